@@ -0,0 +1,494 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * Shared daemon connections.
+ *
+ * All sessions and threads of the process talk to a domain over one
+ * connection. Each request carries a tag in the message header, and
+ * a reader thread hands every reply to the caller waiting for its tag.
+ * The daemon serves tagged requests concurrently.
+ * Daemons that do not answer the eMhMuxHello probe, or setting
+ * OPENHPI_DAEMON_MULTIPLEX to "NO", leave sessions on their own
+ * per-thread connections.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <oh_error.h>
+
+#include <strmsock.h>
+
+#include "conf.h"
+#include "connection.h"
+#include "lock.h"
+#include <sahpi_wrappers.h>
+
+
+/***************************************************************
+ * Connection Layer: class cConnection
+ **************************************************************/
+class cConnection
+{
+public:
+
+    explicit cConnection( SaHpiDomainIdT did );
+    ~cConnection();
+
+    // Ref() and Unref() are called under ohc_lock
+    void Ref()
+    {
+        ++m_ref_cnt;
+    }
+
+    bool Unref()
+    {
+        --m_ref_cnt;
+        return ( m_ref_cnt == 0 );
+    }
+
+    bool IsBroken();
+
+    void Open( const char * host, uint16_t port );
+    ohc_conn_cc Rpc( uint32_t id,
+                     void * payload,
+                     uint32_t& payload_len,
+                     uint8_t& rp_type,
+                     uint32_t& rp_id,
+                     int& rp_byte_order );
+
+private:
+
+    cConnection( const cConnection& );
+    cConnection& operator =( cConnection& );
+
+    struct Waiter
+    {
+        GCond *  cond;
+        bool     done;
+        bool     failed;
+        void *   payload;
+        uint32_t payload_len;
+        uint8_t  type;
+        uint32_t id;
+        int      byte_order;
+    };
+
+    enum eState
+    {
+        eStateOpening,
+        eStateReady,
+        eStateUnsupported,
+        eStateBroken,
+    };
+
+    static gpointer ReaderThread( gpointer ptr );
+    void Read();
+    void SetState( eState state );
+    void Fail();
+
+private:
+
+    static const uint16_t HELLO_TAG = 1;
+
+    // data
+    volatile int        m_ref_cnt;
+    SaHpiDomainIdT      m_did;
+    cClientStreamSock * m_sock;
+    GThread *           m_reader;
+    GMutex *            m_write_lock;
+    GMutex *            m_lock;     // guards the fields below
+    GCond *             m_cond;     // signalled on state change
+    eState              m_state;
+    GHashTable *        m_waiters;  // tag -> Waiter
+    uint16_t            m_next_tag;
+};
+
+
+cConnection::cConnection( SaHpiDomainIdT did )
+    : m_ref_cnt( 0 ),
+      m_did( did ),
+      m_sock( 0 ),
+      m_reader( 0 ),
+      m_state( eStateOpening ),
+      m_next_tag( HELLO_TAG )
+{
+    m_write_lock = wrap_g_mutex_new_init();
+    m_lock       = wrap_g_mutex_new_init();
+    m_cond       = wrap_g_cond_new_init();
+    m_waiters    = g_hash_table_new( g_direct_hash, g_direct_equal );
+}
+
+cConnection::~cConnection()
+{
+    if ( m_sock ) {
+        // wakes up the reader
+        g_mutex_lock( m_write_lock );
+        m_sock->Close();
+        g_mutex_unlock( m_write_lock );
+    }
+    if ( m_reader ) {
+        g_thread_join( m_reader );
+    }
+    delete m_sock;
+
+    g_hash_table_destroy( m_waiters );
+    wrap_g_cond_free( m_cond );
+    wrap_g_mutex_free_clear( m_lock );
+    wrap_g_mutex_free_clear( m_write_lock );
+}
+
+bool cConnection::IsBroken()
+{
+    g_mutex_lock( m_lock );
+    bool broken = ( m_state == eStateBroken );
+    g_mutex_unlock( m_lock );
+
+    return broken;
+}
+
+void cConnection::SetState( eState state )
+{
+    g_mutex_lock( m_lock );
+    m_state = state;
+    g_cond_broadcast( m_cond );
+    g_mutex_unlock( m_lock );
+}
+
+void cConnection::Open( const char * host, uint16_t port )
+{
+    m_sock = new cClientStreamSock;
+
+    bool rc = m_sock->Create( host, port );
+    if ( !rc ) {
+        CRIT( "Connection: cannot open connection to domain %u.", m_did );
+        SetState( eStateBroken );
+        return;
+    }
+
+    m_sock->EnableKeepAliveProbes( /* keepalive_time*/    1,
+                                   /* keepalive_intvl */  1,
+                                   /* keepalive_probes */ 3 );
+
+    // Nobody else uses the socket yet, so the probe is answered in place
+    uint8_t  type;
+    uint16_t tag;
+    uint32_t id, len;
+    int      byte_order;
+    cMsgBuffer buffer;
+
+    rc = m_sock->WriteMsg( eMhMuxHello, HELLO_TAG, 0, 0, 0 );
+    if ( rc ) {
+        rc = m_sock->ReadMsg( type, tag, id, buffer.Data(), len, byte_order );
+    }
+    if ( !rc ) {
+        SetState( eStateBroken );
+        return;
+    }
+    if ( ( type != eMhMuxHello ) || ( tag != HELLO_TAG ) ) {
+        DBG( "Connection: domain %u does not multiplex connections.", m_did );
+        m_sock->Close();
+        SetState( eStateUnsupported );
+        return;
+    }
+
+    m_reader = wrap_g_thread_create_new( "ConnectionReader",
+                                         ReaderThread,
+                                         this,
+                                         TRUE,
+                                         0 );
+    if ( !m_reader ) {
+        CRIT( "Connection: cannot start reader for domain %u.", m_did );
+        SetState( eStateBroken );
+        return;
+    }
+
+    SetState( eStateReady );
+}
+
+ohc_conn_cc cConnection::Rpc( uint32_t id,
+                              void * payload,
+                              uint32_t& payload_len,
+                              uint8_t& rp_type,
+                              uint32_t& rp_id,
+                              int& rp_byte_order )
+{
+    Waiter w;
+    w.cond    = 0;
+    w.done    = false;
+    w.failed  = false;
+    w.payload = payload;
+
+    g_mutex_lock( m_lock );
+    while ( m_state == eStateOpening ) {
+        g_cond_wait( m_cond, m_lock );
+    }
+    if ( m_state != eStateReady ) {
+        eState state = m_state;
+        g_mutex_unlock( m_lock );
+        return ( state == eStateUnsupported ) ? eConnUnsupported : eConnFailed;
+    }
+
+    uint16_t tag;
+    do {
+        ++m_next_tag;
+        tag = m_next_tag;
+    } while ( ( tag == 0 ) ||
+              g_hash_table_lookup( m_waiters, GUINT_TO_POINTER( tag ) ) );
+    w.cond = wrap_g_cond_new_init();
+    g_hash_table_insert( m_waiters, GUINT_TO_POINTER( tag ), &w );
+    g_mutex_unlock( m_lock );
+
+    g_mutex_lock( m_write_lock );
+    bool rc = m_sock->WriteMsg( eMhMsg, tag, id, payload, payload_len );
+    if ( !rc ) {
+        // a partial write breaks the stream for everybody
+        m_sock->Close();
+    }
+    g_mutex_unlock( m_write_lock );
+    if ( !rc ) {
+        Fail();
+    }
+
+    g_mutex_lock( m_lock );
+    while ( !w.done ) {
+        g_cond_wait( w.cond, m_lock );
+    }
+    g_mutex_unlock( m_lock );
+    wrap_g_cond_free( w.cond );
+
+    if ( w.failed ) {
+        return eConnFailed;
+    }
+
+    payload_len   = w.payload_len;
+    rp_type       = w.type;
+    rp_id         = w.id;
+    rp_byte_order = w.byte_order;
+
+    return eConnOk;
+}
+
+gpointer cConnection::ReaderThread( gpointer ptr )
+{
+    cConnection * conn = reinterpret_cast<cConnection *>(ptr);
+    conn->Read();
+
+    return 0;
+}
+
+void cConnection::Read()
+{
+    cMsgBuffer discard;
+
+    while ( true ) {
+        uint8_t  type;
+        uint16_t tag;
+        uint32_t id, len;
+        int      byte_order;
+
+        bool rc = m_sock->ReadMsgHeader( type, tag, id, len, byte_order );
+        if ( !rc ) {
+            break;
+        }
+
+        // The waiter leaves the table before its payload is read,
+        // so Fail() cannot complete it meanwhile.
+        g_mutex_lock( m_lock );
+        gpointer key = GUINT_TO_POINTER( tag );
+        Waiter * w = reinterpret_cast<Waiter *>(
+            g_hash_table_lookup( m_waiters, key ) );
+        if ( w ) {
+            g_hash_table_remove( m_waiters, key );
+        }
+        g_mutex_unlock( m_lock );
+
+        if ( !w ) {
+            CRIT( "Connection: reply with unknown tag %u from domain %u.",
+                  tag, m_did );
+            rc = m_sock->ReadMsgPayload( discard.Data(), len );
+            if ( !rc ) {
+                break;
+            }
+            continue;
+        }
+
+        // The reply goes straight into the caller's buffer
+        rc = m_sock->ReadMsgPayload( w->payload, len );
+
+        g_mutex_lock( m_lock );
+        w->payload_len = len;
+        w->type        = type;
+        w->id          = id;
+        w->byte_order  = byte_order;
+        w->failed      = !rc;
+        w->done        = true;
+        g_cond_signal( w->cond );
+        g_mutex_unlock( m_lock );
+
+        if ( !rc ) {
+            break;
+        }
+    }
+
+    Fail();
+}
+
+void cConnection::Fail()
+{
+    g_mutex_lock( m_lock );
+    if ( m_state != eStateBroken ) {
+        DBG( "Connection: connection to domain %u is broken.", m_did );
+    }
+    m_state = eStateBroken;
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init( &iter, m_waiters );
+    while ( g_hash_table_iter_next( &iter, 0, &value ) ) {
+        Waiter * w = reinterpret_cast<Waiter *>(value);
+        w->failed = true;
+        w->done   = true;
+        g_cond_signal( w->cond );
+    }
+    g_hash_table_remove_all( m_waiters );
+    g_cond_broadcast( m_cond );
+    g_mutex_unlock( m_lock );
+}
+
+
+/***************************************************************
+ * Connection Layer: Connection Table
+ **************************************************************/
+static GHashTable * connections = 0;
+
+static gpointer did_key( SaHpiDomainIdT did )
+{
+    return GUINT_TO_POINTER( did );
+}
+
+static bool multiplex_enabled()
+{
+    static int enabled = -1;
+
+    if ( enabled < 0 ) {
+        const char * value = getenv( "OPENHPI_DAEMON_MULTIPLEX" );
+        enabled = ( value && ( g_ascii_strcasecmp( value, "NO" ) == 0 ) ) ? 0 : 1;
+    }
+
+    return ( enabled != 0 );
+}
+
+static void connections_unref( cConnection * conn )
+{
+    ohc_lock();
+    bool last = conn->Unref();
+    ohc_unlock();
+
+    if ( last ) {
+        delete conn;
+    }
+}
+
+
+/***************************************************************
+ * Connection Layer:  Interface
+ **************************************************************/
+
+ohc_conn_cc ohc_conn_rpc( SaHpiDomainIdT did,
+                          uint32_t id,
+                          void * payload,
+                          uint32_t& payload_len,
+                          uint8_t& rp_type,
+                          uint32_t& rp_id,
+                          int& rp_byte_order )
+{
+    if ( !multiplex_enabled() ) {
+        return eConnUnsupported;
+    }
+
+    cConnection * stale = 0;
+    cConnection * conn;
+    char host[SAHPI_MAX_TEXT_BUFFER_LENGTH];
+    uint16_t port = 0;
+    bool opener = false;
+
+    ohc_lock();
+    const struct ohc_domain_conf * dc = ohc_get_domain_conf( did );
+    if ( !dc ) {
+        ohc_unlock();
+        // the private connection reports the invalid domain
+        return eConnUnsupported;
+    }
+    if ( !connections ) {
+        connections = g_hash_table_new( g_direct_hash, g_direct_equal );
+    }
+    conn = reinterpret_cast<cConnection *>(
+        g_hash_table_lookup( connections, did_key( did ) ) );
+    if ( conn && conn->IsBroken() ) {
+        g_hash_table_remove( connections, did_key( did ) );
+        stale = conn->Unref() ? conn : 0;
+        conn = 0;
+    }
+    if ( !conn ) {
+        conn = new cConnection( did );
+        conn->Ref(); // table reference
+        g_hash_table_insert( connections, did_key( did ), conn );
+        strncpy( host, dc->host, sizeof(host) );
+        host[sizeof(host) - 1] = '\0';
+        port = dc->port;
+        opener = true;
+    }
+    conn->Ref();
+    ohc_unlock();
+
+    delete stale;
+
+    if ( opener ) {
+        conn->Open( host, port );
+    }
+
+    ohc_conn_cc cc = conn->Rpc( id,
+                                payload,
+                                payload_len,
+                                rp_type,
+                                rp_id,
+                                rp_byte_order );
+    connections_unref( conn );
+
+    return cc;
+}
+
+static void collect_func( gpointer /* key */, gpointer value, gpointer user_data )
+{
+    GList ** pvalues = reinterpret_cast<GList **>(user_data);
+    *pvalues = g_list_append( *pvalues, value );
+}
+
+void ohc_conn_close_all()
+{
+    GList * conns = 0;
+
+    ohc_lock();
+    if ( connections ) {
+        g_hash_table_foreach( connections, collect_func, &conns );
+        g_hash_table_remove_all( connections );
+    }
+    ohc_unlock();
+
+    for ( GList * item = conns; item != 0; item = item->next ) {
+        connections_unref( reinterpret_cast<cConnection *>(item->data) );
+    }
+    g_list_free( conns );
+}
+
@@ -0,0 +1,44 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __BASELIB_CONNECTION_H
+#define __BASELIB_CONNECTION_H
+
+#include <stdint.h>
+
+#include <SaHpi.h>
+
+
+enum ohc_conn_cc
+{
+    eConnOk,          // reply received
+    eConnFailed,      // connection failed, the request may be retried
+    eConnUnsupported, // no shared connection, use a private one
+};
+
+/*
+ * Sends a request over the connection shared by all sessions
+ * and threads of the process for the domain.
+ * payload holds the request on input and the reply on output.
+ */
+ohc_conn_cc ohc_conn_rpc( SaHpiDomainIdT did,
+                          uint32_t id,
+                          void * payload,
+                          uint32_t& payload_len,
+                          uint8_t& rp_type,
+                          uint32_t& rp_id,
+                          int& rp_byte_order );
+void ohc_conn_close_all();
+
+#endif /* __BASELIB_CONNECTION_H */
+
@@ -24,6 +24,7 @@
 #include <SaHpi.h>
 
 #include "conf.h"
+#include "connection.h"
 #include "init.h"
 #include "session.h"
 #include "sahpi_wrappers.h"
@@ -57,6 +58,7 @@ SaErrorT ohc_finit(void)
     if ( rv != SA_OK ) {
         return rv;
     }
+    ohc_conn_close_all();
 
     return SA_OK;
 }
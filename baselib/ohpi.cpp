@@ -292,6 +292,180 @@ SaErrorT SAHPI_API oHpiInjectEvent (
 }
 
 
+/*----------------------------------------------------------------------------*/
+/* oHpiSensorCacheStatsGet                                                    */
+/*----------------------------------------------------------------------------*/
+SaErrorT SAHPI_API oHpiSensorCacheStatsGet (
+    SAHPI_IN    SaHpiSessionIdT sid,
+    SAHPI_IN    oHpiHandlerIdT id,
+    SAHPI_OUT   oHpiSensorCacheStatsT *stats)
+{
+    SaErrorT rv;
+
+    if (id == 0 || !stats) {
+        return SA_ERR_HPI_INVALID_PARAMS;
+    }
+
+    ClientRpcParams iparams(&id);
+    ClientRpcParams oparams(stats);
+    rv = ohc_sess_rpc(eFoHpiSensorCacheStatsGet, sid, iparams, oparams);
+
+    return rv;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* oHpiHandlerStatsGet                                                        */
+/*----------------------------------------------------------------------------*/
+SaErrorT SAHPI_API oHpiHandlerStatsGet (
+    SAHPI_IN    SaHpiSessionIdT sid,
+    SAHPI_IN    oHpiHandlerIdT id,
+    SAHPI_IN    SaHpiEntryIdT EntryId,
+    SAHPI_OUT   SaHpiEntryIdT *NextEntryId,
+    SAHPI_OUT   oHpiHandlerStatsT *stats)
+{
+    SaErrorT rv;
+
+    if (id == 0 || !NextEntryId || !stats) {
+        return SA_ERR_HPI_INVALID_PARAMS;
+    }
+    if (EntryId == SAHPI_LAST_ENTRY) {
+        return SA_ERR_HPI_INVALID_PARAMS;
+    }
+
+    ClientRpcParams iparams(&id, &EntryId);
+    ClientRpcParams oparams(NextEntryId, stats);
+    rv = ohc_sess_rpc(eFoHpiHandlerStatsGet, sid, iparams, oparams);
+
+    return rv;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* oHpiDelWriterStatsGet                                                      */
+/*----------------------------------------------------------------------------*/
+SaErrorT SAHPI_API oHpiDelWriterStatsGet (
+    SAHPI_IN    SaHpiSessionIdT sid,
+    SAHPI_OUT   oHpiDelWriterStatsT *stats)
+{
+    SaErrorT rv;
+
+    if (!stats) {
+        return SA_ERR_HPI_INVALID_PARAMS;
+    }
+
+    ClientRpcParams iparams;
+    ClientRpcParams oparams(stats);
+    rv = ohc_sess_rpc(eFoHpiDelWriterStatsGet, sid, iparams, oparams);
+
+    return rv;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* oHpiEventLimitStatsGet                                                     */
+/*----------------------------------------------------------------------------*/
+SaErrorT SAHPI_API oHpiEventLimitStatsGet (
+    SAHPI_IN    SaHpiSessionIdT sid,
+    SAHPI_IN    oHpiHandlerIdT id,
+    SAHPI_OUT   oHpiEventLimitStatsT *stats)
+{
+    SaErrorT rv;
+
+    if (id == 0 || !stats) {
+        return SA_ERR_HPI_INVALID_PARAMS;
+    }
+
+    ClientRpcParams iparams(&id);
+    ClientRpcParams oparams(stats);
+    rv = ohc_sess_rpc(eFoHpiEventLimitStatsGet, sid, iparams, oparams);
+
+    return rv;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* oHpiEventQueueStatsGet                                                     */
+/*----------------------------------------------------------------------------*/
+SaErrorT SAHPI_API oHpiEventQueueStatsGet (
+    SAHPI_IN    SaHpiSessionIdT sid,
+    SAHPI_IN    oHpiEventPriorityT priority,
+    SAHPI_OUT   oHpiEventQueueStatsT *stats)
+{
+    SaErrorT rv;
+
+    if (priority >= OHPI_EVENT_PRIORITY_LEVELS || !stats) {
+        return SA_ERR_HPI_INVALID_PARAMS;
+    }
+
+    ClientRpcParams iparams(&priority);
+    ClientRpcParams oparams(stats);
+    rv = ohc_sess_rpc(eFoHpiEventQueueStatsGet, sid, iparams, oparams);
+
+    return rv;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* oHpiEventLogEntriesGet                                                     */
+/*----------------------------------------------------------------------------*/
+SaErrorT SAHPI_API oHpiEventLogEntriesGet (
+    SAHPI_IN    SaHpiSessionIdT sid,
+    SAHPI_IN    SaHpiResourceIdT rid,
+    SAHPI_IN    SaHpiEventLogEntryIdT entry_id,
+    SAHPI_IN    SaHpiUint32T max_entries,
+    SAHPI_IN    SaHpiBoolT with_rdr,
+    SAHPI_IN    SaHpiBoolT with_rpt_entry,
+    SAHPI_OUT   SaHpiEventLogEntryIdT *next_entry_id,
+    SAHPI_OUT   oHpiEventLogEntriesT *entries)
+{
+    SaErrorT rv;
+    SaHpiDomainIdT did;
+    SaHpiEntityPathT entity_root;
+
+    if (entry_id == SAHPI_NO_MORE_ENTRIES || max_entries == 0 ||
+        !next_entry_id || !entries) {
+        return SA_ERR_HPI_INVALID_PARAMS;
+    }
+
+    memset(entries, 0, sizeof(*entries));
+
+    ClientRpcParams iparams(&rid, &entry_id, &max_entries, &with_rdr, &with_rpt_entry);
+    ClientRpcParams oparams(next_entry_id, entries);
+    rv = ohc_sess_rpc(eFoHpiEventLogEntriesGet, sid, iparams, oparams);
+
+    /* Same adjustments as saHpiEventLogEntryGet */
+    if ((rv == SA_OK) && (rid == SAHPI_UNSPECIFIED_RESOURCE_ID)) {
+        rv = ohc_sess_get_did(sid, did);
+        for (SaHpiUint32T i = 0; (rv == SA_OK) && (i < entries->NumberOfEntries); i++) {
+            SaHpiEventT& event = entries->Entries[i].Event;
+            if (event.EventType == SAHPI_ET_DOMAIN) {
+                event.EventDataUnion.DomainEvent.DomainId = did;
+            }
+        }
+    }
+    if (rv == SA_OK) {
+        rv = ohc_sess_get_entity_root(sid, entity_root);
+    }
+    if (rv == SA_OK) {
+        for (SaHpiUint32T i = 0; i < entries->NumberOfRdrs; i++) {
+            oh_concat_ep(&entries->Rdrs[i].Entity, &entity_root);
+        }
+        for (SaHpiUint32T i = 0; i < entries->NumberOfRptEntries; i++) {
+            oh_concat_ep(&entries->RptEntries[i].ResourceEntity, &entity_root);
+        }
+    }
+    if (rv != SA_OK) {
+        g_free(entries->Entries);
+        g_free(entries->Rdrs);
+        g_free(entries->RptEntries);
+        memset(entries, 0, sizeof(*entries));
+    }
+
+    return rv;
+}
+
+
 
 /*----------------------------------------------------------------------------*/
 /* oHpiDomainAdd                                                              */
@@ -0,0 +1,651 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * Client side RPT and RDR cache.
+ *
+ * A session's RPT is fetched once with saHpiRptEntryGet and kept together
+ * with the domain RptUpdateCount it was taken at; the RDRs of a resource
+ * are kept with the resource's RDR update count. While the data is
+ * younger than OPENHPI_CLIENT_CACHE milliseconds it is served without
+ * a round trip. Older data costs a single update count request, and is
+ * fetched again only if the count has changed. Resource and hot swap
+ * events read by the application, and changes made by it, drop the data
+ * right away.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <oh_error.h>
+#include <oh_utils.h>
+
+#include <marshal_hpi.h>
+#include <oh_rpc_params.h>
+
+#include "lock.h"
+#include "rptcache.h"
+#include "session.h"
+
+
+// How many times a table that keeps changing while it is fetched
+// is fetched again before giving up
+static const int dMaxFetchAttempts = 3;
+
+
+/***************************************************************
+ * Cache Layer: Data
+ **************************************************************/
+struct RptItem
+{
+    SaHpiEntryIdT  next;
+    SaHpiRptEntryT rpte;
+};
+
+struct RdrItem
+{
+    SaHpiEntryIdT next;
+    SaHpiRdrT     rdr;
+};
+
+// Entries in the order of the walk that fetched them
+struct Table
+{
+    SaHpiUint32T update_count;
+    gint64       validated; // msec
+    GArray *     items;
+    GHashTable * by_id;     // entry id -> index + 1
+};
+
+struct SessionCache
+{
+    SaHpiSessionIdT sid;
+    SaHpiDomainIdT  did;
+    guint           generation; // changes when cached data is dropped
+    Table *         rpt;
+    GHashTable *    by_rid;     // resource id -> index + 1 in rpt
+    GHashTable *    rdrs;       // resource id -> Table
+};
+
+static GHashTable * caches = 0;
+
+static gpointer id_key( guint id )
+{
+    return GUINT_TO_POINTER( id );
+}
+
+static guint key_id( gpointer key )
+{
+    return GPOINTER_TO_UINT( key );
+}
+
+static gint64 cache_ttl()
+{
+    static gint64 ttl = -1;
+
+    if ( ttl < 0 ) {
+        const char * value = getenv( "OPENHPI_CLIENT_CACHE" );
+        ttl = value ? strtol( value, 0, 10 ) : 0;
+        if ( ttl < 0 ) {
+            ttl = 0;
+        }
+    }
+
+    return ttl;
+}
+
+static gint64 now_msec()
+{
+#if GLIB_CHECK_VERSION (2, 28, 0)
+    return g_get_monotonic_time() / 1000;
+#else
+    GTimeVal tv;
+    g_get_current_time( &tv );
+    return ( (gint64)tv.tv_sec ) * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
+static Table * table_new( guint item_size )
+{
+    Table * table = g_new0( Table, 1 );
+    table->items = g_array_new( FALSE, FALSE, item_size );
+    table->by_id = g_hash_table_new( g_direct_hash, g_direct_equal );
+    return table;
+}
+
+static void table_free( gpointer ptr )
+{
+    Table * table = reinterpret_cast<Table *>(ptr);
+    if ( table ) {
+        g_array_free( table->items, TRUE );
+        g_hash_table_destroy( table->by_id );
+        g_free( table );
+    }
+}
+
+// Drops the RPT and the RDRs of rid, or of all resources
+static void session_cache_clear( SessionCache * cache, SaHpiResourceIdT rid )
+{
+    ++cache->generation;
+    table_free( cache->rpt );
+    cache->rpt = 0;
+    g_hash_table_remove_all( cache->by_rid );
+    if ( rid == SAHPI_UNSPECIFIED_RESOURCE_ID ) {
+        g_hash_table_remove_all( cache->rdrs );
+    } else {
+        g_hash_table_remove( cache->rdrs, id_key( rid ) );
+    }
+}
+
+static void session_cache_free( gpointer ptr )
+{
+    SessionCache * cache = reinterpret_cast<SessionCache *>(ptr);
+    table_free( cache->rpt );
+    g_hash_table_destroy( cache->by_rid );
+    g_hash_table_destroy( cache->rdrs );
+    g_free( cache );
+}
+
+// Must be called under ohc_lock
+static SessionCache * session_cache_get( SaHpiSessionIdT sid, bool create )
+{
+    if ( !caches ) {
+        if ( !create ) {
+            return 0;
+        }
+        caches = g_hash_table_new_full( g_direct_hash,
+                                        g_direct_equal,
+                                        0,
+                                        session_cache_free );
+    }
+
+    SessionCache * cache;
+    cache = reinterpret_cast<SessionCache *>(g_hash_table_lookup( caches, id_key( sid ) ));
+    if ( !cache && create ) {
+        SaHpiDomainIdT did;
+        if ( ohc_sess_get_did( sid, did ) != SA_OK ) {
+            return 0;
+        }
+        cache = g_new0( SessionCache, 1 );
+        cache->sid = sid;
+        cache->did = did;
+        cache->by_rid = g_hash_table_new( g_direct_hash, g_direct_equal );
+        cache->rdrs = g_hash_table_new_full( g_direct_hash,
+                                             g_direct_equal,
+                                             0,
+                                             table_free );
+        g_hash_table_insert( caches, id_key( sid ), cache );
+    }
+
+    return cache;
+}
+
+static gint table_find( Table * table, SaHpiEntryIdT id )
+{
+    if ( id == SAHPI_FIRST_ENTRY ) {
+        return ( table->items->len > 0 ) ? 0 : -1;
+    }
+    gpointer value = g_hash_table_lookup( table->by_id, id_key( id ) );
+    return static_cast<gint>( key_id( value ) ) - 1;
+}
+
+
+/***************************************************************
+ * Cache Layer: Fetching
+ **************************************************************/
+static SaErrorT rpc_rpt_update_count( SaHpiSessionIdT sid, SaHpiUint32T& count )
+{
+    SaHpiDomainInfoT info;
+    ClientRpcParams iparams;
+    ClientRpcParams oparams( &info );
+    SaErrorT rv = ohc_sess_rpc( eFsaHpiDomainInfoGet, sid, iparams, oparams );
+    if ( rv == SA_OK ) {
+        count = info.RptUpdateCount;
+    }
+    return rv;
+}
+
+static SaErrorT rpc_rdr_update_count( SaHpiSessionIdT sid,
+                                      SaHpiResourceIdT rid,
+                                      SaHpiUint32T& count )
+{
+    ClientRpcParams iparams( &rid );
+    ClientRpcParams oparams( &count );
+    return ohc_sess_rpc( eFsaHpiRdrUpdateCountGet, sid, iparams, oparams );
+}
+
+// Walks the whole RPT. The result is consistent with count.
+static SaErrorT fetch_rpt( SaHpiSessionIdT sid, SaHpiUint32T& count, Table * table )
+{
+    SaHpiEntityPathT root;
+    SaErrorT rv = ohc_sess_get_entity_root( sid, root );
+    if ( rv != SA_OK ) {
+        return rv;
+    }
+
+    for ( int attempt = 0; attempt < dMaxFetchAttempts; ++attempt ) {
+        SaHpiUint32T before;
+        rv = rpc_rpt_update_count( sid, before );
+        if ( rv != SA_OK ) {
+            return rv;
+        }
+
+        g_array_set_size( table->items, 0 );
+        g_hash_table_remove_all( table->by_id );
+        SaHpiEntryIdT id = SAHPI_FIRST_ENTRY;
+        while ( id != SAHPI_LAST_ENTRY ) {
+            RptItem item;
+            ClientRpcParams iparams( &id );
+            ClientRpcParams oparams( &item.next, &item.rpte );
+            rv = ohc_sess_rpc( eFsaHpiRptEntryGet, sid, iparams, oparams );
+            if ( ( rv == SA_ERR_HPI_NOT_PRESENT ) && ( id == SAHPI_FIRST_ENTRY ) ) {
+                rv = SA_OK; // empty table
+                break;
+            }
+            if ( rv != SA_OK ) {
+                break;
+            }
+            oh_concat_ep( &item.rpte.ResourceEntity, &root );
+            g_array_append_val( table->items, item );
+            g_hash_table_insert( table->by_id,
+                                 id_key( ( id != SAHPI_FIRST_ENTRY ) ? id : item.rpte.EntryId ),
+                                 id_key( table->items->len ) );
+            id = item.next;
+        }
+        if ( rv == SA_ERR_HPI_NOT_PRESENT ) {
+            continue; // the entry was removed during the walk
+        }
+        if ( rv != SA_OK ) {
+            return rv;
+        }
+
+        rv = rpc_rpt_update_count( sid, count );
+        if ( rv != SA_OK ) {
+            return rv;
+        }
+        if ( count == before ) {
+            return SA_OK;
+        }
+    }
+
+    DBG( "RPT of session %u keeps changing, not cached.", sid );
+    return SA_ERR_HPI_BUSY;
+}
+
+// Walks all RDRs of the resource. The result is consistent with count.
+static SaErrorT fetch_rdrs( SaHpiSessionIdT sid,
+                            SaHpiResourceIdT rid,
+                            SaHpiUint32T& count,
+                            Table * table )
+{
+    SaHpiEntityPathT root;
+    SaErrorT rv = ohc_sess_get_entity_root( sid, root );
+    if ( rv != SA_OK ) {
+        return rv;
+    }
+
+    for ( int attempt = 0; attempt < dMaxFetchAttempts; ++attempt ) {
+        SaHpiUint32T before;
+        rv = rpc_rdr_update_count( sid, rid, before );
+        if ( rv != SA_OK ) {
+            return rv;
+        }
+
+        g_array_set_size( table->items, 0 );
+        g_hash_table_remove_all( table->by_id );
+        SaHpiEntryIdT id = SAHPI_FIRST_ENTRY;
+        while ( id != SAHPI_LAST_ENTRY ) {
+            RdrItem item;
+            ClientRpcParams iparams( &rid, &id );
+            ClientRpcParams oparams( &item.next, &item.rdr );
+            rv = ohc_sess_rpc( eFsaHpiRdrGet, sid, iparams, oparams );
+            if ( ( rv == SA_ERR_HPI_NOT_PRESENT ) && ( id == SAHPI_FIRST_ENTRY ) ) {
+                rv = SA_OK; // no RDRs
+                break;
+            }
+            if ( rv != SA_OK ) {
+                break;
+            }
+            oh_concat_ep( &item.rdr.Entity, &root );
+            g_array_append_val( table->items, item );
+            g_hash_table_insert( table->by_id,
+                                 id_key( ( id != SAHPI_FIRST_ENTRY ) ? id : item.rdr.RecordId ),
+                                 id_key( table->items->len ) );
+            id = item.next;
+        }
+        if ( rv == SA_ERR_HPI_NOT_PRESENT ) {
+            continue;
+        }
+        if ( rv != SA_OK ) {
+            return rv;
+        }
+
+        rv = rpc_rdr_update_count( sid, rid, count );
+        if ( rv != SA_OK ) {
+            return rv;
+        }
+        if ( count == before ) {
+            return SA_OK;
+        }
+    }
+
+    DBG( "RDRs of resource %u keep changing, not cached.", rid );
+    return SA_ERR_HPI_BUSY;
+}
+
+static void index_rpt( SessionCache * cache )
+{
+    g_hash_table_remove_all( cache->by_rid );
+    for ( guint i = 0; i < cache->rpt->items->len; ++i ) {
+        const RptItem& item = g_array_index( cache->rpt->items, RptItem, i );
+        g_hash_table_insert( cache->by_rid,
+                             id_key( item.rpte.ResourceId ),
+                             id_key( i + 1 ) );
+    }
+}
+
+static gboolean rdrs_stale( gpointer key, gpointer /* value */, gpointer user_data )
+{
+    SessionCache * cache = reinterpret_cast<SessionCache *>(user_data);
+    return g_hash_table_lookup( cache->by_rid, key ) == 0;
+}
+
+/*
+ * Returns the session cache with an up to date RPT, with ohc_lock held.
+ * Returns 0, without the lock, if the RPT cannot be cached.
+ */
+static SessionCache * rpt_acquire( SaHpiSessionIdT sid )
+{
+    ohc_lock();
+    SessionCache * cache = session_cache_get( sid, true );
+    if ( !cache ) {
+        ohc_unlock();
+        return 0;
+    }
+    gint64 now = now_msec();
+    if ( cache->rpt && ( ( now - cache->rpt->validated ) < cache_ttl() ) ) {
+        return cache;
+    }
+    guint generation = cache->generation;
+    bool cached = ( cache->rpt != 0 );
+    SaHpiUint32T cached_count = cached ? cache->rpt->update_count : 0;
+    ohc_unlock();
+
+    SaHpiUint32T count;
+    if ( rpc_rpt_update_count( sid, count ) != SA_OK ) {
+        return 0;
+    }
+    Table * table = 0;
+    if ( ( !cached ) || ( count != cached_count ) ) {
+        table = table_new( sizeof(RptItem) );
+        if ( fetch_rpt( sid, count, table ) != SA_OK ) {
+            table_free( table );
+            return 0;
+        }
+    }
+
+    ohc_lock();
+    cache = session_cache_get( sid, false );
+    if ( ( !cache ) || ( cache->generation != generation ) ) {
+        // Dropped while we were fetching, the data may be stale
+        ohc_unlock();
+        table_free( table );
+        return 0;
+    }
+    if ( table ) {
+        table_free( cache->rpt );
+        cache->rpt = table;
+        cache->rpt->update_count = count;
+        index_rpt( cache );
+        g_hash_table_foreach_remove( cache->rdrs, rdrs_stale, cache );
+    } else if ( !cache->rpt ) {
+        ohc_unlock();
+        return 0;
+    }
+    cache->rpt->validated = now_msec();
+
+    return cache;
+}
+
+/*
+ * Returns up to date RDRs of the resource, with ohc_lock held.
+ * Returns 0, without the lock, if they cannot be cached.
+ */
+static Table * rdrs_acquire( SaHpiSessionIdT sid, SaHpiResourceIdT rid )
+{
+    ohc_lock();
+    SessionCache * cache = session_cache_get( sid, true );
+    if ( !cache ) {
+        ohc_unlock();
+        return 0;
+    }
+    Table * rdrs = reinterpret_cast<Table *>(g_hash_table_lookup( cache->rdrs, id_key( rid ) ));
+    gint64 now = now_msec();
+    if ( rdrs && ( ( now - rdrs->validated ) < cache_ttl() ) ) {
+        return rdrs;
+    }
+    guint generation = cache->generation;
+    bool cached = ( rdrs != 0 );
+    SaHpiUint32T cached_count = cached ? rdrs->update_count : 0;
+    ohc_unlock();
+
+    SaHpiUint32T count;
+    if ( rpc_rdr_update_count( sid, rid, count ) != SA_OK ) {
+        return 0;
+    }
+    Table * table = 0;
+    if ( ( !cached ) || ( count != cached_count ) ) {
+        table = table_new( sizeof(RdrItem) );
+        if ( fetch_rdrs( sid, rid, count, table ) != SA_OK ) {
+            table_free( table );
+            return 0;
+        }
+    }
+
+    ohc_lock();
+    cache = session_cache_get( sid, false );
+    if ( ( !cache ) || ( cache->generation != generation ) ) {
+        ohc_unlock();
+        table_free( table );
+        return 0;
+    }
+    if ( table ) {
+        table->update_count = count;
+        g_hash_table_insert( cache->rdrs, id_key( rid ), table );
+        rdrs = table;
+    } else {
+        rdrs = reinterpret_cast<Table *>(g_hash_table_lookup( cache->rdrs, id_key( rid ) ));
+        if ( !rdrs ) {
+            ohc_unlock();
+            return 0;
+        }
+    }
+    rdrs->validated = now_msec();
+
+    return rdrs;
+}
+
+
+/***************************************************************
+ * Cache Layer: Interface
+ **************************************************************/
+bool ohc_cache_rpt_entry_get( SaHpiSessionIdT sid,
+                              SaHpiEntryIdT id,
+                              SaHpiEntryIdT& next_id,
+                              SaHpiRptEntryT& rpte,
+                              SaErrorT& rv )
+{
+    if ( cache_ttl() == 0 ) {
+        return false;
+    }
+    SessionCache * cache = rpt_acquire( sid );
+    if ( !cache ) {
+        return false;
+    }
+
+    bool served = true;
+    gint i = table_find( cache->rpt, id );
+    if ( i >= 0 ) {
+        const RptItem& item = g_array_index( cache->rpt->items, RptItem, i );
+        next_id = item.next;
+        rpte = item.rpte;
+        rv = SA_OK;
+    } else if ( id == SAHPI_FIRST_ENTRY ) {
+        rv = SA_ERR_HPI_NOT_PRESENT;
+    } else {
+        served = false; // let the daemon decide
+    }
+    ohc_unlock();
+
+    return served;
+}
+
+bool ohc_cache_rpt_entry_get_by_rid( SaHpiSessionIdT sid,
+                                     SaHpiResourceIdT rid,
+                                     SaHpiRptEntryT& rpte,
+                                     SaErrorT& rv )
+{
+    if ( cache_ttl() == 0 ) {
+        return false;
+    }
+    SessionCache * cache = rpt_acquire( sid );
+    if ( !cache ) {
+        return false;
+    }
+
+    bool served = false;
+    gint i = static_cast<gint>( key_id( g_hash_table_lookup( cache->by_rid, id_key( rid ) ) ) ) - 1;
+    if ( i >= 0 ) {
+        rpte = g_array_index( cache->rpt->items, RptItem, i ).rpte;
+        rv = SA_OK;
+        served = true;
+    }
+    ohc_unlock();
+
+    return served;
+}
+
+bool ohc_cache_rdr_get( SaHpiSessionIdT sid,
+                        SaHpiResourceIdT rid,
+                        SaHpiEntryIdT id,
+                        SaHpiEntryIdT& next_id,
+                        SaHpiRdrT& rdr,
+                        SaErrorT& rv )
+{
+    if ( cache_ttl() == 0 ) {
+        return false;
+    }
+    Table * rdrs = rdrs_acquire( sid, rid );
+    if ( !rdrs ) {
+        return false;
+    }
+
+    bool served = true;
+    gint i = table_find( rdrs, id );
+    if ( i >= 0 ) {
+        const RdrItem& item = g_array_index( rdrs->items, RdrItem, i );
+        next_id = item.next;
+        rdr = item.rdr;
+        rv = SA_OK;
+    } else if ( id == SAHPI_FIRST_ENTRY ) {
+        rv = SA_ERR_HPI_NOT_PRESENT;
+    } else {
+        served = false;
+    }
+    ohc_unlock();
+
+    return served;
+}
+
+bool ohc_cache_rdr_get_by_instrument_id( SaHpiSessionIdT sid,
+                                         SaHpiResourceIdT rid,
+                                         SaHpiRdrTypeT type,
+                                         SaHpiInstrumentIdT num,
+                                         SaHpiRdrT& rdr,
+                                         SaErrorT& rv )
+{
+    if ( cache_ttl() == 0 ) {
+        return false;
+    }
+    Table * rdrs = rdrs_acquire( sid, rid );
+    if ( !rdrs ) {
+        return false;
+    }
+
+    bool served = false;
+    for ( guint i = 0; i < rdrs->items->len; ++i ) {
+        const RdrItem& item = g_array_index( rdrs->items, RdrItem, i );
+        if ( ( item.rdr.RdrType == type ) && ( oh_get_instrument_id( &item.rdr ) == num ) ) {
+            rdr = item.rdr;
+            rv = SA_OK;
+            served = true;
+            break;
+        }
+    }
+    ohc_unlock();
+
+    return served;
+}
+
+struct Invalidation
+{
+    SaHpiDomainIdT   did;
+    SaHpiResourceIdT rid;
+};
+
+static void invalidate_func( gpointer /* key */, gpointer value, gpointer user_data )
+{
+    SessionCache * cache = reinterpret_cast<SessionCache *>(value);
+    const Invalidation * inv = reinterpret_cast<const Invalidation *>(user_data);
+
+    if ( cache->did == inv->did ) {
+        session_cache_clear( cache, inv->rid );
+    }
+}
+
+void ohc_cache_invalidate( SaHpiSessionIdT sid, SaHpiResourceIdT rid )
+{
+    if ( cache_ttl() == 0 ) {
+        return;
+    }
+
+    ohc_lock();
+    SessionCache * cache = session_cache_get( sid, false );
+    if ( cache ) {
+        // Other sessions of the domain see the same data
+        Invalidation inv = { cache->did, rid };
+        g_hash_table_foreach( caches, invalidate_func, &inv );
+    }
+    ohc_unlock();
+}
+
+void ohc_cache_event( SaHpiSessionIdT sid, const SaHpiEventT& event )
+{
+    switch ( event.EventType ) {
+        case SAHPI_ET_RESOURCE:
+        case SAHPI_ET_HOTSWAP:
+            ohc_cache_invalidate( sid, event.Source );
+            break;
+        default:
+            break;
+    }
+}
+
+void ohc_cache_drop( SaHpiSessionIdT sid )
+{
+    ohc_lock();
+    if ( caches ) {
+        g_hash_table_remove( caches, id_key( sid ) );
+    }
+    ohc_unlock();
+}
+
@@ -0,0 +1,58 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __BASELIB_RPTCACHE_H
+#define __BASELIB_RPTCACHE_H
+
+#include <SaHpi.h>
+
+
+/*
+ * Client side RPT and RDR cache, enabled by OPENHPI_CLIENT_CACHE.
+ * The lookup functions return false when the request has to be sent
+ * to the daemon; otherwise rv and the output parameters are filled in.
+ * Returned RPT entries already include the domain entity root.
+ */
+bool ohc_cache_rpt_entry_get( SaHpiSessionIdT sid,
+                              SaHpiEntryIdT id,
+                              SaHpiEntryIdT& next_id,
+                              SaHpiRptEntryT& rpte,
+                              SaErrorT& rv );
+bool ohc_cache_rpt_entry_get_by_rid( SaHpiSessionIdT sid,
+                                     SaHpiResourceIdT rid,
+                                     SaHpiRptEntryT& rpte,
+                                     SaErrorT& rv );
+bool ohc_cache_rdr_get( SaHpiSessionIdT sid,
+                        SaHpiResourceIdT rid,
+                        SaHpiEntryIdT id,
+                        SaHpiEntryIdT& next_id,
+                        SaHpiRdrT& rdr,
+                        SaErrorT& rv );
+bool ohc_cache_rdr_get_by_instrument_id( SaHpiSessionIdT sid,
+                                         SaHpiResourceIdT rid,
+                                         SaHpiRdrTypeT type,
+                                         SaHpiInstrumentIdT num,
+                                         SaHpiRdrT& rdr,
+                                         SaErrorT& rv );
+
+/*
+ * Drops cached data of all sessions of the domain the session belongs to.
+ * With SAHPI_UNSPECIFIED_RESOURCE_ID the RDRs of all resources are dropped,
+ * otherwise only those of rid. The RPT is dropped in both cases.
+ */
+void ohc_cache_invalidate( SaHpiSessionIdT sid, SaHpiResourceIdT rid );
+void ohc_cache_event( SaHpiSessionIdT sid, const SaHpiEventT& event );
+void ohc_cache_drop( SaHpiSessionIdT sid );
+
+#endif /* __BASELIB_RPTCACHE_H */
+
@@ -33,6 +33,7 @@
 
 #include "conf.h"
 #include "init.h"
+#include "rptcache.h"
 #include "session.h"
 
 
@@ -220,6 +221,7 @@ SaErrorT SAHPI_API saHpiDiscover(
     ClientRpcParams iparams;
     ClientRpcParams oparams;
     rv = ohc_sess_rpc(eFsaHpiDiscover, SessionId, iparams, oparams);
+    ohc_cache_invalidate(SessionId, SAHPI_UNSPECIFIED_RESOURCE_ID);
 
     return rv;
 }
@@ -326,6 +328,9 @@ SaErrorT SAHPI_API saHpiRptEntryGet(
     if (EntryId == SAHPI_LAST_ENTRY) {
         return SA_ERR_HPI_INVALID_PARAMS;
     }
+    if (ohc_cache_rpt_entry_get(SessionId, EntryId, *NextEntryId, *RptEntry, rv)) {
+        return rv;
+    }
 
     ClientRpcParams iparams(&EntryId);
     ClientRpcParams oparams(NextEntryId, RptEntry);
@@ -357,6 +362,9 @@ SaErrorT SAHPI_API saHpiRptEntryGetByResourceId(
     if (ResourceId == SAHPI_UNSPECIFIED_RESOURCE_ID || (!RptEntry)) {
         return SA_ERR_HPI_INVALID_PARAMS;
     }
+    if (ohc_cache_rpt_entry_get_by_rid(SessionId, ResourceId, *RptEntry, rv)) {
+        return rv;
+    }
 
     ClientRpcParams iparams(&ResourceId);
     ClientRpcParams oparams(RptEntry);
@@ -395,6 +403,7 @@ SaErrorT SAHPI_API saHpiResourceSeveritySet(
     ClientRpcParams iparams(&ResourceId, &Severity);
     ClientRpcParams oparams;
     rv = ohc_sess_rpc(eFsaHpiResourceSeveritySet, SessionId, iparams, oparams);
+    ohc_cache_invalidate(SessionId, ResourceId);
 
     return rv;
 }
@@ -418,6 +427,7 @@ SaErrorT SAHPI_API saHpiResourceTagSet(
     ClientRpcParams iparams(&ResourceId, ResourceTag);
     ClientRpcParams oparams;
     rv = ohc_sess_rpc(eFsaHpiResourceTagSet, SessionId, iparams, oparams);
+    ohc_cache_invalidate(SessionId, ResourceId);
 
     return rv;
 }
@@ -597,6 +607,7 @@ SaErrorT SAHPI_API saHpiResourceFailedRemove(
     ClientRpcParams iparams(&ResourceId);
     ClientRpcParams oparams;
     rv = ohc_sess_rpc(eFsaHpiResourceFailedRemove, SessionId, iparams, oparams);
+    ohc_cache_invalidate(SessionId, ResourceId);
 
     return rv;
 }
@@ -932,6 +943,8 @@ SaErrorT SAHPI_API saHpiEventGet(
     }
 
     if (rv == SA_OK)  {
+        ohc_cache_event(SessionId, *Event);
+
         SaHpiEntityPathT entity_root;
         rv = ohc_sess_get_entity_root(SessionId, entity_root);
         if ((rv == SA_OK) && RptEntry) {
@@ -1146,6 +1159,9 @@ SaErrorT SAHPI_API saHpiRdrGet(
     if (EntryId == SAHPI_LAST_ENTRY || !Rdr || !NextEntryId) {
         return SA_ERR_HPI_INVALID_PARAMS;
     }
+    if (ohc_cache_rdr_get(SessionId, ResourceId, EntryId, *NextEntryId, *Rdr, rv)) {
+        return rv;
+    }
 
     ClientRpcParams iparams(&ResourceId, &EntryId);
     ClientRpcParams oparams(NextEntryId, Rdr);
@@ -1179,6 +1195,10 @@ SaErrorT SAHPI_API saHpiRdrGetByInstrumentId(
     if (!oh_lookup_rdrtype(RdrType) || RdrType == SAHPI_NO_RECORD || !Rdr) {
         return SA_ERR_HPI_INVALID_PARAMS;
     }
+    if (ohc_cache_rdr_get_by_instrument_id(SessionId, ResourceId,
+                                           RdrType, InstrumentId, *Rdr, rv)) {
+        return rv;
+    }
 
     ClientRpcParams iparams(&ResourceId, &RdrType, &InstrumentId);
     ClientRpcParams oparams(Rdr);
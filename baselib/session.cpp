@@ -27,8 +27,10 @@
 #include <strmsock.h>
 
 #include "conf.h"
+#include "connection.h"
 #include "init.h"
 #include "lock.h"
+#include "rptcache.h"
 #include "session.h"
 #include <sahpi_wrappers.h>
 
@@ -182,7 +184,8 @@ SaErrorT cSession::DoRpc( uint32_t id,
     }
 
     int cc;
-    char data[dMaxPayloadLength];
+    cMsgBuffer buffer;
+    char * data = buffer.Data();
     uint32_t data_len;
     uint8_t  rp_type;
     uint32_t rp_id;
@@ -199,6 +202,22 @@ SaErrorT cSession::DoRpc( uint32_t id,
         if ( attempt > 0 ) {
             DBG( "Session: RPC request %u, Attempt %u\n", id, (unsigned int)attempt );
         }
+        // The shared connection is used unless the daemon cannot multiplex
+        ohc_conn_cc conn_cc = ohc_conn_rpc( m_did,
+                                            id,
+                                            data,
+                                            data_len,
+                                            rp_type,
+                                            rp_id,
+                                            rp_byte_order );
+        if ( conn_cc == eConnOk ) {
+            rc = true;
+            break;
+        } else if ( conn_cc == eConnFailed ) {
+            g_usleep( NEXT_RPC_ATTEMPT_TIMEOUT );
+            continue;
+        }
+
         cClientStreamSock * sock;
         rv = GetSock( sock );
         if ( rv != SA_OK ) {
@@ -397,6 +416,9 @@ SaErrorT ohc_sess_close( SaHpiSessionIdT sid )
     }
 
     SaErrorT rv = session->RpcClose();
+    if ( rv == SA_OK ) {
+        ohc_cache_drop( sid );
+    }
     sessions_unref( session, ( rv == SA_OK ) );
 
     return rv;
@@ -415,6 +437,7 @@ SaErrorT ohc_sess_close_all()
         while ( item ) {
             cSession * session = reinterpret_cast<cSession*>(item->data);
             session->RpcClose();
+            ohc_cache_drop( session->GetSid() );
             sessions_unref( session, true );
             item = item->next;
         }
@@ -0,0 +1,288 @@
+/*
+ * Test the client RPT and RDR cache against a fake daemon:
+ * - cached entries are served without a round trip,
+ * - a resource event drops the RPT of all sessions of the domain,
+ * - saHpiDiscover (ohc_cache_invalidate of all resources) drops the RDRs,
+ * - data fetched while the cache was dropped is never served.
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SaHpi.h>
+
+#include <marshal_hpi.h>
+#include <oh_rpc_params.h>
+
+#include "rptcache.h"
+#include "session.h"
+
+
+#define dNumResources 3
+
+// dSid1 and dSid2 are sessions of domain 1, dSid3 of domain 2
+static const SaHpiSessionIdT dSid1 = 1;
+static const SaHpiSessionIdT dSid2 = 2;
+static const SaHpiSessionIdT dSid3 = 3;
+
+static int num_fail = 0;
+
+#define Test(expr) \
+    if ( !( expr ) ) { \
+        printf( "FAIL %s:%d: %s\n", __FILE__, __LINE__, #expr ); \
+        ++num_fail; \
+    }
+
+
+/***************************************************************
+ * Fake daemon
+ **************************************************************/
+static SaHpiRptEntryT  rpt[dNumResources];
+static SaHpiUint32T    rpt_update_count = 0;
+static SaHpiRdrT       rdr[dNumResources]; // one RDR per resource
+static SaHpiUint32T    rdr_update_count[dNumResources];
+static int             rpcs = 0;
+// Session whose cache is dropped during the next RPT walk
+static SaHpiSessionIdT drop_during_walk = 0;
+
+static void daemon_init()
+{
+    memset( rpt, 0, sizeof(rpt) );
+    memset( rdr, 0, sizeof(rdr) );
+    for ( int i = 0; i < dNumResources; ++i ) {
+        rpt[i].EntryId = i + 1;
+        rpt[i].ResourceId = 10 + i;
+        rpt[i].ResourceEntity.Entry[0].EntityType = SAHPI_ENT_SYSTEM_BOARD;
+        rpt[i].ResourceEntity.Entry[0].EntityLocation = i;
+        rpt[i].ResourceEntity.Entry[1].EntityType = SAHPI_ENT_ROOT;
+        rpt[i].ResourceCapabilities = SAHPI_CAPABILITY_RESOURCE | SAHPI_CAPABILITY_RDR;
+        rpt[i].ResourceInfo.FirmwareMajorRev = 1;
+        rdr[i].RecordId = 1;
+        rdr[i].RdrType = SAHPI_SENSOR_RDR;
+        rdr[i].Entity = rpt[i].ResourceEntity;
+        rdr[i].RdrTypeUnion.SensorRec.Num = 1;
+        rdr[i].RdrTypeUnion.SensorRec.Oem = 1;
+        rdr_update_count[i] = 0;
+    }
+}
+
+static int daemon_index( SaHpiResourceIdT rid )
+{
+    int i = static_cast<int>( rid ) - 10;
+    return ( ( i >= 0 ) && ( i < dNumResources ) ) ? i : -1;
+}
+
+// A resource of the daemon changes, as a firmware update would do
+static void daemon_update_resource( int i )
+{
+    ++rpt[i].ResourceInfo.FirmwareMajorRev;
+    ++rpt_update_count;
+}
+
+static void daemon_update_rdr( int i )
+{
+    ++rdr[i].RdrTypeUnion.SensorRec.Oem;
+    ++rdr_update_count[i];
+}
+
+SaErrorT ohc_sess_rpc( uint32_t id,
+                       SaHpiSessionIdT /* sid */,
+                       ClientRpcParams& iparams,
+                       ClientRpcParams& oparams )
+{
+    ++rpcs;
+
+    switch ( id ) {
+        case eFsaHpiDomainInfoGet: {
+            SaHpiDomainInfoT * info = reinterpret_cast<SaHpiDomainInfoT *>(oparams.array[1]);
+            memset( info, 0, sizeof(SaHpiDomainInfoT) );
+            info->RptUpdateCount = rpt_update_count;
+            return SA_OK;
+        }
+        case eFsaHpiRptEntryGet: {
+            if ( drop_during_walk ) {
+                // Another thread of the application reads a resource event
+                ohc_cache_invalidate( drop_during_walk, SAHPI_UNSPECIFIED_RESOURCE_ID );
+                drop_during_walk = 0;
+            }
+            SaHpiEntryIdT eid = *reinterpret_cast<SaHpiEntryIdT *>(iparams.array[1]);
+            int i = ( eid == SAHPI_FIRST_ENTRY ) ? 0 : static_cast<int>( eid ) - 1;
+            if ( ( i < 0 ) || ( i >= dNumResources ) ) {
+                return SA_ERR_HPI_NOT_PRESENT;
+            }
+            *reinterpret_cast<SaHpiEntryIdT *>(oparams.array[1])
+                = ( i + 1 < dNumResources ) ? rpt[i + 1].EntryId : SAHPI_LAST_ENTRY;
+            *reinterpret_cast<SaHpiRptEntryT *>(oparams.array[2]) = rpt[i];
+            return SA_OK;
+        }
+        case eFsaHpiRdrUpdateCountGet: {
+            int i = daemon_index( *reinterpret_cast<SaHpiResourceIdT *>(iparams.array[1]) );
+            if ( i < 0 ) {
+                return SA_ERR_HPI_INVALID_RESOURCE;
+            }
+            *reinterpret_cast<SaHpiUint32T *>(oparams.array[1]) = rdr_update_count[i];
+            return SA_OK;
+        }
+        case eFsaHpiRdrGet: {
+            int i = daemon_index( *reinterpret_cast<SaHpiResourceIdT *>(iparams.array[1]) );
+            SaHpiEntryIdT eid = *reinterpret_cast<SaHpiEntryIdT *>(iparams.array[2]);
+            if ( i < 0 ) {
+                return SA_ERR_HPI_INVALID_RESOURCE;
+            }
+            if ( ( eid != SAHPI_FIRST_ENTRY ) && ( eid != rdr[i].RecordId ) ) {
+                return SA_ERR_HPI_NOT_PRESENT;
+            }
+            *reinterpret_cast<SaHpiEntryIdT *>(oparams.array[1]) = SAHPI_LAST_ENTRY;
+            *reinterpret_cast<SaHpiRdrT *>(oparams.array[2]) = rdr[i];
+            return SA_OK;
+        }
+        default:
+            return SA_ERR_HPI_UNSUPPORTED_API;
+    }
+}
+
+SaErrorT ohc_sess_get_did( SaHpiSessionIdT sid, SaHpiDomainIdT& did )
+{
+    if ( ( sid != dSid1 ) && ( sid != dSid2 ) && ( sid != dSid3 ) ) {
+        return SA_ERR_HPI_INVALID_SESSION;
+    }
+    did = ( sid == dSid3 ) ? 2 : 1;
+    return SA_OK;
+}
+
+SaErrorT ohc_sess_get_entity_root( SaHpiSessionIdT /* sid */, SaHpiEntityPathT& ep )
+{
+    memset( &ep, 0, sizeof(ep) );
+    ep.Entry[0].EntityType = SAHPI_ENT_ROOT;
+    return SA_OK;
+}
+
+
+/***************************************************************
+ * Checks
+ **************************************************************/
+
+// Walks the RPT through the cache, every entry must match the daemon
+static bool rpt_current( SaHpiSessionIdT sid )
+{
+    SaHpiEntryIdT id = SAHPI_FIRST_ENTRY;
+    int n = 0;
+    while ( id != SAHPI_LAST_ENTRY ) {
+        SaHpiEntryIdT next;
+        SaHpiRptEntryT rpte;
+        SaErrorT rv;
+        if ( !ohc_cache_rpt_entry_get( sid, id, next, rpte, rv ) ) {
+            return false;
+        }
+        if ( ( rv != SA_OK ) || ( n >= dNumResources ) ) {
+            return false;
+        }
+        if ( ( rpte.ResourceId != rpt[n].ResourceId ) ||
+             ( rpte.ResourceInfo.FirmwareMajorRev != rpt[n].ResourceInfo.FirmwareMajorRev ) ) {
+            return false;
+        }
+        id = next;
+        ++n;
+    }
+    return ( n == dNumResources );
+}
+
+static SaHpiUint8T rev_by_rid( SaHpiSessionIdT sid, SaHpiResourceIdT rid )
+{
+    SaHpiRptEntryT rpte;
+    SaErrorT rv;
+    if ( !ohc_cache_rpt_entry_get_by_rid( sid, rid, rpte, rv ) || ( rv != SA_OK ) ) {
+        return 0;
+    }
+    return rpte.ResourceInfo.FirmwareMajorRev;
+}
+
+static SaHpiUint32T oem_of_rdr( SaHpiSessionIdT sid, SaHpiResourceIdT rid )
+{
+    SaHpiEntryIdT next;
+    SaHpiRdrT r;
+    SaErrorT rv;
+    if ( !ohc_cache_rdr_get( sid, rid, SAHPI_FIRST_ENTRY, next, r, rv ) || ( rv != SA_OK ) ) {
+        return 0;
+    }
+    return r.RdrTypeUnion.SensorRec.Oem;
+}
+
+
+int main( int /* argc */, char ** /* argv */ )
+{
+    // Long enough that only invalidation makes the cache fetch again
+    setenv( "OPENHPI_CLIENT_CACHE", "600000", 1 );
+
+    daemon_init();
+
+    Test( rpt_current( dSid1 ) );
+    Test( rpt_current( dSid2 ) );
+    Test( rpt_current( dSid3 ) );
+    Test( oem_of_rdr( dSid1, 10 ) == 1 );
+
+    // Cached data costs no round trip
+    rpcs = 0;
+    Test( rpt_current( dSid1 ) );
+    Test( rev_by_rid( dSid1, 11 ) == 1 );
+    Test( oem_of_rdr( dSid1, 10 ) == 1 );
+    Test( rpcs == 0 );
+
+    // RPT change event: all sessions of the domain see the new entry
+    daemon_update_resource( 1 );
+    SaHpiEventT event;
+    memset( &event, 0, sizeof(event) );
+    event.Source = rpt[1].ResourceId;
+    event.EventType = SAHPI_ET_RESOURCE;
+    event.EventDataUnion.ResourceEvent.ResourceEventType = SAHPI_RESE_RESOURCE_UPDATED;
+    ohc_cache_event( dSid1, event );
+    Test( rev_by_rid( dSid1, 11 ) == 2 );
+    Test( rev_by_rid( dSid2, 11 ) == 2 );
+    Test( rpt_current( dSid2 ) );
+
+    // The RDRs of other resources stay cached
+    rpcs = 0;
+    Test( oem_of_rdr( dSid1, 10 ) == 1 );
+    Test( rpcs == 0 );
+
+    // Sessions of other domains keep their data
+    rpcs = 0;
+    Test( rev_by_rid( dSid3, 11 ) != 0 );
+    Test( rpcs == 0 );
+
+    // saHpiDiscover drops the RPT and all RDRs
+    daemon_update_resource( 0 );
+    daemon_update_rdr( 0 );
+    ohc_cache_invalidate( dSid1, SAHPI_UNSPECIFIED_RESOURCE_ID );
+    Test( rpt_current( dSid1 ) );
+    Test( rev_by_rid( dSid2, 10 ) == 2 );
+    Test( oem_of_rdr( dSid1, 10 ) == 2 );
+
+    // Dropped during the walk: the fetched RPT is not served
+    daemon_update_resource( 2 );
+    ohc_cache_invalidate( dSid1, SAHPI_UNSPECIFIED_RESOURCE_ID );
+    drop_during_walk = dSid2;
+    SaHpiEntryIdT next;
+    SaHpiRptEntryT rpte;
+    SaErrorT rv;
+    Test( !ohc_cache_rpt_entry_get( dSid1, SAHPI_FIRST_ENTRY, next, rpte, rv ) );
+    Test( rpt_current( dSid1 ) );
+    Test( rev_by_rid( dSid1, 12 ) == 2 );
+
+    ohc_cache_drop( dSid1 );
+    ohc_cache_drop( dSid2 );
+    ohc_cache_drop( dSid3 );
+
+    return ( num_fail == 0 ) ? 0 : 1;
+}
@@ -25,9 +25,13 @@
  */
 
 #include "oh_clients.h"
+#include <sahpi_wrappers.h>
 
 #define OH_SVN_REV "$Revision$"
 
+/* Entries asked for by each oHpiEventLogEntriesGet() call */
+#define HPIEL_BULK_ENTRIES 256
+
 #define show_error_quit(msg) \
         do { \
                 if (error) { \
@@ -42,7 +46,9 @@ static struct hpiel_opts {
         gboolean  clear;      /* Clear the event log before traversing it. */
         gboolean  resource;   /* Get resource along with event log entry. */
         gboolean  rdr;        /* Get RDR along with event log entry. */
-} opts = { FALSE, FALSE, FALSE, FALSE };
+        gint      jobs;       /* Sessions reading event logs at once. */
+        gboolean  timing;     /* Show how long reading the logs took. */
+} opts = { FALSE, FALSE, FALSE, FALSE, 1, FALSE };
 static oHpiCommonOptionsT copt;
 
 static GOptionEntry my_options[] =
@@ -51,9 +57,37 @@ static GOptionEntry my_options[] =
   { "clear",    'c', 0, G_OPTION_ARG_NONE, &opts.clear,    "Clear log before reading event log entries", NULL },
   { "resource", 'p', 0, G_OPTION_ARG_NONE, &opts.resource, "Pull resource info along with log entry",    NULL },
   { "rdr",      'r', 0, G_OPTION_ARG_NONE, &opts.rdr,      "Pull RDR info along with log entry",         NULL },
+  { "jobs",     'j', 0, G_OPTION_ARG_INT,  &opts.jobs,     "Read up to nn event logs at once, over separate sessions", "nn" },
+  { "timing",   't', 0, G_OPTION_ARG_NONE, &opts.timing,   "Show how long reading the event logs took",  NULL },
   { NULL }
 };
 
+/* An event log, read by read_el() and then shown by print_el() */
+struct el_dump {
+        SaHpiResourceIdT   rid;
+        SaHpiTextBufferT   tag;
+        SaHpiEntityPathT   ep;          /* Resource event logs only */
+        SaErrorT           info_error;
+        SaHpiEventLogInfoT info;
+        gboolean           cleared;
+        SaErrorT           clear_error;
+        SaErrorT           error;       /* Reading the entries */
+        GArray             *entries;    /* SaHpiEventLogEntryT */
+        GArray             *rdrs;       /* SaHpiRdrT */
+        GArray             *rptentries; /* SaHpiRptEntryT */
+        guint              calls;       /* Entry get calls made */
+        gdouble            seconds;
+        gboolean           done;
+};
+
+/* Event logs shared with the harvest_worker() threads */
+static struct {
+        GPtrArray *dumps;
+        guint     next;                 /* Next log to read */
+        GMutex    *lock;
+        GCond     *cond;                /* Signalled when a log is read */
+} harvest;
+
 
 SaHpiDomainIdT domainid = SAHPI_UNSPECIFIED_DOMAIN_ID;
 
@@ -90,6 +124,11 @@ int main(int argc, char **argv)
 	}
         g_option_context_free (context);
 
+        if (opts.jobs < 1) {
+                CRIT("Invalid number of sessions %d.", opts.jobs);
+                return 1;
+        }
+
         /* Program really begins here - all options parsed at this point */
         error = ohc_session_open_by_option ( &copt, &sid);
         show_error_quit("saHpiSessionOpen() returned %s. Exiting.\n");
@@ -121,20 +160,313 @@ int main(int argc, char **argv)
         return error;
 }
 
-SaErrorT harvest_sels(SaHpiSessionIdT sid, SaHpiDomainInfoT *dinfo)
+static struct el_dump *new_el_dump(SaHpiResourceIdT rid, SaHpiTextBufferT *tag)
+{
+        struct el_dump *d = g_new0(struct el_dump, 1);
+
+        d->rid = rid;
+        d->tag = *tag;
+        d->entries = g_array_new(FALSE, FALSE, sizeof(SaHpiEventLogEntryT));
+        d->rdrs = g_array_new(FALSE, FALSE, sizeof(SaHpiRdrT));
+        d->rptentries = g_array_new(FALSE, FALSE, sizeof(SaHpiRptEntryT));
+
+        return d;
+}
+
+static void free_el_dump(struct el_dump *d)
+{
+        g_array_free(d->entries, TRUE);
+        g_array_free(d->rdrs, TRUE);
+        g_array_free(d->rptentries, TRUE);
+        g_free(d);
+}
+
+/* Reads the log oHpiEventLogEntriesGet() at a time */
+static SaErrorT read_entries_bulk(SaHpiSessionIdT sid, struct el_dump *d)
+{
+        SaErrorT error = SA_OK;
+        SaHpiEventLogEntryIdT entryid, nextentryid;
+        oHpiEventLogEntriesT chunk;
+
+        entryid = SAHPI_OLDEST_ENTRY;
+        while (entryid != SAHPI_NO_MORE_ENTRIES) {
+                /* RDR and RPT entry give the entity path of each entry */
+                error = oHpiEventLogEntriesGet(sid, d->rid, entryid,
+                                               HPIEL_BULK_ENTRIES,
+                                               SAHPI_TRUE, SAHPI_TRUE,
+                                               &nextentryid, &chunk);
+                if (copt.debug) 
+                   CRIT ("oHpiEventLogEntriesGet() returned %s\n", 
+                         oh_lookup_error(error));
+                if (error != SA_OK) {
+                        return error;
+                }
+                d->calls++;
+
+                g_array_append_vals(d->entries, chunk.Entries,
+                                    chunk.NumberOfEntries);
+                g_array_append_vals(d->rdrs, chunk.Rdrs, chunk.NumberOfRdrs);
+                g_array_append_vals(d->rptentries, chunk.RptEntries,
+                                    chunk.NumberOfRptEntries);
+                g_free(chunk.Entries);
+                g_free(chunk.Rdrs);
+                g_free(chunk.RptEntries);
+
+                entryid = nextentryid;
+        }
+
+        return SA_OK;
+}
+
+/* Reads the log one saHpiEventLogEntryGet() at a time */
+static SaErrorT read_entries(SaHpiSessionIdT sid, struct el_dump *d)
+{
+        SaErrorT error = SA_OK;
+        SaHpiEventLogEntryIdT entryid, nextentryid, preventryid;
+        SaHpiEventLogEntryT elentry;
+        SaHpiRdrT rdr;
+        SaHpiRptEntryT res;
+
+        entryid = SAHPI_OLDEST_ENTRY;
+        while (entryid != SAHPI_NO_MORE_ENTRIES) {
+                error = saHpiEventLogEntryGet(sid, d->rid,
+                                              entryid, &preventryid,
+                                              &nextentryid, &elentry,
+                                              &rdr,
+                                              &res);
+
+                if (copt.debug) 
+                   CRIT ("saHpiEventLogEntryGet() returned %s\n", 
+                         oh_lookup_error(error));
+                if (error != SA_OK) {
+                        return error;
+                }
+                d->calls++;
+
+                g_array_append_val(d->entries, elentry);
+                g_array_append_val(d->rdrs, rdr);
+                g_array_append_val(d->rptentries, res);
+
+                entryid = nextentryid;
+        }
+
+        return SA_OK;
+}
+
+static void read_el(SaHpiSessionIdT sid, struct el_dump *d)
+{
+        GTimer *timer = g_timer_new();
+
+        d->info_error = saHpiEventLogInfoGet(sid, d->rid, &d->info);
+        if (d->info_error == SA_OK && d->info.Entries != 0) {
+                if (opts.clear) {
+                        d->cleared = TRUE;
+                        d->clear_error = saHpiEventLogClear(sid, d->rid);
+                }
+                if (d->clear_error == SA_OK) {
+                        d->error = read_entries_bulk(sid, d);
+                        if (d->error == SA_ERR_HPI_UNSUPPORTED_API) {
+                                /* Daemon without the bulk call */
+                                d->error = read_entries(sid, d);
+                        }
+                }
+        }
+
+        d->seconds = g_timer_elapsed(timer, NULL);
+        g_timer_destroy(timer);
+}
+
+static SaErrorT print_el(struct el_dump *d)
+{
+        guint i;
+
+        if (d->info_error) {
+                if (copt.debug) CRIT("saHpiEventLogInfoGet() returned %s. Exiting\n",
+                    oh_lookup_error(d->info_error));
+                return d->info_error;
+        }
+
+        printf("EventLogInfo for %s, ResourceId %u\n",
+               d->tag.Data, d->rid);
+        oh_print_eventloginfo(&d->info, 4);
+
+        if (d->info.Entries == 0) {
+                printf("%s Resource %u has an empty event log.\n", d->tag.Data, d->rid);
+                return SA_OK;
+        }
+
+        if (d->cleared) {
+                if (d->clear_error == SA_OK)
+                        printf("EventLog successfully cleared\n");
+                else {
+                        printf("saHpiEventLogClear() returned %s\n",
+                               oh_lookup_error(d->clear_error));
+                        return d->clear_error;
+                }
+
+        }
+
+        for (i = 0; i < d->entries->len; i++) {
+                SaHpiEventLogEntryT *elentry =
+                        &g_array_index(d->entries, SaHpiEventLogEntryT, i);
+                SaHpiRdrT *rdr = &g_array_index(d->rdrs, SaHpiRdrT, i);
+                SaHpiRptEntryT *res =
+                        &g_array_index(d->rptentries, SaHpiRptEntryT, i);
+                SaHpiEntityPathT *ep = NULL;
+
+                /* Get a reference to the entity path for this log entry */
+                if (res->ResourceCapabilities) {
+                        ep = &res->ResourceEntity;
+                } else if (rdr->RdrType != SAHPI_NO_RECORD) {
+                        ep = &rdr->Entity;
+                }
+                /* Print the event log entry */
+                oh_print_eventlogentry(elentry, ep, 6);
+                if (opts.rdr) {
+                        if (rdr->RdrType == SAHPI_NO_RECORD)
+                                printf("            No RDR associated with EventType =  %s\n\n",
+                                       oh_lookup_eventtype(elentry->Event.EventType));
+                        else
+                                oh_print_rdr(rdr, 12);
+                }
+
+                if (opts.resource) {
+                        if (res->ResourceCapabilities == 0)
+                                printf("            No RPT associated with EventType =  %s\n\n",
+                                       oh_lookup_eventtype(elentry->Event.EventType));
+                        else
+                                oh_print_rptentry(res, 10);
+                }
+        }
+
+        if (opts.timing) {
+                printf("Read %u entries of ResourceId %u in %u calls, %.3f sec\n",
+                       d->entries->len, d->rid, d->calls, d->seconds);
+        }
+
+        return d->error;
+}
+
+static SaErrorT print_resource_el(struct el_dump *d)
+{
+        oh_big_textbuffer bigbuf;
+
+        oh_init_bigtext(&bigbuf);
+        oh_decode_entitypath(&d->ep, &bigbuf);
+        printf("%s\n", bigbuf.Data);
+        printf("rptentry[%u] tag: %s\n", d->rid, d->tag.Data);
+
+        return print_el(d);
+}
+
+/* Reads event logs over its own session until none is left */
+static gpointer harvest_worker(gpointer data)
+{
+        SaErrorT error;
+        SaHpiSessionIdT sid;
+        struct el_dump *d;
+
+        error = ohc_session_open_by_option(&copt, &sid);
+
+        for (;;) {
+                wrap_g_mutex_lock(harvest.lock);
+                if (harvest.next >= harvest.dumps->len) {
+                        wrap_g_mutex_unlock(harvest.lock);
+                        break;
+                }
+                d = g_ptr_array_index(harvest.dumps, harvest.next++);
+                wrap_g_mutex_unlock(harvest.lock);
+
+                if (error == SA_OK) {
+                        read_el(sid, d);
+                } else {
+                        d->info_error = error;
+                }
+
+                wrap_g_mutex_lock(harvest.lock);
+                d->done = TRUE;
+                g_cond_broadcast(harvest.cond);
+                wrap_g_mutex_unlock(harvest.lock);
+        }
+
+        if (error == SA_OK) {
+                saHpiSessionClose(sid);
+        }
+
+        return NULL;
+}
+
+/* Reads the logs over njobs sessions and prints them in RPT order */
+static SaErrorT show_els_parallel(GPtrArray *dumps, guint njobs, guint *shown)
 {
         SaErrorT error = SA_OK;
+        GThread **workers;
+        struct el_dump *d;
+        guint i;
+
+        if (g_thread_supported() == FALSE) {
+                wrap_g_thread_init(0);
+        }
+
+        harvest.dumps = dumps;
+        harvest.next = 0;
+        harvest.lock = wrap_g_mutex_new_init();
+        harvest.cond = wrap_g_cond_new_init();
+
+        workers = g_new0(GThread *, njobs);
+        for (i = 0; i < njobs; i++) {
+                workers[i] = wrap_g_thread_create_new("hpiel", harvest_worker,
+                                                      NULL, TRUE, NULL);
+        }
+
+        for (i = 0; i < dumps->len && error == SA_OK; i++) {
+                d = g_ptr_array_index(dumps, i);
+
+                wrap_g_mutex_lock(harvest.lock);
+                while (!d->done) {
+                        g_cond_wait(harvest.cond, harvest.lock);
+                }
+                wrap_g_mutex_unlock(harvest.lock);
+
+                error = print_resource_el(d);
+                *shown += d->entries->len;
+        }
+
+        /* On error, let the workers finish the logs they are reading */
+        wrap_g_mutex_lock(harvest.lock);
+        harvest.next = dumps->len;
+        wrap_g_mutex_unlock(harvest.lock);
+        for (i = 0; i < njobs; i++) {
+                g_thread_join(workers[i]);
+        }
+        g_free(workers);
+
+        wrap_g_cond_free(harvest.cond);
+        wrap_g_mutex_free_clear(harvest.lock);
+
+        return error;
+}
+
+SaErrorT harvest_sels(SaHpiSessionIdT sid, SaHpiDomainInfoT *dinfo)
+{
+        SaErrorT error = SA_OK, show_error = SA_OK;
         SaHpiRptEntryT rptentry;
         SaHpiEntryIdT entryid, nextentryid;
         SaHpiResourceIdT rid;
-        oh_big_textbuffer bigbuf;
         SaHpiBoolT found_entry = SAHPI_FALSE;
+        GPtrArray *dumps;
+        struct el_dump *d;
+        GTimer *timer;
+        guint shown = 0, nsessions = 1, i;
 
         if (!sid || !dinfo) {
                 if (copt.debug) CRIT("Invalid parameters in havest_sels()\n");
                 return SA_ERR_HPI_INVALID_PARAMS;
         }
 
+        timer = g_timer_new();
+        dumps = g_ptr_array_new();
+
         entryid = SAHPI_FIRST_ENTRY;
         while (error == SA_OK && entryid != SAHPI_LAST_ENTRY) {
                 error = saHpiRptEntryGet(sid, entryid, &nextentryid, &rptentry);
@@ -161,19 +493,41 @@ SaErrorT harvest_sels(SaHpiSessionIdT sid, SaHpiDomainInfoT *dinfo)
                             rid, rptentry.ResourceCapabilities);
                         rptentry.ResourceTag.Data[rptentry.ResourceTag.DataLength] = 0;
 
-                        oh_init_bigtext(&bigbuf);
-                        error = oh_decode_entitypath(&rptentry.ResourceEntity, &bigbuf);
-                        printf("%s\n", bigbuf.Data);
-                        printf("rptentry[%u] tag: %s\n", rid, rptentry.ResourceTag.Data);
-
-                        error = display_el(sid, rid, &rptentry.ResourceTag);
+                        d = new_el_dump(rid, &rptentry.ResourceTag);
+                        d->ep = rptentry.ResourceEntity;
+                        g_ptr_array_add(dumps, d);
 
-                        if (copt.withentitypath) return SA_OK;
+                        if (copt.withentitypath) break;
                 }
 
                 entryid = nextentryid;
         }
 
+        if (opts.jobs > 1 && dumps->len > 1) {
+                nsessions = MIN((guint)opts.jobs, dumps->len);
+                show_error = show_els_parallel(dumps, nsessions, &shown);
+        } else {
+                for (i = 0; i < dumps->len && show_error == SA_OK; i++) {
+                        d = g_ptr_array_index(dumps, i);
+                        read_el(sid, d);
+                        show_error = print_resource_el(d);
+                        shown += d->entries->len;
+                }
+        }
+        if (show_error != SA_OK) error = show_error;
+
+        if (opts.timing) {
+                printf("Read %u entries from %u event logs in %.3f sec, %u session(s)\n",
+                       shown, dumps->len, g_timer_elapsed(timer, NULL),
+                       nsessions);
+        }
+        g_timer_destroy(timer);
+
+        for (i = 0; i < dumps->len; i++) {
+                free_el_dump(g_ptr_array_index(dumps, i));
+        }
+        g_ptr_array_free(dumps, TRUE);
+
         if (!found_entry) {
                 if (copt.withentitypath) {
                            CRIT("Could not find resource matching entity path.");
@@ -188,89 +542,18 @@ SaErrorT harvest_sels(SaHpiSessionIdT sid, SaHpiDomainInfoT *dinfo)
 
 SaErrorT display_el(SaHpiSessionIdT sid, SaHpiResourceIdT rid, SaHpiTextBufferT *tag)
 {
-        SaErrorT error = SA_OK;
-        SaHpiEventLogEntryIdT entryid, nextentryid, preventryid;
-        SaHpiEventLogInfoT elinfo;
-        SaHpiEventLogEntryT elentry;
-        SaHpiRdrT rdr;
-        SaHpiRptEntryT res;
+        SaErrorT error;
+        struct el_dump *d;
 
         if (!sid || !rid) {
                 if (copt.debug) CRIT("Invalid parameters in display_el().");
                 return SA_ERR_HPI_INVALID_PARAMS;
         }
 
-        error = saHpiEventLogInfoGet(sid, rid, &elinfo);
-        if (error) {
-                if (copt.debug) CRIT("saHpiEventLogInfoGet() returned %s. Exiting\n",
-                    oh_lookup_error(error));
-                return error;
-        }
-
-        printf("EventLogInfo for %s, ResourceId %u\n",
-               tag->Data, rid);
-        oh_print_eventloginfo(&elinfo, 4);
-
-        if (elinfo.Entries == 0) {
-                printf("%s Resource %u has an empty event log.\n", tag->Data, rid);
-                return SA_OK;
-        }
-
-        if (opts.clear) {
-                error = saHpiEventLogClear(sid, rid);
-                if (error == SA_OK)
-                        printf("EventLog successfully cleared\n");
-                else {
-                        printf("saHpiEventLogClear() returned %s\n",
-                               oh_lookup_error(error));
-                        return error;
-                }
+        d = new_el_dump(rid, tag);
+        read_el(sid, d);
+        error = print_el(d);
+        free_el_dump(d);
 
-        }
-
-        entryid = SAHPI_OLDEST_ENTRY;
-        while (entryid != SAHPI_NO_MORE_ENTRIES) {
-                error = saHpiEventLogEntryGet(sid, rid,
-                                              entryid, &preventryid,
-                                              &nextentryid, &elentry,
-                                              &rdr,
-                                              &res);
-
-                if (copt.debug) 
-                   CRIT ("saHpiEventLogEntryGet() returned %s\n", 
-                         oh_lookup_error(error));
-                if (error == SA_OK) {
-                	SaHpiEntityPathT *ep = NULL;
-                	/* Get a reference to the entity path for this log entry */
-                	if (res.ResourceCapabilities) {
-                		ep = &res.ResourceEntity;
-                	} else if (rdr.RdrType != SAHPI_NO_RECORD) {
-                		ep = &rdr.Entity;
-                	}
-                	/* Print the event log entry */
-                        oh_print_eventlogentry(&elentry, ep, 6);
-                        if (opts.rdr) {
-                                if (rdr.RdrType == SAHPI_NO_RECORD)
-                                        printf("            No RDR associated with EventType =  %s\n\n",
-                                               oh_lookup_eventtype(elentry.Event.EventType));
-                                else
-                                        oh_print_rdr(&rdr, 12);
-                        }
-
-                        if (opts.resource) {
-                                if (res.ResourceCapabilities == 0)
-                                        printf("            No RPT associated with EventType =  %s\n\n",
-                                               oh_lookup_eventtype(elentry.Event.EventType));
-                                else
-                                        oh_print_rptentry(&res, 10);
-                        }
-
-                        preventryid = entryid;
-                        entryid = nextentryid;
-                } else {
-                        return error;
-                }
-        }
-
-        return SA_OK;
+        return error;
 }
@@ -22,6 +22,7 @@
  * 02/01/11 ulikleber  Refactoring to use glib for option parsing and
  *                     introduce common options for all clients
  * 05/18/11 (klw) Fix in fumi data encapsulate FUMI_DATA
+ * 10/18/26       Option --binary writes a binary snapshot (new_sim_snapshot.h)
  *  
  * Open:
  * - print all events of a system (not clear if necessary) 
@@ -35,6 +36,7 @@
  */
 
 #include "oh_clients.h"
+#include "new_sim_snapshot.h"
 
 #define OH_SVN_REV "$Revision: 6571 $"
 #define GEN_SIM_DATA_VERSION "0.901000"
@@ -86,6 +88,7 @@ typedef struct {
 static gint g_resourceid = (gint) SAHPI_UNSPECIFIED_RESOURCE_ID;
 static gchar *g_file = NULL;
 static gchar *g_mode = NULL;
+static gboolean g_binary = FALSE;
 static oHpiCommonOptionsT copt;
 
 static GOptionEntry my_options[] =
@@ -93,6 +96,7 @@ static GOptionEntry my_options[] =
   { "resource", 'r', 0, G_OPTION_ARG_INT,      &g_resourceid, "Select particular resource id for an update file", "res_id"   },
   { "file",     'f', 0, G_OPTION_ARG_FILENAME, &g_file,       "Name of the file to be generated",                 "filename" },
   { "mode",     'm', 0, G_OPTION_ARG_STRING,   &g_mode,       "Write update or initial file",                     "UPD|INIT" },
+  { "binary",   'b', 0, G_OPTION_ARG_NONE,     &g_binary,     "Write a binary snapshot (initial file only, needs -f)", NULL },
   { NULL }
 };
 
@@ -285,6 +289,50 @@ static void       print_textbuffer(FILE *out,
                                      int offset, 
                                      SaHpiTextBufferT data);
 
+static SaErrorT    snapshot_resources(SimSnapshotWriterT *writer,
+                                       SaHpiSessionIdT sessionid,
+                                       SaHpiResourceIdT res_id);
+
+static SaErrorT    snapshot_rdr(SimSnapshotWriterT *writer,
+                                 SaHpiSessionIdT sessionid,
+                                 SaHpiResourceIdT resId,
+                                 SaHpiRdrT *rdrptr);
+
+static SaErrorT    snapshot_sensor(SimSnapshotWriterT *writer,
+                                    SaHpiSessionIdT sessionId,
+                                    SaHpiResourceIdT resId,
+                                    SaHpiSensorRecT *sens);
+
+static SaErrorT    snapshot_control(SimSnapshotWriterT *writer,
+                                     SaHpiSessionIdT sessionId,
+                                     SaHpiResourceIdT resId,
+                                     SaHpiCtrlRecT *ctrl);
+
+static SaErrorT    snapshot_inventory(SimSnapshotWriterT *writer,
+                                       SaHpiSessionIdT sessionId,
+                                       SaHpiResourceIdT resId,
+                                       SaHpiInventoryRecT *inv);
+
+static SaErrorT    snapshot_watchdog(SimSnapshotWriterT *writer,
+                                      SaHpiSessionIdT sessionId,
+                                      SaHpiResourceIdT resId,
+                                      SaHpiWatchdogRecT *wdt);
+
+static SaErrorT    snapshot_annunciator(SimSnapshotWriterT *writer,
+                                         SaHpiSessionIdT sessionId,
+                                         SaHpiResourceIdT resId,
+                                         SaHpiAnnunciatorRecT *ann);
+
+static SaErrorT    snapshot_dimi(SimSnapshotWriterT *writer,
+                                  SaHpiSessionIdT sessionId,
+                                  SaHpiResourceIdT resId,
+                                  SaHpiDimiRecT *dimi);
+
+static SaErrorT    snapshot_fumi(SimSnapshotWriterT *writer,
+                                  SaHpiSessionIdT sessionId,
+                                  SaHpiResourceIdT resId,
+                                  SaHpiFumiRecT *fumi);
+
 static SaErrorT    print_ep(FILE *out, 
                              int offset, 
                              const SaHpiEntityPathT *ep);
@@ -323,7 +371,13 @@ int main(int argc, char **argv) {
 		return 1;
 	}
 
-	if (g_file) {
+	if (g_binary && !g_file) {
+		fprintf(stderr, "\nA binary snapshot needs a file name (-f).\n");
+                GFREE
+		return 1;
+	}
+
+	if (g_file && !g_binary) {
 		outfile = fopen(g_file, "w");
 		if (outfile == NULL) {
 			CRIT("%s couldn't be opened for writing.", g_file);
@@ -344,12 +398,18 @@ int main(int argc, char **argv) {
 			confdata.mode = MODE_INIT;
 		} else {
 			fprintf(stderr, "\nUnknown mode %s.\n", g_mode);
-                        if (g_file)	fclose(outfile);
+                        if (g_file && !g_binary)	fclose(outfile);
                         GFREE
 			return 1;
 		}
 	}
 
+	if (g_binary && confdata.mode == MODE_UPD) {
+		fprintf(stderr, "\nA binary snapshot is always an initial file.\n");
+                GFREE
+		return 1;
+	}
+
 	/**
 	 * Initialize the offset strings
 	 **/
@@ -361,11 +421,12 @@ int main(int argc, char **argv) {
 		offSet[j][OFFSET_STEP*j] = '\0';
 	}
 
-	print_header(outfile, 0, confdata);
+	if (!g_binary)
+		print_header(outfile, 0, confdata);
 	
         rv = ohc_session_open_by_option ( &copt, &sessionid);
 	if (rv != SA_OK) {
-                if (g_file)	fclose(outfile);
+                if (g_file && !g_binary)	fclose(outfile);
                 GFREE
 		return rv;
         }
@@ -376,10 +437,31 @@ int main(int argc, char **argv) {
 	rv = saHpiDiscover(sessionid);
 	if (rv != SA_OK) {
 		printf("saHpiDiscover returns %s\n",oh_lookup_error(rv));
-                if (g_file)	fclose(outfile);
+                if (g_file && !g_binary)	fclose(outfile);
                 GFREE
 		return rv;
 	}
+
+	if (g_binary) {
+		SimSnapshotWriterT *writer = sim_snapshot_writer_new();
+
+		if (writer == NULL) {
+			CRIT("Couldn't allocate the snapshot writer.");
+			rv = SA_ERR_HPI_OUT_OF_MEMORY;
+		} else {
+			rv = snapshot_resources(writer, sessionid, (SaHpiResourceIdT) g_resourceid);
+			if (rv == SA_OK)
+				rv = sim_snapshot_writer_save(writer, g_file);
+			if (rv != SA_OK)
+				CRIT("Snapshot %s couldn't be written: %s", g_file, oh_lookup_error(rv));
+			sim_snapshot_writer_free(writer);
+		}
+
+		saHpiSessionClose(sessionid);
+		GFREE
+		return (rv == SA_OK) ? 0 : 1;
+	}
+
 	print_resources(outfile, 0, sessionid, (SaHpiResourceIdT) g_resourceid);
 
 	rv = saHpiSessionClose(sessionid);
@@ -1831,3 +1913,372 @@ static void print_entitypath(FILE *out, int offset, const SaHpiEntityPathT *ep)
 
 
 
+
+
+/**
+ * Binary snapshot functions
+ *
+ * The same HPI calls as for the text format are used, the data is
+ * written as records of new_sim_snapshot.h instead of being printed.
+ **/
+
+static SaErrorT snapshot_resources(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionid,
+                                   SaHpiResourceIdT resourceid) {
+   SaErrorT rv = SA_OK;
+   SaHpiRptEntryT rptentry;
+   SaHpiEntryIdT rptentryid = SAHPI_FIRST_ENTRY;
+   SaHpiEntryIdT nextrptentryid;
+   SaHpiEntryIdT entryid;
+   SaHpiEntryIdT nextentryid;
+   SaHpiRdrT rdr;
+
+   do {
+      rv = saHpiRptEntryGet(sessionid, rptentryid, &nextrptentryid, &rptentry);
+      if (rv != SA_OK) {
+         fprintf(stderr, "RptEntryGet returns %s\n", oh_lookup_error(rv));
+         return rv;
+      }
+
+      if ((resourceid == SAHPI_UNSPECIFIED_RESOURCE_ID) 
+         || (resourceid == rptentry.ResourceId)) {
+
+         rv = sim_snapshot_add_rpt(writer, &rptentry);
+         if (rv != SA_OK)
+            return rv;
+
+         if (rptentry.ResourceCapabilities & SAHPI_CAPABILITY_RDR) {
+            entryid = SAHPI_FIRST_ENTRY;
+            do {
+               rv = saHpiRdrGet(sessionid, rptentry.ResourceId, entryid, &nextentryid, &rdr);
+               if (rv != SA_OK) {
+                  fprintf(stderr, "saHpiRdrGet[%u, %u] rv = %s\n", rptentry.ResourceId, entryid,
+                                                                  oh_lookup_error(rv));
+                  break;
+               }
+
+               rv = snapshot_rdr(writer, sessionid, rptentry.ResourceId, &rdr);
+               entryid = nextentryid;
+
+            } while ((rv == SA_OK) && (entryid != SAHPI_LAST_ENTRY));
+         }
+      }
+
+      rptentryid = nextrptentryid;
+   } while ((rv == SA_OK) && (rptentryid != SAHPI_LAST_ENTRY));
+
+   return rv;
+}
+
+static SaErrorT snapshot_rdr(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionid, 
+                             SaHpiResourceIdT resId, SaHpiRdrT *rdrptr) {
+   SaErrorT rv;
+
+   rv = sim_snapshot_add_rdr(writer, rdrptr);
+   if (rv != SA_OK)
+      return rv;
+
+   // Like in the text format an error of the data part doesn't stop the processing
+   switch (rdrptr->RdrType) {
+      case SAHPI_CTRL_RDR:
+         return snapshot_control(writer, sessionid, resId, &rdrptr->RdrTypeUnion.CtrlRec);
+      case SAHPI_SENSOR_RDR:
+         return snapshot_sensor(writer, sessionid, resId, &rdrptr->RdrTypeUnion.SensorRec);
+      case SAHPI_INVENTORY_RDR:
+         return snapshot_inventory(writer, sessionid, resId, &rdrptr->RdrTypeUnion.InventoryRec);
+      case SAHPI_WATCHDOG_RDR:
+         return snapshot_watchdog(writer, sessionid, resId, &rdrptr->RdrTypeUnion.WatchdogRec);
+      case SAHPI_ANNUNCIATOR_RDR:
+         return snapshot_annunciator(writer, sessionid, resId, &rdrptr->RdrTypeUnion.AnnunciatorRec);
+      case SAHPI_DIMI_RDR:
+         return snapshot_dimi(writer, sessionid, resId, &rdrptr->RdrTypeUnion.DimiRec);
+      case SAHPI_FUMI_RDR:
+         return snapshot_fumi(writer, sessionid, resId, &rdrptr->RdrTypeUnion.FumiRec);
+      default:
+         fprintf(stderr, "Unknown rdr type %u for ResId %u\n", rdrptr->RdrType, resId);
+   }
+
+   return SA_OK;
+}
+
+static SaErrorT snapshot_sensor(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionId, 
+                                SaHpiResourceIdT resId, SaHpiSensorRecT *sens) {
+   SaErrorT rv;
+   SimSnapshotSensorT data;
+   SaHpiBoolT sensEnabled;
+
+   memset(&data, 0, sizeof(data));
+
+   rv = saHpiSensorEnableGet(sessionId, resId, sens->Num, &sensEnabled);
+   if (rv != SA_OK) {
+      fprintf(stderr, "saHpiSensorEnableGet returns %s for ResId %u sensNum %u\n",
+              oh_lookup_error(rv), resId, sens->Num);
+      return SA_OK;
+   }
+
+   if (!sensEnabled) {
+      // Check whether it is temporarily not enabled
+      if (!sens->EnableCtrl)
+         return SA_OK;
+
+      rv = saHpiSensorEnableSet(sessionId, resId, sens->Num, SAHPI_TRUE);
+      if (rv != SA_OK) {
+         fprintf(stderr, "saHpiSensorEnableSet returns %s for ResId %u sensNum %u\n",
+                 oh_lookup_error(rv), resId, sens->Num);
+         return SA_OK;
+      }
+   }
+
+   rv = saHpiSensorReadingGet(sessionId, resId, sens->Num, &data.Reading, &data.EventState);
+   if (rv != SA_OK) {
+      fprintf(stderr, "SensorReadingGet returns %s for ResId %u sensNum %u\n",
+              oh_lookup_error(rv), resId, sens->Num);
+      rv = SA_OK;
+      goto restore;
+   }
+
+   data.Enabled = sensEnabled;
+   if ((sens->DataFormat.IsSupported == SAHPI_TRUE) && 
+        (data.Reading.IsSupported == SAHPI_FALSE)) {
+      data.Reading.IsSupported = SAHPI_TRUE;
+      data.Reading.Type = sens->DataFormat.ReadingType;
+   }
+
+   // The parser of the text format uses TRUE if the value is missing
+   if (saHpiSensorEventEnableGet(sessionId, resId, sens->Num, &data.EventsEnabled) != SA_OK)
+      data.EventsEnabled = SAHPI_TRUE;
+
+   if (sens->ThresholdDefn.IsAccessible) {
+      SaHpiSensorThresholdsT *thres = &data.Thresholds;
+
+      if (saHpiSensorThresholdsGet(sessionId, resId, sens->Num, thres) == SA_OK) {
+         check_sensor_reading(&thres->LowCritical, sens->DataFormat);
+         check_sensor_reading(&thres->LowMajor, sens->DataFormat);
+         check_sensor_reading(&thres->LowMinor, sens->DataFormat);
+         check_sensor_reading(&thres->UpCritical, sens->DataFormat);
+         check_sensor_reading(&thres->UpMajor, sens->DataFormat);
+         check_sensor_reading(&thres->UpMinor, sens->DataFormat);
+         check_sensor_reading(&thres->PosThdHysteresis, sens->DataFormat);
+         check_sensor_reading(&thres->NegThdHysteresis, sens->DataFormat);
+      } else {
+         memset(thres, 0, sizeof(SaHpiSensorThresholdsT));
+      }
+   }
+
+   if (saHpiSensorEventMasksGet(sessionId, resId, sens->Num,
+                                &data.AssertMask, &data.DeassertMask) != SA_OK) {
+      data.AssertMask = 0;
+      data.DeassertMask = 0;
+   }
+
+   rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_SENSOR, &data, sizeof(data));
+
+restore:
+   if (!sensEnabled) {
+      // The enabled status was changed, set it back
+      if (saHpiSensorEnableSet(sessionId, resId, sens->Num, sensEnabled) != SA_OK)
+         fprintf(stderr, "saHpiSensorEnableSet failed for ResId %u sensNum %u\n",
+                 resId, sens->Num);
+   }
+
+   return rv;
+}
+
+static SaErrorT snapshot_control(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionId, 
+                                 SaHpiResourceIdT resId, SaHpiCtrlRecT *ctrl) {
+   SaErrorT rv;
+   SimSnapshotControlT data;
+
+   // Without a record the simulator uses the default mode and state
+   if (ctrl->WriteOnly != SAHPI_FALSE)
+      return SA_OK;
+
+   memset(&data, 0, sizeof(data));
+   // Text controls have to deliver all lines
+   if (ctrl->Type == SAHPI_CTRL_TYPE_TEXT)
+      data.State.StateUnion.Text.Line = SAHPI_TLN_ALL_LINES;
+
+   rv = saHpiControlGet(sessionId, resId, ctrl->Num, &data.Mode, &data.State);
+   if (rv != SA_OK) {
+      fprintf(stderr, "ControlGet returns %s for ResId %u ControlNum %u\n",
+              oh_lookup_error(rv), resId, ctrl->Num);
+      return SA_OK;
+   }
+
+   return sim_snapshot_add_record(writer, SIM_SNAPSHOT_CONTROL, &data, sizeof(data));
+}
+
+static SaErrorT snapshot_inventory(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionId, 
+                                   SaHpiResourceIdT resId, SaHpiInventoryRecT *inv) {
+   SaErrorT rv;
+   SaHpiIdrInfoT idrInfo;
+   SaHpiEntryIdT areaId = SAHPI_FIRST_ENTRY;
+   SaHpiEntryIdT nextId;
+   SaHpiIdrAreaHeaderT header;
+   int numAreas = 0;
+
+   rv = saHpiIdrInfoGet(sessionId, resId, inv->IdrId, &idrInfo);
+   if (rv != SA_OK) {
+      fprintf(stderr, "IdrInfoGet returns %s for ResId %u IdrId %u\n",
+              oh_lookup_error(rv), resId, inv->IdrId);
+      return SA_OK;
+   }
+
+   rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_IDR_INFO, &idrInfo, sizeof(idrInfo));
+
+   while ((areaId != SAHPI_LAST_ENTRY) &&
+           (rv == SA_OK) &&
+           (numAreas <= idrInfo.NumAreas)) {
+      SaHpiEntryIdT fieldId = SAHPI_FIRST_ENTRY;
+      SaHpiEntryIdT nextFieldId;
+      SaHpiIdrFieldT field;
+      int numFields = 0;
+
+      if (saHpiIdrAreaHeaderGet(sessionId, resId, inv->IdrId, SAHPI_IDR_AREATYPE_UNSPECIFIED,
+                                areaId, &nextId, &header) != SA_OK) {
+         fprintf(stderr, "IdrAreaHeaderGet fails for ResId %u IdrId %u areaId %u\n",
+                 resId, inv->IdrId, areaId);
+         break;
+      }
+      numAreas++;
+      areaId = nextId;
+
+      rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_IDR_AREA, &header, sizeof(header));
+
+      while ((fieldId != SAHPI_LAST_ENTRY) &&
+              (rv == SA_OK) &&
+              (numFields <= header.NumFields)) {
+
+         if (saHpiIdrFieldGet(sessionId, resId, inv->IdrId, header.AreaId, 
+                              SAHPI_IDR_FIELDTYPE_UNSPECIFIED, fieldId, 
+                              &nextFieldId, &field) != SA_OK) {
+            fprintf(stderr, "IdrFieldGet fails for ResId %u IdrId %u areaId %u fieldId %u\n",
+                    resId, inv->IdrId, header.AreaId, fieldId);
+            break;
+         }
+         fieldId = nextFieldId;
+         numFields++;
+
+         rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_IDR_FIELD, &field, sizeof(field));
+      }
+   }
+
+   return rv;
+}
+
+static SaErrorT snapshot_watchdog(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionId, 
+                                  SaHpiResourceIdT resId, SaHpiWatchdogRecT *wdt) {
+   SaErrorT rv;
+   SaHpiWatchdogT wdtTimer;
+
+   rv = saHpiWatchdogTimerGet(sessionId, resId, wdt->WatchdogNum, &wdtTimer);
+   if (rv != SA_OK) {
+      fprintf(stderr, "WatchdogTimerGet returns %s for ResId %u Num %u\n",
+              oh_lookup_error(rv), resId, wdt->WatchdogNum);
+      return SA_OK;
+   }
+
+   return sim_snapshot_add_record(writer, SIM_SNAPSHOT_WATCHDOG, &wdtTimer, sizeof(wdtTimer));
+}
+
+static SaErrorT snapshot_annunciator(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionId, 
+                                     SaHpiResourceIdT resId, SaHpiAnnunciatorRecT *ann) {
+   SaErrorT rv;
+   SimSnapshotAnnunciatorT data;
+   SaHpiAnnouncementT announcement;
+
+   if (saHpiAnnunciatorModeGet(sessionId, resId, ann->AnnunciatorNum, &data.Mode) != SA_OK) {
+      fprintf(stderr, "AnnunciatorModeGet fails for ResId %u Num %u - will be Ignored\n",
+              resId, ann->AnnunciatorNum);
+      data.Mode = SAHPI_ANNUNCIATOR_MODE_AUTO;
+   }
+
+   rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_ANN_MODE, &data, sizeof(data));
+
+   announcement.EntryId = SAHPI_FIRST_ENTRY;
+   while ((rv == SA_OK) &&
+          (saHpiAnnunciatorGetNext(sessionId, resId, ann->AnnunciatorNum, SAHPI_ALL_SEVERITIES,
+                                   SAHPI_FALSE, &announcement) == SA_OK)) {
+      rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_ANNOUNCEMENT, 
+                                   &announcement, sizeof(announcement));
+   }
+
+   return rv;
+}
+
+static SaErrorT snapshot_dimi(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionId, 
+                              SaHpiResourceIdT resId, SaHpiDimiRecT *dimi) {
+   SaErrorT rv;
+   SaHpiDimiInfoT testinfo;
+   int i;
+
+   if (saHpiDimiInfoGet(sessionId, resId, dimi->DimiNum, &testinfo) != SA_OK) {
+      fprintf(stderr, "saHpiDimiInfoGet fails for ResId %u Num %u - will be Ignored, all is set to 0\n",
+              resId, dimi->DimiNum);
+      testinfo.NumberOfTests = 0;
+      testinfo.TestNumUpdateCounter = 0;
+   }
+
+   rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_DIMI_INFO, &testinfo, sizeof(testinfo));
+
+   for (i = 0; (i < testinfo.NumberOfTests) && (rv == SA_OK); i++) {
+      SimSnapshotDimiTestT test;
+
+      memset(&test, 0, sizeof(test));
+      if (saHpiDimiTestInfoGet(sessionId, resId, dimi->DimiNum, i, &test.Info) != SA_OK) {
+         fprintf(stderr, "saHpiDimiTestInfoGet fails for ResId %u DimiNum %u Test %u - "
+                         "will be Ignored\n", resId, dimi->DimiNum, i);
+         continue;
+      }
+
+      if (saHpiDimiTestReadinessGet(sessionId, resId, dimi->DimiNum, i, &test.Ready) != SA_OK)
+         test.Ready = SAHPI_DIMI_WRONG_STATE;
+
+      if (saHpiDimiTestResultsGet(sessionId, resId, dimi->DimiNum, i, &test.Results) == SA_OK)
+         test.HasResults = SAHPI_TRUE;
+
+      rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_DIMI_TEST, &test, sizeof(test));
+   }
+
+   return rv;
+}
+
+static SaErrorT snapshot_fumi(SimSnapshotWriterT *writer, SaHpiSessionIdT sessionId, 
+                              SaHpiResourceIdT resId, SaHpiFumiRecT *fumi) {
+   SaErrorT rv;
+   SimSnapshotFumiT data;
+   int i;
+
+   memset(&data, 0, sizeof(data));
+
+   // Like in the text format the data is only written with spec and impact
+   if ((saHpiFumiSpecInfoGet(sessionId, resId, fumi->Num, &data.Spec) != SA_OK) ||
+       (saHpiFumiServiceImpactGet(sessionId, resId, fumi->Num, &data.Impact) != SA_OK)) {
+      fprintf(stderr, "Fumi information is missing for ResId %u Num %u -"
+                      " no fumi data will be written\n", resId, fumi->Num);
+      return SA_OK;
+   }
+
+   if (fumi->Capability & SAHPI_FUMI_CAP_AUTOROLLBACK) {
+      if (saHpiFumiAutoRollbackDisableGet(sessionId, resId, fumi->Num, 
+                                          &data.RollbackDisabled) != SA_OK)
+         data.RollbackDisabled = SAHPI_FALSE;
+   }
+
+   rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_FUMI_INFO, &data, sizeof(data));
+
+   // Components aren't kept by the simulator, so they aren't written
+   for (i = 0; (i <= fumi->NumBanks) && (rv == SA_OK); i++) {
+      SimSnapshotFumiBankT bank;
+
+      memset(&bank, 0, sizeof(bank));
+      if (saHpiFumiTargetInfoGet(sessionId, resId, fumi->Num, i, &bank.Target) != SA_OK)
+         bank.Target.BankId = i;
+      saHpiFumiSourceInfoGet(sessionId, resId, fumi->Num, i, &bank.Source);
+      if (i == 0)
+         saHpiFumiLogicalTargetInfoGet(sessionId, resId, fumi->Num, &bank.Logical);
+
+      rv = sim_snapshot_add_record(writer, SIM_SNAPSHOT_FUMI_BANK, &bank, sizeof(bank));
+   }
+
+   return rv;
+}
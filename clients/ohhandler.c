@@ -41,6 +41,8 @@
     "         Find the right handler for a resource id              \n\n" \
     "Command retry <handler-id>                                     \n" \
     "         Retry loading of handler <handler-id>                 \n\n" \
+    "Command stats <handler-id>                                     \n" \
+    "         Display plugin call statistics of handler <handler-id>\n\n" \
     "Command create plugin <name> <params>                          \n" \
     "         Create handler with the specified parameters.         \n" \
     "         Pairs of strings in commandline like in openhpi.conf. \n" \
@@ -60,6 +62,7 @@ static SaErrorT exechandlerinfo(oHpiHandlerIdT);
 static SaErrorT exechandlergetnext(oHpiHandlerIdT);
 static SaErrorT exechandlerfind(SaHpiResourceIdT);
 static SaErrorT exechandlerretry(oHpiHandlerIdT);
+static SaErrorT exechandlerstats(oHpiHandlerIdT);
 static SaErrorT exechandlerlist(void);
 
 
@@ -90,6 +93,7 @@ main(int argc, char **argv)
       eHandlerGetNext, 
       eHandlerFind,
       eHandlerRetry,
+      eHandlerStats,
       eHandlerList} cmd=eUndefined;
        
    /* Print version strings */
@@ -154,6 +158,12 @@ main(int argc, char **argv)
          else printusage = TRUE;
       }
 
+      else if (strcmp(argv[i],"stats")==0) {
+         cmd=eHandlerStats;
+         if (++i<argc) handlerid = atoi(argv[i]);
+         else printusage = TRUE;
+      }
+
       else if (strcmp(argv[i],"list")==0) {
          cmd=eHandlerList;
          if (++i<argc) printusage = TRUE;
@@ -212,6 +222,9 @@ main(int argc, char **argv)
                 case eHandlerRetry:
                                    rv = exechandlerretry ( handlerid );
                                    break;
+                case eHandlerStats:
+                                   rv = exechandlerstats ( handlerid );
+                                   break;
                 case eHandlerList:
                                    rv = exechandlerlist ( );
                                    break;
@@ -462,6 +475,100 @@ static SaErrorT exechandlerretry(oHpiHandlerIdT handlerid)
    return rv;
 }
 
+/********************************************/ 
+/* exechandlerstats                         */
+/********************************************/
+// upper latency bound (usec) of the histogram bucket holding the
+// given fraction of calls
+static SaHpiUint64T stats_percentile(const oHpiHandlerStatsT *stats,
+                                     double fraction)
+{
+   SaHpiUint64T sum = 0;
+   SaHpiUint64T limit = (SaHpiUint64T)(stats->Calls * fraction);
+   int i;
+
+   if (limit == 0) limit = 1;
+   for (i = 0; i < OHPI_HANDLER_STATS_BUCKETS - 1; i++) {
+      sum += stats->Histogram[i];
+      if (sum >= limit) return ((SaHpiUint64T)1) << i;
+   }
+   return stats->MaxUsec;
+}
+
+static SaErrorT exechandlerstats(oHpiHandlerIdT handlerid)
+{
+   SaErrorT rv = SA_OK;
+   SaHpiEntryIdT entryid = SAHPI_FIRST_ENTRY;
+   SaHpiEntryIdT nextentryid;
+   oHpiHandlerStatsT stats;
+   oHpiSensorCacheStatsT cstats;
+   oHpiEventLimitStatsT lstats;
+
+   if (copt.debug) DBG("Go and display call statistics of handler %u", 
+                      handlerid);
+
+   printf("\nPlugin call statistics for handler %u:\n\n", handlerid);
+   printf("%-34s %10s %8s %10s %10s %10s %10s\n",
+          "Function", "Calls", "Errors", "Avg(us)", "p50(us)",
+          "p99(us)", "Max(us)");
+   while (entryid != SAHPI_LAST_ENTRY) {
+      rv = oHpiHandlerStatsGet ( sessionid, handlerid, entryid,
+                                 &nextentryid, &stats );
+      if (copt.debug) DBG("oHpiHandlerStatsGet (%u) returned %s",
+                      entryid, oh_lookup_error(rv));
+      if (rv==SA_ERR_HPI_NOT_PRESENT && entryid==SAHPI_FIRST_ENTRY) {
+         printf("No plugin calls recorded.\n");
+         rv = SA_OK;
+         break;
+      }
+      else if (rv!=SA_OK) {
+         CRIT("oHpiHandlerStatsGet returned %s", oh_lookup_error(rv));
+         return rv;
+      }
+      printf("%-34.*s %10llu %8llu %10llu <%9llu <%9llu %10llu\n",
+             stats.Function.DataLength,
+             (const char *)stats.Function.Data,
+             (unsigned long long)stats.Calls,
+             (unsigned long long)stats.Errors,
+             (unsigned long long)(stats.Calls ?
+                                  stats.TotalUsec / stats.Calls : 0),
+             (unsigned long long)stats_percentile(&stats, 0.50),
+             (unsigned long long)stats_percentile(&stats, 0.99),
+             (unsigned long long)stats.MaxUsec);
+      entryid = nextentryid;
+   }
+
+   rv = oHpiSensorCacheStatsGet ( sessionid, handlerid, &cstats );
+   if (rv==SA_OK && cstats.TtlMsec != 0) {
+      printf("\nSensor reading cache (TTL %u msec, %u sensors):\n",
+             cstats.TtlMsec, cstats.Entries);
+      printf("   hits %llu, misses %llu, coalesced %llu, "
+             "invalidations %llu\n",
+             (unsigned long long)cstats.Hits,
+             (unsigned long long)cstats.Misses,
+             (unsigned long long)cstats.Coalesced,
+             (unsigned long long)cstats.Invalidations);
+   }
+
+   rv = oHpiEventLimitStatsGet ( sessionid, handlerid, &lstats );
+   if (rv==SA_OK && (lstats.CoalesceWindowMsec != 0 ||
+                     lstats.CoalesceSources != 0 || lstats.Rate != 0)) {
+      printf("\nEvent limits (window %u msec, %u per-source windows, "
+             "rate %u/sec, burst %u):\n",
+             lstats.CoalesceWindowMsec, lstats.CoalesceSources,
+             lstats.Rate, lstats.Burst);
+      printf("   held %u, coalesced %llu, rate limited %llu, "
+             "deferred harvests %llu\n",
+             lstats.Held,
+             (unsigned long long)lstats.Coalesced,
+             (unsigned long long)lstats.RateLimited,
+             (unsigned long long)lstats.HarvestDeferred);
+   }
+   printf("\n");
+
+   return SA_OK;
+}
+
 /********************************************/ 
 /* exechandlerlist                          */
 /********************************************/
@@ -104,6 +104,86 @@ typedef struct {
 } oHpiGlobalParamT;
 
 
+typedef struct {
+    SaHpiUint32T TtlMsec; /* Reading TTL, 0 if the cache is disabled */
+    SaHpiUint32T Entries; /* Number of sensors tracked by the cache */
+    SaHpiUint64T Hits; /* Readings served from the cache */
+    SaHpiUint64T Misses; /* Readings that went to the plugin */
+    SaHpiUint64T Coalesced; /* Readings that shared another caller's read */
+    SaHpiUint64T Invalidations; /* Cached readings dropped by events/setters */
+} oHpiSensorCacheStatsT;
+
+
+/* Histogram[0] counts calls under 1 usec, Histogram[i] calls that took
+ * [2^(i-1), 2^i) usec and the last bucket all longer calls. */
+#define OHPI_HANDLER_STATS_BUCKETS 24
+
+typedef struct {
+    SaHpiTextBufferT Function; /* Plugin ABI entry, e.g. "get_sensor_reading" */
+    SaHpiUint64T Calls;
+    SaHpiUint64T Errors; /* Calls that did not return SA_OK */
+    SaHpiUint64T TotalUsec;
+    SaHpiUint64T MaxUsec;
+    SaHpiUint32T Histogram[OHPI_HANDLER_STATS_BUCKETS];
+} oHpiHandlerStatsT;
+
+
+typedef struct {
+    SaHpiUint32T FlushIntervalMsec; /* OPENHPI_DEL_FLUSH_INTERVAL */
+    SaHpiUint32T FlushBatch; /* OPENHPI_DEL_FLUSH_BATCH */
+    SaHpiUint32T Pending; /* Logged entries not yet written to disk */
+    SaHpiUint64T Written; /* Logged entries written to disk */
+    SaHpiUint64T Flushes; /* Event log files written */
+    SaHpiUint64T Errors; /* Event log files that failed to be written */
+} oHpiDelWriterStatsT;
+
+
+typedef struct {
+    SaHpiUint32T CoalesceWindowMsec; /* event_coalesce_window, 0 if unset */
+    SaHpiUint32T CoalesceSources; /* Sources with their own window */
+    SaHpiUint32T Rate; /* event_rate in events/sec, 0 if not limited */
+    SaHpiUint32T Burst; /* Token bucket depth */
+    SaHpiUint32T Held; /* Sensor events waiting for their window to end */
+    SaHpiUint64T Coalesced; /* Sensor events merged away by coalescing */
+    SaHpiUint64T RateLimited; /* Sensor events dropped with no tokens left */
+    SaHpiUint64T HarvestDeferred; /* Harvests stopped with no tokens left */
+} oHpiEventLimitStatsT;
+
+
+/* Priority classes of the daemon event queue, highest first */
+typedef enum {
+    OHPI_EVENT_PRIORITY_HIGH = 0, /* Resource, hotswap and domain events */
+    OHPI_EVENT_PRIORITY_NORMAL, /* Other events */
+    OHPI_EVENT_PRIORITY_LOW /* Sensor and OEM events */
+} oHpiEventPriorityT;
+
+#define OHPI_EVENT_PRIORITY_LEVELS 3
+
+/* Histogram has the layout of oHpiHandlerStatsT, in usec spent queued */
+typedef struct {
+    SaHpiUint32T Queued; /* Events of the class waiting for a worker */
+    SaHpiUint32T MaxQueued;
+    SaHpiUint64T Processed;
+    SaHpiUint64T Promoted; /* Moved up behind an event of their resource */
+    SaHpiUint64T TotalUsec;
+    SaHpiUint64T MaxUsec;
+    SaHpiUint32T Histogram[OHPI_HANDLER_STATS_BUCKETS];
+} oHpiEventQueueStatsT;
+
+
+/* Event log entries returned by oHpiEventLogEntriesGet. Rdrs and RptEntries
+ * hold one record per entry when requested, none otherwise. The arrays are
+ * allocated by the call and released by the caller with g_free(). */
+typedef struct {
+    SaHpiUint32T NumberOfEntries;
+    SaHpiEventLogEntryT *Entries;
+    SaHpiUint32T NumberOfRdrs;
+    SaHpiRdrT *Rdrs;
+    SaHpiUint32T NumberOfRptEntries;
+    SaHpiRptEntryT *RptEntries;
+} oHpiEventLogEntriesT;
+
+
 /***************************************************************************
 **
 ** Name: oHpiVersionGet()
@@ -458,6 +538,254 @@ SaErrorT SAHPI_API oHpiInjectEvent (
      SAHPI_IN    SaHpiRptEntryT *rpte,
      SAHPI_IN    SaHpiRdrT *rdr);
 
+/***************************************************************************
+**
+** Name: oHpiSensorCacheStatsGet()
+**
+** Description:
+**   This function returns the sensor reading cache counters for the
+**   specified handler.
+**
+** Parameters:
+**   sid - [in] Identifier for a session context previously obtained using
+**      saHpiSessionOpen().
+**   id - [in] Unique (for the targeted OpenHPI daemon) id associated
+**      with the handler.
+**   stats - [out] Pointer to struct for returning the cache counters.
+**
+** Return Value:
+**   SA_OK is returned on successful completion; otherwise, an error code is
+**      returned.
+**   SA_ERR_HPI_INVALID_SESSION is returned if sid is null.
+**   SA_ERR_HPI_INVALID_PARAMS is returned if
+**      id is null.
+**      stats pointer is passed in as NULL
+**   SA_ERR_HPI_NOT_PRESENT is returned if the id does not correspond to an
+**      existing handler.
+**
+** Remarks:
+**   This is Daemon level function.
+**   The cache is enabled per handler with the "sensor_cache_ttl"
+**   configuration parameter (milliseconds). For handlers without it
+**   all counters and TtlMsec are returned as zero.
+**
+***************************************************************************/
+SaErrorT SAHPI_API oHpiSensorCacheStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    oHpiHandlerIdT id,
+     SAHPI_OUT   oHpiSensorCacheStatsT *stats );
+
+/***************************************************************************
+**
+** Name: oHpiHandlerStatsGet()
+**
+** Description:
+**   This function returns call statistics for one plugin ABI function
+**   of the specified handler. The daemon counts calls, errors and call
+**   latency for every plugin function it invokes.
+**
+** Parameters:
+**   sid - [in] Identifier for a session context previously obtained using
+**      saHpiSessionOpen().
+**   id - [in] Unique (for the targeted OpenHPI daemon) id associated
+**      with the handler.
+**   EntryId - [in] Identifier of the statistics entry to retrieve.
+**      Reserved entry ID values:
+**      SAHPI_FIRST_ENTRY  Get first entry
+**      SAHPI_LAST_ENTRY   Reserved as delimiter for end of list. Not a valid
+**                         entry identifier.
+**   NextEntryId - [out] Pointer to location to store the EntryId of the
+**      next ABI function that has been called at least once, or
+**      SAHPI_LAST_ENTRY.
+**   stats - [out] Pointer to struct for returning the statistics.
+**
+** Return Value:
+**   SA_OK is returned on successful completion; otherwise, an error code is
+**      returned.
+**   SA_ERR_HPI_INVALID_SESSION is returned if sid is null.
+**   SA_ERR_HPI_INVALID_PARAMS is returned if
+**      id is null.
+**      NextEntryId or stats pointer is passed in as NULL.
+**      EntryId is SAHPI_LAST_ENTRY.
+**   SA_ERR_HPI_NOT_PRESENT is returned if the id does not correspond to an
+**      existing handler, EntryId does not correspond to an ABI function,
+**      or EntryId is SAHPI_FIRST_ENTRY and no function has been called yet.
+**
+** Remarks:
+**   This is Daemon level function.
+**   Only functions that have been called at least once are returned when
+**   walking the list starting from SAHPI_FIRST_ENTRY.
+**
+***************************************************************************/
+SaErrorT SAHPI_API oHpiHandlerStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    oHpiHandlerIdT id,
+     SAHPI_IN    SaHpiEntryIdT EntryId,
+     SAHPI_OUT   SaHpiEntryIdT *NextEntryId,
+     SAHPI_OUT   oHpiHandlerStatsT *stats );
+
+/***************************************************************************
+**
+** Name: oHpiDelWriterStatsGet()
+**
+** Description:
+**   This function returns the counters of the daemon thread that saves
+**   domain event logs to disk when OPENHPI_DEL_SAVE is set.
+**
+** Parameters:
+**   sid - [in] Identifier for a session context previously obtained using
+**      saHpiSessionOpen().
+**   stats - [out] Pointer to struct for returning the writer counters.
+**
+** Return Value:
+**   SA_OK is returned on successful completion; otherwise, an error code is
+**      returned.
+**   SA_ERR_HPI_INVALID_SESSION is returned if sid is null.
+**   SA_ERR_HPI_INVALID_PARAMS is returned if
+**      stats pointer is passed in as NULL
+**
+** Remarks:
+**   This is Daemon level function.
+**   Logged entries are written at most OPENHPI_DEL_FLUSH_INTERVAL msec
+**   after they were logged, or as soon as OPENHPI_DEL_FLUSH_BATCH of
+**   them are pending. Pending entries are written when the daemon stops.
+**
+***************************************************************************/
+SaErrorT SAHPI_API oHpiDelWriterStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_OUT   oHpiDelWriterStatsT *stats );
+
+/***************************************************************************
+**
+** Name: oHpiEventLimitStatsGet()
+**
+** Description:
+**   This function returns the event coalescing and rate limiting
+**   settings and counters for the specified handler.
+**
+** Parameters:
+**   sid - [in] Identifier for a session context previously obtained using
+**      saHpiSessionOpen().
+**   id - [in] Unique (for the targeted OpenHPI daemon) id associated
+**      with the handler.
+**   stats - [out] Pointer to struct for returning the counters.
+**
+** Return Value:
+**   SA_OK is returned on successful completion; otherwise, an error code is
+**      returned.
+**   SA_ERR_HPI_INVALID_SESSION is returned if sid is null.
+**   SA_ERR_HPI_INVALID_PARAMS is returned if
+**      id is null.
+**      stats pointer is passed in as NULL
+**   SA_ERR_HPI_NOT_PRESENT is returned if the id does not correspond to an
+**      existing handler.
+**
+** Remarks:
+**   This is Daemon level function.
+**   Limits are set per handler with the "event_coalesce_window",
+**   "event_coalesce_sources", "event_rate" and "event_burst"
+**   configuration parameters. For handlers without them all fields are
+**   returned as zero.
+**
+***************************************************************************/
+SaErrorT SAHPI_API oHpiEventLimitStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    oHpiHandlerIdT id,
+     SAHPI_OUT   oHpiEventLimitStatsT *stats );
+
+/***************************************************************************
+**
+** Name: oHpiEventQueueStatsGet()
+**
+** Description:
+**   This function returns the counters and the queueing latency histogram
+**   of one priority class of the daemon event queue.
+**
+** Parameters:
+**   sid - [in] Identifier for a session context previously obtained using
+**      saHpiSessionOpen().
+**   priority - [in] Priority class, OHPI_EVENT_PRIORITY_HIGH to
+**      OHPI_EVENT_PRIORITY_LOW.
+**   stats - [out] Pointer to struct for returning the counters.
+**
+** Return Value:
+**   SA_OK is returned on successful completion; otherwise, an error code is
+**      returned.
+**   SA_ERR_HPI_INVALID_SESSION is returned if sid is null.
+**   SA_ERR_HPI_INVALID_PARAMS is returned if
+**      priority is not a valid class.
+**      stats pointer is passed in as NULL
+**
+** Remarks:
+**   This is Daemon level function.
+**   Event processing workers take resource, hotswap and domain events
+**   first and sensor and OEM events last. An event moves the queued
+**   events of its resource up to its class, so the events of a resource
+**   are still processed in order; these are counted as Promoted in their
+**   own class.
+**
+***************************************************************************/
+SaErrorT SAHPI_API oHpiEventQueueStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    oHpiEventPriorityT priority,
+     SAHPI_OUT   oHpiEventQueueStatsT *stats );
+
+/***************************************************************************
+**
+** Name: oHpiEventLogEntriesGet()
+**
+** Description:
+**   This function retrieves a range of consecutive entries from an event
+**   log in one call, starting at a given entry and walking towards the
+**   newest one, as repeated saHpiEventLogEntryGet() calls would.
+**
+** Parameters:
+**   sid - [in] Identifier for a session context previously obtained using
+**      saHpiSessionOpen().
+**   rid - [in] Identifier of the resource whose event log is read, or
+**      SAHPI_UNSPECIFIED_RESOURCE_ID for the domain event log.
+**   entry_id - [in] Identifier of the first entry to retrieve. Use
+**      SAHPI_OLDEST_ENTRY to start at the beginning of the log and the
+**      next_entry_id of the previous call to continue.
+**   max_entries - [in] Maximum number of entries to retrieve.
+**   with_rdr - [in] Also return the RDR associated with each entry.
+**   with_rpt_entry - [in] Also return the RPT entry associated with each
+**      entry.
+**   next_entry_id - [out] Identifier of the entry following the last one
+**      returned, SAHPI_NO_MORE_ENTRIES at the end of the log.
+**   entries - [out] Pointer to struct for returning the entries.
+**
+** Return Value:
+**   SA_OK is returned on successful completion; otherwise, an error code is
+**      returned.
+**   SA_ERR_HPI_INVALID_SESSION is returned if sid is null.
+**   SA_ERR_HPI_INVALID_PARAMS is returned if
+**      entry_id is SAHPI_NO_MORE_ENTRIES.
+**      max_entries is 0.
+**      next_entry_id or entries pointer is passed in as NULL
+**   Other errors are those of saHpiEventLogEntryGet() for the first entry.
+**
+** Remarks:
+**   This is Daemon level function.
+**   The daemon may return fewer than max_entries entries so that the reply
+**   fits in one message.
+**   If reading an entry fails after some entries were read, those are
+**   returned and next_entry_id names the failing entry, so the next call
+**   reports the error.
+**   On success the caller frees entries->Entries, entries->Rdrs and
+**   entries->RptEntries with g_free().
+**
+***************************************************************************/
+SaErrorT SAHPI_API oHpiEventLogEntriesGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    SaHpiResourceIdT rid,
+     SAHPI_IN    SaHpiEventLogEntryIdT entry_id,
+     SAHPI_IN    SaHpiUint32T max_entries,
+     SAHPI_IN    SaHpiBoolT with_rdr,
+     SAHPI_IN    SaHpiBoolT with_rpt_entry,
+     SAHPI_OUT   SaHpiEventLogEntryIdT *next_entry_id,
+     SAHPI_OUT   oHpiEventLogEntriesT *entries );
+
 /***************************************************************************
 **
 ** Name: oHpiDomainAdd()
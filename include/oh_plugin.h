@@ -16,6 +16,8 @@
 #ifndef __OH_PLUGIN_H
 #define __OH_PLUGIN_H
 
+#include <stddef.h>
+
 #include <glib.h>
 #include <gmodule.h>
 
@@ -74,6 +76,19 @@ struct oh_handlers {
         GStaticRecMutex lock;
 #endif
 };
+/* Call statistics of one plugin ABI function of a handler */
+struct oh_abi_call_stats {
+        SaHpiUint64T calls;
+        SaHpiUint64T errors;
+        SaHpiUint64T total_usec;
+        SaHpiUint64T max_usec;
+        SaHpiUint32T hist[OHPI_HANDLER_STATS_BUCKETS];
+};
+
+#define OH_ABI_FUNC_COUNT (sizeof(struct oh_abi_v2) / sizeof(void *))
+#define OH_ABI_FUNC_INDEX(func) \
+        (offsetof(struct oh_abi_v2, func) / sizeof(void *))
+
 struct oh_handler {
         unsigned int id; /* id of handler */
         char *plugin_name;
@@ -100,6 +115,14 @@ struct oh_handler {
         GStaticRecMutex refcount_lock;
 #endif
         int refcount;
+
+        /* Plugin call statistics, indexed by OH_ABI_FUNC_INDEX() */
+#if GLIB_CHECK_VERSION (2, 32, 0)
+        GMutex stats_lock;
+#else
+        GStaticMutex stats_lock;
+#endif
+        struct oh_abi_call_stats *stats;
 };
 extern struct oh_handlers oh_handlers;
 
@@ -122,6 +145,17 @@ int oh_getnext_handler_id(unsigned int hid, unsigned int *next_hid);
 SaErrorT oh_create_handler(GHashTable *handler_config, unsigned int *hid);
 int oh_destroy_handler(unsigned int hid);
 SaErrorT oh_get_handler_info(unsigned int hid, oHpiHandlerInfoT *info, GHashTable *conf_params);
+SaErrorT oh_get_handler_stats(unsigned int hid,
+                              SaHpiEntryIdT entry_id,
+                              SaHpiEntryIdT *next_entry_id,
+                              oHpiHandlerStatsT *stats);
+
+/* Plugin call statistics, see OH_CALL_ABI */
+gint64 oh_abi_stats_start(void);
+void oh_abi_stats_record(struct oh_handler *h,
+                         unsigned int func_index,
+                         SaErrorT rv,
+                         gint64 start);
 SaErrorT oh_discovery(void);
 
 /* Bind abi functions into plugin */
@@ -116,15 +116,19 @@
  * OH_CALL_ABI will check for a valid handler struct and existing plugin abi.
  * If a valid abi or handler is not found, it returns error. Once it passes
  * this validity check, it will call the plugin abi function with the passed
- * parameters. 
+ * parameters. The call is timed and accounted in the handler statistics.
  */
 #define OH_CALL_ABI(handler, func, err, ret, params...) \
 	{ \
+		gint64 __abi_start; \
 		if (!handler || !handler->abi->func) { \
                 	oh_release_handler(handler); \
                 	return err; \
         	} \
+        	__abi_start = oh_abi_stats_start(); \
         	ret = handler->abi->func(handler->hnd, params); \
+        	oh_abi_stats_record(handler, OH_ABI_FUNC_INDEX(func), \
+        	                    ret, __abi_start); \
         }
 
 #endif
@@ -2016,6 +2016,102 @@ static const cMarshalType *oHpiInjectEventOut[] =
 };
 
 
+static const cMarshalType *oHpiSensorCacheStatsGetIn[] =
+{
+  &SaHpiSessionIdType, // session id (SaHpiSessionIdT)
+  &oHpiHandlerIdType, // handler id
+  0
+};
+
+static const cMarshalType *oHpiSensorCacheStatsGetOut[] =
+{
+  &SaErrorType, // result (SaErrorT)
+  &oHpiSensorCacheStatsType, // sensor cache counters
+  0
+};
+
+
+static const cMarshalType *oHpiHandlerStatsGetIn[] =
+{
+  &SaHpiSessionIdType, // session id (SaHpiSessionIdT)
+  &oHpiHandlerIdType, // handler id
+  &SaHpiEntryIdType, // entry id
+  0
+};
+
+static const cMarshalType *oHpiHandlerStatsGetOut[] =
+{
+  &SaErrorType, // result (SaErrorT)
+  &SaHpiEntryIdType, // next entry id
+  &oHpiHandlerStatsType, // ABI call statistics
+  0
+};
+
+
+static const cMarshalType *oHpiDelWriterStatsGetIn[] =
+{
+  &SaHpiSessionIdType, // session id (SaHpiSessionIdT)
+  0
+};
+
+static const cMarshalType *oHpiDelWriterStatsGetOut[] =
+{
+  &SaErrorType, // result (SaErrorT)
+  &oHpiDelWriterStatsType, // DEL writer counters
+  0
+};
+
+
+static const cMarshalType *oHpiEventLimitStatsGetIn[] =
+{
+  &SaHpiSessionIdType, // session id (SaHpiSessionIdT)
+  &oHpiHandlerIdType, // handler id
+  0
+};
+
+static const cMarshalType *oHpiEventLimitStatsGetOut[] =
+{
+  &SaErrorType, // result (SaErrorT)
+  &oHpiEventLimitStatsType, // event limit counters
+  0
+};
+
+
+static const cMarshalType *oHpiEventQueueStatsGetIn[] =
+{
+  &SaHpiSessionIdType, // session id (SaHpiSessionIdT)
+  &oHpiEventPriorityType, // priority class
+  0
+};
+
+static const cMarshalType *oHpiEventQueueStatsGetOut[] =
+{
+  &SaErrorType, // result (SaErrorT)
+  &oHpiEventQueueStatsType, // event queue counters
+  0
+};
+
+
+static const cMarshalType *oHpiEventLogEntriesGetIn[] =
+{
+  &SaHpiSessionIdType, // session id (SaHpiSessionIdT)
+  &SaHpiResourceIdType,
+  &SaHpiEventLogEntryIdType, // first entry
+  &SaHpiUint32Type, // max entries
+  &SaHpiBoolType, // with RDRs
+  &SaHpiBoolType, // with RPT entries
+  0
+};
+
+static const cMarshalType *oHpiEventLogEntriesGetOut[] =
+{
+  &SaErrorType, // result (SaErrorT)
+  &SaHpiEventLogEntryIdType, // next entry
+  &oHpiEventLogEntriesType, // entries
+  0
+};
+
+
 static cHpiMarshal hpi_marshal[] =
 {
   dHpiMarshalEntry( saHpiSessionOpen ),
@@ -2149,6 +2245,14 @@ static cHpiMarshal hpi_marshal[] =
   dHpiMarshalEntry( saHpiFumiAutoRollbackDisableSet ),
   dHpiMarshalEntry( saHpiFumiActivateStart ),
   dHpiMarshalEntry( saHpiFumiCleanup ),
+
+  // OpenHPI extensions added after B.03.01
+  dHpiMarshalEntry( oHpiSensorCacheStatsGet ),
+  dHpiMarshalEntry( oHpiHandlerStatsGet ),
+  dHpiMarshalEntry( oHpiDelWriterStatsGet ),
+  dHpiMarshalEntry( oHpiEventLimitStatsGet ),
+  dHpiMarshalEntry( oHpiEventQueueStatsGet ),
+  dHpiMarshalEntry( oHpiEventLogEntriesGet ),
 };
 
 
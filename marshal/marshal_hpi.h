@@ -166,6 +166,14 @@ typedef enum
   eFsaHpiFumiActivateStart,
   eFsaHpiFumiCleanup,
 
+  // OpenHPI extensions added after B.03.01
+  eFoHpiSensorCacheStatsGet,
+  eFoHpiHandlerStatsGet,
+  eFoHpiDelWriterStatsGet,
+  eFoHpiEventLimitStatsGet,
+  eFoHpiEventQueueStatsGet,
+  eFoHpiEventLogEntriesGet,
+
 } tHpiFucntionId;
 
 
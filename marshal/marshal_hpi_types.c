@@ -1145,3 +1145,100 @@ static cMarshalType oHpiGlobalParamTypeElements[] =
 
 cMarshalType oHpiGlobalParamType = dStruct( oHpiGlobalParamTypeElements );
 
+
+// sensor cache stats
+static cMarshalType oHpiSensorCacheStatsElements[] =
+{
+  dStructElement( oHpiSensorCacheStatsT, TtlMsec, SaHpiUint32Type ),
+  dStructElement( oHpiSensorCacheStatsT, Entries, SaHpiUint32Type ),
+  dStructElement( oHpiSensorCacheStatsT, Hits, SaHpiUint64Type ),
+  dStructElement( oHpiSensorCacheStatsT, Misses, SaHpiUint64Type ),
+  dStructElement( oHpiSensorCacheStatsT, Coalesced, SaHpiUint64Type ),
+  dStructElement( oHpiSensorCacheStatsT, Invalidations, SaHpiUint64Type ),
+  dStructElementEnd()
+};
+
+cMarshalType oHpiSensorCacheStatsType = dStruct( oHpiSensorCacheStatsElements );
+
+
+// handler ABI call stats
+static cMarshalType HandlerStatsHistogramArray = dArray( "HandlerStatsHistogramArray", OHPI_HANDLER_STATS_BUCKETS, SaHpiUint32T, SaHpiUint32Type );
+
+static cMarshalType oHpiHandlerStatsElements[] =
+{
+  dStructElement( oHpiHandlerStatsT, Function, SaHpiTextBufferType ),
+  dStructElement( oHpiHandlerStatsT, Calls, SaHpiUint64Type ),
+  dStructElement( oHpiHandlerStatsT, Errors, SaHpiUint64Type ),
+  dStructElement( oHpiHandlerStatsT, TotalUsec, SaHpiUint64Type ),
+  dStructElement( oHpiHandlerStatsT, MaxUsec, SaHpiUint64Type ),
+  dStructElement( oHpiHandlerStatsT, Histogram, HandlerStatsHistogramArray ),
+  dStructElementEnd()
+};
+
+cMarshalType oHpiHandlerStatsType = dStruct( oHpiHandlerStatsElements );
+
+
+// DEL writer stats
+static cMarshalType oHpiDelWriterStatsElements[] =
+{
+  dStructElement( oHpiDelWriterStatsT, FlushIntervalMsec, SaHpiUint32Type ),
+  dStructElement( oHpiDelWriterStatsT, FlushBatch, SaHpiUint32Type ),
+  dStructElement( oHpiDelWriterStatsT, Pending, SaHpiUint32Type ),
+  dStructElement( oHpiDelWriterStatsT, Written, SaHpiUint64Type ),
+  dStructElement( oHpiDelWriterStatsT, Flushes, SaHpiUint64Type ),
+  dStructElement( oHpiDelWriterStatsT, Errors, SaHpiUint64Type ),
+  dStructElementEnd()
+};
+
+cMarshalType oHpiDelWriterStatsType = dStruct( oHpiDelWriterStatsElements );
+
+
+// event limit stats
+static cMarshalType oHpiEventLimitStatsElements[] =
+{
+  dStructElement( oHpiEventLimitStatsT, CoalesceWindowMsec, SaHpiUint32Type ),
+  dStructElement( oHpiEventLimitStatsT, CoalesceSources, SaHpiUint32Type ),
+  dStructElement( oHpiEventLimitStatsT, Rate, SaHpiUint32Type ),
+  dStructElement( oHpiEventLimitStatsT, Burst, SaHpiUint32Type ),
+  dStructElement( oHpiEventLimitStatsT, Held, SaHpiUint32Type ),
+  dStructElement( oHpiEventLimitStatsT, Coalesced, SaHpiUint64Type ),
+  dStructElement( oHpiEventLimitStatsT, RateLimited, SaHpiUint64Type ),
+  dStructElement( oHpiEventLimitStatsT, HarvestDeferred, SaHpiUint64Type ),
+  dStructElementEnd()
+};
+
+cMarshalType oHpiEventLimitStatsType = dStruct( oHpiEventLimitStatsElements );
+
+
+// event queue stats
+static cMarshalType oHpiEventQueueStatsElements[] =
+{
+  dStructElement( oHpiEventQueueStatsT, Queued, SaHpiUint32Type ),
+  dStructElement( oHpiEventQueueStatsT, MaxQueued, SaHpiUint32Type ),
+  dStructElement( oHpiEventQueueStatsT, Processed, SaHpiUint64Type ),
+  dStructElement( oHpiEventQueueStatsT, Promoted, SaHpiUint64Type ),
+  dStructElement( oHpiEventQueueStatsT, TotalUsec, SaHpiUint64Type ),
+  dStructElement( oHpiEventQueueStatsT, MaxUsec, SaHpiUint64Type ),
+  dStructElement( oHpiEventQueueStatsT, Histogram, HandlerStatsHistogramArray ),
+  dStructElementEnd()
+};
+
+cMarshalType oHpiEventQueueStatsType = dStruct( oHpiEventQueueStatsElements );
+
+
+// event log entry range
+static cMarshalType EventLogEntriesArray = dVarArray( "EventLogEntriesArray", 0, SaHpiEventLogEntryT, SaHpiEventLogEntryType );
+static cMarshalType EventLogRdrsArray = dVarArray( "EventLogRdrsArray", 2, SaHpiRdrT, SaHpiRdrType );
+static cMarshalType EventLogRptEntriesArray = dVarArray( "EventLogRptEntriesArray", 4, SaHpiRptEntryT, SaHpiRptEntryType );
+static cMarshalType oHpiEventLogEntriesElements[] =
+{
+  dStructElement( oHpiEventLogEntriesT, NumberOfEntries, SaHpiUint32Type ),
+  dStructElement( oHpiEventLogEntriesT, Entries, EventLogEntriesArray ),
+  dStructElement( oHpiEventLogEntriesT, NumberOfRdrs, SaHpiUint32Type ),
+  dStructElement( oHpiEventLogEntriesT, Rdrs, EventLogRdrsArray ),
+  dStructElement( oHpiEventLogEntriesT, NumberOfRptEntries, SaHpiUint32Type ),
+  dStructElement( oHpiEventLogEntriesT, RptEntries, EventLogRptEntriesArray ),
+  dStructElementEnd()
+};
+
+cMarshalType oHpiEventLogEntriesType = dStruct( oHpiEventLogEntriesElements );
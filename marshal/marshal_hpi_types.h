@@ -298,6 +298,13 @@ extern cMarshalType oHpiHandlerConfigType;
 extern cMarshalType oHpiHandlerInfoType;
 #define oHpiGlobalParamTypeType SaHpiUint32Type
 extern cMarshalType oHpiGlobalParamType;
+extern cMarshalType oHpiSensorCacheStatsType;
+extern cMarshalType oHpiHandlerStatsType;
+extern cMarshalType oHpiDelWriterStatsType;
+extern cMarshalType oHpiEventLimitStatsType;
+#define oHpiEventPriorityType SaHpiUint32Type
+extern cMarshalType oHpiEventQueueStatsType;
+extern cMarshalType oHpiEventLogEntriesType;
 
 #ifdef __cplusplus
 }
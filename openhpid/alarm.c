@@ -22,6 +22,56 @@
 
 #include "alarm.h"
 #include "conf.h"
+#include "sahpi_wrappers.h"
+
+/*
+ * DAT persistency.
+ *
+ * With OPENHPI_DAT_SAVE every alarm table change is recorded as an
+ * add/acknowledge/delete record. Records are queued while the domain is
+ * locked and appended to "dat.<did>.journal" by a background writer, at
+ * most OH_DAT_JOURNAL_FLUSH_INTERVAL later, or as soon as
+ * OH_DAT_JOURNAL_FLUSH_RECORDS records are waiting. Once a journal holds
+ * OH_DAT_JOURNAL_COMPACT_RECORDS records, the writer folds it into the
+ * "dat.<did>" snapshot and truncates it. On startup the snapshot is
+ * loaded and the journal is replayed on top of it.
+ */
+#define OH_DAT_JOURNAL_FLUSH_INTERVAL  G_USEC_PER_SEC
+#define OH_DAT_JOURNAL_FLUSH_RECORDS   256
+#define OH_DAT_JOURNAL_COMPACT_RECORDS 1024
+
+struct oh_dat_journal_rec {
+        SaHpiUint32T op; /* oh_dat_journal_op */
+        SaHpiAlarmT alarm;
+};
+
+struct dat_journal_item {
+        SaHpiDomainIdT did;
+        struct oh_dat_journal_rec rec;
+};
+
+struct dat_journal_file {
+        SaHpiDomainIdT did;
+        FILE *fp;
+        guint records;
+};
+
+/* Lives as long as the daemon, producers may race with writer shutdown */
+#if GLIB_CHECK_VERSION (2, 32, 0)
+static GMutex dat_writer_lock;
+#define DAT_WRITER_MUTEX (&dat_writer_lock)
+#else
+static GStaticMutex dat_writer_lock = G_STATIC_MUTEX_INIT;
+#define DAT_WRITER_MUTEX g_static_mutex_get_mutex(&dat_writer_lock)
+#endif
+/* Protected by dat_writer_lock */
+static gboolean dat_writer_running = FALSE;
+static GCond *dat_writer_cond = NULL;
+static GQueue *dat_pending = NULL;
+static GThread *dat_writer_thread = NULL;
+static gboolean dat_writer_stop = FALSE;
+/* Only touched by the writer thread */
+static GHashTable *dat_journals = NULL;
 
 static void __update_dat(struct oh_domain *d)
 {
@@ -108,7 +158,7 @@ static SaHpiUint32T __count_alarms(struct oh_domain *d,
  * @d: pointer to domain
  * @alarm: alarm to be added
  * @fromfile: if True will preserve alarm's id, timestamp, and
- * acknowledge flag. Also, it will not save immediatedly to disk,
+ * acknowledge flag. Also, it will not be journaled to disk,
  * if OPENHPI_DAT_SAVE is set.
  *
  * Return value: reference to newly added alarm or NULL if there was
@@ -170,16 +220,7 @@ SaHpiAlarmT *oh_add_alarm(struct oh_domain *d, SaHpiAlarmT *alarm, int fromfile)
 
         if (!fromfile) {
                 __update_dat(d);
-                param.type = OPENHPI_DAT_SAVE;
-                oh_get_global_param(&param);
-                if (param.u.dat_save) {
-                        char dat_filepath[SAHPI_MAX_TEXT_BUFFER_LENGTH*2];
-                        param.type = OPENHPI_VARPATH;
-                        oh_get_global_param(&param);
-                        snprintf(dat_filepath, SAHPI_MAX_TEXT_BUFFER_LENGTH*2,
-                                        "%s/dat.%u", param.u.varpath, d->id);
-                        oh_alarms_to_file(&d->dat, dat_filepath);
-                }
+                oh_journal_alarm(d, OH_DAT_JOURNAL_ADD, a);
         }
 
         return a;
@@ -223,30 +264,16 @@ SaHpiAlarmT *oh_get_alarm(struct oh_domain *d,
         return alarm_node->data;
 }
 
-/**
- * oh_remove_alarm
- * @d: pointer to domain
- * @severity: Optional. Severity of alarm to remove
- * @type: Optional. Type of alarm to remove
- * @rid: Optional. Resource Id of alarm to remove
- * @mid: Optional. Manufacturer Id of alarm to remove
- * @num: Optional. Sensor Number of alarm to remove
- * @state: Optional. Event state of alarm to remove
- * @deassert_mask: Optional. Deassert Mask. Matches on a bit AND operation.
- * @multi: If True, does operation for all matching alarms, otherwise,
- * just the first matching one.
- *
- * Return value: SA_OK on success
- **/
-SaErrorT oh_remove_alarm(struct oh_domain *d,
-                         SaHpiSeverityT *severity,
-                         SaHpiStatusCondTypeT *type,
-                         SaHpiResourceIdT *rid,
-                         SaHpiManufacturerIdT *mid,
-                         SaHpiSensorNumT *num,
-                         SaHpiEventStateT *state,
-                         SaHpiEventStateT *deassert_mask,
-                         int multi)
+static SaErrorT __remove_alarm(struct oh_domain *d,
+                               SaHpiSeverityT *severity,
+                               SaHpiStatusCondTypeT *type,
+                               SaHpiResourceIdT *rid,
+                               SaHpiManufacturerIdT *mid,
+                               SaHpiSensorNumT *num,
+                               SaHpiEventStateT *state,
+                               SaHpiEventStateT *deassert_mask,
+                               int multi,
+                               int journal)
 {
         GSList *alarm_node = NULL;
         SaHpiAlarmT *alarm = NULL;
@@ -263,6 +290,10 @@ SaErrorT oh_remove_alarm(struct oh_domain *d,
 
                 aid = alarm->AlarmId;
                 if (deassert_mask ? *deassert_mask & alarm->AlarmCond.EventState : 1) {
+                        if (journal) {
+                                oh_journal_alarm(d, OH_DAT_JOURNAL_DELETE,
+                                                 alarm);
+                        }
                         d->dat.list = g_slist_delete_link(d->dat.list, alarm_node);
                         g_free(alarm);
                 }
@@ -280,6 +311,35 @@ SaErrorT oh_remove_alarm(struct oh_domain *d,
         return SA_OK;
 }
 
+/**
+ * oh_remove_alarm
+ * @d: pointer to domain
+ * @severity: Optional. Severity of alarm to remove
+ * @type: Optional. Type of alarm to remove
+ * @rid: Optional. Resource Id of alarm to remove
+ * @mid: Optional. Manufacturer Id of alarm to remove
+ * @num: Optional. Sensor Number of alarm to remove
+ * @state: Optional. Event state of alarm to remove
+ * @deassert_mask: Optional. Deassert Mask. Matches on a bit AND operation.
+ * @multi: If True, does operation for all matching alarms, otherwise,
+ * just the first matching one.
+ *
+ * Return value: SA_OK on success
+ **/
+SaErrorT oh_remove_alarm(struct oh_domain *d,
+                         SaHpiSeverityT *severity,
+                         SaHpiStatusCondTypeT *type,
+                         SaHpiResourceIdT *rid,
+                         SaHpiManufacturerIdT *mid,
+                         SaHpiSensorNumT *num,
+                         SaHpiEventStateT *state,
+                         SaHpiEventStateT *deassert_mask,
+                         int multi)
+{
+        return __remove_alarm(d, severity, type, rid, mid, num, state,
+                              deassert_mask, multi, 1);
+}
+
 /**
  * oh_close_alarmtable
  * @d: pointer to domain
@@ -294,8 +354,9 @@ SaErrorT oh_close_alarmtable(struct oh_domain *d)
 
         if (!d) return SA_ERR_HPI_INVALID_PARAMS;
 
-        error = oh_remove_alarm(d, NULL, NULL, NULL, NULL,
-                                NULL, NULL, NULL, 1);
+        /* Not journaled: the saved table outlives the in-memory one */
+        error = __remove_alarm(d, NULL, NULL, NULL, NULL,
+                               NULL, NULL, NULL, 1, 0);
         d->dat.next_id = 0;
         d->dat.update_count = 0;
         d->dat.update_timestamp = SAHPI_TIME_UNSPECIFIED;
@@ -744,3 +805,443 @@ SaErrorT oh_alarms_from_file(struct oh_domain *d, char *filename)
         return SA_OK;
 }
 
+
+static void __dat_journal_path(SaHpiDomainIdT did,
+                               const char *suffix,
+                               char *path)
+{
+        struct oh_global_param param = { .type = OPENHPI_VARPATH };
+
+        oh_get_global_param(&param);
+        snprintf(path, SAHPI_MAX_TEXT_BUFFER_LENGTH*2,
+                 "%s/dat.%u%s", param.u.varpath, did, suffix);
+}
+
+/**
+ * oh_alarms_journal_replay
+ *
+ * @d: pointer to domain. alarm table in this domain was loaded
+ * with oh_alarms_from_file() and receives the changes recorded after it.
+ * @filename: journal file to replay
+ *
+ * A missing journal is not an error.
+ *
+ * Return value: SA_OK on success
+ **/
+SaErrorT oh_alarms_journal_replay(struct oh_domain *d, char *filename)
+{
+        FILE *fp;
+        struct oh_dat_journal_rec rec;
+        GSList *node;
+        SaHpiAlarmIdT aid;
+        guint records = 0;
+
+        if (!d || !filename) {
+                return SA_ERR_HPI_ERROR;
+        }
+
+        fp = fopen(filename, "rb");
+        if (!fp) {
+                return SA_OK;
+        }
+
+        while (fread(&rec, sizeof(rec), 1, fp) == 1) {
+                aid = rec.alarm.AlarmId;
+                node = __get_alarm_node(d, &aid, NULL, NULL, NULL, NULL,
+                                        NULL, NULL, 0, 0);
+                switch (rec.op) {
+                case OH_DAT_JOURNAL_ADD:
+                        if (!node && !oh_add_alarm(d, &rec.alarm, 1)) {
+                                CRIT("Error adding alarm read from journal.");
+                        }
+                        break;
+                case OH_DAT_JOURNAL_ACK:
+                        if (node) {
+                                ((SaHpiAlarmT *)node->data)->Acknowledged =
+                                        SAHPI_TRUE;
+                        }
+                        break;
+                case OH_DAT_JOURNAL_DELETE:
+                        if (node) {
+                                g_free(node->data);
+                                d->dat.list =
+                                        g_slist_delete_link(d->dat.list, node);
+                        }
+                        break;
+                default:
+                        CRIT("Unknown record in journal '%s'.", filename);
+                        break;
+                }
+                records++;
+        }
+
+        fclose(fp);
+
+        if (records) {
+                __update_dat(d);
+                DBG("Replayed %u records from '%s'.", records, filename);
+        }
+
+        return SA_OK;
+}
+
+/**
+ * oh_journal_alarm
+ *
+ * @d: pointer to locked domain that owns @alarm
+ * @op: change made to the alarm table
+ * @alarm: added, acknowledged or deleted alarm
+ *
+ * Queues the change for the alarm table writer if OPENHPI_DAT_SAVE
+ * is set. Must be called with the domain locked, so that records are
+ * queued in the order the changes are made.
+ **/
+void oh_journal_alarm(struct oh_domain *d,
+                      oh_dat_journal_op op,
+                      const SaHpiAlarmT *alarm)
+{
+        struct oh_global_param param = { .type = OPENHPI_DAT_SAVE };
+        struct dat_journal_item *item;
+
+        if (!d || !alarm) {
+                return;
+        }
+
+        oh_get_global_param(&param);
+        if (!param.u.dat_save) {
+                return;
+        }
+
+        item = g_new0(struct dat_journal_item, 1);
+        item->did = d->id;
+        item->rec.op = op;
+        item->rec.alarm = *alarm;
+
+        g_mutex_lock(DAT_WRITER_MUTEX);
+        if (!dat_writer_running) {
+                g_mutex_unlock(DAT_WRITER_MUTEX);
+                g_free(item);
+                return;
+        }
+        g_queue_push_tail(dat_pending, item);
+        if (g_queue_get_length(dat_pending) == OH_DAT_JOURNAL_FLUSH_RECORDS) {
+                g_cond_signal(dat_writer_cond);
+        }
+        g_mutex_unlock(DAT_WRITER_MUTEX);
+}
+
+static void __dat_journal_close(gpointer data)
+{
+        struct dat_journal_file *jf = data;
+
+        if (jf->fp) {
+                fclose(jf->fp);
+        }
+        g_free(jf);
+}
+
+static void __dat_journal_compact(struct dat_journal_file *jf);
+
+static struct dat_journal_file *__dat_journal_get(SaHpiDomainIdT did)
+{
+        struct dat_journal_file *jf;
+        char path[SAHPI_MAX_TEXT_BUFFER_LENGTH*2];
+        long size;
+
+        jf = g_hash_table_lookup(dat_journals, &did);
+        if (jf) {
+                return jf;
+        }
+
+        jf = g_new0(struct dat_journal_file, 1);
+        jf->did = did;
+        __dat_journal_path(did, ".journal", path);
+        jf->fp = fopen(path, "ab");
+        if (!jf->fp) {
+                CRIT("File '%s' could not be opened", path);
+                g_free(jf);
+                return NULL;
+        }
+        fseek(jf->fp, 0, SEEK_END);
+        size = ftell(jf->fp);
+        if (size > 0) {
+                jf->records = size / sizeof(struct oh_dat_journal_rec);
+        }
+        g_hash_table_insert(dat_journals, &jf->did, jf);
+
+        /*
+         * The replay skipped a record torn by a crash. Records appended
+         * after it would be misaligned, so start over from a snapshot.
+         */
+        if (size > 0 && size % sizeof(struct oh_dat_journal_rec) != 0) {
+                __dat_journal_compact(jf);
+                /* Compaction may drop the journal from the table */
+                return g_hash_table_lookup(dat_journals, &did);
+        }
+
+        return jf;
+}
+
+static gint __dat_item_did_cmp(gconstpointer a, gconstpointer b)
+{
+        const struct dat_journal_item *item = a;
+
+        return (item->did == *(const SaHpiDomainIdT *)b) ? 0 : 1;
+}
+
+/*
+ * Puts records taken out for a failed compaction back in front of the
+ * queue, ahead of the ones queued for the domain since.
+ */
+static void __dat_journal_requeue(GQueue *saved)
+{
+        GList *link;
+
+        g_mutex_lock(DAT_WRITER_MUTEX);
+        while ((link = g_queue_pop_tail_link(saved)) != NULL) {
+                g_queue_push_head_link(dat_pending, link);
+        }
+        g_mutex_unlock(DAT_WRITER_MUTEX);
+}
+
+/*
+ * Folds the journal into the snapshot: the alarm table is written to a
+ * temporary file that replaces "dat.<did>", then the journal is truncated.
+ */
+static void __dat_journal_compact(struct dat_journal_file *jf)
+{
+        struct oh_domain *d;
+        struct oh_dat snapshot;
+        GSList *node;
+        GList *link;
+        GQueue saved = G_QUEUE_INIT;
+        char path[SAHPI_MAX_TEXT_BUFFER_LENGTH*2];
+        char tmppath[SAHPI_MAX_TEXT_BUFFER_LENGTH*2];
+        SaErrorT error;
+
+        d = oh_get_domain(jf->did);
+        if (!d) {
+                return;
+        }
+
+        /*
+         * Pending records are already part of the table being saved.
+         * They are dropped only once the snapshot is in place.
+         */
+        g_mutex_lock(DAT_WRITER_MUTEX);
+        while ((link = g_queue_find_custom(dat_pending, &jf->did,
+                                           __dat_item_did_cmp)) != NULL) {
+                g_queue_unlink(dat_pending, link);
+                g_queue_push_tail_link(&saved, link);
+        }
+        g_mutex_unlock(DAT_WRITER_MUTEX);
+
+        memset(&snapshot, 0, sizeof(snapshot));
+        for (node = d->dat.list; node; node = node->next) {
+                snapshot.list = g_slist_prepend(snapshot.list,
+                                g_memdup(node->data, sizeof(SaHpiAlarmT)));
+        }
+        snapshot.list = g_slist_reverse(snapshot.list);
+        oh_release_domain(d);
+
+        __dat_journal_path(jf->did, "", path);
+        __dat_journal_path(jf->did, ".tmp", tmppath);
+        error = oh_alarms_to_file(&snapshot, tmppath);
+        g_slist_foreach(snapshot.list, (GFunc)g_free, NULL);
+        g_slist_free(snapshot.list);
+        if (error != SA_OK) {
+                __dat_journal_requeue(&saved);
+                return;
+        }
+#ifdef _WIN32
+        remove(path);
+#endif
+        if (rename(tmppath, path) != 0) {
+                CRIT("Couldn't replace '%s'.", path);
+                __dat_journal_requeue(&saved);
+                return;
+        }
+        g_queue_foreach(&saved, (GFunc)g_free, NULL);
+        g_queue_clear(&saved);
+
+        __dat_journal_path(jf->did, ".journal", path);
+        fclose(jf->fp);
+        jf->fp = fopen(path, "wb");
+        if (!jf->fp) {
+                CRIT("File '%s' could not be opened", path);
+                g_hash_table_remove(dat_journals, &jf->did);
+                return;
+        }
+        jf->records = 0;
+}
+
+static void __dat_journal_write(GQueue *batch)
+{
+        struct dat_journal_item *item;
+        struct dat_journal_file *jf;
+        GHashTableIter iter;
+        gpointer value;
+
+        while ((item = g_queue_pop_head(batch)) != NULL) {
+                jf = __dat_journal_get(item->did);
+                if (jf) {
+                        if (fwrite(&item->rec, sizeof(item->rec), 1,
+                                   jf->fp) != 1) {
+                                CRIT("Couldn't write DAT journal for domain %u.",
+                                     item->did);
+                        } else {
+                                jf->records++;
+                        }
+                }
+                g_free(item);
+        }
+
+        g_hash_table_iter_init(&iter, dat_journals);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+                jf = value;
+                fflush(jf->fp);
+        }
+}
+
+static void __dat_journal_compact_all(guint min_records)
+{
+        GList *journals, *node;
+        struct dat_journal_file *jf;
+
+        /* Compaction may drop a journal from the table */
+        journals = g_hash_table_get_values(dat_journals);
+        for (node = journals; node; node = node->next) {
+                jf = node->data;
+                if (jf->records && jf->records >= min_records) {
+                        __dat_journal_compact(jf);
+                }
+        }
+        g_list_free(journals);
+}
+
+static gpointer dat_writer_func(gpointer data)
+{
+        GQueue *batch;
+
+        DBG("Begin alarm table writing.");
+
+        g_mutex_lock(DAT_WRITER_MUTEX);
+        while (dat_writer_stop == FALSE) {
+                /*
+                 * Producers only wake us for a full batch or shutdown,
+                 * otherwise whatever piled up is written once per interval.
+                 */
+                if (g_queue_get_length(dat_pending) <
+                    OH_DAT_JOURNAL_FLUSH_RECORDS) {
+                        #if GLIB_CHECK_VERSION (2, 32, 0)
+                        gint64 time;
+                        time = g_get_monotonic_time();
+                        time = time + OH_DAT_JOURNAL_FLUSH_INTERVAL;
+                        wrap_g_cond_timed_wait(dat_writer_cond,
+                                               DAT_WRITER_MUTEX, time);
+                        #else
+                        GTimeVal time;
+                        g_get_current_time(&time);
+                        g_time_val_add(&time, OH_DAT_JOURNAL_FLUSH_INTERVAL);
+                        wrap_g_cond_timed_wait(dat_writer_cond,
+                                               DAT_WRITER_MUTEX, &time);
+                        #endif
+                }
+                if (dat_writer_stop || g_queue_is_empty(dat_pending)) {
+                        continue;
+                }
+
+                batch = dat_pending;
+                dat_pending = g_queue_new();
+                g_mutex_unlock(DAT_WRITER_MUTEX);
+
+                __dat_journal_write(batch);
+                g_queue_free(batch);
+                __dat_journal_compact_all(OH_DAT_JOURNAL_COMPACT_RECORDS);
+
+                g_mutex_lock(DAT_WRITER_MUTEX);
+        }
+
+        /* Flush what is left and leave only snapshots behind */
+        batch = dat_pending;
+        dat_pending = g_queue_new();
+        g_mutex_unlock(DAT_WRITER_MUTEX);
+
+        __dat_journal_write(batch);
+        g_queue_free(batch);
+        __dat_journal_compact_all(1);
+
+        /* Keep records of failed compactions in the journal at least */
+        g_mutex_lock(DAT_WRITER_MUTEX);
+        batch = dat_pending;
+        dat_pending = g_queue_new();
+        g_mutex_unlock(DAT_WRITER_MUTEX);
+
+        __dat_journal_write(batch);
+        g_queue_free(batch);
+
+        DBG("Done with alarm table writing.");
+
+        return 0;
+}
+
+/**
+ * oh_alarm_writer_start
+ *
+ * Starts the thread that writes queued alarm table changes to disk.
+ **/
+void oh_alarm_writer_start(void)
+{
+        g_mutex_lock(DAT_WRITER_MUTEX);
+        if (dat_writer_running) {
+                g_mutex_unlock(DAT_WRITER_MUTEX);
+                return;
+        }
+
+        dat_writer_stop = FALSE;
+        dat_pending = g_queue_new();
+        dat_journals = g_hash_table_new_full(g_int_hash, g_int_equal,
+                                             NULL, __dat_journal_close);
+        dat_writer_cond = wrap_g_cond_new_init();
+        dat_writer_running = TRUE;
+        dat_writer_thread = wrap_g_thread_create_new("DatWriter",
+                                                     dat_writer_func,
+                                                     0, TRUE, 0);
+        g_mutex_unlock(DAT_WRITER_MUTEX);
+}
+
+/**
+ * oh_alarm_writer_stop
+ *
+ * Flushes queued alarm table changes, compacts the journals
+ * and stops the writer thread.
+ **/
+void oh_alarm_writer_stop(void)
+{
+        GThread *thread;
+
+        g_mutex_lock(DAT_WRITER_MUTEX);
+        if (!dat_writer_running || dat_writer_stop) {
+                g_mutex_unlock(DAT_WRITER_MUTEX);
+                return;
+        }
+        dat_writer_stop = TRUE;
+        thread = dat_writer_thread;
+        g_cond_broadcast(dat_writer_cond);
+        g_mutex_unlock(DAT_WRITER_MUTEX);
+        g_thread_join(thread);
+
+        g_mutex_lock(DAT_WRITER_MUTEX);
+        /* Producers see the writer gone from here on */
+        dat_writer_running = FALSE;
+        g_hash_table_destroy(dat_journals);
+        /* Only changes made after the final flush can be left here */
+        g_queue_foreach(dat_pending, (GFunc)g_free, NULL);
+        g_queue_free(dat_pending);
+        wrap_g_cond_free(dat_writer_cond);
+        dat_journals = NULL;
+        dat_pending = NULL;
+        dat_writer_cond = NULL;
+        dat_writer_thread = NULL;
+        g_mutex_unlock(DAT_WRITER_MUTEX);
+}
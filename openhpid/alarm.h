@@ -71,8 +71,20 @@ SaErrorT oh_detect_sensor_mask_alarm(SaHpiDomainIdT did,
                                      SaHpiEventStateT deassert_mask);
 
 /* Persistency */
+typedef enum {
+        OH_DAT_JOURNAL_ADD = 1,
+        OH_DAT_JOURNAL_ACK,
+        OH_DAT_JOURNAL_DELETE
+} oh_dat_journal_op;
+
 SaErrorT oh_alarms_to_file(struct oh_dat *at, char *filename);
 SaErrorT oh_alarms_from_file(struct oh_domain *d, char *filename);
+SaErrorT oh_alarms_journal_replay(struct oh_domain *d, char *filename);
+void oh_journal_alarm(struct oh_domain *d,
+                      oh_dat_journal_op op,
+                      const SaHpiAlarmT *alarm);
+void oh_alarm_writer_start(void);
+void oh_alarm_writer_stop(void);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -59,6 +59,9 @@ static const char *known_globals[] = {
         "OPENHPI_UNCONFIGURED",
         "OPENHPI_AUTOINSERT_TIMEOUT",
         "OPENHPI_AUTOINSERT_TIMEOUT_READONLY",
+        "OPENHPI_DEL_FLUSH_INTERVAL",
+        "OPENHPI_DEL_FLUSH_BATCH",
+        "OPENHPI_EVT_WORKERS",
         NULL
 };
 
@@ -77,6 +80,9 @@ static struct {
         SaHpiBoolT unconfigured;
         SaHpiTimeoutT ai_timeout;
         SaHpiBoolT ai_timeout_readonly;
+        SaHpiUint32T del_flush_interval;
+        SaHpiUint32T del_flush_batch;
+        SaHpiUint32T evt_workers;
         unsigned char read_env;
         GStaticRecMutex lock;
 } global_params = { /* Defaults for global params are set here */
@@ -93,6 +99,9 @@ static struct {
         .unconfigured = SAHPI_FALSE,
         .ai_timeout = 0,
         .ai_timeout_readonly = SAHPI_TRUE,
+        .del_flush_interval = 1000, /* msec */
+        .del_flush_batch = 100, /* 0 is flush on interval only */
+        .evt_workers = 4,
         .read_env = 0,
         .lock = G_STATIC_REC_MUTEX_INIT
 };
@@ -237,6 +246,12 @@ static void process_global_param(const char *name, char *value)
                 } else {
                         global_params.ai_timeout_readonly = SAHPI_FALSE;
                 }
+        } else if (!strcmp("OPENHPI_DEL_FLUSH_INTERVAL", name)) {
+                global_params.del_flush_interval = atoi(value);
+        } else if (!strcmp("OPENHPI_DEL_FLUSH_BATCH", name)) {
+                global_params.del_flush_batch = atoi(value);
+        } else if (!strcmp("OPENHPI_EVT_WORKERS", name)) {
+                global_params.evt_workers = atoi(value);
 	} else {
                 CRIT("Invalid global parameter %s in config file.", name);
         }
@@ -803,6 +818,15 @@ int oh_get_global_param(struct oh_global_param *param)
                 case OPENHPI_AUTOINSERT_TIMEOUT_READONLY:
                         param->u.ai_timeout_readonly = global_params.ai_timeout_readonly;
                         break;
+                case OPENHPI_DEL_FLUSH_INTERVAL:
+                        param->u.del_flush_interval = global_params.del_flush_interval;
+                        break;
+                case OPENHPI_DEL_FLUSH_BATCH:
+                        param->u.del_flush_batch = global_params.del_flush_batch;
+                        break;
+                case OPENHPI_EVT_WORKERS:
+                        param->u.evt_workers = global_params.evt_workers;
+                        break;
                 default:
                         wrap_g_static_rec_mutex_unlock(&global_params.lock);
                         CRIT("Invalid global parameter %d!", param->type);
@@ -896,6 +920,15 @@ int oh_set_global_param(const struct oh_global_param *param)
                 case OPENHPI_AUTOINSERT_TIMEOUT_READONLY:
                         global_params.ai_timeout_readonly = param->u.ai_timeout_readonly;
                         break;
+                case OPENHPI_DEL_FLUSH_INTERVAL:
+                        global_params.del_flush_interval = param->u.del_flush_interval;
+                        break;
+                case OPENHPI_DEL_FLUSH_BATCH:
+                        global_params.del_flush_batch = param->u.del_flush_batch;
+                        break;
+                case OPENHPI_EVT_WORKERS:
+                        global_params.evt_workers = param->u.evt_workers;
+                        break;
                 default:
                         wrap_g_static_rec_mutex_unlock(&global_params.lock);
                         CRIT("Invalid global parameter %d!", param->type);
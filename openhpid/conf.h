@@ -46,7 +46,10 @@ typedef enum {
         OPENHPI_CONF, 
 	OPENHPI_UNCONFIGURED,
         OPENHPI_AUTOINSERT_TIMEOUT,
-        OPENHPI_AUTOINSERT_TIMEOUT_READONLY
+        OPENHPI_AUTOINSERT_TIMEOUT_READONLY,
+        OPENHPI_DEL_FLUSH_INTERVAL,
+        OPENHPI_DEL_FLUSH_BATCH,
+        OPENHPI_EVT_WORKERS
 } oh_global_param_type;
 
 typedef union {
@@ -64,6 +67,9 @@ typedef union {
 	SaHpiBoolT unconfigured;
         SaHpiTimeoutT ai_timeout;
         SaHpiBoolT ai_timeout_readonly;
+        SaHpiUint32T del_flush_interval;
+        SaHpiUint32T del_flush_batch;
+        SaHpiUint32T evt_workers;
 } oh_global_param_union;
 
 struct oh_global_param {
@@ -0,0 +1,332 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * Domain event log writer.
+ *
+ * With OPENHPI_DEL_SAVE, logging an event only marks the domain event
+ * log as dirty. A background thread writes dirty logs to "del.<did>"
+ * once OPENHPI_DEL_FLUSH_INTERVAL msec have passed since the oldest
+ * pending entry was logged, or earlier when OPENHPI_DEL_FLUSH_BATCH
+ * entries are pending. The domain is only locked to copy the log;
+ * the file is written without it. Pending entries are written when
+ * the writer stops.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <oh_domain.h>
+#include <oh_error.h>
+#include <oh_utils.h>
+
+#include "conf.h"
+#include "del_writer.h"
+#include "sahpi_wrappers.h"
+
+struct del_dirty {
+        SaHpiDomainIdT did;
+        SaHpiUint32T entries; /* Entries logged since the last write */
+};
+
+/* Lives as long as the daemon, producers may race with writer shutdown */
+#if GLIB_CHECK_VERSION (2, 32, 0)
+static GMutex del_writer_lock;
+#define DEL_WRITER_MUTEX (&del_writer_lock)
+#else
+static GStaticMutex del_writer_lock = G_STATIC_MUTEX_INIT;
+#define DEL_WRITER_MUTEX g_static_mutex_get_mutex(&del_writer_lock)
+#endif
+/* Protected by del_writer_lock */
+static gboolean del_writer_running = FALSE;
+static GCond *del_writer_cond = NULL;
+static GThread *del_writer_thread = NULL;
+static gboolean del_writer_stop = FALSE;
+static GHashTable *del_dirty = NULL; /* did -> struct del_dirty */
+static gint64 del_oldest = 0; /* When the oldest pending entry was logged */
+static SaHpiUint32T del_pending = 0;
+static SaHpiUint32T del_inflight = 0; /* Taken by the writer, not written yet */
+static SaHpiUint64T del_written = 0;
+static SaHpiUint64T del_flushes = 0;
+static SaHpiUint64T del_errors = 0;
+
+
+static gint64 del_now(void)
+{
+#if GLIB_CHECK_VERSION (2, 28, 0)
+        return g_get_monotonic_time();
+#else
+        GTimeVal now;
+        g_get_current_time(&now);
+        return ((gint64)now.tv_sec * G_USEC_PER_SEC) + now.tv_usec;
+#endif
+}
+
+static void del_get_limits(SaHpiUint32T *interval, SaHpiUint32T *batch)
+{
+        struct oh_global_param param;
+
+        oh_get_global_param2(OPENHPI_DEL_FLUSH_INTERVAL, &param);
+        *interval = param.u.del_flush_interval;
+        oh_get_global_param2(OPENHPI_DEL_FLUSH_BATCH, &param);
+        *batch = param.u.del_flush_batch;
+}
+
+/*
+ * Copies the domain event log with the domain locked
+ * and writes it with the domain unlocked.
+ */
+static SaErrorT del_write(SaHpiDomainIdT did)
+{
+        struct oh_global_param param = { .type = OPENHPI_VARPATH };
+        char path[SAHPI_MAX_TEXT_BUFFER_LENGTH*2];
+        char tmppath[SAHPI_MAX_TEXT_BUFFER_LENGTH*2];
+        struct oh_domain *d;
+        oh_el_entry *entries;
+        GList *node;
+        guint n, i;
+        FILE *fp;
+
+        d = oh_get_domain(did);
+        if (!d) {
+                /* Domain is gone, so is its log */
+                return SA_OK;
+        }
+        n = g_list_length(d->del->list);
+        entries = g_new(oh_el_entry, n ? n : 1);
+        for (node = d->del->list, i = 0; node; node = node->next, i++) {
+                entries[i] = *(oh_el_entry *)node->data;
+        }
+        oh_release_domain(d);
+
+        oh_get_global_param(&param);
+        snprintf(path, sizeof(path), "%s/del.%u", param.u.varpath, did);
+        snprintf(tmppath, sizeof(tmppath), "%s.tmp", path);
+
+        fp = fopen(tmppath, "wb");
+        if (!fp) {
+                CRIT("EL file '%s' could not be opened", tmppath);
+                g_free(entries);
+                return SA_ERR_HPI_ERROR;
+        }
+        if (n && fwrite(entries, sizeof(oh_el_entry), n, fp) != n) {
+                CRIT("Couldn't write to file '%s'.", tmppath);
+                fclose(fp);
+                g_free(entries);
+                return SA_ERR_HPI_ERROR;
+        }
+        fclose(fp);
+        g_free(entries);
+
+#ifdef _WIN32
+        remove(path);
+#endif
+        if (rename(tmppath, path) != 0) {
+                CRIT("Couldn't replace '%s'.", path);
+                return SA_ERR_HPI_ERROR;
+        }
+
+        return SA_OK;
+}
+
+/* Called with del_writer_lock held, returns with it held */
+static void del_flush(void)
+{
+        GHashTable *dirty;
+        GHashTableIter iter;
+        gpointer value;
+        struct del_dirty *dd;
+        SaErrorT error;
+
+        dirty = del_dirty;
+        del_dirty = g_hash_table_new_full(g_int_hash, g_int_equal,
+                                          NULL, g_free);
+        del_inflight = del_pending;
+        del_pending = 0;
+        g_mutex_unlock(DEL_WRITER_MUTEX);
+
+        g_hash_table_iter_init(&iter, dirty);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+                dd = value;
+                error = del_write(dd->did);
+
+                g_mutex_lock(DEL_WRITER_MUTEX);
+                del_inflight -= dd->entries;
+                if (error == SA_OK) {
+                        del_written += dd->entries;
+                        del_flushes++;
+                } else {
+                        del_errors++;
+                }
+                g_mutex_unlock(DEL_WRITER_MUTEX);
+        }
+        g_hash_table_destroy(dirty);
+
+        g_mutex_lock(DEL_WRITER_MUTEX);
+}
+
+static gpointer del_writer_func(gpointer data)
+{
+        SaHpiUint32T interval, batch;
+        gint64 wait;
+
+        DBG("Begin event log writing.");
+
+        g_mutex_lock(DEL_WRITER_MUTEX);
+        while (del_writer_stop == FALSE) {
+                del_get_limits(&interval, &batch);
+                wait = (gint64)interval * 1000;
+                if (del_pending) {
+                        wait = del_oldest + wait - del_now();
+                        if (wait <= 0 || (batch && del_pending >= batch)) {
+                                del_flush();
+                                continue;
+                        }
+                } else if (wait == 0) {
+                        wait = G_USEC_PER_SEC;
+                }
+
+                #if GLIB_CHECK_VERSION (2, 32, 0)
+                gint64 time;
+                time = g_get_monotonic_time();
+                time = time + wait;
+                wrap_g_cond_timed_wait(del_writer_cond, DEL_WRITER_MUTEX, time);
+                #else
+                GTimeVal time;
+                g_get_current_time(&time);
+                g_time_val_add(&time, (glong)wait);
+                wrap_g_cond_timed_wait(del_writer_cond, DEL_WRITER_MUTEX, &time);
+                #endif
+        }
+
+        if (del_pending) {
+                del_flush();
+        }
+        g_mutex_unlock(DEL_WRITER_MUTEX);
+
+        DBG("Done with event log writing.");
+
+        return 0;
+}
+
+/**
+ * oh_del_writer_start
+ *
+ * Starts the thread that saves domain event logs to disk.
+ **/
+void oh_del_writer_start(void)
+{
+        g_mutex_lock(DEL_WRITER_MUTEX);
+        if (del_writer_running) {
+                g_mutex_unlock(DEL_WRITER_MUTEX);
+                return;
+        }
+
+        del_writer_stop = FALSE;
+        del_dirty = g_hash_table_new_full(g_int_hash, g_int_equal,
+                                          NULL, g_free);
+        del_writer_cond = wrap_g_cond_new_init();
+        del_writer_running = TRUE;
+        del_writer_thread = wrap_g_thread_create_new("DelWriter",
+                                                     del_writer_func,
+                                                     0, TRUE, 0);
+        g_mutex_unlock(DEL_WRITER_MUTEX);
+}
+
+/**
+ * oh_del_writer_stop
+ *
+ * Writes the pending event logs and stops the writer thread.
+ **/
+void oh_del_writer_stop(void)
+{
+        GThread *thread;
+
+        g_mutex_lock(DEL_WRITER_MUTEX);
+        if (!del_writer_running || del_writer_stop) {
+                g_mutex_unlock(DEL_WRITER_MUTEX);
+                return;
+        }
+        del_writer_stop = TRUE;
+        thread = del_writer_thread;
+        g_cond_broadcast(del_writer_cond);
+        g_mutex_unlock(DEL_WRITER_MUTEX);
+        g_thread_join(thread);
+
+        g_mutex_lock(DEL_WRITER_MUTEX);
+        /* Producers see the writer gone from here on */
+        del_writer_running = FALSE;
+        g_hash_table_destroy(del_dirty);
+        wrap_g_cond_free(del_writer_cond);
+        del_dirty = NULL;
+        del_writer_cond = NULL;
+        del_writer_thread = NULL;
+        /* Only entries logged after the final flush can be left here */
+        del_pending = 0;
+        g_mutex_unlock(DEL_WRITER_MUTEX);
+}
+
+/**
+ * oh_del_writer_queue
+ * @did: domain whose event log got a new entry
+ *
+ * Schedules the domain event log to be saved. Called with the domain
+ * locked, right after the entry was logged.
+ **/
+void oh_del_writer_queue(SaHpiDomainIdT did)
+{
+        struct del_dirty *dd;
+        SaHpiUint32T interval, batch;
+
+        del_get_limits(&interval, &batch);
+
+        g_mutex_lock(DEL_WRITER_MUTEX);
+        if (!del_writer_running) {
+                g_mutex_unlock(DEL_WRITER_MUTEX);
+                return;
+        }
+        dd = g_hash_table_lookup(del_dirty, &did);
+        if (!dd) {
+                dd = g_new0(struct del_dirty, 1);
+                dd->did = did;
+                g_hash_table_insert(del_dirty, &dd->did, dd);
+        }
+        dd->entries++;
+        if (del_pending++ == 0) {
+                del_oldest = del_now();
+                g_cond_signal(del_writer_cond);
+        } else if (batch && del_pending >= batch) {
+                g_cond_signal(del_writer_cond);
+        }
+        g_mutex_unlock(DEL_WRITER_MUTEX);
+}
+
+/**
+ * oh_del_writer_get_stats
+ * @stats: filled with the writer counters
+ **/
+void oh_del_writer_get_stats(oHpiDelWriterStatsT *stats)
+{
+        if (!stats) {
+                return;
+        }
+
+        memset(stats, 0, sizeof(*stats));
+        del_get_limits(&stats->FlushIntervalMsec, &stats->FlushBatch);
+
+        g_mutex_lock(DEL_WRITER_MUTEX);
+        stats->Pending = del_pending + del_inflight;
+        stats->Written = del_written;
+        stats->Flushes = del_flushes;
+        stats->Errors = del_errors;
+        g_mutex_unlock(DEL_WRITER_MUTEX);
+}
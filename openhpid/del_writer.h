@@ -0,0 +1,35 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __OH_DEL_WRITER_H
+#define __OH_DEL_WRITER_H
+
+#include <SaHpi.h>
+#include <oHpi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oh_del_writer_start(void);
+void oh_del_writer_stop(void);
+
+void oh_del_writer_queue(SaHpiDomainIdT did);
+
+void oh_del_writer_get_stats(oHpiDelWriterStatsT *stats);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __OH_DEL_WRITER_H */
@@ -424,6 +424,9 @@ SaErrorT oh_create_domain(SaHpiDomainIdT id,
 			 SAHPI_MAX_TEXT_BUFFER_LENGTH*2,
 			 "%s/dat.%u", param.u.varpath, domain->id);
 		oh_alarms_from_file(domain, filepath);
+		strncat(filepath, ".journal",
+			SAHPI_MAX_TEXT_BUFFER_LENGTH*2 - strlen(filepath) - 1);
+		oh_alarms_journal_replay(domain, filepath);
 	}
 
         /* Need to put new domain in table before relating to other domains. */
@@ -34,11 +34,16 @@
 
 #include "alarm.h"
 #include "conf.h"
+#include "del_writer.h"
 #include "event.h"
+#include "event_limit.h"
+#include "sahpi_wrappers.h"
+#include "sensor_cache.h"
 
 
 extern volatile int signal_stop;
 oh_evt_queue * oh_process_q = 0;
+static GMutex *evt_stats_lock = NULL; /* event queue statistics */
 
 /*
  *  The following is required to set up the thread state for
@@ -49,6 +54,7 @@ int oh_event_init()
 {
         DBG("Setting up event processing queue.");
         if (!oh_process_q) oh_process_q = g_async_queue_new();
+        if (!evt_stats_lock) evt_stats_lock = wrap_g_mutex_new_init();
         if (oh_process_q) {
                 DBG("Set up processing queue.");
                 return 1;
@@ -64,6 +70,10 @@ int oh_event_finit(void)
                 g_async_queue_unref(oh_process_q);
                 DBG("Processing queue is disposed.");
         }
+        if (evt_stats_lock) {
+                wrap_g_mutex_free_clear(evt_stats_lock);
+                evt_stats_lock = NULL;
+        }
         return 0;
 }
 
@@ -167,6 +177,19 @@ int oh_detect_quit_event(struct oh_event * e)
  *  2. Processing of the events into: Domain Event Log, Alarm Table,
  *  Session queues, Resource Precense Table.
  *
+ *  Processing is spread over OPENHPI_EVT_WORKERS threads. Events are
+ *  assigned to a worker by source resource, so events of one resource
+ *  are processed in order. A worker updates the RPT, the DEL and the
+ *  alarm table with the domain locked, then queues the event to the
+ *  sessions with the domain unlocked, while other workers can use it.
+ *
+ *  Resource, hotswap and domain events are queued to the workers ahead
+ *  of other events, sensor and OEM events last (see evt_worker_push).
+ *
+ *  Handlers configured with event limits (see event_limit.c) are asked
+ *  for events only while they have rate tokens left, and their events
+ *  are coalesced and rate limited before they reach the workers.
+ *
  */
 
 static SaErrorT harvest_events_for_handler(struct oh_handler *h)
@@ -176,9 +199,21 @@ static SaErrorT harvest_events_for_handler(struct oh_handler *h)
 	if (!h->hnd || !h->abi->get_event) return SA_OK;
 
         do {
+                gint64 start;
+
+                if (!oh_event_limit_harvest_allowed(h->id)) {
+                        DBG("Handler %u is out of event tokens", h->id);
+                        break;
+                }
+                start = oh_abi_stats_start();
                 error = h->abi->get_event(h->hnd);
+                /* get_event returns the number of events or a negative error */
+                oh_abi_stats_record(h, OH_ABI_FUNC_INDEX(get_event),
+                                    (error < 0) ? error : SA_OK, start);
                 if (error < 1) {
                         DBG("Handler is out of Events");
+                } else {
+                        oh_event_limit_harvested(h->id, error);
                 }
         } while (error > 0);
 
@@ -225,7 +260,6 @@ SaErrorT oh_harvest_events()
 static int oh_add_event_to_del(struct oh_domain *d, struct oh_event *e)
 {
         struct oh_global_param param = { .type = OPENHPI_LOG_ON_SEV };
-        char del_filepath[SAHPI_MAX_TEXT_BUFFER_LENGTH*2];
         int error = 0;
 
         if (!d || !e) return -1;
@@ -249,23 +283,16 @@ static int oh_add_event_to_del(struct oh_domain *d, struct oh_event *e)
 		}
 
                 if (param.u.del_save) {
-                        param.type = OPENHPI_VARPATH;
-                        oh_get_global_param(&param);
-                        snprintf(del_filepath,
-                                 SAHPI_MAX_TEXT_BUFFER_LENGTH*2,
-                                 "%s/del.%u", param.u.varpath, d->id);
-                        oh_el_map_to_file(d->del, del_filepath);
+                        oh_del_writer_queue(d->id);
                 }
         }
 
         return error;
 }
 
+/* Returns 1 if the event is to be delivered to the domain sessions */
 static int process_hpi_event(struct oh_domain *d, struct oh_event *e)
 {
-        int i;
-        GArray *sessions = NULL;
-        SaHpiSessionIdT sid;
         SaHpiEventT *event = NULL;
         SaHpiRptEntryT *resource = NULL;
         SaHpiRdrT *rdr = NULL;
@@ -284,22 +311,32 @@ static int process_hpi_event(struct oh_domain *d, struct oh_event *e)
         oh_add_event_to_del(d, e);
         DBG("Added event to EL");
 
+        return 1;
+}
+
+/* Called with the domain unlocked */
+static int deliver_hpi_event(SaHpiDomainIdT did, struct oh_event *e)
+{
+        int i;
+        GArray *sessions = NULL;
+        SaHpiSessionIdT sid;
+
         /*
          * Here is the SESSION MULTIPLEXING code
          */
-        sessions = oh_list_sessions(d->id);
+        sessions = oh_list_sessions(did);
         if (!sessions) {
-                CRIT("Error: Got an empty session list on domain id %u", d->id);
+                CRIT("Error: Got an empty session list on domain id %u", did);
                 return -2;
         }
-        DBG("Got session list for domain %u", d->id);
+        DBG("Got session list for domain %u", did);
 
         /* Drop events if there are no sessions open to receive them.
          */
         if (sessions->len < 1) {
                 g_array_free(sessions, TRUE);
                 DBG("No sessions open for event's domain %u. "
-                    "Dropping hpi_event", d->id);
+                    "Dropping hpi_event", did);
                 return 0;
         }
 
@@ -399,7 +436,9 @@ static int process_resource_event(struct oh_domain *d, struct oh_event *e)
         }
 
         if ( process ) {
-            process_hpi_event(d, e);
+            /* Cached readings may not survive a change of the resource */
+            oh_sensor_cache_invalidate_resource(e->hid, e->resource.ResourceId);
+            return process_hpi_event(d, e);
         }
 
         return 0;
@@ -422,6 +461,7 @@ static int process_hs_event(struct oh_domain *d, struct oh_event *e)
         hse = &e->event.EventDataUnion.HotSwapEvent;
         if (hse->HotSwapState == SAHPI_HS_STATE_NOT_PRESENT) {
             oh_remove_resource(rpt, e->resource.ResourceId);
+            oh_sensor_cache_invalidate_resource(e->hid, e->resource.ResourceId);
         } else {
             hidp = g_new0(unsigned int, 1);
             *hidp = e->hid;
@@ -436,7 +476,7 @@ static int process_hs_event(struct oh_domain *d, struct oh_event *e)
         }
 
         if (hse->HotSwapState != hse->PreviousHotSwapState) {
-            process_hpi_event(d, e);
+            return process_hpi_event(d, e);
         }
 
         return 0;
@@ -447,6 +487,7 @@ static int process_event(SaHpiDomainIdT did,
 {
         struct oh_domain *d = NULL;
         RPTable *rpt = NULL;
+        int deliver = 0;
 
         if (!e) {
 		CRIT("Got NULL event");
@@ -480,7 +521,7 @@ static int process_event(SaHpiDomainIdT did,
                         CRIT("Invalid event. Resource in resource added event "
                             "has FRU capability. Dropping.");
                 } else {
-                        process_resource_event(d, e);
+                        deliver = process_resource_event(d, e);
                 }
                 break;
         case SAHPI_ET_HOTSWAP:
@@ -503,11 +544,19 @@ static int process_event(SaHpiDomainIdT did,
                         CRIT("Invalid event. Resource in hotswap event "
                                 "has no FRU capability. Dropping.");
                 } else {
-                        process_hs_event(d, e);
+                        deliver = process_hs_event(d, e);
                 }
                 break;
         case SAHPI_ET_SENSOR:
+                oh_sensor_cache_invalidate(e->hid, e->event.Source,
+                        e->event.EventDataUnion.SensorEvent.SensorNum);
+                deliver = process_hpi_event(d, e);
+                break;
         case SAHPI_ET_SENSOR_ENABLE_CHANGE:
+                oh_sensor_cache_invalidate(e->hid, e->event.Source,
+                        e->event.EventDataUnion.SensorEnableChangeEvent.SensorNum);
+                deliver = process_hpi_event(d, e);
+                break;
         case SAHPI_ET_WATCHDOG:
         case SAHPI_ET_HPI_SW:
         case SAHPI_ET_OEM:
@@ -516,7 +565,7 @@ static int process_event(SaHpiDomainIdT did,
         case SAHPI_ET_DIMI:
         case SAHPI_ET_DIMI_UPDATE:
         case SAHPI_ET_FUMI:
-                process_hpi_event(d, e);
+                deliver = process_hpi_event(d, e);
                 break;
         default:
 		CRIT("Don't know what to do for event type  %d", e->event.EventType);
@@ -524,23 +573,351 @@ static int process_event(SaHpiDomainIdT did,
         oh_detect_event_alarm(d, e);
         oh_release_domain(d);
 
+        if (deliver > 0) {
+                deliver_hpi_event(did, e);
+        }
+
         return 0;
 }
 
-SaErrorT oh_process_events()
+/*
+ * Each worker has a queue per priority class. A worker takes the oldest
+ * event of the highest class first. To keep the events of a resource in
+ * order, an event moves the events of its resource still queued in lower
+ * classes up to its own class, ahead of it. The links of each resource's
+ * events are indexed per class, so only the moved events are touched.
+ */
+struct evt_node {
+        struct oh_event *e;
+        SaHpiResourceIdT rid;
+        guint prio; /* class the event was queued with */
+        gint64 queued;
+};
+
+/* Links into the worker's class queues, in queue order */
+struct evt_resource {
+        GQueue links[OHPI_EVENT_PRIORITY_LEVELS];
+        guint count;
+};
+
+struct evt_worker {
+        GThread *thread;
+        GMutex *lock;
+        GCond *cond;
+        GQueue *levels[OHPI_EVENT_PRIORITY_LEVELS];
+        GHashTable *resources; /* rid -> struct evt_resource */
+        SaHpiBoolT stop;
+};
+
+struct evt_class_stats {
+        SaHpiUint32T queued;
+        SaHpiUint32T max_queued;
+        SaHpiUint64T processed;
+        SaHpiUint64T promoted;
+        SaHpiUint64T total_usec;
+        SaHpiUint64T max_usec;
+        SaHpiUint32T hist[OHPI_HANDLER_STATS_BUCKETS];
+};
+
+static struct evt_class_stats evt_stats[OHPI_EVENT_PRIORITY_LEVELS];
+
+static guint evt_priority(const struct oh_event *e)
+{
+        switch (e->event.EventType) {
+        case SAHPI_ET_RESOURCE:
+        case SAHPI_ET_HOTSWAP:
+        case SAHPI_ET_DOMAIN:
+                return OHPI_EVENT_PRIORITY_HIGH;
+        case SAHPI_ET_SENSOR:
+        case SAHPI_ET_OEM:
+                return OHPI_EVENT_PRIORITY_LOW;
+        default:
+                return OHPI_EVENT_PRIORITY_NORMAL;
+        }
+}
+
+/* Called with the worker locked */
+static void evt_worker_promote(struct evt_worker *w,
+                               struct evt_resource *r,
+                               guint prio)
 {
-        int cc;
+        GList *link;
+        struct evt_node *n;
+        guint level;
+
+        for (level = prio + 1; level < OHPI_EVENT_PRIORITY_LEVELS; level++) {
+                if (g_queue_is_empty(&r->links[level])) {
+                        continue;
+                }
+                g_mutex_lock(evt_stats_lock);
+                while ((link = g_queue_pop_head(&r->links[level])) != NULL) {
+                        n = link->data;
+                        g_queue_unlink(w->levels[level], link);
+                        g_queue_push_tail_link(w->levels[prio], link);
+                        g_queue_push_tail(&r->links[prio], link);
+                        evt_stats[n->prio].promoted++;
+                }
+                g_mutex_unlock(evt_stats_lock);
+        }
+}
+
+static void evt_worker_push(struct evt_worker *w, struct oh_event *e)
+{
+        struct evt_node *n;
+        struct evt_resource *r;
+        struct evt_class_stats *s;
+
+        n = g_new(struct evt_node, 1);
+        n->e = e;
+        n->rid = e->event.Source;
+        n->prio = evt_priority(e);
+        n->queued = oh_abi_stats_start();
+
+        g_mutex_lock(w->lock);
+        r = g_hash_table_lookup(w->resources, GUINT_TO_POINTER(n->rid));
+        if (!r) {
+                r = g_new0(struct evt_resource, 1);
+                g_hash_table_insert(w->resources, GUINT_TO_POINTER(n->rid), r);
+        }
+        if (n->prio != OHPI_EVENT_PRIORITY_LOW) {
+                evt_worker_promote(w, r, n->prio);
+        }
+        g_queue_push_tail(w->levels[n->prio], n);
+        g_queue_push_tail(&r->links[n->prio], w->levels[n->prio]->tail);
+        r->count++;
+        g_mutex_lock(evt_stats_lock);
+        s = &evt_stats[n->prio];
+        s->queued++;
+        if (s->queued > s->max_queued) {
+                s->max_queued = s->queued;
+        }
+        g_mutex_unlock(evt_stats_lock);
+        g_cond_signal(w->cond);
+        g_mutex_unlock(w->lock);
+}
+
+/* Returns NULL once the worker is stopped and its queues are empty */
+static struct oh_event *evt_worker_pop(struct evt_worker *w)
+{
+        struct evt_node *n = NULL;
+        struct evt_resource *r;
+        struct evt_class_stats *s;
         struct oh_event *e;
+        unsigned int bucket = 0;
+        gint64 usec;
+        guint level;
+
+        g_mutex_lock(w->lock);
+        for (;;) {
+                for (level = 0; level < OHPI_EVENT_PRIORITY_LEVELS; level++) {
+                        n = g_queue_pop_head(w->levels[level]);
+                        if (n) {
+                                /* The oldest event of its resource
+                                 * in this class */
+                                r = g_hash_table_lookup(w->resources,
+                                                GUINT_TO_POINTER(n->rid));
+                                g_queue_pop_head(&r->links[level]);
+                                if (--r->count == 0) {
+                                        g_hash_table_remove(w->resources,
+                                                GUINT_TO_POINTER(n->rid));
+                                }
+                                break;
+                        }
+                }
+                if (n || w->stop) {
+                        break;
+                }
+                g_cond_wait(w->cond, w->lock);
+        }
+        g_mutex_unlock(w->lock);
+
+        if (!n) {
+                return NULL;
+        }
+
+        usec = oh_abi_stats_start() - n->queued;
+        if (usec < 0) usec = 0;
+        while ((bucket < OHPI_HANDLER_STATS_BUCKETS - 1) &&
+               ((usec >> bucket) != 0)) {
+                bucket++;
+        }
 
-        while ((e = g_async_queue_pop(oh_process_q)) != NULL) {
+        g_mutex_lock(evt_stats_lock);
+        s = &evt_stats[n->prio];
+        s->queued--;
+        s->processed++;
+        s->total_usec += usec;
+        if ((SaHpiUint64T)usec > s->max_usec) s->max_usec = usec;
+        s->hist[bucket]++;
+        g_mutex_unlock(evt_stats_lock);
+
+        e = n->e;
+        g_free(n);
+
+        return e;
+}
+
+static gpointer evt_worker_func(gpointer data)
+{
+        struct evt_worker *w = data;
+        struct oh_event *e;
+
+        while ((e = evt_worker_pop(w)) != NULL) {
                 process_event(OH_DEFAULT_DOMAIN_ID, e);
-                cc = oh_detect_quit_event(e);
                 oh_event_free(e, FALSE);
-                if (cc == 0) {
+        }
+
+        return 0;
+}
+
+static guint evt_worker_index(const struct oh_event *e, guint nworkers)
+{
+        /* Keeps the events of a resource in one worker, hence in order */
+        return e->event.Source % nworkers;
+}
+
+/* Passes coalesced events whose window is over to the workers.
+ * Returns the usec until the next one is due, or -1 if none is held. */
+static gint64 evt_release_held(struct evt_worker *workers, guint nworkers,
+                               SaHpiBoolT all)
+{
+        GSList *events, *node;
+        gint64 wait;
+
+        wait = oh_event_limit_release(all, &events);
+        for (node = events; node; node = node->next) {
+                struct oh_event *e = node->data;
+                evt_worker_push(&workers[evt_worker_index(e, nworkers)], e);
+        }
+        g_slist_free(events);
+
+        return wait;
+}
+
+static struct oh_event *evt_pop(gint64 wait)
+{
+        if (wait < 0) {
+                return g_async_queue_pop(oh_process_q);
+        }
+#if GLIB_CHECK_VERSION (2, 32, 0)
+        return wrap_g_async_queue_timed_pop(oh_process_q, (guint64)wait);
+#else
+        GTimeVal end;
+        g_get_current_time(&end);
+        g_time_val_add(&end, (glong)wait);
+        return wrap_g_async_queue_timed_pop(oh_process_q, &end);
+#endif
+}
+
+SaErrorT oh_process_events()
+{
+        struct oh_global_param param = { .type = OPENHPI_EVT_WORKERS };
+        struct evt_worker *workers;
+        struct oh_event *e, *held;
+        GSList *released, *node;
+        guint nworkers, i, level;
+
+        if (oh_get_global_param(&param) || param.u.evt_workers == 0) {
+                nworkers = 1;
+        } else {
+                nworkers = param.u.evt_workers;
+        }
+
+        DBG("Starting %u event processing workers.", nworkers);
+        workers = g_new0(struct evt_worker, nworkers);
+        for (i = 0; i < nworkers; i++) {
+                workers[i].lock = wrap_g_mutex_new_init();
+                workers[i].cond = wrap_g_cond_new_init();
+                for (level = 0; level < OHPI_EVENT_PRIORITY_LEVELS; level++) {
+                        workers[i].levels[level] = g_queue_new();
+                }
+                workers[i].resources = g_hash_table_new_full(g_direct_hash,
+                                                             g_direct_equal,
+                                                             NULL, g_free);
+                workers[i].thread = wrap_g_thread_create_new("EventWorker",
+                                                        evt_worker_func,
+                                                        &workers[i], TRUE, 0);
+        }
+
+        for (;;) {
+                e = evt_pop(evt_release_held(workers, nworkers, SAHPI_FALSE));
+                if (!e) {
+                        continue; /* a held event is due */
+                }
+                if (oh_detect_quit_event(e) == 0) {
                         break;
                 }
+                e = oh_event_limit_filter(e, &released);
+                for (node = released; node; node = node->next) {
+                        held = node->data;
+                        i = evt_worker_index(held, nworkers);
+                        evt_worker_push(&workers[i], held);
+                }
+                g_slist_free(released);
+                if (e) {
+                        i = evt_worker_index(e, nworkers);
+                        evt_worker_push(&workers[i], e);
+                }
 	}
 
+        /* Let the workers finish their events, the quit event goes last */
+        evt_release_held(workers, nworkers, SAHPI_TRUE);
+        for (i = 0; i < nworkers; i++) {
+                g_mutex_lock(workers[i].lock);
+                workers[i].stop = SAHPI_TRUE;
+                g_cond_signal(workers[i].cond);
+                g_mutex_unlock(workers[i].lock);
+        }
+        for (i = 0; i < nworkers; i++) {
+                g_thread_join(workers[i].thread);
+                for (level = 0; level < OHPI_EVENT_PRIORITY_LEVELS; level++) {
+                        g_queue_free(workers[i].levels[level]);
+                }
+                g_hash_table_destroy(workers[i].resources);
+                wrap_g_cond_free(workers[i].cond);
+                wrap_g_mutex_free_clear(workers[i].lock);
+        }
+        g_free(workers);
+
+        if (e) {
+                process_event(OH_DEFAULT_DOMAIN_ID, e);
+                oh_event_free(e, FALSE);
+        }
+
         return SA_OK;
 }
 
+/**
+ * oh_event_queue_get_stats
+ * @prio: priority class
+ * @stats: where the counters of the class are returned
+ *
+ * Returns SA_ERR_HPI_INVALID_PARAMS for an unknown class.
+ **/
+SaErrorT oh_event_queue_get_stats(SaHpiUint32T prio,
+                                  oHpiEventQueueStatsT *stats)
+{
+        struct evt_class_stats *s;
+
+        if (prio >= OHPI_EVENT_PRIORITY_LEVELS || !stats) {
+                return SA_ERR_HPI_INVALID_PARAMS;
+        }
+
+        memset(stats, 0, sizeof(*stats));
+        if (!evt_stats_lock) {
+                return SA_OK;
+        }
+
+        g_mutex_lock(evt_stats_lock);
+        s = &evt_stats[prio];
+        stats->Queued = s->queued;
+        stats->MaxQueued = s->max_queued;
+        stats->Processed = s->processed;
+        stats->Promoted = s->promoted;
+        stats->TotalUsec = s->total_usec;
+        stats->MaxUsec = s->max_usec;
+        memcpy(stats->Histogram, s->hist, sizeof(stats->Histogram));
+        g_mutex_unlock(evt_stats_lock);
+
+        return SA_OK;
+}
@@ -20,6 +20,7 @@
 #ifndef __OH_EVENT_H
 #define __OH_EVENT_H
 
+#include <oHpi.h>
 #include <oh_utils.h>
 
 #ifdef __cplusplus
@@ -35,6 +36,8 @@ void oh_post_quit_event(void);
 int oh_detect_quit_event(struct oh_event * e);
 SaErrorT oh_harvest_events(void);
 SaErrorT oh_process_events(void);
+SaErrorT oh_event_queue_get_stats(SaHpiUint32T prio,
+                                  oHpiEventQueueStatsT *stats);
 
 #ifdef __cplusplus
 }
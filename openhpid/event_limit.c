@@ -0,0 +1,699 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * Per-handler event coalescing and rate limiting.
+ *
+ * Coalescing: after a sensor event for a (resource, sensor, event state)
+ * is passed on, later events for the same key are held until the
+ * "event_coalesce_window" (or the per-source "event_coalesce_sources")
+ * window is over. Only the last held event is kept. When the window
+ * ends it is passed on if it changes the assertion state last passed on,
+ * otherwise the held assert/deassert pairs cancel out and it is dropped.
+ * Any other event of the resource that is passed on ends the windows of
+ * the resource first, so the events of a resource stay in order. Held
+ * events of a removed resource or handler are dropped.
+ *
+ * Rate limiting: a token bucket refilled at "event_rate" events per
+ * second, "event_burst" deep. Harvesting stops while the bucket is empty
+ * and the harvested events are paid for up front. Events that plugin
+ * threads queue on their own are paid for when dispatched, and sensor
+ * events are dropped if the bucket is empty. Other events always pass.
+ *
+ * Handlers without these parameters are not affected.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <oh_error.h>
+
+#include "event_limit.h"
+#include "sahpi_wrappers.h"
+
+struct limit_handler {
+        unsigned int hid;
+        gint64 window; /* usec, 0 if not coalescing by default */
+        GHashTable *windows; /* per source windows in msec, by ResourceId */
+        guint rate; /* events per second, 0 if not rate limited */
+        guint burst;
+        gdouble tokens;
+        gint64 refilled;
+        guint prepaid; /* harvested events not dispatched yet */
+        guint held;
+        SaHpiUint64T coalesced;
+        SaHpiUint64T rate_limited;
+        SaHpiUint64T deferred;
+};
+
+struct limit_key {
+        unsigned int hid;
+        SaHpiResourceIdT rid;
+        SaHpiSensorNumT num;
+        SaHpiEventStateT state;
+};
+
+struct limit_entry {
+        struct limit_key key;
+        struct limit_handler *lh;
+        gint64 window;
+        gint64 window_end;
+        SaHpiBoolT assertion; /* last assertion state passed on */
+        struct oh_event *held;
+};
+
+struct limit_release {
+        SaHpiBoolT all;
+        gint64 now;
+        gint64 deadline;
+        unsigned int hid; /* for handler or resource removal and flushes */
+        SaHpiBoolT resource; /* only the entries of hid and rid */
+        SaHpiResourceIdT rid;
+        GSList *events;
+};
+
+static GMutex *limit_lock = NULL;
+static GHashTable *limit_handlers = NULL;
+static GHashTable *limit_entries = NULL;
+static volatile gint limit_count = 0; /* handlers with limits */
+static guint limit_held = 0;
+static gint64 limit_deadline = 0; /* earliest end of a held window */
+static gint64 limit_pruned = 0; /* last pass over limit_entries */
+
+/* Keys that are not held are forgotten at most this long after their
+ * window ended, even if no event is ever held */
+#define LIMIT_PRUNE_INTERVAL G_USEC_PER_SEC
+
+
+static gint64 limit_now(void)
+{
+#if GLIB_CHECK_VERSION (2, 28, 0)
+        return g_get_monotonic_time();
+#else
+        GTimeVal now;
+        g_get_current_time(&now);
+        return ((gint64)now.tv_sec * G_USEC_PER_SEC) + now.tv_usec;
+#endif
+}
+
+static guint limit_key_hash(gconstpointer key)
+{
+        const struct limit_key *k = key;
+
+        return ((k->hid * 131u + k->rid) * 257u + k->num) * 31u + k->state;
+}
+
+static gboolean limit_key_equal(gconstpointer a, gconstpointer b)
+{
+        const struct limit_key *ka = a;
+        const struct limit_key *kb = b;
+
+        return (ka->hid == kb->hid) &&
+               (ka->rid == kb->rid) &&
+               (ka->num == kb->num) &&
+               (ka->state == kb->state);
+}
+
+static void limit_handler_free(gpointer data)
+{
+        struct limit_handler *lh = data;
+
+        if (lh->windows) {
+                g_hash_table_destroy(lh->windows);
+        }
+        g_free(lh);
+}
+
+static void limit_entry_free(gpointer data)
+{
+        struct limit_entry *le = data;
+
+        if (le->held) {
+                oh_event_free(le->held, FALSE);
+        }
+        g_free(le);
+}
+
+static gint limit_event_cmp(gconstpointer a, gconstpointer b)
+{
+        const struct oh_event *ea = a;
+        const struct oh_event *eb = b;
+
+        if (ea->event.Timestamp < eb->event.Timestamp) {
+                return -1;
+        }
+        return (ea->event.Timestamp > eb->event.Timestamp) ? 1 : 0;
+}
+
+void oh_event_limit_init(void)
+{
+        if (limit_lock) {
+                return;
+        }
+
+        limit_lock = wrap_g_mutex_new_init();
+        limit_handlers = g_hash_table_new_full(g_int_hash, g_int_equal,
+                                               NULL, limit_handler_free);
+        limit_entries = g_hash_table_new_full(limit_key_hash, limit_key_equal,
+                                              NULL, limit_entry_free);
+}
+
+void oh_event_limit_finit(void)
+{
+        if (!limit_lock) {
+                return;
+        }
+
+        g_hash_table_destroy(limit_entries);
+        g_hash_table_destroy(limit_handlers);
+        limit_entries = NULL;
+        limit_handlers = NULL;
+        limit_held = 0;
+        g_atomic_int_set(&limit_count, 0);
+        wrap_g_mutex_free_clear(limit_lock);
+        limit_lock = NULL;
+}
+
+static guint limit_config_uint(GHashTable *config, const char *key)
+{
+        const char *value;
+
+        value = (const char *)g_hash_table_lookup(config, key);
+        if (!value) {
+                return 0;
+        }
+
+        return (guint)strtoul(value, NULL, 10);
+}
+
+/* Parses "rid:msec[,rid:msec...]" */
+static GHashTable *limit_config_windows(GHashTable *config)
+{
+        GHashTable *windows;
+        const char *value;
+        gchar **pairs;
+        char *end;
+        unsigned long rid, msec;
+        int i;
+
+        value = (const char *)g_hash_table_lookup(config,
+                                                  OH_EVENT_COALESCE_SOURCES_KEY);
+        if (!value) {
+                return NULL;
+        }
+
+        windows = g_hash_table_new(g_direct_hash, g_direct_equal);
+        pairs = g_strsplit(value, ",", -1);
+        for (i = 0; pairs[i]; i++) {
+                rid = strtoul(pairs[i], &end, 10);
+                if (end == pairs[i] || *end != ':') {
+                        CRIT("Ignoring invalid %s entry \"%s\".",
+                             OH_EVENT_COALESCE_SOURCES_KEY, pairs[i]);
+                        continue;
+                }
+                msec = strtoul(end + 1, NULL, 10);
+                g_hash_table_insert(windows, GUINT_TO_POINTER(rid),
+                                    GUINT_TO_POINTER(msec));
+        }
+        g_strfreev(pairs);
+
+        if (g_hash_table_size(windows) == 0) {
+                g_hash_table_destroy(windows);
+                return NULL;
+        }
+
+        return windows;
+}
+
+void oh_event_limit_handler_add(unsigned int hid, GHashTable *config)
+{
+        struct limit_handler *lh;
+        guint window, rate, burst;
+        GHashTable *windows;
+
+        if (!limit_lock || !config) {
+                return;
+        }
+
+        window = limit_config_uint(config, OH_EVENT_COALESCE_WINDOW_KEY);
+        rate = limit_config_uint(config, OH_EVENT_RATE_KEY);
+        burst = limit_config_uint(config, OH_EVENT_BURST_KEY);
+        windows = limit_config_windows(config);
+        if (window == 0 && rate == 0 && !windows) {
+                return;
+        }
+
+        lh = g_new0(struct limit_handler, 1);
+        lh->hid = hid;
+        lh->window = (gint64)window * 1000;
+        lh->windows = windows;
+        lh->rate = rate;
+        lh->burst = (burst != 0) ? burst : rate;
+        lh->tokens = lh->burst;
+        lh->refilled = limit_now();
+
+        g_mutex_lock(limit_lock);
+        if (!g_hash_table_lookup(limit_handlers, &hid)) {
+                g_atomic_int_inc(&limit_count);
+        }
+        g_hash_table_insert(limit_handlers, &lh->hid, lh);
+        g_mutex_unlock(limit_lock);
+
+        INFO("Event limits for handler %u: coalescing window %u msec "
+             "(%u per source), rate %u/sec, burst %u.",
+             hid, window, windows ? g_hash_table_size(windows) : 0,
+             rate, lh->burst);
+}
+
+static gboolean limit_match_handler(gpointer key, gpointer value,
+                                    gpointer data)
+{
+        struct limit_entry *le = value;
+        struct limit_release *r = data;
+
+        if (le->key.hid != r->hid) {
+                return FALSE;
+        }
+        if (le->held) {
+                limit_held--;
+        }
+
+        return TRUE;
+}
+
+void oh_event_limit_handler_remove(unsigned int hid)
+{
+        struct limit_release r;
+
+        if (!limit_lock) {
+                return;
+        }
+
+        g_mutex_lock(limit_lock);
+        if (g_hash_table_lookup(limit_handlers, &hid)) {
+                /* Held events of the handler go with it */
+                memset(&r, 0, sizeof(r));
+                r.hid = hid;
+                g_hash_table_foreach_remove(limit_entries,
+                                            limit_match_handler, &r);
+                g_hash_table_remove(limit_handlers, &hid);
+                g_atomic_int_add(&limit_count, -1);
+        }
+        g_mutex_unlock(limit_lock);
+}
+
+static void limit_refill(struct limit_handler *lh, gint64 now)
+{
+        lh->tokens += (gdouble)(now - lh->refilled) * lh->rate /
+                      G_USEC_PER_SEC;
+        if (lh->tokens > lh->burst) {
+                lh->tokens = lh->burst;
+        }
+        lh->refilled = now;
+}
+
+/**
+ * oh_event_limit_harvest_allowed
+ * @hid: handler id
+ *
+ * Returns SAHPI_FALSE, and counts a deferred harvest, if the token bucket
+ * of the handler is empty. The events stay with the plugin until the
+ * next harvest.
+ **/
+SaHpiBoolT oh_event_limit_harvest_allowed(unsigned int hid)
+{
+        struct limit_handler *lh;
+        SaHpiBoolT allowed = SAHPI_TRUE;
+
+        if (!limit_lock || g_atomic_int_get(&limit_count) == 0) {
+                return SAHPI_TRUE;
+        }
+
+        g_mutex_lock(limit_lock);
+        lh = g_hash_table_lookup(limit_handlers, &hid);
+        if (lh && lh->rate != 0) {
+                limit_refill(lh, limit_now());
+                if (lh->tokens < 1) {
+                        lh->deferred++;
+                        allowed = SAHPI_FALSE;
+                }
+        }
+        g_mutex_unlock(limit_lock);
+
+        return allowed;
+}
+
+/**
+ * oh_event_limit_harvested
+ * @hid: handler id
+ * @nevents: number of events queued by the handler's get_event()
+ *
+ * Pays for harvested events, so they are not charged again when they
+ * are dispatched.
+ **/
+void oh_event_limit_harvested(unsigned int hid, int nevents)
+{
+        struct limit_handler *lh;
+
+        if (!limit_lock || nevents < 1 ||
+            g_atomic_int_get(&limit_count) == 0) {
+                return;
+        }
+
+        g_mutex_lock(limit_lock);
+        lh = g_hash_table_lookup(limit_handlers, &hid);
+        if (lh && lh->rate != 0) {
+                lh->tokens -= nevents;
+                lh->prepaid += nevents;
+                if (lh->prepaid > lh->burst) {
+                        lh->prepaid = lh->burst;
+                }
+        }
+        g_mutex_unlock(limit_lock);
+}
+
+static gint64 limit_window(struct limit_handler *lh, SaHpiResourceIdT rid)
+{
+        gpointer msec;
+
+        if (lh->windows &&
+            g_hash_table_lookup_extended(lh->windows, GUINT_TO_POINTER(rid),
+                                         NULL, &msec)) {
+                return (gint64)GPOINTER_TO_UINT(msec) * 1000;
+        }
+
+        return lh->window;
+}
+
+/* Returns SAHPI_FALSE if the event is to be dropped */
+static SaHpiBoolT limit_take(struct limit_handler *lh, struct oh_event *e,
+                             gint64 now)
+{
+        limit_refill(lh, now);
+        if (lh->tokens >= 1) {
+                lh->tokens -= 1;
+                return SAHPI_TRUE;
+        }
+
+        return (e->event.EventType == SAHPI_ET_SENSOR) ?
+                SAHPI_FALSE : SAHPI_TRUE;
+}
+
+static gboolean limit_prune_entry(gpointer key, gpointer value,
+                                  gpointer data)
+{
+        struct limit_entry *le = value;
+        gint64 now = *(gint64 *)data;
+
+        return (!le->held && now >= le->window_end) ? TRUE : FALSE;
+}
+
+static gboolean limit_release_entry(gpointer key, gpointer value,
+                                    gpointer data);
+
+static gboolean limit_match_resource(gpointer key, gpointer value,
+                                     gpointer data)
+{
+        struct limit_entry *le = value;
+        struct limit_release *r = data;
+
+        if (le->key.hid != r->hid || le->key.rid != r->rid) {
+                return FALSE;
+        }
+        if (le->held) {
+                le->lh->held--;
+                limit_held--;
+        }
+
+        return TRUE;
+}
+
+static SaHpiBoolT limit_resource_gone(const struct oh_event *e)
+{
+        if (e->event.EventType == SAHPI_ET_RESOURCE) {
+                return (e->event.EventDataUnion.ResourceEvent.ResourceEventType
+                        == SAHPI_RESE_RESOURCE_REMOVED) ? SAHPI_TRUE : SAHPI_FALSE;
+        }
+        if (e->event.EventType == SAHPI_ET_HOTSWAP) {
+                return (e->event.EventDataUnion.HotSwapEvent.HotSwapState
+                        == SAHPI_HS_STATE_NOT_PRESENT) ? SAHPI_TRUE : SAHPI_FALSE;
+        }
+
+        return SAHPI_FALSE;
+}
+
+/*
+ * Called with limit_lock held for an event that is passed on. Held events
+ * of its resource go ahead of it, so the resource's events stay in order.
+ * If the resource went away, they are dropped.
+ */
+static GSList *limit_flush_resource(struct limit_handler *lh,
+                                    const struct oh_event *e,
+                                    gint64 now)
+{
+        struct limit_release r;
+
+        if (lh->held == 0) {
+                return NULL;
+        }
+
+        memset(&r, 0, sizeof(r));
+        r.all = SAHPI_TRUE;
+        r.now = now;
+        r.hid = e->hid;
+        r.resource = SAHPI_TRUE;
+        r.rid = e->event.Source;
+        if (limit_resource_gone(e)) {
+                g_hash_table_foreach_remove(limit_entries,
+                                            limit_match_resource, &r);
+                return NULL;
+        }
+        g_hash_table_foreach_remove(limit_entries, limit_release_entry, &r);
+
+        return g_slist_sort(r.events, limit_event_cmp);
+}
+
+/**
+ * oh_event_limit_filter
+ * @e: event taken from the processing queue
+ * @released: where held events to be processed before the returned event
+ * are returned, oldest first
+ *
+ * Returns the event to be processed, or NULL if the event was taken over
+ * (held for coalescing or dropped).
+ **/
+struct oh_event *oh_event_limit_filter(struct oh_event *e, GSList **released)
+{
+        struct limit_handler *lh;
+        struct limit_entry *le = NULL;
+        struct limit_key key;
+        SaHpiSensorEventT *se;
+        SaHpiBoolT paid = SAHPI_FALSE;
+        gint64 now, window = 0;
+
+        *released = NULL;
+        if (!e || e->hid == 0 || !limit_lock ||
+            g_atomic_int_get(&limit_count) == 0) {
+                return e;
+        }
+
+        g_mutex_lock(limit_lock);
+        lh = g_hash_table_lookup(limit_handlers, &e->hid);
+        if (!lh) {
+                g_mutex_unlock(limit_lock);
+                return e;
+        }
+
+        if (lh->prepaid > 0) {
+                lh->prepaid--;
+                paid = SAHPI_TRUE;
+        }
+
+        now = limit_now();
+        if (e->event.EventType == SAHPI_ET_SENSOR) {
+                window = limit_window(lh, e->event.Source);
+        }
+
+        if (window > 0) {
+                se = &e->event.EventDataUnion.SensorEvent;
+                memset(&key, 0, sizeof(key));
+                key.hid = e->hid;
+                key.rid = e->event.Source;
+                key.num = se->SensorNum;
+                key.state = se->EventState;
+                le = g_hash_table_lookup(limit_entries, &key);
+                if (le && le->held) {
+                        /* The new event supersedes the held one */
+                        oh_event_free(le->held, FALSE);
+                        le->held = NULL;
+                        lh->held--;
+                        limit_held--;
+                        lh->coalesced++;
+                }
+                if (le && now < le->window_end) {
+                        le->held = e;
+                        lh->held++;
+                        if (limit_held++ == 0 ||
+                            le->window_end < limit_deadline) {
+                                limit_deadline = le->window_end;
+                        }
+                        g_mutex_unlock(limit_lock);
+                        return NULL;
+                }
+        }
+
+        if (!paid && lh->rate != 0 && !limit_take(lh, e, now)) {
+                lh->rate_limited++;
+                g_mutex_unlock(limit_lock);
+                oh_event_free(e, FALSE);
+                return NULL;
+        }
+
+        if (window > 0) {
+                if (!le) {
+                        if (now - limit_pruned >= LIMIT_PRUNE_INTERVAL) {
+                                g_hash_table_foreach_remove(limit_entries,
+                                                            limit_prune_entry,
+                                                            &now);
+                                limit_pruned = now;
+                        }
+                        le = g_new0(struct limit_entry, 1);
+                        le->key = key;
+                        le->lh = lh;
+                        g_hash_table_insert(limit_entries, &le->key, le);
+                }
+                le->window = window;
+                le->window_end = now + window;
+                le->assertion = e->event.EventDataUnion.SensorEvent.Assertion;
+        }
+        *released = limit_flush_resource(lh, e, now);
+        g_mutex_unlock(limit_lock);
+
+        return e;
+}
+
+static gboolean limit_release_entry(gpointer key, gpointer value,
+                                    gpointer data)
+{
+        struct limit_entry *le = value;
+        struct limit_release *r = data;
+        struct oh_event *held = le->held;
+
+        if (r->resource &&
+            (le->key.hid != r->hid || le->key.rid != r->rid)) {
+                return FALSE;
+        }
+
+        if (held && (r->all || r->now >= le->window_end)) {
+                le->held = NULL;
+                le->lh->held--;
+                limit_held--;
+                if (held->event.EventDataUnion.SensorEvent.Assertion !=
+                    le->assertion) {
+                        /* Passed on, and starts a new window */
+                        le->assertion = held->event.EventDataUnion.SensorEvent.Assertion;
+                        le->window_end = r->now + le->window;
+                        r->events = g_slist_prepend(r->events, held);
+                } else {
+                        /* Held assert/deassert pairs cancel out */
+                        le->lh->coalesced++;
+                        oh_event_free(held, FALSE);
+                }
+        }
+
+        if (le->held) {
+                if (r->deadline == 0 || le->window_end < r->deadline) {
+                        r->deadline = le->window_end;
+                }
+                return FALSE;
+        }
+
+        /* Forget keys that have been quiet for a whole window */
+        return (r->now >= le->window_end) ? TRUE : FALSE;
+}
+
+/**
+ * oh_event_limit_release
+ * @all: release held events even if their window is not over
+ * @events: where the events to be processed are returned, oldest first
+ *
+ * Returns the time in usec until the next held event is due, or -1 if
+ * no event is held.
+ **/
+gint64 oh_event_limit_release(SaHpiBoolT all, GSList **events)
+{
+        struct limit_release r;
+        gint64 wait = -1;
+
+        *events = NULL;
+        if (!limit_lock) {
+                return -1;
+        }
+
+        g_mutex_lock(limit_lock);
+        if (limit_held == 0) {
+                g_mutex_unlock(limit_lock);
+                return -1;
+        }
+
+        memset(&r, 0, sizeof(r));
+        r.all = all;
+        r.now = limit_now();
+        if (!all && r.now < limit_deadline) {
+                wait = limit_deadline - r.now;
+                g_mutex_unlock(limit_lock);
+                return wait;
+        }
+
+        g_hash_table_foreach_remove(limit_entries, limit_release_entry, &r);
+        if (limit_held != 0) {
+                limit_deadline = r.deadline;
+                wait = (r.deadline > r.now) ? r.deadline - r.now : 0;
+        }
+        g_mutex_unlock(limit_lock);
+
+        *events = g_slist_sort(r.events, limit_event_cmp);
+
+        return wait;
+}
+
+SaErrorT oh_event_limit_get_stats(unsigned int hid,
+                                  oHpiEventLimitStatsT *stats)
+{
+        struct limit_handler *lh;
+
+        if (!stats) {
+                return SA_ERR_HPI_INVALID_PARAMS;
+        }
+
+        memset(stats, 0, sizeof(*stats));
+        if (!limit_lock) {
+                return SA_OK;
+        }
+
+        g_mutex_lock(limit_lock);
+        lh = g_hash_table_lookup(limit_handlers, &hid);
+        if (lh) {
+                stats->CoalesceWindowMsec = (SaHpiUint32T)(lh->window / 1000);
+                stats->CoalesceSources = lh->windows ?
+                        g_hash_table_size(lh->windows) : 0;
+                stats->Rate = lh->rate;
+                stats->Burst = lh->burst;
+                stats->Held = lh->held;
+                stats->Coalesced = lh->coalesced;
+                stats->RateLimited = lh->rate_limited;
+                stats->HarvestDeferred = lh->deferred;
+        }
+        g_mutex_unlock(limit_lock);
+
+        return SA_OK;
+}
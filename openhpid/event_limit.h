@@ -0,0 +1,52 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __OH_EVENT_LIMIT_H
+#define __OH_EVENT_LIMIT_H
+
+#include <glib.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+#include <oh_utils.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Handler configuration keys, all values in quotes */
+#define OH_EVENT_COALESCE_WINDOW_KEY  "event_coalesce_window"  /* msec */
+#define OH_EVENT_COALESCE_SOURCES_KEY "event_coalesce_sources" /* rid:msec,... */
+#define OH_EVENT_RATE_KEY             "event_rate"             /* events/sec */
+#define OH_EVENT_BURST_KEY            "event_burst"            /* events */
+
+void oh_event_limit_init(void);
+void oh_event_limit_finit(void);
+
+void oh_event_limit_handler_add(unsigned int hid, GHashTable *config);
+void oh_event_limit_handler_remove(unsigned int hid);
+
+SaHpiBoolT oh_event_limit_harvest_allowed(unsigned int hid);
+void oh_event_limit_harvested(unsigned int hid, int nevents);
+
+struct oh_event *oh_event_limit_filter(struct oh_event *e,
+                                       GSList **released);
+gint64 oh_event_limit_release(SaHpiBoolT all, GSList **events);
+
+SaErrorT oh_event_limit_get_stats(unsigned int hid,
+                                  oHpiEventLimitStatsT *stats);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __OH_EVENT_LIMIT_H */
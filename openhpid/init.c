@@ -36,8 +36,10 @@
 
 #include "conf.h"
 #include "event.h"
+#include "event_limit.h"
 #include "init.h"
 #include "lock.h"
+#include "sensor_cache.h"
 #include "threaded.h"
 #include "sahpi_wrappers.h"
 
@@ -116,6 +118,10 @@ int oh_init(void)
                 return rval;
         }
 
+        /* Initialize sensor reading cache */
+        oh_sensor_cache_init();
+        /* Initialize event coalescing and rate limits */
+        oh_event_limit_init();
         /* Initialize handler table */
         oh_handlers.table = g_hash_table_new(g_int_hash, g_int_equal);
         /* Initialize domain table */
@@ -217,6 +223,8 @@ int oh_finit(void)
 #endif
 
         oh_event_finit();
+        oh_sensor_cache_finit();
+        oh_event_limit_finit();
 
 	INFO("OpenHPI has been finalized.");
 
@@ -31,9 +31,12 @@
 #include <sahpimacros.h>
 
 #include "conf.h"
+#include "del_writer.h"
 #include "event.h"
+#include "event_limit.h"
 #include "init.h"
 #include "lock.h"
+#include "sensor_cache.h"
 
 
 /**
@@ -404,6 +407,7 @@ SaErrorT SAHPI_API oHpiInjectEvent (
 
 	struct oh_handler *h = NULL;
 	SaErrorT error = SA_OK;
+	gint64 start;
 
         if (sid == 0){
 		return SA_ERR_HPI_INVALID_SESSION;
@@ -438,13 +442,248 @@ SaErrorT SAHPI_API oHpiInjectEvent (
                 return SA_ERR_HPI_INVALID_CMD;
         }
 
+	start = oh_abi_stats_start();
 	error = inject_event(h->hnd, event, rpte, rdr);
+	oh_abi_stats_record(h, OH_ABI_FUNC_INDEX(inject_event), error, start);
 
         oh_release_handler(h);
         oh_release_domain(d); /* Unlock domain */
         return error;
 }
 
+/**
+ * oHpiSensorCacheStatsGet
+ **/
+SaErrorT SAHPI_API oHpiSensorCacheStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    oHpiHandlerIdT id,
+     SAHPI_OUT   oHpiSensorCacheStatsT *stats )
+{
+        SaHpiDomainIdT did;
+        struct oh_domain *d = NULL;
+        struct oh_handler *h = NULL;
+        SaErrorT error;
+
+        if (sid == 0)
+                return SA_ERR_HPI_INVALID_SESSION;
+        if (id == 0 || !stats)
+                return SA_ERR_HPI_INVALID_PARAMS;
+
+        OH_CHECK_INIT_STATE(sid);
+        OH_GET_DID(sid, did);
+        OH_GET_DOMAIN(did, d); /* Lock domain */
+
+        if (oh_init()) {
+                oh_release_domain(d); /* Unlock domain */
+                return SA_ERR_HPI_INTERNAL_ERROR;
+        }
+
+        h = oh_get_handler(id);
+        if (!h) {
+                oh_release_domain(d); /* Unlock domain */
+                return SA_ERR_HPI_NOT_PRESENT;
+        }
+        oh_release_handler(h);
+
+        error = oh_sensor_cache_get_stats(id, stats);
+
+        oh_release_domain(d); /* Unlock domain */
+        return error;
+}
+
+/**
+ * oHpiHandlerStatsGet
+ **/
+SaErrorT SAHPI_API oHpiHandlerStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    oHpiHandlerIdT id,
+     SAHPI_IN    SaHpiEntryIdT EntryId,
+     SAHPI_OUT   SaHpiEntryIdT *NextEntryId,
+     SAHPI_OUT   oHpiHandlerStatsT *stats )
+{
+        SaHpiDomainIdT did;
+        struct oh_domain *d = NULL;
+        SaErrorT error;
+
+        if (sid == 0)
+                return SA_ERR_HPI_INVALID_SESSION;
+        if (id == 0 || !NextEntryId || !stats ||
+            EntryId == SAHPI_LAST_ENTRY)
+                return SA_ERR_HPI_INVALID_PARAMS;
+
+        OH_CHECK_INIT_STATE(sid);
+        OH_GET_DID(sid, did);
+        OH_GET_DOMAIN(did, d); /* Lock domain */
+
+        if (oh_init()) {
+                oh_release_domain(d); /* Unlock domain */
+                return SA_ERR_HPI_INTERNAL_ERROR;
+        }
+
+        error = oh_get_handler_stats(id, EntryId, NextEntryId, stats);
+
+        oh_release_domain(d); /* Unlock domain */
+        return error;
+}
+
+/**
+ * oHpiDelWriterStatsGet
+ **/
+SaErrorT SAHPI_API oHpiDelWriterStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_OUT   oHpiDelWriterStatsT *stats )
+{
+        if (sid == 0)
+                return SA_ERR_HPI_INVALID_SESSION;
+        if (!stats)
+                return SA_ERR_HPI_INVALID_PARAMS;
+
+        OH_CHECK_INIT_STATE(sid);
+
+        if (oh_init()) {
+                return SA_ERR_HPI_INTERNAL_ERROR;
+        }
+
+        oh_del_writer_get_stats(stats);
+
+        return SA_OK;
+}
+
+/**
+ * oHpiEventLimitStatsGet
+ **/
+SaErrorT SAHPI_API oHpiEventLimitStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    oHpiHandlerIdT id,
+     SAHPI_OUT   oHpiEventLimitStatsT *stats )
+{
+        SaHpiDomainIdT did;
+        struct oh_domain *d = NULL;
+        struct oh_handler *h = NULL;
+        SaErrorT error;
+
+        if (sid == 0)
+                return SA_ERR_HPI_INVALID_SESSION;
+        if (id == 0 || !stats)
+                return SA_ERR_HPI_INVALID_PARAMS;
+
+        OH_CHECK_INIT_STATE(sid);
+        OH_GET_DID(sid, did);
+        OH_GET_DOMAIN(did, d); /* Lock domain */
+
+        if (oh_init()) {
+                oh_release_domain(d); /* Unlock domain */
+                return SA_ERR_HPI_INTERNAL_ERROR;
+        }
+
+        h = oh_get_handler(id);
+        if (!h) {
+                oh_release_domain(d); /* Unlock domain */
+                return SA_ERR_HPI_NOT_PRESENT;
+        }
+        oh_release_handler(h);
+
+        error = oh_event_limit_get_stats(id, stats);
+
+        oh_release_domain(d); /* Unlock domain */
+        return error;
+}
+
+/**
+ * oHpiEventQueueStatsGet
+ **/
+SaErrorT SAHPI_API oHpiEventQueueStatsGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    oHpiEventPriorityT priority,
+     SAHPI_OUT   oHpiEventQueueStatsT *stats )
+{
+        if (sid == 0)
+                return SA_ERR_HPI_INVALID_SESSION;
+        if (priority >= OHPI_EVENT_PRIORITY_LEVELS || !stats)
+                return SA_ERR_HPI_INVALID_PARAMS;
+
+        OH_CHECK_INIT_STATE(sid);
+
+        if (oh_init()) {
+                return SA_ERR_HPI_INTERNAL_ERROR;
+        }
+
+        return oh_event_queue_get_stats(priority, stats);
+}
+
+/* Marshalled records are never larger than the structs, so entries are
+ * counted against this many bytes to keep a reply within one message. */
+#define OH_EL_ENTRIES_REPLY_BYTES 60000
+
+/**
+ * oHpiEventLogEntriesGet
+ **/
+SaErrorT SAHPI_API oHpiEventLogEntriesGet (
+     SAHPI_IN    SaHpiSessionIdT sid,
+     SAHPI_IN    SaHpiResourceIdT rid,
+     SAHPI_IN    SaHpiEventLogEntryIdT entry_id,
+     SAHPI_IN    SaHpiUint32T max_entries,
+     SAHPI_IN    SaHpiBoolT with_rdr,
+     SAHPI_IN    SaHpiBoolT with_rpt_entry,
+     SAHPI_OUT   SaHpiEventLogEntryIdT *next_entry_id,
+     SAHPI_OUT   oHpiEventLogEntriesT *entries )
+{
+        SaHpiEventLogEntryIdT id, prev, next;
+        SaHpiRdrT *rdr;
+        SaHpiRptEntryT *rpte;
+        SaErrorT error = SA_OK;
+        gsize record = sizeof(SaHpiEventLogEntryT);
+        SaHpiUint32T n;
+
+        if (sid == 0)
+                return SA_ERR_HPI_INVALID_SESSION;
+        if (entry_id == SAHPI_NO_MORE_ENTRIES || max_entries == 0 ||
+            !next_entry_id || !entries)
+                return SA_ERR_HPI_INVALID_PARAMS;
+
+        OH_CHECK_INIT_STATE(sid);
+
+        if (with_rdr) record += sizeof(SaHpiRdrT);
+        if (with_rpt_entry) record += sizeof(SaHpiRptEntryT);
+        if (max_entries > OH_EL_ENTRIES_REPLY_BYTES / record)
+                max_entries = OH_EL_ENTRIES_REPLY_BYTES / record;
+
+        memset(entries, 0, sizeof(*entries));
+        entries->Entries = g_new0(SaHpiEventLogEntryT, max_entries);
+        if (with_rdr)
+                entries->Rdrs = g_new0(SaHpiRdrT, max_entries);
+        if (with_rpt_entry)
+                entries->RptEntries = g_new0(SaHpiRptEntryT, max_entries);
+
+        id = entry_id;
+        for (n = 0; n < max_entries && id != SAHPI_NO_MORE_ENTRIES; n++) {
+                rdr = with_rdr ? &entries->Rdrs[n] : NULL;
+                rpte = with_rpt_entry ? &entries->RptEntries[n] : NULL;
+                if (rdr) rdr->RdrType = SAHPI_NO_RECORD;
+                error = saHpiEventLogEntryGet(sid, rid, id, &prev, &next,
+                                              &entries->Entries[n],
+                                              rdr, rpte);
+                if (error != SA_OK)
+                        break;
+                id = next;
+        }
+
+        if (n == 0) {
+                g_free(entries->Entries);
+                g_free(entries->Rdrs);
+                g_free(entries->RptEntries);
+                memset(entries, 0, sizeof(*entries));
+                return error;
+        }
+
+        entries->NumberOfEntries = n;
+        if (with_rdr) entries->NumberOfRdrs = n;
+        if (with_rpt_entry) entries->NumberOfRptEntries = n;
+        *next_entry_id = id;
+
+        return SA_OK;
+}
+
 /**
  * oHpiDomainAdd
  * Currently only available in client library, but not in daemon
@@ -54,6 +54,8 @@ static gboolean verbose_flag    = FALSE;
 static gchar    *bindaddr       = NULL;
 static gint     port            = OPENHPI_DEFAULT_DAEMON_PORT;
 static gchar    *portstr        = NULL;
+static gchar    *unixpath       = NULL;
+static gchar    *unixgroup      = NULL;
 static gchar    *optpidfile     = NULL;
 static gint     sock_timeout    = 0;  // unlimited -- TODO: unlimited or 30 minutes default? was unsigned int
 static gint     max_threads     = -1; // unlimited
@@ -82,6 +84,11 @@ static GOptionEntry daemon_options[] =
   { "port",      'p', 0, G_OPTION_ARG_STRING,   &portstr,       "Overrides the default listening port (4743) of\n"
                                     "                            the daemon. The option is optional.",              "port" },
 
+  { "unix",      'u', 0, G_OPTION_ARG_FILENAME, &unixpath,      "Also listens on this Unix domain socket for local\n"
+                                    "                            clients. The option is optional.",                 "socket_path" },
+  { "unix-group", 'g', 0, G_OPTION_ARG_STRING,  &unixgroup,     "Also lets this group use the Unix domain socket.\n"
+                                    "                            Only the daemon user and root may use it by\n"
+                                    "                            default. The option is optional.",                 "group" },
   { "pidfile",   'f', 0, G_OPTION_ARG_FILENAME, &optpidfile,    "Overrides the default path/name for the daemon.\n"
                                     "                            pid file. The option is optional.",                "pidfile" },
   { "timeout",   's', 0, G_OPTION_ARG_INT,      &sock_timeout,  "Overrides the default socket read timeout of 30\n"
@@ -132,6 +139,15 @@ void display_help(void)
     printf("                            No bind address is used by default.\n");
     printf("  -p, --port=port           Overrides the default listening port (4743) of\n");
     printf("                            the daemon. The option is optional.\n");
+    printf("  -u, --unix=socket_path    Also listens on this Unix domain socket for local\n");
+    printf("                            clients. Also the path can be specified with\n");
+    printf("                            OPENHPI_DAEMON_UNIX_SOCKET environment variable.\n");
+    printf("                            The option is optional.\n");
+    printf("  -g, --unix-group=group    Also lets this group use the Unix domain socket.\n");
+    printf("                            Only the daemon user and root may use it by\n");
+    printf("                            default. Also the group can be specified with\n");
+    printf("                            OPENHPI_DAEMON_UNIX_GROUP environment variable.\n");
+    printf("                            The option is optional.\n");
     printf("  -f, --pidfile=pidfile     Overrides the default path/name for the daemon.\n");
     printf("                            pid file. The option is optional.\n");
     printf("  -s, --timeout=seconds     Overrides the default socket read timeout of 30\n");
@@ -362,6 +378,16 @@ int main(int argc, char *argv[])
     if (portstr) {
         port = atoi(portstr);
     }
+    if (unixpath) {
+        setenv("OPENHPI_DAEMON_UNIX_SOCKET", unixpath, 1);
+    } else {
+        unixpath = getenv("OPENHPI_DAEMON_UNIX_SOCKET");
+    }
+    if (unixgroup) {
+        setenv("OPENHPI_DAEMON_UNIX_GROUP", unixgroup, 1);
+    } else {
+        unixgroup = getenv("OPENHPI_DAEMON_UNIX_GROUP");
+    }
 
 #ifdef HAVE_ENCRYPT
     if (g_decrypt) {
@@ -425,6 +451,12 @@ int main(int argc, char *argv[])
         INFO("OPENHPI_DAEMON_BIND_ADDRESS = %s.", bindaddr);
     }
     INFO("OPENHPI_DAEMON_PORT = %u.", port);
+    if (unixpath) {
+        INFO("OPENHPI_DAEMON_UNIX_SOCKET = %s.", unixpath);
+    }
+    if (unixgroup) {
+        INFO("OPENHPI_DAEMON_UNIX_GROUP = %s.", unixgroup);
+    }
     INFO("Enabled IP versions:%s%s.",
          (ipvflags & FlagIPv4) ? " IPv4" : "",
          (ipvflags & FlagIPv6) ? " IPv6" : "");
@@ -436,7 +468,7 @@ int main(int argc, char *argv[])
         return 8;
     }
 
-    bool rc = oh_server_run(ipvflags, bindaddr, port, sock_timeout, max_threads);
+    bool rc = oh_server_run(ipvflags, bindaddr, port, unixpath, unixgroup, sock_timeout, max_threads);
     if (!rc) {
         return 9;
     }
@@ -34,7 +34,9 @@
 
 #include "conf.h"
 #include "event.h"
+#include "event_limit.h"
 #include "lock.h"
+#include "sensor_cache.h"
 #include "sahpi_wrappers.h"
 
 extern volatile int signal_stop;
@@ -354,6 +356,159 @@ int oh_unload_plugin(char *plugin_name)
         return 0;
 }
 
+/*
+ * Names of the plugin ABI functions, used to report handler call
+ * statistics. Order follows struct oh_abi_v2.
+ */
+#define OH_ABI_NAME(func) { offsetof(struct oh_abi_v2, func), #func }
+static const struct {
+        size_t offset;
+        const char *name;
+} oh_abi_names[] = {
+        OH_ABI_NAME(open),
+        OH_ABI_NAME(close),
+        OH_ABI_NAME(get_event),
+        OH_ABI_NAME(discover_resources),
+        OH_ABI_NAME(set_resource_tag),
+        OH_ABI_NAME(set_resource_severity),
+        OH_ABI_NAME(resource_failed_remove),
+        OH_ABI_NAME(get_el_info),
+        OH_ABI_NAME(get_el_caps),
+        OH_ABI_NAME(set_el_time),
+        OH_ABI_NAME(add_el_entry),
+        OH_ABI_NAME(get_el_entry),
+        OH_ABI_NAME(clear_el),
+        OH_ABI_NAME(set_el_state),
+        OH_ABI_NAME(reset_el_overflow),
+        OH_ABI_NAME(get_sensor_reading),
+        OH_ABI_NAME(get_sensor_thresholds),
+        OH_ABI_NAME(set_sensor_thresholds),
+        OH_ABI_NAME(get_sensor_enable),
+        OH_ABI_NAME(set_sensor_enable),
+        OH_ABI_NAME(get_sensor_event_enables),
+        OH_ABI_NAME(set_sensor_event_enables),
+        OH_ABI_NAME(get_sensor_event_masks),
+        OH_ABI_NAME(set_sensor_event_masks),
+        OH_ABI_NAME(get_control_state),
+        OH_ABI_NAME(set_control_state),
+        OH_ABI_NAME(get_idr_info),
+        OH_ABI_NAME(get_idr_area_header),
+        OH_ABI_NAME(add_idr_area),
+        OH_ABI_NAME(add_idr_area_id),
+        OH_ABI_NAME(del_idr_area),
+        OH_ABI_NAME(get_idr_field),
+        OH_ABI_NAME(add_idr_field),
+        OH_ABI_NAME(add_idr_field_id),
+        OH_ABI_NAME(set_idr_field),
+        OH_ABI_NAME(del_idr_field),
+        OH_ABI_NAME(get_watchdog_info),
+        OH_ABI_NAME(set_watchdog_info),
+        OH_ABI_NAME(reset_watchdog),
+        OH_ABI_NAME(get_next_announce),
+        OH_ABI_NAME(get_announce),
+        OH_ABI_NAME(ack_announce),
+        OH_ABI_NAME(add_announce),
+        OH_ABI_NAME(del_announce),
+        OH_ABI_NAME(get_annunc_mode),
+        OH_ABI_NAME(set_annunc_mode),
+        OH_ABI_NAME(get_dimi_info),
+        OH_ABI_NAME(get_dimi_test),
+        OH_ABI_NAME(get_dimi_test_ready),
+        OH_ABI_NAME(start_dimi_test),
+        OH_ABI_NAME(cancel_dimi_test),
+        OH_ABI_NAME(get_dimi_test_status),
+        OH_ABI_NAME(get_dimi_test_results),
+        OH_ABI_NAME(get_fumi_spec),
+        OH_ABI_NAME(get_fumi_service_impact),
+        OH_ABI_NAME(set_fumi_source),
+        OH_ABI_NAME(validate_fumi_source),
+        OH_ABI_NAME(get_fumi_source),
+        OH_ABI_NAME(get_fumi_source_component),
+        OH_ABI_NAME(get_fumi_target),
+        OH_ABI_NAME(get_fumi_target_component),
+        OH_ABI_NAME(get_fumi_logical_target),
+        OH_ABI_NAME(get_fumi_logical_target_component),
+        OH_ABI_NAME(start_fumi_backup),
+        OH_ABI_NAME(set_fumi_bank_order),
+        OH_ABI_NAME(start_fumi_bank_copy),
+        OH_ABI_NAME(start_fumi_install),
+        OH_ABI_NAME(get_fumi_status),
+        OH_ABI_NAME(start_fumi_verify),
+        OH_ABI_NAME(start_fumi_verify_main),
+        OH_ABI_NAME(cancel_fumi_upgrade),
+        OH_ABI_NAME(get_fumi_autorollback_disable),
+        OH_ABI_NAME(set_fumi_autorollback_disable),
+        OH_ABI_NAME(start_fumi_rollback),
+        OH_ABI_NAME(activate_fumi),
+        OH_ABI_NAME(start_fumi_activate),
+        OH_ABI_NAME(cleanup_fumi),
+        OH_ABI_NAME(hotswap_policy_cancel),
+        OH_ABI_NAME(set_autoinsert_timeout),
+        OH_ABI_NAME(get_autoextract_timeout),
+        OH_ABI_NAME(set_autoextract_timeout),
+        OH_ABI_NAME(get_hotswap_state),
+        OH_ABI_NAME(set_hotswap_state),
+        OH_ABI_NAME(request_hotswap_action),
+        OH_ABI_NAME(get_indicator_state),
+        OH_ABI_NAME(set_indicator_state),
+        OH_ABI_NAME(get_power_state),
+        OH_ABI_NAME(set_power_state),
+        OH_ABI_NAME(control_parm),
+        OH_ABI_NAME(load_id_get),
+        OH_ABI_NAME(load_id_set),
+        OH_ABI_NAME(get_reset_state),
+        OH_ABI_NAME(set_reset_state),
+        OH_ABI_NAME(inject_event),
+};
+
+gint64 oh_abi_stats_start(void)
+{
+#if GLIB_CHECK_VERSION (2, 28, 0)
+        return g_get_monotonic_time();
+#else
+        GTimeVal now;
+        g_get_current_time(&now);
+        return ((gint64)now.tv_sec * G_USEC_PER_SEC) + now.tv_usec;
+#endif
+}
+
+/**
+ * oh_abi_stats_record
+ * @h: handler the plugin function was called on
+ * @func_index: OH_ABI_FUNC_INDEX() of the called function
+ * @rv: value returned by the plugin
+ * @start: oh_abi_stats_start() value taken before the call
+ *
+ * Accounts one plugin call in the handler statistics.
+ **/
+void oh_abi_stats_record(struct oh_handler *h,
+                         unsigned int func_index,
+                         SaErrorT rv,
+                         gint64 start)
+{
+        struct oh_abi_call_stats *s;
+        gint64 usec;
+        unsigned int bucket = 0;
+
+        if (!h || !h->stats || func_index >= OH_ABI_FUNC_COUNT) return;
+
+        usec = oh_abi_stats_start() - start;
+        if (usec < 0) usec = 0;
+        while ((bucket < OHPI_HANDLER_STATS_BUCKETS - 1) &&
+               ((usec >> bucket) != 0)) {
+                bucket++;
+        }
+
+        s = &h->stats[func_index];
+        wrap_g_static_mutex_lock(&h->stats_lock);
+        s->calls++;
+        if (rv != SA_OK) s->errors++;
+        s->total_usec += usec;
+        if ((SaHpiUint64T)usec > s->max_usec) s->max_usec = usec;
+        s->hist[bucket]++;
+        wrap_g_static_mutex_unlock(&h->stats_lock);
+}
+
 static void __inc_handler_refcount(struct oh_handler *h)
 {
         wrap_g_static_rec_mutex_lock(&h->refcount_lock);
@@ -388,6 +543,8 @@ static void __delete_handler(struct oh_handler *h)
 
         wrap_g_static_rec_mutex_free_clear(&h->lock);
         wrap_g_static_rec_mutex_free_clear(&h->refcount_lock);
+        wrap_g_static_mutex_free_clear(&h->stats_lock);
+        g_free(h->stats);
         g_free(h);
 }
 
@@ -543,6 +700,8 @@ static struct oh_handler *new_handler(GHashTable *handler_config)
         handler->refcount = 0;
         wrap_g_static_rec_mutex_init(&handler->lock);
         wrap_g_static_rec_mutex_init(&handler->refcount_lock);
+        wrap_g_static_mutex_init(&handler->stats_lock);
+        handler->stats = g_new0(struct oh_abi_call_stats, OH_ABI_FUNC_COUNT);
 
         return handler;
 cleanexit:
@@ -575,6 +734,8 @@ SaErrorT oh_create_handler (GHashTable *handler_config, unsigned int *hid)
         if (!handler) return SA_ERR_HPI_ERROR;
 
         *hid = handler->id;
+        oh_sensor_cache_handler_add(handler->id, handler->config);
+        oh_event_limit_handler_add(handler->id, handler->config);
         wrap_g_static_rec_mutex_lock(&oh_handlers.lock);
         oh_handlers.list = g_slist_append(oh_handlers.list, handler);
         g_hash_table_insert(oh_handlers.table,
@@ -646,6 +807,9 @@ int oh_destroy_handler(unsigned int hid)
         oh_handlers.list = g_slist_remove(oh_handlers.list, &(handler->id));
         wrap_g_static_rec_mutex_unlock(&oh_handlers.lock);
 
+        oh_sensor_cache_handler_remove(hid);
+        oh_event_limit_handler_remove(hid);
+
         __dec_handler_refcount(handler);
         if (handler->refcount < 1)
                 __delete_handler(handler);
@@ -708,6 +872,82 @@ SaErrorT oh_get_handler_info(unsigned int hid, oHpiHandlerInfoT *info, GHashTabl
         return SA_OK;
 }
 
+/**
+ * oh_get_handler_stats
+ * @hid: id of the handler
+ * @entry_id: 1-based position of the ABI function in oh_abi_names,
+ * or SAHPI_FIRST_ENTRY for the first function called at least once.
+ * @next_entry_id: next function called at least once or SAHPI_LAST_ENTRY
+ * @stats: where the statistics are copied
+ *
+ * The handler lock is not taken, so statistics can be read while the
+ * handler is busy in a plugin call.
+ *
+ * Returns: SA_OK on success.
+ **/
+SaErrorT oh_get_handler_stats(unsigned int hid,
+                              SaHpiEntryIdT entry_id,
+                              SaHpiEntryIdT *next_entry_id,
+                              oHpiHandlerStatsT *stats)
+{
+        struct oh_handler *h = NULL;
+        struct oh_abi_call_stats *s;
+        GSList *node = NULL;
+        unsigned int i, n = G_N_ELEMENTS(oh_abi_names);
+
+        if ((hid == 0) || !next_entry_id || !stats ||
+            (entry_id == SAHPI_LAST_ENTRY)) {
+                return SA_ERR_HPI_INVALID_PARAMS;
+        }
+
+        /* Holding the table lock keeps the handler from being deleted */
+        wrap_g_static_rec_mutex_lock(&oh_handlers.lock);
+        node = g_hash_table_lookup(oh_handlers.table, &hid);
+        h = node ? (struct oh_handler *)(node->data) : NULL;
+        if (!h || !h->stats) {
+                wrap_g_static_rec_mutex_unlock(&oh_handlers.lock);
+                return SA_ERR_HPI_NOT_PRESENT;
+        }
+
+        wrap_g_static_mutex_lock(&h->stats_lock);
+        if (entry_id == SAHPI_FIRST_ENTRY) {
+                for (i = 0; i < n; i++) {
+                        s = &h->stats[oh_abi_names[i].offset / sizeof(void *)];
+                        if (s->calls) break;
+                }
+        } else {
+                i = entry_id - 1;
+        }
+        if (i >= n) {
+                wrap_g_static_mutex_unlock(&h->stats_lock);
+                wrap_g_static_rec_mutex_unlock(&oh_handlers.lock);
+                return SA_ERR_HPI_NOT_PRESENT;
+        }
+
+        s = &h->stats[oh_abi_names[i].offset / sizeof(void *)];
+        memset(stats, 0, sizeof(*stats));
+        oh_init_textbuffer(&stats->Function);
+        oh_append_textbuffer(&stats->Function, oh_abi_names[i].name);
+        stats->Calls = s->calls;
+        stats->Errors = s->errors;
+        stats->TotalUsec = s->total_usec;
+        stats->MaxUsec = s->max_usec;
+        memcpy(stats->Histogram, s->hist, sizeof(stats->Histogram));
+
+        *next_entry_id = SAHPI_LAST_ENTRY;
+        for (i = i + 1; i < n; i++) {
+                s = &h->stats[oh_abi_names[i].offset / sizeof(void *)];
+                if (s->calls) {
+                        *next_entry_id = i + 1;
+                        break;
+                }
+        }
+        wrap_g_static_mutex_unlock(&h->stats_lock);
+        wrap_g_static_rec_mutex_unlock(&oh_handlers.lock);
+
+        return SA_OK;
+}
+
 /**
  * oh_discover_resources
  *
@@ -737,7 +977,11 @@ SaErrorT oh_discovery(void)
                 }
 
 		if (h->abi->discover_resources && h->hnd) {
+                        gint64 start = oh_abi_stats_start();
                         cur_error = h->abi->discover_resources(h->hnd);
+                        oh_abi_stats_record(h,
+                                OH_ABI_FUNC_INDEX(discover_resources),
+                                cur_error, start);
                         if (cur_error == SA_OK && error) {
                                 error = cur_error;
                         }
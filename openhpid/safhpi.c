@@ -37,9 +37,11 @@
 
 #include "alarm.h"
 #include "conf.h"
+#include "del_writer.h"
 #include "event.h"
 #include "hotswap.h"
 #include "init.h"
+#include "sensor_cache.h"
 #include "threaded.h"
 
 
@@ -810,7 +812,6 @@ SaErrorT SAHPI_API saHpiEventLogEntryAdd (
         struct oh_handler *h;
         struct oh_domain *d;
         SaHpiDomainIdT did;
-        char del_filepath[SAHPI_MAX_TEXT_BUFFER_LENGTH*2];
 
         OH_CHECK_INIT_STATE(SessionId);
 
@@ -864,12 +865,7 @@ SaErrorT SAHPI_API saHpiEventLogEntryAdd (
                 oh_get_global_param(&param);
                 rv = oh_el_append(d->del, EvtEntry, NULL, NULL);
                 if (param.u.del_save) {
-                        param.type = OPENHPI_VARPATH;
-                        oh_get_global_param(&param);
-                        snprintf(del_filepath,
-                                 SAHPI_MAX_TEXT_BUFFER_LENGTH*2,
-                                 "%s/del.%u", param.u.varpath, did);
-                        oh_el_map_to_file(d->del, del_filepath);
+                        oh_del_writer_queue(did);
                 }
                 oh_release_domain(d); /* Unlock domain */
                 return rv;
@@ -1462,6 +1458,7 @@ SaErrorT SAHPI_API saHpiAlarmAcknowledge(
                                  0, 0);
                 if (a) {
                         a->Acknowledged = SAHPI_TRUE;
+                        oh_journal_alarm(d, OH_DAT_JOURNAL_ACK, a);
                         error = SA_OK;
                 }
         } else { /* Acknowledge group of alarms, by severity */
@@ -1471,6 +1468,7 @@ SaErrorT SAHPI_API saHpiAlarmAcknowledge(
                                  0, 1);
                 while (a) {
                         a->Acknowledged = SAHPI_TRUE;
+                        oh_journal_alarm(d, OH_DAT_JOURNAL_ACK, a);
                         a = oh_get_alarm(d, &a->AlarmId, &Severity, NULL,
                                          NULL, NULL, NULL, NULL,
                                          0, 1);
@@ -1542,6 +1540,7 @@ SaErrorT SAHPI_API saHpiAlarmDelete(
                         if (a->AlarmCond.Type != SAHPI_STATUS_COND_TYPE_USER) {
                                 error = SA_ERR_HPI_READ_ONLY;
                         } else {
+                                oh_journal_alarm(d, OH_DAT_JOURNAL_DELETE, a);
                                 d->dat.list = g_slist_remove(d->dat.list, a);
                                 g_free(a);
                                 error = SA_OK;
@@ -1765,6 +1764,11 @@ SaErrorT SAHPI_API saHpiSensorReadingGet (
         SaHpiRdrT *rdr;
         SaHpiDomainIdT did;
         struct oh_domain *d = NULL;
+        unsigned int *hid = NULL;
+        struct oh_sensor_cache_ticket ticket;
+        oh_sensor_cache_status cstatus;
+        SaHpiSensorReadingT reading;
+        SaHpiEventStateT state;
 
         OH_CHECK_INIT_STATE(SessionId);
         OH_GET_DID(SessionId, did);
@@ -1783,25 +1787,68 @@ SaErrorT SAHPI_API saHpiSensorReadingGet (
                 return SA_ERR_HPI_NOT_PRESENT;
         }
 
-        OH_HANDLER_GET(d, ResourceId, h);
+        hid = oh_get_resource_data(&(d->rpt), ResourceId);
+        if (!hid) {
+                oh_release_domain(d); /* Unlock domain */
+                return SA_ERR_HPI_INVALID_RESOURCE;
+        }
+        ticket.hid = *hid;
+        ticket.rid = ResourceId;
+        ticket.num = SensorNum;
         oh_release_domain(d); /* Unlock domain */
 
-        OH_CALL_ABI(h, get_sensor_reading, SA_ERR_HPI_INVALID_CMD, rv,
-                    ResourceId, SensorNum, Reading, EventState);
-
-	/* If the Reading->IsSupported is set to False, then Reading->Type and
-	 * Reading->Value fields are not valid. Hence, these two fields may not
-	 * be modified by the plugin. But the marshalling code expects all
-	 * the fields of return structure to have proper values.
-	 * 
-	 * The below code is added to overcome the marshalling limitation.
-	 */
-	if (rv == SA_OK && Reading && Reading->IsSupported == SAHPI_FALSE) {
-		Reading->Type = 0;
-		memset(&(Reading->Value), 0, sizeof(SaHpiSensorReadingUnionT));
-	}
+        /* The plugin always gets full buffers so the result can be shared */
+        memset(&reading, 0, sizeof(reading));
+        state = 0;
 
-        oh_release_handler(h);
+        /* May wait for another session reading the same sensor */
+        cstatus = oh_sensor_cache_begin(&ticket, &reading, &state, &rv);
+        if (cstatus != OH_SENSOR_CACHE_DONE) {
+                h = oh_get_handler(ticket.hid);
+                if (h && !h->hnd) {
+                        oh_release_handler(h);
+                        h = NULL;
+                }
+                if (!h || !h->abi->get_sensor_reading) {
+                        if (h) oh_release_handler(h);
+                        rv = SA_ERR_HPI_INVALID_CMD;
+                } else {
+                        gint64 start = oh_abi_stats_start();
+                        rv = h->abi->get_sensor_reading(h->hnd,
+                                                        ResourceId,
+                                                        SensorNum,
+                                                        &reading,
+                                                        &state);
+                        oh_abi_stats_record(h,
+                                OH_ABI_FUNC_INDEX(get_sensor_reading),
+                                rv, start);
+                        oh_release_handler(h);
+                }
+
+                /* If the Reading->IsSupported is set to False, then
+                 * Reading->Type and Reading->Value fields are not valid.
+                 * Hence, these two fields may not be modified by the plugin.
+                 * But the marshalling code expects all the fields of
+                 * return structure to have proper values.
+                 *
+                 * The below code is added to overcome the marshalling
+                 * limitation.
+                 */
+                if (rv == SA_OK && reading.IsSupported == SAHPI_FALSE) {
+                        reading.Type = 0;
+                        memset(&(reading.Value), 0,
+                               sizeof(SaHpiSensorReadingUnionT));
+                }
+
+                if (cstatus == OH_SENSOR_CACHE_FETCH) {
+                        oh_sensor_cache_end(&ticket, rv, &reading, &state);
+                }
+        }
+
+        if (rv == SA_OK) {
+                if (Reading) *Reading = reading;
+                if (EventState) *EventState = state;
+        }
 
         return rv;
 }
@@ -1934,6 +1981,10 @@ SaErrorT SAHPI_API saHpiSensorThresholdsSet (
 
         OH_CALL_ABI(h, set_sensor_thresholds, SA_ERR_HPI_INVALID_CMD, rv,
                     ResourceId, SensorNum, SensorThresholds);
+        /* Thresholds and enable state change what a reading returns */
+        if (rv == SA_OK) {
+                oh_sensor_cache_invalidate(h->id, ResourceId, SensorNum);
+        }
         oh_release_handler(h);
 
         return rv;
@@ -2069,6 +2120,10 @@ SaErrorT SAHPI_API saHpiSensorEnableSet (
 
         OH_CALL_ABI(h, set_sensor_enable, SA_ERR_HPI_INVALID_CMD, rv,
                     ResourceId, SensorNum, SensorEnabled);
+        /* Thresholds and enable state change what a reading returns */
+        if (rv == SA_OK) {
+                oh_sensor_cache_invalidate(h->id, ResourceId, SensorNum);
+        }
         oh_release_handler(h);
         if (rv == SA_OK) {
                 oh_detect_sensor_enable_alarm(did, ResourceId,
@@ -0,0 +1,420 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * Sensor reading cache.
+ *
+ * Readings returned by a handler are kept for "sensor_cache_ttl"
+ * milliseconds (handler configuration parameter). Concurrent reads of
+ * the same sensor that miss the cache are coalesced into a single
+ * plugin call: the first caller performs the read and the others wait
+ * for its result. Sensor events and sensor setters invalidate entries.
+ * Handlers without the parameter (or with 0) bypass the cache.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include <oh_error.h>
+
+#include "sensor_cache.h"
+#include "sahpi_wrappers.h"
+
+struct cache_key {
+        unsigned int hid;
+        SaHpiResourceIdT rid;
+        SaHpiSensorNumT num;
+};
+
+/* One plugin read shared by the caller doing it and all waiters */
+struct cache_flight {
+        guint refcount;
+        SaHpiBoolT done;
+        SaErrorT rv;
+        SaHpiSensorReadingT reading;
+        SaHpiEventStateT state;
+};
+
+struct cache_entry {
+        struct cache_key key;
+        SaHpiBoolT valid;
+        gint64 expires;
+        guint generation;
+        SaHpiSensorReadingT reading;
+        SaHpiEventStateT state;
+        struct cache_flight *flight;
+};
+
+struct cache_handler {
+        unsigned int hid;
+        gint64 ttl; /* usec */
+        SaHpiUint64T hits;
+        SaHpiUint64T misses;
+        SaHpiUint64T coalesced;
+        SaHpiUint64T invalidations;
+        SaHpiUint32T entries;
+};
+
+struct cache_match {
+        struct cache_handler *hc;
+        SaHpiResourceIdT rid;
+        SaHpiBoolT any_rid;
+};
+
+static GMutex *cache_lock = NULL;
+static GCond *cache_cond = NULL;
+static GHashTable *cache_handlers = NULL;
+static GHashTable *cache_entries = NULL;
+
+
+static gint64 cache_now(void)
+{
+#if GLIB_CHECK_VERSION (2, 28, 0)
+        return g_get_monotonic_time();
+#else
+        GTimeVal now;
+        g_get_current_time(&now);
+        return ((gint64)now.tv_sec * G_USEC_PER_SEC) + now.tv_usec;
+#endif
+}
+
+static guint cache_key_hash(gconstpointer key)
+{
+        const struct cache_key *k = key;
+
+        return (k->hid * 131u + k->rid) * 257u + k->num;
+}
+
+static gboolean cache_key_equal(gconstpointer a, gconstpointer b)
+{
+        const struct cache_key *ka = a;
+        const struct cache_key *kb = b;
+
+        return (ka->hid == kb->hid) &&
+               (ka->rid == kb->rid) &&
+               (ka->num == kb->num);
+}
+
+static void cache_flight_unref(struct cache_flight *f)
+{
+        if (--f->refcount == 0) {
+                g_free(f);
+        }
+}
+
+static void cache_entry_invalidate(struct cache_handler *hc,
+                                   struct cache_entry *e)
+{
+        if (e->valid) {
+                hc->invalidations++;
+        }
+        e->valid = SAHPI_FALSE;
+        /* A read in flight must not repopulate the entry */
+        e->generation++;
+}
+
+void oh_sensor_cache_init(void)
+{
+        if (cache_lock) {
+                return;
+        }
+
+        cache_lock = wrap_g_mutex_new_init();
+        cache_cond = wrap_g_cond_new_init();
+        cache_handlers = g_hash_table_new_full(g_int_hash, g_int_equal,
+                                               NULL, g_free);
+        cache_entries = g_hash_table_new_full(cache_key_hash, cache_key_equal,
+                                              NULL, g_free);
+}
+
+void oh_sensor_cache_finit(void)
+{
+        if (!cache_lock) {
+                return;
+        }
+
+        g_hash_table_destroy(cache_entries);
+        g_hash_table_destroy(cache_handlers);
+        cache_entries = NULL;
+        cache_handlers = NULL;
+        wrap_g_cond_free(cache_cond);
+        wrap_g_mutex_free_clear(cache_lock);
+        cache_cond = NULL;
+        cache_lock = NULL;
+}
+
+void oh_sensor_cache_handler_add(unsigned int hid, GHashTable *config)
+{
+        struct cache_handler *hc;
+        const char *value;
+        unsigned long ttl;
+
+        if (!cache_lock || !config) {
+                return;
+        }
+
+        value = (const char *)g_hash_table_lookup(config,
+                                                  OH_SENSOR_CACHE_TTL_KEY);
+        if (!value) {
+                return;
+        }
+
+        ttl = strtoul(value, NULL, 10);
+        if (ttl == 0) {
+                return;
+        }
+
+        hc = g_new0(struct cache_handler, 1);
+        hc->hid = hid;
+        hc->ttl = (gint64)ttl * 1000;
+
+        g_mutex_lock(cache_lock);
+        g_hash_table_insert(cache_handlers, &hc->hid, hc);
+        g_mutex_unlock(cache_lock);
+
+        INFO("Sensor reading cache enabled for handler %u, TTL %lu msec.",
+             hid, ttl);
+}
+
+static gboolean cache_match_entry(gpointer key, gpointer value, gpointer data)
+{
+        struct cache_entry *e = value;
+        struct cache_match *m = data;
+
+        if (e->key.hid != m->hc->hid) {
+                return FALSE;
+        }
+        if (!m->any_rid && e->key.rid != m->rid) {
+                return FALSE;
+        }
+
+        cache_entry_invalidate(m->hc, e);
+        m->hc->entries--;
+
+        return TRUE;
+}
+
+void oh_sensor_cache_handler_remove(unsigned int hid)
+{
+        struct cache_handler *hc;
+        struct cache_match m;
+
+        if (!cache_lock) {
+                return;
+        }
+
+        g_mutex_lock(cache_lock);
+        hc = g_hash_table_lookup(cache_handlers, &hid);
+        if (hc) {
+                /*
+                 * Entries with a read in flight can go as well: the reading
+                 * caller holds the flight and completes it without the entry.
+                 */
+                m.hc = hc;
+                m.rid = SAHPI_UNSPECIFIED_RESOURCE_ID;
+                m.any_rid = SAHPI_TRUE;
+                g_hash_table_foreach_remove(cache_entries,
+                                            cache_match_entry, &m);
+                g_hash_table_remove(cache_handlers, &hid);
+        }
+        g_mutex_unlock(cache_lock);
+}
+
+oh_sensor_cache_status oh_sensor_cache_begin(struct oh_sensor_cache_ticket *t,
+                                             SaHpiSensorReadingT *reading,
+                                             SaHpiEventStateT *state,
+                                             SaErrorT *rv)
+{
+        struct cache_handler *hc;
+        struct cache_entry *e;
+        struct cache_flight *f;
+        struct cache_key key;
+
+        if (!t || !reading || !state || !rv || !cache_lock) {
+                return OH_SENSOR_CACHE_BYPASS;
+        }
+
+        t->flight = NULL;
+        t->generation = 0;
+
+        g_mutex_lock(cache_lock);
+        hc = g_hash_table_lookup(cache_handlers, &t->hid);
+        if (!hc) {
+                g_mutex_unlock(cache_lock);
+                return OH_SENSOR_CACHE_BYPASS;
+        }
+
+        key.hid = t->hid;
+        key.rid = t->rid;
+        key.num = t->num;
+        e = g_hash_table_lookup(cache_entries, &key);
+        if (!e) {
+                e = g_new0(struct cache_entry, 1);
+                e->key = key;
+                g_hash_table_insert(cache_entries, &e->key, e);
+                hc->entries++;
+        }
+
+        if (e->valid && cache_now() < e->expires) {
+                *reading = e->reading;
+                *state = e->state;
+                *rv = SA_OK;
+                hc->hits++;
+                g_mutex_unlock(cache_lock);
+                return OH_SENSOR_CACHE_DONE;
+        }
+
+        if (e->flight) {
+                /* Someone is already reading this sensor, share the result */
+                f = e->flight;
+                f->refcount++;
+                hc->coalesced++;
+                while (!f->done) {
+                        g_cond_wait(cache_cond, cache_lock);
+                }
+                *reading = f->reading;
+                *state = f->state;
+                *rv = f->rv;
+                cache_flight_unref(f);
+                g_mutex_unlock(cache_lock);
+                return OH_SENSOR_CACHE_DONE;
+        }
+
+        f = g_new0(struct cache_flight, 1);
+        f->refcount = 1;
+        e->flight = f;
+        hc->misses++;
+        t->generation = e->generation;
+        t->flight = f;
+        g_mutex_unlock(cache_lock);
+
+        return OH_SENSOR_CACHE_FETCH;
+}
+
+void oh_sensor_cache_end(struct oh_sensor_cache_ticket *t,
+                         SaErrorT rv,
+                         const SaHpiSensorReadingT *reading,
+                         const SaHpiEventStateT *state)
+{
+        struct cache_handler *hc;
+        struct cache_entry *e;
+        struct cache_flight *f;
+        struct cache_key key;
+
+        if (!t || !t->flight || !cache_lock) {
+                return;
+        }
+
+        g_mutex_lock(cache_lock);
+        f = t->flight;
+        f->rv = rv;
+        if (reading) f->reading = *reading;
+        if (state) f->state = *state;
+        f->done = SAHPI_TRUE;
+
+        key.hid = t->hid;
+        key.rid = t->rid;
+        key.num = t->num;
+        hc = g_hash_table_lookup(cache_handlers, &t->hid);
+        e = g_hash_table_lookup(cache_entries, &key);
+        if (hc && e && e->flight == f) {
+                e->flight = NULL;
+                if (rv == SA_OK && e->generation == t->generation) {
+                        e->reading = f->reading;
+                        e->state = f->state;
+                        e->expires = cache_now() + hc->ttl;
+                        e->valid = SAHPI_TRUE;
+                }
+        }
+
+        g_cond_broadcast(cache_cond);
+        cache_flight_unref(f);
+        t->flight = NULL;
+        g_mutex_unlock(cache_lock);
+}
+
+void oh_sensor_cache_invalidate(unsigned int hid,
+                                SaHpiResourceIdT rid,
+                                SaHpiSensorNumT num)
+{
+        struct cache_handler *hc;
+        struct cache_entry *e;
+        struct cache_key key;
+
+        if (!cache_lock) {
+                return;
+        }
+
+        g_mutex_lock(cache_lock);
+        hc = g_hash_table_lookup(cache_handlers, &hid);
+        if (hc) {
+                key.hid = hid;
+                key.rid = rid;
+                key.num = num;
+                e = g_hash_table_lookup(cache_entries, &key);
+                if (e) {
+                        cache_entry_invalidate(hc, e);
+                }
+        }
+        g_mutex_unlock(cache_lock);
+}
+
+void oh_sensor_cache_invalidate_resource(unsigned int hid,
+                                         SaHpiResourceIdT rid)
+{
+        struct cache_handler *hc;
+        struct cache_match m;
+
+        if (!cache_lock) {
+                return;
+        }
+
+        g_mutex_lock(cache_lock);
+        hc = g_hash_table_lookup(cache_handlers, &hid);
+        if (hc) {
+                m.hc = hc;
+                m.rid = rid;
+                m.any_rid = SAHPI_FALSE;
+                g_hash_table_foreach_remove(cache_entries,
+                                            cache_match_entry, &m);
+        }
+        g_mutex_unlock(cache_lock);
+}
+
+SaErrorT oh_sensor_cache_get_stats(unsigned int hid,
+                                   oHpiSensorCacheStatsT *stats)
+{
+        struct cache_handler *hc;
+
+        if (!stats) {
+                return SA_ERR_HPI_INVALID_PARAMS;
+        }
+
+        memset(stats, 0, sizeof(*stats));
+        if (!cache_lock) {
+                return SA_OK;
+        }
+
+        g_mutex_lock(cache_lock);
+        hc = g_hash_table_lookup(cache_handlers, &hid);
+        if (hc) {
+                stats->TtlMsec = (SaHpiUint32T)(hc->ttl / 1000);
+                stats->Hits = hc->hits;
+                stats->Misses = hc->misses;
+                stats->Coalesced = hc->coalesced;
+                stats->Invalidations = hc->invalidations;
+                stats->Entries = hc->entries;
+        }
+        g_mutex_unlock(cache_lock);
+
+        return SA_OK;
+}
@@ -0,0 +1,74 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __OH_SENSOR_CACHE_H
+#define __OH_SENSOR_CACHE_H
+
+#include <glib.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Handler configuration key holding the cache TTL in milliseconds */
+#define OH_SENSOR_CACHE_TTL_KEY "sensor_cache_ttl"
+
+typedef enum {
+        OH_SENSOR_CACHE_BYPASS = 0, /* Cache disabled, call the plugin */
+        OH_SENSOR_CACHE_DONE,       /* Result was delivered by the cache */
+        OH_SENSOR_CACHE_FETCH       /* Caller must read and call _end() */
+} oh_sensor_cache_status;
+
+/*
+ * Filled in by oh_sensor_cache_begin() and handed back to
+ * oh_sensor_cache_end() by the caller that performs the plugin read.
+ */
+struct oh_sensor_cache_ticket {
+        unsigned int hid;
+        SaHpiResourceIdT rid;
+        SaHpiSensorNumT num;
+        guint generation;
+        gpointer flight;
+};
+
+void oh_sensor_cache_init(void);
+void oh_sensor_cache_finit(void);
+
+void oh_sensor_cache_handler_add(unsigned int hid, GHashTable *config);
+void oh_sensor_cache_handler_remove(unsigned int hid);
+
+oh_sensor_cache_status oh_sensor_cache_begin(struct oh_sensor_cache_ticket *t,
+                                             SaHpiSensorReadingT *reading,
+                                             SaHpiEventStateT *state,
+                                             SaErrorT *rv);
+void oh_sensor_cache_end(struct oh_sensor_cache_ticket *t,
+                         SaErrorT rv,
+                         const SaHpiSensorReadingT *reading,
+                         const SaHpiEventStateT *state);
+
+void oh_sensor_cache_invalidate(unsigned int hid,
+                                SaHpiResourceIdT rid,
+                                SaHpiSensorNumT num);
+void oh_sensor_cache_invalidate_resource(unsigned int hid,
+                                         SaHpiResourceIdT rid);
+
+SaErrorT oh_sensor_cache_get_stats(unsigned int hid,
+                                   oHpiSensorCacheStatsT *stats);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __OH_SENSOR_CACHE_H */
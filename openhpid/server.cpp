@@ -20,7 +20,12 @@
  *
  */
 
+#include <stdlib.h>
 #include <string.h>
+#ifndef _WIN32
+#include <grp.h>
+#include <unistd.h>
+#endif
 
 #include <glib.h>
 
@@ -40,6 +45,7 @@
 /*--------------------------------------------------------------------*/
 
 static void service_thread(gpointer sock_ptr, gpointer /* user_data */);
+static void request_thread(gpointer req_ptr, gpointer /* user_data */);
 static SaErrorT process_msg(cHpiMarshal * hm,
                             int rq_byte_order,
                             char * data,
@@ -59,6 +65,43 @@ static volatile bool stop = false;
 
 static GList * sockets = 0; 
 
+// Runs tagged requests of all connections
+static GThreadPool * request_pool = 0;
+// Tagged requests queued or running, guarded by lock. Requests beyond
+// request_limit are answered with SA_ERR_HPI_BUSY.
+static int request_count = 0;
+static int request_limit = 0;
+// Used if the number of threads is not limited
+static const int default_request_limit = 64;
+
+// Session id -> Connection that opened it, guarded by lock.
+// A session can be closed through any connection.
+static GHashTable * session_owners = 0;
+
+#ifndef _WIN32
+// Group whose members may use the local socket besides the daemon user
+static gid_t local_gid = 0;
+static bool local_gid_set = false;
+#endif
+
+struct Connection
+{
+    cStreamSock * sock;
+    GMutex      * lock;     // guards socket writes and the fields below
+    GCond       * cond;
+    guint         pending;  // tagged requests not replied yet
+};
+
+struct TaggedRequest
+{
+    Connection * conn;
+    uint16_t     tag;
+    uint32_t     id;
+    int          byte_order;
+    uint32_t     data_len;
+    char       * data;      // message buffer, dMaxPayloadLength bytes
+};
+
 /*--------------------------------------------------------------------*/
 /* Socket List                                                        */
 /*--------------------------------------------------------------------*/
@@ -139,27 +182,76 @@ static void LogIp( const cStreamSock * sock )
 }
 
 
+#ifndef _WIN32
 /*--------------------------------------------------------------------*/
-/* HPI Server Interface                                               */
+/* Function to check local connection credentials                     */
 /*--------------------------------------------------------------------*/
+static bool CheckPeer( const cStreamSock * sock )
+{
+    uid_t uid;
+    gid_t gid;
+    pid_t pid;
+    bool rc = sock->GetPeerCredentials( uid, gid, pid );
+    if ( !rc ) {
+        CRIT( "Cannot determine local connection credentials. Refused." );
+        return false;
+    }
 
-bool oh_server_run( int ipvflags,
-                    const char * bindaddr,
-                    uint16_t port,
-                    unsigned int sock_timeout,
-                    int max_threads )
+    // Only root, the daemon user and the configured group are served.
+    // The daemon group is often shared, so it does not count by itself.
+    bool allowed = ( uid == 0 ) || ( uid == geteuid() );
+    if ( !allowed && local_gid_set && ( gid == local_gid ) ) {
+        allowed = true;
+    }
+    if ( !allowed ) {
+        CRIT( "Local connection from pid %d uid %u gid %u refused.",
+              (int)pid, (unsigned int)uid, (unsigned int)gid );
+        return false;
+    }
+
+    INFO( "Got local connection from pid %d uid %u gid %u",
+          (int)pid, (unsigned int)uid, (unsigned int)gid );
+
+    return true;
+}
+
+/*--------------------------------------------------------------------*/
+/* Function to resolve the local socket group (name or number)        */
+/*--------------------------------------------------------------------*/
+static bool ResolveGroup( const char * name, gid_t& gid )
 {
-    // create the server socket
-    cServerStreamSock * ssock = new cServerStreamSock;
-    if (!ssock->Create(ipvflags, bindaddr, port)) {
-        CRIT("Error creating server socket. Exiting.");
+    struct group * gr = getgrnam( name );
+    if ( gr ) {
+        gid = gr->gr_gid;
+        return true;
+    }
+
+    char * end = 0;
+    unsigned long n = strtoul( name, &end, 10 );
+    if ( ( *name == '\0' ) || ( *end != '\0' ) ) {
         return false;
     }
-    add_socket_to_list( ssock );
+    gid = (gid_t)n;
+    return true;
+}
+#endif
 
-    // create the thread pool
-    GThreadPool *pool;
-    pool = g_thread_pool_new(service_thread, 0, max_threads, FALSE, 0);
+
+/*--------------------------------------------------------------------*/
+/* Function: accept_loop                                              */
+/*--------------------------------------------------------------------*/
+
+struct Listener
+{
+    cServerStreamSock * ssock;
+    GThreadPool       * pool;
+    bool                local;
+};
+
+static gpointer accept_loop( gpointer listener_ptr )
+{
+    Listener * listener = (Listener *)listener_ptr;
+    cServerStreamSock * ssock = listener->ssock;
 
     cStreamSock::eWaitCc wc;
     // wait for a connection and then service the connection
@@ -189,10 +281,110 @@ bool oh_server_run( int ipvflags,
             break;
         }
 
+#ifndef _WIN32
+        if ( listener->local ) {
+            if ( !CheckPeer( sock ) ) {
+                delete sock;
+                continue;
+            }
+        } else {
+            LogIp( sock );
+        }
+#else
         LogIp( sock );
+#endif
         add_socket_to_list( sock );
         DBG("### Spawning thread to handle connection. ###");
-        g_thread_pool_push(pool, (gpointer)sock, 0);
+        g_thread_pool_push(listener->pool, (gpointer)sock, 0);
+    }
+
+    return 0;
+}
+
+
+/*--------------------------------------------------------------------*/
+/* HPI Server Interface                                               */
+/*--------------------------------------------------------------------*/
+
+bool oh_server_run( int ipvflags,
+                    const char * bindaddr,
+                    uint16_t port,
+                    const char * unix_path,
+                    const char * unix_group,
+                    unsigned int sock_timeout,
+                    int max_threads )
+{
+#ifndef _WIN32
+    if ( unix_path && unix_group ) {
+        if ( !ResolveGroup( unix_group, local_gid ) ) {
+            CRIT("Unknown unix socket group %s. Exiting.", unix_group);
+            return false;
+        }
+        local_gid_set = true;
+    }
+#endif
+
+    // create the server socket
+    cServerStreamSock * ssock = new cServerStreamSock;
+    if (!ssock->Create(ipvflags, bindaddr, port)) {
+        CRIT("Error creating server socket. Exiting.");
+        return false;
+    }
+    add_socket_to_list( ssock );
+
+    // create the local server socket, if requested
+    cServerStreamSock * lsock = 0;
+    if ( unix_path ) {
+        lsock = new cServerStreamSock;
+        if (!lsock->CreateLocal(unix_path)) {
+            CRIT("Error creating unix server socket %s. Exiting.", unix_path);
+            delete lsock;
+            remove_socket_from_list( ssock );
+            delete ssock;
+            return false;
+        }
+#ifndef _WIN32
+        // Members of the group need access to the socket file too
+        if ( local_gid_set && ( chown( unix_path, (uid_t)-1, local_gid ) != 0 ) ) {
+            CRIT("Cannot set group of unix server socket %s. Exiting.", unix_path);
+            delete lsock;
+            unlink( unix_path );
+            remove_socket_from_list( ssock );
+            delete ssock;
+            return false;
+        }
+#endif
+        add_socket_to_list( lsock );
+    }
+
+    // create the thread pools
+    GThreadPool *pool;
+    pool = g_thread_pool_new(service_thread, 0, max_threads, FALSE, 0);
+    // Tagged requests may block (saHpiEventGet), so they get their own
+    // pool. Its threads are shared by all connections and exit when idle.
+    request_limit = ( max_threads > 0 ) ? max_threads : default_request_limit;
+    request_pool = g_thread_pool_new(request_thread, 0, request_limit, FALSE, 0);
+
+    Listener local = { lsock, pool, true };
+    GThread * local_thread = 0;
+    if ( lsock ) {
+        local_thread = wrap_g_thread_create_new("LocalListener",
+                                                accept_loop,
+                                                &local, TRUE, 0);
+    }
+
+    Listener remote = { ssock, pool, false };
+    accept_loop( &remote );
+
+    if ( local_thread ) {
+        g_thread_join( local_thread );
+    }
+    if ( lsock ) {
+        remove_socket_from_list( lsock );
+        delete lsock;
+#ifndef _WIN32
+        unlink( unix_path );
+#endif
     }
 
     remove_socket_from_list( ssock );
@@ -201,6 +393,8 @@ bool oh_server_run( int ipvflags,
 
     g_thread_pool_free(pool, FALSE, TRUE);
     DBG("All connection threads are terminated.");
+    g_thread_pool_free(request_pool, FALSE, TRUE);
+    request_pool = 0;
 
     return true;
 }
@@ -212,17 +406,182 @@ void oh_server_request_stop(void)
 }
 
 
+/*--------------------------------------------------------------------*/
+/* Function: serve_msg                                                */
+/*--------------------------------------------------------------------*/
+
+// Processes one request in place, data gets the reply.
+static bool serve_msg(uint32_t id,
+                      int rq_byte_order,
+                      char * data,
+                      uint32_t& data_len,
+                      SaErrorT& process_rv,
+                      SaHpiSessionIdT& changed_sid)
+{
+    cHpiMarshal *hm = HpiMarshalFind(id);
+    changed_sid = 0;
+    if ( hm ) {
+        process_rv = process_msg(hm, rq_byte_order, data, data_len, changed_sid);
+    } else {
+        process_rv = SA_ERR_HPI_UNSUPPORTED_API;
+    }
+    if (process_rv != SA_OK) {
+        int cc = HpiMarshalReply0(hm, data, &process_rv);
+        if (cc < 0) {
+            CRIT("%p Marshal failed, cc = %d", g_thread_self(), cc);
+            return false;
+        }
+        data_len = (uint32_t)cc;
+    }
+
+    return true;
+}
+
+
+/*--------------------------------------------------------------------*/
+/* Sessions opened through a connection                               */
+/*--------------------------------------------------------------------*/
+
+static void track_session(Connection * conn,
+                          uint32_t id,
+                          SaErrorT process_rv,
+                          SaHpiSessionIdT changed_sid)
+{
+    if ((process_rv != SA_OK) || (changed_sid == 0)) {
+        return;
+    }
+
+    wrap_g_static_rec_mutex_lock(&lock);
+    if (!session_owners) {
+        session_owners = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+    if (id == eFsaHpiSessionOpen) {
+        g_hash_table_insert(session_owners, GUINT_TO_POINTER(changed_sid), conn);
+    } else if (id == eFsaHpiSessionClose) {
+        g_hash_table_remove(session_owners, GUINT_TO_POINTER(changed_sid));
+    }
+    wrap_g_static_rec_mutex_unlock(&lock);
+}
+
+static void close_sessions(Connection * conn)
+{
+    GSList * sids = 0;
+    GHashTableIter iter;
+    gpointer key, value;
+
+    wrap_g_static_rec_mutex_lock(&lock);
+    if (session_owners) {
+        g_hash_table_iter_init(&iter, session_owners);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            if (value == conn) {
+                sids = g_slist_prepend(sids, key);
+                g_hash_table_iter_remove(&iter);
+            }
+        }
+    }
+    wrap_g_static_rec_mutex_unlock(&lock);
+
+    for (GSList * node = sids; node != 0; node = g_slist_next(node)) {
+        saHpiSessionClose(GPOINTER_TO_UINT(node->data));
+    }
+    g_slist_free(sids);
+}
+
+
+/*--------------------------------------------------------------------*/
+/* Function: request_thread                                           */
+/*--------------------------------------------------------------------*/
+
+static void request_thread(gpointer req_ptr, gpointer /* user_data */)
+{
+    TaggedRequest * req = (TaggedRequest *)req_ptr;
+    Connection * conn = req->conn;
+    gpointer thrdid;
+    thrdid = g_thread_self();
+    SaErrorT process_rv;
+    SaHpiSessionIdT changed_sid;
+
+    bool rc = serve_msg(req->id, req->byte_order, req->data, req->data_len,
+                        process_rv, changed_sid);
+    if (rc) {
+        track_session(conn, req->id, process_rv, changed_sid);
+    }
+
+    g_mutex_lock(conn->lock);
+    if (rc) {
+        rc = conn->sock->WriteMsg(eMhMsg, req->tag, req->id,
+                                  req->data, req->data_len);
+    } else {
+        // The caller must not wait forever for this tag
+        rc = conn->sock->WriteMsg(eMhError, req->tag, req->id, 0, 0);
+    }
+    if (!rc && !stop) {
+        CRIT("%p Socket write failed.", thrdid);
+    }
+    --conn->pending;
+    if (conn->pending == 0) {
+        g_cond_broadcast(conn->cond);
+    }
+    g_mutex_unlock(conn->lock);
+
+    FreeMsgBuffer(req->data);
+    g_free(req);
+
+    wrap_g_static_rec_mutex_lock(&lock);
+    --request_count;
+    wrap_g_static_rec_mutex_unlock(&lock);
+}
+
+// Takes a slot in the request pool, false if all are in use
+static bool reserve_request(void)
+{
+    bool reserved = false;
+
+    wrap_g_static_rec_mutex_lock(&lock);
+    if (request_count < request_limit) {
+        ++request_count;
+        reserved = true;
+    }
+    wrap_g_static_rec_mutex_unlock(&lock);
+
+    return reserved;
+}
+
+// Answers a tagged request the pool has no room for
+static bool reply_busy(Connection * conn, TaggedRequest * req)
+{
+    cHpiMarshal *hm = HpiMarshalFind(req->id);
+    SaErrorT rv = SA_ERR_HPI_BUSY;
+    bool rc;
+
+    int cc = hm ? HpiMarshalReply0(hm, req->data, &rv) : -1;
+    g_mutex_lock(conn->lock);
+    if (cc < 0) {
+        rc = conn->sock->WriteMsg(eMhError, req->tag, req->id, 0, 0);
+    } else {
+        rc = conn->sock->WriteMsg(eMhMsg, req->tag, req->id,
+                                  req->data, (uint32_t)cc);
+    }
+    g_mutex_unlock(conn->lock);
+
+    return rc;
+}
+
+
 /*--------------------------------------------------------------------*/
 /* Function: service_thread                                           */
 /*--------------------------------------------------------------------*/
 
 static void service_thread(gpointer sock_ptr, gpointer /* user_data */)
 {
-    cStreamSock * sock = (cStreamSock *)sock_ptr;
     gpointer thrdid;
     thrdid = g_thread_self();
-    // TODO several sids for one connection
-    SaHpiSessionIdT my_sid = 0;
+    Connection conn;
+
+    conn.sock    = (cStreamSock *)sock_ptr;
+    conn.lock    = wrap_g_mutex_new_init();
+    conn.cond    = wrap_g_cond_new_init();
+    conn.pending = 0;
 
     DBG("%p Servicing connection.", thrdid);
 
@@ -232,15 +591,21 @@ static void service_thread(gpointer sock_ptr, gpointer /* user_data */)
 
     DBG("### service_thread, thrdid [%p] ###", (void *)thrdid);
 
+    // Untagged requests are served here one by one, as before.
+    // Tagged requests are handed to the request pool, so a client
+    // can multiplex its sessions and threads onto this connection.
+    TaggedRequest * req = 0;
     while (!stop) {
         bool     rc;
-        char     data[dMaxPayloadLength];
-        uint32_t data_len;
         uint8_t  type;
-        uint32_t id;
-        int      rq_byte_order;
 
-        rc = sock->ReadMsg(type, id, data, data_len, rq_byte_order);
+        if (!req) {
+            req = g_new(TaggedRequest, 1);
+            req->conn = &conn;
+            req->data = (char *)AllocMsgBuffer();
+        }
+        rc = conn.sock->ReadMsg(type, req->tag, req->id,
+                                req->data, req->data_len, req->byte_order);
         if (stop) {
             break;
         }
@@ -250,27 +615,44 @@ static void service_thread(gpointer sock_ptr, gpointer /* user_data */)
             // one of the false return is not a real error
             // CRIT("%p Error or Timeout while reading socket.", thrdid);
             break;
+        } else if (type == eMhMuxHello) {
+            g_mutex_lock(conn.lock);
+            rc = conn.sock->WriteMsg(eMhMuxHello, req->tag, req->id, 0, 0);
+            g_mutex_unlock(conn.lock);
+            if (!rc) {
+                CRIT("%p Socket write failed.", thrdid);
+                break;
+            }
         } else if (type != eMhMsg) {
             CRIT("%p Unsupported message type. Discarding.", thrdid);
-            sock->WriteMsg(eMhError, id, 0, 0);
+            g_mutex_lock(conn.lock);
+            conn.sock->WriteMsg(eMhError, req->tag, req->id, 0, 0);
+            g_mutex_unlock(conn.lock);
+        } else if ((req->tag != 0) && !reserve_request()) {
+            WARN("%p Too many requests in progress, request rejected.",
+                 thrdid);
+            if (!reply_busy(&conn, req)) {
+                CRIT("%p Socket write failed.", thrdid);
+                break;
+            }
+        } else if (req->tag != 0) {
+            g_mutex_lock(conn.lock);
+            ++conn.pending;
+            g_mutex_unlock(conn.lock);
+            g_thread_pool_push(request_pool, (gpointer)req, 0);
+            req = 0;
         } else {
-            cHpiMarshal *hm = HpiMarshalFind(id);
             SaErrorT process_rv;
-            SaHpiSessionIdT changed_sid = 0;
-            if ( hm ) {
-                process_rv = process_msg(hm, rq_byte_order, data, data_len, changed_sid);
-            } else {
-                process_rv = SA_ERR_HPI_UNSUPPORTED_API;
-            }
-            if (process_rv != SA_OK) {
-                int cc = HpiMarshalReply0(hm, data, &process_rv);
-                if (cc < 0) {
-                    CRIT("%p Marshal failed, cc = %d", thrdid, cc);
-                    break;
-                }
-                data_len = (uint32_t)cc;
+            SaHpiSessionIdT changed_sid;
+            rc = serve_msg(req->id, req->byte_order, req->data, req->data_len,
+                           process_rv, changed_sid);
+            if (!rc) {
+                break;
             }
-            rc = sock->WriteMsg(eMhMsg, id, data, data_len);
+            track_session(&conn, req->id, process_rv, changed_sid);
+            g_mutex_lock(conn.lock);
+            rc = conn.sock->WriteMsg(eMhMsg, req->id, req->data, req->data_len);
+            g_mutex_unlock(conn.lock);
             if (stop) {
                 break;
             }
@@ -278,24 +660,32 @@ static void service_thread(gpointer sock_ptr, gpointer /* user_data */)
                 CRIT("%p Socket write failed.", thrdid);
                 break;
             }
-            if ((process_rv == SA_OK) && (changed_sid != 0)) {
-                if (id == eFsaHpiSessionOpen) {
-                    my_sid = changed_sid;
-                } else if (id == eFsaHpiSessionClose) {
-                    my_sid = 0;
-                    break;
-                }
+            if ((process_rv == SA_OK) && (req->id == eFsaHpiSessionClose)) {
+                break;
             }
         }
     }
+    if (req) {
+        FreeMsgBuffer(req->data);
+        g_free(req);
+    }
 
-    // if necessary, clean up HPI lib data
-    if (my_sid != 0) {
-        saHpiSessionClose(my_sid);
+    // if necessary, clean up HPI lib data.
+    // Closing the sessions also wakes up requests blocked in saHpiEventGet.
+    close_sessions(&conn);
+    g_mutex_lock(conn.lock);
+    while (conn.pending != 0) {
+        g_cond_wait(conn.cond, conn.lock);
     }
+    g_mutex_unlock(conn.lock);
+    // Sessions opened by requests that were still in flight
+    close_sessions(&conn);
+
+    wrap_g_cond_free(conn.cond);
+    wrap_g_mutex_free_clear(conn.lock);
 
-    remove_socket_from_list( sock );
-    delete sock; // cleanup thread instance data
+    remove_socket_from_list( conn.sock );
+    delete conn.sock; // cleanup thread instance data
 
     DBG("%p Connection closed.", thrdid);
     return; // do NOT use g_thread_exit here!
@@ -2104,6 +2494,105 @@ static SaErrorT process_msg(cHpiMarshal * hm,
         }
         break;
 
+        case eFoHpiSensorCacheStatsGet: {
+            oHpiHandlerIdT hid;
+            oHpiSensorCacheStatsT stats;
+
+            RpcParams iparams(&sid, &hid);
+            DEMARSHAL_RQ(rq_byte_order, hm, data, iparams);
+
+            rv = oHpiSensorCacheStatsGet(sid, hid, &stats);
+
+            RpcParams oparams(&rv, &stats);
+            MARSHAL_RP(hm, data, data_len, oparams);
+        }
+        break;
+
+        case eFoHpiHandlerStatsGet: {
+            oHpiHandlerIdT hid;
+            SaHpiEntryIdT entry_id;
+            SaHpiEntryIdT next_entry_id;
+            oHpiHandlerStatsT stats;
+
+            RpcParams iparams(&sid, &hid, &entry_id);
+            DEMARSHAL_RQ(rq_byte_order, hm, data, iparams);
+
+            rv = oHpiHandlerStatsGet(sid, hid, entry_id, &next_entry_id, &stats);
+
+            RpcParams oparams(&rv, &next_entry_id, &stats);
+            MARSHAL_RP(hm, data, data_len, oparams);
+        }
+        break;
+
+        case eFoHpiDelWriterStatsGet: {
+            oHpiDelWriterStatsT stats;
+
+            RpcParams iparams(&sid);
+            DEMARSHAL_RQ(rq_byte_order, hm, data, iparams);
+
+            rv = oHpiDelWriterStatsGet(sid, &stats);
+
+            RpcParams oparams(&rv, &stats);
+            MARSHAL_RP(hm, data, data_len, oparams);
+        }
+        break;
+
+        case eFoHpiEventLimitStatsGet: {
+            oHpiHandlerIdT hid;
+            oHpiEventLimitStatsT stats;
+
+            RpcParams iparams(&sid, &hid);
+            DEMARSHAL_RQ(rq_byte_order, hm, data, iparams);
+
+            rv = oHpiEventLimitStatsGet(sid, hid, &stats);
+
+            RpcParams oparams(&rv, &stats);
+            MARSHAL_RP(hm, data, data_len, oparams);
+        }
+        break;
+
+        case eFoHpiEventQueueStatsGet: {
+            oHpiEventPriorityT priority;
+            oHpiEventQueueStatsT stats;
+
+            RpcParams iparams(&sid, &priority);
+            DEMARSHAL_RQ(rq_byte_order, hm, data, iparams);
+
+            rv = oHpiEventQueueStatsGet(sid, priority, &stats);
+
+            RpcParams oparams(&rv, &stats);
+            MARSHAL_RP(hm, data, data_len, oparams);
+        }
+        break;
+
+        case eFoHpiEventLogEntriesGet: {
+            SaHpiEventLogEntryIdT eid;
+            SaHpiEventLogEntryIdT next_eid = SAHPI_NO_MORE_ENTRIES;
+            SaHpiUint32T          max_entries;
+            SaHpiBoolT            with_rdr;
+            SaHpiBoolT            with_rpte;
+            oHpiEventLogEntriesT  entries;
+
+            RpcParams iparams(&sid, &rid, &eid, &max_entries, &with_rdr, &with_rpte);
+            DEMARSHAL_RQ(rq_byte_order, hm, data, iparams);
+
+            memset(&entries, 0, sizeof(entries));
+            rv = oHpiEventLogEntriesGet(sid, rid, eid, max_entries,
+                                        with_rdr, with_rpte,
+                                        &next_eid, &entries);
+
+            RpcParams oparams(&rv, &next_eid, &entries);
+            int cc = HpiMarshalReply(hm, data, oparams.const_array);
+            g_free(entries.Entries);
+            g_free(entries.Rdrs);
+            g_free(entries.RptEntries);
+            if (cc < 0) {
+                return SA_ERR_HPI_INTERNAL_ERROR;
+            }
+            data_len = (uint32_t)cc;
+        }
+        break;
+
         default:
             DBG("%p Function not found", thrdid);
             return SA_ERR_HPI_UNSUPPORTED_API; 
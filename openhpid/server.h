@@ -25,6 +25,8 @@
 bool oh_server_run( int ipvflags,
                     const char * bindaddr,
                     uint16_t port,
+                    const char * unix_path,
+                    const char * unix_group,
                     unsigned int sock_timeout,
                     int max_threads );
 
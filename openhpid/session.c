@@ -369,7 +369,10 @@ SaErrorT oh_dequeue_session_event(SaHpiSessionIdT sid,
                         return SA_ERR_HPI_NO_RESPONSE;
                 }
                 memcpy(event, devent, sizeof(struct oh_event));
-                g_free(devent);
+                /* The RDRs now belong to the caller's copy */
+                devent->rdrs = NULL;
+                devent->rdrs_to_remove = NULL;
+                oh_event_free(devent, FALSE);
                 return SA_OK;
         } else {
                 memset(event, 0, sizeof(struct oh_event));
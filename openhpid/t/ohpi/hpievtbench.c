@@ -0,0 +1,168 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * Event processing throughput benchmark.
+ *
+ * Injects sensor events for a number of resources through
+ * oHpiInjectEvent and reads them back with saHpiEventGet. Reports the
+ * injection and end-to-end rates and checks that the events of each
+ * resource arrive in the order they were injected.
+ * Compare runs with different OPENHPI_EVT_WORKERS values. Events are
+ * read after all are injected, so keep -n below OPENHPI_EVT_QUEUE_LIMIT.
+ * Not part of "make check": build it with "make hpievtbench".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/time.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+#include <oh_utils.h>
+
+#define BENCH_SENSOR_NUM 0x7E
+/* SensorSpecific carries the resource index and a per resource sequence */
+#define BENCH_SEQ_BITS   20
+#define BENCH_SEQ_MASK   ((1u << BENCH_SEQ_BITS) - 1)
+#define BENCH_TIMEOUT    (10 * 1000000000LL) /* nsec */
+
+static double now_sec(void)
+{
+        struct timeval tv;
+
+        gettimeofday(&tv, NULL);
+        return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+int main(int argc, char **argv)
+{
+        SaErrorT rv;
+        SaHpiSessionIdT sid;
+        oHpiHandlerIdT hid = 1;
+        SaHpiSeverityT sev = SAHPI_INFORMATIONAL;
+        SaHpiEventT event;
+        SaHpiRptEntryT rpte;
+        SaHpiRdrT rdr;
+        SaHpiUint32T *last_seq;
+        unsigned int count = 10000, resources = 16;
+        unsigned int i, k, received = 0, disorder = 0;
+        double t0, t1, t2;
+        int c;
+
+        while ((c = getopt(argc, argv, "n:r:h:l")) != EOF) {
+                switch (c) {
+                case 'n': count = atoi(optarg); break;
+                case 'r': resources = atoi(optarg); break;
+                case 'h': hid = atoi(optarg); break;
+                case 'l': sev = SAHPI_CRITICAL; break;
+                default:
+                        printf("Usage: %s [-n events] [-r resources] "
+                               "[-h handler id] [-l]\n", argv[0]);
+                        printf("  -l  inject critical events, "
+                               "so they are logged to the DEL\n");
+                        return 1;
+                }
+        }
+        if (count == 0 || resources == 0 ||
+            resources > (1u << (32 - BENCH_SEQ_BITS)) ||
+            count / resources >= BENCH_SEQ_MASK) {
+                printf("Invalid number of events or resources\n");
+                return 1;
+        }
+
+        rv = saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL);
+        if (rv != SA_OK) {
+                printf("saHpiSessionOpen returns %s\n", oh_lookup_error(rv));
+                return -1;
+        }
+        saHpiDiscover(sid);
+        rv = saHpiSubscribe(sid);
+        if (rv != SA_OK) {
+                printf("saHpiSubscribe returns %s\n", oh_lookup_error(rv));
+                return -1;
+        }
+
+        last_seq = calloc(resources, sizeof(SaHpiUint32T));
+        memset(&rdr, 0, sizeof(rdr));
+        rdr.RdrType = SAHPI_SENSOR_RDR;
+
+        memset(&event, 0, sizeof(event));
+        event.EventType = SAHPI_ET_SENSOR;
+        event.Severity = sev;
+        event.Timestamp = SAHPI_TIME_UNSPECIFIED;
+        event.EventDataUnion.SensorEvent.SensorNum = BENCH_SENSOR_NUM;
+        event.EventDataUnion.SensorEvent.SensorType = SAHPI_TEMPERATURE;
+        event.EventDataUnion.SensorEvent.EventCategory = SAHPI_EC_THRESHOLD;
+        event.EventDataUnion.SensorEvent.Assertion = SAHPI_FALSE;
+        event.EventDataUnion.SensorEvent.EventState = SAHPI_ES_UPPER_MINOR;
+
+        t0 = now_sec();
+        for (i = 0; i < count; i++) {
+                k = i % resources;
+                /* The handler derives the source resource from the path */
+                memset(&rpte, 0, sizeof(rpte));
+                rpte.ResourceEntity.Entry[0].EntityType = SAHPI_ENT_SYSTEM_BOARD;
+                rpte.ResourceEntity.Entry[0].EntityLocation = 100 + k;
+                rpte.ResourceEntity.Entry[1].EntityType = SAHPI_ENT_ROOT;
+                event.EventDataUnion.SensorEvent.SensorSpecific =
+                        (k << BENCH_SEQ_BITS) | (1 + i / resources);
+                rv = oHpiInjectEvent(sid, hid, &event, &rpte, &rdr);
+                if (rv != SA_OK) {
+                        printf("oHpiInjectEvent returns %s\n",
+                               oh_lookup_error(rv));
+                        return -1;
+                }
+        }
+        t1 = now_sec();
+
+        while (received < count) {
+                SaHpiSensorEventT *se;
+
+                rv = saHpiEventGet(sid, BENCH_TIMEOUT, &event,
+                                   NULL, NULL, NULL);
+                if (rv != SA_OK) {
+                        printf("saHpiEventGet returns %s after %u events\n",
+                               oh_lookup_error(rv), received);
+                        break;
+                }
+                se = &event.EventDataUnion.SensorEvent;
+                if (event.EventType != SAHPI_ET_SENSOR ||
+                    se->SensorNum != BENCH_SENSOR_NUM) {
+                        continue;
+                }
+                k = se->SensorSpecific >> BENCH_SEQ_BITS;
+                if (k >= resources) {
+                        continue;
+                }
+                if ((se->SensorSpecific & BENCH_SEQ_MASK) != last_seq[k] + 1) {
+                        disorder++;
+                }
+                last_seq[k] = se->SensorSpecific & BENCH_SEQ_MASK;
+                received++;
+        }
+        t2 = now_sec();
+
+        printf("events:      %u injected, %u received, %u resources\n",
+               count, received, resources);
+        printf("inject:      %.3f sec, %.0f events/sec\n",
+               t1 - t0, count / (t1 - t0));
+        printf("end to end:  %.3f sec, %.0f events/sec\n",
+               t2 - t0, received / (t2 - t0));
+        printf("out of order: %u\n", disorder);
+
+        free(last_seq);
+        saHpiUnsubscribe(sid);
+        saHpiSessionClose(sid);
+
+        return (received == count && disorder == 0) ? 0 : -1;
+}
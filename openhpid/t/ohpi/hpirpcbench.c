@@ -0,0 +1,161 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * RPC latency benchmark.
+ *
+ * Times saHpiDomainInfoGet round trips to the default domain. With -u,
+ * the same daemon is also reached through its Unix domain socket
+ * (openhpid -u) and both transports are compared.
+ * Not part of "make check": build it with "make hpirpcbench".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <sys/time.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+#include <oh_utils.h>
+
+struct bench_result {
+        double total;   /* sec */
+        double avg;     /* usec */
+        double p50;     /* usec */
+        double p99;     /* usec */
+};
+
+static double now_usec(void)
+{
+        struct timeval tv;
+
+        gettimeofday(&tv, NULL);
+        return tv.tv_sec * 1000000.0 + tv.tv_usec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+        double x = *(const double *)a;
+        double y = *(const double *)b;
+
+        return (x > y) - (x < y);
+}
+
+static int run(SaHpiDomainIdT did, unsigned int count,
+               struct bench_result *res)
+{
+        SaErrorT rv;
+        SaHpiSessionIdT sid;
+        SaHpiDomainInfoT info;
+        double *lat, t0, t;
+        unsigned int i;
+
+        rv = saHpiSessionOpen(did, &sid, NULL);
+        if (rv != SA_OK) {
+                printf("saHpiSessionOpen(%u) returns %s\n",
+                       did, oh_lookup_error(rv));
+                return -1;
+        }
+
+        /* The first call pays for connecting */
+        saHpiDomainInfoGet(sid, &info);
+
+        lat = calloc(count, sizeof(double));
+        t0 = now_usec();
+        for (i = 0; i < count; i++) {
+                t = now_usec();
+                rv = saHpiDomainInfoGet(sid, &info);
+                lat[i] = now_usec() - t;
+                if (rv != SA_OK) {
+                        printf("saHpiDomainInfoGet returns %s\n",
+                               oh_lookup_error(rv));
+                        free(lat);
+                        saHpiSessionClose(sid);
+                        return -1;
+                }
+        }
+        res->total = (now_usec() - t0) / 1000000.0;
+        res->avg = res->total * 1000000.0 / count;
+
+        qsort(lat, count, sizeof(double), cmp_double);
+        res->p50 = lat[count / 2];
+        res->p99 = lat[(count * 99) / 100];
+
+        free(lat);
+        saHpiSessionClose(sid);
+
+        return 0;
+}
+
+static void report(const char *name, const struct bench_result *res)
+{
+        printf("%-8s avg %8.1f usec, p50 %8.1f usec, p99 %8.1f usec, "
+               "%.0f calls/sec\n",
+               name, res->avg, res->p50, res->p99,
+               res->avg > 0 ? 1000000.0 / res->avg : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+        SaErrorT rv;
+        SaHpiTextBufferT host;
+        SaHpiEntityPathT root;
+        SaHpiDomainIdT did;
+        struct bench_result tcp, local;
+        unsigned int count = 10000;
+        const char *path = NULL;
+        int c;
+
+        while ((c = getopt(argc, argv, "n:u:")) != EOF) {
+                switch (c) {
+                case 'n': count = atoi(optarg); break;
+                case 'u': path = optarg; break;
+                default:
+                        printf("Usage: %s [-n calls] [-u socket_path]\n",
+                               argv[0]);
+                        printf("  -u  also measure the daemon's "
+                               "Unix domain socket\n");
+                        return 1;
+                }
+        }
+        if (count == 0) {
+                printf("Invalid number of calls\n");
+                return 1;
+        }
+
+        if (run(SAHPI_UNSPECIFIED_DOMAIN_ID, count, &tcp) != 0) {
+                return -1;
+        }
+        printf("%u calls per transport\n", count);
+        report("default", &tcp);
+
+        if (!path) {
+                return 0;
+        }
+
+        oh_init_textbuffer(&host);
+        oh_append_textbuffer(&host, "unix:");
+        oh_append_textbuffer(&host, path);
+        oh_init_ep(&root);
+        rv = oHpiDomainAdd(&host, 0, &root, &did);
+        if (rv != SA_OK) {
+                printf("oHpiDomainAdd returns %s\n", oh_lookup_error(rv));
+                return -1;
+        }
+        if (run(did, count, &local) != 0) {
+                return -1;
+        }
+        report("unix", &local);
+        printf("unix/default latency: %.2f\n", local.avg / tcp.avg);
+
+        return 0;
+}
+
@@ -0,0 +1,117 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+
+/**
+ * Pass null arguments, bogus ids and out of range values to the
+ * statistics and bulk read extensions.
+ * Pass on error, otherwise test failed.
+ **/
+
+int main(int argc, char **argv)
+{
+        SaHpiSessionIdT sid = 0;
+        oHpiSensorCacheStatsT cache_stats;
+        SaHpiEntryIdT next;
+        oHpiHandlerStatsT handler_stats;
+        oHpiDelWriterStatsT del_stats;
+        oHpiEventLimitStatsT limit_stats;
+        oHpiEventQueueStatsT queue_stats;
+        SaHpiEventLogEntryIdT next_entry;
+        oHpiEventLogEntriesT entries;
+
+        /* Unset config file env variable */
+        setenv("OPENHPI_CONF","./noconfig", 1);
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        if (!oHpiSensorCacheStatsGet(sid, 1, NULL))
+                return -1;
+
+        if (!oHpiSensorCacheStatsGet(sid, 0, &cache_stats))
+                return -1;
+
+        if (!oHpiSensorCacheStatsGet(sid, 5555, &cache_stats))
+                return -1;
+
+        if (!oHpiHandlerStatsGet(sid, 1, SAHPI_FIRST_ENTRY, NULL,
+                                 &handler_stats))
+                return -1;
+
+        if (!oHpiHandlerStatsGet(sid, 1, SAHPI_FIRST_ENTRY, &next, NULL))
+                return -1;
+
+        if (!oHpiHandlerStatsGet(sid, 1, SAHPI_LAST_ENTRY, &next,
+                                 &handler_stats))
+                return -1;
+
+        if (!oHpiHandlerStatsGet(sid, 5555, SAHPI_FIRST_ENTRY, &next,
+                                 &handler_stats))
+                return -1;
+
+        if (!oHpiDelWriterStatsGet(sid, NULL))
+                return -1;
+
+        if (!oHpiDelWriterStatsGet(0, &del_stats))
+                return -1;
+
+        if (!oHpiEventLimitStatsGet(sid, 1, NULL))
+                return -1;
+
+        if (!oHpiEventLimitStatsGet(sid, 0, &limit_stats))
+                return -1;
+
+        if (!oHpiEventLimitStatsGet(sid, 5555, &limit_stats))
+                return -1;
+
+        if (!oHpiEventQueueStatsGet(sid, OHPI_EVENT_PRIORITY_HIGH, NULL))
+                return -1;
+
+        if (!oHpiEventQueueStatsGet(0, OHPI_EVENT_PRIORITY_HIGH, &queue_stats))
+                return -1;
+
+        if (!oHpiEventQueueStatsGet(sid, OHPI_EVENT_PRIORITY_LEVELS,
+                                    &queue_stats))
+                return -1;
+
+        if (!oHpiEventLogEntriesGet(sid, SAHPI_UNSPECIFIED_RESOURCE_ID,
+                                    SAHPI_OLDEST_ENTRY, 16,
+                                    SAHPI_FALSE, SAHPI_FALSE, NULL, &entries))
+                return -1;
+
+        if (!oHpiEventLogEntriesGet(sid, SAHPI_UNSPECIFIED_RESOURCE_ID,
+                                    SAHPI_OLDEST_ENTRY, 16,
+                                    SAHPI_FALSE, SAHPI_FALSE, &next_entry, NULL))
+                return -1;
+
+        if (!oHpiEventLogEntriesGet(sid, SAHPI_UNSPECIFIED_RESOURCE_ID,
+                                    SAHPI_OLDEST_ENTRY, 0, SAHPI_FALSE,
+                                    SAHPI_FALSE, &next_entry, &entries))
+                return -1;
+
+        if (!oHpiEventLogEntriesGet(sid, SAHPI_UNSPECIFIED_RESOURCE_ID,
+                                    SAHPI_NO_MORE_ENTRIES, 16, SAHPI_FALSE,
+                                    SAHPI_FALSE, &next_entry, &entries))
+                return -1;
+
+        if (!oHpiEventLogEntriesGet(0, SAHPI_UNSPECIFIED_RESOURCE_ID,
+                                    SAHPI_OLDEST_ENTRY, 16, SAHPI_FALSE,
+                                    SAHPI_FALSE, &next_entry, &entries))
+                return -1;
+
+        return 0;
+}
@@ -0,0 +1,166 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+
+/**
+ * Create a 'libsimulator' handler, read a chassis sensor three times and
+ * inject one good event and one with a bad RDR type.
+ * Walk the handler statistics and check calls and errors of both
+ * functions, and that the histogram accounts for every call.
+ * Pass on success, otherwise test failed.
+ **/
+
+#define CHASSIS_SENSOR 1
+#define SENSOR_READS 3
+
+/* Discovery events are processed in the background, wait for the chassis */
+static SaHpiResourceIdT find_chassis(SaHpiSessionIdT sid)
+{
+        SaHpiEntryIdT id, next;
+        SaHpiRptEntryT rpte;
+        int i;
+
+        for (i = 0; i < 100; i++) {
+                id = SAHPI_FIRST_ENTRY;
+                while (id != SAHPI_LAST_ENTRY &&
+                       saHpiRptEntryGet(sid, id, &next, &rpte) == SA_OK) {
+                        if (rpte.ResourceEntity.Entry[0].EntityType ==
+                            SAHPI_ENT_SYSTEM_CHASSIS)
+                                return rpte.ResourceId;
+                        id = next;
+                }
+                g_usleep(G_USEC_PER_SEC / 10);
+        }
+
+        return 0;
+}
+
+static SaErrorT inject(SaHpiSessionIdT sid, oHpiHandlerIdT hid,
+                       SaHpiRdrTypeT type)
+{
+        SaHpiEventT event;
+        SaHpiRptEntryT rpte;
+        SaHpiRdrT rdr;
+
+        memset(&event, 0, sizeof(event));
+        event.EventType = SAHPI_ET_SENSOR;
+        event.Severity = SAHPI_INFORMATIONAL;
+        event.Timestamp = SAHPI_TIME_UNSPECIFIED;
+        event.EventDataUnion.SensorEvent.SensorNum = CHASSIS_SENSOR;
+        event.EventDataUnion.SensorEvent.SensorType = SAHPI_TEMPERATURE;
+        event.EventDataUnion.SensorEvent.EventCategory = SAHPI_EC_THRESHOLD;
+        event.EventDataUnion.SensorEvent.EventState = SAHPI_ES_UPPER_MINOR;
+
+        memset(&rpte, 0, sizeof(rpte));
+        rpte.ResourceEntity.Entry[0].EntityType = SAHPI_ENT_SYSTEM_BOARD;
+        rpte.ResourceEntity.Entry[0].EntityLocation = 100;
+        rpte.ResourceEntity.Entry[1].EntityType = SAHPI_ENT_ROOT;
+
+        memset(&rdr, 0, sizeof(rdr));
+        rdr.RdrType = type;
+
+        return oHpiInjectEvent(sid, hid, &event, &rpte, &rdr);
+}
+
+static int check_stats(oHpiHandlerStatsT *stats)
+{
+        SaHpiUint64T sum = 0;
+        int i;
+
+        if (!stats->Calls || stats->Errors > stats->Calls ||
+            stats->MaxUsec > stats->TotalUsec)
+                return -1;
+
+        for (i = 0; i < OHPI_HANDLER_STATS_BUCKETS; i++)
+                sum += stats->Histogram[i];
+
+        return sum == stats->Calls ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+        SaHpiSessionIdT sid = 0;
+        GHashTable *config = g_hash_table_new(g_str_hash, g_str_equal);
+        oHpiHandlerIdT hid = 0;
+        SaHpiResourceIdT rid;
+        SaHpiSensorReadingT reading;
+        SaHpiEntryIdT id, next;
+        oHpiHandlerStatsT stats;
+        int found = 0;
+        int i;
+
+        setenv("OPENHPI_CONF","./noconfig", 1);
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        g_hash_table_insert(config, "plugin", "libsimulator");
+        g_hash_table_insert(config, "entity_root", "{SYSTEM_CHASSIS,1}");
+        g_hash_table_insert(config, "name", "test");
+        g_hash_table_insert(config, "addr", "0");
+
+        if (oHpiHandlerCreate(sid, config, &hid))
+                return -1;
+
+        if (saHpiDiscover(sid))
+                return -1;
+
+        rid = find_chassis(sid);
+        if (!rid)
+                return -1;
+
+        for (i = 0; i < SENSOR_READS; i++) {
+                if (saHpiSensorReadingGet(sid, rid, CHASSIS_SENSOR,
+                                          &reading, NULL))
+                        return -1;
+        }
+
+        if (inject(sid, hid, SAHPI_SENSOR_RDR) != SA_OK)
+                return -1;
+        if (inject(sid, hid, SAHPI_NO_RECORD) != SA_ERR_HPI_INVALID_PARAMS)
+                return -1;
+
+        /* Only functions called at least once are listed */
+        id = SAHPI_FIRST_ENTRY;
+        while (id != SAHPI_LAST_ENTRY) {
+                if (oHpiHandlerStatsGet(sid, hid, id, &next, &stats))
+                        return -1;
+                if (check_stats(&stats))
+                        return -1;
+
+                if (!strcmp((char *)stats.Function.Data,
+                            "get_sensor_reading")) {
+                        if (stats.Calls != SENSOR_READS || stats.Errors)
+                                return -1;
+                        found++;
+                } else if (!strcmp((char *)stats.Function.Data,
+                                   "inject_event")) {
+                        if (stats.Calls != 2 || stats.Errors != 1)
+                                return -1;
+                        found++;
+                }
+                id = next;
+        }
+
+        if (found != 2)
+                return -1;
+
+        if (oHpiHandlerDestroy(sid, hid))
+                return -1;
+
+        return 0;
+}
@@ -0,0 +1,147 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+#include <oh_utils.h>
+
+#include "del_writer.h"
+
+/**
+ * Save the domain event log to a temporary directory with a long flush
+ * interval and a batch of four entries. Three entries stay pending,
+ * the fourth one gets the log written, and stopping the writer writes
+ * the entries logged after that.
+ * Pass on success, otherwise test failed.
+ **/
+
+#define FLUSH_BATCH 4
+
+static char varpath[] = "/tmp/ohpi_042.XXXXXX";
+static char delpath[sizeof(varpath) + 8];
+
+static int add_entry(SaHpiSessionIdT sid, int i)
+{
+        SaHpiEventT event;
+
+        memset(&event, 0, sizeof(event));
+        event.Source = SAHPI_UNSPECIFIED_RESOURCE_ID;
+        event.EventType = SAHPI_ET_USER;
+        event.Severity = SAHPI_INFORMATIONAL;
+        event.Timestamp = SAHPI_TIME_UNSPECIFIED;
+        oh_init_textbuffer(&event.EventDataUnion.UserEvent.UserEventData);
+        snprintf((char *)event.EventDataUnion.UserEvent.UserEventData.Data,
+                 SAHPI_MAX_TEXT_BUFFER_LENGTH, "ohpi_042 entry %d", i);
+        event.EventDataUnion.UserEvent.UserEventData.DataLength =
+                strlen((char *)event.EventDataUnion.UserEvent.UserEventData.Data);
+
+        return saHpiEventLogEntryAdd(sid, SAHPI_UNSPECIFIED_RESOURCE_ID,
+                                     &event) ? -1 : 0;
+}
+
+/* Returns the number of entries in the saved log, -1 if there is none */
+static long saved_entries(void)
+{
+        struct stat st;
+
+        if (stat(delpath, &st))
+                return -1;
+        if (st.st_size % sizeof(oh_el_entry))
+                return -2;
+
+        return st.st_size / sizeof(oh_el_entry);
+}
+
+static int run(SaHpiSessionIdT sid)
+{
+        oHpiDelWriterStatsT stats;
+        int i;
+
+        /* Below the batch nothing is written */
+        for (i = 0; i < FLUSH_BATCH - 1; i++) {
+                if (add_entry(sid, i))
+                        return -1;
+        }
+        if (oHpiDelWriterStatsGet(sid, &stats))
+                return -1;
+        if (stats.FlushBatch != FLUSH_BATCH ||
+            stats.Pending != FLUSH_BATCH - 1 || stats.Flushes ||
+            saved_entries() != -1)
+                return -1;
+
+        /* A full batch is written without waiting for the interval */
+        if (add_entry(sid, i++))
+                return -1;
+        for (i = 0; i < 100; i++) {
+                if (oHpiDelWriterStatsGet(sid, &stats))
+                        return -1;
+                if (stats.Written == FLUSH_BATCH)
+                        break;
+                g_usleep(G_USEC_PER_SEC / 100);
+        }
+        if (stats.Written != FLUSH_BATCH || stats.Flushes != 1 ||
+            stats.Pending || stats.Errors ||
+            saved_entries() != FLUSH_BATCH)
+                return -1;
+
+        /* Stopping the writer saves what is still pending */
+        if (add_entry(sid, FLUSH_BATCH) || add_entry(sid, FLUSH_BATCH + 1))
+                return -1;
+        if (oHpiDelWriterStatsGet(sid, &stats))
+                return -1;
+        if (stats.Pending != 2 || saved_entries() != FLUSH_BATCH)
+                return -1;
+
+        oh_del_writer_stop();
+
+        if (oHpiDelWriterStatsGet(sid, &stats))
+                return -1;
+        if (stats.Written != FLUSH_BATCH + 2 || stats.Flushes != 2 ||
+            stats.Pending || stats.Errors ||
+            saved_entries() != FLUSH_BATCH + 2)
+                return -1;
+
+        return 0;
+}
+
+int main(int argc, char **argv)
+{
+        SaHpiSessionIdT sid = 0;
+        int rv;
+
+        if (!mkdtemp(varpath))
+                return -1;
+        snprintf(delpath, sizeof(delpath), "%s/del.%u",
+                 varpath, OH_DEFAULT_DOMAIN_ID);
+
+        setenv("OPENHPI_CONF","./noconfig", 1);
+        setenv("OPENHPI_VARPATH", varpath, 1);
+        setenv("OPENHPI_DEL_SAVE", "YES", 1);
+        setenv("OPENHPI_DEL_FLUSH_INTERVAL", "600000", 1);
+        setenv("OPENHPI_DEL_FLUSH_BATCH", "4", 1);
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                rv = -1;
+        else
+                rv = run(sid);
+
+        unlink(delpath);
+        rmdir(varpath);
+
+        return rv;
+}
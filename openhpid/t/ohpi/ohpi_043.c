@@ -0,0 +1,208 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+
+/**
+ * Create two 'libsimulator' handlers, one coalescing sensor events and
+ * one rate limiting them.
+ * Inject an assert, deassert, assert, deassert sequence for one sensor:
+ * the first event is passed on, the two middle ones are merged away and
+ * the last one is passed on when the window is over.
+ * Inject a burst of sensor events: only as many as the bucket holds are
+ * passed on, the others are dropped.
+ * Pass on success, otherwise test failed.
+ **/
+
+#define COALESCE_WINDOW_MSEC 2000
+#define EVENT_RATE 1
+#define EVENT_BURST 3
+#define BURST_EVENTS 10
+#define WAIT_NSEC 1000000000LL
+
+static GHashTable *new_config(const char *root, const char *name)
+{
+        GHashTable *config = g_hash_table_new(g_str_hash, g_str_equal);
+
+        g_hash_table_insert(config, "plugin", "libsimulator");
+        g_hash_table_insert(config, "entity_root", (gpointer)root);
+        g_hash_table_insert(config, "name", (gpointer)name);
+        g_hash_table_insert(config, "addr", "0");
+
+        return config;
+}
+
+/* Marks the event with mark, so it can be told apart when it comes back */
+static int inject(SaHpiSessionIdT sid, oHpiHandlerIdT hid,
+                  SaHpiUint32T mark, SaHpiBoolT assertion)
+{
+        SaHpiEventT event;
+        SaHpiRptEntryT rpte;
+        SaHpiRdrT rdr;
+
+        memset(&event, 0, sizeof(event));
+        event.EventType = SAHPI_ET_SENSOR;
+        event.Severity = SAHPI_INFORMATIONAL;
+        event.Timestamp = SAHPI_TIME_UNSPECIFIED;
+        event.EventDataUnion.SensorEvent.SensorNum = 1;
+        event.EventDataUnion.SensorEvent.SensorType = SAHPI_TEMPERATURE;
+        event.EventDataUnion.SensorEvent.EventCategory = SAHPI_EC_THRESHOLD;
+        event.EventDataUnion.SensorEvent.Assertion = assertion;
+        event.EventDataUnion.SensorEvent.EventState = SAHPI_ES_UPPER_MINOR;
+        event.EventDataUnion.SensorEvent.SensorSpecific = mark;
+
+        /* The handler derives the source resource from the path */
+        memset(&rpte, 0, sizeof(rpte));
+        rpte.ResourceEntity.Entry[0].EntityType = SAHPI_ENT_SYSTEM_BOARD;
+        rpte.ResourceEntity.Entry[0].EntityLocation = 100;
+        rpte.ResourceEntity.Entry[1].EntityType = SAHPI_ENT_ROOT;
+
+        memset(&rdr, 0, sizeof(rdr));
+        rdr.RdrType = SAHPI_SENSOR_RDR;
+
+        return oHpiInjectEvent(sid, hid, &event, &rpte, &rdr) ? -1 : 0;
+}
+
+/* Returns the mark of the next sensor event, 0 if none came in time */
+static SaHpiUint32T next_mark(SaHpiSessionIdT sid, SaHpiTimeoutT timeout,
+                              SaHpiBoolT *assertion)
+{
+        SaHpiEventT event;
+
+        while (saHpiEventGet(sid, timeout, &event,
+                             NULL, NULL, NULL) == SA_OK) {
+                if (event.EventType != SAHPI_ET_SENSOR)
+                        continue;
+                if (assertion)
+                        *assertion = event.EventDataUnion.SensorEvent.Assertion;
+                return event.EventDataUnion.SensorEvent.SensorSpecific;
+        }
+
+        return 0;
+}
+
+static int test_coalescing(SaHpiSessionIdT sid, oHpiHandlerIdT hid)
+{
+        oHpiEventLimitStatsT stats;
+        SaHpiBoolT assertion;
+        int i;
+
+        if (inject(sid, hid, 1, SAHPI_TRUE) ||
+            inject(sid, hid, 2, SAHPI_FALSE) ||
+            inject(sid, hid, 3, SAHPI_TRUE) ||
+            inject(sid, hid, 4, SAHPI_FALSE))
+                return -1;
+
+        /* Each held event supersedes the one held before it */
+        for (i = 0; i < 100; i++) {
+                if (oHpiEventLimitStatsGet(sid, hid, &stats))
+                        return -1;
+                if (stats.Coalesced == 2)
+                        break;
+                g_usleep(G_USEC_PER_SEC / 100);
+        }
+        if (stats.CoalesceWindowMsec != COALESCE_WINDOW_MSEC ||
+            stats.Coalesced != 2 || stats.Held != 1 || stats.RateLimited)
+                return -1;
+
+        if (next_mark(sid, WAIT_NSEC, NULL) != 1)
+                return -1;
+
+        /* The last event changes the state passed on, so it goes too */
+        if (next_mark(sid, 2 * COALESCE_WINDOW_MSEC / 1000 * WAIT_NSEC,
+                      &assertion) != 4 || assertion != SAHPI_FALSE)
+                return -1;
+
+        if (oHpiEventLimitStatsGet(sid, hid, &stats))
+                return -1;
+        if (stats.Coalesced != 2 || stats.Held)
+                return -1;
+
+        return 0;
+}
+
+static int test_rate(SaHpiSessionIdT sid, oHpiHandlerIdT hid)
+{
+        oHpiEventLimitStatsT stats;
+        SaHpiUint32T mark;
+        int i, received = 0;
+
+        /* Let the bucket refill after the discovery events */
+        g_usleep((EVENT_BURST / EVENT_RATE + 1) * G_USEC_PER_SEC);
+
+        for (i = 0; i < BURST_EVENTS; i++) {
+                if (inject(sid, hid, 100 + i, i % 2 ? SAHPI_FALSE : SAHPI_TRUE))
+                        return -1;
+        }
+
+        while ((mark = next_mark(sid, WAIT_NSEC, NULL)) != 0) {
+                if (mark < 100 || mark >= 100 + BURST_EVENTS)
+                        return -1;
+                received++;
+        }
+
+        if (oHpiEventLimitStatsGet(sid, hid, &stats))
+                return -1;
+        if (stats.Rate != EVENT_RATE || stats.Burst != EVENT_BURST ||
+            stats.Coalesced || stats.Held)
+                return -1;
+        /* A token may have come in while injecting */
+        if (received < EVENT_BURST || received > EVENT_BURST + 1 ||
+            stats.RateLimited != (SaHpiUint64T)(BURST_EVENTS - received))
+                return -1;
+
+        return 0;
+}
+
+int main(int argc, char **argv)
+{
+        SaHpiSessionIdT sid = 0;
+        GHashTable *coalescing, *limited;
+        oHpiHandlerIdT chid = 0, lhid = 0;
+
+        setenv("OPENHPI_CONF","./noconfig", 1);
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        coalescing = new_config("{SYSTEM_CHASSIS,1}", "coalescing");
+        g_hash_table_insert(coalescing, "event_coalesce_window",
+                            G_STRINGIFY(COALESCE_WINDOW_MSEC));
+        limited = new_config("{SYSTEM_CHASSIS,2}", "limited");
+        g_hash_table_insert(limited, "event_rate", G_STRINGIFY(EVENT_RATE));
+        g_hash_table_insert(limited, "event_burst", G_STRINGIFY(EVENT_BURST));
+
+        if (oHpiHandlerCreate(sid, coalescing, &chid) ||
+            oHpiHandlerCreate(sid, limited, &lhid))
+                return -1;
+
+        if (saHpiDiscover(sid))
+                return -1;
+
+        if (saHpiSubscribe(sid))
+                return -1;
+
+        if (test_coalescing(sid, chid))
+                return -1;
+
+        if (test_rate(sid, lhid))
+                return -1;
+
+        if (oHpiHandlerDestroy(sid, chid) || oHpiHandlerDestroy(sid, lhid))
+                return -1;
+
+        return 0;
+}
@@ -0,0 +1,260 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+#include <oh_domain.h>
+
+/**
+ * Run a single event worker and keep it busy by holding the domain.
+ * Meanwhile queue sensor events of resources A and B, a watchdog event
+ * of resource C and a domain event of resource B.
+ * The domain event goes first, with the sensor event of B moved up ahead
+ * of it, then the watchdog event and the sensor event of A last.
+ * Pass on success, otherwise test failed.
+ **/
+
+enum { RES_BLOCKER, RES_A, RES_B, RES_C, NUM_RES };
+
+/* Discovery events are processed in the background, wait for the chassis */
+static SaHpiResourceIdT find_chassis(SaHpiSessionIdT sid)
+{
+        SaHpiEntryIdT id, next;
+        SaHpiRptEntryT rpte;
+        int i;
+
+        for (i = 0; i < 100; i++) {
+                id = SAHPI_FIRST_ENTRY;
+                while (id != SAHPI_LAST_ENTRY &&
+                       saHpiRptEntryGet(sid, id, &next, &rpte) == SA_OK) {
+                        if (rpte.ResourceEntity.Entry[0].EntityType ==
+                            SAHPI_ENT_SYSTEM_CHASSIS)
+                                return rpte.ResourceId;
+                        id = next;
+                }
+                g_usleep(G_USEC_PER_SEC / 10);
+        }
+
+        return 0;
+}
+
+/* Returns the id the handler gave the resource, 0 on error */
+static SaHpiResourceIdT inject(SaHpiSessionIdT sid, oHpiHandlerIdT hid,
+                               SaHpiEventTypeT type, int res)
+{
+        SaHpiEventT event;
+        SaHpiRptEntryT rpte;
+        SaHpiRdrT rdr;
+
+        memset(&event, 0, sizeof(event));
+        event.EventType = type;
+        event.Severity = SAHPI_INFORMATIONAL;
+        event.Timestamp = SAHPI_TIME_UNSPECIFIED;
+        switch (type) {
+        case SAHPI_ET_SENSOR:
+                event.EventDataUnion.SensorEvent.SensorNum = 1;
+                event.EventDataUnion.SensorEvent.SensorType = SAHPI_TEMPERATURE;
+                event.EventDataUnion.SensorEvent.EventCategory = SAHPI_EC_THRESHOLD;
+                event.EventDataUnion.SensorEvent.EventState = SAHPI_ES_UPPER_MINOR;
+                break;
+        case SAHPI_ET_WATCHDOG:
+                event.EventDataUnion.WatchdogEvent.WatchdogNum = 1;
+                event.EventDataUnion.WatchdogEvent.WatchdogAction = SAHPI_WA_NO_ACTION;
+                event.EventDataUnion.WatchdogEvent.WatchdogPreTimerAction = SAHPI_WPI_NONE;
+                event.EventDataUnion.WatchdogEvent.WatchdogUse = SAHPI_WTU_OEM;
+                break;
+        case SAHPI_ET_DOMAIN:
+                event.EventDataUnion.DomainEvent.Type = SAHPI_DOMAIN_REF_ADDED;
+                event.EventDataUnion.DomainEvent.DomainId = OH_DEFAULT_DOMAIN_ID;
+                break;
+        default:
+                return 0;
+        }
+
+        /* The handler derives the source resource from the path */
+        memset(&rpte, 0, sizeof(rpte));
+        rpte.ResourceEntity.Entry[0].EntityType = SAHPI_ENT_SYSTEM_BOARD;
+        rpte.ResourceEntity.Entry[0].EntityLocation = 100 + res;
+        rpte.ResourceEntity.Entry[1].EntityType = SAHPI_ENT_ROOT;
+
+        memset(&rdr, 0, sizeof(rdr));
+        rdr.RdrType = SAHPI_SENSOR_RDR;
+
+        if (oHpiInjectEvent(sid, hid, &event, &rpte, &rdr))
+                return 0;
+
+        return event.Source;
+}
+
+static int get_stats(SaHpiSessionIdT sid,
+                     oHpiEventQueueStatsT stats[OHPI_EVENT_PRIORITY_LEVELS],
+                     SaHpiUint32T *queued)
+{
+        int i;
+
+        *queued = 0;
+        for (i = 0; i < OHPI_EVENT_PRIORITY_LEVELS; i++) {
+                if (oHpiEventQueueStatsGet(sid, i, &stats[i]))
+                        return -1;
+                *queued += stats[i].Queued;
+        }
+
+        return 0;
+}
+
+/* Called with the domain held, so the worker cannot process anything */
+static int queue_events(SaHpiSessionIdT sid, oHpiHandlerIdT hid,
+                        SaHpiResourceIdT rids[NUM_RES],
+                        SaHpiUint64T *promoted)
+{
+        oHpiEventQueueStatsT before[OHPI_EVENT_PRIORITY_LEVELS];
+        oHpiEventQueueStatsT stats[OHPI_EVENT_PRIORITY_LEVELS];
+        SaHpiUint32T queued;
+        int i;
+
+        if (get_stats(sid, before, &queued) || queued)
+                return -1;
+        *promoted = before[OHPI_EVENT_PRIORITY_LOW].Promoted;
+
+        /* The worker takes this one and waits for the domain */
+        rids[RES_BLOCKER] = inject(sid, hid, SAHPI_ET_SENSOR, RES_BLOCKER);
+        if (!rids[RES_BLOCKER])
+                return -1;
+        for (i = 0; i < 100; i++) {
+                if (get_stats(sid, stats, &queued))
+                        return -1;
+                if (stats[OHPI_EVENT_PRIORITY_LOW].Processed >
+                    before[OHPI_EVENT_PRIORITY_LOW].Processed)
+                        break;
+                g_usleep(G_USEC_PER_SEC / 100);
+        }
+        if (stats[OHPI_EVENT_PRIORITY_LOW].Processed !=
+            before[OHPI_EVENT_PRIORITY_LOW].Processed + 1)
+                return -1;
+
+        rids[RES_A] = inject(sid, hid, SAHPI_ET_SENSOR, RES_A);
+        rids[RES_B] = inject(sid, hid, SAHPI_ET_SENSOR, RES_B);
+        rids[RES_C] = inject(sid, hid, SAHPI_ET_WATCHDOG, RES_C);
+        if (!rids[RES_A] || !rids[RES_B] || !rids[RES_C] ||
+            inject(sid, hid, SAHPI_ET_DOMAIN, RES_B) != rids[RES_B])
+                return -1;
+
+        for (i = 0; i < 100; i++) {
+                if (get_stats(sid, stats, &queued))
+                        return -1;
+                if (queued == 4)
+                        break;
+                g_usleep(G_USEC_PER_SEC / 100);
+        }
+        if (queued != 4 ||
+            stats[OHPI_EVENT_PRIORITY_LOW].Queued != 2 ||
+            stats[OHPI_EVENT_PRIORITY_NORMAL].Queued != 1 ||
+            stats[OHPI_EVENT_PRIORITY_HIGH].Queued != 1)
+                return -1;
+
+        return 0;
+}
+
+int main(int argc, char **argv)
+{
+        SaHpiSessionIdT sid = 0;
+        GHashTable *config = g_hash_table_new(g_str_hash, g_str_equal);
+        oHpiHandlerIdT hid = 0;
+        struct oh_domain *d;
+        SaHpiResourceIdT rids[NUM_RES];
+        oHpiEventQueueStatsT stats[OHPI_EVENT_PRIORITY_LEVELS];
+        SaHpiUint32T queued;
+        SaHpiUint64T promoted;
+        SaHpiEventT event;
+        const struct {
+                SaHpiEventTypeT type;
+                int res;
+        } expected[] = {
+                { SAHPI_ET_SENSOR, RES_BLOCKER },
+                { SAHPI_ET_SENSOR, RES_B },
+                { SAHPI_ET_DOMAIN, RES_B },
+                { SAHPI_ET_WATCHDOG, RES_C },
+                { SAHPI_ET_SENSOR, RES_A },
+        };
+        int i, n = 0, rv;
+
+        setenv("OPENHPI_CONF","./noconfig", 1);
+        setenv("OPENHPI_EVT_WORKERS", "1", 1);
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        g_hash_table_insert(config, "plugin", "libsimulator");
+        g_hash_table_insert(config, "entity_root", "{SYSTEM_CHASSIS,1}");
+        g_hash_table_insert(config, "name", "test");
+        g_hash_table_insert(config, "addr", "0");
+
+        if (oHpiHandlerCreate(sid, config, &hid))
+                return -1;
+
+        if (saHpiDiscover(sid))
+                return -1;
+
+        if (!find_chassis(sid))
+                return -1;
+
+        /* Let the rest of the discovery events through */
+        for (i = 0; i < 100; i++) {
+                if (get_stats(sid, stats, &queued))
+                        return -1;
+                if (queued == 0)
+                        break;
+                g_usleep(G_USEC_PER_SEC / 100);
+        }
+
+        if (saHpiSubscribe(sid))
+                return -1;
+
+        d = oh_get_domain(OH_DEFAULT_DOMAIN_ID);
+        if (!d)
+                return -1;
+        rv = queue_events(sid, hid, rids, &promoted);
+        oh_release_domain(d);
+        if (rv)
+                return -1;
+
+        while (n < (int)(sizeof(expected) / sizeof(expected[0])) &&
+               saHpiEventGet(sid, 1000000000LL, &event,
+                             NULL, NULL, NULL) == SA_OK) {
+                for (i = 0; i < NUM_RES; i++) {
+                        if (event.Source == rids[i])
+                                break;
+                }
+                if (i == NUM_RES)
+                        continue;
+                if (event.EventType != expected[n].type ||
+                    i != expected[n].res)
+                        return -1;
+                n++;
+        }
+        if (n != (int)(sizeof(expected) / sizeof(expected[0])))
+                return -1;
+
+        /* Only the sensor event of B was moved up */
+        if (get_stats(sid, stats, &queued))
+                return -1;
+        if (queued || stats[OHPI_EVENT_PRIORITY_LOW].Promoted != promoted + 1)
+                return -1;
+
+        if (oHpiHandlerDestroy(sid, hid))
+                return -1;
+
+        return 0;
+}
@@ -0,0 +1,270 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+#include <oh_plugin.h>
+#include <oh_utils.h>
+
+/**
+ * Read the domain event log in pages of three entries and compare them
+ * with the entries read one by one.
+ * Create a 'libsimulator' handler and make it fail to read one entry of
+ * the chassis event log: the entries before it are returned, and the
+ * failing entry is where the next call starts and gets the error.
+ * Pass on success, otherwise test failed.
+ **/
+
+#define DEL_ENTRIES 7
+#define PAGE_ENTRIES 3
+#define RES_ENTRIES 5
+#define FAILING_ENTRY 2
+
+static SaErrorT (*get_el_entry)(void *hnd, SaHpiResourceIdT id,
+                                SaHpiEventLogEntryIdT current,
+                                SaHpiEventLogEntryIdT *prev,
+                                SaHpiEventLogEntryIdT *next,
+                                SaHpiEventLogEntryT *entry,
+                                SaHpiRdrT *rdr,
+                                SaHpiRptEntryT *rptentry);
+static SaHpiEventLogEntryIdT failing_id;
+
+static SaErrorT failing_get_el_entry(void *hnd, SaHpiResourceIdT id,
+                                     SaHpiEventLogEntryIdT current,
+                                     SaHpiEventLogEntryIdT *prev,
+                                     SaHpiEventLogEntryIdT *next,
+                                     SaHpiEventLogEntryT *entry,
+                                     SaHpiRdrT *rdr,
+                                     SaHpiRptEntryT *rptentry)
+{
+        if (current == failing_id)
+                return SA_ERR_HPI_BUSY;
+
+        return get_el_entry(hnd, id, current, prev, next,
+                            entry, rdr, rptentry);
+}
+
+/* Discovery events are processed in the background, wait for the chassis */
+static SaHpiResourceIdT find_chassis(SaHpiSessionIdT sid)
+{
+        SaHpiEntryIdT id, next;
+        SaHpiRptEntryT rpte;
+        int i;
+
+        for (i = 0; i < 100; i++) {
+                id = SAHPI_FIRST_ENTRY;
+                while (id != SAHPI_LAST_ENTRY &&
+                       saHpiRptEntryGet(sid, id, &next, &rpte) == SA_OK) {
+                        if (rpte.ResourceEntity.Entry[0].EntityType ==
+                            SAHPI_ENT_SYSTEM_CHASSIS)
+                                return rpte.ResourceId;
+                        id = next;
+                }
+                g_usleep(G_USEC_PER_SEC / 10);
+        }
+
+        return 0;
+}
+
+/* Clears the log, adds count entries and returns their ids in ids */
+static int fill_log(SaHpiSessionIdT sid, SaHpiResourceIdT rid,
+                    int count, SaHpiEventLogEntryIdT *ids)
+{
+        SaHpiEventT event;
+        SaHpiEventLogEntryIdT id, prev, next;
+        SaHpiEventLogEntryT entry;
+        SaHpiTextBufferT *data = &event.EventDataUnion.UserEvent.UserEventData;
+        int i;
+
+        if (saHpiEventLogClear(sid, rid))
+                return -1;
+
+        for (i = 0; i < count; i++) {
+                memset(&event, 0, sizeof(event));
+                event.Source = SAHPI_UNSPECIFIED_RESOURCE_ID;
+                event.EventType = SAHPI_ET_USER;
+                event.Severity = SAHPI_INFORMATIONAL;
+                event.Timestamp = SAHPI_TIME_UNSPECIFIED;
+                oh_init_textbuffer(data);
+                snprintf((char *)data->Data, SAHPI_MAX_TEXT_BUFFER_LENGTH,
+                         "ohpi_045 entry %d", i);
+                data->DataLength = strlen((char *)data->Data);
+                if (saHpiEventLogEntryAdd(sid, rid, &event))
+                        return -1;
+        }
+
+        id = SAHPI_OLDEST_ENTRY;
+        for (i = 0; id != SAHPI_NO_MORE_ENTRIES; i++) {
+                if (i == count ||
+                    saHpiEventLogEntryGet(sid, rid, id, &prev, &next,
+                                          &entry, NULL, NULL))
+                        return -1;
+                ids[i] = entry.EntryId;
+                id = next;
+        }
+
+        return i == count ? 0 : -1;
+}
+
+/* Checks the returned entries are ids[first..first+count) */
+static int check_entries(oHpiEventLogEntriesT *entries,
+                         SaHpiEventLogEntryIdT *ids, int first, int count)
+{
+        int i;
+
+        if (entries->NumberOfEntries != (SaHpiUint32T)count)
+                return -1;
+        for (i = 0; i < count; i++) {
+                if (entries->Entries[i].EntryId != ids[first + i])
+                        return -1;
+        }
+
+        return 0;
+}
+
+static void free_entries(oHpiEventLogEntriesT *entries)
+{
+        g_free(entries->Entries);
+        g_free(entries->Rdrs);
+        g_free(entries->RptEntries);
+}
+
+static int test_paging(SaHpiSessionIdT sid)
+{
+        SaHpiEventLogEntryIdT ids[DEL_ENTRIES];
+        SaHpiEventLogEntryIdT id, next;
+        oHpiEventLogEntriesT entries;
+        int first = 0, rv;
+
+        if (fill_log(sid, SAHPI_UNSPECIFIED_RESOURCE_ID, DEL_ENTRIES, ids))
+                return -1;
+
+        id = SAHPI_OLDEST_ENTRY;
+        while (id != SAHPI_NO_MORE_ENTRIES) {
+                if (oHpiEventLogEntriesGet(sid, SAHPI_UNSPECIFIED_RESOURCE_ID,
+                                           id, PAGE_ENTRIES,
+                                           SAHPI_TRUE, SAHPI_TRUE,
+                                           &next, &entries))
+                        return -1;
+                rv = check_entries(&entries, ids, first,
+                                   MIN(PAGE_ENTRIES, DEL_ENTRIES - first));
+                if (entries.NumberOfRdrs != entries.NumberOfEntries ||
+                    entries.NumberOfRptEntries != entries.NumberOfEntries)
+                        rv = -1;
+                first += entries.NumberOfEntries;
+                free_entries(&entries);
+                if (rv)
+                        return -1;
+                id = next;
+        }
+
+        return first == DEL_ENTRIES ? 0 : -1;
+}
+
+static int test_failure(SaHpiSessionIdT sid, oHpiHandlerIdT hid,
+                        SaHpiResourceIdT rid)
+{
+        SaHpiEventLogEntryIdT ids[RES_ENTRIES];
+        SaHpiEventLogEntryIdT next;
+        oHpiEventLogEntriesT entries;
+        struct oh_handler *h;
+        SaErrorT error;
+        int rv;
+
+        if (fill_log(sid, rid, RES_ENTRIES, ids))
+                return -1;
+
+        h = oh_get_handler(hid);
+        if (!h)
+                return -1;
+        get_el_entry = h->abi->get_el_entry;
+        h->abi->get_el_entry = failing_get_el_entry;
+        oh_release_handler(h);
+        failing_id = ids[FAILING_ENTRY];
+
+        /* The entries read before the failure are returned */
+        if (oHpiEventLogEntriesGet(sid, rid, SAHPI_OLDEST_ENTRY, RES_ENTRIES,
+                                   SAHPI_FALSE, SAHPI_FALSE, &next, &entries))
+                return -1;
+        rv = check_entries(&entries, ids, 0, FAILING_ENTRY);
+        free_entries(&entries);
+        if (rv || next != failing_id)
+                return -1;
+
+        /* Starting at the failing entry returns the error */
+        error = oHpiEventLogEntriesGet(sid, rid, next, RES_ENTRIES,
+                                       SAHPI_FALSE, SAHPI_FALSE,
+                                       &next, &entries);
+        if (error != SA_ERR_HPI_BUSY || entries.Entries)
+                return -1;
+
+        h = oh_get_handler(hid);
+        if (!h)
+                return -1;
+        h->abi->get_el_entry = get_el_entry;
+        oh_release_handler(h);
+
+        /* And the rest can be read once the entry can be read again */
+        if (oHpiEventLogEntriesGet(sid, rid, failing_id, RES_ENTRIES,
+                                   SAHPI_FALSE, SAHPI_FALSE, &next, &entries))
+                return -1;
+        rv = check_entries(&entries, ids, FAILING_ENTRY,
+                           RES_ENTRIES - FAILING_ENTRY);
+        free_entries(&entries);
+        if (rv || next != SAHPI_NO_MORE_ENTRIES)
+                return -1;
+
+        return 0;
+}
+
+int main(int argc, char **argv)
+{
+        SaHpiSessionIdT sid = 0;
+        GHashTable *config = g_hash_table_new(g_str_hash, g_str_equal);
+        oHpiHandlerIdT hid = 0;
+        SaHpiResourceIdT rid;
+
+        setenv("OPENHPI_CONF","./noconfig", 1);
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        if (test_paging(sid))
+                return -1;
+
+        g_hash_table_insert(config, "plugin", "libsimulator");
+        g_hash_table_insert(config, "entity_root", "{SYSTEM_CHASSIS,1}");
+        g_hash_table_insert(config, "name", "test");
+        g_hash_table_insert(config, "addr", "0");
+
+        if (oHpiHandlerCreate(sid, config, &hid))
+                return -1;
+
+        if (saHpiDiscover(sid))
+                return -1;
+
+        rid = find_chassis(sid);
+        if (!rid)
+                return -1;
+
+        if (test_failure(sid, hid, rid))
+                return -1;
+
+        if (oHpiHandlerDestroy(sid, hid))
+                return -1;
+
+        return 0;
+}
@@ -0,0 +1,206 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+#include <sahpi_wrappers.h>
+
+#include "sensor_cache.h"
+
+/**
+ * Create a 'libsimulator' handler with a sensor reading cache and read
+ * a chassis sensor: the first read misses, the next one is a hit, and
+ * once the TTL is over the sensor is read again.
+ * Start a read of the sensor by hand and read it from another thread
+ * meanwhile: that read waits and returns the first read's result.
+ * Pass on success, otherwise test failed.
+ **/
+
+#define CACHE_TTL_MSEC "500"
+#define CHASSIS_SENSOR 1
+
+struct reader {
+        SaHpiSessionIdT sid;
+        SaHpiResourceIdT rid;
+        SaErrorT rv;
+        SaHpiSensorReadingT reading;
+};
+
+static gpointer read_sensor(gpointer data)
+{
+        struct reader *r = data;
+
+        r->rv = saHpiSensorReadingGet(r->sid, r->rid, CHASSIS_SENSOR,
+                                      &r->reading, NULL);
+        return NULL;
+}
+
+/* Discovery events are processed in the background, wait for the chassis */
+static SaHpiResourceIdT find_chassis(SaHpiSessionIdT sid)
+{
+        SaHpiEntryIdT id, next;
+        SaHpiRptEntryT rpte;
+        int i;
+
+        for (i = 0; i < 100; i++) {
+                id = SAHPI_FIRST_ENTRY;
+                while (id != SAHPI_LAST_ENTRY &&
+                       saHpiRptEntryGet(sid, id, &next, &rpte) == SA_OK) {
+                        if (rpte.ResourceEntity.Entry[0].EntityType ==
+                            SAHPI_ENT_SYSTEM_CHASSIS)
+                                return rpte.ResourceId;
+                        id = next;
+                }
+                g_usleep(G_USEC_PER_SEC / 10);
+        }
+
+        return 0;
+}
+
+static int read_float(SaHpiSessionIdT sid, SaHpiResourceIdT rid,
+                      SaHpiFloat64T *value)
+{
+        SaHpiSensorReadingT reading;
+
+        if (saHpiSensorReadingGet(sid, rid, CHASSIS_SENSOR, &reading, NULL))
+                return -1;
+        if (!reading.IsSupported ||
+            reading.Type != SAHPI_SENSOR_READING_TYPE_FLOAT64)
+                return -1;
+        *value = reading.Value.SensorFloat64;
+
+        return 0;
+}
+
+int main(int argc, char **argv)
+{
+        SaHpiSessionIdT sid = 0;
+        GHashTable *config = g_hash_table_new(g_str_hash, g_str_equal);
+        oHpiHandlerIdT hid = 0;
+        SaHpiResourceIdT rid;
+        oHpiSensorCacheStatsT stats;
+        struct oh_sensor_cache_ticket ticket;
+        SaHpiSensorReadingT reading;
+        SaHpiEventStateT state;
+        SaErrorT rv;
+        SaHpiFloat64T value, cached;
+        struct reader r;
+        GThread *thread;
+        int i;
+
+        setenv("OPENHPI_CONF","./noconfig", 1);
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        g_hash_table_insert(config, "plugin", "libsimulator");
+        g_hash_table_insert(config, "entity_root", "{SYSTEM_CHASSIS,1}");
+        g_hash_table_insert(config, "name", "test");
+        g_hash_table_insert(config, "addr", "0");
+        g_hash_table_insert(config, "sensor_cache_ttl", CACHE_TTL_MSEC);
+
+        if (oHpiHandlerCreate(sid, config, &hid))
+                return -1;
+
+        if (saHpiDiscover(sid))
+                return -1;
+
+        rid = find_chassis(sid);
+        if (!rid)
+                return -1;
+
+        if (oHpiSensorCacheStatsGet(sid, hid, &stats))
+                return -1;
+        if (stats.TtlMsec != (SaHpiUint32T)atoi(CACHE_TTL_MSEC) ||
+            stats.Hits || stats.Misses)
+                return -1;
+
+        /* First read goes to the plugin, the second one does not */
+        if (read_float(sid, rid, &value) || read_float(sid, rid, &cached))
+                return -1;
+        if (cached != value)
+                return -1;
+        if (oHpiSensorCacheStatsGet(sid, hid, &stats))
+                return -1;
+        if (stats.Entries != 1 || stats.Misses != 1 || stats.Hits != 1)
+                return -1;
+
+        /* Expired readings are read again */
+        g_usleep(2 * atoi(CACHE_TTL_MSEC) * 1000);
+        if (read_float(sid, rid, &value))
+                return -1;
+        if (oHpiSensorCacheStatsGet(sid, hid, &stats))
+                return -1;
+        if (stats.Misses != 2 || stats.Hits != 1)
+                return -1;
+
+        /* Start a read by hand, as a slow session would */
+        oh_sensor_cache_invalidate(hid, rid, CHASSIS_SENSOR);
+        memset(&ticket, 0, sizeof(ticket));
+        ticket.hid = hid;
+        ticket.rid = rid;
+        ticket.num = CHASSIS_SENSOR;
+        if (oh_sensor_cache_begin(&ticket, &reading, &state, &rv) !=
+            OH_SENSOR_CACHE_FETCH)
+                return -1;
+
+        memset(&r, 0, sizeof(r));
+        r.sid = sid;
+        r.rid = rid;
+        thread = wrap_g_thread_create_new("ohpi_046", read_sensor,
+                                          &r, TRUE, 0);
+        if (!thread)
+                return -1;
+
+        /* The other read must wait for ours */
+        for (i = 0; i < 100; i++) {
+                if (oHpiSensorCacheStatsGet(sid, hid, &stats))
+                        return -1;
+                if (stats.Coalesced == 1)
+                        break;
+                g_usleep(G_USEC_PER_SEC / 100);
+        }
+        if (stats.Coalesced != 1 || stats.Misses != 3 ||
+            stats.Invalidations != 1)
+                return -1;
+
+        /* A value the plugin never returns shows where the result came from */
+        memset(&reading, 0, sizeof(reading));
+        reading.IsSupported = SAHPI_TRUE;
+        reading.Type = SAHPI_SENSOR_READING_TYPE_FLOAT64;
+        reading.Value.SensorFloat64 = value + 1000;
+        state = SAHPI_ES_UNSPECIFIED;
+        oh_sensor_cache_end(&ticket, SA_OK, &reading, &state);
+        g_thread_join(thread);
+
+        if (r.rv != SA_OK ||
+            r.reading.Value.SensorFloat64 != value + 1000)
+                return -1;
+
+        /* And it is cached for the following reads */
+        if (read_float(sid, rid, &cached))
+                return -1;
+        if (cached != value + 1000)
+                return -1;
+        if (oHpiSensorCacheStatsGet(sid, hid, &stats))
+                return -1;
+        if (stats.Misses != 3 || stats.Hits != 2 || stats.Coalesced != 1)
+                return -1;
+
+        if (oHpiHandlerDestroy(sid, hid))
+                return -1;
+
+        return 0;
+}
@@ -0,0 +1,281 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright The OpenHPI Project 2026
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <SaHpi.h>
+#include <oHpi.h>
+#include <oh_utils.h>
+
+#include "alarm.h"
+
+/**
+ * Save the alarm table to a temporary directory. Each run of the daemon
+ * is a child process that exits without shutting down.
+ * The first run adds, acknowledges and deletes alarms, and the second
+ * one must replay the same table from the journal, except for the last
+ * record that was cut in half meanwhile. Its changes must be written
+ * after a fresh snapshot, and stopping the writer leaves only the live
+ * alarms in the snapshot. The last run loads that snapshot.
+ * Pass on success, otherwise test failed.
+ **/
+
+#define JOURNAL_RECORDS 6
+
+static char varpath[] = "/tmp/ohpi_047.XXXXXX";
+static char datpath[sizeof(varpath) + 8];
+static char journalpath[sizeof(varpath) + 16];
+
+struct expected_alarm {
+        const char *label;
+        SaHpiBoolT acked;
+};
+
+static long file_size(const char *path)
+{
+        struct stat st;
+
+        if (stat(path, &st))
+                return -1;
+
+        return st.st_size;
+}
+
+static int is_alarm(const SaHpiAlarmT *alarm, const char *label)
+{
+        return alarm->AlarmCond.Data.DataLength == strlen(label) &&
+               !memcmp(alarm->AlarmCond.Data.Data, label, strlen(label));
+}
+
+static SaHpiAlarmIdT add_alarm(SaHpiSessionIdT sid, const char *label)
+{
+        SaHpiAlarmT alarm;
+
+        memset(&alarm, 0, sizeof(alarm));
+        alarm.Severity = SAHPI_MINOR;
+        alarm.AlarmCond.Type = SAHPI_STATUS_COND_TYPE_USER;
+        oh_init_textbuffer(&alarm.AlarmCond.Data);
+        oh_append_textbuffer(&alarm.AlarmCond.Data, label);
+
+        if (saHpiAlarmAdd(sid, &alarm))
+                return 0;
+
+        return alarm.AlarmId;
+}
+
+static SaHpiAlarmIdT find_alarm(SaHpiSessionIdT sid, const char *label)
+{
+        SaHpiAlarmT alarm;
+
+        alarm.AlarmId = SAHPI_FIRST_ENTRY;
+        while (saHpiAlarmGetNext(sid, SAHPI_ALL_SEVERITIES,
+                                 SAHPI_FALSE, &alarm) == SA_OK) {
+                if (is_alarm(&alarm, label))
+                        return alarm.AlarmId;
+        }
+
+        return 0;
+}
+
+/* Checks the alarms hold exactly the expected ones */
+static int check_alarms(const SaHpiAlarmT *alarms, int count,
+                        const struct expected_alarm *expected, int n)
+{
+        int i, j;
+
+        if (count != n)
+                return -1;
+        for (i = 0; i < n; i++) {
+                for (j = 0; j < count; j++) {
+                        if (is_alarm(&alarms[j], expected[i].label))
+                                break;
+                }
+                if (j == count || alarms[j].Acknowledged != expected[i].acked)
+                        return -1;
+        }
+
+        return 0;
+}
+
+static int check_table(SaHpiSessionIdT sid,
+                       const struct expected_alarm *expected, int n)
+{
+        SaHpiAlarmT alarms[8];
+        SaHpiAlarmT alarm;
+        int count = 0;
+
+        alarm.AlarmId = SAHPI_FIRST_ENTRY;
+        while (saHpiAlarmGetNext(sid, SAHPI_ALL_SEVERITIES,
+                                 SAHPI_FALSE, &alarm) == SA_OK) {
+                if (count == 8)
+                        return -1;
+                alarms[count++] = alarm;
+        }
+
+        return check_alarms(alarms, count, expected, n);
+}
+
+static int check_snapshot(const struct expected_alarm *expected, int n)
+{
+        SaHpiAlarmT alarms[8];
+        FILE *fp;
+        int count;
+
+        fp = fopen(datpath, "rb");
+        if (!fp)
+                return -1;
+        count = fread(alarms, sizeof(SaHpiAlarmT), 8, fp);
+        fclose(fp);
+
+        return check_alarms(alarms, count, expected, n);
+}
+
+/* The writer appends queued changes once a second */
+static long wait_journal(void)
+{
+        g_usleep(2 * G_USEC_PER_SEC);
+
+        return file_size(journalpath);
+}
+
+static int first_run(long record)
+{
+        SaHpiSessionIdT sid = 0;
+        SaHpiAlarmIdT a2, a3;
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        if (!add_alarm(sid, "A1"))
+                return -1;
+        a2 = add_alarm(sid, "A2");
+        a3 = add_alarm(sid, "A3");
+        if (!a2 || !a3)
+                return -1;
+        if (saHpiAlarmAcknowledge(sid, a2, SAHPI_MINOR) ||
+            saHpiAlarmDelete(sid, a3, SAHPI_MINOR))
+                return -1;
+        if (!add_alarm(sid, "A4"))
+                return -1;
+
+        return wait_journal() > 0 ? 0 : -1;
+}
+
+static int second_run(long record)
+{
+        const struct expected_alarm replayed[] = {
+                { "A1", SAHPI_FALSE }, { "A2", SAHPI_TRUE },
+        };
+        const struct expected_alarm live[] = {
+                { "A2", SAHPI_TRUE }, { "A5", SAHPI_FALSE },
+        };
+        SaHpiSessionIdT sid = 0;
+        SaHpiAlarmIdT a1;
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        /* A3 was deleted, the torn record of A4 is ignored */
+        if (check_table(sid, replayed, 2))
+                return -1;
+
+        a1 = find_alarm(sid, "A1");
+        if (!a1 || saHpiAlarmDelete(sid, a1, SAHPI_MINOR) ||
+            !add_alarm(sid, "A5"))
+                return -1;
+
+        /* The torn journal is replaced by a snapshot before appending */
+        if (wait_journal() != 2 * record)
+                return -1;
+
+        /* Stopping the writer folds the journal into the snapshot */
+        oh_alarm_writer_stop();
+        if (file_size(journalpath) != 0 ||
+            file_size(datpath) != 2 * (long)sizeof(SaHpiAlarmT))
+                return -1;
+
+        return check_snapshot(live, 2);
+}
+
+static int run_child(int (*run)(long), long record)
+{
+        pid_t pid;
+        int status;
+
+        pid = fork();
+        if (pid < 0)
+                return -1;
+        if (pid == 0)
+                _exit(run(record) ? 1 : 0);
+        if (waitpid(pid, &status, 0) != pid)
+                return -1;
+
+        return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : -1;
+}
+
+static int run(void)
+{
+        const struct expected_alarm live[] = {
+                { "A2", SAHPI_TRUE }, { "A5", SAHPI_FALSE },
+        };
+        SaHpiSessionIdT sid = 0;
+        long size, record;
+
+        if (run_child(first_run, 0))
+                return -1;
+
+        /* Cut the last record in half, as a crash while writing would */
+        size = file_size(journalpath);
+        if (size <= 0 || size % JOURNAL_RECORDS)
+                return -1;
+        record = size / JOURNAL_RECORDS;
+        if (truncate(journalpath, size - record / 2))
+                return -1;
+
+        if (run_child(second_run, record))
+                return -1;
+
+        if (saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &sid, NULL))
+                return -1;
+
+        return check_table(sid, live, 2);
+}
+
+int main(int argc, char **argv)
+{
+        int rv;
+
+        if (!mkdtemp(varpath))
+                return -1;
+        snprintf(datpath, sizeof(datpath), "%s/dat.%u",
+                 varpath, OH_DEFAULT_DOMAIN_ID);
+        snprintf(journalpath, sizeof(journalpath), "%s.journal", datpath);
+
+        /* The daemon runs in the children first, keep it out of here */
+        setenv("OPENHPI_CONF","./noconfig", 1);
+        setenv("OPENHPI_VARPATH", varpath, 1);
+        setenv("OPENHPI_DAT_SAVE", "YES", 1);
+
+        rv = run();
+
+        unlink(journalpath);
+        unlink(datpath);
+        rmdir(varpath);
+
+        return rv;
+}
@@ -17,6 +17,8 @@
 #include <oh_error.h>
 #include <oh_plugin.h>
 
+#include "alarm.h"
+#include "del_writer.h"
 #include "event.h"
 #include "threaded.h"
 #include "sahpi_wrappers.h"
@@ -150,6 +152,12 @@ int oh_threaded_start()
 
         signal_stop = FALSE;
 
+        DBG("Starting alarm table writer thread.");
+        oh_alarm_writer_start();
+
+        DBG("Starting event log writer thread.");
+        oh_del_writer_start();
+
         DBG("Starting discovery thread.");
         discovery_cond = wrap_g_cond_new_init();
         discovery_lock = wrap_g_mutex_new_init();
@@ -210,6 +218,10 @@ int oh_threaded_stop(void)
         discovery_thread = 0;
         discovery_lock   = 0;
 
+        /* Last, so that changes made while stopping are flushed */
+        oh_del_writer_stop();
+        oh_alarm_writer_stop();
+
         started = FALSE;
 
         return 0;
@@ -4164,6 +4164,8 @@ bool NewSimulator::GetParams( GHashTable *handler_config ) {
  * Interface Open. The parameters entity root and filename are read from 
  * the hash table and it is tried to open the file by generating a new 
  * NewSimulatorFile object and calling NewSimulatorFile::Open().\n
+ * If the optional parameter snapshot is set, a simulation file in the text
+ * format is converted into this binary snapshot after it was parsed.\n
  * The Initializiation itself is done inside NewSimulatorDomain::Init() which is 
  * called inside this method.
  * 
@@ -4199,6 +4201,11 @@ bool NewSimulator::IfOpen( GHashTable *handler_config ) {
       return false;
    }
 
+   const char *snapshot = (const char *)g_hash_table_lookup( handler_config, "snapshot" );
+
+   if ( snapshot && !simfile->IsSnapshot() )
+      simfile->SetSnapshotFile( snapshot );
+
    bool rv = simfile->Open();
    
    if ( rv == false ) {
@@ -151,6 +151,30 @@ void NewSimulatorAnnunciator::SetData( SaHpiAnnunciatorRecT ann_data ) {
 }
 
 
+/**
+ * Add the mode and the announcements to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the annunciator was added before
+ * @return success
+ **/
+bool NewSimulatorAnnunciator::WriteSnapshot( SimSnapshotWriterT *writer ) {
+   SimSnapshotAnnunciatorT data;
+   
+   data.Mode = m_mode;
+   if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_ANN_MODE,
+                                 &data, sizeof( data ) ) != SA_OK )
+      return false;
+
+   for ( int i = 0; i < m_anns.Num(); i++ ) {
+      if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_ANNOUNCEMENT, &m_anns[i]->AnnRec(),
+                                    sizeof( SaHpiAnnouncementT ) ) != SA_OK )
+         return false;
+   }
+
+   return true;
+}
+
+
 // Official HPI functions
  
  /**
@@ -72,6 +72,7 @@ public:
   bool AddAnnouncement( NewSimulatorAnnouncement *ann );
   // create an RDR sensor record
   virtual bool CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr );
+  virtual bool WriteSnapshot( SimSnapshotWriterT *writer );
   virtual void SetData( SaHpiAnnunciatorRecT ann_data );
   
   // Official HPI functions
@@ -77,6 +77,27 @@ bool NewSimulatorControl::CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr )
 }
 
 
+/**
+ * Add the mode and the state of the control to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the control was added before
+ * @param state state of the control
+ * 
+ * @return success
+ **/
+bool NewSimulatorControl::WriteControlSnapshot( SimSnapshotWriterT *writer,
+                                                const SaHpiCtrlStateT &state ) {
+   SimSnapshotControlT data;
+   
+   memset( &data, 0, sizeof( SimSnapshotControlT ));
+   data.Mode = m_ctrl_mode;
+   memcpy( &data.State, &state, sizeof( SaHpiCtrlStateT ));
+   
+   return ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_CONTROL,
+                                     &data, sizeof( data ) ) == SA_OK );
+}
+
+
 /**
  * HPI function saHpiControlTypeGet()
  * 
@@ -59,6 +59,8 @@ protected:
    /// mode of the control
    SaHpiCtrlModeT       m_ctrl_mode;
 
+   bool WriteControlSnapshot( SimSnapshotWriterT *writer, const SaHpiCtrlStateT &state );
+
 public:
   NewSimulatorControl( NewSimulatorResource *res,
                        SaHpiRdrT rdr,
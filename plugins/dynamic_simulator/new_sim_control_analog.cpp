@@ -63,6 +63,24 @@ bool NewSimulatorControlAnalog::CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &
 }
 
 
+/**
+ * Add the mode and the state of the control to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the control was added before
+ * 
+ * @return success
+ **/
+bool NewSimulatorControlAnalog::WriteSnapshot( SimSnapshotWriterT *writer ) {
+   SaHpiCtrlStateT state;
+   
+   memset( &state, 0, sizeof( SaHpiCtrlStateT ));
+   state.Type = SAHPI_CTRL_TYPE_ANALOG;
+   memcpy( &state.StateUnion.Analog, &m_state, sizeof( SaHpiCtrlStateAnalogT ));
+   
+   return WriteControlSnapshot( writer, state );
+}
+
+
 /**
  * HPI function saHpiControlGet()
  * 
@@ -57,6 +57,7 @@ public:
 
   // create an RDR sensor record
   virtual bool CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr );
+  virtual bool WriteSnapshot( SimSnapshotWriterT *writer );
 
   virtual SaErrorT SetState( const SaHpiCtrlModeT &mode, const SaHpiCtrlStateT &state );
   virtual SaErrorT GetState( SaHpiCtrlModeT &mode, SaHpiCtrlStateT &state );
@@ -63,6 +63,24 @@ bool NewSimulatorControlDigital::CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT
 }
 
 
+/**
+ * Add the mode and the state of the control to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the control was added before
+ * 
+ * @return success
+ **/
+bool NewSimulatorControlDigital::WriteSnapshot( SimSnapshotWriterT *writer ) {
+   SaHpiCtrlStateT state;
+   
+   memset( &state, 0, sizeof( SaHpiCtrlStateT ));
+   state.Type = SAHPI_CTRL_TYPE_DIGITAL;
+   memcpy( &state.StateUnion.Digital, &m_state, sizeof( SaHpiCtrlStateDigitalT ));
+   
+   return WriteControlSnapshot( writer, state );
+}
+
+
 /**
  * HPI function saHpiControlGet()
  * 
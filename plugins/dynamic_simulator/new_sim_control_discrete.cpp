@@ -63,6 +63,24 @@ bool NewSimulatorControlDiscrete::CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT
 }
 
 
+/**
+ * Add the mode and the state of the control to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the control was added before
+ * 
+ * @return success
+ **/
+bool NewSimulatorControlDiscrete::WriteSnapshot( SimSnapshotWriterT *writer ) {
+   SaHpiCtrlStateT state;
+   
+   memset( &state, 0, sizeof( SaHpiCtrlStateT ));
+   state.Type = SAHPI_CTRL_TYPE_DISCRETE;
+   memcpy( &state.StateUnion.Discrete, &m_state, sizeof( SaHpiCtrlStateDiscreteT ));
+   
+   return WriteControlSnapshot( writer, state );
+}
+
+
 /**
  * HPI function saHpiControlGet()
  * 
@@ -63,6 +63,24 @@ bool NewSimulatorControlOem::CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr
 }
 
 
+/**
+ * Add the mode and the state of the control to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the control was added before
+ * 
+ * @return success
+ **/
+bool NewSimulatorControlOem::WriteSnapshot( SimSnapshotWriterT *writer ) {
+   SaHpiCtrlStateT state;
+   
+   memset( &state, 0, sizeof( SaHpiCtrlStateT ));
+   state.Type = SAHPI_CTRL_TYPE_OEM;
+   memcpy( &state.StateUnion.Oem, &m_state, sizeof( SaHpiCtrlStateOemT ));
+   
+   return WriteControlSnapshot( writer, state );
+}
+
+
 /**
  * HPI function saHpiControlGet()
  * 
@@ -131,6 +131,27 @@ bool NewSimulatorDimi::SetInfo( SaHpiDimiInfoT info ) {
 }
 
 
+/**
+ * Add the dimi information and all tests to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the dimi was added before
+ * @return success
+ **/
+bool NewSimulatorDimi::WriteSnapshot( SimSnapshotWriterT *writer ) {
+
+   if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_DIMI_INFO, &m_dimi_info,
+                                 sizeof( SaHpiDimiInfoT ) ) != SA_OK )
+      return false;
+
+   for ( int i = 0; i < m_tests.Num(); i++ ) {
+      if ( !m_tests[i]->WriteSnapshot( writer ) )
+         return false;
+   }
+
+   return true;
+}
+
+
 /**
  * Find a test by id
  * 
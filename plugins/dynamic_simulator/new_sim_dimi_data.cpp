@@ -116,6 +116,26 @@ bool NewSimulatorDimiTest::SetResults( SaHpiDimiTestResultsT results ) {
 }
 
 
+/**
+ * Add the test case data to a snapshot
+ * 
+ * @param writer snapshot writer
+ * @return success
+ **/
+bool NewSimulatorDimiTest::WriteSnapshot( SimSnapshotWriterT *writer ) {
+   SimSnapshotDimiTestT data;
+   
+   memset( &data, 0, sizeof( SimSnapshotDimiTestT ));
+   memcpy( &data.Info, &m_info, sizeof( SaHpiDimiTestT ));
+   data.Ready = m_ready;
+   data.HasResults = ( m_status != SAHPI_DIMITEST_STATUS_NOT_RUN ) ? SAHPI_TRUE : SAHPI_FALSE;
+   memcpy( &data.Results, &m_results, sizeof( SaHpiDimiTestResultsT ));
+   
+   return ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_DIMI_TEST,
+                                     &data, sizeof( data ) ) == SA_OK );
+}
+
+
 /**
  * Test if a test case is running
  * 
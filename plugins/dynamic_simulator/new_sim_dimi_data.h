@@ -63,6 +63,7 @@ class NewSimulatorDimiTest {
    bool SetData( SaHpiDimiTestT info );
    bool SetReadiness( SaHpiDimiReadyT ready );
    bool SetResults( SaHpiDimiTestResultsT results );
+   bool WriteSnapshot( SimSnapshotWriterT *writer );
    
    bool IsRunning();
    
@@ -80,6 +80,18 @@ bool NewSimulatorDomain::Init( NewSimulatorFile *file ) {
 
    m_did = 0;
 
+   // start the generators of sensor readings
+   for( int i = 0; i < m_resources.Num(); i++ ) {
+      NewSimulatorResource *res = m_resources[i];
+      
+      for( int j = 0; j < res->NumRdr(); j++ ) {
+         NewSimulatorRdr *rdr = res->GetRdr( j );
+         
+         if ( rdr->Type() == SAHPI_SENSOR_RDR )
+            ((NewSimulatorSensor *) rdr)->StartGenerator();
+      }
+   }
+
    stdlog << "Domain ID " << m_did << "\n";
    Dump( stdlog );
    
@@ -105,6 +117,8 @@ void NewSimulatorDomain::Cleanup() {
       CleanupResource( res );
    }
 
+   // all timers are stopped
+   m_timer_service.Shutdown();
 }
 
 
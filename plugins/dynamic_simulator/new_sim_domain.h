@@ -84,6 +84,10 @@ extern "C" {
 #include "new_sim_dimi.h"
 #endif
 
+#ifndef __NEW_SIM_TIMER_SERVICE_H__
+#include "new_sim_timer_service.h"
+#endif
+
 /**
  * @class NewSimulatorDomain
  * 
@@ -131,6 +135,8 @@ public:
   void SetRunningWdt( bool flag ) { m_running_wdt = flag; }
   /// set running fumi flag
   void SetRunningFumi( bool flag ) { m_running_fumi = flag; }
+  /// return the service which runs the watchdog and hotswap timers
+  NewSimulatorTimerService *TimerService() { return &m_timer_service; }
 
 protected:
   /// Major version 
@@ -139,6 +145,8 @@ protected:
   unsigned int  m_minor_version;
   
 protected:
+  /// runs all timers of the domain, it must be destroyed after the resources
+  NewSimulatorTimerService      m_timer_service;
   /// global lock for reading/writing:
   //   mcs, entities, sensors, frus, sels
   cThreadLockRw                 m_lock;
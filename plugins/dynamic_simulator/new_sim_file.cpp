@@ -34,6 +34,7 @@
 #include "new_sim_file_watchdog.h"
 #include "new_sim_file_fumi.h"
 #include "new_sim_file_dimi.h"
+#include "new_sim_file_snapshot.h"
 #include "new_sim_domain.h"
 #include "new_sim_entity.h"
 #include "new_sim_utils.h"
@@ -113,12 +114,18 @@ extern "C" {
 /**
  * Constructor
  * Open the file \<filename\> and initialize a GScanner.
+ *
+ * A binary snapshot (see new_sim_snapshot.h) is recognized by its magic
+ * and isn't read by the GScanner.
  * 
  * @param filename Pointer with the simulation filename
  */
 NewSimulatorFile::NewSimulatorFile(const char *filename, NewSimulatorEntityPath root) 
   : NewSimulatorFileUtil( root ),
-    m_version ( GEN_SIM_DATA_VERSION ) {
+    m_version ( GEN_SIM_DATA_VERSION ),
+    m_filename( g_strdup( filename ) ),
+    m_is_snapshot( sim_snapshot_probe( filename ) != 0 ),
+    m_snapshot( NULL ) {
    
    stdlog << "DBG: NewSimulatorFile.constructor with " << filename << "\n";
    m_scanner = g_scanner_new(&oh_scanner_config);
@@ -154,6 +161,24 @@ NewSimulatorFile::~NewSimulatorFile() {
    
    for (i=m_tokens.Num()-1; i >= 0; i--)
       m_tokens.Rem(i);	
+
+   g_free( m_filename );
+   g_free( m_snapshot );
+}
+
+
+/**
+ * Set the name of a snapshot
+ *
+ * After a simulation file in the text format was parsed successfully,
+ * NewSimulatorFile::Discover() writes the resources into this binary
+ * snapshot. The next start can use the snapshot as simulation file.
+ *
+ * @param filename name of the snapshot or NULL
+ **/
+void NewSimulatorFile::SetSnapshotFile( const char *filename ) {
+   g_free( m_snapshot );
+   m_snapshot = g_strdup( filename );
 }
 
 
@@ -199,9 +224,16 @@ bool NewSimulatorFile::Open() {
    m_tokens.Add(new SimulatorToken( "FUMI_SOURCE_DATA",  FUMI_SOURCE_DATA_TOKEN_HANDLER ));
    m_tokens.Add(new SimulatorToken( "FUMI_TARGET_DATA",  FUMI_TARGET_DATA_TOKEN_HANDLER ));
    m_tokens.Add(new SimulatorToken( "FUMI_LOG_TARGET_DATA", FUMI_LOG_TARGET_DATA_TOKEN_HANDLER ));
+   m_tokens.Add(new SimulatorToken( "SENSOR_GENERATOR", SENSOR_GENERATOR_TOKEN_HANDLER ));
    
    stdlog << "DBG: NewSimulatorFile::Open()\n";
    stdlog << "DBG: Working with entity path: " << m_root_ep << "\n";
+
+   if (m_is_snapshot) {
+      stdlog << "DBG: " << m_filename << " is a binary snapshot\n";
+      m_mode = INIT;
+      return true;
+   }
  
    if (m_depth != 0) 
       return false;
@@ -249,16 +281,23 @@ bool NewSimulatorFile::Open() {
  *  
  * Starting with \c RPT_TOKEN_HANDLER the rpt information
  * is read inside NewSimulatorFile::process_rpt_token.
+ * A binary snapshot is loaded by NewSimulatorFileSnapshot instead.
  *
  * @param domain Pointer to the domain to which the information should be linked
  * 
  * @return success 
  **/
 bool NewSimulatorFile::Discover(NewSimulatorDomain *domain) {
-   guint cur_token = g_scanner_peek_next_token (m_scanner);
+   guint cur_token;
    int done = 0;
    bool success = true;
+
+   if (m_is_snapshot) {
+      NewSimulatorFileSnapshot snapshot( m_root_ep );
+      return snapshot.Discover( m_filename, domain );
+   }
    
+   cur_token = g_scanner_peek_next_token (m_scanner);
    while (!done) {
       switch (cur_token) {
 
@@ -286,6 +325,12 @@ bool NewSimulatorFile::Discover(NewSimulatorDomain *domain) {
       
       };
    }
+
+   if (success && m_snapshot) {
+      // a broken snapshot mustn't stop the simulation
+      if (!NewSimulatorFileSnapshot::Write( m_snapshot, domain ))
+         err("Couldn't convert %s into snapshot %s", m_filename, m_snapshot);
+   }
    
    return success;
 }
@@ -59,6 +59,9 @@ class NewSimulatorFile : public NewSimulatorFileUtil {
    int                   m_mode;     //!< Switch if the class is running in UPDATE or INIT mode
    int                   m_depth;    //!< Deepth concerning LEFT and RIGHT_CURLY
    cArray<SimulatorToken> m_tokens;   //!< Array with additional TOKENS of type SimulatorToken
+   char                  *m_filename; //!< Name of the simulation file
+   bool                  m_is_snapshot; //!< Switch if the file is a binary snapshot
+   char                  *m_snapshot; //!< Snapshot to be written after parsing a text file
    
    bool process_configuration_token();
    bool process_rpt_token(NewSimulatorDomain *domain);
@@ -77,6 +80,8 @@ class NewSimulatorFile : public NewSimulatorFileUtil {
    };
    bool                Open();
    bool                Discover( NewSimulatorDomain *domain );
+   void                SetSnapshotFile( const char *filename );
+   bool                IsSnapshot() { return m_is_snapshot; } //!< Read function for m_is_snapshot
    int                 &Mode() { return m_mode; }  //!< Read/Write function fo the private m_mode
 };
 
@@ -26,6 +26,7 @@
 #include "new_sim_file_rdr.h"
 #include "new_sim_file_sensor.h"
 #include "new_sim_file_util.h"
+#include "new_sim_domain.h"
 #include "new_sim_resource.h"
 #include "new_sim_rdr.h"
 #include "new_sim_sensor.h"
@@ -43,7 +44,8 @@ NewSimulatorFileSensor::NewSimulatorFileSensor( GScanner *scanner )
                        m_sensor_event_amask ( 0 ), 
                        m_sensor_event_dmask ( 0 ), 
                        m_sensor_enabled ( SAHPI_TRUE ), 
-                       m_sensor_event_enabled( SAHPI_TRUE ) { 
+                       m_sensor_event_enabled( SAHPI_TRUE ),
+                       m_has_generator( false ) { 
    
    m_sensor_rec = &m_rdr.RdrTypeUnion.SensorRec;
    memset ( &m_sensor_data, 0, sizeof( SaHpiSensorReadingT ));
@@ -164,6 +166,11 @@ NewSimulatorRdr * NewSimulatorFileSensor::process_token( NewSimulatorResource *r
          case SENSOR_DATA_TOKEN_HANDLER:
             success = process_sensor_data_token();
          
+            break;   
+
+         case SENSOR_GENERATOR_TOKEN_HANDLER:
+            success = process_sensor_generator_token();
+         
             break;   
          default: 
             err("Processing parse rdr entry: Unknown token");
@@ -173,17 +180,34 @@ NewSimulatorRdr * NewSimulatorFileSensor::process_token( NewSimulatorResource *r
    }
    
    if ( success ) { 
+      NewSimulatorSensor *sensor;
+      
       if ( m_sensor_rec->ThresholdDefn.IsAccessible ) {
-         return ( new NewSimulatorSensorThreshold(res, m_rdr, m_sensor_data, m_sensor_event_state, 
+         sensor = new NewSimulatorSensorThreshold(res, m_rdr, m_sensor_data, m_sensor_event_state, 
                                             m_sensor_event_amask, m_sensor_event_dmask,
                                             m_sensor_thresholds, m_sensor_enabled, 
-                                            m_sensor_event_enabled) );
+                                            m_sensor_event_enabled);
       
       } else {
-         return ( new NewSimulatorSensorCommon(res, m_rdr, m_sensor_data, m_sensor_event_state, 
+         sensor = new NewSimulatorSensorCommon(res, m_rdr, m_sensor_data, m_sensor_event_state, 
                                             m_sensor_event_amask, m_sensor_event_dmask,
-                                            m_sensor_enabled, m_sensor_event_enabled) );
+                                            m_sensor_enabled, m_sensor_event_enabled);
       }
+      
+      if ( m_has_generator ) {
+         NewSimulatorValueGenerator *generator;
+         generator = new NewSimulatorValueGenerator( res->Domain()->TimerService(),
+                                                     sensor, m_generator_params );
+         if ( generator->Init() ) {
+            sensor->SetGenerator( generator );
+         } else {
+            err("Processing parse sensor: Generator of sensor %d is ignored",
+                m_sensor_rec->Num);
+            delete generator;
+         }
+      }
+      
+      return sensor;
    }
 
    return NULL;
@@ -834,3 +858,145 @@ bool NewSimulatorFileSensor::process_sensor_reading( SaHpiSensorReadingT *sensor
    return success;	
 }
 
+
+
+/**
+ * Parse inside the \c RDR_DETAIL_TOKEN_HANDLER the \c SENSOR_GENERATOR_TOKEN_HANDLER
+ *
+ * The parameters of a generator which changes the sensor reading over the time are
+ * read. Startpoint is the \c SENSOR_GENERATOR_TOKEN_HANDLER. Endpoint is the last
+ * \c G_TOKEN_RIGHT_CURLY.
+ *  
+ * @return success
+ **/
+bool NewSimulatorFileSensor::process_sensor_generator_token( ) {
+   bool success = true;
+   int start = m_depth;
+   char *field;
+   
+   guint cur_token = g_scanner_get_next_token(m_scanner);
+   
+   if (cur_token != G_TOKEN_LEFT_CURLY) {
+   	  err("Processing parse configuration: Expected left curly token after SENSOR_GENERATOR_TOKEN_HANDLER.");
+      return false;
+   }
+   m_depth++;
+   
+   while ( (m_depth > start) && success ) {
+      cur_token = g_scanner_get_next_token(m_scanner);
+      
+      switch (cur_token) {
+
+         case G_TOKEN_EOF:  
+            err("Processing parse rpt entry: File ends too early");
+       	    success = false;
+       	    break;
+       	    
+       	 case G_TOKEN_RIGHT_CURLY:
+            m_depth--;
+            break;
+          
+         case G_TOKEN_LEFT_CURLY:
+            m_depth++;
+            break;
+
+         case G_TOKEN_STRING:
+       	    field = g_strdup(m_scanner->value.v_string);
+            cur_token = g_scanner_get_next_token(m_scanner);
+            
+            if (cur_token != G_TOKEN_EQUAL_SIGN) {
+               err("Processing parse rdr entry: Missing equal sign");
+               success = false;
+            }
+            cur_token = g_scanner_get_next_token(m_scanner);
+            
+            if (!strcmp(field, "Type")) {
+            	   if (cur_token == G_TOKEN_INT)
+         	      m_generator_params.m_type = ( NewSimulatorGeneratorType ) m_scanner->value.v_int;
+         	   
+            } else if (!strcmp(field, "Interval")) {
+            	   if (cur_token == G_TOKEN_INT)
+         	      m_generator_params.m_interval = m_scanner->value.v_int;
+         	   
+         	} else if (!strcmp(field, "Min")) {
+         	   success = process_generator_value( cur_token, m_generator_params.m_min );
+
+         	} else if (!strcmp(field, "Max")) {
+         	   success = process_generator_value( cur_token, m_generator_params.m_max );
+
+         	} else if (!strcmp(field, "Period")) {
+            	   if (cur_token == G_TOKEN_INT)
+         	      m_generator_params.m_period = m_scanner->value.v_int;
+         	   
+         	} else if (!strcmp(field, "Step")) {
+         	   success = process_generator_value( cur_token, m_generator_params.m_step );
+
+         	} else if (!strcmp(field, "Seed")) {
+            	   if (cur_token == G_TOKEN_INT)
+         	      m_generator_params.m_seed = m_scanner->value.v_int;
+         	   
+         	} else if (!strcmp(field, "Trace")) {
+            	   if (cur_token == G_TOKEN_STRING)
+         	      m_generator_params.SetTrace( m_scanner->value.v_string );
+         	   
+         	} else if (!strcmp(field, "TraceFormat")) {
+            	   if (cur_token == G_TOKEN_INT)
+         	      m_generator_params.m_trace_format = ( NewSimulatorTraceFormat ) m_scanner->value.v_int;
+         	   
+         	} else if (!strcmp(field, "Loop")) {
+            	   if (cur_token == G_TOKEN_INT)
+         	      m_generator_params.m_loop = ( m_scanner->value.v_int != 0 );
+            	      	
+            } else {
+               // Unknown Token 
+               err("Processing parse rdr entry: Unknown generator field %s", field);
+               success = false;	
+            }
+            
+            break;
+            
+         default: 
+            err("Processing parse rdr entry: Unknown token");
+            success = false;
+            break;   
+      }
+   }
+   
+   m_has_generator = success;
+   
+   return success;
+}
+
+
+/**
+ * Read a number of the generator, it can be an integer or a float with a sign
+ *
+ * @param cur_token current token, it is the first token after the equal sign
+ * @param value variable to be filled
+ *
+ * @return success
+ **/
+bool NewSimulatorFileSensor::process_generator_value( guint cur_token, double &value ) {
+   bool negative = false;
+   
+   if ( cur_token == '-' ) {
+      negative = true;
+      cur_token = g_scanner_get_next_token(m_scanner);	
+   }
+   
+   if ( cur_token == G_TOKEN_INT ) {
+      value = m_scanner->value.v_int;
+      
+   } else if ( cur_token == G_TOKEN_FLOAT ) {
+      value = m_scanner->value.v_float;
+      
+   } else {
+      err("Processing parse sensor generator: Expected a number");
+      return false;
+   }
+   
+   if ( negative )
+      value = -value;
+   
+   return true;
+}
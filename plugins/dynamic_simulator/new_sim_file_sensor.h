@@ -42,6 +42,10 @@ extern "C" {
 #include "new_sim_sensor.h"
 #endif
 
+#ifndef __NEW_SIM_VALUE_GENERATOR_H__
+#include "new_sim_value_generator.h"
+#endif
+
 /**
  * @class NewSimulatorFileSensor
  * 
@@ -57,6 +61,8 @@ class NewSimulatorFileSensor : public NewSimulatorFileRdr {
    SaHpiSensorThresholdsT m_sensor_thresholds;
    SaHpiBoolT             m_sensor_enabled;
    SaHpiBoolT             m_sensor_event_enabled;
+   NewSimulatorGeneratorParams m_generator_params;
+   bool                   m_has_generator;
 
    bool process_dataformat        ( SaHpiSensorDataFormatT *dataformat);
    bool process_dataformat_range  ( SaHpiSensorRangeT      *datarange );
@@ -64,6 +70,8 @@ class NewSimulatorFileSensor : public NewSimulatorFileRdr {
    bool process_sensor_data_token ( void );
    bool process_sensor_thresholds ( SaHpiSensorThresholdsT *thres );
    bool process_sensor_reading    ( SaHpiSensorReadingT    *sensorreading );
+   bool process_sensor_generator_token ( void );
+   bool process_generator_value   ( guint cur_token, double &value );
    
 
    public:
@@ -0,0 +1,630 @@
+/**
+ * @file    new_sim_file_snapshot.cpp
+ *
+ * The file includes a class for loading and writing binary snapshots:\n
+ * NewSimulatorFileSnapshot
+ *
+ * @version 0.1
+ * @date    2026
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <SaHpi.h>
+#include <oh_error.h>
+
+#include "new_sim_file_snapshot.h"
+#include "new_sim_domain.h"
+#include "new_sim_resource.h"
+#include "new_sim_sensor_threshold.h"
+#include "new_sim_sensor_common.h"
+#include "new_sim_value_generator.h"
+#include "new_sim_control_digital.h"
+#include "new_sim_control_discrete.h"
+#include "new_sim_control_analog.h"
+#include "new_sim_control_stream.h"
+#include "new_sim_control_text.h"
+#include "new_sim_control_oem.h"
+#include "new_sim_inventory.h"
+#include "new_sim_inventory_data.h"
+#include "new_sim_watchdog.h"
+#include "new_sim_annunciator.h"
+#include "new_sim_announcement.h"
+#include "new_sim_dimi.h"
+#include "new_sim_dimi_data.h"
+#include "new_sim_fumi.h"
+#include "new_sim_fumi_data.h"
+#include "new_sim_log.h"
+
+
+/**
+ * Constructor
+ *
+ * @param root root entity path of the plugin
+ **/
+NewSimulatorFileSnapshot::NewSimulatorFileSnapshot( NewSimulatorEntityPath root )
+  : m_root_ep( root ) {
+
+   memset( &m_snap, 0, sizeof( SimSnapshotT ));
+}
+
+
+/**
+ * Destructor
+ **/
+NewSimulatorFileSnapshot::~NewSimulatorFileSnapshot() {
+
+   sim_snapshot_close( &m_snap );
+}
+
+
+/**
+ * Fill a domain with the resources of a snapshot
+ *
+ * The snapshot is mapped into memory and verified before any resource is
+ * created. The rdr of every resource are added like a RDR section of the
+ * text format before the resource is populated.
+ *
+ * @param filename name of the snapshot
+ * @param domain domain to be filled
+ * @return success
+ **/
+bool NewSimulatorFileSnapshot::Discover( const char *filename, NewSimulatorDomain *domain ) {
+   bool success = true;
+
+   stdlog << "DBG: NewSimulatorFileSnapshot::Discover " << filename << "\n";
+
+   if ( sim_snapshot_open( filename, &m_snap ) != SA_OK ) {
+      err("Snapshot file '%s' couldn't be loaded", filename);
+      return false;
+   }
+
+   stdlog << "DBG: Snapshot with " << m_snap.NumRpts << " rpt and "
+          << m_snap.NumRdrs << " rdr entries\n";
+
+   for ( SaHpiUint32T i = 0; i < m_snap.NumRpts && success; i++ )
+      success = process_rpt( domain, m_snap.Rpts[i] );
+
+   if ( !success )
+      err("Stop loading the snapshot due to the error before");
+
+   sim_snapshot_close( &m_snap );
+
+   return success;
+}
+
+
+/**
+ * Replace the root of an entity path by the root of the plugin
+ *
+ * @param path entity path to be changed
+ **/
+void NewSimulatorFileSnapshot::replace_root( SaHpiEntityPathT &path ) {
+   NewSimulatorEntityPath ep( path );
+
+   ep.ReplaceRoot( m_root_ep );
+   path = ep;
+}
+
+
+/**
+ * Create a resource with its rdr
+ *
+ * @param domain domain to which the resource is added
+ * @param srpt rpt entry of the snapshot
+ * @return success
+ **/
+bool NewSimulatorFileSnapshot::process_rpt( NewSimulatorDomain *domain,
+                                            const SimSnapshotRptT &srpt ) {
+   const SaHpiRptEntryT &rpt = srpt.Rpt;
+   NewSimulatorResource *res = new NewSimulatorResource( domain );
+   bool success = true;
+
+   // the ResourceId will be assigned by the daemon
+   res->EntryId() = rpt.EntryId;
+   res->SetResourceInfo( rpt.ResourceInfo );
+   res->EntityPath() = rpt.ResourceEntity;
+   res->EntityPath().ReplaceRoot( m_root_ep );
+   res->ResourceCapabilities() = rpt.ResourceCapabilities;
+   res->HotSwapCapabilities() = rpt.HotSwapCapabilities;
+   res->ResourceSeverity() = rpt.ResourceSeverity;
+   res->ResourceFailed() = rpt.ResourceFailed;
+   res->ResourceTag() = rpt.ResourceTag;
+
+   stdlog << "DBG: Add resource " << res->EntityPath() << " to domain\n";
+   domain->AddResource( res );
+
+   for ( SaHpiUint32T i = 0; i < srpt.NumRdr && success; i++ ) {
+      NewSimulatorRdr *rdr = process_rdr( res, m_snap.Rdrs[srpt.FirstRdr + i] );
+
+      if ( rdr != NULL )
+         success = res->AddRdr( rdr );
+   }
+
+   if ( res->Populate() ) {
+      stdlog << "DBG: Resource::Populate was successful.\n";
+   } else {
+      stdlog << "DBG: Resource::Populate returns an error.\n";
+      success = false;
+   }
+
+   return success;
+}
+
+
+/**
+ * Create the object of one rdr
+ *
+ * @param res resource of the rdr
+ * @param srdr rdr entry of the snapshot
+ * @return new rdr object or NULL if the rdr is skipped
+ **/
+NewSimulatorRdr *NewSimulatorFileSnapshot::process_rdr( NewSimulatorResource *res,
+                                                        const SimSnapshotRdrT &srdr ) {
+   SaHpiRdrT rdr;
+
+   memcpy( &rdr, &srdr.Rdr, sizeof( SaHpiRdrT ));
+   replace_root( rdr.Entity );
+
+   switch ( rdr.RdrType ) {
+      case SAHPI_SENSOR_RDR:
+         return process_sensor( res, rdr, srdr );
+
+      case SAHPI_CTRL_RDR:
+         return process_control( res, rdr, srdr );
+
+      case SAHPI_INVENTORY_RDR:
+         return process_inventory( res, rdr, srdr );
+
+      case SAHPI_WATCHDOG_RDR:
+         return process_watchdog( res, rdr, srdr );
+
+      case SAHPI_ANNUNCIATOR_RDR:
+         return process_annunciator( res, rdr, srdr );
+
+      case SAHPI_DIMI_RDR:
+         return process_dimi( res, rdr, srdr );
+
+      case SAHPI_FUMI_RDR:
+         return process_fumi( res, rdr, srdr );
+
+      default:
+         err("Snapshot: Unknown rdr type %d is ignored", rdr.RdrType);
+         return NULL;
+   }
+}
+
+
+/**
+ * Create a sensor
+ *
+ * Without a SENSOR record the sensor gets the default values of the parser.
+ **/
+NewSimulatorRdr *NewSimulatorFileSnapshot::process_sensor( NewSimulatorResource *res,
+                                                           SaHpiRdrT &rdr,
+                                                           const SimSnapshotRdrT &srdr ) {
+   SimSnapshotSensorT data;
+   const SimSnapshotGeneratorT *gen = NULL;
+   NewSimulatorSensor *sensor;
+
+   memset( &data, 0, sizeof( SimSnapshotSensorT ));
+   data.Enabled = SAHPI_TRUE;
+   data.EventsEnabled = SAHPI_TRUE;
+
+   for ( const SimSnapshotRecordT *rec = sim_snapshot_first_record( &m_snap, &srdr );
+         rec != NULL; rec = sim_snapshot_next_record( &m_snap, &srdr, rec ) ) {
+
+      if ( rec->Tag == SIM_SNAPSHOT_SENSOR )
+         memcpy( &data, sim_snapshot_record_data( rec ), sizeof( SimSnapshotSensorT ));
+      else if ( rec->Tag == SIM_SNAPSHOT_GENERATOR )
+         gen = (const SimSnapshotGeneratorT *) sim_snapshot_record_data( rec );
+   }
+
+   if ( rdr.RdrTypeUnion.SensorRec.ThresholdDefn.IsAccessible ) {
+      sensor = new NewSimulatorSensorThreshold( res, rdr, data.Reading, data.EventState,
+                                                data.AssertMask, data.DeassertMask,
+                                                data.Thresholds, data.Enabled,
+                                                data.EventsEnabled );
+   } else {
+      sensor = new NewSimulatorSensorCommon( res, rdr, data.Reading, data.EventState,
+                                             data.AssertMask, data.DeassertMask,
+                                             data.Enabled, data.EventsEnabled );
+   }
+
+   if ( gen != NULL ) {
+      NewSimulatorGeneratorParams params;
+      NewSimulatorValueGenerator *generator;
+
+      params.m_type         = (NewSimulatorGeneratorType) gen->Type;
+      params.m_interval     = gen->Interval;
+      params.m_period       = gen->Period;
+      params.m_seed         = gen->Seed;
+      params.m_trace_format = (NewSimulatorTraceFormat) gen->TraceFormat;
+      params.m_loop         = ( gen->Loop != 0 );
+      params.m_min          = gen->Min;
+      params.m_max          = gen->Max;
+      params.m_step         = gen->Step;
+      if ( memchr( gen->Trace, 0, SIM_SNAPSHOT_MAX_PATH ) != NULL )
+         params.SetTrace( gen->Trace );
+
+      generator = new NewSimulatorValueGenerator( res->Domain()->TimerService(),
+                                                  sensor, params );
+      if ( generator->Init() ) {
+         sensor->SetGenerator( generator );
+      } else {
+         err("Snapshot: Generator of sensor %d is ignored",
+             rdr.RdrTypeUnion.SensorRec.Num);
+         delete generator;
+      }
+   }
+
+   return sensor;
+}
+
+
+/**
+ * Create a control
+ *
+ * Without a CONTROL record the control gets the default mode and state of
+ * the rdr like inside the parser.
+ **/
+NewSimulatorRdr *NewSimulatorFileSnapshot::process_control( NewSimulatorResource *res,
+                                                            SaHpiRdrT &rdr,
+                                                            const SimSnapshotRdrT &srdr ) {
+   SaHpiCtrlRecT &ctrl = rdr.RdrTypeUnion.CtrlRec;
+   SimSnapshotControlT data;
+   bool found = false;
+
+   memset( &data, 0, sizeof( SimSnapshotControlT ));
+
+   for ( const SimSnapshotRecordT *rec = sim_snapshot_first_record( &m_snap, &srdr );
+         rec != NULL; rec = sim_snapshot_next_record( &m_snap, &srdr, rec ) ) {
+
+      if ( rec->Tag == SIM_SNAPSHOT_CONTROL ) {
+         memcpy( &data, sim_snapshot_record_data( rec ), sizeof( SimSnapshotControlT ));
+         found = true;
+      }
+   }
+
+   if ( !found )
+      data.Mode = ctrl.DefaultMode.Mode;
+
+   switch ( ctrl.Type ) {
+      case SAHPI_CTRL_TYPE_DIGITAL:
+         if ( !found )
+            data.State.StateUnion.Digital = ctrl.TypeUnion.Digital.Default;
+
+         return new NewSimulatorControlDigital( res, rdr, data.State.StateUnion.Digital,
+                                                data.Mode );
+
+      case SAHPI_CTRL_TYPE_DISCRETE:
+         if ( !found )
+            data.State.StateUnion.Discrete = ctrl.TypeUnion.Discrete.Default;
+
+         return new NewSimulatorControlDiscrete( res, rdr, data.State.StateUnion.Discrete,
+                                                 data.Mode );
+
+      case SAHPI_CTRL_TYPE_ANALOG:
+         if ( !found )
+            data.State.StateUnion.Analog = ctrl.TypeUnion.Analog.Default;
+
+         return new NewSimulatorControlAnalog( res, rdr, data.State.StateUnion.Analog,
+                                               data.Mode );
+
+      case SAHPI_CTRL_TYPE_STREAM:
+         if ( !found )
+            memcpy( &data.State.StateUnion.Stream, &ctrl.TypeUnion.Stream.Default,
+                    sizeof( SaHpiCtrlStateStreamT ));
+
+         return new NewSimulatorControlStream( res, rdr, data.State.StateUnion.Stream,
+                                               data.Mode );
+
+      case SAHPI_CTRL_TYPE_TEXT:
+         if ( !found )
+            memcpy( &data.State.StateUnion.Text, &ctrl.TypeUnion.Text.Default,
+                    sizeof( SaHpiCtrlStateTextT ));
+
+         return new NewSimulatorControlText( res, rdr, data.State.StateUnion.Text,
+                                             data.Mode );
+
+      case SAHPI_CTRL_TYPE_OEM:
+         if ( !found )
+            memcpy( &data.State.StateUnion.Oem, &ctrl.TypeUnion.Oem.Default,
+                    sizeof( SaHpiCtrlStateOemT ));
+
+         return new NewSimulatorControlOem( res, rdr, data.State.StateUnion.Oem,
+                                            data.Mode );
+
+      default:
+         err("Snapshot: Unknown Control Type");
+         return NULL;
+   }
+}
+
+
+/**
+ * Create an inventory with its areas and fields
+ *
+ * Like inside the parser, an inventory without data is skipped.
+ **/
+NewSimulatorRdr *NewSimulatorFileSnapshot::process_inventory( NewSimulatorResource *res,
+                                                              SaHpiRdrT &rdr,
+                                                              const SimSnapshotRdrT &srdr ) {
+   NewSimulatorInventory *idr = NULL;
+   NewSimulatorInventoryArea *ida = NULL;
+   SaHpiIdrInfoT info;
+
+   memset( &info, 0, sizeof( SaHpiIdrInfoT ));
+
+   for ( const SimSnapshotRecordT *rec = sim_snapshot_first_record( &m_snap, &srdr );
+         rec != NULL; rec = sim_snapshot_next_record( &m_snap, &srdr, rec ) ) {
+      const void *data = sim_snapshot_record_data( rec );
+
+      switch ( rec->Tag ) {
+         case SIM_SNAPSHOT_IDR_INFO:
+            memcpy( &info, data, sizeof( SaHpiIdrInfoT ));
+            if ( idr == NULL )
+               idr = new NewSimulatorInventory( res, rdr );
+            break;
+
+         case SIM_SNAPSHOT_IDR_AREA:
+            if ( idr == NULL )
+               break;
+
+            SaHpiIdrAreaHeaderT aheader;
+            memcpy( &aheader, data, sizeof( SaHpiIdrAreaHeaderT ));
+
+            ida = new NewSimulatorInventoryArea();
+            ida->SetData( aheader );
+            if ( !idr->AddInventoryArea( ida ) ) {
+               delete ida;
+               ida = NULL;
+            }
+            break;
+
+         case SIM_SNAPSHOT_IDR_FIELD:
+            if ( ida == NULL )
+               break;
+
+            SaHpiIdrFieldT field;
+            memcpy( &field, data, sizeof( SaHpiIdrFieldT ));
+
+            NewSimulatorInventoryField *idf;
+            idf = new NewSimulatorInventoryField( field );
+            if ( !ida->AddInventoryField( idf ) )
+               delete idf;
+            break;
+
+         default:
+            break;
+      }
+   }
+
+   if ( idr != NULL ) {
+      idr->SetInfo( info );
+      idr->SetData( rdr.RdrTypeUnion.InventoryRec );
+   }
+
+   return idr;
+}
+
+
+/**
+ * Create a watchdog
+ **/
+NewSimulatorRdr *NewSimulatorFileSnapshot::process_watchdog( NewSimulatorResource *res,
+                                                             SaHpiRdrT &rdr,
+                                                             const SimSnapshotRdrT &srdr ) {
+   SaHpiWatchdogT data;
+
+   memset( &data, 0, sizeof( SaHpiWatchdogT ));
+
+   for ( const SimSnapshotRecordT *rec = sim_snapshot_first_record( &m_snap, &srdr );
+         rec != NULL; rec = sim_snapshot_next_record( &m_snap, &srdr, rec ) ) {
+
+      if ( rec->Tag == SIM_SNAPSHOT_WATCHDOG )
+         memcpy( &data, sim_snapshot_record_data( rec ), sizeof( SaHpiWatchdogT ));
+   }
+
+   return new NewSimulatorWatchdog( res, rdr, data );
+}
+
+
+/**
+ * Create an annunciator with its announcements
+ *
+ * The announcements keep their entry ids and timestamps. Like inside the
+ * parser, an annunciator without data is skipped.
+ **/
+NewSimulatorRdr *NewSimulatorFileSnapshot::process_annunciator( NewSimulatorResource *res,
+                                                                SaHpiRdrT &rdr,
+                                                                const SimSnapshotRdrT &srdr ) {
+   NewSimulatorAnnunciator *ann = NULL;
+
+   for ( const SimSnapshotRecordT *rec = sim_snapshot_first_record( &m_snap, &srdr );
+         rec != NULL; rec = sim_snapshot_next_record( &m_snap, &srdr, rec ) ) {
+      const void *data = sim_snapshot_record_data( rec );
+
+      if ( rec->Tag == SIM_SNAPSHOT_ANN_MODE ) {
+         if ( ann == NULL )
+            ann = new NewSimulatorAnnunciator( res, rdr );
+         ann->SetMode( ((const SimSnapshotAnnunciatorT *) data)->Mode );
+
+      } else if ( rec->Tag == SIM_SNAPSHOT_ANNOUNCEMENT && ann != NULL ) {
+         SaHpiAnnouncementT announce;
+         memcpy( &announce, data, sizeof( SaHpiAnnouncementT ));
+
+         NewSimulatorAnnouncement *a = new NewSimulatorAnnouncement( announce );
+         if ( !ann->AddAnnouncement( a ) )
+            delete a;
+      }
+   }
+
+   if ( ann != NULL )
+      ann->SetData( rdr.RdrTypeUnion.AnnunciatorRec );
+
+   return ann;
+}
+
+
+/**
+ * Create a dimi with its tests
+ *
+ * Like inside the parser, a dimi without data is skipped.
+ **/
+NewSimulatorRdr *NewSimulatorFileSnapshot::process_dimi( NewSimulatorResource *res,
+                                                         SaHpiRdrT &rdr,
+                                                         const SimSnapshotRdrT &srdr ) {
+   NewSimulatorDimi *dimi = NULL;
+   SaHpiDimiInfoT info;
+
+   memset( &info, 0, sizeof( SaHpiDimiInfoT ));
+
+   for ( const SimSnapshotRecordT *rec = sim_snapshot_first_record( &m_snap, &srdr );
+         rec != NULL; rec = sim_snapshot_next_record( &m_snap, &srdr, rec ) ) {
+      const void *data = sim_snapshot_record_data( rec );
+
+      if ( rec->Tag == SIM_SNAPSHOT_DIMI_INFO ) {
+         memcpy( &info, data, sizeof( SaHpiDimiInfoT ));
+         if ( dimi == NULL )
+            dimi = new NewSimulatorDimi( res, rdr );
+
+      } else if ( rec->Tag == SIM_SNAPSHOT_DIMI_TEST && dimi != NULL ) {
+         const SimSnapshotDimiTestT *test = (const SimSnapshotDimiTestT *) data;
+         NewSimulatorDimiTest *dt = new NewSimulatorDimiTest( dimi->GetTestId() );
+
+         dt->SetData( test->Info );
+         dt->SetReadiness( test->Ready );
+         if ( test->HasResults )
+            dt->SetResults( test->Results );
+
+         dimi->AddTest( dt );
+      }
+   }
+
+   if ( dimi != NULL ) {
+      dimi->SetInfo( info );
+      dimi->SetData( rdr.RdrTypeUnion.DimiRec );
+   }
+
+   return dimi;
+}
+
+
+/**
+ * Create a fumi with its banks
+ *
+ * Like inside the parser, a fumi without data is skipped.
+ **/
+NewSimulatorRdr *NewSimulatorFileSnapshot::process_fumi( NewSimulatorResource *res,
+                                                         SaHpiRdrT &rdr,
+                                                         const SimSnapshotRdrT &srdr ) {
+   NewSimulatorFumi *fumi = NULL;
+
+   for ( const SimSnapshotRecordT *rec = sim_snapshot_first_record( &m_snap, &srdr );
+         rec != NULL; rec = sim_snapshot_next_record( &m_snap, &srdr, rec ) ) {
+      const void *data = sim_snapshot_record_data( rec );
+
+      if ( rec->Tag == SIM_SNAPSHOT_FUMI_INFO ) {
+         SimSnapshotFumiT info;
+         memcpy( &info, data, sizeof( SimSnapshotFumiT ));
+
+         for ( int i = 0; i < info.Impact.NumEntities
+                          && i < SAHPI_FUMI_MAX_ENTITIES_IMPACTED; i++ )
+            replace_root( info.Impact.ImpactedEntities[i].ImpactedEntity );
+
+         if ( fumi == NULL )
+            fumi = new NewSimulatorFumi( res, rdr );
+         fumi->SetInfo( info.Spec, info.Impact, info.RollbackDisabled );
+
+      } else if ( rec->Tag == SIM_SNAPSHOT_FUMI_BANK && fumi != NULL ) {
+         const SimSnapshotFumiBankT *sbank = (const SimSnapshotFumiBankT *) data;
+         NewSimulatorFumiBank bank;
+
+         bank.SetData( sbank->Target );
+         bank.SetData( sbank->Source );
+         bank.SetData( sbank->Logical );
+
+         fumi->SetBankTarget( &bank );
+         fumi->SetBankSource( &bank );
+         fumi->SetBankLogical( &bank );
+      }
+   }
+
+   if ( fumi != NULL )
+      fumi->SetData( rdr.RdrTypeUnion.FumiRec );
+
+   return fumi;
+}
+
+
+/**
+ * Write all resources of a domain into a snapshot
+ *
+ * Every rdr adds its current state by NewSimulatorRdr::WriteSnapshot(),
+ * so a snapshot written after a text file was parsed holds the same
+ * information as the text file.
+ *
+ * @param filename name of the snapshot
+ * @param domain domain with the resources
+ * @return success
+ **/
+bool NewSimulatorFileSnapshot::Write( const char *filename, NewSimulatorDomain *domain ) {
+   SimSnapshotWriterT *writer = sim_snapshot_writer_new();
+   bool success = true;
+
+   if ( writer == NULL ) {
+      err("Snapshot: Couldn't allocate the writer");
+      return false;
+   }
+
+   for ( int i = 0; i < domain->Num() && success; i++ ) {
+      NewSimulatorResource *res = domain->GetResource( i );
+      SaHpiRptEntryT rpt;
+
+      memset( &rpt, 0, sizeof( SaHpiRptEntryT ));
+      rpt.EntryId              = res->EntryId();
+      rpt.ResourceId           = res->ResourceId();
+      rpt.ResourceInfo         = res->ResourceInfo();
+      rpt.ResourceEntity       = res->EntityPath();
+      rpt.ResourceCapabilities = res->ResourceCapabilities();
+      rpt.HotSwapCapabilities  = res->HotSwapCapabilities();
+      rpt.ResourceSeverity     = res->ResourceSeverity();
+      rpt.ResourceFailed       = res->ResourceFailed();
+      rpt.ResourceTag          = res->ResourceTag();
+
+      success = ( sim_snapshot_add_rpt( writer, &rpt ) == SA_OK );
+
+      for ( int j = 0; j < res->NumRdr() && success; j++ ) {
+         NewSimulatorRdr *rdr = res->GetRdr( j );
+         SaHpiRdrT rec;
+
+         memset( &rec, 0, sizeof( SaHpiRdrT ));
+         success = rdr->CreateRdr( rpt, rec )
+                   && sim_snapshot_add_rdr( writer, &rec ) == SA_OK
+                   && rdr->WriteSnapshot( writer );
+      }
+   }
+
+   if ( success )
+      success = ( sim_snapshot_writer_save( writer, filename ) == SA_OK );
+
+   if ( success )
+      stdlog << "DBG: Snapshot " << filename << " written\n";
+   else
+      err("Snapshot file '%s' couldn't be written", filename);
+
+   sim_snapshot_writer_free( writer );
+
+   return success;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file    new_sim_file_snapshot.h
+ *
+ * The file includes a class for loading and writing binary snapshots:\n
+ * NewSimulatorFileSnapshot
+ *
+ * @version 0.1
+ * @date    2026
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __NEW_SIM_FILE_SNAPSHOT_H__
+#define __NEW_SIM_FILE_SNAPSHOT_H__
+
+extern "C" {
+#include "SaHpi.h"
+}
+
+#ifndef __NEW_SIM_SNAPSHOT_H__
+#include "new_sim_snapshot.h"
+#endif
+
+#ifndef __NEW_SIM_ENTITY_H__
+#include "new_sim_entity.h"
+#endif
+
+#ifndef __NEW_SIM_RESOURCE_H__
+#include "new_sim_resource.h"
+#endif
+
+class NewSimulatorDomain;
+
+/**
+ * @class NewSimulatorFileSnapshot
+ *
+ * Fills a domain from a binary snapshot (see new_sim_snapshot.h) and writes
+ * the resources of a domain into a snapshot.
+ *
+ * The objects are created in the same way as by the parser of the text
+ * format, so a snapshot converted from a text file gives the same simulation.
+ **/
+class NewSimulatorFileSnapshot {
+   private:
+   /// Root entity path comes from configuration file
+   NewSimulatorEntityPath m_root_ep;
+   /// Mapped snapshot
+   SimSnapshotT           m_snap;
+
+   void             replace_root( SaHpiEntityPathT &path );
+   bool             process_rpt( NewSimulatorDomain *domain, const SimSnapshotRptT &srpt );
+   NewSimulatorRdr *process_rdr( NewSimulatorResource *res, const SimSnapshotRdrT &srdr );
+   NewSimulatorRdr *process_sensor( NewSimulatorResource *res, SaHpiRdrT &rdr,
+                                    const SimSnapshotRdrT &srdr );
+   NewSimulatorRdr *process_control( NewSimulatorResource *res, SaHpiRdrT &rdr,
+                                     const SimSnapshotRdrT &srdr );
+   NewSimulatorRdr *process_inventory( NewSimulatorResource *res, SaHpiRdrT &rdr,
+                                       const SimSnapshotRdrT &srdr );
+   NewSimulatorRdr *process_watchdog( NewSimulatorResource *res, SaHpiRdrT &rdr,
+                                      const SimSnapshotRdrT &srdr );
+   NewSimulatorRdr *process_annunciator( NewSimulatorResource *res, SaHpiRdrT &rdr,
+                                         const SimSnapshotRdrT &srdr );
+   NewSimulatorRdr *process_dimi( NewSimulatorResource *res, SaHpiRdrT &rdr,
+                                  const SimSnapshotRdrT &srdr );
+   NewSimulatorRdr *process_fumi( NewSimulatorResource *res, SaHpiRdrT &rdr,
+                                  const SimSnapshotRdrT &srdr );
+
+   public:
+   NewSimulatorFileSnapshot( NewSimulatorEntityPath root );
+   ~NewSimulatorFileSnapshot();
+
+   bool        Discover( const char *filename, NewSimulatorDomain *domain );
+   static bool Write( const char *filename, NewSimulatorDomain *domain );
+};
+
+#endif /*__NEW_SIM_FILE_SNAPSHOT_H__*/
@@ -238,6 +238,42 @@ bool NewSimulatorFumi::SetBankLogical( NewSimulatorFumiBank *bank ) {
 }
 
 
+/**
+ * Add the fumi information and the banks to a snapshot
+ * 
+ * The components of the banks are not part of a snapshot.
+ * 
+ * @param writer snapshot writer, the rdr of the fumi was added before
+ * @return success
+ **/
+bool NewSimulatorFumi::WriteSnapshot( SimSnapshotWriterT *writer ) {
+   SimSnapshotFumiT data;
+   
+   memset( &data, 0, sizeof( SimSnapshotFumiT ));
+   memcpy( &data.Spec, &m_spec_info, sizeof( SaHpiFumiSpecInfoT ));
+   memcpy( &data.Impact, &m_impact_data, sizeof( SaHpiFumiServiceImpactDataT ));
+   data.RollbackDisabled = m_dis_rb;
+   
+   if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_FUMI_INFO,
+                                 &data, sizeof( data ) ) != SA_OK )
+      return false;
+
+   for ( int i = 0; i < m_banks.Num(); i++ ) {
+      SimSnapshotFumiBankT bank;
+      
+      bank.Source  = m_banks[i]->GetSource();
+      bank.Target  = m_banks[i]->GetTarget();
+      bank.Logical = m_banks[i]->GetLogical();
+      
+      if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_FUMI_BANK,
+                                    &bank, sizeof( bank ) ) != SA_OK )
+         return false;
+   }
+
+   return true;
+}
+
+
 
 // Official HPI functions
  
@@ -79,6 +79,7 @@ public:
   
   // create a RDR record
   virtual bool CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr );
+  virtual bool WriteSnapshot( SimSnapshotWriterT *writer );
   
   // Official HPI functions
   SaErrorT GetSpecInfo( SaHpiFumiSpecInfoT &spec );
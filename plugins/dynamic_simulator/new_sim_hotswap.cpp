@@ -28,7 +28,7 @@
  * Constructor
  **/
 NewSimulatorHotSwap::NewSimulatorHotSwap( NewSimulatorResource *res )
-                    : NewSimulatorTimerThread( 0 ),
+                    : NewSimulatorTimerThread( res->Domain()->TimerService(), 0 ),
                       m_insert_time( SAHPI_TIMEOUT_IMMEDIATE ),
                       m_extract_time( SAHPI_TIMEOUT_IMMEDIATE ),
                       m_running( false ),
@@ -45,7 +45,7 @@ NewSimulatorHotSwap::NewSimulatorHotSwap( NewSimulatorResource *res,
                       SaHpiTimeoutT insertTime,
                       SaHpiTimeoutT extractTime, 
                       SaHpiHsStateT startState )
-                    : NewSimulatorTimerThread( 0 ),
+                    : NewSimulatorTimerThread( res->Domain()->TimerService(), 0 ),
                       m_insert_time( insertTime ),
                       m_extract_time( extractTime ),
                       m_running( false ),
@@ -191,6 +191,27 @@ bool NewSimulatorInventory::SetInfo( SaHpiIdrInfoT idrInfo ) {
 }
 
 
+/**
+ * Add the inventory information with all areas and fields to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the inventory was added before
+ * @return success
+ **/
+bool NewSimulatorInventory::WriteSnapshot( SimSnapshotWriterT *writer ) {
+
+   if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_INFO, &m_inv_info,
+                                 sizeof( SaHpiIdrInfoT ) ) != SA_OK )
+      return false;
+
+   for ( int i = 0; i < m_areas.Num(); i++ ) {
+      if ( !m_areas[i]->WriteSnapshot( writer ) )
+         return false;
+   }
+
+   return true;
+}
+
+
 // Official HPI functions
  
  /**
@@ -157,6 +157,28 @@ bool NewSimulatorInventoryArea::SetData(SaHpiIdrAreaHeaderT aheader) {
 }
 
 
+/**
+ * Add the area header followed by the fields to a snapshot
+ * 
+ * @param writer snapshot writer
+ * @return success
+ **/
+bool NewSimulatorInventoryArea::WriteSnapshot( SimSnapshotWriterT *writer ) {
+
+   if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_AREA, &AreaHeader(),
+                                 sizeof( SaHpiIdrAreaHeaderT ) ) != SA_OK )
+      return false;
+
+   for ( int i = 0; i < m_fields.Num(); i++ ) {
+      if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_FIELD, &m_fields[i]->FieldData(),
+                                    sizeof( SaHpiIdrFieldT ) ) != SA_OK )
+         return false;
+   }
+
+   return true;
+}
+
+
 // Official HPI functions
 /**
  * HPI function saHpiIdrFieldGet()
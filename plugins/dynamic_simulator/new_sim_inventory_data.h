@@ -107,6 +107,7 @@ public:
   bool IncludesReadOnlyField();
   void DeleteFields();
   bool SetData( SaHpiIdrAreaHeaderT aheader );
+  bool WriteSnapshot( SimSnapshotWriterT *writer );
   
   // methods for HPI functions
   SaErrorT  GetField( SaHpiIdrFieldTypeT fieldType, SaHpiEntryIdT fieldId, 
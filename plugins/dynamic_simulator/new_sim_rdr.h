@@ -36,6 +36,10 @@ extern "C" {
 #include "SaHpi.h"
 }
 
+#ifndef __NEW_SIM_SNAPSHOT_H__
+#include "new_sim_snapshot.h"
+#endif
+
 
 class NewSimulatorResource;
 
@@ -100,6 +104,8 @@ public:
   virtual unsigned int Num() const = 0;
   /// Dump the internal data
   virtual void Dump( NewSimulatorLog &dump ) const = 0;
+  /// Add the records with the state of the rdr to a snapshot, the default has none
+  virtual bool WriteSnapshot( SimSnapshotWriterT * ) { return true; }
 
   
 private:
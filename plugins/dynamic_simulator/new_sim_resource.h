@@ -126,6 +126,8 @@ public:
    SaHpiSeverityT         &ResourceSeverity() { return m_rpt_entry.ResourceSeverity; }
    /// set/get resource failed flag
    SaHpiBoolT             &ResourceFailed() { return m_rpt_entry.ResourceFailed; }
+   /// get resource info
+   const SaHpiResourceInfoT &ResourceInfo() const { return m_rpt_entry.ResourceInfo; }
 
 public:
    NewSimulatorResource( NewSimulatorDomain *domain );
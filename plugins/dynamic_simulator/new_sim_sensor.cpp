@@ -37,6 +37,7 @@
 #include "new_sim_entity.h"
 #include "new_sim_utils.h"
 #include "new_sim_text_buffer.h"
+#include "new_sim_value_generator.h"
 
 
 
@@ -49,7 +50,8 @@ NewSimulatorSensor::NewSimulatorSensor( NewSimulatorResource *res )
     m_events_enabled( SAHPI_TRUE ),
     m_read_support( SAHPI_TRUE ),
     m_assert_mask( 0 ),
-    m_deassert_mask( 0 ){
+    m_deassert_mask( 0 ),
+    m_generator( 0 ){
     	
    memset( &m_sensor_record, 0, sizeof( SaHpiSensorRecT ));
    memset( &m_read_data, 0, sizeof( SaHpiSensorReadingT ));
@@ -74,7 +76,8 @@ NewSimulatorSensor::NewSimulatorSensor( NewSimulatorResource *res,
     m_read_support( SAHPI_TRUE ),
     m_assert_mask( event_amask ),
     m_deassert_mask( event_dmask ),
-    m_event_data( event_state ) {
+    m_event_data( event_state ),
+    m_generator( 0 ) {
 
    memcpy(&m_sensor_record, &rdr.RdrTypeUnion.SensorRec, sizeof( SaHpiSensorRecT ));
    memcpy(&m_read_data, &data, sizeof( SaHpiSensorReadingT ));
@@ -87,6 +90,126 @@ NewSimulatorSensor::NewSimulatorSensor( NewSimulatorResource *res,
  **/
 NewSimulatorSensor::~NewSimulatorSensor()
 {
+  StopGenerator();
+
+  delete m_generator;
+}
+
+
+/**
+ * Set the generator of readings, the sensor takes the ownership
+ *
+ * @param generator generator which was initialized for this sensor
+ **/
+void NewSimulatorSensor::SetGenerator( NewSimulatorValueGenerator *generator )
+{
+  if ( m_generator ) {
+     m_generator->Stop();
+     delete m_generator;
+  }
+
+  m_generator = generator;
+}
+
+
+/**
+ * Start the generator of readings, if there is one
+ **/
+void NewSimulatorSensor::StartGenerator()
+{
+  if ( m_generator )
+     m_generator->Start();
+}
+
+
+/**
+ * Stop the generator of readings, if there is one.
+ *
+ * Derived classes have to call it in their destructor, since the generator
+ * calls SetReading().
+ **/
+void NewSimulatorSensor::StopGenerator()
+{
+  if ( m_generator )
+     m_generator->Stop();
+}
+
+
+/**
+ * Set a new reading, called by the generator
+ *
+ * @param value new value, converted to the reading type of the sensor
+ **/
+void NewSimulatorSensor::SetReading( double value )
+{
+  cThreadLockAuto al( m_data_lock );
+
+  NewSimulatorValueGenerator::FromDouble( value, DataFormat().ReadingType, m_read_data );
+}
+
+
+/**
+ * Add the state of the sensor and its generator to a snapshot
+ *
+ * @param writer snapshot writer, the rdr of the sensor was added before
+ * @param thres threshold values, NULL if the sensor has none
+ * @return success
+ **/
+bool NewSimulatorSensor::WriteSensorSnapshot( SimSnapshotWriterT *writer,
+                                              const SaHpiSensorThresholdsT *thres )
+{
+  SimSnapshotSensorT data;
+
+  memset( &data, 0, sizeof( SimSnapshotSensorT ) );
+
+  m_data_lock.Lock();
+  data.Reading       = m_read_data;
+  data.EventState    = m_event_data;
+  data.Enabled       = m_enabled;
+  if ( thres )
+     data.Thresholds = *thres;
+  m_data_lock.Unlock();
+
+  data.AssertMask    = m_assert_mask;
+  data.DeassertMask  = m_deassert_mask;
+  data.EventsEnabled = m_events_enabled;
+
+  if ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_SENSOR,
+                                &data, sizeof( data ) ) != SA_OK )
+     return false;
+
+  if ( m_generator == 0 )
+     return true;
+
+  const NewSimulatorGeneratorParams &params = m_generator->Params();
+  SimSnapshotGeneratorT gen;
+
+  memset( &gen, 0, sizeof( SimSnapshotGeneratorT ) );
+  gen.Type        = params.m_type;
+  gen.Interval    = params.m_interval;
+  gen.Period      = params.m_period;
+  gen.Seed        = params.m_seed;
+  gen.TraceFormat = params.m_trace_format;
+  gen.Loop        = params.m_loop;
+  gen.Min         = params.m_min;
+  gen.Max         = params.m_max;
+  gen.Step        = params.m_step;
+  strncpy( gen.Trace, params.m_trace, SIM_SNAPSHOT_MAX_PATH - 1 );
+
+  return sim_snapshot_add_record( writer, SIM_SNAPSHOT_GENERATOR,
+                                  &gen, sizeof( gen ) ) == SA_OK;
+}
+
+
+/**
+ * Add the state of the sensor to a snapshot
+ *
+ * @param writer snapshot writer, the rdr of the sensor was added before
+ * @return success
+ **/
+bool NewSimulatorSensor::WriteSnapshot( SimSnapshotWriterT *writer )
+{
+  return WriteSensorSnapshot( writer, 0 );
 }
 
 
@@ -380,6 +503,7 @@ bool NewSimulatorSensor::CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr ) {
  * @return HPI return code
  **/
 SaErrorT NewSimulatorSensor::GetEnable( SaHpiBoolT &enable ) {
+    cThreadLockAuto al( m_data_lock );
     enable = m_enabled;
 
     return SA_OK;
@@ -397,10 +521,14 @@ SaErrorT NewSimulatorSensor::GetEnable( SaHpiBoolT &enable ) {
  * @return HPI return code
  **/
 SaErrorT NewSimulatorSensor::SetEnable( const SaHpiBoolT &enable ) {
-    if (m_enabled == enable)
+    m_data_lock.Lock();
+    if (m_enabled == enable) {
+        m_data_lock.Unlock();
         return SA_OK;
+    }
 
     m_enabled = enable;
+    m_data_lock.Unlock();
 
     CreateEnableChangeEvent();
 
@@ -41,8 +41,13 @@ extern "C" {
 #include "new_sim_rdr.h"
 #endif
 
+#ifndef __THREAD_H__
+#include "thread.h"
+#endif
+
 
 class  NewSimulatorDomain;
+class  NewSimulatorValueGenerator;
 
 /**
  * @class NewSimulatorSensor
@@ -71,6 +76,10 @@ protected:
   SaHpiSensorReadingT    m_read_data;
   /// EventState
   SaHpiEventStateT       m_event_data;
+  /// Lock for the reading and event state, they are changed by a generator
+  cThreadLock            m_data_lock;
+  /// Generator of readings, 0 if the reading is static
+  NewSimulatorValueGenerator *m_generator;
   
   virtual bool gt(const SaHpiSensorReadingT &val1, const SaHpiSensorReadingT &val2);
   virtual bool ge(const SaHpiSensorReadingT &val1, const SaHpiSensorReadingT &val2);
@@ -78,6 +87,9 @@ protected:
   virtual bool le(const SaHpiSensorReadingT &val1, const SaHpiSensorReadingT &val2);
   virtual bool eq(const SaHpiSensorReadingT &val1, const SaHpiSensorReadingT &val2);
   virtual bool ltZero(const SaHpiSensorReadingT &val1);
+
+  bool WriteSensorSnapshot( SimSnapshotWriterT *writer,
+                            const SaHpiSensorThresholdsT *thres );
   
 public:
   NewSimulatorSensor( NewSimulatorResource *res );
@@ -130,6 +142,14 @@ public:
   /// create an RDR sensor record
   virtual bool CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr );
 
+  void SetGenerator( NewSimulatorValueGenerator *generator );
+  void StartGenerator();
+  void StopGenerator();
+  /// Return the generator of readings
+  NewSimulatorValueGenerator *Generator() const { return m_generator; }
+  virtual void SetReading( double value );
+  virtual bool WriteSnapshot( SimSnapshotWriterT *writer );
+
   // Official HPI functions
   /// abstract method for the GetSensorReading command
   virtual SaErrorT GetSensorReading( SaHpiSensorReadingT &data, SaHpiEventStateT &state ) = 0;
@@ -57,6 +57,7 @@ NewSimulatorSensorCommon::NewSimulatorSensorCommon( NewSimulatorResource *res,
  **/
 NewSimulatorSensorCommon::~NewSimulatorSensorCommon()
 {
+  StopGenerator();
 }
 
 
@@ -94,6 +95,9 @@ SaErrorT NewSimulatorSensorCommon::GetSensorReading( SaHpiSensorReadingT &data,
                                                      SaHpiEventStateT &state ) {
 
   stdlog << "DBG: NewSimulatorSensorCommon::GetSensorReading is called\n";                                                 	
+  // the value generator changes the reading from the timer thread
+  cThreadLockAuto al( m_data_lock );
+
   if ( m_enabled == SAHPI_FALSE )
      return SA_ERR_HPI_INVALID_REQUEST;
 
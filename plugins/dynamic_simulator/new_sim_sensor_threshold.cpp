@@ -20,6 +20,7 @@
 #include "new_sim_sensor_threshold.h"
 #include "new_sim_log.h"
 #include "new_sim_domain.h"
+#include "new_sim_value_generator.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -62,6 +63,7 @@ NewSimulatorSensorThreshold::NewSimulatorSensorThreshold( NewSimulatorResource *
  **/
 NewSimulatorSensorThreshold::~NewSimulatorSensorThreshold()
 {
+  StopGenerator();
 }
 
 
@@ -335,6 +337,18 @@ bool NewSimulatorSensorThreshold::CreateRdr( SaHpiRptEntryT &resource,
   return true;
 }
 
+
+/**
+ * Add the state of the sensor including the thresholds to a snapshot
+ *
+ * @param writer snapshot writer, the rdr of the sensor was added before
+ * @return success
+ **/
+bool NewSimulatorSensorThreshold::WriteSnapshot( SimSnapshotWriterT *writer ) {
+
+  return WriteSensorSnapshot( writer, &m_thres );
+}
+
 /** 
  * HPI function saHpiSensorReadingGet()
  * 
@@ -350,6 +364,9 @@ SaErrorT NewSimulatorSensorThreshold::GetSensorReading( SaHpiSensorReadingT &dat
                                                         SaHpiEventStateT &state ) {
 
    stdlog << "DBG: NewSimulatorSensorThreshold::GetSensorReading is called\n";
+   // the value generator changes the reading from the timer thread
+   cThreadLockAuto al( m_data_lock );
+
    if ( m_enabled == SAHPI_FALSE )
       return SA_ERR_HPI_INVALID_REQUEST;
 
@@ -381,7 +398,9 @@ SaErrorT NewSimulatorSensorThreshold::GetThresholds( SaHpiSensorThresholdsT &thr
         ( m_read_thold == 0 ))
       return SA_ERR_HPI_INVALID_CMD;
 
+   m_data_lock.Lock();
    memcpy(&thres, &m_thres, sizeof(SaHpiSensorThresholdsT));
+   m_data_lock.Unlock();
    setMask(thres, m_read_thold);
   
    return SA_OK;
@@ -480,7 +499,9 @@ SaErrorT NewSimulatorSensorThreshold::SetThresholds( const SaHpiSensorThresholds
       return rv; 
    
    // Ok, it seems everything is fine - take the new values    
+   m_data_lock.Lock();
    memcpy( &m_thres, &tmp, sizeof(SaHpiSensorThresholdsT));
+   m_data_lock.Unlock();
 
    return SA_OK;
 }
@@ -653,3 +674,133 @@ void NewSimulatorSensorThreshold::setMask( SaHpiSensorThresholdsT &thres,
    }
                                            	
 }
+
+
+/** 
+ * Set a new reading, called by the value generator
+ * 
+ * The event states are calculated with the thresholds and hysteresis
+ * values. For every threshold state which changed, a sensor event is
+ * sent if the sensor, its events and the state in the assertion or
+ * deassertion mask are enabled.
+ * 
+ * @param value new reading
+ **/
+void NewSimulatorSensorThreshold::SetReading( double value ) {
+   const SaHpiEventStateT states[] = { SAHPI_ES_LOWER_MINOR, SAHPI_ES_LOWER_MAJOR,
+                                       SAHPI_ES_LOWER_CRIT, SAHPI_ES_UPPER_MINOR,
+                                       SAHPI_ES_UPPER_MAJOR, SAHPI_ES_UPPER_CRIT };
+   SaHpiSensorReadingT thresholds[6];
+   SaHpiSensorReadingT reading;
+   SaHpiEventStateT previous, current;
+
+   m_data_lock.Lock();
+
+   NewSimulatorValueGenerator::FromDouble( value, DataFormat().ReadingType, m_read_data );
+   reading = m_read_data;
+   previous = m_event_data;
+   current = NewSimulatorValueGenerator::ThresholdState( value, m_thres, previous );
+   current &= EventStates();
+   m_event_data = current;
+
+   thresholds[0] = m_thres.LowMinor;
+   thresholds[1] = m_thres.LowMajor;
+   thresholds[2] = m_thres.LowCritical;
+   thresholds[3] = m_thres.UpMinor;
+   thresholds[4] = m_thres.UpMajor;
+   thresholds[5] = m_thres.UpCritical;
+
+   SaHpiBoolT enabled = m_enabled;
+
+   m_data_lock.Unlock();
+
+   if ( ( previous == current ) || ( enabled == SAHPI_FALSE ) 
+        || ( m_events_enabled == SAHPI_FALSE ) )
+      return;
+
+   for ( int i = 0; i < 6; i++ ) {
+      if ( !( ( previous ^ current ) & states[i] ) )
+         continue;
+
+      if ( current & states[i] ) {
+         if ( m_assert_mask & states[i] )
+            CreateThresholdEvent( states[i], SAHPI_TRUE, reading, thresholds[i],
+                                  previous, current );
+      } else {
+         if ( m_deassert_mask & states[i] )
+            CreateThresholdEvent( states[i], SAHPI_FALSE, reading, thresholds[i],
+                                  previous, current );
+      }
+   }
+}
+
+
+/** 
+ * Send a threshold sensor event
+ * 
+ * @param event_state threshold state which changed
+ * @param assertion state is asserted or deasserted
+ * @param reading reading which triggered the event
+ * @param threshold threshold which was crossed
+ * @param previous event states before the reading
+ * @param current event states after the reading
+ **/
+void NewSimulatorSensorThreshold::CreateThresholdEvent( SaHpiEventStateT event_state,
+                                                        SaHpiBoolT assertion,
+                                                        const SaHpiSensorReadingT &reading,
+                                                        const SaHpiSensorReadingT &threshold,
+                                                        SaHpiEventStateT previous,
+                                                        SaHpiEventStateT current ) {
+   NewSimulatorResource *res = Resource();
+   if( !res ) {
+      stdlog << "CreateThresholdEvent: No resource !\n";
+      return;
+   }
+
+   oh_event *e = (oh_event *)g_malloc0( sizeof( struct oh_event ) );
+
+   SaHpiRptEntryT *rptentry = oh_get_resource_by_id( res->Domain()->GetHandler()->rptcache, res->ResourceId() );
+   SaHpiRdrT *rdrentry = oh_get_rdr_by_id( res->Domain()->GetHandler()->rptcache, res->ResourceId(), m_record_id );
+
+   if ( rptentry )
+      e->resource = *rptentry;
+   else
+      e->resource.ResourceCapabilities = 0;
+
+   if ( rdrentry )
+      e->rdrs = g_slist_append(e->rdrs, g_memdup(rdrentry, sizeof(SaHpiRdrT)));
+   else
+      e->rdrs = NULL;
+
+   // hpi event
+   e->event.Source    = res->ResourceId();
+   e->event.EventType = SAHPI_ET_SENSOR;
+
+   if ( event_state & ( SAHPI_ES_LOWER_CRIT | SAHPI_ES_UPPER_CRIT ) )
+      e->event.Severity = SAHPI_CRITICAL;
+   else if ( event_state & ( SAHPI_ES_LOWER_MAJOR | SAHPI_ES_UPPER_MAJOR ) )
+      e->event.Severity = SAHPI_MAJOR;
+   else
+      e->event.Severity = SAHPI_MINOR;
+
+   oh_gettimeofday(&e->event.Timestamp);
+
+   // sensor event
+   SaHpiSensorEventT *se = &e->event.EventDataUnion.SensorEvent;
+   se->SensorNum     = m_sensor_record.Num;
+   se->SensorType    = Type();
+   se->EventCategory = SAHPI_EC_THRESHOLD;
+   se->Assertion     = assertion;
+   se->EventState    = event_state;
+   se->OptionalDataPresent = SAHPI_SOD_TRIGGER_READING | SAHPI_SOD_TRIGGER_THRESHOLD
+                             | SAHPI_SOD_PREVIOUS_STATE | SAHPI_SOD_CURRENT_STATE;
+   se->TriggerReading   = reading;
+   se->TriggerThreshold = threshold;
+   se->PreviousState = previous;
+   se->CurrentState  = current;
+
+   stdlog << "DBG: NewSimulatorSensorThreshold::CreateThresholdEvent resource " 
+          << res->ResourceId() << " sensor " << m_sensor_record.Num
+          << ( assertion ? " assert " : " deassert " ) << event_state << "\n";
+   res->Domain()->AddHpiEvent( e );
+}
@@ -48,6 +48,11 @@ private:
    SaErrorT checkOrdering( const SaHpiSensorThresholdsT &thres );
    
    void setMask( SaHpiSensorThresholdsT &thres, const SaHpiSensorThdMaskT mask);
+   
+   void CreateThresholdEvent( SaHpiEventStateT event_state, SaHpiBoolT assertion,
+                              const SaHpiSensorReadingT &reading,
+                              const SaHpiSensorReadingT &threshold,
+                              SaHpiEventStateT previous, SaHpiEventStateT current );
 
 
 public:
@@ -72,6 +77,9 @@ public:
   bool Cmp( const NewSimulatorSensor &s2 ) const;
   // create an RDR sensor record
   virtual bool CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr );
+  virtual bool WriteSnapshot( SimSnapshotWriterT *writer );
+  // set a new reading and send threshold events
+  virtual void SetReading( double value );
 
   // official hpi functions 
 
@@ -0,0 +1,588 @@
+/**
+ * @file    new_sim_snapshot.c
+ *
+ * The file includes the writer and the reader of the binary snapshot
+ * format, see new_sim_snapshot.h.
+ *
+ * @version 0.1
+ * @date    2026
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <oh_error.h>
+
+#include "new_sim_snapshot.h"
+
+/// Round a size up to the alignment of the format
+#define SNAPSHOT_ALIGN( x ) ( ( (x) + SIM_SNAPSHOT_ALIGN - 1 ) & ~( (SaHpiUint64T) SIM_SNAPSHOT_ALIGN - 1 ) )
+
+/// Growing memory buffer of the writer
+typedef struct {
+   unsigned char *Data;
+   size_t         Len;
+   size_t         Size;
+} SnapshotBufferT;
+
+/// Data collected by the writer
+struct SimSnapshotWriter {
+   SnapshotBufferT Rpts;
+   SnapshotBufferT Rdrs;
+   SnapshotBufferT Data;
+   SaHpiUint32T    NumRpts;
+   SaHpiUint32T    NumRdrs;
+};
+
+
+/**
+ * Append data to a buffer, the buffer grows by doubling its size
+ *
+ * @param buf buffer
+ * @param data data to be appended, zeros if NULL
+ * @param len number of bytes
+ * @return pointer on the appended bytes or NULL if out of memory
+ **/
+static void *buffer_append( SnapshotBufferT *buf, const void *data, size_t len ) {
+   void *dst;
+
+   if ( buf->Len + len > buf->Size ) {
+      size_t size = buf->Size ? buf->Size : 4096;
+      unsigned char *n;
+
+      while ( size < buf->Len + len )
+         size *= 2;
+
+      n = (unsigned char *) realloc( buf->Data, size );
+      if ( n == NULL )
+         return NULL;
+
+      buf->Data = n;
+      buf->Size = size;
+   }
+
+   dst = buf->Data + buf->Len;
+
+   if ( data )
+      memcpy( dst, data, len );
+   else
+      memset( dst, 0, len );
+
+   buf->Len += len;
+
+   return dst;
+}
+
+
+/**
+ * Return the minimal payload size of a record
+ *
+ * @param tag tag of the record
+ * @return size or 0 for unknown tags
+ **/
+static size_t record_min_size( SaHpiUint32T tag ) {
+
+   switch ( tag ) {
+      case SIM_SNAPSHOT_SENSOR:       return sizeof( SimSnapshotSensorT );
+      case SIM_SNAPSHOT_GENERATOR:    return sizeof( SimSnapshotGeneratorT );
+      case SIM_SNAPSHOT_CONTROL:      return sizeof( SimSnapshotControlT );
+      case SIM_SNAPSHOT_IDR_INFO:     return sizeof( SaHpiIdrInfoT );
+      case SIM_SNAPSHOT_IDR_AREA:     return sizeof( SaHpiIdrAreaHeaderT );
+      case SIM_SNAPSHOT_IDR_FIELD:    return sizeof( SaHpiIdrFieldT );
+      case SIM_SNAPSHOT_WATCHDOG:     return sizeof( SaHpiWatchdogT );
+      case SIM_SNAPSHOT_ANN_MODE:     return sizeof( SimSnapshotAnnunciatorT );
+      case SIM_SNAPSHOT_ANNOUNCEMENT: return sizeof( SaHpiAnnouncementT );
+      case SIM_SNAPSHOT_DIMI_INFO:    return sizeof( SaHpiDimiInfoT );
+      case SIM_SNAPSHOT_DIMI_TEST:    return sizeof( SimSnapshotDimiTestT );
+      case SIM_SNAPSHOT_FUMI_INFO:    return sizeof( SimSnapshotFumiT );
+      case SIM_SNAPSHOT_FUMI_BANK:    return sizeof( SimSnapshotFumiBankT );
+   }
+
+   return 0;
+}
+
+
+/**
+ * Create a new writer
+ *
+ * @return writer or NULL if out of memory
+ **/
+SimSnapshotWriterT *sim_snapshot_writer_new( void ) {
+
+   return (SimSnapshotWriterT *) calloc( 1, sizeof( SimSnapshotWriterT ) );
+}
+
+
+/**
+ * Free a writer and the collected data
+ *
+ * @param writer writer to be freed
+ **/
+void sim_snapshot_writer_free( SimSnapshotWriterT *writer ) {
+
+   if ( writer == NULL )
+      return;
+
+   free( writer->Rpts.Data );
+   free( writer->Rdrs.Data );
+   free( writer->Data.Data );
+   free( writer );
+}
+
+
+/**
+ * Add a resource, the following rdr belong to it
+ *
+ * @param writer writer
+ * @param rpt rpt entry of the resource
+ * @return SA_OK or SA_ERR_HPI_OUT_OF_MEMORY
+ **/
+SaErrorT sim_snapshot_add_rpt( SimSnapshotWriterT *writer, const SaHpiRptEntryT *rpt ) {
+   SimSnapshotRptT *r;
+
+   r = (SimSnapshotRptT *) buffer_append( &writer->Rpts, NULL, sizeof( SimSnapshotRptT ) );
+   if ( r == NULL )
+      return SA_ERR_HPI_OUT_OF_MEMORY;
+
+   memcpy( &r->Rpt, rpt, sizeof( SaHpiRptEntryT ) );
+   r->FirstRdr = writer->NumRdrs;
+   r->NumRdr = 0;
+   writer->NumRpts++;
+
+   return SA_OK;
+}
+
+
+/**
+ * Add a rdr to the latest resource, the following records belong to it
+ *
+ * @param writer writer
+ * @param rdr rdr entry
+ * @return SA_OK, SA_ERR_HPI_INVALID_REQUEST without resource or
+ *         SA_ERR_HPI_OUT_OF_MEMORY
+ **/
+SaErrorT sim_snapshot_add_rdr( SimSnapshotWriterT *writer, const SaHpiRdrT *rdr ) {
+   SimSnapshotRdrT *r;
+
+   if ( writer->NumRpts == 0 )
+      return SA_ERR_HPI_INVALID_REQUEST;
+
+   r = (SimSnapshotRdrT *) buffer_append( &writer->Rdrs, NULL, sizeof( SimSnapshotRdrT ) );
+   if ( r == NULL )
+      return SA_ERR_HPI_OUT_OF_MEMORY;
+
+   memcpy( &r->Rdr, rdr, sizeof( SaHpiRdrT ) );
+   r->NumRecords = 0;
+   r->DataSize = 0;
+   r->DataOffset = writer->Data.Len;
+   writer->NumRdrs++;
+
+   ((SimSnapshotRptT *) writer->Rpts.Data)[writer->NumRpts - 1].NumRdr++;
+
+   return SA_OK;
+}
+
+
+/**
+ * Add a record to the latest rdr
+ *
+ * @param writer writer
+ * @param tag tag of the record
+ * @param data payload
+ * @param size size of the payload
+ * @return SA_OK, SA_ERR_HPI_INVALID_REQUEST without rdr, SA_ERR_HPI_INVALID_PARAMS
+ *         for a too small payload or SA_ERR_HPI_OUT_OF_MEMORY
+ **/
+SaErrorT sim_snapshot_add_record( SimSnapshotWriterT *writer, SaHpiUint32T tag,
+                                  const void *data, SaHpiUint32T size ) {
+   SimSnapshotRdrT *r;
+   SimSnapshotRecordT rec;
+   size_t len = sizeof( SimSnapshotRecordT ) + SNAPSHOT_ALIGN( size );
+   unsigned char *dst;
+
+   if ( writer->NumRdrs == 0 )
+      return SA_ERR_HPI_INVALID_REQUEST;
+
+   if ( size < record_min_size( tag ) )
+      return SA_ERR_HPI_INVALID_PARAMS;
+
+   r = &((SimSnapshotRdrT *) writer->Rdrs.Data)[writer->NumRdrs - 1];
+
+   if ( r->DataSize + len > 0xffffffffUL )
+      return SA_ERR_HPI_OUT_OF_SPACE;
+
+   dst = (unsigned char *) buffer_append( &writer->Data, NULL, len );
+   if ( dst == NULL )
+      return SA_ERR_HPI_OUT_OF_MEMORY;
+
+   rec.Tag = tag;
+   rec.Size = size;
+   memcpy( dst, &rec, sizeof( SimSnapshotRecordT ) );
+   memcpy( dst + sizeof( SimSnapshotRecordT ), data, size );
+
+   r->NumRecords++;
+   r->DataSize += len;
+
+   return SA_OK;
+}
+
+
+/**
+ * Write the collected data into a file
+ *
+ * The file is written under a temporary name and renamed afterwards,
+ * so a running plugin never sees a partial snapshot.
+ *
+ * @param writer writer
+ * @param filename name of the snapshot
+ * @return SA_OK or SA_ERR_HPI_ERROR if the file couldn't be written
+ **/
+SaErrorT sim_snapshot_writer_save( SimSnapshotWriterT *writer, const char *filename ) {
+   SimSnapshotHeaderT header;
+   const SnapshotBufferT *bufs[SIM_SNAPSHOT_NUM_SECTIONS];
+   static const unsigned char zeros[SIM_SNAPSHOT_ALIGN] = { 0 };
+   SaHpiUint64T offset;
+   char *tmp;
+   FILE *f;
+   int i, ok = 1;
+
+   bufs[SIM_SNAPSHOT_SECTION_RPT]  = &writer->Rpts;
+   bufs[SIM_SNAPSHOT_SECTION_RDR]  = &writer->Rdrs;
+   bufs[SIM_SNAPSHOT_SECTION_DATA] = &writer->Data;
+
+   memset( &header, 0, sizeof( SimSnapshotHeaderT ) );
+   memcpy( header.Magic, SIM_SNAPSHOT_MAGIC, SIM_SNAPSHOT_MAGIC_LEN );
+   header.Version     = SIM_SNAPSHOT_VERSION;
+   header.ByteOrder   = SIM_SNAPSHOT_BYTE_ORDER;
+   header.HeaderSize  = sizeof( SimSnapshotHeaderT );
+   header.RptSize     = sizeof( SaHpiRptEntryT );
+   header.RdrSize     = sizeof( SaHpiRdrT );
+   header.NumSections = SIM_SNAPSHOT_NUM_SECTIONS;
+
+   offset = SNAPSHOT_ALIGN( sizeof( SimSnapshotHeaderT ) );
+
+   for ( i = 0; i < SIM_SNAPSHOT_NUM_SECTIONS; i++ ) {
+      header.Sections[i].Type   = i;
+      header.Sections[i].Offset = offset;
+      header.Sections[i].Size   = bufs[i]->Len;
+      offset = SNAPSHOT_ALIGN( offset + bufs[i]->Len );
+   }
+
+   header.Sections[SIM_SNAPSHOT_SECTION_RPT].Count  = writer->NumRpts;
+   header.Sections[SIM_SNAPSHOT_SECTION_RDR].Count  = writer->NumRdrs;
+   header.Sections[SIM_SNAPSHOT_SECTION_DATA].Count = 0;
+   header.FileSize = offset;
+
+   tmp = (char *) malloc( strlen( filename ) + 5 );
+   if ( tmp == NULL )
+      return SA_ERR_HPI_OUT_OF_MEMORY;
+
+   sprintf( tmp, "%s.tmp", filename );
+
+   f = fopen( tmp, "wb" );
+   if ( f == NULL ) {
+      err( "Snapshot file '%s' could not be opened for writing", tmp );
+      free( tmp );
+      return SA_ERR_HPI_ERROR;
+   }
+
+   if ( fwrite( &header, sizeof( header ), 1, f ) != 1 )
+      ok = 0;
+
+   offset = sizeof( header );
+
+   for ( i = 0; ok && i < SIM_SNAPSHOT_NUM_SECTIONS; i++ ) {
+      size_t pad = header.Sections[i].Offset - offset;
+
+      if ( pad && fwrite( zeros, pad, 1, f ) != 1 )
+         ok = 0;
+
+      if ( ok && bufs[i]->Len && fwrite( bufs[i]->Data, bufs[i]->Len, 1, f ) != 1 )
+         ok = 0;
+
+      offset = header.Sections[i].Offset + bufs[i]->Len;
+   }
+
+   if ( ok && header.FileSize > offset
+        && fwrite( zeros, header.FileSize - offset, 1, f ) != 1 )
+      ok = 0;
+
+   if ( fclose( f ) != 0 )
+      ok = 0;
+
+   if ( ok && rename( tmp, filename ) != 0 )
+      ok = 0;
+
+   if ( !ok ) {
+      err( "Snapshot file '%s' could not be written", filename );
+      unlink( tmp );
+   }
+
+   free( tmp );
+
+   return ok ? SA_OK : SA_ERR_HPI_ERROR;
+}
+
+
+/**
+ * Check if a file starts with the magic of a snapshot
+ *
+ * @param filename name of the file
+ * @return 1 for a snapshot, 0 otherwise
+ **/
+int sim_snapshot_probe( const char *filename ) {
+   char magic[SIM_SNAPSHOT_MAGIC_LEN];
+   int fd, rv = 0;
+
+   fd = open( filename, O_RDONLY );
+   if ( fd < 0 )
+      return 0;
+
+   if ( read( fd, magic, SIM_SNAPSHOT_MAGIC_LEN ) == SIM_SNAPSHOT_MAGIC_LEN
+        && !memcmp( magic, SIM_SNAPSHOT_MAGIC, SIM_SNAPSHOT_MAGIC_LEN ) )
+      rv = 1;
+
+   close( fd );
+
+   return rv;
+}
+
+
+/**
+ * Check that a section lies inside the file and holds count entries of
+ * a given size
+ **/
+static int check_section( const SimSnapshotSectionT *s, SaHpiUint32T type,
+                          SaHpiUint64T file_size, size_t entry_size ) {
+
+   if ( s->Type != type || s->Offset % SIM_SNAPSHOT_ALIGN )
+      return 0;
+
+   if ( s->Offset > file_size || s->Size > file_size - s->Offset )
+      return 0;
+
+   if ( entry_size && s->Size != (SaHpiUint64T) s->Count * entry_size )
+      return 0;
+
+   return 1;
+}
+
+
+/**
+ * Check all references between the sections and the records of one rdr
+ **/
+static int check_rdr( const SimSnapshotT *snap, const SimSnapshotRdrT *rdr ) {
+   SaHpiUint64T pos = rdr->DataOffset, end;
+   SaHpiUint32T i;
+
+   if ( pos % SIM_SNAPSHOT_ALIGN || pos > snap->DataSize
+        || rdr->DataSize > snap->DataSize - pos )
+      return 0;
+
+   end = pos + rdr->DataSize;
+
+   for ( i = 0; i < rdr->NumRecords; i++ ) {
+      const SimSnapshotRecordT *rec;
+      SaHpiUint64T len;
+
+      if ( end - pos < sizeof( SimSnapshotRecordT ) )
+         return 0;
+
+      rec = (const SimSnapshotRecordT *) ( snap->Data + pos );
+      len = sizeof( SimSnapshotRecordT ) + SNAPSHOT_ALIGN( (SaHpiUint64T) rec->Size );
+
+      if ( len > end - pos || rec->Size < record_min_size( rec->Tag ) )
+         return 0;
+
+      pos += len;
+   }
+
+   return pos == end;
+}
+
+
+/**
+ * Map a snapshot into memory and verify it
+ *
+ * Every offset and count inside the file is checked, so the structures
+ * and the record iteration can be used afterwards without further checks.
+ *
+ * @param filename name of the snapshot
+ * @param snap structure to be filled
+ * @return SA_OK, SA_ERR_HPI_ERROR if the file couldn't be read or
+ *         SA_ERR_HPI_INVALID_DATA if it isn't a valid snapshot
+ **/
+SaErrorT sim_snapshot_open( const char *filename, SimSnapshotT *snap ) {
+   const SimSnapshotHeaderT *h;
+   const SimSnapshotSectionT *s;
+   struct stat st;
+   SaHpiUint32T i;
+   int fd;
+
+   memset( snap, 0, sizeof( SimSnapshotT ) );
+
+   fd = open( filename, O_RDONLY );
+   if ( fd < 0 ) {
+      err( "Snapshot file '%s' could not be opened", filename );
+      return SA_ERR_HPI_ERROR;
+   }
+
+   if ( fstat( fd, &st ) != 0 || (size_t) st.st_size < sizeof( SimSnapshotHeaderT ) ) {
+      err( "Snapshot file '%s' is too short", filename );
+      close( fd );
+      return SA_ERR_HPI_INVALID_DATA;
+   }
+
+   snap->MapSize = st.st_size;
+   snap->Map = mmap( NULL, snap->MapSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+   close( fd );
+
+   if ( snap->Map == MAP_FAILED ) {
+      err( "Snapshot file '%s' could not be mapped", filename );
+      snap->Map = NULL;
+      return SA_ERR_HPI_ERROR;
+   }
+
+   h = snap->Header = (const SimSnapshotHeaderT *) snap->Map;
+
+   if ( memcmp( h->Magic, SIM_SNAPSHOT_MAGIC, SIM_SNAPSHOT_MAGIC_LEN )
+        || h->ByteOrder != SIM_SNAPSHOT_BYTE_ORDER
+        || h->Version != SIM_SNAPSHOT_VERSION ) {
+      err( "Snapshot file '%s' has an unknown version or byte order", filename );
+      goto invalid;
+   }
+
+   if ( h->HeaderSize != sizeof( SimSnapshotHeaderT )
+        || h->RptSize != sizeof( SaHpiRptEntryT )
+        || h->RdrSize != sizeof( SaHpiRdrT )
+        || h->NumSections != SIM_SNAPSHOT_NUM_SECTIONS ) {
+      err( "Snapshot file '%s' was written with other HPI structures", filename );
+      goto invalid;
+   }
+
+   if ( h->FileSize != snap->MapSize
+        || !check_section( &h->Sections[SIM_SNAPSHOT_SECTION_RPT], SIM_SNAPSHOT_SECTION_RPT,
+                           h->FileSize, sizeof( SimSnapshotRptT ) )
+        || !check_section( &h->Sections[SIM_SNAPSHOT_SECTION_RDR], SIM_SNAPSHOT_SECTION_RDR,
+                           h->FileSize, sizeof( SimSnapshotRdrT ) )
+        || !check_section( &h->Sections[SIM_SNAPSHOT_SECTION_DATA], SIM_SNAPSHOT_SECTION_DATA,
+                           h->FileSize, 0 ) ) {
+      err( "Snapshot file '%s' has broken sections", filename );
+      goto invalid;
+   }
+
+   s = &h->Sections[SIM_SNAPSHOT_SECTION_RPT];
+   snap->Rpts = (const SimSnapshotRptT *) ( (const char *) snap->Map + s->Offset );
+   snap->NumRpts = s->Count;
+
+   s = &h->Sections[SIM_SNAPSHOT_SECTION_RDR];
+   snap->Rdrs = (const SimSnapshotRdrT *) ( (const char *) snap->Map + s->Offset );
+   snap->NumRdrs = s->Count;
+
+   s = &h->Sections[SIM_SNAPSHOT_SECTION_DATA];
+   snap->Data = (const unsigned char *) snap->Map + s->Offset;
+   snap->DataSize = s->Size;
+
+   for ( i = 0; i < snap->NumRpts; i++ ) {
+      const SimSnapshotRptT *rpt = &snap->Rpts[i];
+
+      if ( rpt->FirstRdr > snap->NumRdrs || rpt->NumRdr > snap->NumRdrs - rpt->FirstRdr ) {
+         err( "Snapshot file '%s': rpt entry %u refers to missing rdr", filename, i );
+         goto invalid;
+      }
+   }
+
+   for ( i = 0; i < snap->NumRdrs; i++ ) {
+      if ( !check_rdr( snap, &snap->Rdrs[i] ) ) {
+         err( "Snapshot file '%s': rdr entry %u has broken records", filename, i );
+         goto invalid;
+      }
+   }
+
+   return SA_OK;
+
+invalid:
+   sim_snapshot_close( snap );
+
+   return SA_ERR_HPI_INVALID_DATA;
+}
+
+
+/**
+ * Unmap a snapshot
+ *
+ * @param snap snapshot filled by sim_snapshot_open()
+ **/
+void sim_snapshot_close( SimSnapshotT *snap ) {
+
+   if ( snap->Map )
+      munmap( snap->Map, snap->MapSize );
+
+   memset( snap, 0, sizeof( SimSnapshotT ) );
+}
+
+
+/**
+ * Return the first record of a rdr
+ *
+ * @param snap snapshot
+ * @param rdr rdr entry of the snapshot
+ * @return first record or NULL if the rdr has no records
+ **/
+const SimSnapshotRecordT *sim_snapshot_first_record( const SimSnapshotT *snap,
+                                                     const SimSnapshotRdrT *rdr ) {
+
+   if ( rdr->NumRecords == 0 )
+      return NULL;
+
+   return (const SimSnapshotRecordT *) ( snap->Data + rdr->DataOffset );
+}
+
+
+/**
+ * Return the record following another one
+ *
+ * @param snap snapshot
+ * @param rdr rdr entry of the snapshot
+ * @param rec current record
+ * @return next record or NULL at the end of the records of the rdr
+ **/
+const SimSnapshotRecordT *sim_snapshot_next_record( const SimSnapshotT *snap,
+                                                    const SimSnapshotRdrT *rdr,
+                                                    const SimSnapshotRecordT *rec ) {
+   const unsigned char *next;
+
+   next = (const unsigned char *) rec + sizeof( SimSnapshotRecordT ) + SNAPSHOT_ALIGN( rec->Size );
+
+   if ( next >= snap->Data + rdr->DataOffset + rdr->DataSize )
+      return NULL;
+
+   return (const SimSnapshotRecordT *) next;
+}
+
+
+/**
+ * Return the payload of a record
+ *
+ * @param rec record
+ * @return pointer on the payload
+ **/
+const void *sim_snapshot_record_data( const SimSnapshotRecordT *rec ) {
+
+   return (const unsigned char *) rec + sizeof( SimSnapshotRecordT );
+}
@@ -0,0 +1,231 @@
+/**
+ * @file    new_sim_snapshot.h
+ *
+ * The file includes the binary snapshot format of a simulation:\n
+ * the file layout, a writer and a memory mapped reader.
+ *
+ * A snapshot holds the same information as a simulation file in the text
+ * format. It is written by hpigensimdata or converted from a text file by
+ * the plugin and can be loaded without parsing. The file starts with
+ * a SimSnapshotHeaderT which gives the offsets of three sections:
+ *
+ * - RPT:  array of SimSnapshotRptT, each one refers to its rdr entries
+ * - RDR:  array of SimSnapshotRdrT, each one refers to its records
+ * - DATA: SimSnapshotRecordT records with the state of the rdr
+ *         (sensor reading, control state, inventory areas, ...)
+ *
+ * All sections and records are aligned to 8 bytes, so the structures can
+ * be used directly inside the mapped file. The HPI structures are stored
+ * in host byte order; a file written on another architecture or with other
+ * HPI structure sizes is refused.
+ *
+ * The code is plain C, so it can be used by the clients as well.
+ *
+ * @version 0.1
+ * @date    2026
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __NEW_SIM_SNAPSHOT_H__
+#define __NEW_SIM_SNAPSHOT_H__
+
+#include <stddef.h>
+#include <SaHpi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Magic at the start of a snapshot
+#define SIM_SNAPSHOT_MAGIC      "OHSIMSNP"
+/// Length of the magic
+#define SIM_SNAPSHOT_MAGIC_LEN  8
+/// Version of the format
+#define SIM_SNAPSHOT_VERSION    1
+/// Written in host byte order, used to detect a foreign byte order
+#define SIM_SNAPSHOT_BYTE_ORDER 0x01020304
+/// Alignment of sections and records
+#define SIM_SNAPSHOT_ALIGN      8
+/// Maximal length of a trace file name of a generator
+#define SIM_SNAPSHOT_MAX_PATH   256
+
+/// Sections of a snapshot
+typedef enum {
+   SIM_SNAPSHOT_SECTION_RPT = 0,
+   SIM_SNAPSHOT_SECTION_RDR,
+   SIM_SNAPSHOT_SECTION_DATA,
+   SIM_SNAPSHOT_NUM_SECTIONS
+} SimSnapshotSectionTypeT;
+
+/// Tags of the records inside the DATA section
+typedef enum {
+   SIM_SNAPSHOT_SENSOR = 1,     //!< SimSnapshotSensorT
+   SIM_SNAPSHOT_GENERATOR,      //!< SimSnapshotGeneratorT
+   SIM_SNAPSHOT_CONTROL,        //!< SimSnapshotControlT
+   SIM_SNAPSHOT_IDR_INFO,       //!< SaHpiIdrInfoT
+   SIM_SNAPSHOT_IDR_AREA,       //!< SaHpiIdrAreaHeaderT, followed by its fields
+   SIM_SNAPSHOT_IDR_FIELD,      //!< SaHpiIdrFieldT of the latest area
+   SIM_SNAPSHOT_WATCHDOG,       //!< SaHpiWatchdogT
+   SIM_SNAPSHOT_ANN_MODE,       //!< SimSnapshotAnnunciatorT
+   SIM_SNAPSHOT_ANNOUNCEMENT,   //!< SaHpiAnnouncementT
+   SIM_SNAPSHOT_DIMI_INFO,      //!< SaHpiDimiInfoT
+   SIM_SNAPSHOT_DIMI_TEST,      //!< SimSnapshotDimiTestT
+   SIM_SNAPSHOT_FUMI_INFO,      //!< SimSnapshotFumiT
+   SIM_SNAPSHOT_FUMI_BANK       //!< SimSnapshotFumiBankT
+} SimSnapshotTagT;
+
+/// Position of one section
+typedef struct {
+   SaHpiUint32T Type;          //!< SimSnapshotSectionTypeT
+   SaHpiUint32T Count;         //!< Number of entries
+   SaHpiUint64T Offset;        //!< Offset from the start of the file
+   SaHpiUint64T Size;          //!< Size in bytes
+} SimSnapshotSectionT;
+
+/// Start of a snapshot file
+typedef struct {
+   char                Magic[SIM_SNAPSHOT_MAGIC_LEN];
+   SaHpiUint32T        Version;
+   SaHpiUint32T        ByteOrder;
+   SaHpiUint32T        HeaderSize;  //!< sizeof( SimSnapshotHeaderT )
+   SaHpiUint32T        RptSize;     //!< sizeof( SaHpiRptEntryT ) of the writer
+   SaHpiUint32T        RdrSize;     //!< sizeof( SaHpiRdrT ) of the writer
+   SaHpiUint32T        NumSections;
+   SaHpiUint64T        FileSize;
+   SimSnapshotSectionT Sections[SIM_SNAPSHOT_NUM_SECTIONS];
+} SimSnapshotHeaderT;
+
+/// Entry of the RPT section
+typedef struct {
+   SaHpiRptEntryT Rpt;
+   SaHpiUint32T   FirstRdr;    //!< Index of the first rdr in the RDR section
+   SaHpiUint32T   NumRdr;      //!< Number of rdr of the resource
+} SimSnapshotRptT;
+
+/// Entry of the RDR section
+typedef struct {
+   SaHpiRdrT      Rdr;
+   SaHpiUint32T   NumRecords;  //!< Number of records of the rdr
+   SaHpiUint32T   DataSize;    //!< Size of the records in bytes
+   SaHpiUint64T   DataOffset;  //!< Offset of the first record inside the DATA section
+} SimSnapshotRdrT;
+
+/// Header of a record inside the DATA section, followed by the payload
+typedef struct {
+   SaHpiUint32T   Tag;         //!< SimSnapshotTagT
+   SaHpiUint32T   Size;        //!< Size of the payload without padding
+} SimSnapshotRecordT;
+
+/// Payload of SIM_SNAPSHOT_SENSOR
+typedef struct {
+   SaHpiSensorReadingT    Reading;
+   SaHpiSensorThresholdsT Thresholds;   //!< only used by threshold sensors
+   SaHpiEventStateT       EventState;
+   SaHpiEventStateT       AssertMask;
+   SaHpiEventStateT       DeassertMask;
+   SaHpiBoolT             Enabled;
+   SaHpiBoolT             EventsEnabled;
+} SimSnapshotSensorT;
+
+/// Payload of SIM_SNAPSHOT_GENERATOR, see NewSimulatorGeneratorParams
+typedef struct {
+   SaHpiUint32T   Type;
+   SaHpiUint32T   Interval;
+   SaHpiUint32T   Period;
+   SaHpiUint32T   Seed;
+   SaHpiUint32T   TraceFormat;
+   SaHpiUint32T   Loop;
+   SaHpiFloat64T  Min;
+   SaHpiFloat64T  Max;
+   SaHpiFloat64T  Step;
+   char           Trace[SIM_SNAPSHOT_MAX_PATH];
+} SimSnapshotGeneratorT;
+
+/// Payload of SIM_SNAPSHOT_CONTROL
+typedef struct {
+   SaHpiCtrlModeT  Mode;
+   SaHpiCtrlStateT State;
+} SimSnapshotControlT;
+
+/// Payload of SIM_SNAPSHOT_ANN_MODE
+typedef struct {
+   SaHpiAnnunciatorModeT Mode;
+} SimSnapshotAnnunciatorT;
+
+/// Payload of SIM_SNAPSHOT_DIMI_TEST
+typedef struct {
+   SaHpiDimiTestT        Info;
+   SaHpiDimiReadyT       Ready;
+   SaHpiBoolT            HasResults;  //!< Results are only set if the test was run
+   SaHpiDimiTestResultsT Results;
+} SimSnapshotDimiTestT;
+
+/// Payload of SIM_SNAPSHOT_FUMI_INFO
+typedef struct {
+   SaHpiFumiSpecInfoT          Spec;
+   SaHpiFumiServiceImpactDataT Impact;
+   SaHpiBoolT                  RollbackDisabled;
+} SimSnapshotFumiT;
+
+/// Payload of SIM_SNAPSHOT_FUMI_BANK, the bank id is Target.BankId
+typedef struct {
+   SaHpiFumiSourceInfoT      Source;
+   SaHpiFumiBankInfoT        Target;
+   SaHpiFumiLogicalBankInfoT Logical;
+} SimSnapshotFumiBankT;
+
+/// A snapshot file mapped into memory
+typedef struct {
+   void                     *Map;       //!< Start of the mapping
+   size_t                    MapSize;   //!< Size of the mapping
+   const SimSnapshotHeaderT *Header;
+   const SimSnapshotRptT    *Rpts;
+   SaHpiUint32T              NumRpts;
+   const SimSnapshotRdrT    *Rdrs;
+   SaHpiUint32T              NumRdrs;
+   const unsigned char      *Data;
+   SaHpiUint64T              DataSize;
+} SimSnapshotT;
+
+/// Writer of a snapshot, the data is collected in memory
+typedef struct SimSnapshotWriter SimSnapshotWriterT;
+
+
+SimSnapshotWriterT *sim_snapshot_writer_new( void );
+void                sim_snapshot_writer_free( SimSnapshotWriterT *writer );
+SaErrorT            sim_snapshot_add_rpt( SimSnapshotWriterT *writer,
+                                          const SaHpiRptEntryT *rpt );
+SaErrorT            sim_snapshot_add_rdr( SimSnapshotWriterT *writer,
+                                          const SaHpiRdrT *rdr );
+SaErrorT            sim_snapshot_add_record( SimSnapshotWriterT *writer,
+                                             SaHpiUint32T tag,
+                                             const void *data,
+                                             SaHpiUint32T size );
+SaErrorT            sim_snapshot_writer_save( SimSnapshotWriterT *writer,
+                                              const char *filename );
+
+int                 sim_snapshot_probe( const char *filename );
+SaErrorT            sim_snapshot_open( const char *filename, SimSnapshotT *snap );
+void                sim_snapshot_close( SimSnapshotT *snap );
+
+const SimSnapshotRecordT *sim_snapshot_first_record( const SimSnapshotT *snap,
+                                                     const SimSnapshotRdrT *rdr );
+const SimSnapshotRecordT *sim_snapshot_next_record( const SimSnapshotT *snap,
+                                                    const SimSnapshotRdrT *rdr,
+                                                    const SimSnapshotRecordT *rec );
+const void               *sim_snapshot_record_data( const SimSnapshotRecordT *rec );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,298 @@
+/**
+ * @file    new_sim_timer_service.cpp
+ *
+ * The file includes a class which runs all timers of a domain:\n
+ * NewSimulatorTimerService
+ *
+ * @version 0.1
+ * @date    2026
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include "new_sim_log.h"
+#include "new_sim_timer_service.h"
+#include "new_sim_timer_thread.h"
+
+
+/**
+ * Constructor
+ **/
+NewSimulatorTimerService::NewSimulatorTimerService()
+                        : m_num( 0 ),
+                          m_size( TIMER_HEAP_SIZE ),
+                          m_current( 0 ),
+                          m_expired( 0 ),
+                          m_exit( false ) {
+
+   m_heap = new NewSimulatorTimerThread *[m_size];
+}
+
+
+/**
+ * Destructor
+ **/
+NewSimulatorTimerService::~NewSimulatorTimerService() {
+
+   Shutdown();
+
+   delete [] m_heap;
+}
+
+
+/**
+ * Compare two heap entries, m_cond must be locked
+ *
+ * @return true if entry i expires before entry j
+ **/
+bool NewSimulatorTimerService::Less( int i, int j ) {
+
+   return m_heap[i]->m_expire < m_heap[j]->m_expire;
+}
+
+
+/**
+ * Put a timer at a heap position, m_cond must be locked
+ **/
+void NewSimulatorTimerService::Place( int i, NewSimulatorTimerThread *timer ) {
+
+   m_heap[i] = timer;
+   timer->m_heap_idx = i;
+}
+
+
+/**
+ * Move an entry towards the root of the heap, m_cond must be locked
+ **/
+void NewSimulatorTimerService::Up( int i ) {
+
+   while( i > 0 ) {
+      int parent = ( i - 1 ) / 2;
+
+      if ( !Less( i, parent ) )
+         break;
+
+      NewSimulatorTimerThread *timer = m_heap[i];
+      Place( i, m_heap[parent] );
+      Place( parent, timer );
+      i = parent;
+   }
+}
+
+
+/**
+ * Move an entry towards the leaves of the heap, m_cond must be locked
+ **/
+void NewSimulatorTimerService::Down( int i ) {
+
+   for(;;) {
+      int min = i;
+      int left = 2 * i + 1;
+      int right = left + 1;
+
+      if ( left < m_num && Less( left, min ) )
+         min = left;
+
+      if ( right < m_num && Less( right, min ) )
+         min = right;
+
+      if ( min == i )
+         break;
+
+      NewSimulatorTimerThread *timer = m_heap[i];
+      Place( i, m_heap[min] );
+      Place( min, timer );
+      i = min;
+   }
+}
+
+
+/**
+ * Remove an entry of the heap, m_cond must be locked
+ **/
+void NewSimulatorTimerService::Remove( int i ) {
+
+   m_heap[i]->m_heap_idx = -1;
+   m_num--;
+
+   if ( i == m_num )
+      return;
+
+   NewSimulatorTimerThread *last = m_heap[m_num];
+   Place( i, last );
+   Up( i );
+   Down( last->m_heap_idx );
+}
+
+
+/**
+ * Schedule a timer or move it to a new expiration time.
+ *
+ * The service thread is started if it is not running.
+ *
+ * @param timer timer to be scheduled
+ * @param expire absolute expiration time
+ **/
+void NewSimulatorTimerService::Schedule( NewSimulatorTimerThread *timer,
+                                         const cTime &expire ) {
+
+   cThreadLockAuto al( m_cond );
+
+   timer->m_expire = expire;
+
+   if ( timer->m_heap_idx >= 0 ) {
+      Up( timer->m_heap_idx );
+      Down( timer->m_heap_idx );
+
+   } else {
+      if ( m_num == m_size ) {
+         NewSimulatorTimerThread **heap = new NewSimulatorTimerThread *[m_size * 2];
+
+         for( int i = 0; i < m_num; i++ )
+            heap[i] = m_heap[i];
+
+         delete [] m_heap;
+         m_heap = heap;
+         m_size *= 2;
+      }
+
+      Place( m_num, timer );
+      m_num++;
+      Up( m_num - 1 );
+   }
+
+   if ( m_state != eTsRun ) {
+      if ( m_state == eTsExit ) {
+         void *rv;
+         Wait( rv );
+      }
+
+      m_exit = false;
+      Start();
+   }
+
+   m_cond.Broadcast();
+}
+
+
+/**
+ * Cancel a timer.
+ *
+ * If the action of the timer is running in the service thread, the call
+ * waits for it to finish, unless it is done by the action itself.
+ * Afterwards the timer can be deleted.
+ *
+ * @param timer timer to be cancelled
+ **/
+void NewSimulatorTimerService::Cancel( NewSimulatorTimerThread *timer ) {
+
+   cThreadLockAuto al( m_cond );
+
+   for(;;) {
+      // the action may have scheduled the timer again
+      if ( timer->m_heap_idx >= 0 )
+         Remove( timer->m_heap_idx );
+
+      if ( m_current != timer || cThread::GetThread() == this )
+         break;
+
+      m_cond.Wait();
+   }
+}
+
+
+/**
+ * Stop the service thread, the scheduled timers are kept.
+ **/
+void NewSimulatorTimerService::Shutdown() {
+
+   m_cond.Lock();
+   m_exit = true;
+   m_cond.Broadcast();
+   m_cond.Unlock();
+
+   if ( m_state == eTsRun || m_state == eTsExit ) {
+      void *rv;
+      Wait( rv );
+   }
+}
+
+
+/**
+ * Return the number of scheduled timers
+ **/
+int NewSimulatorTimerService::NumTimers() {
+
+   cThreadLockAuto al( m_cond );
+
+   return m_num;
+}
+
+
+/**
+ * Return the number of expired timers
+ **/
+unsigned int NewSimulatorTimerService::NumExpired() {
+
+   cThreadLockAuto al( m_cond );
+
+   return m_expired;
+}
+
+
+/**
+ * Main loop of the service.
+ *
+ * Expired timers are removed from the heap before their action is
+ * called without holding the lock, so the action can reset, start or
+ * stop timers.
+ **/
+void *NewSimulatorTimerService::Run() {
+
+   stdlog << "DBG: Run TimerService\n";
+
+   m_cond.Lock();
+
+   while( !m_exit ) {
+      if ( m_num == 0 ) {
+         m_cond.Wait();
+         continue;
+      }
+
+      NewSimulatorTimerThread *timer = m_heap[0];
+      cTime now( cTime::Now() );
+
+      if ( now < timer->m_expire ) {
+         cTime delta( timer->m_expire );
+         delta -= now;
+
+         m_cond.TimedWait( delta.GetMsec() + 1 );
+         continue;
+      }
+
+      Remove( 0 );
+      m_current = timer;
+      m_expired++;
+      m_cond.Unlock();
+
+      timer->Expire();
+
+      m_cond.Lock();
+      m_current = 0;
+      m_cond.Broadcast();
+   }
+
+   m_cond.Unlock();
+
+   stdlog << "DBG: Exit TimerService\n";
+
+   return 0;
+}
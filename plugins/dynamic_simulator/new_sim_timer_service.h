@@ -0,0 +1,87 @@
+/**
+ * @file    new_sim_timer_service.h
+ *
+ * The file includes a class which runs all timers of a domain:\n
+ * NewSimulatorTimerService
+ *
+ * @version 0.1
+ * @date    2026
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __NEW_SIM_TIMER_SERVICE_H__
+#define __NEW_SIM_TIMER_SERVICE_H__
+
+#ifndef __NEW_SIM_UTILS_H__
+#include "new_sim_utils.h"
+#endif
+
+#ifndef __THREAD_H__
+#include "thread.h"
+#endif
+
+class NewSimulatorTimerThread;
+
+/// Initial number of entries of the timer heap
+#define TIMER_HEAP_SIZE 64
+
+/**
+ * @class NewSimulatorTimerService
+ *
+ * One thread per domain which runs all NewSimulatorTimerThread objects.
+ *
+ * The scheduled timers are kept in a binary heap ordered by expiration
+ * time. The thread sleeps until the first timer expires or a timer with
+ * an earlier expiration is scheduled. The thread is started with the first
+ * scheduled timer.
+ **/
+class NewSimulatorTimerService : public cThread {
+
+private:
+   /// lock for the heap, signaled if it changes or a timer action is done
+   cThreadCond               m_cond;
+   /// heap of scheduled timers
+   NewSimulatorTimerThread **m_heap;
+   /// number of scheduled timers
+   int                       m_num;
+   /// size of m_heap
+   int                       m_size;
+   /// timer whose action is running
+   NewSimulatorTimerThread  *m_current;
+   /// number of expired timers
+   unsigned int              m_expired;
+   /// signal thread to exit
+   bool                      m_exit;
+
+   bool Less( int i, int j );
+   void Place( int i, NewSimulatorTimerThread *timer );
+   void Up( int i );
+   void Down( int i );
+   void Remove( int i );
+
+protected:
+   virtual void *Run();
+
+public:
+   NewSimulatorTimerService();
+   virtual ~NewSimulatorTimerService();
+
+   void Schedule( NewSimulatorTimerThread *timer, const cTime &expire );
+   void Cancel( NewSimulatorTimerThread *timer );
+   void Shutdown();
+
+   int NumTimers();
+   unsigned int NumExpired();
+};
+
+
+#endif
@@ -1,7 +1,7 @@
 /** 
  * @file    new_sim_timer_thread.cpp
  *
- * The file includes a class Timer which runs in another thread:\n
+ * The file includes a class Timer which is run by the domain timer service:\n
  * NewSimulatorTimerThread
  * 
  * @author  Lars Wetzel <larswetzel@users.sourceforge.net>
@@ -17,21 +17,23 @@
  * 
  */
 
-#include <assert.h>
-#include <errno.h>
-#include "new_sim.h"
+#include "new_sim_log.h"
 #include "new_sim_utils.h"
-#include "new_sim_watchdog.h"
+#include "new_sim_timer_thread.h"
 
 
  
 /**
- * Constructor for Watchdogs
+ * Constructor
+ *
+ * @param service timer service of the domain
+ * @param ms_timeout timeout value in ms
  **/
-// NewSimulatorTimerThread::NewSimulatorTimerThread( NewSimulatorWatchdog  *wdt, 
-NewSimulatorTimerThread::NewSimulatorTimerThread(
+NewSimulatorTimerThread::NewSimulatorTimerThread( NewSimulatorTimerService *service,
                                                   unsigned int ms_timeout )
-                       : m_timeout( ms_timeout ),
+                       : m_service( service ),
+                         m_timeout( ms_timeout ),
+                         m_heap_idx( -1 ),
                          m_running( false ),
                          m_exit( false ) {
 
@@ -42,16 +44,42 @@ NewSimulatorTimerThread::NewSimulatorTimerThread(
  * Destructor
  **/
 NewSimulatorTimerThread::~NewSimulatorTimerThread() {
+
+   Stop();
 }
 
 
 /**
- * Set the exit flag and sleep THREAD_SLEEPTIME to be sure it is read
+ * Start the timer with the current timeout value
+ *
+ * @return true
+ **/
+bool NewSimulatorTimerThread::Start() {
+
+   m_start = cTime::Now();
+   m_running = true;
+   m_exit = false;
+   stdlog << "DBG: Start Timer - with timeout " << m_timeout << "\n";
+
+   cTime expire( m_start );
+   expire += (int) m_timeout;
+   m_service->Schedule( this, expire );
+
+   return true;
+}
+
+
+/**
+ * Remove the timer from the service and set the exit flag.
+ *
+ * If TriggerAction() is running in the service thread, it is
+ * finished afterwards.
  **/
 void NewSimulatorTimerThread::Stop() {
 
+   m_service->Cancel( this );
    m_exit = true;
-   usleep( THREAD_SLEEPTIME );
+   m_running = false;
 }
 
 
@@ -68,41 +96,53 @@ unsigned int NewSimulatorTimerThread::Reset( unsigned int new_timeout ) {
    m_start = cTime::Now();
    stdlog << "DBG: Reset timeout value " << m_timeout << "\n";
 
+   if ( m_running ) {
+      cTime expire( m_start );
+      expire += (int) m_timeout;
+      m_service->Schedule( this, expire );
+   }
+
    return m_timeout;
 }
 
 
+/**
+ * Start the next period of a periodic timer.
+ *
+ * Called by TriggerAction(), the timer expires again one timeout after
+ * the latest expiration instead of one timeout after now, so the
+ * period doesn't drift with the time needed by the action.
+ **/
+void NewSimulatorTimerThread::NextPeriod() {
+
+   m_start += (int) m_timeout;
+}
+
+
 /** 
- * Main loop of the timer.
+ * Called by the service if the timer expires.
  *
- * If the timer expires the method TriggerAction() is called. 
+ * The method TriggerAction() is called. If it doesn't stop the timer,
+ * the timer is scheduled again with the latest start and timeout values.
  **/
-void * NewSimulatorTimerThread::Run() {
-   cTime now;
-   int delta;
-   m_start = cTime::Now();
-   m_running = true;
-   m_exit = false;
-   stdlog << "DBG: Run Timerloop - with timeout " << m_timeout << "\n";
-
-   while( !m_exit ) {
-      now = cTime::Now();
-      now -= m_start;
-      delta = m_timeout - now.GetMsec();
-      
-      if ( delta <= 0 ) {
-         m_exit = TriggerAction();	
-
-      } else if ( delta <= THREAD_SLEEPTIME / 1000 ) {
-         usleep( delta*1000 );
-
-      } else {
-      	 usleep( THREAD_SLEEPTIME );
-      }
+void NewSimulatorTimerThread::Expire() {
+
+   m_exit = TriggerAction();
+
+   if ( m_exit ) {
+      m_running = false;
+      stdlog << "DBG: Exit Timer\n";
+      return;
    }
-   m_running = false;
-   stdlog << "DBG: Exit TimerLoop\n";
-   
-   return 0;
-}
 
+   cTime now( cTime::Now() );
+   cTime expire( m_start );
+   expire += (int) m_timeout;
+
+   if ( !( now < expire ) ) {
+      expire = now;
+      expire += THREAD_SLEEPTIME / 1000;
+   }
+
+   m_service->Schedule( this, expire );
+}
@@ -1,7 +1,7 @@
 /** 
  * @file    new_sim_timer_thread.h
  *
- * The file includes a class for starting a timer in a thread:\n
+ * The file includes a class for a timer run by the domain timer service:\n
  * NewSimulatorTimerThread
  * 
  * @author  Lars Wetzel <larswetzel@users.sourceforge.net>
@@ -24,47 +24,61 @@
 #include "new_sim_utils.h"
 #endif
 
-#ifndef __THREAD_H__
-#include "thread.h"
+#ifndef __NEW_SIM_TIMER_SERVICE_H__
+#include "new_sim_timer_service.h"
 #endif
 
 class NewSimulatorWatchdog;
 class NewSimulatorHotSwap;
 class NewSimulatorTimerThread;
 
-/// us for which the timer will sleep 
+/// us after which an expired timer is checked again if the action keeps it running
 #define THREAD_SLEEPTIME 10000
 
 /**
  * @class NewSimulatorTimerThread
  * 
- * Starts a thread in which a timer will trigger a function after expiration.
+ * A timer which triggers a function after expiration.
+ *
+ * The timer doesn't own a thread, it is run by the NewSimulatorTimerService
+ * of the domain.
  **/
-class NewSimulatorTimerThread : public cThread {
+class NewSimulatorTimerThread {
+
+friend class NewSimulatorTimerService;
 
 private:
 
+  /// Service running the timer
+  NewSimulatorTimerService *m_service;
   /// Timeout in ms
   unsigned int     m_timeout;
   /// Start time of timer
   cTime             m_start;
+  /// Expiration time, set by the service
+  cTime             m_expire;
+  /// Position in the heap of the service, -1 if not scheduled
+  int               m_heap_idx;
+
+  void Expire();
 
 protected:
-  virtual void *Run();
-  /// Flag if a thread is already running
+  /// Flag if the timer is running
   bool             m_running;
   /// Abstract method which is called after the timre expires
   virtual bool TriggerAction() = 0;
 
 public:
-  /// signal thread to exit
+  /// signal timer to stop
   bool m_exit;
 
-  NewSimulatorTimerThread( unsigned int ms_timeout );
+  NewSimulatorTimerThread( NewSimulatorTimerService *service, unsigned int ms_timeout );
   virtual ~NewSimulatorTimerThread();
   
+  bool Start();
   void Stop();
   unsigned int Reset( unsigned int new_timeout );
+  void NextPeriod();
   
 };
 
@@ -0,0 +1,466 @@
+/**
+ * @file    new_sim_value_generator.cpp
+ *
+ * The file includes a class which changes a sensor reading over the time:\n
+ * NewSimulatorValueGenerator
+ *
+ * @version 0.1
+ * @date    2026
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "new_sim_log.h"
+#include "new_sim_value_generator.h"
+#include "new_sim_sensor.h"
+
+#include <oh_error.h>
+
+
+/**
+ * Constructor with default values
+ **/
+NewSimulatorGeneratorParams::NewSimulatorGeneratorParams()
+                           : m_type( GENERATOR_NONE ),
+                             m_interval( GENERATOR_DEFAULT_INTERVAL ),
+                             m_min( 0 ),
+                             m_max( 0 ),
+                             m_period( 0 ),
+                             m_step( 0 ),
+                             m_seed( 1 ),
+                             m_trace_format( TRACE_CSV ),
+                             m_loop( true ) {
+
+   m_trace[0] = 0;
+}
+
+
+/**
+ * Set the name of the trace file
+ *
+ * @param file name of the file
+ **/
+void NewSimulatorGeneratorParams::SetTrace( const char *file ) {
+
+   strncpy( m_trace, file, GENERATOR_MAX_PATH - 1 );
+   m_trace[GENERATOR_MAX_PATH - 1] = 0;
+}
+
+
+/**
+ * Constructor
+ *
+ * @param service timer service of the domain
+ * @param sensor sensor which gets the readings
+ * @param params parameters of the generator
+ **/
+NewSimulatorValueGenerator::NewSimulatorValueGenerator( NewSimulatorTimerService *service,
+                                                        NewSimulatorSensor *sensor,
+                                                        const NewSimulatorGeneratorParams &params )
+                          : NewSimulatorTimerThread( service, params.m_interval ),
+                            m_sensor( sensor ),
+                            m_params( params ),
+                            m_count( 0 ),
+                            m_walk( 0 ),
+                            m_random( params.m_seed ),
+                            m_values( 0 ),
+                            m_num_values( 0 ) {
+
+}
+
+
+/**
+ * Destructor
+ **/
+NewSimulatorValueGenerator::~NewSimulatorValueGenerator() {
+
+   Stop();
+
+   delete [] m_values;
+}
+
+
+/**
+ * Check the parameters and read the trace file
+ *
+ * @return true if the generator can be started
+ **/
+bool NewSimulatorValueGenerator::Init() {
+
+   if ( m_params.m_interval == 0 ) {
+      err("Value generator: Interval must not be 0");
+      return false;
+   }
+
+   switch ( m_params.m_type ) {
+      case GENERATOR_RAMP:
+      case GENERATOR_SINE:
+         if ( m_params.m_period == 0 ) {
+            err("Value generator: Period must not be 0");
+            return false;
+         }
+         // fall through
+
+      case GENERATOR_RANDOM_WALK:
+         if ( m_params.m_max < m_params.m_min ) {
+            err("Value generator: Max is lower than Min");
+            return false;
+         }
+         break;
+
+      case GENERATOR_TRACE:
+         if ( m_params.m_trace_format == TRACE_BINARY ) {
+            if ( !LoadBinary( m_params.m_trace ) )
+               return false;
+
+         } else if ( !LoadCsv( m_params.m_trace ) ) {
+            return false;
+         }
+
+         if ( m_num_values == 0 ) {
+            err("Value generator: Trace %s has no values", m_params.m_trace);
+            return false;
+         }
+         break;
+
+      default:
+         err("Value generator: Invalid type %d", m_params.m_type);
+         return false;
+   }
+
+   m_count  = 0;
+   m_walk   = ( m_params.m_min + m_params.m_max ) / 2;
+   m_random = m_params.m_seed;
+
+   return true;
+}
+
+
+/**
+ * Read a trace with one value per line.
+ *
+ * The value is the last field of a line, separated by ',' or ';', so
+ * a trace with a time stamp in the first column can be read. Empty lines,
+ * lines starting with '#' and lines without a number (like a header) are
+ * skipped.
+ *
+ * @param file name of the trace file
+ * @return success
+ **/
+bool NewSimulatorValueGenerator::LoadCsv( const char *file ) {
+   char line[256];
+   unsigned int size = 256;
+
+   FILE *fp = fopen( file, "r" );
+
+   if ( !fp ) {
+      err("Value generator: Cannot open trace %s", file);
+      return false;
+   }
+
+   delete [] m_values;
+   m_values = new double[size];
+   m_num_values = 0;
+
+   while( fgets( line, sizeof( line ), fp ) ) {
+      if ( line[0] == '#' )
+         continue;
+
+      char *field = line;
+
+      for( char *p = line; *p; p++ )
+         if ( *p == ',' || *p == ';' )
+            field = p + 1;
+
+      char *end;
+      double value = strtod( field, &end );
+
+      if ( end == field )
+         continue;
+
+      if ( m_num_values == size ) {
+         double *values = new double[size * 2];
+         memcpy( values, m_values, size * sizeof( double ) );
+         delete [] m_values;
+         m_values = values;
+         size *= 2;
+      }
+
+      m_values[m_num_values++] = value;
+   }
+
+   fclose( fp );
+
+   stdlog << "DBG: Read " << m_num_values << " values of trace " << file << "\n";
+
+   return true;
+}
+
+
+/**
+ * Read a trace of doubles in host byte order
+ *
+ * @param file name of the trace file
+ * @return success
+ **/
+bool NewSimulatorValueGenerator::LoadBinary( const char *file ) {
+
+   FILE *fp = fopen( file, "rb" );
+
+   if ( !fp ) {
+      err("Value generator: Cannot open trace %s", file);
+      return false;
+   }
+
+   fseek( fp, 0, SEEK_END );
+   long size = ftell( fp );
+   fseek( fp, 0, SEEK_SET );
+
+   if ( size < 0 || size % sizeof( double ) ) {
+      err("Value generator: Trace %s is not a list of doubles", file);
+      fclose( fp );
+      return false;
+   }
+
+   delete [] m_values;
+   m_num_values = size / sizeof( double );
+   m_values = new double[m_num_values ? m_num_values : 1];
+
+   if ( fread( m_values, sizeof( double ), m_num_values, fp ) != m_num_values ) {
+      err("Value generator: Cannot read trace %s", file);
+      m_num_values = 0;
+      fclose( fp );
+      return false;
+   }
+
+   fclose( fp );
+
+   stdlog << "DBG: Read " << m_num_values << " values of trace " << file << "\n";
+
+   return true;
+}
+
+
+/**
+ * Next random number, the same seed gives the same numbers on all hosts
+ *
+ * @return number between 0 and 1
+ **/
+double NewSimulatorValueGenerator::Random() {
+
+   m_random = m_random * 1103515245 + 12345;
+
+   return ( ( m_random >> 16 ) & 0x7fff ) / 32767.0;
+}
+
+
+/**
+ * Calculate the next value
+ *
+ * @param value next value
+ * @return false if the trace is done
+ **/
+bool NewSimulatorValueGenerator::NextValue( double &value ) {
+   double range = m_params.m_max - m_params.m_min;
+   double t = (double) m_count * m_params.m_interval;
+   double phase;
+
+   switch ( m_params.m_type ) {
+      case GENERATOR_RAMP:
+         phase = fmod( t, m_params.m_period ) / m_params.m_period;
+
+         if ( phase < 0.5 )
+            value = m_params.m_min + range * 2 * phase;
+         else
+            value = m_params.m_max - range * ( 2 * phase - 1 );
+         break;
+
+      case GENERATOR_SINE:
+         phase = fmod( t, m_params.m_period ) / m_params.m_period;
+         value = m_params.m_min + range / 2 * ( 1 + sin( 2 * M_PI * phase ) );
+         break;
+
+      case GENERATOR_RANDOM_WALK:
+         if ( m_count > 0 ) {
+            m_walk += ( 2 * Random() - 1 ) * m_params.m_step;
+
+            if ( m_walk < m_params.m_min )
+               m_walk = m_params.m_min;
+            if ( m_walk > m_params.m_max )
+               m_walk = m_params.m_max;
+         }
+         value = m_walk;
+         break;
+
+      case GENERATOR_TRACE:
+         if ( m_num_values == 0 )
+            return false;
+
+         if ( ( m_count >= m_num_values ) && !m_params.m_loop )
+            return false;
+
+         value = m_values[m_count % m_num_values];
+         break;
+
+      default:
+         return false;
+   }
+
+   m_count++;
+
+   return true;
+}
+
+
+/**
+ * Set the next reading of the sensor
+ *
+ * @return true if the generator is done
+ **/
+bool NewSimulatorValueGenerator::TriggerAction() {
+   double value;
+
+   if ( !NextValue( value ) ) {
+      stdlog << "DBG: Value generator is at the end of the trace\n";
+      return true;
+   }
+
+   if ( m_sensor )
+      m_sensor->SetReading( value );
+
+   NextPeriod();
+
+   return false;
+}
+
+
+/**
+ * Calculate the threshold event states of a reading
+ *
+ * A lower threshold state is asserted if the value is lower or equal to the
+ * threshold. It is deasserted if the value is above the threshold plus the
+ * positive hysteresis. An upper threshold state is asserted if the value is
+ * greater or equal to the threshold and deasserted if the value is below the
+ * threshold minus the negative hysteresis. In between the state is kept.
+ *
+ * @param value new reading
+ * @param thres thresholds of the sensor
+ * @param state event states before the reading
+ *
+ * @return new event states
+ **/
+SaHpiEventStateT NewSimulatorValueGenerator::ThresholdState( double value,
+                                                             const SaHpiSensorThresholdsT &thres,
+                                                             SaHpiEventStateT state ) {
+   const SaHpiSensorReadingT *lower[] = { &thres.LowMinor, &thres.LowMajor,
+                                          &thres.LowCritical };
+   const SaHpiSensorReadingT *upper[] = { &thres.UpMinor, &thres.UpMajor,
+                                          &thres.UpCritical };
+   const SaHpiEventStateT lower_state[] = { SAHPI_ES_LOWER_MINOR, SAHPI_ES_LOWER_MAJOR,
+                                            SAHPI_ES_LOWER_CRIT };
+   const SaHpiEventStateT upper_state[] = { SAHPI_ES_UPPER_MINOR, SAHPI_ES_UPPER_MAJOR,
+                                            SAHPI_ES_UPPER_CRIT };
+   double pos = 0, neg = 0, t;
+
+   ToDouble( thres.PosThdHysteresis, pos );
+   ToDouble( thres.NegThdHysteresis, neg );
+
+   for( int i = 0; i < 3; i++ ) {
+      if ( ToDouble( *lower[i], t ) ) {
+         if ( value <= t )
+            state |= lower_state[i];
+         else if ( value > t + pos )
+            state &= ~lower_state[i];
+      }
+
+      if ( ToDouble( *upper[i], t ) ) {
+         if ( value >= t )
+            state |= upper_state[i];
+         else if ( value < t - neg )
+            state &= ~upper_state[i];
+      }
+   }
+
+   return state;
+}
+
+
+/**
+ * Convert a reading to double
+ *
+ * @param reading sensor reading
+ * @param value converted value
+ *
+ * @return false if the reading is not supported or a buffer
+ **/
+bool NewSimulatorValueGenerator::ToDouble( const SaHpiSensorReadingT &reading,
+                                           double &value ) {
+
+   if ( reading.IsSupported == SAHPI_FALSE )
+      return false;
+
+   switch ( reading.Type ) {
+      case SAHPI_SENSOR_READING_TYPE_INT64:
+         value = (double) reading.Value.SensorInt64;
+         return true;
+
+      case SAHPI_SENSOR_READING_TYPE_UINT64:
+         value = (double) reading.Value.SensorUint64;
+         return true;
+
+      case SAHPI_SENSOR_READING_TYPE_FLOAT64:
+         value = reading.Value.SensorFloat64;
+         return true;
+
+      default:
+         return false;
+   }
+}
+
+
+/**
+ * Fill a reading with a double value
+ *
+ * @param value value to be set
+ * @param type reading type of the sensor
+ * @param reading sensor reading to be filled
+ **/
+void NewSimulatorValueGenerator::FromDouble( double value,
+                                             SaHpiSensorReadingTypeT type,
+                                             SaHpiSensorReadingT &reading ) {
+
+   memset( &reading, 0, sizeof( SaHpiSensorReadingT ) );
+   reading.IsSupported = SAHPI_TRUE;
+   reading.Type = type;
+
+   switch ( type ) {
+      case SAHPI_SENSOR_READING_TYPE_INT64:
+         reading.Value.SensorInt64 = (SaHpiInt64T) floor( value + 0.5 );
+         break;
+
+      case SAHPI_SENSOR_READING_TYPE_UINT64:
+         reading.Value.SensorUint64 = ( value < 0 ) ? 0 : (SaHpiUint64T) floor( value + 0.5 );
+         break;
+
+      case SAHPI_SENSOR_READING_TYPE_FLOAT64:
+         reading.Value.SensorFloat64 = value;
+         break;
+
+      default:
+         reading.IsSupported = SAHPI_FALSE;
+         break;
+   }
+}
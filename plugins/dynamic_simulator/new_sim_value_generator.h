@@ -0,0 +1,147 @@
+/**
+ * @file    new_sim_value_generator.h
+ *
+ * The file includes a class which changes a sensor reading over the time:\n
+ * NewSimulatorValueGenerator
+ *
+ * @version 0.1
+ * @date    2026
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#ifndef __NEW_SIM_VALUE_GENERATOR_H__
+#define __NEW_SIM_VALUE_GENERATOR_H__
+
+extern "C" {
+#include "SaHpi.h"
+}
+
+#ifndef __NEW_SIM_TIMER_THREAD_H__
+#include "new_sim_timer_thread.h"
+#endif
+
+class NewSimulatorSensor;
+
+/// Kind of values produced by a generator
+enum NewSimulatorGeneratorType {
+   GENERATOR_NONE = 0,
+   GENERATOR_RAMP,
+   GENERATOR_SINE,
+   GENERATOR_RANDOM_WALK,
+   GENERATOR_TRACE
+};
+
+/// Format of a trace file
+enum NewSimulatorTraceFormat {
+   TRACE_CSV = 0,
+   TRACE_BINARY
+};
+
+/// Default interval between two readings in ms
+#define GENERATOR_DEFAULT_INTERVAL 1000
+/// Maximal length of the trace file name
+#define GENERATOR_MAX_PATH 256
+
+/**
+ * @class NewSimulatorGeneratorParams
+ *
+ * Parameters of a generator as they are read from the simulation file.
+ **/
+class NewSimulatorGeneratorParams {
+public:
+   /// Kind of values
+   NewSimulatorGeneratorType m_type;
+   /// Time between two readings in ms
+   unsigned int              m_interval;
+   /// Lowest value of ramp, sine and random walk
+   double                    m_min;
+   /// Highest value of ramp, sine and random walk
+   double                    m_max;
+   /// Period of ramp and sine in ms
+   unsigned int              m_period;
+   /// Largest change of the random walk for one reading
+   double                    m_step;
+   /// Start value of the random numbers, the same seed gives the same walk
+   unsigned int              m_seed;
+   /// Trace file
+   char                      m_trace[GENERATOR_MAX_PATH];
+   /// Format of the trace file
+   NewSimulatorTraceFormat   m_trace_format;
+   /// Restart the trace at its end
+   bool                      m_loop;
+
+   NewSimulatorGeneratorParams();
+
+   void SetTrace( const char *file );
+};
+
+/**
+ * @class NewSimulatorValueGenerator
+ *
+ * Sets a new reading of a sensor every interval.
+ *
+ * The readings follow a ramp (up from min to max and down again during one
+ * period), a sine, a random walk or a recorded trace. The values only depend
+ * on the parameters and the number of readings done, so a simulation can be
+ * repeated. The generator is run by the timer service of the domain.
+ **/
+class NewSimulatorValueGenerator : public NewSimulatorTimerThread {
+
+private:
+   /// Sensor which gets the readings
+   NewSimulatorSensor         *m_sensor;
+   /// Parameters
+   NewSimulatorGeneratorParams m_params;
+   /// Number of readings done
+   unsigned int                m_count;
+   /// Latest value of the random walk
+   double                      m_walk;
+   /// State of the random numbers
+   unsigned int                m_random;
+   /// Values of the trace
+   double                     *m_values;
+   /// Number of values of the trace
+   unsigned int                m_num_values;
+
+   double Random();
+   bool   LoadCsv( const char *file );
+   bool   LoadBinary( const char *file );
+
+protected:
+   virtual bool TriggerAction();
+
+public:
+   NewSimulatorValueGenerator( NewSimulatorTimerService *service,
+                               NewSimulatorSensor *sensor,
+                               const NewSimulatorGeneratorParams &params );
+   virtual ~NewSimulatorValueGenerator();
+
+   bool Init();
+   bool NextValue( double &value );
+
+   /// Return the number of readings done
+   unsigned int Count() const { return m_count; }
+   /// Return the number of values of the trace
+   unsigned int NumValues() const { return m_num_values; }
+   /// Return the parameters
+   const NewSimulatorGeneratorParams &Params() const { return m_params; }
+
+   static SaHpiEventStateT ThresholdState( double value,
+                                           const SaHpiSensorThresholdsT &thres,
+                                           SaHpiEventStateT state );
+   static bool ToDouble( const SaHpiSensorReadingT &reading, double &value );
+   static void FromDouble( double value, SaHpiSensorReadingTypeT type,
+                           SaHpiSensorReadingT &reading );
+};
+
+
+#endif
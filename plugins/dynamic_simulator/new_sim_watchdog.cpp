@@ -31,7 +31,7 @@
  **/
 NewSimulatorWatchdog::NewSimulatorWatchdog( NewSimulatorResource *res )
                     : NewSimulatorRdr( res, SAHPI_WATCHDOG_RDR ),
-                      NewSimulatorTimerThread( 0 ),
+                      NewSimulatorTimerThread( res->Domain()->TimerService(), 0 ),
                       m_state( NONE ) {
 
    memset( &m_wdt_rec, 0, sizeof( SaHpiWatchdogRecT ));
@@ -47,7 +47,8 @@ NewSimulatorWatchdog::NewSimulatorWatchdog( NewSimulatorResource *res,
                       SaHpiRdrT rdr, 
                       SaHpiWatchdogT wdt_data)
                     : NewSimulatorRdr( res, SAHPI_WATCHDOG_RDR, rdr.Entity, rdr.IsFru, rdr.IdString ),
-                      NewSimulatorTimerThread(  (wdt_data.InitialCount - wdt_data.PreTimeoutInterval) ),
+                      NewSimulatorTimerThread( res->Domain()->TimerService(),
+                                               (wdt_data.InitialCount - wdt_data.PreTimeoutInterval) ),
                       m_state( NONE ) {
 
    memcpy( &m_wdt_rec, &rdr.RdrTypeUnion.WatchdogRec, sizeof( SaHpiWatchdogRecT ));
@@ -87,6 +88,19 @@ bool NewSimulatorWatchdog::CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr )
 }
 
 
+/**
+ * Add the watchdog settings to a snapshot
+ * 
+ * @param writer snapshot writer, the rdr of the watchdog was added before
+ * @return success
+ **/
+bool NewSimulatorWatchdog::WriteSnapshot( SimSnapshotWriterT *writer ) {
+
+   return ( sim_snapshot_add_record( writer, SIM_SNAPSHOT_WATCHDOG, &m_wdt_data,
+                                     sizeof( SaHpiWatchdogT ) ) == SA_OK );
+}
+
+
 /** 
  * Dump the Watchdog information
  * 
@@ -79,6 +79,7 @@ public:
 
   // create an RDR sensor record
   bool CreateRdr( SaHpiRptEntryT &resource, SaHpiRdrT &rdr );
+  virtual bool WriteSnapshot( SimSnapshotWriterT *writer );
   // Dump 
   void Dump( NewSimulatorLog &dump ) const;
   
@@ -0,0 +1,317 @@
+/*
+ * Test the binary snapshot format: write a snapshot, read it back
+ * and refuse broken files.
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "new_sim_snapshot.h"
+#include "test.h"
+
+
+static void
+FillRpt( SaHpiRptEntryT &rpt, SaHpiEntryIdT id )
+{
+  memset( &rpt, 0, sizeof( rpt ) );
+  rpt.EntryId = id;
+  rpt.ResourceId = id;
+  rpt.ResourceEntity.Entry[0].EntityType = SAHPI_ENT_SYSTEM_BOARD;
+  rpt.ResourceEntity.Entry[0].EntityLocation = id;
+  rpt.ResourceEntity.Entry[1].EntityType = SAHPI_ENT_ROOT;
+  rpt.ResourceCapabilities = SAHPI_CAPABILITY_RESOURCE | SAHPI_CAPABILITY_RDR
+                             | SAHPI_CAPABILITY_SENSOR;
+}
+
+
+static void
+FillSensorRdr( SaHpiRdrT &rdr, SaHpiSensorNumT num )
+{
+  memset( &rdr, 0, sizeof( rdr ) );
+  rdr.RecordId = num;
+  rdr.RdrType = SAHPI_SENSOR_RDR;
+  rdr.RdrTypeUnion.SensorRec.Num = num;
+  rdr.RdrTypeUnion.SensorRec.Type = SAHPI_TEMPERATURE;
+}
+
+
+// two resources, the first one with a sensor and an inventory
+static void
+Write( const char *file )
+{
+  SimSnapshotWriterT *writer = sim_snapshot_writer_new();
+  SaHpiRptEntryT rpt;
+  SaHpiRdrT rdr;
+
+  Test( writer != 0 );
+
+  // a rdr without resource
+  FillSensorRdr( rdr, 1 );
+  Test( sim_snapshot_add_rdr( writer, &rdr ) == SA_ERR_HPI_INVALID_REQUEST );
+
+  FillRpt( rpt, 1 );
+  Test( sim_snapshot_add_rpt( writer, &rpt ) == SA_OK );
+
+  Test( sim_snapshot_add_rdr( writer, &rdr ) == SA_OK );
+
+  SimSnapshotSensorT sensor;
+  memset( &sensor, 0, sizeof( sensor ) );
+  sensor.Reading.IsSupported = SAHPI_TRUE;
+  sensor.Reading.Type = SAHPI_SENSOR_READING_TYPE_FLOAT64;
+  sensor.Reading.Value.SensorFloat64 = 42.5;
+  sensor.EventState = SAHPI_ES_UPPER_MINOR;
+  sensor.Enabled = SAHPI_TRUE;
+  Test( sim_snapshot_add_record( writer, SIM_SNAPSHOT_SENSOR, &sensor, sizeof( sensor ) ) == SA_OK );
+
+  // a payload which is too short
+  Test( sim_snapshot_add_record( writer, SIM_SNAPSHOT_SENSOR, &sensor, 4 )
+        == SA_ERR_HPI_INVALID_PARAMS );
+
+  SimSnapshotGeneratorT gen;
+  memset( &gen, 0, sizeof( gen ) );
+  gen.Type = 1;
+  gen.Interval = 500;
+  gen.Max = 100;
+  strcpy( gen.Trace, "/tmp/trace.csv" );
+  Test( sim_snapshot_add_record( writer, SIM_SNAPSHOT_GENERATOR, &gen, sizeof( gen ) ) == SA_OK );
+
+  memset( &rdr, 0, sizeof( rdr ) );
+  rdr.RecordId = 2;
+  rdr.RdrType = SAHPI_INVENTORY_RDR;
+  rdr.RdrTypeUnion.InventoryRec.IdrId = 7;
+  Test( sim_snapshot_add_rdr( writer, &rdr ) == SA_OK );
+
+  SaHpiIdrInfoT info;
+  memset( &info, 0, sizeof( info ) );
+  info.IdrId = 7;
+  info.NumAreas = 1;
+  Test( sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_INFO, &info, sizeof( info ) ) == SA_OK );
+
+  SaHpiIdrAreaHeaderT area;
+  memset( &area, 0, sizeof( area ) );
+  area.AreaId = 1;
+  area.NumFields = 2;
+  Test( sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_AREA, &area, sizeof( area ) ) == SA_OK );
+
+  for( int i = 1; i <= 2; i++ )
+     {
+       SaHpiIdrFieldT field;
+       memset( &field, 0, sizeof( field ) );
+       field.AreaId = 1;
+       field.FieldId = i;
+       field.Field.DataLength = 3;
+       memcpy( field.Field.Data, "abc", 3 );
+       Test( sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_FIELD, &field, sizeof( field ) ) == SA_OK );
+     }
+
+  // a resource without rdr
+  FillRpt( rpt, 2 );
+  Test( sim_snapshot_add_rpt( writer, &rpt ) == SA_OK );
+
+  Test( sim_snapshot_writer_save( writer, file ) == SA_OK );
+
+  sim_snapshot_writer_free( writer );
+}
+
+
+static void
+Read( const char *file )
+{
+  SimSnapshotT snap;
+
+  Test( sim_snapshot_probe( file ) == 1 );
+  Test( sim_snapshot_open( file, &snap ) == SA_OK );
+
+  Test( snap.NumRpts == 2 );
+  Test( snap.NumRdrs == 2 );
+
+  Test( snap.Rpts[0].Rpt.EntryId == 1 );
+  Test( snap.Rpts[0].FirstRdr == 0 );
+  Test( snap.Rpts[0].NumRdr == 2 );
+  Test( snap.Rpts[0].Rpt.ResourceEntity.Entry[0].EntityLocation == 1 );
+  Test( snap.Rpts[1].Rpt.EntryId == 2 );
+  Test( snap.Rpts[1].NumRdr == 0 );
+
+  // the sensor
+  const SimSnapshotRdrT *rdr = &snap.Rdrs[0];
+  Test( rdr->Rdr.RdrType == SAHPI_SENSOR_RDR );
+  Test( rdr->NumRecords == 2 );
+
+  const SimSnapshotRecordT *rec = sim_snapshot_first_record( &snap, rdr );
+  Test( rec != 0 && rec->Tag == SIM_SNAPSHOT_SENSOR );
+
+  const SimSnapshotSensorT *sensor = (const SimSnapshotSensorT *)sim_snapshot_record_data( rec );
+  Test( sensor->Reading.Value.SensorFloat64 == 42.5 );
+  Test( sensor->EventState == SAHPI_ES_UPPER_MINOR );
+
+  // the records are aligned inside the mapping
+  Test( ( (unsigned long)sensor % SIM_SNAPSHOT_ALIGN ) == 0 );
+
+  rec = sim_snapshot_next_record( &snap, rdr, rec );
+  Test( rec != 0 && rec->Tag == SIM_SNAPSHOT_GENERATOR );
+
+  const SimSnapshotGeneratorT *gen = (const SimSnapshotGeneratorT *)sim_snapshot_record_data( rec );
+  Test( gen->Interval == 500 && gen->Max == 100 );
+  Test( strcmp( gen->Trace, "/tmp/trace.csv" ) == 0 );
+
+  Test( sim_snapshot_next_record( &snap, rdr, rec ) == 0 );
+
+  // the inventory
+  rdr = &snap.Rdrs[1];
+  Test( rdr->Rdr.RdrTypeUnion.InventoryRec.IdrId == 7 );
+  Test( rdr->NumRecords == 4 );
+
+  int tags[4], n = 0;
+
+  for( rec = sim_snapshot_first_record( &snap, rdr ); rec && n < 4;
+       rec = sim_snapshot_next_record( &snap, rdr, rec ) )
+       tags[n++] = rec->Tag;
+
+  Test( n == 4 && rec == 0 );
+  Test( tags[0] == SIM_SNAPSHOT_IDR_INFO && tags[1] == SIM_SNAPSHOT_IDR_AREA );
+  Test( tags[2] == SIM_SNAPSHOT_IDR_FIELD && tags[3] == SIM_SNAPSHOT_IDR_FIELD );
+
+  sim_snapshot_close( &snap );
+  Test( snap.Map == 0 );
+}
+
+
+static void
+Copy( const char *from, const char *to, off_t len )
+{
+  struct stat st;
+  Test( stat( from, &st ) == 0 );
+
+  if ( len < 0 || len > st.st_size )
+       len = st.st_size;
+
+  char *buf = (char *)malloc( st.st_size );
+  int fd = open( from, O_RDONLY );
+  Test( read( fd, buf, st.st_size ) == st.st_size );
+  close( fd );
+
+  fd = open( to, O_WRONLY | O_CREAT | O_TRUNC, 0600 );
+  Test( write( fd, buf, len ) == len );
+  close( fd );
+
+  free( buf );
+}
+
+
+static void
+Patch( const char *file, off_t offset, const void *data, size_t len )
+{
+  int fd = open( file, O_WRONLY );
+  Test( pwrite( fd, data, len, offset ) == (ssize_t)len );
+  close( fd );
+}
+
+
+static void
+Broken( const char *file )
+{
+  char broken[] = "/tmp/snapshot_000_XXXXXX";
+  int fd = mkstemp( broken );
+  Test( fd >= 0 );
+  close( fd );
+
+  SimSnapshotT snap;
+  SaHpiUint32T u32;
+  SaHpiUint64T u64;
+
+  // truncated
+  Copy( file, broken, 200 );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_INVALID_DATA );
+
+  Copy( file, broken, 4 );
+  Test( sim_snapshot_probe( broken ) == 0 );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_INVALID_DATA );
+
+  // wrong magic
+  Copy( file, broken, -1 );
+  Patch( broken, 0, "OHSIMSNX", 8 );
+  Test( sim_snapshot_probe( broken ) == 0 );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_INVALID_DATA );
+
+  // other version
+  Copy( file, broken, -1 );
+  u32 = SIM_SNAPSHOT_VERSION + 1;
+  Patch( broken, offsetof( SimSnapshotHeaderT, Version ), &u32, sizeof( u32 ) );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_INVALID_DATA );
+
+  // other byte order
+  Copy( file, broken, -1 );
+  u32 = 0x04030201;
+  Patch( broken, offsetof( SimSnapshotHeaderT, ByteOrder ), &u32, sizeof( u32 ) );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_INVALID_DATA );
+
+  // a section behind the end of the file
+  Copy( file, broken, -1 );
+  u64 = 1 << 30;
+  Patch( broken, offsetof( SimSnapshotHeaderT, Sections )
+                 + SIM_SNAPSHOT_SECTION_DATA * sizeof( SimSnapshotSectionT )
+                 + offsetof( SimSnapshotSectionT, Offset ), &u64, sizeof( u64 ) );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_INVALID_DATA );
+
+  // a resource with too many rdr
+  SimSnapshotT good;
+  Test( sim_snapshot_open( file, &good ) == SA_OK );
+  off_t rpt_offset = good.Header->Sections[SIM_SNAPSHOT_SECTION_RPT].Offset;
+  off_t rdr_offset = good.Header->Sections[SIM_SNAPSHOT_SECTION_RDR].Offset;
+  sim_snapshot_close( &good );
+
+  Copy( file, broken, -1 );
+  u32 = 3;
+  Patch( broken, rpt_offset + offsetof( SimSnapshotRptT, NumRdr ), &u32, sizeof( u32 ) );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_INVALID_DATA );
+
+  // a rdr with a record too much
+  Copy( file, broken, -1 );
+  u32 = 3;
+  Patch( broken, rdr_offset + offsetof( SimSnapshotRdrT, NumRecords ), &u32, sizeof( u32 ) );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_INVALID_DATA );
+
+  // a missing file
+  unlink( broken );
+  Test( sim_snapshot_probe( broken ) == 0 );
+  Test( sim_snapshot_open( broken, &snap ) == SA_ERR_HPI_ERROR );
+
+  // a text simulation file isn't a snapshot
+  fd = open( broken, O_WRONLY | O_CREAT | O_TRUNC, 0600 );
+  Test( write( fd, "CONFIGURATION {\n", 16 ) == 16 );
+  close( fd );
+  Test( sim_snapshot_probe( broken ) == 0 );
+
+  unlink( broken );
+}
+
+
+int
+main()
+{
+  char file[] = "/tmp/snapshot_000_XXXXXX";
+  int fd = mkstemp( file );
+  Test( fd >= 0 );
+  close( fd );
+
+  Write( file );
+  Read( file );
+  Broken( file );
+
+  unlink( file );
+
+  return TestResult();
+}
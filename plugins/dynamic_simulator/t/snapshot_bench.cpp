@@ -0,0 +1,376 @@
+/*
+ * Snapshot load benchmark.
+ *
+ * Writes a snapshot with a configurable number of resources (each one
+ * with threshold sensors, controls and an inventory) and times mapping
+ * plus verification and a walk over all records, i.e. the work done
+ * before the plugin creates its objects. An existing snapshot, e.g.
+ * written by "hpigensimdata -b", can be given instead.
+ *
+ * With "-p <plugin> <simulation file>" the plugin is loaded and opened
+ * with the text file, which is converted into a snapshot once, and
+ * then opened with that snapshot. Both open times are reported, so the
+ * text parser and the snapshot loader are compared on the same data.
+ *
+ * Not part of "make check": build it with "make snapshot_bench".
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <glib.h>
+#include <gmodule.h>
+
+#include <oh_utils.h>
+
+#include "new_sim_snapshot.h"
+
+
+typedef void *(*PluginOpenT)( GHashTable *, unsigned int, oh_evt_queue * );
+typedef void (*PluginCloseT)( void * );
+
+
+static double
+Now()
+{
+  struct timeval tv;
+
+  gettimeofday( &tv, 0 );
+
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+
+static bool
+Generate( const char *file, unsigned int num_res )
+{
+  SimSnapshotWriterT *writer = sim_snapshot_writer_new();
+  SaHpiRptEntryT rpt;
+  SaHpiRdrT rdr;
+  bool ok = ( writer != 0 );
+
+  for( unsigned int i = 0; ok && i < num_res; i++ )
+     {
+       memset( &rpt, 0, sizeof( rpt ) );
+       rpt.EntryId = i + 1;
+       rpt.ResourceEntity.Entry[0].EntityType = SAHPI_ENT_SYSTEM_BLADE;
+       rpt.ResourceEntity.Entry[0].EntityLocation = i;
+       rpt.ResourceEntity.Entry[1].EntityType = SAHPI_ENT_ROOT;
+       ok = sim_snapshot_add_rpt( writer, &rpt ) == SA_OK;
+
+       for( unsigned int s = 0; ok && s < 16; s++ )
+          {
+            SimSnapshotSensorT sensor;
+
+            memset( &rdr, 0, sizeof( rdr ) );
+            rdr.RdrType = SAHPI_SENSOR_RDR;
+            rdr.RdrTypeUnion.SensorRec.Num = s;
+            rdr.RdrTypeUnion.SensorRec.ThresholdDefn.IsAccessible = SAHPI_TRUE;
+
+            memset( &sensor, 0, sizeof( sensor ) );
+            sensor.Reading.IsSupported = SAHPI_TRUE;
+            sensor.Reading.Type = SAHPI_SENSOR_READING_TYPE_FLOAT64;
+            sensor.Reading.Value.SensorFloat64 = s;
+
+            ok = sim_snapshot_add_rdr( writer, &rdr ) == SA_OK
+                 && sim_snapshot_add_record( writer, SIM_SNAPSHOT_SENSOR,
+                                             &sensor, sizeof( sensor ) ) == SA_OK;
+          }
+
+       for( unsigned int c = 0; ok && c < 4; c++ )
+          {
+            SimSnapshotControlT ctrl;
+
+            memset( &rdr, 0, sizeof( rdr ) );
+            rdr.RdrType = SAHPI_CTRL_RDR;
+            rdr.RdrTypeUnion.CtrlRec.Num = c;
+            rdr.RdrTypeUnion.CtrlRec.Type = SAHPI_CTRL_TYPE_DIGITAL;
+
+            memset( &ctrl, 0, sizeof( ctrl ) );
+            ctrl.State.Type = SAHPI_CTRL_TYPE_DIGITAL;
+
+            ok = sim_snapshot_add_rdr( writer, &rdr ) == SA_OK
+                 && sim_snapshot_add_record( writer, SIM_SNAPSHOT_CONTROL,
+                                             &ctrl, sizeof( ctrl ) ) == SA_OK;
+          }
+
+       SaHpiIdrInfoT info;
+       SaHpiIdrAreaHeaderT area;
+       SaHpiIdrFieldT field;
+
+       memset( &rdr, 0, sizeof( rdr ) );
+       rdr.RdrType = SAHPI_INVENTORY_RDR;
+       memset( &info, 0, sizeof( info ) );
+       memset( &area, 0, sizeof( area ) );
+       memset( &field, 0, sizeof( field ) );
+
+       ok = ok && sim_snapshot_add_rdr( writer, &rdr ) == SA_OK
+            && sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_INFO, &info, sizeof( info ) ) == SA_OK
+            && sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_AREA, &area, sizeof( area ) ) == SA_OK;
+
+       for( unsigned int f = 0; ok && f < 8; f++ )
+            ok = sim_snapshot_add_record( writer, SIM_SNAPSHOT_IDR_FIELD,
+                                          &field, sizeof( field ) ) == SA_OK;
+     }
+
+  ok = ok && sim_snapshot_writer_save( writer, file ) == SA_OK;
+
+  if ( writer )
+       sim_snapshot_writer_free( writer );
+
+  return ok;
+}
+
+
+static bool
+Load( const char *file, unsigned int loops )
+{
+  unsigned long records = 0;
+  double sum = 0.0;
+  double t0, t1, t2;
+  SimSnapshotT snap;
+
+  t0 = Now();
+  for( unsigned int l = 0; l < loops; l++ )
+     {
+       if ( sim_snapshot_open( file, &snap ) != SA_OK )
+            return false;
+
+       sim_snapshot_close( &snap );
+     }
+
+  t1 = Now();
+  for( unsigned int l = 0; l < loops; l++ )
+     {
+       if ( sim_snapshot_open( file, &snap ) != SA_OK )
+            return false;
+
+       records = 0;
+
+       for( SaHpiUint32T i = 0; i < snap.NumRdrs; i++ )
+            for( const SimSnapshotRecordT *rec = sim_snapshot_first_record( &snap, &snap.Rdrs[i] );
+                 rec; rec = sim_snapshot_next_record( &snap, &snap.Rdrs[i], rec ) )
+               {
+                 sum += rec->Tag;
+                 records++;
+               }
+
+       sim_snapshot_close( &snap );
+     }
+
+  t2 = Now();
+
+  if ( sim_snapshot_open( file, &snap ) != SA_OK )
+       return false;
+
+  printf( "%u resources, %u rdr, %lu records, %lu bytes\n",
+          snap.NumRpts, snap.NumRdrs, records, (unsigned long)snap.MapSize );
+  printf( "open+verify %10.3f ms  open+verify+walk %10.3f ms  (%.0f rdr/s)\n",
+          ( t1 - t0 ) * 1000 / loops, ( t2 - t1 ) * 1000 / loops,
+          snap.NumRdrs * loops / ( t2 - t1 ) );
+
+  sim_snapshot_close( &snap );
+
+  // keep the loops from being optimized away
+  if ( sum == 0.123 )
+       printf( "\n" );
+
+  return true;
+}
+
+
+/*
+ * Opens and closes the plugin loops times with file as simulation file.
+ * If snapshot is given, the plugin converts file into it.
+ */
+static bool
+PluginLoad( PluginOpenT plugin_open, PluginCloseT plugin_close,
+            const char *file, const char *snapshot,
+            unsigned int loops, double &ms )
+{
+  GHashTable *config = g_hash_table_new( g_str_hash, g_str_equal );
+  oh_evt_queue *eventq = g_async_queue_new();
+  struct oh_event *e;
+  double t = 0.0;
+  bool ok = true;
+
+  g_hash_table_insert( config, (gpointer)"entity_root",
+                       (gpointer)"{SYSTEM_CHASSIS,1}" );
+  g_hash_table_insert( config, (gpointer)"file", (gpointer)file );
+
+  if ( snapshot )
+       g_hash_table_insert( config, (gpointer)"snapshot", (gpointer)snapshot );
+
+  for( unsigned int l = 0; ok && l < loops; l++ )
+     {
+       double t0 = Now();
+       void *hnd = plugin_open( config, 1, eventq );
+
+       t += Now() - t0;
+
+       if ( !hnd )
+          {
+            ok = false;
+            break;
+          }
+
+       plugin_close( hnd );
+
+       // discovery events of this round
+       while( ( e = (struct oh_event *)g_async_queue_try_pop( eventq ) ) != 0 )
+            oh_event_free( e, FALSE );
+     }
+
+  g_async_queue_unref( eventq );
+  g_hash_table_destroy( config );
+
+  ms = t * 1000 / loops;
+
+  return ok;
+}
+
+
+static int
+Compare( const char *plugin, const char *file, unsigned int loops )
+{
+  char snapshot[] = "/tmp/snapshot_bench_XXXXXX";
+  PluginOpenT plugin_open = 0;
+  PluginCloseT plugin_close = 0;
+  double text_ms, snap_ms;
+  gpointer sym;
+
+  // no uid map file, resource ids only live as long as the process
+  setenv( "OPENHPI_UID_MAP", "", 1 );
+  oh_uid_initialize();
+
+  GModule *module = g_module_open( plugin, G_MODULE_BIND_LOCAL );
+
+  if ( !module )
+     {
+       printf( "cannot load %s: %s\n", plugin, g_module_error() );
+       return 1;
+     }
+
+  if ( g_module_symbol( module, "oh_open", &sym ) )
+       plugin_open = (PluginOpenT)sym;
+
+  if ( g_module_symbol( module, "oh_close", &sym ) )
+       plugin_close = (PluginCloseT)sym;
+
+  if ( !plugin_open || !plugin_close )
+     {
+       printf( "%s is not a plugin\n", plugin );
+       g_module_close( module );
+       return 1;
+     }
+
+  int fd = mkstemp( snapshot );
+
+  if ( fd < 0 )
+     {
+       g_module_close( module );
+       return 1;
+     }
+
+  close( fd );
+
+  bool ok = PluginLoad( plugin_open, plugin_close, file, snapshot, 1, text_ms );
+
+  if ( !ok || !sim_snapshot_probe( snapshot ) )
+     {
+       printf( "cannot convert %s\n", file );
+       ok = false;
+     }
+
+  ok = ok && PluginLoad( plugin_open, plugin_close, file, 0, loops, text_ms )
+          && PluginLoad( plugin_open, plugin_close, snapshot, 0, loops, snap_ms );
+
+  if ( ok )
+     {
+       printf( "%s\n", file );
+       printf( "text open %10.3f ms  snapshot open %10.3f ms  (%.1fx)\n",
+               text_ms, snap_ms, snap_ms > 0 ? text_ms / snap_ms : 0.0 );
+
+       ok = Load( snapshot, loops );
+     }
+
+  unlink( snapshot );
+  g_module_close( module );
+
+  return ok ? 0 : 1;
+}
+
+
+int
+main( int argc, char *argv[] )
+{
+  unsigned int num_res = 1000;
+  unsigned int loops = 20;
+  char file[] = "/tmp/snapshot_bench_XXXXXX";
+
+  if ( argc > 1 && strcmp( argv[1], "-p" ) == 0 )
+     {
+       if ( argc < 4 )
+          {
+            printf( "Usage: %s -p <plugin> <simulation file>\n", argv[0] );
+            return 1;
+          }
+
+       return Compare( argv[2], argv[3], loops );
+     }
+
+  if ( argc > 1 && sim_snapshot_probe( argv[1] ) )
+     {
+       if ( !Load( argv[1], loops ) )
+            return 1;
+
+       return 0;
+     }
+
+  if ( argc > 1 )
+       num_res = atoi( argv[1] );
+
+  if ( num_res < 1 )
+     {
+       printf( "Usage: %s [resources | snapshot]\n"
+               "       %s -p <plugin> <simulation file>\n", argv[0], argv[0] );
+       return 1;
+     }
+
+  int fd = mkstemp( file );
+
+  if ( fd < 0 )
+       return 1;
+
+  close( fd );
+
+  double t0 = Now();
+
+  if ( !Generate( file, num_res ) )
+     {
+       printf( "cannot write %s\n", file );
+       unlink( file );
+       return 1;
+     }
+
+  printf( "write %10.3f ms\n", ( Now() - t0 ) * 1000 );
+
+  bool ok = Load( file, loops );
+  unlink( file );
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+/*
+ * Test the domain timer service with 10000 hotswap timers:
+ * all of them are run by one thread, none expires early and
+ * cancelled timers don't expire.
+ *
+ * The timers follow the auto insertion policy of NewSimulatorHotSwap:
+ * INSERTION_PENDING goes to ACTIVE after the insertion timeout.
+ * A simulated resource needs the plugin handler, so the timers
+ * don't send events.
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <dirent.h>
+
+#include "new_sim_timer_service.h"
+#include "new_sim_timer_thread.h"
+#include "test.h"
+
+
+#define dNumResources 10000
+#define dMaxTimeout   500
+
+
+enum tTestHsState
+{
+  eHsInsertionPending,
+  eHsActive,
+  eHsInactive
+};
+
+
+static cThreadLock lock;
+static int  num_active = 0;
+static bool early      = false;
+
+
+class cTestHotSwap : public NewSimulatorTimerThread
+{
+public:
+  tTestHsState m_state;
+  cTime        m_insert;
+
+  cTestHotSwap( NewSimulatorTimerService *service )
+    : NewSimulatorTimerThread( service, 0 ), m_state( eHsInactive ) {}
+
+  ~cTestHotSwap()
+  {
+    Stop();
+  }
+
+  void ActionInsertion( unsigned int timeout )
+  {
+    m_state  = eHsInsertionPending;
+    m_insert = cTime::Now();
+    m_insert += (int)timeout;
+
+    Reset( timeout );
+    Start();
+  }
+
+  // like NewSimulatorHotSwap::SetInactive()
+  void SetInactive()
+  {
+    Stop();
+    m_state = eHsInactive;
+  }
+
+protected:
+  virtual bool TriggerAction()
+  {
+    cThreadLockAuto al( lock );
+
+    if ( cTime::Now() < m_insert )
+         early = true;
+
+    m_state = eHsActive;
+    num_active++;
+
+    return true;
+  }
+};
+
+
+// like the watchdog: the pre-timeout keeps the timer running
+// with a new timeout, the timeout stops it from its action
+class cTestWatchdog : public NewSimulatorTimerThread
+{
+public:
+  int m_pretimeout;
+  int m_timeout;
+
+  cTestWatchdog( NewSimulatorTimerService *service )
+    : NewSimulatorTimerThread( service, 20 ), m_pretimeout( 0 ), m_timeout( 0 ) {}
+
+  ~cTestWatchdog()
+  {
+    Stop();
+  }
+
+protected:
+  virtual bool TriggerAction()
+  {
+    cThreadLockAuto al( lock );
+
+    if ( m_pretimeout == 0 )
+       {
+         m_pretimeout++;
+         Reset( 20 );
+         return false;
+       }
+
+    m_timeout++;
+    Stop();
+
+    return true;
+  }
+};
+
+
+static int
+NumActive()
+{
+  cThreadLockAuto al( lock );
+
+  return num_active;
+}
+
+
+static int
+WdtTimeouts( cTestWatchdog &wdt )
+{
+  cThreadLockAuto al( lock );
+
+  return wdt.m_timeout;
+}
+
+
+static int
+NumThreads()
+{
+  DIR *dir = opendir( "/proc/self/task" );
+
+  if ( dir == 0 )
+       return -1;
+
+  int n = 0;
+  struct dirent *d;
+
+  while( ( d = readdir( dir ) ) != 0 )
+       if ( d->d_name[0] != '.' )
+            n++;
+
+  closedir( dir );
+
+  return n;
+}
+
+
+int
+main()
+{
+  NewSimulatorTimerService service;
+  cTestHotSwap *res[dNumResources];
+  int threads = NumThreads();
+
+  for( int i = 0; i < dNumResources; i++ )
+       res[i] = new cTestHotSwap( &service );
+
+  // no thread until a timer is started
+  Test( !service.IsRunning() );
+
+  for( int i = 0; i < dNumResources; i++ )
+       res[i]->ActionInsertion( 100 + ( i * 7919 ) % dMaxTimeout );
+
+  Test( service.IsRunning() );
+  Test( service.NumTimers() == dNumResources );
+
+  if ( threads > 0 )
+       Test( NumThreads() == threads + 1 );
+
+  // every 10th resource is set inactive before the timeout
+  int cancelled = 0;
+
+  for( int i = 0; i < dNumResources; i += 10 )
+     {
+       res[i]->SetInactive();
+       cancelled++;
+     }
+
+  cTime timeout = cTime::Now();
+  timeout += 10000;
+
+  while( NumActive() < dNumResources - cancelled && cTime::Now() < timeout )
+       usleep( 10000 );
+
+  // cancelled timers must not expire
+  usleep( 100000 );
+
+  Test( NumActive() == dNumResources - cancelled );
+  Test( service.NumTimers() == 0 );
+  Test( service.NumExpired() == (unsigned int)( dNumResources - cancelled ) );
+  Test( !early );
+
+  for( int i = 0; i < dNumResources; i++ )
+       Test( res[i]->m_state == ( i % 10 ? eHsActive : eHsInactive ) );
+
+  // a timer kept running by its action
+  cTestWatchdog wdt( &service );
+  wdt.Start();
+
+  timeout = cTime::Now();
+  timeout += 5000;
+
+  while( WdtTimeouts( wdt ) == 0 && cTime::Now() < timeout )
+       usleep( 10000 );
+
+  wdt.Stop();
+
+  Test( wdt.m_pretimeout == 1 );
+  Test( wdt.m_timeout == 1 );
+  Test( service.NumTimers() == 0 );
+
+  // timers can be deleted while they are scheduled
+  for( int i = 0; i < dNumResources; i++ )
+       res[i]->ActionInsertion( 60000 );
+
+  Test( service.NumTimers() == dNumResources );
+
+  for( int i = 0; i < dNumResources; i++ )
+       delete res[i];
+
+  Test( service.NumTimers() == 0 );
+
+  service.Shutdown();
+
+  Test( !service.IsRunning() );
+
+  if ( threads > 0 )
+       Test( NumThreads() == threads );
+
+  return TestResult();
+}
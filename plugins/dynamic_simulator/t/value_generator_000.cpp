@@ -0,0 +1,390 @@
+/*
+ * Test the sensor value generators: ramp, sine, random walk and
+ * trace replay, the threshold states with hysteresis and a trace
+ * run by the timer service.
+ *
+ * A simulated sensor needs the plugin handler, so the generators
+ * are tested without a sensor.
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+
+#include "new_sim_timer_service.h"
+#include "new_sim_value_generator.h"
+#include "test.h"
+
+
+static bool
+Near( double v1, double v2 )
+{
+  return fabs( v1 - v2 ) < 1e-6;
+}
+
+
+static SaHpiSensorReadingT
+Reading( double value )
+{
+  SaHpiSensorReadingT r;
+
+  NewSimulatorValueGenerator::FromDouble( value, SAHPI_SENSOR_READING_TYPE_FLOAT64, r );
+
+  return r;
+}
+
+
+static void
+TestRamp( NewSimulatorTimerService *service )
+{
+  NewSimulatorGeneratorParams params;
+  params.m_type     = GENERATOR_RAMP;
+  params.m_interval = 100;
+  params.m_min      = 0;
+  params.m_max      = 100;
+  params.m_period   = 1000;
+
+  NewSimulatorValueGenerator gen( service, 0, params );
+  Test( gen.Init() );
+
+  const double expected[] = { 0, 20, 40, 60, 80, 100, 80, 60, 40, 20, 0, 20 };
+  double value;
+
+  for( unsigned int i = 0; i < sizeof( expected ) / sizeof( double ); i++ )
+     {
+       Test( gen.NextValue( value ) );
+       Test( Near( value, expected[i] ) );
+     }
+
+  Test( gen.Count() == sizeof( expected ) / sizeof( double ) );
+}
+
+
+static void
+TestSine( NewSimulatorTimerService *service )
+{
+  NewSimulatorGeneratorParams params;
+  params.m_type     = GENERATOR_SINE;
+  params.m_interval = 100;
+  params.m_min      = -10;
+  params.m_max      = 10;
+  params.m_period   = 400;
+
+  NewSimulatorValueGenerator gen( service, 0, params );
+  Test( gen.Init() );
+
+  const double expected[] = { 0, 10, 0, -10, 0 };
+  double value;
+
+  for( unsigned int i = 0; i < sizeof( expected ) / sizeof( double ); i++ )
+     {
+       Test( gen.NextValue( value ) );
+       Test( Near( value, expected[i] ) );
+     }
+
+  // no period
+  params.m_period = 0;
+  NewSimulatorValueGenerator bad( service, 0, params );
+  Test( !bad.Init() );
+}
+
+
+static void
+TestRandomWalk( NewSimulatorTimerService *service )
+{
+  NewSimulatorGeneratorParams params;
+  params.m_type     = GENERATOR_RANDOM_WALK;
+  params.m_min      = 20;
+  params.m_max      = 40;
+  params.m_step     = 2;
+  params.m_seed     = 4711;
+
+  NewSimulatorValueGenerator gen1( service, 0, params );
+  NewSimulatorValueGenerator gen2( service, 0, params );
+  Test( gen1.Init() );
+  Test( gen2.Init() );
+
+  params.m_seed = 815;
+  NewSimulatorValueGenerator gen3( service, 0, params );
+  Test( gen3.Init() );
+
+  double v1, v2, v3, last = 30;
+  bool differ = false;
+
+  for( int i = 0; i < 1000; i++ )
+     {
+       Test( gen1.NextValue( v1 ) );
+       Test( gen2.NextValue( v2 ) );
+       Test( gen3.NextValue( v3 ) );
+
+       if ( i == 0 )
+            Test( Near( v1, 30 ) );
+
+       // the same seed gives the same walk
+       Test( v1 == v2 );
+
+       if ( v1 != v3 )
+            differ = true;
+
+       Test( v1 >= 20 && v1 <= 40 );
+       Test( fabs( v1 - last ) <= 2 );
+       last = v1;
+     }
+
+  Test( differ );
+
+  // a new Init() repeats the walk
+  Test( gen1.Init() );
+  Test( gen1.NextValue( v1 ) );
+  Test( Near( v1, 30 ) );
+}
+
+
+static void
+TestTraceCsv( NewSimulatorTimerService *service )
+{
+  char file[] = "/tmp/value_generator_000_XXXXXX";
+  int fd = mkstemp( file );
+  Test( fd >= 0 );
+
+  const char *data = "# recorded temperature\n"
+                     "time,value\n"
+                     "0,1.5\n"
+                     "\n"
+                     "1000,-2.5\n"
+                     "2000;3\n";
+  Test( write( fd, data, strlen( data ) ) == (ssize_t)strlen( data ) );
+  close( fd );
+
+  NewSimulatorGeneratorParams params;
+  params.m_type = GENERATOR_TRACE;
+  params.m_trace_format = TRACE_CSV;
+  params.m_loop = false;
+  params.SetTrace( file );
+
+  NewSimulatorValueGenerator gen( service, 0, params );
+  Test( gen.Init() );
+  Test( gen.NumValues() == 3 );
+
+  double value;
+  Test( gen.NextValue( value ) && Near( value, 1.5 ) );
+  Test( gen.NextValue( value ) && Near( value, -2.5 ) );
+  Test( gen.NextValue( value ) && Near( value, 3 ) );
+  Test( !gen.NextValue( value ) );
+
+  params.m_loop = true;
+  NewSimulatorValueGenerator loop( service, 0, params );
+  Test( loop.Init() );
+
+  for( int i = 0; i < 7; i++ )
+       Test( loop.NextValue( value ) );
+
+  Test( Near( value, 1.5 ) );
+
+  unlink( file );
+
+  // the trace is missing
+  NewSimulatorValueGenerator missing( service, 0, params );
+  Test( !missing.Init() );
+}
+
+
+static void
+TestTraceBinary( NewSimulatorTimerService *service )
+{
+  char file[] = "/tmp/value_generator_000_XXXXXX";
+  int fd = mkstemp( file );
+  Test( fd >= 0 );
+
+  double data[100];
+
+  for( int i = 0; i < 100; i++ )
+       data[i] = i * 0.25;
+
+  Test( write( fd, data, sizeof( data ) ) == (ssize_t)sizeof( data ) );
+  close( fd );
+
+  NewSimulatorGeneratorParams params;
+  params.m_type = GENERATOR_TRACE;
+  params.m_trace_format = TRACE_BINARY;
+  params.m_loop = false;
+  params.SetTrace( file );
+
+  NewSimulatorValueGenerator gen( service, 0, params );
+  Test( gen.Init() );
+  Test( gen.NumValues() == 100 );
+
+  double value;
+
+  for( int i = 0; i < 100; i++ )
+     {
+       Test( gen.NextValue( value ) );
+       Test( value == data[i] );
+     }
+
+  Test( !gen.NextValue( value ) );
+
+  // a trace with a broken double
+  fd = open( file, O_WRONLY | O_APPEND );
+  Test( write( fd, data, 3 ) == 3 );
+  close( fd );
+
+  NewSimulatorValueGenerator broken( service, 0, params );
+  Test( !broken.Init() );
+
+  unlink( file );
+}
+
+
+static void
+TestThresholdState()
+{
+  SaHpiSensorThresholdsT thres;
+  memset( &thres, 0, sizeof( thres ) );
+
+  thres.LowCritical      = Reading( 10 );
+  thres.LowMinor         = Reading( 20 );
+  thres.UpMinor          = Reading( 80 );
+  thres.UpMajor          = Reading( 90 );
+  thres.PosThdHysteresis = Reading( 2 );
+  thres.NegThdHysteresis = Reading( 3 );
+
+  SaHpiEventStateT state = 0;
+
+  state = NewSimulatorValueGenerator::ThresholdState( 50, thres, state );
+  Test( state == 0 );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 80, thres, state );
+  Test( state == SAHPI_ES_UPPER_MINOR );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 95, thres, state );
+  Test( state == ( SAHPI_ES_UPPER_MINOR | SAHPI_ES_UPPER_MAJOR ) );
+
+  // the upper major state is kept inside the hysteresis
+  state = NewSimulatorValueGenerator::ThresholdState( 88, thres, state );
+  Test( state == ( SAHPI_ES_UPPER_MINOR | SAHPI_ES_UPPER_MAJOR ) );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 86, thres, state );
+  Test( state == SAHPI_ES_UPPER_MINOR );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 76, thres, state );
+  Test( state == 0 );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 5, thres, state );
+  Test( state == ( SAHPI_ES_LOWER_MINOR | SAHPI_ES_LOWER_CRIT ) );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 11, thres, state );
+  Test( state == ( SAHPI_ES_LOWER_MINOR | SAHPI_ES_LOWER_CRIT ) );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 13, thres, state );
+  Test( state == SAHPI_ES_LOWER_MINOR );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 23, thres, state );
+  Test( state == 0 );
+
+  // unsupported thresholds never assert
+  state = NewSimulatorValueGenerator::ThresholdState( -100, thres, state );
+  Test( !( state & SAHPI_ES_LOWER_MAJOR ) );
+
+  state = NewSimulatorValueGenerator::ThresholdState( 1000, thres, 0 );
+  Test( !( state & SAHPI_ES_UPPER_CRIT ) );
+}
+
+
+static void
+TestConversion()
+{
+  SaHpiSensorReadingT r;
+  double value;
+
+  NewSimulatorValueGenerator::FromDouble( 41.6, SAHPI_SENSOR_READING_TYPE_INT64, r );
+  Test( r.IsSupported && r.Value.SensorInt64 == 42 );
+  Test( NewSimulatorValueGenerator::ToDouble( r, value ) && value == 42 );
+
+  NewSimulatorValueGenerator::FromDouble( -41.6, SAHPI_SENSOR_READING_TYPE_INT64, r );
+  Test( r.Value.SensorInt64 == -42 );
+
+  NewSimulatorValueGenerator::FromDouble( -1, SAHPI_SENSOR_READING_TYPE_UINT64, r );
+  Test( r.IsSupported && r.Value.SensorUint64 == 0 );
+
+  NewSimulatorValueGenerator::FromDouble( 1.25, SAHPI_SENSOR_READING_TYPE_FLOAT64, r );
+  Test( NewSimulatorValueGenerator::ToDouble( r, value ) && value == 1.25 );
+
+  NewSimulatorValueGenerator::FromDouble( 1, SAHPI_SENSOR_READING_TYPE_BUFFER, r );
+  Test( !r.IsSupported );
+  Test( !NewSimulatorValueGenerator::ToDouble( r, value ) );
+}
+
+
+// a trace without loop is run by the timer service until its end
+static void
+TestService( NewSimulatorTimerService *service )
+{
+  char file[] = "/tmp/value_generator_000_XXXXXX";
+  int fd = mkstemp( file );
+  Test( fd >= 0 );
+
+  const char *data = "1\n2\n3\n4\n5\n";
+  Test( write( fd, data, strlen( data ) ) == (ssize_t)strlen( data ) );
+  close( fd );
+
+  NewSimulatorGeneratorParams params;
+  params.m_type     = GENERATOR_TRACE;
+  params.m_interval = 10;
+  params.m_loop     = false;
+  params.SetTrace( file );
+
+  NewSimulatorValueGenerator gen( service, 0, params );
+  Test( gen.Init() );
+  unlink( file );
+
+  cTime start = cTime::Now();
+  gen.Start();
+
+  cTime timeout = cTime::Now();
+  timeout += 5000;
+
+  while( service->NumTimers() > 0 && cTime::Now() < timeout )
+       usleep( 10000 );
+
+  cTime duration = cTime::Now();
+  duration -= start;
+
+  Test( service->NumTimers() == 0 );
+  Test( gen.Count() == 5 );
+  // 5 readings and the end of the trace
+  Test( service->NumExpired() == 6 );
+  Test( duration.GetMsec() >= 60 );
+}
+
+
+int
+main()
+{
+  NewSimulatorTimerService service;
+
+  TestRamp( &service );
+  TestSine( &service );
+  TestRandomWalk( &service );
+  TestTraceCsv( &service );
+  TestTraceBinary( &service );
+  TestThresholdState();
+  TestConversion();
+  TestService( &service );
+
+  service.Shutdown();
+
+  return TestResult();
+}
@@ -307,6 +307,7 @@ enum ir_discoverstate { BLANK=0, OK=1, FAILED=2, REMOVED=3};
 #define IR_EXISTED		0x02
 #define IR_FAILED		0x04
 #define IR_SPEED_UPDATED	0x08
+#define IR_STATUS_UPDATED	0x10	/* status string changed since last poll */
 
 typedef struct ir_cpudata {
 	unsigned int cpuflags;
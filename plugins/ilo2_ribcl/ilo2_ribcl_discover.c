@@ -39,10 +39,8 @@
 #include <ilo2_ribcl_xml.h>
 #include <ilo2_ribcl_sensor.h>
 #include <ilo2_ribcl_idr.h>
-#ifdef ILO2_RIBCL_SIMULATE_iLO2_RESPONSE
 #include <sys/stat.h>   /* For test routine ilo2_ribcl_getfile() */
 #include <fcntl.h>      /* For test routine ilo2_ribcl_getfile() */
-#endif /* ILO2_RIBCL_SIMULATE_iLO2_RESPONSE */
 #include "sahpi_wrappers.h"
 
 /* Foreward decls: */
@@ -86,10 +84,6 @@ static SaErrorT ilo2_ribcl_get_iml( struct oh_handler_state *);
 static SaErrorT ilo2_ribcl_discovery(void *);
 gpointer ilo_thread_func( gpointer);
 
-#ifdef ILO2_RIBCL_SIMULATE_iLO2_RESPONSE
-static int ilo2_ribcl_getfile( char *, char *, int);
-#endif /* ILO2_RIBCL_SIMULATE_iLO2_RESPONSE */
-
 extern SaHpiBoolT close_handler;
 
 /**
@@ -496,13 +490,13 @@ static SaErrorT ilo2_ribcl_do_discovery( ilo2_ribcl_handler_t *ir_handler)
 
 		case ILO:
 		case ILO2:
-			ret = ir_xml_parse_discoveryinfo( ir_handler, 
+			ret = ir_xml_stream_parse_discoveryinfo( ir_handler,
 							d_response);
 			break;
 		case ILO3:
 		case ILO4:
 			new_buffer = ir_xml_decode_chunked(d_response);
-			ret = ir_xml_parse_discoveryinfo( ir_handler, 
+			ret = ir_xml_stream_parse_discoveryinfo( ir_handler, 
 							new_buffer);
 			break;
 		default:
@@ -534,7 +528,10 @@ static SaErrorT ilo2_ribcl_do_discovery( ilo2_ribcl_handler_t *ir_handler)
  * @ir_handler: Pointer to the plugin private handler. 
  *
  * This routine clears the IR_DISCOVERED bit in the flags element
- * for all discoverable resources that can be removed. 
+ * for all discoverable resources that can be removed. For fans, power
+ * supplies and VRMs the IR_STATUS_UPDATED bit is cleared as well, so that
+ * only the resources whose status changed since the last poll are
+ * revisited.
  *
  * Return values: None
  **/
@@ -557,17 +554,20 @@ void ilo2_ribcl_clear_discoveryflags( ilo2_ribcl_handler_t *ir_handler){
 
 	/* Clear the fan flags */
 	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_FAN_MAX; idex++){
-		ddata->fandata[idex].fanflags &= ~IR_DISCOVERED;
+		ddata->fandata[idex].fanflags &=
+					~(IR_DISCOVERED | IR_STATUS_UPDATED);
 	}
 
 	/* Clear the power supply flags */
 	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_PSU_MAX; idex++){
-		ddata->psudata[idex].psuflags &= ~IR_DISCOVERED;
+		ddata->psudata[idex].psuflags &=
+					~(IR_DISCOVERED | IR_STATUS_UPDATED);
 	}
 
 	/* Clear the VRM flags */
 	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_PSU_MAX; idex++){
-		ddata->vrmdata[idex].vrmflags &= ~IR_DISCOVERED;
+		ddata->vrmdata[idex].vrmflags &=
+					~(IR_DISCOVERED | IR_STATUS_UPDATED);
 	}
 
         /* Clear the Temperature Sensor flags */
@@ -1055,6 +1055,14 @@ static SaErrorT ilo2_ribcl_discover_fans( struct oh_handler_state *oh_handler,
 			continue;
 		}
 
+		/* A resource that is present, was not failed on the last
+		 * poll and reports the same status has nothing to update. */
+		if( (fandata->fanflags & IR_DISCOVERED) &&
+		    !(fandata->fanflags & IR_STATUS_UPDATED) &&
+		    (fandata->dstate == OK)){
+			continue;
+		}
+
 		/* Build the entity path for this fan */
 
 		fan_ep.Entry[0].EntityType = SAHPI_ENT_COOLING_DEVICE;
@@ -1081,7 +1089,7 @@ static SaErrorT ilo2_ribcl_discover_fans( struct oh_handler_state *oh_handler,
 		 *        </FAN>	
  		 **/
 		if(!strcmp(fanstatus, "Not Installed")|| !strcmp(fanstatus, "Unknown")){
-			fandata->fanflags = ~IR_DISCOVERED;
+			fandata->fanflags &= ~IR_DISCOVERED;
 		}
 
 		/* include the fan location in the text tag */
@@ -1170,6 +1178,14 @@ static SaErrorT ilo2_ribcl_discover_powersupplies( struct oh_handler_state *oh_h
 			continue;
 		}
 
+		/* A resource that is present, was not failed on the last
+		 * poll and reports the same status has nothing to update. */
+		if( (psudata->psuflags & IR_DISCOVERED) &&
+		    !(psudata->psuflags & IR_STATUS_UPDATED) &&
+		    (psudata->dstate == OK)){
+			continue;
+		}
+
 		/* Build the entity path for this psu */
 
 		psu_ep.Entry[0].EntityType = SAHPI_ENT_POWER_SUPPLY;
@@ -1190,7 +1206,7 @@ static SaErrorT ilo2_ribcl_discover_powersupplies( struct oh_handler_state *oh_h
 
 		if(!strcmp(psustatus, "Not Installed") || 
 			   !strcmp(psustatus, "Unknown")){
-			psudata->psuflags = ~IR_DISCOVERED;
+			psudata->psuflags &= ~IR_DISCOVERED;
 		}
 
 		if( psudata->psuflags & IR_DISCOVERED ){
@@ -1266,6 +1282,14 @@ static SaErrorT ilo2_ribcl_discover_vrm( struct oh_handler_state *oh_handler,
 			continue;
 		}
 
+		/* A resource that is present, was not failed on the last
+		 * poll and reports the same status has nothing to update. */
+		if( (vrmdata->vrmflags & IR_DISCOVERED) &&
+		    !(vrmdata->vrmflags & IR_STATUS_UPDATED) &&
+		    (vrmdata->dstate == OK)){
+			continue;
+		}
+
 		/* Build the entity path for this vrm */
 
 		vrm_ep.Entry[0].EntityType = SAHPI_ENT_POWER_MODULE;
@@ -2764,7 +2788,6 @@ static SaErrorT ilo2_ribcl_get_iml( struct oh_handler_state *oh_handler)
 }
 
 
-#ifdef ILO2_RIBCL_SIMULATE_iLO2_RESPONSE
 /**
  * ilo2_ribcl_getfile
  * @fname: The file name.
@@ -2772,11 +2795,13 @@ static SaErrorT ilo2_ribcl_get_iml( struct oh_handler_state *oh_handler)
  * @bufsize: Size of the destination buffer.
  *
  * This function, intended for testing, will read the contents of file
- * 'fname' into the buffer pointed to by 'buffer'.
+ * 'fname' into the buffer pointed to by 'buffer'. It is used when
+ * ILO2_RIBCL_SIMULATE_iLO2_RESPONSE is defined and by the XML parser
+ * benchmark to load saved iLO2 responses.
  *
  * Return values: 0 if Success, 1 otherwise.
  **/
-static int ilo2_ribcl_getfile( char *fname, char *buffer, int bufsize)
+int ilo2_ribcl_getfile( char *fname, char *buffer, int bufsize)
 {
 
 	int fd;
@@ -2825,8 +2850,6 @@ static int ilo2_ribcl_getfile( char *fname, char *buffer, int bufsize)
 
 } /* end ilo2_ribcl_getfile() */
 
-#endif /* ILO2_RIBCL_SIMULATE_iLO2_RESPONSE */
-
 
 
 /*****************************
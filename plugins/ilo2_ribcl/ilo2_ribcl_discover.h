@@ -50,4 +50,6 @@ extern void ilo2_ribcl_free_discoverydata( ilo2_ribcl_handler_t *);
 extern void ilo2_ribcl_add_resource_capability( struct oh_handler_state *,
         struct oh_event *, SaHpiCapabilitiesT); 
 
+extern int ilo2_ribcl_getfile( char *, char *, int);
+
 #endif /* _INC_ILO2_RIBCL_DISCOVER_H_ */
@@ -46,6 +46,7 @@
 #include <sys/types.h>
 #include <libxml/parser.h>
 #include <libxml/xmlmemory.h>
+#include <libxml/xmlreader.h>
 #include <ilo2_ribcl.h>
 #include <ilo2_ribcl_xml.h>
 #include <ilo2_ribcl_cmnds.h>
@@ -55,6 +56,7 @@
 static xmlNodePtr ir_xml_find_node( xmlNodePtr, char *);
 static int ir_xml_checkresults_doc( xmlDocPtr, char *);
 static int ir_xml_scan_response( xmlNodePtr, char *);
+static int ir_xml_response_status( xmlNodePtr, char *);
 static char *ir_xml_convert_buffer( char*, int *);
 static xmlDocPtr ir_xml_doparse( char *);
 static int ir_xml_scan_fans( ilo2_ribcl_handler_t *, xmlNodePtr);
@@ -80,6 +82,7 @@ static xmlChar *ir_xml_smb_get_value( char *, xmlNodePtr);
 static int ir_xml_insert_logininfo( char *, int, char *, char *, char *);
 static int ir_xml_extract_index( char *, char *, int);
 static int ir_xml_replacestr( char **, char *);
+static int ir_xml_str_changed( char *, char *);
 static int ir_xml_iml_write( struct oh_handler_state*,xmlNodePtr);
 static SaErrorT ilo2_ribcl_iml_event( xmlNodePtr n,char *host, 
 					struct oh_handler_state*,
@@ -403,6 +406,264 @@ int ir_xml_parse_discoveryinfo( ilo2_ribcl_handler_t *ir_handler,
 } /* end ir_xml_parse_discoveryinfo() */
 
 
+/**
+ * ir_xml_stream_parse_discoveryinfo
+ * @ir_handler: Ptr to this instance's custom handler.
+ * @ribcl_outbuf: Ptr to the raw RIBCL output from the GET_SERVER_DATA cmd
+ *
+ * Parses the same output as ir_xml_parse_discoveryinfo(), but with the
+ * libxml2 xmlTextReader pull parser rather than building a tree for the
+ * whole response. The reader walks the response element by element, and
+ * only the sections we are interested in (each SMBIOS_RECORD of
+ * GET_HOST_DATA, the FANS, VRM, POWER_SUPPLIES, TEMPERATURE and
+ * HEALTH_AT_A_GLANCE sections of GET_EMBEDDED_HEALTH_DATA and the
+ * GET_FW_VERSION element) are expanded into a small subtree. That subtree
+ * is handed to the same ir_xml_scan_XXX() routines used by the tree parser,
+ * and is released by the reader as soon as we move past it. So memory use
+ * is bounded by the largest section instead of the whole response, and the
+ * DiscoveryData structure is updated in place as the sections arrive.
+ *
+ * The STATUS of each RIBCL RESPONSE is checked as it is read. Since the
+ * sections are recorded as they arrive, a failure reported by a later
+ * RIBCL section leaves the earlier sections recorded; the caller treats
+ * the whole discovery as failed in that case, as before.
+ *
+ * Return value: RIBCL_SUCCESS on success, -1 if error.
+ **/
+int ir_xml_stream_parse_discoveryinfo( ilo2_ribcl_handler_t *ir_handler,
+				char *ribcl_outbuf)
+{
+	xmlTextReaderPtr reader;
+	xmlNodePtr s_node;
+	const xmlChar *name;
+	xmlChar *typ;
+	char *ribcl_xml_buf;
+	int xml_buf_size;
+	int depth;
+	int host_depth = -1;		/* depth of GET_HOST_DATA */
+	int eh_depth = -1;		/* depth of GET_EMBEDDED_HEALTH_DATA */
+	int in_ribcl = 0;
+	int ribcl_resp = 0;
+	int successful = 0;
+	int found_host = 0;
+	int found_eh = 0;
+	int found_fw = 0;
+	int mem_slotindex = 1;
+	int skip;
+	int rd;
+	int status = RIBCL_SUCCESS;
+	int ret = RIBCL_SUCCESS;
+
+	ribcl_xml_buf = ir_xml_convert_buffer( ribcl_outbuf, &xml_buf_size);
+	if( ribcl_xml_buf == NULL){
+		err("ir_xml_stream_parse_discoveryinfo(): Error converting XML output buffer.");
+		return( -1);
+	}
+
+	reader = xmlReaderForMemory( ribcl_xml_buf, xml_buf_size, NULL, NULL,
+				     0);
+	if( reader == NULL){
+		err("ir_xml_stream_parse_discoveryinfo(): Could not create XML reader.");
+		free( ribcl_xml_buf);
+		return( -1);
+	}
+
+	rd = xmlTextReaderRead( reader);
+	while( (rd == 1) && (ret == RIBCL_SUCCESS) &&
+	       (status == RIBCL_SUCCESS)){
+
+		skip = 0;
+
+		if( xmlTextReaderNodeType( reader) != XML_READER_TYPE_ELEMENT){
+			rd = xmlTextReaderRead( reader);
+			continue;
+		}
+
+		name = xmlTextReaderConstName( reader);
+		depth = xmlTextReaderDepth( reader);
+
+		/* Leaving the GET_HOST_DATA or GET_EMBEDDED_HEALTH_DATA
+		 * section? */
+		if( depth <= host_depth){
+			host_depth = -1;
+		}
+		if( depth <= eh_depth){
+			eh_depth = -1;
+		}
+
+		if( (depth == 1) &&
+		    !xmlStrcmp( name, (const xmlChar *)"RIBCL")){
+
+			/* Every RIBCL section must have a RESPONSE */
+			if( in_ribcl && !ribcl_resp){
+				status = -1;
+				break;
+			}
+			in_ribcl = 1;
+			ribcl_resp = 0;
+
+		} else if( in_ribcl && !ribcl_resp && (depth == 2) &&
+		    !xmlStrcmp( name, (const xmlChar *)"RESPONSE")){
+
+			ribcl_resp = 1;
+			s_node = xmlTextReaderExpand( reader);
+			if( s_node == NULL){
+				ret = -1;
+			} else {
+				status = ir_xml_response_status( s_node,
+						ir_handler->ilo2_hostport);
+				successful = 1;
+			}
+			skip = 1;
+
+		} else if( !found_host &&
+		    !xmlStrcmp( name, (const xmlChar *)"GET_HOST_DATA")){
+
+			found_host = 1;
+			host_depth = depth;
+
+		} else if( (host_depth >= 0) && (depth == host_depth + 1) &&
+		    !xmlStrcmp( name, (const xmlChar *)"SMBIOS_RECORD")){
+
+			s_node = xmlTextReaderExpand( reader);
+			if( s_node == NULL){
+				ret = -1;
+				break;
+			}
+
+			typ = xmlGetProp( s_node, (const xmlChar *)"TYPE");
+
+			if( !xmlStrcmp( typ, (const xmlChar *)"1")){
+				/* Scan type 1 node for product name */
+				ret = ir_xml_scan_smbios_1( ir_handler,
+								s_node);
+			} else if( !xmlStrcmp( typ, (const xmlChar *)"4")){ 
+				/* Scan type 4 node for processor info */
+				ret = ir_xml_scan_smbios_4( ir_handler,
+								s_node);
+			} else if( !xmlStrcmp( typ, (const xmlChar *)"17")){
+				/* Scan type 17 node for memory */
+				ret = ir_xml_scan_smbios_17( ir_handler,
+							     s_node,
+							     &mem_slotindex);
+			}
+
+			if( typ){
+				xmlFree( typ);
+			}
+			skip = 1;
+
+		} else if( !found_eh &&
+		    !xmlStrcmp( name,
+				(const xmlChar *)"GET_EMBEDDED_HEALTH_DATA")){
+
+			found_eh = 1;
+			eh_depth = depth;
+
+		} else if( (eh_depth >= 0) && (depth == eh_depth + 1)){
+
+			/* Only the direct children of GET_EMBEDDED_HEALTH_DATA
+			 * are sections, HEALTH_AT_A_GLANCE has children with
+			 * the same names. */
+
+			s_node = NULL;
+			if( !xmlStrcmp( name, (const xmlChar *)"FANS") ||
+			    !xmlStrcmp( name, (const xmlChar *)"VRM") ||
+			    !xmlStrcmp( name, (const xmlChar *)"POWER_SUPPLIES") ||
+			    !xmlStrcmp( name, (const xmlChar *)"TEMPERATURE") ||
+			    !xmlStrcmp( name,
+					(const xmlChar *)"HEALTH_AT_A_GLANCE")){
+
+				s_node = xmlTextReaderExpand( reader);
+				if( s_node == NULL){
+					ret = -1;
+					break;
+				}
+				skip = 1;
+			}
+
+			if( s_node == NULL){
+				/* Not a section we use */
+			} else if( !xmlStrcmp( s_node->name,
+					       (const xmlChar *)"FANS")){
+				ret = ir_xml_scan_fans( ir_handler, s_node);
+			} else if( !xmlStrcmp( s_node->name,
+					       (const xmlChar *)"VRM")){
+				ret = ir_xml_scan_vrm( ir_handler, s_node);
+			} else if( !xmlStrcmp( s_node->name,
+					(const xmlChar *)"POWER_SUPPLIES")){
+				ret = ir_xml_scan_power( ir_handler, s_node);
+			} else if( !xmlStrcmp( s_node->name,
+					(const xmlChar *)"TEMPERATURE")){
+				ret = ir_xml_scan_temperature( ir_handler,
+								s_node);
+			} else {
+				ret = ir_xml_scan_health_at_a_glance(
+							ir_handler, s_node);
+			}
+
+		} else if( !found_fw &&
+		    !xmlStrcmp( name, (const xmlChar *)"GET_FW_VERSION")){
+
+			found_fw = 1;
+			s_node = xmlTextReaderExpand( reader);
+			if( s_node == NULL){
+				ret = -1;
+				break;
+			}
+			ir_xml_scan_firmware_revision( ir_handler, s_node);
+			skip = 1;
+		}
+
+		/* Move past a section we have scanned, so the reader can
+		 * release its subtree. */
+		if( skip){
+			rd = xmlTextReaderNext( reader);
+		} else {
+			rd = xmlTextReaderRead( reader);
+		}
+
+	} /* end while rd == 1 */
+
+	xmlFreeTextReader( reader);
+	free( ribcl_xml_buf);
+
+	if( rd == -1){
+		err("ir_xml_stream_parse_discoveryinfo(): XML parsing failed.");
+		return( -1);
+	}
+
+	/* The scan routines log their own errors */
+	if( ret != RIBCL_SUCCESS){
+		return( -1);
+	}
+
+	if( (status != RIBCL_SUCCESS) || !successful ||
+	    (in_ribcl && !ribcl_resp)){
+		err("ir_xml_stream_parse_discoveryinfo(): Unsuccessful RIBCL status.");
+		return( -1);
+	}
+
+	if( !found_host){
+		err("ir_xml_stream_parse_discoveryinfo(): GET_HOST_DATA element not found."); 
+		return( -1);
+	}
+
+	if( !found_eh){
+		err("ir_xml_stream_parse_discoveryinfo(): GET_EMBEDDED_HEALTH_DATA element not found."); 
+		return( -1);
+	}
+
+	if( !found_fw){
+		err("ir_xml_stream_parse_discoveryinfo(): GET_FW_VERSION element not found."); 
+		return( -1);
+	}
+
+	return( RIBCL_SUCCESS);
+
+} /* end ir_xml_stream_parse_discoveryinfo() */
+
+
 
 /**
  * ir_xml_parse_hostdata
@@ -1373,6 +1634,8 @@ static int ir_xml_scan_fans( ilo2_ribcl_handler_t *ir_handler,
  *	- Set the IR_DISCOVERED bit in fanflags.
  *	- if the fan speed differs from our previous reading, set the
  *	  IR_SPEED_UPDATED flag in fanflags.
+ *	- if the fan status differs from our previous reading, set the
+ *	  IR_STATUS_UPDATED flag in fanflags.
  *	- Store updated values for the speed, label, zone, status, and
  *	  speedunit for this fan.  
  *
@@ -1439,6 +1702,10 @@ static int ir_xml_record_fandata( ilo2_ribcl_handler_t *ir_handler,
 		return( -1);
 	}
 	
+	if( ir_xml_str_changed( fandat->status, fanstat)){
+		fandat->fanflags |= IR_STATUS_UPDATED;
+	}
+
 	if( ir_xml_replacestr( &(fandat->status), fanstat) != RIBCL_SUCCESS){
 		return( -1);
 	}
@@ -1954,6 +2221,10 @@ static int ir_xml_record_vrmdata( ilo2_ribcl_handler_t *ir_handler,
 		return( -1);
 	}
 
+	if( ir_xml_str_changed( vrmdat->status, vrmstat)){
+		vrmdat->vrmflags |= IR_STATUS_UPDATED;
+	}
+
 	if( ir_xml_replacestr( &(vrmdat->status), vrmstat) != RIBCL_SUCCESS){
 		return( -1);
 	}
@@ -2123,6 +2394,10 @@ static int ir_xml_record_psdata( ilo2_ribcl_handler_t *ir_handler,
 		return( -1);
 	}
 	  
+	if( ir_xml_str_changed( psudat->status, psstat)){
+		psudat->psuflags |= IR_STATUS_UPDATED;
+	}
+
 	if( ir_xml_replacestr( &(psudat->status), psstat) != RIBCL_SUCCESS){
 		return( -1);
 	}
@@ -2739,22 +3014,13 @@ int ir_xml_checkresults_doc( xmlDocPtr doc, char *ilostr){
  * ilostring
  *
  * Examines the RIBCL node for a RESPONSE section, and then returns the value
- * of the STATUS propery.
- *
- * If the STATUS property in the RESPONSE section is not equal to the value
- * zero (RIBCL_SUCCESS), then log any text in the MESSAGE property as an
- * error message. The string passed in parameter 'ilostring' will be
- * incorporated into the error message so each iLO2's messages can be
- * identified if multiple instances are in use. 
+ * of the STATUS propery, see ir_xml_response_status().
  *
  * Return value: Integer value of the STATUS property on success, -1 on failure.
  **/
 static int ir_xml_scan_response( xmlNodePtr RIBCLnode, char *ilostring)
 {
 	xmlNodePtr resp_node;
-	xmlChar *statprop;
-	xmlChar *errmes;
-	int ret_stat = RIBCL_SUCCESS;
 	
 	/* Parameter RIBCLnode should point to a RIBCL node in the RIBCL xml
 	 * output document. */
@@ -2763,38 +3029,7 @@ static int ir_xml_scan_response( xmlNodePtr RIBCLnode, char *ilostring)
 	while( resp_node != NULL){
 
 		if((!xmlStrcmp( resp_node->name, (const xmlChar *)"RESPONSE"))){
-			statprop = xmlGetProp( resp_node, (const xmlChar *)"STATUS");
-			if( statprop != NULL){
-				ret_stat = (int)( strtol( (char *)statprop,
-						 NULL, 0));
-				xmlFree( statprop);
-			}
-
-			/* Log the error message from iLO2 */
-			if( ret_stat != RIBCL_SUCCESS){
-				errmes = xmlGetProp( resp_node,
-						(const xmlChar *)"MESSAGE");
-				if( errmes){
-					/* this condition indicates the 
-					   requested setting is not supported
-					   on the platform. For example
-					   SET_HOST_POWER_SAVER 
-					   HOST_POWER_SAVER="4" is not a
-					   supported value on a DL385 G2.
-					   Return RIBCL_UNSUPPORTED to the
-					   calling routine. */
-
-					if(xmlStrcmp(errmes,
-						(const xmlChar *)"The value specified is invalid.") == 0) {
-						ret_stat = RIBCL_UNSUPPORTED;
-					}
-					err("Error from iLO2 at %s : %s.",
-						ilostring, (char *)errmes);
-					xmlFree( errmes);
-				}
-			}
-
-			return( ret_stat);
+			return( ir_xml_response_status( resp_node, ilostring));
 		}
 		
 		resp_node = resp_node->next;
@@ -2805,6 +3040,62 @@ static int ir_xml_scan_response( xmlNodePtr RIBCLnode, char *ilostring)
 
 
 
+/**
+ * ir_xml_response_status
+ * @resp_node: Ptr to a RESPONSE node of a RIBCL section.
+ * @ilostring: String to identify a particular iLO2 in error messages.
+ *
+ * Returns the value of the STATUS propery of a RESPONSE node.
+ *
+ * If the STATUS property in the RESPONSE section is not equal to the value
+ * zero (RIBCL_SUCCESS), then log any text in the MESSAGE property as an
+ * error message. The string passed in parameter 'ilostring' will be
+ * incorporated into the error message so each iLO2's messages can be
+ * identified if multiple instances are in use. 
+ *
+ * Return value: Integer value of the STATUS property.
+ **/
+static int ir_xml_response_status( xmlNodePtr resp_node, char *ilostring)
+{
+	xmlChar *statprop;
+	xmlChar *errmes;
+	int ret_stat = RIBCL_SUCCESS;
+
+	statprop = xmlGetProp( resp_node, (const xmlChar *)"STATUS");
+	if( statprop != NULL){
+		ret_stat = (int)( strtol( (char *)statprop, NULL, 0));
+		xmlFree( statprop);
+	}
+
+	/* Log the error message from iLO2 */
+	if( ret_stat != RIBCL_SUCCESS){
+		errmes = xmlGetProp( resp_node, (const xmlChar *)"MESSAGE");
+		if( errmes){
+			/* this condition indicates the 
+			   requested setting is not supported
+			   on the platform. For example
+			   SET_HOST_POWER_SAVER 
+			   HOST_POWER_SAVER="4" is not a
+			   supported value on a DL385 G2.
+			   Return RIBCL_UNSUPPORTED to the
+			   calling routine. */
+
+			if(xmlStrcmp(errmes,
+				(const xmlChar *)"The value specified is invalid.") == 0) {
+				ret_stat = RIBCL_UNSUPPORTED;
+			}
+			err("Error from iLO2 at %s : %s.",
+				ilostring, (char *)errmes);
+			xmlFree( errmes);
+		}
+	}
+
+	return( ret_stat);
+
+} /* end ir_xml_response_status() */
+
+
+
 /**
  * ir_xml_convert_buffer
  * @oldbuffer: Ptr to memory buffer containing the raw RIBCL output.
@@ -3089,6 +3380,33 @@ static int ir_xml_replacestr( char **ostring, char *nstring)
 	
 } /* end ir_xml_replacestr() */
 
+
+
+/**
+ * ir_xml_str_changed
+ * @ostring: the string recorded from a previous response, may be NULL.
+ * @nstring: the string from the current response, may be NULL.
+ *
+ * Used by the record routines to tell if a value reported by iLO2 differs
+ * from the one we already have in DiscoveryData. A NULL new string leaves
+ * the old value in place (see ir_xml_replacestr()), so it is not a change.
+ *
+ * Return value: 1 if the value changed, 0 otherwise.
+ **/
+static int ir_xml_str_changed( char *ostring, char *nstring)
+{
+	if( nstring == NULL){
+		return( 0);
+	}
+
+	if( (ostring == NULL) || strcmp( ostring, nstring)){
+		return( 1);
+	}
+
+	return( 0);
+
+} /* end ir_xml_str_changed() */
+
 /**
  * ir_xml_decode_chunked
  * @d_response: Pointer to the raw output from RIBCL command.
@@ -0,0 +1,281 @@
+/*
+ * iLO2 RIBCL discovery response parser benchmark.
+ *
+ * Loads a saved GET_SERVER_DATA response with ilo2_ribcl_getfile() and
+ * times the tree parser ir_xml_parse_discoveryinfo() against the pull
+ * parser ir_xml_stream_parse_discoveryinfo(). Both must record the same
+ * DiscoveryData, and parsing the same response a second time must not
+ * flag any fan, power supply or VRM as changed. Responses saved from an
+ * iLO3/iLO4 (starting with the HTTP header) are decoded first.
+ * Not part of "make check": build it with "make ilo2_ribcl_xml_bench".
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <ilo2_ribcl.h>
+#include <ilo2_ribcl_xml.h>
+#include <ilo2_ribcl_discover.h>
+
+typedef int (*ir_bench_parser_t)( ilo2_ribcl_handler_t *, char *);
+
+static double ir_bench_now( void)
+{
+	struct timeval tv;
+
+	gettimeofday( &tv, NULL);
+	return( tv.tv_sec + tv.tv_usec / 1000000.0);
+}
+
+static ilo2_ribcl_handler_t *ir_bench_handler_new( void)
+{
+	ilo2_ribcl_handler_t *ir_handler;
+
+	ir_handler = g_new0( ilo2_ribcl_handler_t, 1);
+	ir_handler->ilo2_hostport = "bench";
+	return( ir_handler);
+}
+
+static void ir_bench_handler_free( ilo2_ribcl_handler_t *ir_handler)
+{
+	ilo2_ribcl_free_discoverydata( ir_handler);
+	g_free( ir_handler);
+}
+
+/* Returns msec per parse, or a negative value if a parse failed */
+static double ir_bench_time( ir_bench_parser_t parser, char *response,
+			     int loops)
+{
+	ilo2_ribcl_handler_t *ir_handler;
+	double t0, t1;
+	int i;
+
+	ir_handler = ir_bench_handler_new();
+
+	t0 = ir_bench_now();
+	for( i = 0; i < loops; i++){
+		if( parser( ir_handler, response) != RIBCL_SUCCESS){
+			ir_bench_handler_free( ir_handler);
+			return( -1.0);
+		}
+	}
+	t1 = ir_bench_now();
+
+	ir_bench_handler_free( ir_handler);
+	return( (t1 - t0) * 1000 / loops);
+}
+
+static int ir_bench_strdiff( const char *what, int idex, char *a, char *b)
+{
+	if( (a == NULL) && (b == NULL)){
+		return( 0);
+	}
+
+	if( (a == NULL) || (b == NULL) || strcmp( a, b)){
+		printf( "%s %d differs: \"%s\" != \"%s\"\n", what, idex,
+			a ? a : "(null)", b ? b : "(null)");
+		return( 1);
+	}
+
+	return( 0);
+}
+
+/* Returns the number of fields that differ between the two handlers */
+static int ir_bench_compare( ilo2_ribcl_DiscoveryData_t *a,
+			     ilo2_ribcl_DiscoveryData_t *b)
+{
+	int diffs = 0;
+	int idex;
+
+	diffs += ir_bench_strdiff( "product name", 0, a->product_name,
+				   b->product_name);
+	diffs += ir_bench_strdiff( "serial number", 0, a->serial_number,
+				   b->serial_number);
+	diffs += ir_bench_strdiff( "firmware", 0, a->fwdata.version_string,
+				   b->fwdata.version_string);
+
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_CPU_MAX; idex++){
+		diffs += ir_bench_strdiff( "cpu", idex, a->cpudata[idex].label,
+					   b->cpudata[idex].label);
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_MEM_MAX; idex++){
+		diffs += ir_bench_strdiff( "memory", idex,
+			a->memdata[idex].label, b->memdata[idex].label);
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_FAN_MAX; idex++){
+		diffs += ir_bench_strdiff( "fan", idex,
+			a->fandata[idex].status, b->fandata[idex].status);
+		if( a->fandata[idex].speed != b->fandata[idex].speed){
+			printf( "fan %d speed differs\n", idex);
+			diffs++;
+		}
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_PSU_MAX; idex++){
+		diffs += ir_bench_strdiff( "power supply", idex,
+			a->psudata[idex].status, b->psudata[idex].status);
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_VRM_MAX; idex++){
+		diffs += ir_bench_strdiff( "vrm", idex,
+			a->vrmdata[idex].status, b->vrmdata[idex].status);
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_TS_MAX; idex++){
+		diffs += ir_bench_strdiff( "temperature", idex,
+			a->tsdata[idex].reading, b->tsdata[idex].reading);
+	}
+	for( idex = 0; idex < I2R_NUM_CHASSIS_SENSORS; idex++){
+		if( a->chassis_sensors[idex].reading.intval !=
+		    b->chassis_sensors[idex].reading.intval){
+			printf( "chassis sensor %d differs\n", idex);
+			diffs++;
+		}
+	}
+
+	return( diffs);
+}
+
+/* Parses the response twice and returns the number of fans, power
+ * supplies and VRMs flagged as changed by the second parse */
+static int ir_bench_changes( char *response)
+{
+	ilo2_ribcl_handler_t *ir_handler;
+	ilo2_ribcl_DiscoveryData_t *ddata;
+	int changed = 0;
+	int idex;
+
+	ir_handler = ir_bench_handler_new();
+	ddata = &(ir_handler->DiscoveryData);
+
+	if( ir_xml_stream_parse_discoveryinfo( ir_handler, response)
+							!= RIBCL_SUCCESS){
+		ir_bench_handler_free( ir_handler);
+		return( -1);
+	}
+
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_FAN_MAX; idex++){
+		ddata->fandata[idex].fanflags &= ~IR_STATUS_UPDATED;
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_PSU_MAX; idex++){
+		ddata->psudata[idex].psuflags &= ~IR_STATUS_UPDATED;
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_VRM_MAX; idex++){
+		ddata->vrmdata[idex].vrmflags &= ~IR_STATUS_UPDATED;
+	}
+
+	if( ir_xml_stream_parse_discoveryinfo( ir_handler, response)
+							!= RIBCL_SUCCESS){
+		ir_bench_handler_free( ir_handler);
+		return( -1);
+	}
+
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_FAN_MAX; idex++){
+		if( ddata->fandata[idex].fanflags & IR_STATUS_UPDATED){
+			changed++;
+		}
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_PSU_MAX; idex++){
+		if( ddata->psudata[idex].psuflags & IR_STATUS_UPDATED){
+			changed++;
+		}
+	}
+	for( idex = 1; idex <= ILO2_RIBCL_DISCOVER_VRM_MAX; idex++){
+		if( ddata->vrmdata[idex].vrmflags & IR_STATUS_UPDATED){
+			changed++;
+		}
+	}
+
+	ir_bench_handler_free( ir_handler);
+	return( changed);
+}
+
+int main( int argc, char *argv[])
+{
+	ilo2_ribcl_handler_t *tree_handler;
+	ilo2_ribcl_handler_t *stream_handler;
+	char *raw;
+	char *decoded = NULL;
+	char *response;
+	double tree_ms;
+	double stream_ms;
+	int loops = 200;
+	int diffs;
+	int changed;
+
+	if( argc < 2){
+		printf( "Usage: %s <saved RIBCL response> [loops]\n", argv[0]);
+		return( 1);
+	}
+
+	if( argc > 2){
+		loops = atoi( argv[2]);
+		if( loops < 1){
+			loops = 1;
+		}
+	}
+
+	raw = malloc( ILO2_RIBCL_DISCOVER_RESP_MAX);
+	if( raw == NULL){
+		return( 1);
+	}
+
+	if( ilo2_ribcl_getfile( argv[1], raw, ILO2_RIBCL_DISCOVER_RESP_MAX)){
+		printf( "cannot read %s\n", argv[1]);
+		free( raw);
+		return( 1);
+	}
+
+	response = raw;
+	if( strncmp( raw, "HTTP/", 5) == 0){
+		decoded = ir_xml_decode_chunked( raw);
+		if( decoded == NULL){
+			printf( "cannot decode chunked response %s\n", argv[1]);
+			free( raw);
+			return( 1);
+		}
+		response = decoded;
+	}
+
+	/* Both parsers must record the same data */
+	tree_handler = ir_bench_handler_new();
+	stream_handler = ir_bench_handler_new();
+	if( (ir_xml_parse_discoveryinfo( tree_handler, response)
+							!= RIBCL_SUCCESS) ||
+	    (ir_xml_stream_parse_discoveryinfo( stream_handler, response)
+							!= RIBCL_SUCCESS)){
+		printf( "cannot parse %s\n", argv[1]);
+		ir_bench_handler_free( tree_handler);
+		ir_bench_handler_free( stream_handler);
+		free( decoded);
+		free( raw);
+		return( 1);
+	}
+	diffs = ir_bench_compare( &(tree_handler->DiscoveryData),
+				  &(stream_handler->DiscoveryData));
+	ir_bench_handler_free( tree_handler);
+	ir_bench_handler_free( stream_handler);
+
+	tree_ms = ir_bench_time( ir_xml_parse_discoveryinfo, response, loops);
+	stream_ms = ir_bench_time( ir_xml_stream_parse_discoveryinfo,
+				   response, loops);
+	changed = ir_bench_changes( response);
+
+	printf( "%d bytes, %d loops\n", (int)strlen( response), loops);
+	printf( "tree %10.3f ms  stream %10.3f ms  (%.2fx)\n",
+		tree_ms, stream_ms, stream_ms > 0 ? tree_ms / stream_ms : 0.0);
+	printf( "%d fields differ, %d records changed on re-poll\n",
+		diffs, changed);
+
+	free( decoded);
+	free( raw);
+
+	return( (diffs == 0 && changed == 0) ? 0 : 1);
+}
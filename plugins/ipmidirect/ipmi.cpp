@@ -21,6 +21,7 @@
 
 #include "ipmi.h"
 #include "ipmi_con_lan.h"
+#include "ipmi_con_pool.h"
 #include "ipmi_con_smi.h"
 #include "ipmi_utils.h"
 
@@ -1881,6 +1882,15 @@ cIpmi::AllocConnection( GHashTable *handler_config )
         stdlog << "AllocConnection: Don't poll alive MCs.\n";
      }
 
+  // threads running the tasks of all MCs
+  m_mc_workers = GetIntNotNull( handler_config, "McWorkerThreads",
+                                dIpmiSchedulerDefaultWorkers );
+
+  if ( m_mc_workers > dIpmiSchedulerMaxWorkers )
+       m_mc_workers = dIpmiSchedulerMaxWorkers;
+
+  stdlog << "AllocConnection: MC worker threads " << m_mc_workers << ".\n";
+
   m_own_domain = false;
   /** This code block has been commented out due to the
    ** multi-domain changes in the infrastructure.
@@ -2032,9 +2042,27 @@ cIpmi::AllocConnection( GHashTable *handler_config )
        if ( value )
             strncpy( passwd, value, 32 );
 
-       return new cIpmiConLanDomain( this, m_con_ipmi_timeout, dIpmiConLogAll,
-                                     lan_addr, lan_port, auth, priv,
-                                     user, passwd );
+       // number of RMCP sessions
+       unsigned int sessions = GetIntNotNull( handler_config, "LanSessions", 1 );
+
+       if ( sessions > dIpmiConPoolMaxSessions )
+            sessions = dIpmiConPoolMaxSessions;
+
+       stdlog << "AllocConnection: sessions = " << sessions << ".\n";
+
+       if ( sessions <= 1 )
+            return new cIpmiConLanDomain( this, m_con_ipmi_timeout, dIpmiConLogAll,
+                                          lan_addr, lan_port, auth, priv,
+                                          user, passwd );
+
+       cIpmiConPool *pool = new cIpmiConPool( m_con_ipmi_timeout, dIpmiConLogAll );
+
+       for( unsigned int i = 0; i < sessions; i++ )
+            pool->AddSession( new cIpmiConLanDomain( this, m_con_ipmi_timeout, dIpmiConLogAll,
+                                                     lan_addr, lan_port, auth, priv,
+                                                     user, passwd ) );
+
+       return pool;
      }
   else if ( !strcmp( name, "smi" ) )
      {
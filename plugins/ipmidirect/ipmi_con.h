@@ -195,18 +195,18 @@ protected:
   virtual void HandleCheckConnection( bool state );
 
 public:
-  bool  Open();
-  void  Close();
-  SaErrorT Cmd( const cIpmiAddr &addr, const cIpmiMsg &msg,
-                cIpmiAddr &rsp_addr, cIpmiMsg &rsp_msg,
-                int retries = dIpmiDefaultRetries );
+  virtual bool  Open();
+  virtual void  Close();
+  virtual SaErrorT Cmd( const cIpmiAddr &addr, const cIpmiMsg &msg,
+                        cIpmiAddr &rsp_addr, cIpmiMsg &rsp_msg,
+                        int retries = dIpmiDefaultRetries );
 
   SaErrorT ExecuteCmd( const cIpmiAddr &addr, const cIpmiMsg &msg,
                        cIpmiMsg &rsp_msg,
                        int retries = dIpmiDefaultRetries );
 
   int GetMaxOutstanding() { return m_max_outstanding; }
-  bool SetMaxOutstanding( int max )
+  virtual bool SetMaxOutstanding( int max )
   {
     if ( max < 1 || max > 32 )
          return false;
@@ -215,6 +215,14 @@ public:
 
     return true;
   }
+
+  virtual void SetTimeout( unsigned int timeout )
+  {
+    m_timeout = timeout;
+  }
+
+  // time of the last response, event or pong
+  cTime LastReceiveTimestamp() const { return m_last_receive_timestamp; }
 };
 
 
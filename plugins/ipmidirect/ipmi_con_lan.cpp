@@ -707,7 +707,7 @@ cIpmiConLan::Reconnect()
   GList *list = m_queue;
   m_queue = 0;
 
-  while( true )
+  while( !m_exit )
      {
        // send a ping
        SendPing();
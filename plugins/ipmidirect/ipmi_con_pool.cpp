@@ -0,0 +1,402 @@
+/*
+ * ipmi_con_pool.cpp
+ *
+ * spread IPMI commands over several sessions to the same BMC
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * A single RMCP session never has more than m_max_outstanding
+ * (at most 32) requests in flight, so discovery of a shelf with many
+ * MCs is bound by the round trip time. The pool opens several
+ * sessions to the same BMC or shelf manager and multiplies that
+ * window by the number of sessions.
+ */
+
+#include <assert.h>
+
+#include "ipmi_con_pool.h"
+
+
+static int
+DiffMs( const cTime &t1, const cTime &t0 )
+{
+  return   ( t1.m_time.tv_sec - t0.m_time.tv_sec ) * 1000
+         + ( t1.m_time.tv_usec - t0.m_time.tv_usec ) / 1000;
+}
+
+
+cIpmiConPool::cIpmiConPool( unsigned int timeout, int log_level )
+  : cIpmiCon( timeout, log_level ), m_num_sessions( 0 ), m_next( 0 )
+{
+  for( int i = 0; i < dIpmiConPoolMaxSessions; i++ )
+       m_sessions[i].m_con = 0;
+}
+
+
+cIpmiConPool::~cIpmiConPool()
+{
+  Close();
+
+  for( int i = 0; i < m_num_sessions; i++ )
+     {
+       delete m_sessions[i].m_con;
+       m_sessions[i].m_con = 0;
+     }
+}
+
+
+bool
+cIpmiConPool::AddSession( cIpmiCon *con )
+{
+  if ( IsOpen() || m_num_sessions >= dIpmiConPoolMaxSessions )
+       return false;
+
+  con->SetTimeout( m_timeout );
+  m_sessions[m_num_sessions++].m_con = con;
+
+  return true;
+}
+
+
+bool
+cIpmiConPool::Open()
+{
+  if ( IsOpen() )
+       return true;
+
+  int num = 0;
+
+  for( int i = 0; i < m_num_sessions; i++ )
+     {
+       cSession &s = m_sessions[i];
+
+       s.m_health = cIpmiConPoolHealth();
+       s.m_busy_since = cTime::Now();
+
+       if ( s.m_con->Open() )
+          {
+            num++;
+            continue;
+          }
+
+       stdlog << "cannot open IPMI session " << i << " !\n";
+       SetDown( i, "open fails" );
+     }
+
+  stdlog << num << " of " << m_num_sessions << " IPMI sessions open.\n";
+
+  if ( num == 0 )
+       return false;
+
+  m_is_open = true;
+
+  return true;
+}
+
+
+void
+cIpmiConPool::Close()
+{
+  if ( !IsOpen() )
+       return;
+
+  LogHealth();
+
+  for( int i = 0; i < m_num_sessions; i++ )
+       if ( m_sessions[i].m_con->IsOpen() )
+            m_sessions[i].m_con->Close();
+
+  m_is_open = false;
+}
+
+
+// m_lock must be locked
+void
+cIpmiConPool::SetDown( int idx, const char *reason )
+{
+  cSession &s = m_sessions[idx];
+
+  if ( s.m_health.m_up )
+     {
+       stdlog << "IPMI session " << idx << " out of service: " << reason << ".\n";
+       s.m_health.m_down_count++;
+     }
+
+  s.m_health.m_up = false;
+  s.m_retry = cTime::Now();
+  s.m_retry += dIpmiConPoolRetryInterval;
+}
+
+
+// m_lock must be locked.
+// Returns the time in ms a session with commands
+// in flight is waiting for the next one done.
+int
+cIpmiConPool::Waiting( int idx, const cTime &now )
+{
+  cSession &s = m_sessions[idx];
+
+  if ( s.m_health.m_pending == 0 )
+       return 0;
+
+  return DiffMs( now, s.m_busy_since );
+}
+
+
+// m_lock must be locked
+void
+cIpmiConPool::CheckStalled( const cTime &now )
+{
+  // all retries of a command and a check connection
+  // are over without any command done
+  int max = m_timeout * ( dIpmiDefaultRetries + 2 );
+
+  for( int i = 0; i < m_num_sessions; i++ )
+       if ( m_sessions[i].m_health.m_up && Waiting( i, now ) > max )
+            SetDown( i, "stalled" );
+}
+
+
+int
+cIpmiConPool::Select( bool &open )
+{
+  cThreadLockAuto al( m_lock );
+
+  cTime now = cTime::Now();
+  int best = -1;
+  bool best_late = false;
+
+  CheckStalled( now );
+
+  for( int i = 0; i < m_num_sessions; i++ )
+     {
+       int idx = ( m_next + i ) % m_num_sessions;
+       cSession &s = m_sessions[idx];
+
+       if ( !s.m_health.m_up )
+          {
+            // probe a session out of service from time to time,
+            // but not while it still hangs in old commands
+            if ( s.m_health.m_pending == 0 && now >= s.m_retry )
+               {
+                 s.m_retry = now;
+                 s.m_retry += dIpmiConPoolRetryInterval;
+                 best = idx;
+                 break;
+               }
+
+            continue;
+          }
+
+       // avoid sessions with a response overdue
+       bool late = Waiting( idx, now ) > (int)m_timeout;
+
+       if (    best == -1
+            || ( best_late && !late )
+            || (    best_late == late
+                 && s.m_health.m_pending < m_sessions[best].m_health.m_pending ) )
+          {
+            best = idx;
+            best_late = late;
+          }
+     }
+
+  if ( best == -1 )
+       return -1;
+
+  cSession &s = m_sessions[best];
+
+  if ( s.m_health.m_pending++ == 0 )
+       s.m_busy_since = now;
+
+  m_next = ( best + 1 ) % m_num_sessions;
+  open = s.m_con->IsOpen();
+
+  return best;
+}
+
+
+bool
+cIpmiConPool::Done( int idx, SaErrorT rv, const cTime &start )
+{
+  cThreadLockAuto al( m_lock );
+
+  cSession &s = m_sessions[idx];
+  cIpmiConPoolHealth &h = s.m_health;
+  cTime now = cTime::Now();
+
+  assert( h.m_pending > 0 );
+  h.m_pending--;
+  s.m_busy_since = now;
+
+  unsigned int latency = DiffMs( now, start );
+  h.m_latency = h.m_cmds ? ( h.m_latency * 7 + latency ) / 8 : latency;
+  h.m_cmds++;
+
+  if ( rv != SA_OK )
+     {
+       if ( rv == SA_ERR_HPI_TIMEOUT )
+            h.m_timeouts++;
+       else
+            h.m_errors++;
+
+       // a MC not responding is no problem of the session
+       // as long as there are other responses.
+       if (    !s.m_con->IsOpen()
+            || DiffMs( now, s.m_con->LastReceiveTimestamp() ) >= (int)m_timeout )
+          {
+            if ( ++h.m_failures >= dIpmiConPoolMaxFailures || !h.m_up )
+                 SetDown( idx, "no response" );
+
+            return h.m_up;
+          }
+     }
+
+  h.m_failures = 0;
+
+  if ( !h.m_up )
+     {
+       stdlog << "IPMI session " << idx << " back in service.\n";
+       h.m_up = true;
+     }
+
+  return true;
+}
+
+
+SaErrorT
+cIpmiConPool::Cmd( const cIpmiAddr &addr, const cIpmiMsg &msg,
+                   cIpmiAddr &rsp_addr, cIpmiMsg &rsp_msg,
+                   int retries )
+{
+  SaErrorT rv = SA_ERR_HPI_TIMEOUT;
+
+  // try the next session if the used one goes out of service
+  for( int i = 0; i < m_num_sessions; i++ )
+     {
+       bool open = false;
+       int idx = Select( open );
+
+       if ( idx < 0 )
+            break;
+
+       cIpmiCon *con = m_sessions[idx].m_con;
+       cTime start = cTime::Now();
+
+       if ( !open && !con->Open() )
+          {
+            Done( idx, SA_ERR_HPI_NO_RESPONSE, start );
+            continue;
+          }
+
+       rv = con->Cmd( addr, msg, rsp_addr, rsp_msg, retries );
+
+       if ( Done( idx, rv, start ) || rv == SA_OK )
+            return rv;
+     }
+
+  return rv;
+}
+
+
+bool
+cIpmiConPool::SetMaxOutstanding( int max )
+{
+  if ( !cIpmiCon::SetMaxOutstanding( max ) )
+       return false;
+
+  for( int i = 0; i < m_num_sessions; i++ )
+       m_sessions[i].m_con->SetMaxOutstanding( max );
+
+  stdlog << "max number of outstanding = " << max * m_num_sessions
+         << " in " << m_num_sessions << " sessions.\n";
+
+  return true;
+}
+
+
+void
+cIpmiConPool::SetTimeout( unsigned int timeout )
+{
+  m_timeout = timeout;
+
+  for( int i = 0; i < m_num_sessions; i++ )
+       m_sessions[i].m_con->SetTimeout( timeout );
+}
+
+
+bool
+cIpmiConPool::GetHealth( int idx, cIpmiConPoolHealth &health )
+{
+  if ( idx < 0 || idx >= m_num_sessions )
+       return false;
+
+  cThreadLockAuto al( m_lock );
+
+  CheckStalled( cTime::Now() );
+  health = m_sessions[idx].m_health;
+
+  return true;
+}
+
+
+void
+cIpmiConPool::LogHealth()
+{
+  cThreadLockAuto al( m_lock );
+
+  for( int i = 0; i < m_num_sessions; i++ )
+     {
+       cIpmiConPoolHealth &h = m_sessions[i].m_health;
+
+       stdlog << "IPMI session " << i << ": "
+              << ( h.m_up ? "up" : "down" )
+              << ", cmds " << h.m_cmds
+              << ", timeouts " << h.m_timeouts
+              << ", errors " << h.m_errors
+              << ", out of service " << h.m_down_count
+              << ", latency " << h.m_latency << " ms.\n";
+     }
+}
+
+
+// the sessions do the work
+int
+cIpmiConPool::IfGetMaxSeq()
+{
+  return dMaxSeq;
+}
+
+
+int
+cIpmiConPool::IfOpen()
+{
+  return -1;
+}
+
+
+SaErrorT
+cIpmiConPool::IfSendCmd( cIpmiRequest * /*r*/ )
+{
+  return SA_ERR_HPI_INTERNAL_ERROR;
+}
+
+
+void
+cIpmiConPool::IfReadResponse()
+{
+}
+
+
+void
+cIpmiConPool::HandleAsyncEvent( const cIpmiAddr & /*addr*/, const cIpmiMsg & /*msg*/ )
+{
+  // events are passed on by the sessions
+}
@@ -0,0 +1,110 @@
+/*
+ * ipmi_con_pool.h
+ *
+ * spread IPMI commands over several sessions to the same BMC
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#ifndef dIpmiConPool_h
+#define dIpmiConPool_h
+
+
+#ifndef dIpmiCon_h
+#include "ipmi_con.h"
+#endif
+
+
+// most BMCs support 4 or more sessions
+#define dIpmiConPoolMaxSessions 16
+
+// consecutive failures before a session is taken out of service
+#define dIpmiConPoolMaxFailures 3
+
+// ms before a session out of service is tried again
+#define dIpmiConPoolRetryInterval 10000
+
+
+// health of one session
+class cIpmiConPoolHealth
+{
+public:
+  bool         m_up;
+  int          m_pending;     // commands in flight
+  unsigned int m_cmds;        // commands done
+  unsigned int m_errors;      // commands with error
+  unsigned int m_timeouts;    // commands with timeout
+  unsigned int m_failures;    // consecutive failures
+  unsigned int m_down_count;  // times taken out of service
+  unsigned int m_latency;     // average latency in ms
+
+  cIpmiConPoolHealth()
+    : m_up( true ), m_pending( 0 ), m_cmds( 0 ), m_errors( 0 ),
+      m_timeouts( 0 ), m_failures( 0 ), m_down_count( 0 ), m_latency( 0 ) {}
+};
+
+
+// A connection made of several sessions, each one with its own
+// reader thread and sequence window. Commands go to the session
+// with the fewest commands in flight. Sessions that stop responding
+// are taken out of service and tried again later.
+class cIpmiConPool : public cIpmiCon
+{
+  class cSession
+  {
+  public:
+    cIpmiCon          *m_con;
+    cIpmiConPoolHealth m_health;
+    cTime              m_busy_since; // last completion or start of work
+    cTime              m_retry;      // next try while down
+  };
+
+  cThreadLock  m_lock;
+  cSession     m_sessions[dIpmiConPoolMaxSessions];
+  int          m_num_sessions;
+  int          m_next; // round robin start
+
+  int  Select( bool &open );
+  bool Done( int idx, SaErrorT rv, const cTime &start );
+  void SetDown( int idx, const char *reason );
+  int  Waiting( int idx, const cTime &now );
+  void CheckStalled( const cTime &now );
+
+protected:
+  virtual int  IfGetMaxSeq();
+  virtual int  IfOpen();
+  virtual SaErrorT IfSendCmd( cIpmiRequest *r );
+  virtual void IfReadResponse();
+  virtual void HandleAsyncEvent( const cIpmiAddr &addr, const cIpmiMsg &msg );
+
+public:
+  cIpmiConPool( unsigned int timeout, int log_level );
+  virtual ~cIpmiConPool();
+
+  // the pool takes ownership of con
+  bool AddSession( cIpmiCon *con );
+  int  NumSessions() const { return m_num_sessions; }
+
+  bool GetHealth( int idx, cIpmiConPoolHealth &health );
+  void LogHealth();
+
+  virtual bool Open();
+  virtual void Close();
+  virtual SaErrorT Cmd( const cIpmiAddr &addr, const cIpmiMsg &msg,
+                        cIpmiAddr &rsp_addr, cIpmiMsg &rsp_msg,
+                        int retries = dIpmiDefaultRetries );
+
+  // the limits apply to each session
+  virtual bool SetMaxOutstanding( int max );
+  virtual void SetTimeout( unsigned int timeout );
+};
+
+
+#endif
@@ -49,9 +49,10 @@ public:
 cIpmiMcThread::cIpmiMcThread( cIpmiDomain *domain,
                               unsigned char addr,
                               unsigned int properties )
-  : m_domain( domain ), m_addr( addr ), m_chan( 0 ),
+  : cIpmiStrand( &domain->m_mc_scheduler ),
+    m_domain( domain ), m_addr( addr ), m_chan( 0 ),
     m_mc( 0 ),
-    m_properties( properties ),
+    m_properties( properties ), m_started( false ),
     m_exit( false ), m_tasks( 0 ),
     m_sel( 0 ), m_events( 0 )
 {
@@ -60,6 +61,7 @@ cIpmiMcThread::cIpmiMcThread( cIpmiDomain *domain,
 
 cIpmiMcThread::~cIpmiMcThread()
 {
+  Detach();
   ClearMcTaskList();
 }
 
@@ -169,90 +171,100 @@ cIpmiMcThread::ClearMcTaskList()
 }
 
 
-void *
-cIpmiMcThread::Run()
+void
+cIpmiMcThread::Start()
 {
   stdlog << "starting MC thread " << m_addr << ".\n";
 
-  m_domain->m_mc_thread_lock.Lock();
-  m_domain->m_num_mc_threads++;
-  m_domain->m_mc_thread_lock.Unlock();
+  Wakeup();
+}
 
-  if ( m_properties & dIpmiMcThreadInitialDiscover )
-     {
-       if ( m_addr != dIpmiBmcSlaveAddr )
-       {
-           stdlog << "Waiting for BMC discovery (" << m_addr << ").\n";
-           while ( m_domain->m_bmc_discovered == false )
-           {
-               usleep( 100000 );
-           }
-           stdlog << "BMC Discovery done, let's go (" << m_addr << ").\n";
-       }
-       else
-       {
-           stdlog << "BMC Discovery Start\n";
-       }
-                
-       Discover();
-       m_domain->m_initial_discover_lock.Lock();
-       m_domain->m_initial_discover--;
-       m_domain->m_initial_discover_lock.Unlock();
-
-       // clear initial discover flag
-       m_properties &= ~dIpmiMcThreadInitialDiscover;
-
-       if ( m_addr == dIpmiBmcSlaveAddr )
-       {
-           stdlog << "BMC Discovery done\n";
-           m_domain->m_bmc_discovered = true;
-       }
-       else {
-           stdlog << "BMC Discovery (" << m_addr << ", " << m_chan << ") done\n";
-	   if (m_domain->m_initial_discover == 0) 
-		stdlog << "All BMC Discoveries Completed\n";
-       }
-     }
 
-  if (    ( m_mc  && (m_properties & dIpmiMcThreadPollAliveMc ) )
-       || ( !m_mc && (m_properties & dIpmiMcThreadPollDeadMc ) ) )
-       PollAddr( m_mc );
+void
+cIpmiMcThread::Run()
+{
+  if ( m_exit )
+       return;
 
-  // this is a hack, because
-  // of the usleep calls and polling
-  // of event queue and task list.
-  while( !m_exit )
+  if ( !m_started )
      {
-       // handling all events in the event 
-       // in the event queue
-       HandleEvents();
-       usleep( 100000 );
-
-       // check for tasks to do
-       while( m_tasks )
+       if ( m_properties & dIpmiMcThreadInitialDiscover )
           {
-            cTime now = cTime::Now();
+            if ( m_addr != dIpmiBmcSlaveAddr )
+               {
+                 if ( m_domain->m_bmc_discovered == false )
+                    {
+                      // don't hold a worker while waiting
+                      WakeupIn( 100 );
+                      return;
+                    }
 
-	    if ( now < m_tasks->m_timeout )
-		 break;
+                 stdlog << "BMC Discovery done, let's go (" << m_addr << ").\n";
+               }
+            else
+               {
+                 stdlog << "BMC Discovery Start\n";
+               }
 
-	    // timeout
-            cIpmiMcTask *dt = m_tasks;
-            m_tasks = m_tasks->m_next;
+            Discover();
+            m_domain->m_initial_discover_lock.Lock();
+            m_domain->m_initial_discover--;
+            m_domain->m_initial_discover_lock.Unlock();
 
-            (this->*dt->m_task)( dt->m_userdata );
-            delete dt;
+            // clear initial discover flag
+            m_properties &= ~dIpmiMcThreadInitialDiscover;
+
+            if ( m_addr == dIpmiBmcSlaveAddr )
+               {
+                 stdlog << "BMC Discovery done\n";
+                 m_domain->m_bmc_discovered = true;
+               }
+            else {
+                 stdlog << "BMC Discovery (" << m_addr << ", " << m_chan << ") done\n";
+                 if (m_domain->m_initial_discover == 0) 
+                      stdlog << "All BMC Discoveries Completed\n";
+            }
           }
+
+       m_started = true;
+
+       if (    ( m_mc  && (m_properties & dIpmiMcThreadPollAliveMc ) )
+            || ( !m_mc && (m_properties & dIpmiMcThreadPollDeadMc ) ) )
+            PollAddr( m_mc );
+     }
+
+  // handling all events in the event queue
+  HandleEvents();
+
+  // check for tasks to do
+  while( m_tasks && !m_exit )
+     {
+       cTime now = cTime::Now();
+
+       if ( now < m_tasks->m_timeout )
+            break;
+
+       // timeout
+       cIpmiMcTask *dt = m_tasks;
+       m_tasks = m_tasks->m_next;
+
+       (this->*dt->m_task)( dt->m_userdata );
+       delete dt;
      }
 
-  stdlog << "stop MC thread " << m_addr << ".\n";
+  // sleep until the next task is due,
+  // new events wake the MC thread up
+  if ( m_tasks && !m_exit )
+     {
+       cTime now = cTime::Now();
+       unsigned int ms = 0;
 
-  m_domain->m_mc_thread_lock.Lock();
-  assert( m_domain->m_num_mc_threads > 0 );
-  m_domain->m_num_mc_threads--;
-  m_domain->m_mc_thread_lock.Unlock();  
+       if ( now < m_tasks->m_timeout )
+            ms =   ( m_tasks->m_timeout.m_time.tv_sec - now.m_time.tv_sec ) * 1000
+                 + ( m_tasks->m_timeout.m_time.tv_usec - now.m_time.tv_usec + 999 ) / 1000;
 
-  return 0;
+       WakeupIn( ms );
+     }
 }
 
 
@@ -642,6 +654,8 @@ cIpmiMcThread::AddEvent( cIpmiEvent *event )
   m_events_lock.Lock();
   m_events = g_list_append( m_events, event );
   m_events_lock.Unlock();
+
+  Wakeup();
 }
 
 
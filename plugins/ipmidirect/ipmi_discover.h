@@ -17,6 +17,10 @@
 #define dIpmiDiscover_h
 
 
+#ifndef dIpmiScheduler_h
+#include "ipmi_scheduler.h"
+#endif
+
 class cIpmiDomain;
 class cIpmiMcThread;
 class cIpmiMcTask;
@@ -31,7 +35,10 @@ class cIpmiMcTask;
 
 typedef void (cIpmiMcThread::*tIpmiMcTask)( void *userdata );
 
-class cIpmiMcThread : public cThread
+// Discovery, polling and event handling of one IPMB address.
+// Despite the name it has no thread of its own any more:
+// its work is run in order by the domain's MC scheduler.
+class cIpmiMcThread : public cIpmiStrand
 {
 private:
   cIpmiDomain  *m_domain;
@@ -46,16 +53,22 @@ private:
   // properties
   unsigned int m_properties; // dIpmiMcThreadXXXX
 
+  // initial discover and poll done
+  bool m_started;
+
 public:
   cIpmiMc     *Mc()   { return m_mc; }
 
 protected:
-  virtual void *Run();
+  virtual void Run();
 
 public:
   // signal to MC thread to exit
   bool m_exit;
 
+  // schedule the initial discover
+  void Start();
+
   cIpmiMcThread( cIpmiDomain  *domain,
                  unsigned char addr,
                  unsigned int  properties );
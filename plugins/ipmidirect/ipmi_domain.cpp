@@ -41,6 +41,7 @@ cIpmiDomain::cIpmiDomain()
 
   m_did = 0;
   m_own_domain = false;
+  m_mc_workers = dIpmiSchedulerDefaultWorkers;
 
   for( int i = 0; i < 256; i++ )
      {
@@ -305,7 +306,9 @@ cIpmiDomain::Init( cIpmiCon *con )
   // Start all MC threads with the
   // properties found in m_mc_to_check.
   m_initial_discover = 0;
-  m_num_mc_threads   = 0;
+
+  m_mc_scheduler.Start( m_mc_workers );
+  stdlog << "MC tasks run by " << m_mc_scheduler.NumThreads() << " threads.\n";
 
   for( GList *list = GetFruInfoList(); list; list = g_list_next( list ) )
      {
@@ -353,26 +356,12 @@ cIpmiDomain::Cleanup()
        if ( m_mc_thread[i] )
             m_mc_thread[i]->m_exit = true;
 
-  // wait until all threads are finish
-  bool loop = true;
-
-  while( loop )
-     {
-       m_mc_thread_lock.Lock();
-       loop = (bool)m_num_mc_threads;
-       m_mc_thread_lock.Unlock();
+  // wait until running MC tasks are finished
+  m_mc_scheduler.Stop();
 
-       usleep( 100000 );
-     }
-
-  // wait for threads exit
   for( i = 0; i < 256; i++ )
        if ( m_mc_thread[i] )
           {
-            void *rv;
-
-            m_mc_thread[i]->Wait( rv );
-
             delete m_mc_thread[i];
             m_mc_thread[i] = 0;
           }
@@ -496,7 +485,7 @@ cIpmiDomain::CheckTca()
 
   // use atca timeout
   stdlog << "set timeout to " << m_con_atca_timeout << ".\n";
-  m_con->m_timeout = m_con_atca_timeout;
+  m_con->SetTimeout( m_con_atca_timeout );
 
   m_is_tca = true;
 
@@ -101,6 +101,7 @@ public:
 
   unsigned int m_max_outstanding; // 0 => use default
   bool         m_atca_poll_alive_mcs;
+  unsigned int m_mc_workers; // threads running MC tasks
 protected:
   // ipmi connection
   cIpmiCon     *m_con;
@@ -184,8 +185,8 @@ protected:
   cIpmiMcThread *m_mc_thread[256];
 
 public:
-  int           m_num_mc_threads;
-  cThreadLock   m_mc_thread_lock;
+  // runs the tasks of all mc threads
+  cIpmiScheduler m_mc_scheduler;
 
 public:
   // time between mc poll in ms
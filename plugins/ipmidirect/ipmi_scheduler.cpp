@@ -0,0 +1,538 @@
+/*
+ * ipmi_scheduler.cpp
+ *
+ * timer wheel and worker pool for MC tasks
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * Every MC used to have its own thread polling its task list every
+ * 100 ms. Now the tasks of all MCs are run by a small pool of worker
+ * threads. A single timer thread keeps the pending timers in a
+ * hierarchical timer wheel and sleeps until the next one is due.
+ */
+
+
+#include "ipmi_scheduler.h"
+#include <glib.h>
+#include <sys/time.h>
+
+
+#define dIpmiSchedulerNever (~0ULL)
+
+
+class cIpmiSchedulerThread : public cThread
+{
+  cIpmiScheduler *m_scheduler;
+  bool            m_timer;
+
+public:
+  cIpmiSchedulerThread( cIpmiScheduler *scheduler, bool timer )
+    : m_scheduler( scheduler ), m_timer( timer )
+  {}
+
+protected:
+  virtual void *Run()
+  {
+    if ( m_timer )
+         m_scheduler->TimerLoop();
+    else
+         m_scheduler->WorkerLoop();
+
+    return 0;
+  }
+};
+
+
+//////////////////////////////////////////////////
+//                  cIpmiStrand
+//////////////////////////////////////////////////
+
+cIpmiStrand::cIpmiStrand( cIpmiScheduler *scheduler )
+  : m_timer_next( 0 ), m_timer_prev( 0 ), m_expires( 0 ), m_armed( false ),
+    m_level( 0 ), m_slot( 0 ),
+    m_run_next( 0 ), m_queued( false ), m_running( false ), m_rerun( false ),
+    m_detached( false ), m_scheduler( scheduler )
+{
+}
+
+
+cIpmiStrand::~cIpmiStrand()
+{
+  Detach();
+}
+
+
+void
+cIpmiStrand::Wakeup()
+{
+  m_scheduler->Queue( this );
+}
+
+
+void
+cIpmiStrand::WakeupIn( unsigned int ms )
+{
+  m_scheduler->Arm( this, ms );
+}
+
+
+void
+cIpmiStrand::Detach()
+{
+  m_scheduler->Detach( this );
+}
+
+
+//////////////////////////////////////////////////
+//                  cIpmiScheduler
+//////////////////////////////////////////////////
+
+cIpmiScheduler::cIpmiScheduler()
+  : m_tick( 0 ), m_next_wake( dIpmiSchedulerNever ), m_start( 0 ), m_num_timers( 0 ),
+    m_run_first( 0 ), m_run_last( 0 ), m_detach_waiters( 0 ),
+    m_stop( true ), m_timer_thread( 0 ), m_num_workers( 0 )
+{
+  for( int l = 0; l < dIpmiWheelLevels; l++ )
+       for( int i = 0; i < dIpmiWheelSize; i++ )
+            m_wheel[l][i] = 0;
+
+  for( int i = 0; i < dIpmiSchedulerMaxWorkers; i++ )
+       m_workers[i] = 0;
+}
+
+
+cIpmiScheduler::~cIpmiScheduler()
+{
+  Stop();
+}
+
+
+unsigned long long
+cIpmiScheduler::Now() const
+{
+#if GLIB_CHECK_VERSION (2, 28, 0)
+  return g_get_monotonic_time() / 1000;
+#else
+  struct timeval tv;
+  gettimeofday( &tv, 0 );
+
+  return (unsigned long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
+
+unsigned long long
+cIpmiScheduler::NowTick() const
+{
+  return ( Now() - m_start ) / dIpmiSchedulerTick;
+}
+
+
+bool
+cIpmiScheduler::Start( unsigned int workers )
+{
+  if ( !m_stop )
+       return false;
+
+  if ( workers == 0 )
+       workers = 1;
+
+  if ( workers > dIpmiSchedulerMaxWorkers )
+       workers = dIpmiSchedulerMaxWorkers;
+
+  m_start     = Now();
+  m_tick      = 0;
+  m_next_wake = dIpmiSchedulerNever;
+  m_stop      = false;
+
+  m_timer_thread = new cIpmiSchedulerThread( this, true );
+  m_timer_thread->Start();
+
+  for( m_num_workers = 0; m_num_workers < workers; m_num_workers++ )
+     {
+       m_workers[m_num_workers] = new cIpmiSchedulerThread( this, false );
+       m_workers[m_num_workers]->Start();
+     }
+
+  return true;
+}
+
+
+void
+cIpmiScheduler::Stop()
+{
+  m_timer.Lock();
+  m_run.Lock();
+
+  bool running = !m_stop;
+  m_stop = true;
+
+  m_run.Broadcast();
+  m_run.Unlock();
+  m_timer.Signal();
+  m_timer.Unlock();
+
+  if ( !running )
+       return;
+
+  void *rv;
+
+  m_timer_thread->Wait( rv );
+  delete m_timer_thread;
+  m_timer_thread = 0;
+
+  for( unsigned int i = 0; i < m_num_workers; i++ )
+     {
+       m_workers[i]->Wait( rv );
+       delete m_workers[i];
+       m_workers[i] = 0;
+     }
+
+  m_num_workers = 0;
+
+  // drop pending timers and runs
+  m_timer.Lock();
+
+  for( int l = 0; l < dIpmiWheelLevels; l++ )
+       for( int i = 0; i < dIpmiWheelSize; i++ )
+            while( m_wheel[l][i] )
+                 TimerUnlink( m_wheel[l][i] );
+
+  m_timer.Unlock();
+
+  m_run.Lock();
+
+  while( m_run_first )
+     {
+       cIpmiStrand *s = m_run_first;
+       m_run_first = s->m_run_next;
+       s->m_queued = false;
+       s->m_run_next = 0;
+     }
+
+  m_run_last = 0;
+  m_run.Unlock();
+}
+
+
+unsigned int
+cIpmiScheduler::NumThreads() const
+{
+  return m_num_workers + ( m_timer_thread ? 1 : 0 );
+}
+
+
+// m_timer must be locked
+void
+cIpmiScheduler::TimerInsert( cIpmiStrand *s )
+{
+  const unsigned long long max = 1ULL << ( dIpmiWheelBits * dIpmiWheelLevels );
+
+  if ( s->m_expires <= m_tick )
+       s->m_expires = m_tick + 1;
+
+  unsigned long long delta = s->m_expires - m_tick;
+
+  if ( delta >= max )
+     {
+       delta = max - 1;
+       s->m_expires = m_tick + delta;
+     }
+
+  int level = 0;
+
+  while( delta >= ( 1ULL << ( dIpmiWheelBits * ( level + 1 ) ) ) )
+       level++;
+
+  int idx = ( s->m_expires >> ( dIpmiWheelBits * level ) ) & dIpmiWheelMask;
+  cIpmiStrand *&head = m_wheel[level][idx];
+
+  s->m_level = level;
+  s->m_slot  = idx;
+
+  s->m_timer_prev = 0;
+  s->m_timer_next = head;
+
+  if ( head )
+       head->m_timer_prev = s;
+
+  head = s;
+  s->m_armed = true;
+  m_num_timers++;
+}
+
+
+// m_timer must be locked
+void
+cIpmiScheduler::TimerUnlink( cIpmiStrand *s )
+{
+  if ( !s->m_armed )
+       return;
+
+  if ( s->m_timer_next )
+       s->m_timer_next->m_timer_prev = s->m_timer_prev;
+
+  if ( s->m_timer_prev )
+       s->m_timer_prev->m_timer_next = s->m_timer_next;
+  else
+       m_wheel[s->m_level][s->m_slot] = s->m_timer_next;
+
+  s->m_timer_next = 0;
+  s->m_timer_prev = 0;
+  s->m_armed = false;
+  m_num_timers--;
+}
+
+
+// move the timers of the current slot of level one level down
+void
+cIpmiScheduler::Cascade( int level )
+{
+  int idx = ( m_tick >> ( dIpmiWheelBits * level ) ) & dIpmiWheelMask;
+  cIpmiStrand *s = m_wheel[level][idx];
+
+  m_wheel[level][idx] = 0;
+
+  while( s )
+     {
+       cIpmiStrand *next = s->m_timer_next;
+
+       m_num_timers--;
+       TimerInsert( s );
+
+       s = next;
+     }
+}
+
+
+// m_timer must be locked
+void
+cIpmiScheduler::Advance( unsigned long long tick )
+{
+  while( m_tick < tick )
+     {
+       m_tick++;
+
+       for( int l = 1; l < dIpmiWheelLevels; l++ )
+          {
+            if ( m_tick & ( ( 1ULL << ( dIpmiWheelBits * l ) ) - 1 ) )
+                 break;
+
+            Cascade( l );
+          }
+
+       cIpmiStrand *&head = m_wheel[0][m_tick & dIpmiWheelMask];
+
+       while( head )
+          {
+            cIpmiStrand *s = head;
+
+            TimerUnlink( s );
+            Queue( s );
+          }
+     }
+}
+
+
+// m_timer must be locked
+unsigned long long
+cIpmiScheduler::NextExpiry() const
+{
+  if ( m_num_timers == 0 )
+       return dIpmiSchedulerNever;
+
+  // timers of higher levels are not due before the next cascade
+  unsigned long long cascade = ( m_tick | dIpmiWheelMask ) + 1;
+
+  for( unsigned long long t = m_tick + 1; t < cascade; t++ )
+       if ( m_wheel[0][t & dIpmiWheelMask] )
+            return t;
+
+  return cascade;
+}
+
+
+void
+cIpmiScheduler::Arm( cIpmiStrand *s, unsigned int ms )
+{
+  cThreadLockAuto al( m_timer );
+
+  if ( s->m_detached || m_stop )
+       return;
+
+  TimerUnlink( s );
+
+  // round up, a timer never fires early
+  s->m_expires = ( Now() - m_start + ms + dIpmiSchedulerTick - 1 ) / dIpmiSchedulerTick;
+  TimerInsert( s );
+
+  if ( s->m_expires < m_next_wake )
+       m_timer.Signal();
+}
+
+
+void
+cIpmiScheduler::Queue( cIpmiStrand *s )
+{
+  cThreadLockAuto al( m_run );
+
+  if ( s->m_detached || m_stop )
+       return;
+
+  if ( s->m_running )
+     {
+       // run again when done
+       s->m_rerun = true;
+       return;
+     }
+
+  if ( s->m_queued )
+       return;
+
+  s->m_queued = true;
+  s->m_run_next = 0;
+
+  if ( m_run_last )
+       m_run_last->m_run_next = s;
+  else
+       m_run_first = s;
+
+  m_run_last = s;
+
+  m_run.Signal();
+}
+
+
+void
+cIpmiScheduler::Detach( cIpmiStrand *s )
+{
+  // no new timers or runs from now on
+  m_timer.Lock();
+  m_run.Lock();
+  s->m_detached = true;
+  m_run.Unlock();
+  TimerUnlink( s );
+  m_timer.Unlock();
+
+  m_run.Lock();
+
+  if ( s->m_queued )
+     {
+       cIpmiStrand *prev = 0;
+
+       for( cIpmiStrand *c = m_run_first; c; prev = c, c = c->m_run_next )
+            if ( c == s )
+               {
+                 if ( prev )
+                      prev->m_run_next = s->m_run_next;
+                 else
+                      m_run_first = s->m_run_next;
+
+                 if ( m_run_last == s )
+                      m_run_last = prev;
+
+                 break;
+               }
+
+       s->m_queued = false;
+       s->m_run_next = 0;
+     }
+
+  s->m_rerun = false;
+
+  while( s->m_running )
+     {
+       m_detach_waiters++;
+       m_run.Wait();
+       m_detach_waiters--;
+     }
+
+  m_run.Unlock();
+}
+
+
+void
+cIpmiScheduler::TimerLoop()
+{
+  m_timer.Lock();
+
+  while( !m_stop )
+     {
+       Advance( NowTick() );
+
+       m_next_wake = NextExpiry();
+
+       if ( m_next_wake == dIpmiSchedulerNever )
+          {
+            m_timer.Wait();
+            continue;
+          }
+
+       unsigned long long now = Now() - m_start;
+       unsigned long long due = m_next_wake * dIpmiSchedulerTick;
+
+       if ( due > now )
+            m_timer.TimedWait( (unsigned int)( due - now ) );
+     }
+
+  m_timer.Unlock();
+}
+
+
+void
+cIpmiScheduler::WorkerLoop()
+{
+  m_run.Lock();
+
+  while( true )
+     {
+       while( !m_stop && !m_run_first )
+            m_run.Wait();
+
+       if ( m_stop )
+            break;
+
+       cIpmiStrand *s = m_run_first;
+       m_run_first = s->m_run_next;
+
+       if ( !m_run_first )
+            m_run_last = 0;
+
+       s->m_run_next = 0;
+       s->m_queued   = false;
+       s->m_running  = true;
+
+       m_run.Unlock();
+
+       s->Run();
+
+       m_run.Lock();
+
+       s->m_running = false;
+
+       if ( s->m_rerun )
+          {
+            s->m_rerun = false;
+            s->m_queued = true;
+
+            if ( m_run_last )
+                 m_run_last->m_run_next = s;
+            else
+                 m_run_first = s;
+
+            m_run_last = s;
+          }
+
+       if ( m_detach_waiters )
+            m_run.Broadcast();
+     }
+
+  m_run.Unlock();
+}
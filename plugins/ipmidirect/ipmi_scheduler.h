@@ -0,0 +1,146 @@
+/*
+ * ipmi_scheduler.h
+ *
+ * timer wheel and worker pool for MC tasks
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#ifndef dIpmiScheduler_h
+#define dIpmiScheduler_h
+
+
+#ifndef dThread_h
+#include "thread.h"
+#endif
+
+
+// timer resolution in ms
+#define dIpmiSchedulerTick     10
+
+// hierarchical timer wheel: 4 levels of 64 slots.
+// Level 0 covers 640 ms, level 3 about 46 hours.
+#define dIpmiWheelBits         6
+#define dIpmiWheelSize         (1 << dIpmiWheelBits)
+#define dIpmiWheelMask         (dIpmiWheelSize - 1)
+#define dIpmiWheelLevels       4
+
+#define dIpmiSchedulerDefaultWorkers 8
+#define dIpmiSchedulerMaxWorkers     64
+
+
+class cIpmiScheduler;
+class cIpmiSchedulerThread;
+
+
+// A sequence of work run by the worker pool.
+// Run() is never called concurrently for the same strand,
+// so the work of a strand is done in order.
+// Derived classes must call Detach() in their destructor.
+class cIpmiStrand
+{
+  friend class cIpmiScheduler;
+
+  // timer wheel, protected by cIpmiScheduler::m_timer
+  cIpmiStrand *m_timer_next;
+  cIpmiStrand *m_timer_prev;
+  unsigned long long m_expires; // tick
+  bool         m_armed;
+  int          m_level;
+  int          m_slot;
+
+  // run queue, protected by cIpmiScheduler::m_run
+  cIpmiStrand *m_run_next;
+  bool         m_queued;
+  bool         m_running;
+  bool         m_rerun;
+
+  // protected by both locks
+  bool         m_detached;
+
+protected:
+  cIpmiScheduler *m_scheduler;
+
+  // called by a worker thread
+  virtual void Run() = 0;
+
+public:
+  cIpmiStrand( cIpmiScheduler *scheduler );
+  virtual ~cIpmiStrand();
+
+  // run as soon as possible
+  void Wakeup();
+
+  // run in ms, replaces a pending timer of the strand
+  void WakeupIn( unsigned int ms );
+
+  // cancel pending runs and wait for a running one to finish.
+  // Must not be called by the strand itself.
+  void Detach();
+};
+
+
+class cIpmiScheduler
+{
+  friend class cIpmiStrand;
+  friend class cIpmiSchedulerThread;
+
+  // timer wheel
+  cThreadCond  m_timer;
+  cIpmiStrand *m_wheel[dIpmiWheelLevels][dIpmiWheelSize];
+  unsigned long long m_tick;      // last processed tick
+  unsigned long long m_next_wake; // tick the timer thread sleeps until
+  unsigned long long m_start;     // ms
+  unsigned int m_num_timers;
+
+  // run queue
+  cThreadCond  m_run;
+  cIpmiStrand *m_run_first;
+  cIpmiStrand *m_run_last;
+  int          m_detach_waiters;
+
+  bool         m_stop;
+
+  cIpmiSchedulerThread *m_timer_thread;
+  cIpmiSchedulerThread *m_workers[dIpmiSchedulerMaxWorkers];
+  unsigned int m_num_workers;
+
+  unsigned long long Now() const;
+  unsigned long long NowTick() const;
+
+  void TimerInsert( cIpmiStrand *s );
+  void TimerUnlink( cIpmiStrand *s );
+  void Cascade( int level );
+  void Advance( unsigned long long tick );
+  unsigned long long NextExpiry() const;
+
+  void Arm( cIpmiStrand *s, unsigned int ms );
+  void Queue( cIpmiStrand *s );
+  void Detach( cIpmiStrand *s );
+
+  void TimerLoop();
+  void WorkerLoop();
+
+public:
+  cIpmiScheduler();
+  ~cIpmiScheduler();
+
+  bool Start( unsigned int workers = dIpmiSchedulerDefaultWorkers );
+
+  // stop all threads. Running strands are finished,
+  // pending runs and timers are dropped.
+  void Stop();
+
+  // number of threads used by the scheduler
+  unsigned int NumThreads() const;
+};
+
+
+#endif
@@ -24,6 +24,7 @@
 
 
 #include "ipmi_sensor_factors.h"
+#include "thread.h"
 #include <math.h>
 
 
@@ -76,8 +77,116 @@ IpmiLinearizationToString( tIpmiLinearization val )
 }
 
 
+// Readings of a sensor are converted from an 8 bit raw value,
+// so all 256 results are computed once when the SDR is read.
+// Sensors of a kind usually share their factors and the table.
+class cIpmiSensorFactorTable
+{
+public:
+  cIpmiSensorFactorTable *m_next;
+  int                     m_ref_count;
+
+  tIpmiAnalogeDataFormat  m_analog_data_format;
+  tIpmiLinearization      m_linearization;
+  int                     m_m;
+  int                     m_b;
+  int                     m_r_exp;
+  int                     m_b_exp;
+
+  double                  m_value[256];
+  double                  m_hysteresis[256];
+
+  bool Match( const cIpmiSensorFactors &sf ) const
+  {
+    return    m_m     == sf.M()
+           && m_b     == sf.B()
+           && m_r_exp == sf.RExp()
+           && m_b_exp == sf.BExp()
+           && m_linearization      == sf.Linearization()
+           && m_analog_data_format == sf.AnalogDataFormat();
+  }
+};
+
+
+static cThreadLock             factor_table_lock;
+static cIpmiSensorFactorTable *factor_tables = 0;
+
+
+static cIpmiSensorFactorTable *
+FactorTableGet( const cIpmiSensorFactors &sf )
+{
+  cThreadLockAuto al( factor_table_lock );
+
+  for( cIpmiSensorFactorTable *t = factor_tables; t; t = t->m_next )
+       if ( t->Match( sf ) )
+          {
+            t->m_ref_count++;
+            return t;
+          }
+
+  cIpmiSensorFactorTable *t = new cIpmiSensorFactorTable;
+
+  for( unsigned int i = 0; i < 256; i++ )
+       if (    !sf.Calculate( i, t->m_value[i], false )
+            || !sf.Calculate( i, t->m_hysteresis[i], true ) )
+          {
+            // not an analog sensor
+            delete t;
+            return 0;
+          }
+
+  t->m_analog_data_format = sf.AnalogDataFormat();
+  t->m_linearization      = sf.Linearization();
+  t->m_m                  = sf.M();
+  t->m_b                  = sf.B();
+  t->m_r_exp              = sf.RExp();
+  t->m_b_exp              = sf.BExp();
+  t->m_ref_count          = 1;
+  t->m_next               = factor_tables;
+  factor_tables           = t;
+
+  return t;
+}
+
+
+static void
+FactorTableRelease( cIpmiSensorFactorTable *table )
+{
+  if ( !table )
+       return;
+
+  cThreadLockAuto al( factor_table_lock );
+
+  if ( --table->m_ref_count > 0 )
+       return;
+
+  for( cIpmiSensorFactorTable **t = &factor_tables; *t; t = &(*t)->m_next )
+       if ( *t == table )
+          {
+            *t = table->m_next;
+            break;
+          }
+
+  delete table;
+}
+
+
+static cIpmiSensorFactorTable *
+FactorTableRef( cIpmiSensorFactorTable *table )
+{
+  if ( table )
+     {
+       cThreadLockAuto al( factor_table_lock );
+       table->m_ref_count++;
+     }
+
+  return table;
+}
+
+
 cIpmiSensorFactors::cIpmiSensorFactors()
-  : m_analog_data_format( eIpmiAnalogDataFormatUnsigned ),
+  : m_table( 0 ),
+    m_analog_data_format( eIpmiAnalogDataFormatUnsigned ),
     m_linearization( eIpmiLinearizationLinear ),
     m_is_non_linear( false ),
     m_m( 0 ),
@@ -86,13 +195,47 @@ cIpmiSensorFactors::cIpmiSensorFactors()
     m_r_exp( 0 ),
     m_accuracy_exp( 0 ),
     m_accuracy( 0 ),
-    m_b_exp( 0 )
+    m_b_exp( 0 ),
+    m_accuracy_factor( 0.0 )
+{
+}
+
+
+cIpmiSensorFactors::cIpmiSensorFactors( const cIpmiSensorFactors &sf )
+  : m_table( 0 )
 {
+  *this = sf;
 }
 
 
 cIpmiSensorFactors::~cIpmiSensorFactors()
 {
+  FactorTableRelease( m_table );
+}
+
+
+cIpmiSensorFactors &
+cIpmiSensorFactors::operator=( const cIpmiSensorFactors &sf )
+{
+  if ( this == &sf )
+       return *this;
+
+  FactorTableRelease( m_table );
+  m_table = FactorTableRef( sf.m_table );
+
+  m_analog_data_format = sf.m_analog_data_format;
+  m_linearization      = sf.m_linearization;
+  m_is_non_linear      = sf.m_is_non_linear;
+  m_m                  = sf.m_m;
+  m_tolerance          = sf.m_tolerance;
+  m_b                  = sf.m_b;
+  m_r_exp              = sf.m_r_exp;
+  m_accuracy_exp       = sf.m_accuracy_exp;
+  m_accuracy           = sf.m_accuracy;
+  m_b_exp              = sf.m_b_exp;
+  m_accuracy_factor    = sf.m_accuracy_factor;
+
+  return *this;
 }
 
 
@@ -120,6 +263,9 @@ cIpmiSensorFactors::GetDataFromSdr( const cIpmiSdr *sdr )
   else
       m_is_non_linear = true;
 
+  FactorTableRelease( m_table );
+  m_table = FactorTableGet( *this );
+
   return true;
 }
 
@@ -250,6 +396,23 @@ bool
 cIpmiSensorFactors::ConvertFromRaw( unsigned int val,
                                     double      &result,
                                     bool        is_hysteresis) const
+{
+  // the factors may have been changed after the table was made
+  if ( m_table && m_table->Match( *this ) )
+     {
+       val &= 0xff;
+       result = is_hysteresis ? m_table->m_hysteresis[val] : m_table->m_value[val];
+       return true;
+     }
+
+  return Calculate( val, result, is_hysteresis );
+}
+
+
+bool
+cIpmiSensorFactors::Calculate( unsigned int val,
+                               double      &result,
+                               bool        is_hysteresis) const
 {
   double m, b, b_exp, r_exp, fval;
   linearizer c_func;
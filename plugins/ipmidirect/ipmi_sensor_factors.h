@@ -67,12 +67,22 @@ enum tIpmiLinearization
 const char *IpmiLinearizationToString( tIpmiLinearization val );
 
 
+// raw value to reading lookup table,
+// shared by all sensor factors with the same conversion parameters
+class cIpmiSensorFactorTable;
+
+
 class cIpmiSensorFactors
 {
+  cIpmiSensorFactorTable *m_table;
+
 public:
   cIpmiSensorFactors();
+  cIpmiSensorFactors( const cIpmiSensorFactors &sf );
   virtual ~cIpmiSensorFactors();
 
+  cIpmiSensorFactors &operator=( const cIpmiSensorFactors &sf );
+
   virtual bool GetDataFromSdr( const cIpmiSdr *sdr );
   virtual bool Cmp( const cIpmiSensorFactors &sf ) const;
 
@@ -108,7 +118,10 @@ public:
       eRoundUp
   };
 
+  // uses the lookup table if there is one for the current factors
   bool ConvertFromRaw( unsigned int val, double &result, bool is_hysteresis ) const;
+  // conversion without lookup table
+  bool Calculate( unsigned int val, double &result, bool is_hysteresis ) const;
   bool ConvertToRaw( tIpmiRound rounding, double val, unsigned int &result, bool is_hysteresis, bool swap_thresholds ) const;
 };
 
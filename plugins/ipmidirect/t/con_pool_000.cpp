@@ -0,0 +1,211 @@
+/*
+ * Test the connection pool with a local BMC stub:
+ * commands are spread over all sessions and a session
+ * that stops responding is taken out of service.
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <arpa/inet.h>
+
+#include "ipmi_con_lan.h"
+#include "ipmi_con_pool.h"
+#include "lan_bmc_stub.h"
+#include "test.h"
+
+
+#define dNumSessions 4
+#define dNumThreads  8
+#define dTimeout     300
+
+
+class cTestCon : public cIpmiConLan
+{
+public:
+  cTestCon( struct in_addr addr, int port )
+    : cIpmiConLan( dTimeout, 0, addr, port, eIpmiAuthTypeNone,
+                   eIpmiPrivilegeAdmin, (char *)"", (char *)"" )
+  {}
+
+  virtual void HandleAsyncEvent( const cIpmiAddr &, const cIpmiMsg & ) {}
+};
+
+
+static cIpmiConPool *pool = 0;
+static cThreadLock lock;
+static int cmds_done = 0;
+static int cmds_ok   = 0;
+
+
+class cCmdThread : public cThread
+{
+  int m_cmds;
+
+public:
+  int m_ok;
+
+  cCmdThread( int cmds ) : m_cmds( cmds ), m_ok( 0 ) {}
+
+protected:
+  virtual void *Run()
+  {
+    cIpmiAddr si( eIpmiAddrTypeSystemInterface );
+    cIpmiMsg  msg( eIpmiNetfnApp, eIpmiCmdGetDeviceId );
+
+    for( int i = 0; i < m_cmds; i++ )
+       {
+         cIpmiMsg rsp;
+         SaErrorT rv = pool->ExecuteCmd( si, msg, rsp );
+
+         cThreadLockAuto al( lock );
+
+         cmds_done++;
+
+         if ( rv == SA_OK && rsp.m_data[0] == 0 && rsp.m_data_len == 12 )
+            {
+              cmds_ok++;
+              m_ok++;
+            }
+       }
+
+    return 0;
+  }
+};
+
+
+static int
+Done()
+{
+  cThreadLockAuto al( lock );
+
+  return cmds_done;
+}
+
+
+static int
+Ok()
+{
+  cThreadLockAuto al( lock );
+
+  return cmds_ok;
+}
+
+
+static void
+StartCmds( cCmdThread **threads, int cmds )
+{
+  for( int i = 0; i < dNumThreads; i++ )
+     {
+       threads[i] = new cCmdThread( cmds );
+       threads[i]->Start();
+     }
+}
+
+
+static void
+WaitCmds( cCmdThread **threads )
+{
+  for( int i = 0; i < dNumThreads; i++ )
+     {
+       void *rv;
+       threads[i]->Wait( rv );
+       delete threads[i];
+     }
+}
+
+
+static bool
+Up( int idx )
+{
+  cIpmiConPoolHealth h;
+
+  pool->GetHealth( idx, h );
+
+  return h.m_up;
+}
+
+
+int
+main()
+{
+  cLanBmcStub stub( 2 );
+  cCmdThread *threads[dNumThreads];
+  struct in_addr addr;
+
+  Test( stub.Open() );
+  inet_aton( "127.0.0.1", &addr );
+
+  pool = new cIpmiConPool( dTimeout, 0 );
+
+  for( int i = 0; i < dNumSessions; i++ )
+       Test( pool->AddSession( new cTestCon( addr, stub.Port() ) ) );
+
+  Test( pool->Open() );
+  Test( stub.NumClients() == dNumSessions );
+  Test( pool->SetMaxOutstanding( 2 ) );
+
+  // commands are spread over all sessions
+  StartCmds( threads, 100 );
+  WaitCmds( threads );
+
+  Test( Ok() == dNumThreads * 100 );
+
+  for( int i = 0; i < dNumSessions; i++ )
+     {
+       cIpmiConPoolHealth h;
+
+       Test( pool->GetHealth( i, h ) );
+       Test( h.m_up );
+       Test( h.m_cmds > 0 );
+       Test( h.m_timeouts == 0 );
+     }
+
+  // session 1 hangs
+  cmds_done = cmds_ok = 0;
+  stub.Drop( 1, true );
+  StartCmds( threads, 200 );
+
+  cTime timeout = cTime::Now();
+  timeout += 20000;
+
+  while( Up( 1 ) && cTime::Now() < timeout )
+       usleep( 10000 );
+
+  Test( !Up( 1 ) );
+
+  // new commands go to the other sessions
+  cCmdThread t( 100 );
+  void *rv;
+  t.Start();
+  t.Wait( rv );
+  Test( t.m_ok == 100 );
+
+  // session 1 comes back,
+  // its waiting commands are done
+  stub.Drop( 1, false );
+
+  while( Done() < dNumThreads * 200 + 100 && cTime::Now() < timeout )
+       usleep( 10000 );
+
+  Test( Done() == dNumThreads * 200 + 100 );
+  WaitCmds( threads );
+
+  Test( Ok() == dNumThreads * 200 + 100 );
+  Test( Up( 1 ) );
+
+  cIpmiConPoolHealth h;
+  pool->GetHealth( 1, h );
+  Test( h.m_down_count == 1 );
+
+  delete pool;
+  stub.Close();
+
+  return TestResult();
+}
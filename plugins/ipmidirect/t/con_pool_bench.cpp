@@ -0,0 +1,167 @@
+/*
+ * Connection pool throughput benchmark.
+ *
+ * Runs get device id commands from several threads against
+ * the local BMC stub with 1, 2, 4 and 8 sessions and prints
+ * the commands per second.
+ * Not part of "make check": build it with "make con_pool_bench".
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+
+#include "ipmi_con_lan.h"
+#include "ipmi_con_pool.h"
+#include "lan_bmc_stub.h"
+
+
+#define dMaxThreads 256
+
+
+class cBenchCon : public cIpmiConLan
+{
+public:
+  cBenchCon( struct in_addr addr, int port )
+    : cIpmiConLan( 5000, 0, addr, port, eIpmiAuthTypeNone,
+                   eIpmiPrivilegeAdmin, (char *)"", (char *)"" )
+  {}
+
+  virtual void HandleAsyncEvent( const cIpmiAddr &, const cIpmiMsg & ) {}
+};
+
+
+class cCmdThread : public cThread
+{
+  cIpmiCon *m_con;
+  int       m_cmds;
+
+public:
+  int m_errors;
+
+  cCmdThread( cIpmiCon *con, int cmds )
+    : m_con( con ), m_cmds( cmds ), m_errors( 0 ) {}
+
+protected:
+  virtual void *Run()
+  {
+    cIpmiAddr si( eIpmiAddrTypeSystemInterface );
+    cIpmiMsg  msg( eIpmiNetfnApp, eIpmiCmdGetDeviceId );
+    cIpmiMsg  rsp;
+
+    for( int i = 0; i < m_cmds; i++ )
+         if ( m_con->ExecuteCmd( si, msg, rsp ) != SA_OK )
+              m_errors++;
+
+    return 0;
+  }
+};
+
+
+static double
+Now()
+{
+  struct timeval tv;
+
+  gettimeofday( &tv, 0 );
+
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+
+int
+main( int argc, char *argv[] )
+{
+  unsigned int delay = 5;
+  int threads = 32;
+  int cmds    = 200;
+  int max_outstanding = 4;
+
+  if ( argc > 1 )
+       delay = atoi( argv[1] );
+
+  if ( argc > 2 )
+       threads = atoi( argv[2] );
+
+  if ( argc > 3 )
+       cmds = atoi( argv[3] );
+
+  if ( argc > 4 )
+       max_outstanding = atoi( argv[4] );
+
+  if ( threads < 1 || threads > dMaxThreads || cmds < 1 )
+     {
+       printf( "Usage: %s [delay ms] [threads] [commands per thread] [max outstanding]\n",
+               argv[0] );
+       return 1;
+     }
+
+  cLanBmcStub stub( delay );
+
+  if ( !stub.Open() )
+     {
+       printf( "cannot start BMC stub !\n" );
+       return 1;
+     }
+
+  struct in_addr addr;
+  inet_aton( "127.0.0.1", &addr );
+
+  printf( "%d threads, %d commands each, round trip %u ms, %d outstanding per session\n",
+          threads, cmds, delay, max_outstanding );
+
+  for( int sessions = 1; sessions <= 8; sessions *= 2 )
+     {
+       cIpmiConPool pool( 5000, 0 );
+
+       for( int i = 0; i < sessions; i++ )
+            pool.AddSession( new cBenchCon( addr, stub.Port() ) );
+
+       if ( !pool.Open() || !pool.SetMaxOutstanding( max_outstanding ) )
+          {
+            printf( "cannot open %d sessions !\n", sessions );
+            return 1;
+          }
+
+       cCmdThread *t[dMaxThreads];
+       int errors = 0;
+       double t0 = Now();
+
+       for( int i = 0; i < threads; i++ )
+          {
+            t[i] = new cCmdThread( &pool, cmds );
+            t[i]->Start();
+          }
+
+       for( int i = 0; i < threads; i++ )
+          {
+            void *rv;
+            t[i]->Wait( rv );
+            errors += t[i]->m_errors;
+            delete t[i];
+          }
+
+       double t1 = Now();
+
+       printf( "%d sessions: %10.0f commands/s, %d errors\n",
+               sessions, threads * cmds / ( t1 - t0 ), errors );
+
+       pool.Close();
+     }
+
+  stub.Close();
+
+  return 0;
+}
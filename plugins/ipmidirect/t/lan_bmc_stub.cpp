@@ -0,0 +1,401 @@
+/*
+ * A local UDP server answering like a BMC with RMCP,
+ * for connection tests without IPMI hardware.
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include "lan_bmc_stub.h"
+#include "ipmi_cmd.h"
+#include "ipmi_auth.h"
+#include "ipmi_addr.h"
+
+
+#define dAsfIana 0xbe110000
+
+
+static unsigned char
+Checksum( const unsigned char *data, int size )
+{
+  unsigned char csum = 0;
+
+  for( ; size > 0; size--, data++ )
+       csum += *data;
+
+  return -csum;
+}
+
+
+cLanBmcStub::cLanBmcStub( unsigned int delay )
+  : m_fd( -1 ), m_port( 0 ), m_delay( delay ), m_exit( false ),
+    m_num_clients( 0 ), m_requests( 0 ), m_dropped( 0 ),
+    m_first( 0 ), m_num_pending( 0 )
+{
+  m_pending = new cPending[dLanBmcStubMaxPending];
+}
+
+
+cLanBmcStub::~cLanBmcStub()
+{
+  Close();
+
+  delete [] m_pending;
+}
+
+
+bool
+cLanBmcStub::Open()
+{
+  struct sockaddr_in addr;
+  socklen_t len = sizeof( addr );
+
+  m_fd = socket( PF_INET, SOCK_DGRAM, IPPROTO_UDP );
+
+  if ( m_fd == -1 )
+       return false;
+
+  memset( &addr, 0, sizeof( addr ) );
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = 0;
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+  if (    bind( m_fd, (struct sockaddr *)&addr, sizeof( addr ) )
+       || getsockname( m_fd, (struct sockaddr *)&addr, &len ) )
+     {
+       close( m_fd );
+       m_fd = -1;
+       return false;
+     }
+
+  m_port = ntohs( addr.sin_port );
+  m_exit = false;
+
+  return Start();
+}
+
+
+void
+cLanBmcStub::Close()
+{
+  if ( m_fd == -1 )
+       return;
+
+  m_exit = true;
+
+  void *rv;
+  Wait( rv );
+
+  close( m_fd );
+  m_fd = -1;
+}
+
+
+void
+cLanBmcStub::Drop( int client, bool drop )
+{
+  cThreadLockAuto al( m_lock );
+
+  if ( client >= 0 && client < m_num_clients )
+       m_clients[client].m_drop = drop;
+}
+
+
+int
+cLanBmcStub::NumClients()
+{
+  cThreadLockAuto al( m_lock );
+
+  return m_num_clients;
+}
+
+
+unsigned int
+cLanBmcStub::NumRequests()
+{
+  cThreadLockAuto al( m_lock );
+
+  return m_requests;
+}
+
+
+unsigned int
+cLanBmcStub::NumDropped()
+{
+  cThreadLockAuto al( m_lock );
+
+  return m_dropped;
+}
+
+
+// m_lock must be locked
+cLanBmcStub::cClient *
+cLanBmcStub::FindClient( const struct sockaddr_in &addr )
+{
+  for( int i = 0; i < m_num_clients; i++ )
+       if (    m_clients[i].m_addr.sin_port == addr.sin_port
+            && m_clients[i].m_addr.sin_addr.s_addr == addr.sin_addr.s_addr )
+            return &m_clients[i];
+
+  if ( m_num_clients == dLanBmcStubMaxClients )
+       return 0;
+
+  cClient *c = &m_clients[m_num_clients];
+
+  c->m_addr       = addr;
+  c->m_session_id = 0x1000 + m_num_clients;
+  c->m_seq        = 0;
+  c->m_active     = false;
+  c->m_drop       = false;
+
+  m_num_clients++;
+
+  return c;
+}
+
+
+void
+cLanBmcStub::Queue( const struct sockaddr_in &addr,
+                    const unsigned char *data, int len )
+{
+  if ( m_num_pending == dLanBmcStubMaxPending )
+       return;
+
+  cPending &p = m_pending[( m_first + m_num_pending ) % dLanBmcStubMaxPending];
+
+  p.m_due = cTime::Now();
+  p.m_due += m_delay;
+  p.m_addr = addr;
+  memcpy( p.m_data, data, len );
+  p.m_len = len;
+
+  m_num_pending++;
+}
+
+
+// send due responses,
+// returns the time in ms until the next one
+int
+cLanBmcStub::SendDue()
+{
+  cTime now = cTime::Now();
+
+  while( m_num_pending )
+     {
+       cPending &p = m_pending[m_first];
+
+       if ( now < p.m_due )
+          {
+            int ms =   ( p.m_due.m_time.tv_sec - now.m_time.tv_sec ) * 1000
+                     + ( p.m_due.m_time.tv_usec - now.m_time.tv_usec ) / 1000;
+
+            return ms > 0 ? ms : 1;
+          }
+
+       sendto( m_fd, p.m_data, p.m_len, 0,
+               (struct sockaddr *)&p.m_addr, sizeof( p.m_addr ) );
+
+       m_first = ( m_first + 1 ) % dLanBmcStubMaxPending;
+       m_num_pending--;
+     }
+
+  return 100;
+}
+
+
+// fill in the response data, returns the length
+int
+cLanBmcStub::HandleCmd( cClient *c, unsigned char netfn, unsigned char cmd,
+                        const unsigned char *data, int len, unsigned char *rsp )
+{
+  if ( netfn != eIpmiNetfnApp )
+     {
+       rsp[0] = eIpmiCcInvalidCmd;
+       return 1;
+     }
+
+  switch( cmd )
+     {
+       case eIpmiCmdGetDeviceId:
+            {
+              static const unsigned char device_id[] =
+              {
+                0x00, 0x20, 0x01, 0x01, 0x00, 0x51, 0x02,
+                0x57, 0x01, 0x00, 0x01, 0x00
+              };
+
+              memcpy( rsp, device_id, sizeof( device_id ) );
+              return sizeof( device_id );
+            }
+
+       case eIpmiCmdGetChannelAuthCapabilities:
+            memset( rsp, 0, 9 );
+            rsp[1] = 0x01;
+            rsp[2] = 1 << eIpmiAuthTypeNone;
+            return 9;
+
+       case eIpmiCmdGetSessionChallenge:
+            rsp[0] = 0;
+            IpmiSetUint32( rsp + 1, c->m_session_id );
+            memset( rsp + 5, 0x5a, 16 );
+            return 21;
+
+       case eIpmiCmdActivateSession:
+            if ( len < 22 )
+               {
+                 rsp[0] = eIpmiCcRequestDataLengthInvalid;
+                 return 1;
+               }
+
+            // the client chooses the seq numbers we send
+            c->m_seq    = IpmiGetUint32( data + 18 );
+            c->m_active = true;
+
+            rsp[0] = 0;
+            rsp[1] = eIpmiAuthTypeNone;
+            IpmiSetUint32( rsp + 2, c->m_session_id );
+            IpmiSetUint32( rsp + 6, 1 );
+            rsp[10] = data[1];
+            return 11;
+
+       case eIpmiCmdSetSessionPrivilege:
+            rsp[0] = 0;
+            rsp[1] = len > 0 ? data[0] : eIpmiPrivilegeAdmin;
+            return 2;
+
+       case eIpmiCmdCloseSession:
+            c->m_active = false;
+            rsp[0] = 0;
+            return 1;
+     }
+
+  rsp[0] = eIpmiCcInvalidCmd;
+  return 1;
+}
+
+
+void
+cLanBmcStub::HandlePacket( const unsigned char *data, int len,
+                           const struct sockaddr_in &addr )
+{
+  unsigned char rsp[dLanBmcStubMaxLen];
+
+  if ( len < 12 || data[0] != 6 || data[2] != 0xff )
+       return;
+
+  cThreadLockAuto al( m_lock );
+
+  cClient *c = FindClient( addr );
+
+  if ( c == 0 )
+       return;
+
+  if ( c->m_drop )
+     {
+       m_dropped++;
+       return;
+     }
+
+  if ( data[3] == 0x06 )
+     {
+       // presence ping
+       if ( data[8] != 0x80 )
+            return;
+
+       memset( rsp, 0, 28 );
+       rsp[0] = 6;
+       rsp[2] = 0xff;
+       rsp[3] = 0x06;
+       IpmiSetUint32( rsp + 4, dAsfIana );
+       rsp[8] = 0x40; // pong
+       rsp[9] = data[9];
+       rsp[11] = 16;
+
+       Queue( addr, rsp, 28 );
+       return;
+     }
+
+  // IPMI message without authentication
+  if ( data[3] != 0x07 || data[4] != 0 || len < 21 || len < data[13] + 14 )
+       return;
+
+  m_requests++;
+
+  unsigned int session_id = IpmiGetUint32( data + 9 );
+  const unsigned char *tmsg = data + 14;
+  int tlen = data[13];
+
+  // a new session is set up
+  if ( session_id == 0 )
+       c->m_active = false;
+
+  unsigned char netfn = tmsg[1] >> 2;
+  unsigned char *r = rsp + 14;
+
+  int dlen = HandleCmd( c, netfn, tmsg[5], tmsg + 6, tlen - 7, r + 6 );
+
+  r[0] = tmsg[3];
+  r[1] = ( ( netfn | 1 ) << 2 ) | ( tmsg[1] & 3 );
+  r[2] = Checksum( r, 2 );
+  r[3] = dIpmiBmcSlaveAddr;
+  r[4] = tmsg[4];
+  r[5] = tmsg[5];
+  r[6 + dlen] = Checksum( r + 3, 3 + dlen );
+
+  rsp[0] = 6;
+  rsp[1] = 0;
+  rsp[2] = 0xff;
+  rsp[3] = 0x07;
+  rsp[4] = eIpmiAuthTypeNone;
+  IpmiSetUint32( rsp + 5, c->m_active ? c->m_seq++ : 0 );
+  IpmiSetUint32( rsp + 9, session_id );
+  rsp[13] = 7 + dlen;
+
+  Queue( addr, rsp, 14 + 7 + dlen );
+}
+
+
+void *
+cLanBmcStub::Run()
+{
+  struct pollfd pfd;
+
+  pfd.fd     = m_fd;
+  pfd.events = POLLIN;
+
+  while( !m_exit )
+     {
+       int timeout = SendDue();
+
+       if ( timeout > 100 )
+            timeout = 100;
+
+       if ( poll( &pfd, 1, timeout ) != 1 )
+            continue;
+
+       unsigned char data[dLanBmcStubMaxLen];
+       struct sockaddr_in addr;
+       socklen_t addr_len = sizeof( addr );
+
+       int len = recvfrom( m_fd, data, sizeof( data ), 0,
+                           (struct sockaddr *)&addr, &addr_len );
+
+       if ( len > 0 )
+            HandlePacket( data, len, addr );
+     }
+
+  return 0;
+}
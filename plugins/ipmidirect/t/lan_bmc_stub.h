@@ -0,0 +1,106 @@
+/*
+ * A local UDP server answering like a BMC with RMCP,
+ * for connection tests without IPMI hardware.
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * Only authentication type none is supported. The stub answers
+ * presence pings, the session setup commands and get device id;
+ * all other commands get completion code 0xc1. Responses are sent
+ * after a fixed delay to emulate the round trip time.
+ */
+
+#ifndef dLanBmcStub_h
+#define dLanBmcStub_h
+
+
+#include <netinet/in.h>
+
+#ifndef dThread_h
+#include "thread.h"
+#endif
+
+#ifndef dIpmiUtils_h
+#include "ipmi_utils.h"
+#endif
+
+
+#define dLanBmcStubMaxClients  64
+#define dLanBmcStubMaxPending  4096
+#define dLanBmcStubMaxLen      128
+
+
+class cLanBmcStub : public cThread
+{
+  struct cClient
+  {
+    struct sockaddr_in m_addr;
+    unsigned int       m_session_id;
+    unsigned int       m_seq;    // next outbound seq
+    bool               m_active;
+    bool               m_drop;   // ignore all packets
+  };
+
+  struct cPending
+  {
+    cTime              m_due;
+    struct sockaddr_in m_addr;
+    unsigned char      m_data[dLanBmcStubMaxLen];
+    int                m_len;
+  };
+
+  int          m_fd;
+  int          m_port;
+  unsigned int m_delay;
+  bool         m_exit;
+
+  cThreadLock  m_lock;
+  cClient      m_clients[dLanBmcStubMaxClients];
+  int          m_num_clients;
+  unsigned int m_requests;
+  unsigned int m_dropped;
+
+  // responses not yet sent, in order of m_due
+  cPending    *m_pending;
+  int          m_first;
+  int          m_num_pending;
+
+  cClient *FindClient( const struct sockaddr_in &addr );
+  void HandlePacket( const unsigned char *data, int len,
+                     const struct sockaddr_in &addr );
+  int  HandleCmd( cClient *c, unsigned char netfn, unsigned char cmd,
+                  const unsigned char *data, int len, unsigned char *rsp );
+  void Queue( const struct sockaddr_in &addr,
+              const unsigned char *data, int len );
+  int  SendDue();
+
+protected:
+  virtual void *Run();
+
+public:
+  cLanBmcStub( unsigned int delay = 0 );
+  virtual ~cLanBmcStub();
+
+  // bind to a free port on localhost and start
+  bool Open();
+  void Close();
+
+  int Port() const { return m_port; }
+
+  // clients are numbered in the order of their first packet
+  void Drop( int client, bool drop );
+  int  NumClients();
+
+  unsigned int NumRequests();
+  unsigned int NumDropped();
+};
+
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * Test the MC task scheduler: timers and per strand ordering
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include "ipmi_scheduler.h"
+#include "ipmi_utils.h"
+#include "test.h"
+
+
+#define dNumStrands 200
+#define dNumRuns    5
+#define dNumWorkers 4
+
+
+static cThreadLock lock;
+static int  num_runs    = 0;
+static bool concurrent  = false;
+static bool early       = false;
+
+
+class cTestStrand : public cIpmiStrand
+{
+public:
+  int   m_inside;
+  int   m_runs;
+  int   m_delay;
+  cTime m_due;
+
+  cTestStrand( cIpmiScheduler *s, int delay )
+    : cIpmiStrand( s ), m_inside( 0 ), m_runs( 0 ), m_delay( delay )
+  {}
+
+  ~cTestStrand()
+  {
+    Detach();
+  }
+
+  void Arm()
+  {
+    m_due = cTime::Now();
+    m_due += m_delay;
+    WakeupIn( m_delay );
+  }
+
+protected:
+  virtual void Run()
+  {
+    cTime now = cTime::Now();
+    // allow for the clock resolution
+    now += 2;
+
+    lock.Lock();
+
+    if ( m_inside++ )
+         concurrent = true;
+
+    if ( now < m_due )
+         early = true;
+
+    lock.Unlock();
+
+    usleep( 100 );
+
+    m_runs++;
+
+    lock.Lock();
+    m_inside--;
+    num_runs++;
+    lock.Unlock();
+
+    if ( m_runs < dNumRuns )
+         Arm();
+  }
+};
+
+
+static int
+Runs()
+{
+  cThreadLockAuto al( lock );
+
+  return num_runs;
+}
+
+
+int
+main()
+{
+  cIpmiScheduler scheduler;
+
+  Test( scheduler.Start( dNumWorkers ) );
+  Test( scheduler.NumThreads() == dNumWorkers + 1 );
+
+  cTestStrand *strands[dNumStrands];
+
+  // timers up to 1.6 s, more than level 0 of the wheel covers
+  for( int i = 0; i < dNumStrands; i++ )
+     {
+       strands[i] = new cTestStrand( &scheduler, ( i * 37 ) % 1600 );
+       strands[i]->Arm();
+     }
+
+  cTime timeout = cTime::Now();
+  timeout += 20000;
+
+  while( Runs() < dNumStrands * dNumRuns && cTime::Now() < timeout )
+       usleep( 10000 );
+
+  Test( Runs() == dNumStrands * dNumRuns );
+  Test( !concurrent );
+  Test( !early );
+
+  // many wakeups of one strand never run it concurrently
+  cTestStrand *s = strands[0];
+  s->m_runs = dNumRuns;
+  s->m_due = cTime::Now();
+
+  int before = Runs();
+
+  for( int i = 0; i < 1000; i++ )
+       s->Wakeup();
+
+  timeout = cTime::Now();
+  timeout += 5000;
+
+  while( Runs() == before && cTime::Now() < timeout )
+       usleep( 10000 );
+
+  Test( Runs() > before );
+  Test( !concurrent );
+
+  // detached strands don't run
+  strands[1]->WakeupIn( 50 );
+  strands[1]->Detach();
+  before = Runs();
+  usleep( 200000 );
+  Test( Runs() == before );
+
+  scheduler.Stop();
+  Test( scheduler.NumThreads() == 0 );
+
+  for( int i = 0; i < dNumStrands; i++ )
+       delete strands[i];
+
+  return TestResult();
+}
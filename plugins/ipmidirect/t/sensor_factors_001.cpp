@@ -0,0 +1,137 @@
+/*
+ * Test that the raw -> interpreted lookup tables give
+ * the same readings as the direct calculation
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+
+#include <string.h>
+#include <math.h>
+
+#include "test.h"
+#include "ipmi_sensor_factors.h"
+
+
+static void
+SetFactors( cIpmiSdr &sdr, int fmt, int lin, int m, int b, int r_exp, int b_exp )
+{
+  memset( &sdr, 0, sizeof( cIpmiSdr ) );
+  sdr.m_type   = eSdrTypeFullSensorRecord;
+  sdr.m_length = 60;
+
+  sdr.m_data[20] = fmt << 6;
+  sdr.m_data[23] = lin;
+  sdr.m_data[24] = m & 0xff;
+  sdr.m_data[25] = (m >> 2) & 0xc0;
+  sdr.m_data[26] = b & 0xff;
+  sdr.m_data[27] = (b >> 2) & 0xc0;
+  sdr.m_data[29] = ((r_exp << 4) & 0xf0) | (b_exp & 0x0f);
+}
+
+
+static bool
+Same( double a, double b )
+{
+  if ( isnan( a ) || isnan( b ) )
+       return isnan( a ) && isnan( b );
+
+  return a == b;
+}
+
+
+static bool
+SameReadings( const cIpmiSensorFactors &sf )
+{
+  for( unsigned int i = 0; i < 256; i++ )
+     {
+       double t, c;
+
+       if ( !sf.ConvertFromRaw( i, t, false ) || !sf.Calculate( i, c, false ) )
+            return false;
+
+       if ( !Same( t, c ) )
+            return false;
+
+       if ( !sf.ConvertFromRaw( i, t, true ) || !sf.Calculate( i, c, true ) )
+            return false;
+
+       if ( !Same( t, c ) )
+            return false;
+     }
+
+  return true;
+}
+
+
+int
+main( int /*argc*/, char * /*argv*/[] )
+{
+  static const int m[]     = { 1, 136, -20, 511 };
+  static const int b[]     = { 0, 17, -300 };
+  static const int r_exp[] = { 0, -4, 2 };
+
+  cIpmiSdr sdr;
+
+  for( int fmt = eIpmiAnalogDataFormatUnsigned; fmt <= eIpmiAnalogDataFormat2Compl; fmt++ )
+       for( int lin = eIpmiLinearizationLinear; lin <= eIpmiLinearization1OverCube; lin++ )
+            for( unsigned int i = 0; i < sizeof( m ) / sizeof( int ); i++ )
+                 for( unsigned int j = 0; j < sizeof( b ) / sizeof( int ); j++ )
+                      for( unsigned int k = 0; k < sizeof( r_exp ) / sizeof( int ); k++ )
+                         {
+                           cIpmiSensorFactors sf;
+
+                           SetFactors( sdr, fmt, lin, m[i], b[j], r_exp[k], 1 );
+                           Test( sf.GetDataFromSdr( &sdr ) );
+                           Test( SameReadings( sf ) );
+                         }
+
+  // sensors with the same factors
+  SetFactors( sdr, eIpmiAnalogDataFormatUnsigned, eIpmiLinearizationLinear, 136, 0, -4, 0 );
+
+  cIpmiSensorFactors *s1 = new cIpmiSensorFactors;
+  cIpmiSensorFactors *s2 = new cIpmiSensorFactors;
+  Test( s1->GetDataFromSdr( &sdr ) );
+  Test( s2->GetDataFromSdr( &sdr ) );
+
+  cIpmiSensorFactors s3( *s1 );
+  delete s1;
+  Test( SameReadings( *s2 ) );
+  Test( SameReadings( s3 ) );
+
+  for( unsigned int i = 0; i < 256; i++ )
+     {
+       double d;
+       unsigned int r;
+
+       Test( s3.ConvertFromRaw( i, d, false ) );
+       Test( s3.ConvertToRaw( cIpmiSensorFactors::eRoundNormal, d, r, false, false ) );
+       Test( r == i );
+     }
+
+  // factors changed after reading the SDR
+  s2->m_m = 42;
+  Test( SameReadings( *s2 ) );
+
+  double d;
+  Test( s2->ConvertFromRaw( 10, d, false ) );
+  Test( fabs( d - 0.042 ) < 1e-9 );
+
+  delete s2;
+
+  // not an analog sensor
+  cIpmiSensorFactors s4;
+  SetFactors( sdr, eIpmiAnalogDataFormatNotAnalog, eIpmiLinearizationLinear, 1, 0, 0, 0 );
+  Test( s4.GetDataFromSdr( &sdr ) );
+  Test( !s4.ConvertFromRaw( 1, d, false ) );
+
+  return TestResult();
+}
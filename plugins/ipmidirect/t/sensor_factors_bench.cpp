@@ -0,0 +1,132 @@
+/*
+ * Sensor reading conversion benchmark.
+ *
+ * Compares raw -> interpreted conversions per second with the lookup
+ * tables against the direct calculation, for a linear and a non-linear
+ * sensor, and times the interpreted -> raw search.
+ * Not part of "make check": build it with "make sensor_factors_bench".
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "ipmi_sensor_factors.h"
+
+
+static double
+Now()
+{
+  struct timeval tv;
+
+  gettimeofday( &tv, 0 );
+
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+
+static void
+SetFactors( cIpmiSdr &sdr, tIpmiLinearization lin )
+{
+  memset( &sdr, 0, sizeof( cIpmiSdr ) );
+  sdr.m_type   = eSdrTypeFullSensorRecord;
+  sdr.m_length = 60;
+
+  sdr.m_data[20] = eIpmiAnalogDataFormatUnsigned << 6;
+  sdr.m_data[23] = lin;
+  sdr.m_data[24] = 136;                // M
+  sdr.m_data[26] = 3;                  // B
+  sdr.m_data[29] = ((-4 << 4) & 0xf0); // RExp
+}
+
+
+static void
+Run( const cIpmiSensorFactors &sf, unsigned int count )
+{
+  double sum = 0.0;
+  double d, t0, t1, t2, t3;
+  unsigned int i, r;
+
+  t0 = Now();
+  for( i = 0; i < count; i++ )
+     {
+       sf.Calculate( i & 0xff, d, false );
+       sum += d;
+     }
+
+  t1 = Now();
+  for( i = 0; i < count; i++ )
+     {
+       sf.ConvertFromRaw( i & 0xff, d, false );
+       sum += d;
+     }
+
+  t2 = Now();
+  for( i = 0; i < count / 8; i++ )
+     {
+       sf.ConvertFromRaw( i & 0xff, d, false );
+       sf.ConvertToRaw( cIpmiSensorFactors::eRoundNormal, d, r, false, false );
+       sum += r;
+     }
+
+  t3 = Now();
+
+  printf( "%-10s calculate %12.0f/s  table %12.0f/s  (x%.1f)  to raw %10.0f/s\n",
+          IpmiLinearizationToString( sf.Linearization() ),
+          count / ( t1 - t0 ), count / ( t2 - t1 ),
+          ( t1 - t0 ) / ( t2 - t1 ), ( count / 8 ) / ( t3 - t2 ) );
+
+  // keep the loops from being optimized away
+  if ( sum == 0.123 )
+       printf( "\n" );
+}
+
+
+int
+main( int argc, char *argv[] )
+{
+  unsigned int count = 10000000;
+
+  if ( argc > 1 )
+       count = atoi( argv[1] );
+
+  if ( count < 8 )
+     {
+       printf( "Usage: %s [conversions]\n", argv[0] );
+       return 1;
+     }
+
+  static const tIpmiLinearization lin[] =
+  {
+    eIpmiLinearizationLinear,
+    eIpmiLinearizationLn,
+    eIpmiLinearizationExp10,
+    eIpmiLinearizationCube
+  };
+
+  printf( "%u conversions\n", count );
+
+  for( unsigned int i = 0; i < sizeof( lin ) / sizeof( lin[0] ); i++ )
+     {
+       cIpmiSdr sdr;
+       cIpmiSensorFactors sf;
+
+       SetFactors( sdr, lin[i] );
+       sf.GetDataFromSdr( &sdr );
+       Run( sf, count );
+     }
+
+  return 0;
+}
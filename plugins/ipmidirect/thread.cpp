@@ -139,7 +139,8 @@ cThread::Start()
 bool
 cThread::Wait( void *&rv )
 {
-  if ( m_state != eTsRun )
+  // the thread may have finished already
+  if ( m_state != eTsRun && m_state != eTsExit )
        return false;
 
   void *rr;
@@ -149,6 +150,7 @@ cThread::Wait( void *&rv )
   if ( r )
        return false;
 
+  m_state = eTsUnknown;
   rv = rr;
 
   return true;
@@ -336,3 +338,30 @@ cThreadCond::Wait()
   pthread_cond_wait( &m_cond, &m_lock );
 }
 
+
+void
+cThreadCond::Broadcast()
+{
+  pthread_cond_broadcast( &m_cond );
+}
+
+
+bool
+cThreadCond::TimedWait( unsigned int ms )
+{
+  struct timeval now;
+  struct timespec timeout;
+
+  gettimeofday( &now, 0 );
+
+  timeout.tv_sec  = now.tv_sec + ms / 1000;
+  timeout.tv_nsec = ( now.tv_usec + ( ms % 1000 ) * 1000 ) * 1000;
+
+  if ( timeout.tv_nsec >= 1000000000 )
+     {
+       timeout.tv_sec++;
+       timeout.tv_nsec -= 1000000000;
+     }
+
+  return pthread_cond_timedwait( &m_cond, &m_lock, &timeout ) != ETIMEDOUT;
+}
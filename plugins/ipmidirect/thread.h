@@ -138,8 +138,15 @@ public:
   // call Lock before Signal
   virtual void Signal();
 
+  // call Lock before Broadcast
+  virtual void Broadcast();
+
   // call Lock before Wait
   virtual void Wait();
+
+  // call Lock before TimedWait.
+  // false => timeout
+  virtual bool TimedWait( unsigned int ms );
 };
 
 
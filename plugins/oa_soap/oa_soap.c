@@ -61,6 +61,7 @@
 #include "sahpi_wrappers.h"
 #include "oa_soap.h"
 #include "oa_soap_utils.h"
+#include "oa_soap_telemetry.h"
 
 /* For maintaining the patch versions */
 static char const rcsid[] __attribute__ ((used)) =
@@ -168,6 +169,13 @@ SaErrorT build_oa_soap_custom_handler(struct oh_handler_state *oh_handler)
                 memset(oa_handler->memErrRecFlag, 0, sizeof( SaHpiInt32T) * 16);
                 memset(oa_handler->server_insert_timer, 0, sizeof( time_t) * 16);
 
+                /* Initialize the telemetry snapshot. Without it the sensor
+                 * readings are fetched from the OA on every read
+                 */
+                oa_handler->telemetry = oa_soap_tlm_new(oh_handler->config);
+                if (oa_handler->telemetry == NULL)
+                        err("Telemetry snapshot is not available");
+
                 /* Put the oa_handler in oh_handler */
                 oh_handler->data = oa_handler;
         } else {
@@ -409,6 +417,10 @@ void oa_soap_close(void *oh_handler)
                 soap_close(oa_handler->oa_2->event_con2);
         dbg("Released the SOAP CON structures from handler");
 
+        /* Release the telemetry snapshot */
+        oa_soap_tlm_free(oa_handler->telemetry);
+        oa_handler->telemetry = NULL;
+
         /* Release the oa info structure */
         wrap_g_free(oa_handler->oa_1);
         wrap_g_free(oa_handler->oa_2);
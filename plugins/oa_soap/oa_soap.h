@@ -173,6 +173,8 @@ typedef struct resource_status
         SaHpiInt32T max_bays;
         enum resource_presence_status *presence;
         char **serial_number;
+        /* Hash of the part number, 0 if not known */
+        guint *fingerprint;
         SaHpiResourceIdT *resource_id;
 } resource_status_t;
 
@@ -218,6 +220,8 @@ struct oa_soap_handler
         uint desired_rated_circuit_cap;
         SaHpiInt32T memErrRecFlag[16];
         time_t server_insert_timer[16];
+        /* Enclosure telemetry snapshot, see oa_soap_telemetry.h */
+        struct oa_soap_telemetry *telemetry;
 };
 
 /* Structure for storing the current hotswap state of the resource */
@@ -652,6 +652,15 @@ static SaErrorT oa_soap_build_enc_info(struct oh_handler_state *oh_handler,
                 release_oa_soap_resources(oa_handler);
                 return SA_ERR_HPI_OUT_OF_MEMORY;
         }
+        /* Part number fingerprints, 0 till the bay is discovered */
+        oa_handler->oa_soap_resources.server.fingerprint = (guint *)
+                g_malloc0(sizeof(guint) *
+                          oa_handler->oa_soap_resources.server.max_bays);
+        if (oa_handler->oa_soap_resources.server.fingerprint == NULL) {
+                err("Out of memory");
+                release_oa_soap_resources(oa_handler);
+                return SA_ERR_HPI_OUT_OF_MEMORY;
+        }
 
         for (i = 0; i < oa_handler->oa_soap_resources.server.max_bays; i++) {
                 oa_handler->oa_soap_resources.server.presence[i] = RES_ABSENT;
@@ -696,6 +705,15 @@ static SaErrorT oa_soap_build_enc_info(struct oh_handler_state *oh_handler,
                 release_oa_soap_resources(oa_handler);
                 return SA_ERR_HPI_OUT_OF_MEMORY;
         }
+        /* Part number fingerprints, 0 till the bay is discovered */
+        oa_handler->oa_soap_resources.interconnect.fingerprint = (guint *)
+                g_malloc0(sizeof(guint) *
+                          oa_handler->oa_soap_resources.interconnect.max_bays);
+        if (oa_handler->oa_soap_resources.interconnect.fingerprint == NULL) {
+                err("Out of memory");
+                release_oa_soap_resources(oa_handler);
+                return SA_ERR_HPI_OUT_OF_MEMORY;
+        }
 
         for (i = 0;
              i < oa_handler->oa_soap_resources.interconnect.max_bays;
@@ -735,6 +753,15 @@ static SaErrorT oa_soap_build_enc_info(struct oh_handler_state *oh_handler,
                 release_oa_soap_resources(oa_handler);
                 return SA_ERR_HPI_OUT_OF_MEMORY;
         }
+        /* Part number fingerprints, 0 till the bay is discovered */
+        oa_handler->oa_soap_resources.oa.fingerprint = (guint *)
+                g_malloc0(sizeof(guint) *
+                          oa_handler->oa_soap_resources.oa.max_bays);
+        if (oa_handler->oa_soap_resources.oa.fingerprint == NULL) {
+                err("Out of memory");
+                release_oa_soap_resources(oa_handler);
+                return SA_ERR_HPI_OUT_OF_MEMORY;
+        }
         /* allocate memory for OAs resource_id array */
         oa_handler->oa_soap_resources.oa.resource_id =
                 (SaHpiResourceIdT *)
@@ -834,6 +861,15 @@ static SaErrorT oa_soap_build_enc_info(struct oh_handler_state *oh_handler,
                 release_oa_soap_resources(oa_handler);
                 return SA_ERR_HPI_OUT_OF_MEMORY;
         }
+        /* Part number fingerprints, 0 till the bay is discovered */
+        oa_handler->oa_soap_resources.ps_unit.fingerprint = (guint *)
+                g_malloc0(sizeof(guint) *
+                          oa_handler->oa_soap_resources.ps_unit.max_bays);
+        if (oa_handler->oa_soap_resources.ps_unit.fingerprint == NULL) {
+                err("Out of memory");
+                release_oa_soap_resources(oa_handler);
+                return SA_ERR_HPI_OUT_OF_MEMORY;
+        }
 
         for (i = 0; i < oa_handler->oa_soap_resources.ps_unit.max_bays; i++) {
                 oa_handler->oa_soap_resources.ps_unit.presence[i] = RES_ABSENT;
@@ -1525,6 +1561,9 @@ SaErrorT discover_oa(struct oh_handler_state *oh_handler)
                 oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.oa, i,
                       info_result.serialNumber, resource_id, RES_PRESENT);
+                oa_soap_update_resource_fingerprint(
+                      &oa_handler->oa_soap_resources.oa, i,
+                      info_result.partNumber);
 
                 /* Build RDRs for OA */
                 rv = build_oa_rdr(oh_handler, oa_handler->active_con, i,
@@ -2333,6 +2372,9 @@ SaErrorT discover_server(struct oh_handler_state *oh_handler)
                 oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.server, i,
                       info_result.serialNumber, resource_id, RES_PRESENT);
+                oa_soap_update_resource_fingerprint(
+                      &oa_handler->oa_soap_resources.server, i,
+                      info_result.partNumber);
 
                 /* Build rdr entry for server */
                 rv = build_discovered_server_rdr_arr(oh_handler, oa_handler->active_con, i,
@@ -3185,6 +3227,9 @@ SaErrorT discover_interconnect(struct oh_handler_state *oh_handler)
                 oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.interconnect, i,
                       info_result.serialNumber, resource_id, RES_PRESENT);
+                oa_soap_update_resource_fingerprint(
+                      &oa_handler->oa_soap_resources.interconnect, i,
+                      info_result.partNumber);
                 /* Build rdr entry for interconnect */
                 rv = build_discovered_intr_rdr_arr(oh_handler, oa_handler->active_con,
                                                 i, resource_id, TRUE, &info_result,
@@ -3903,6 +3948,9 @@ SaErrorT discover_power_supply(struct oh_handler_state *oh_handler)
                 oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.ps_unit, i,
                       result->serialNumber, resource_id, RES_PRESENT);
+                oa_soap_update_resource_fingerprint(
+                      &oa_handler->oa_soap_resources.ps_unit, i,
+                      result->sparePartNumber);
 
                 /* Build the rdr entry for power supply */
                 rv = build_discovered_ps_rdr_arr(oh_handler, result, 
@@ -54,6 +54,7 @@
  **/
 
 #include "oa_soap_event.h"
+#include "oa_soap_telemetry.h"
 #include "sahpi_wrappers.h"
 #include <sys/time.h>
 
@@ -272,8 +273,13 @@ gpointer oa_soap_event_thread(gpointer oa_pointer)
                          */
                         if (response.eventInfoArray == NULL) {
                                 dbg("Ignoring empty event response");
-                        } else
+                        } else {
                                 process_oa_events(handler, oa, &response);
+                                /* Readings may have changed with the
+                                 * events, drop the telemetry snapshot
+                                 */
+                                oa_soap_tlm_invalidate(oa_handler->telemetry);
+                        }
                 } else {
                         /* On switchover, the standby-turned-active OA stops
                          * responding to SOAP calls to avoid the network loop.
@@ -304,6 +310,11 @@ gpointer oa_soap_event_thread(gpointer oa_pointer)
                                 oa_soap_error_handling(handler, oa);
                                 request.pid = oa->event_pid;
 
+                                /* The active OA may have changed and the
+                                 * resources are re-discovered
+                                 */
+                                oa_soap_tlm_invalidate(oa_handler->telemetry);
+
                                 /* Re-initialize the con */
                                 if (oa->event_con2 != NULL) {
                                         soap_close(oa->event_con2);
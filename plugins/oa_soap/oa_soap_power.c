@@ -45,6 +45,12 @@
  *      get_interconnect_power_state()  - gets the inter connect resource power
  *                                        state
  *
+ *      oa_soap_map_server_power()      - maps the blade status power state
+ *                                        to the HPI power state
+ *
+ *      oa_soap_map_interconnect_power() - maps the interconnect status power
+ *                                        state to the HPI power state
+ *
  *      set_server_power_state()        - sets the server blade resource power
  *                                        state
  *
@@ -245,7 +251,31 @@ SaErrorT get_server_power_state(SOAP_CON *con,
                 return SA_ERR_HPI_INTERNAL_ERROR;
         }
 
-        switch (response.powered) {
+        return oa_soap_map_server_power(response.powered, bay_number, state);
+}
+
+/**
+ * oa_soap_map_server_power
+ *      @powered:    Power state reported in the blade status
+ *      @bay_number: Bay number of the server blade
+ *      @state:      Pointer to power state of the server blade
+ *
+ * Purpose:
+ *      Maps the power state of the blade status to the HPI power state.
+ *
+ * Detailed Description:
+ *      - Lets the callers which already have the blade status (e.g. from
+ *        the status array) avoid the getBladeStatus call
+ *
+ * Return values:
+ *      SA_OK                     - on success.
+ *      SA_ERR_HPI_INTERNAL_ERROR - on unexpected power state.
+ **/
+SaErrorT oa_soap_map_server_power(enum power powered,
+                                  SaHpiInt32T bay_number,
+                                  SaHpiPowerStateT *state)
+{
+        switch (powered) {
                 case (POWER_ON):
                         *state = SAHPI_POWER_ON;
                         break;
@@ -258,7 +288,7 @@ SaErrorT get_server_power_state(SOAP_CON *con,
                         break;
                 default:
                         err("Unknown Power State %d detected for Blade in "
-				" bay %d", response.powered, bay_number);
+				" bay %d", powered, bay_number);
                         return SA_ERR_HPI_INTERNAL_ERROR;
         }
         return SA_OK;
@@ -300,7 +330,31 @@ SaErrorT get_interconnect_power_state(SOAP_CON *con,
                 return SA_ERR_HPI_INTERNAL_ERROR;
         }
 
-        switch (response.powered) {
+        return oa_soap_map_interconnect_power(response.powered, bay_number,
+                                              state);
+}
+
+/**
+ * oa_soap_map_interconnect_power
+ *      @powered:    Power state reported in the interconnect tray status
+ *      @bay_number: Bay number of the interconnect blade
+ *      @state:      Pointer to power state of the interconnect blade
+ *
+ * Purpose:
+ *      Maps the power state of the interconnect tray status to the HPI
+ *      power state.
+ *
+ * Detailed Description: NA
+ *
+ * Return values:
+ *      SA_OK                     - on success.
+ *      SA_ERR_HPI_INTERNAL_ERROR - on unexpected power state.
+ **/
+SaErrorT oa_soap_map_interconnect_power(enum power powered,
+                                        SaHpiInt32T bay_number,
+                                        SaHpiPowerStateT *state)
+{
+        switch (powered) {
                 case (POWER_ON):
                         *state = SAHPI_POWER_ON;
                         break;
@@ -316,7 +370,7 @@ SaErrorT get_interconnect_power_state(SOAP_CON *con,
                         break;
                 default:
                         err("Unknown Power State %d detected for interconnect"
-				" at bay %d", response.powered, bay_number);
+				" at bay %d", powered, bay_number);
                         return SA_ERR_HPI_INTERNAL_ERROR;
         }
         return SA_OK;
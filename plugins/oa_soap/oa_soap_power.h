@@ -56,6 +56,14 @@ SaErrorT get_interconnect_power_state(SOAP_CON *con,
                                       SaHpiInt32T bay_number,
                                       SaHpiPowerStateT *state);
 
+SaErrorT oa_soap_map_server_power(enum power powered,
+                                  SaHpiInt32T bay_number,
+                                  SaHpiPowerStateT *state);
+
+SaErrorT oa_soap_map_interconnect_power(enum power powered,
+                                        SaHpiInt32T bay_number,
+                                        SaHpiPowerStateT *state);
+
 SaErrorT set_server_power_state(SOAP_CON *con,
                                 SaHpiInt32T bay_number,
                                 SaHpiPowerStateT state);
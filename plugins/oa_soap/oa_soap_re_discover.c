@@ -83,6 +83,9 @@
  *
  *      add_ps_unit()                   - Add the PSU to RPT
  *
+ *	oa_soap_re_disc_is_replaced()	- Checks whether the resource in a
+ *					  bay got replaced
+ *
  *	oa_soap_re_disc_oa_sen()	- Re-discovers the OA sensor states
  *
  *	oa_soap_re_disc_interconct_sen()- Re-discovers the interconnect sensor
@@ -111,13 +114,20 @@
 #include "sahpi_wrappers.h"
 
 /* Forward declarations for static functions */
+static SaHpiBoolT oa_soap_re_disc_is_replaced(resource_status_t *res_status,
+					       SaHpiInt32T bay_number,
+					       char *serial_number,
+					       char *part_number);
 static SaErrorT oa_soap_re_disc_oa_sen(struct oh_handler_state *oh_handler,
 				       SOAP_CON *con,
-				       SaHpiInt32T bay_number);
+				       SaHpiInt32T bay_number,
+				       struct oaStatus *response);
 static SaErrorT oa_soap_re_disc_interconct_sen(struct oh_handler_state
 							*oh_handler,
 					      SOAP_CON *con,
-					      SaHpiInt32T bay_number);
+					      SaHpiInt32T bay_number,
+					      struct interconnectTrayStatus
+							*response);
 static SaErrorT oa_soap_re_disc_ps_sen(struct oh_handler_state *oh_handler,
 				       SOAP_CON *con,
 				       SaHpiInt32T bay_number,
@@ -350,14 +360,16 @@ SaErrorT re_discover_oa(struct oh_handler_state *oh_handler,
                                 /* If serail number is different
                                  * remove and add OA
                                  */
-                                if (strcmp(oa_handler->oa_soap_resources.oa.
-                                           serial_number[i - 1],
-                                           info_result.serialNumber) != 0) {
+                                if (oa_soap_re_disc_is_replaced(
+                                        &oa_handler->oa_soap_resources.oa, i,
+                                        info_result.serialNumber,
+                                        info_result.partNumber) == SAHPI_TRUE) {
                                         replace_resource = SAHPI_TRUE;
                                 } else {
 					/* Check the OA sensors state */
 					rv = oa_soap_re_disc_oa_sen(
-						oh_handler, con, i);
+						oh_handler, con, i,
+						&status_result);
 					if (rv != SA_OK) {
 						err("Re-discover OA sensors "
 						    " failed");
@@ -632,6 +644,9 @@ SaErrorT add_oa(struct oh_handler_state *oh_handler,
         oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.oa, bay_number,
                       response.serialNumber, resource_id, RES_PRESENT);
+        oa_soap_update_resource_fingerprint(
+              &oa_handler->oa_soap_resources.oa, bay_number,
+              response.partNumber);
 
         /* Update the OA firmware version to RPT entry */
         rv = update_oa_info(oh_handler, &response, resource_id);
@@ -713,6 +728,7 @@ SaErrorT re_discover_blade(struct oh_handler_state *oh_handler,
         struct bladeInfo result;
         struct bladeStatus sts_result;
         struct bladePortMap pm_result;
+        SaHpiPowerStateT power_state;
         SaHpiInt32T i = 0,max_bays = 0;
         enum resource_presence_status state = RES_ABSENT;
         SaHpiBoolT replace_resource = SAHPI_FALSE;
@@ -793,17 +809,23 @@ SaErrorT re_discover_blade(struct oh_handler_state *oh_handler,
                                 /* If Serial number is different, remove and
                                  * add the blade
                                  */
-                               if (strcmp(oa_handler->oa_soap_resources.server.
-                                   serial_number[i - 1],
-                                   result.serialNumber) != 0) {
+                               if (oa_soap_re_disc_is_replaced(
+                                       &oa_handler->oa_soap_resources.server, i,
+                                       result.serialNumber,
+                                       result.partNumber) == SAHPI_TRUE) {
                                         replace_resource = SAHPI_TRUE;
                                } else {
                                        /* Check and update the hotswap state
                                         * of the server blade
                                         */
                                       if(result.bladeType == BLADE_TYPE_SERVER){
-                                              rv = update_server_hotswap_state(
-                                                   oh_handler, con, i);
+                                              rv = oa_soap_map_server_power(
+                                                   sts_result.powered, i,
+                                                   &power_state);
+                                              if (rv == SA_OK)
+                                                   rv =
+                                                   update_server_hotswap_state(
+                                                   oh_handler, i, power_state);
                                               if (rv != SA_OK) {
                                                    err("Update server hot swap"
                                                        " state failed");
@@ -884,8 +906,8 @@ SaErrorT re_discover_blade(struct oh_handler_state *oh_handler,
 /**
  * update_server_hotswap_state
  *      @oh_handler: Pointer to openhpi handler
- *      @con:        Pointer to soap client handler
  *      @bay_number: Bay number of the removed blade
+ *      @state:      Power state of the blade from the status array
  *
  * Purpose:
  *      Updates the server blade hot swap state in RPTable
@@ -898,18 +920,16 @@ SaErrorT re_discover_blade(struct oh_handler_state *oh_handler,
  *      SA_ERR_HPI_INTERNAL_ERROR - on failure.
  **/
 SaErrorT update_server_hotswap_state(struct oh_handler_state *oh_handler,
-                                     SOAP_CON *con,
-                                     SaHpiInt32T bay_number)
+                                     SaHpiInt32T bay_number,
+                                     SaHpiPowerStateT state)
 {
-        SaErrorT rv = SA_OK;
         SaHpiRptEntryT *rpt = NULL;
         struct oa_soap_hotswap_state *hotswap_state = NULL;
         struct oh_event event;
-        SaHpiPowerStateT state;
         SaHpiResourceIdT resource_id;
         struct oa_soap_handler *oa_handler;
 
-        if (oh_handler == NULL || con == NULL) {
+        if (oh_handler == NULL) {
                 err("Invalid parameters");
                 return SA_ERR_HPI_INVALID_PARAMS;
         }
@@ -931,12 +951,6 @@ SaErrorT update_server_hotswap_state(struct oh_handler_state *oh_handler,
                 return SA_ERR_HPI_INVALID_RESOURCE;
         }
 
-        rv = get_server_power_state(con, bay_number, &state);
-        if (rv != SA_OK) {
-                err("Unable to get power state");
-                return SA_ERR_HPI_INTERNAL_ERROR;
-        }
-
         /* Check whether current hotswap state of the server is same as
          * in hotswap structure in rpt entry
          */
@@ -1191,6 +1205,9 @@ SaErrorT add_server_blade(struct oh_handler_state *oh_handler,
         oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.server, bay_number,
                       info->serialNumber, resource_id, RES_PRESENT);
+        oa_soap_update_resource_fingerprint(
+              &oa_handler->oa_soap_resources.server, bay_number,
+              info->partNumber);
 
         /* Build the server RDR */
         rv = build_discovered_server_rdr_arr(oh_handler, con, bay_number, resource_id, 
@@ -1362,6 +1379,7 @@ SaErrorT re_discover_interconnect(struct oh_handler_state *oh_handler,
         struct interconnectTrayStatus status_result;
         struct interconnectTrayInfo info_result;
         struct interconnectTrayPortMap portmap;
+        SaHpiPowerStateT power_state;
         SaHpiInt32T i = 0, max_bays = 0;
         enum resource_presence_status state = RES_ABSENT;
         SaHpiBoolT replace_resource = SAHPI_FALSE;
@@ -1449,16 +1467,20 @@ SaErrorT re_discover_interconnect(struct oh_handler_state *oh_handler,
                         /* If serial number is different, remove and add the
                          * interconnect
                          */
-                        if (strcmp(oa_handler->oa_soap_resources.interconnect.
-                                   serial_number[i - 1],
-                                   info_result.serialNumber) != 0) {
+                        if (oa_soap_re_disc_is_replaced(
+                                &oa_handler->oa_soap_resources.interconnect, i,
+                                info_result.serialNumber,
+                                info_result.partNumber) == SAHPI_TRUE) {
                                 replace_resource = SAHPI_TRUE;
                         } else {
                                 /* Check and update the hotswap state of the
                                  * server blade
                                  */
-                                rv = update_interconnect_hotswap_state(
-                                        oh_handler, con, i);
+                                rv = oa_soap_map_interconnect_power(
+                                        status_result.powered, i, &power_state);
+                                if (rv == SA_OK)
+                                        rv = update_interconnect_hotswap_state(
+                                                oh_handler, i, power_state);
                                 if (rv != SA_OK) {
                                         err("update interconnect hot swap"
                                             " state failed");
@@ -1469,7 +1491,8 @@ SaErrorT re_discover_interconnect(struct oh_handler_state *oh_handler,
                                 }
 				/* Check the interconnect sensors state */
 				rv = oa_soap_re_disc_interconct_sen(
-							oh_handler, con, i);
+							oh_handler, con, i,
+							&status_result);
 				if (rv != SA_OK) {
 					err("Re-discover interconnect sensors "
 					    "failed");
@@ -1539,8 +1562,8 @@ SaErrorT re_discover_interconnect(struct oh_handler_state *oh_handler,
 /**
  * update_interconnect_hotswap_state
  *      @oh_handler: Pointer to openhpi handler
- *      @con:        Pointer to the SOAP_CON structure
  *      @bay_number: Bay number of the removed blade
+ *      @state:      Power state of the interconnect from the status array
  *
  * Purpose:
  *      Updates the interconnect hot swap state in RPTable
@@ -1553,18 +1576,16 @@ SaErrorT re_discover_interconnect(struct oh_handler_state *oh_handler,
  *      SA_ERR_HPI_INTERNAL_ERROR - on failure.
  **/
 SaErrorT update_interconnect_hotswap_state(struct oh_handler_state *oh_handler,
-                                           SOAP_CON *con,
-                                           SaHpiInt32T bay_number)
+                                           SaHpiInt32T bay_number,
+                                           SaHpiPowerStateT state)
 {
-        SaErrorT rv = SA_OK;
         SaHpiRptEntryT *rpt = NULL;
         struct oa_soap_hotswap_state *hotswap_state = NULL;
         struct oh_event event;
-        SaHpiPowerStateT state;
         SaHpiResourceIdT resource_id;
         struct oa_soap_handler *oa_handler;
 
-        if (oh_handler == NULL || con == NULL) {
+        if (oh_handler == NULL) {
                 err("Invalid parameters");
                 return SA_ERR_HPI_INVALID_PARAMS;
         }
@@ -1586,12 +1607,6 @@ SaErrorT update_interconnect_hotswap_state(struct oh_handler_state *oh_handler,
                 return SA_ERR_HPI_INVALID_RESOURCE;
         }
 
-        rv = get_interconnect_power_state(con, bay_number, &state);
-        if (rv != SA_OK) {
-                err("Unable to get interconnect power status");
-                return SA_ERR_HPI_INTERNAL_ERROR;
-        }
-
         /* Check whether current hotswap state of the interconnect is same as
          * in hotswap structure in rpt entry
          */
@@ -1830,6 +1845,9 @@ SaErrorT add_interconnect(struct oh_handler_state *oh_handler,
         oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.interconnect, bay_number,
                       response->serialNumber, resource_id, RES_PRESENT);
+        oa_soap_update_resource_fingerprint(
+              &oa_handler->oa_soap_resources.interconnect, bay_number,
+              response->partNumber);
 
         /* Build the RDRs */
         rv = build_discovered_intr_rdr_arr(oh_handler, con,
@@ -2054,6 +2072,7 @@ SaErrorT re_discover_fan(struct oh_handler_state *oh_handler,
                         } else
                                 err("Fan %d added", i);
                 }
+                response.fanInfoArray = soap_next_node(response.fanInfoArray);
         }
         xmlFreeDoc(fan_info_doc);
         return SA_OK;
@@ -2339,12 +2358,14 @@ SaErrorT re_discover_ps_unit(struct oh_handler_state *oh_handler,
                                 oa_soap_resources.ps_unit.presence[i - 1] ==
                             RES_PRESENT) {
 
-                                /* If serial number is diferent,
-                                 * remove and add the power supply
+                                /* If serial number or part number is
+                                 * diferent, remove and add the power supply
                                  */
-                                if (strcmp(oa_handler->oa_soap_resources.
-                                           ps_unit.serial_number[i - 1],
-                                           info_result->serialNumber) != 0) {
+                                if (oa_soap_re_disc_is_replaced(
+                                        &oa_handler->oa_soap_resources.ps_unit,
+                                        i, info_result->serialNumber,
+                                        info_result->sparePartNumber) ==
+                                    SAHPI_TRUE) {
                                         replace_resource = SAHPI_TRUE;
                                  } else {
 					/* Check the power supply sensors
@@ -2571,6 +2592,9 @@ SaErrorT add_ps_unit(struct oh_handler_state *oh_handler,
         oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.ps_unit, info->bayNumber,
                       response->serialNumber, resource_id, RES_PRESENT);
+        oa_soap_update_resource_fingerprint(
+              &oa_handler->oa_soap_resources.ps_unit, info->bayNumber,
+              response->sparePartNumber);
 
         /* Build the RDRs */
         rv = build_power_supply_rdr(oh_handler, con, response, resource_id);
@@ -2676,6 +2700,9 @@ SaErrorT add_ps_unit_arr(struct oh_handler_state *oh_handler,
         oa_soap_update_resource_status(
                       &oa_handler->oa_soap_resources.ps_unit, info->bayNumber,
                       info->serialNumber, resource_id, RES_PRESENT);
+        oa_soap_update_resource_fingerprint(
+              &oa_handler->oa_soap_resources.ps_unit, info->bayNumber,
+              info->sparePartNumber);
 
         /* Build the RDRs */
         rv = build_discovered_ps_rdr_arr(oh_handler, info, resource_id, sts_res);
@@ -2723,16 +2750,71 @@ SaErrorT add_ps_unit_arr(struct oh_handler_state *oh_handler,
         return SA_OK;
 }
 
+/**
+ * oa_soap_re_disc_is_replaced
+ *      @res_status	: Pointer to the resource status of the resource type
+ *      @bay_number	: Bay number of the resource
+ *      @serial_number	: Serial number from the info array
+ *      @part_number	: Part number from the info array
+ *
+ * Purpose:
+ *	Checks whether the resource in the bay is not the one discovered
+ *	earlier.
+ *
+ * Detailed Description:
+ *	- The serial number and the part number fingerprint stored on
+ *	  discovery are compared with the freshly fetched info array entry
+ *	- The fingerprint is compared only if it is known on both sides, as
+ *	  resources added through the hotswap events do not store it
+ *	- Resources which are not replaced keep their RPT entry and RDRs,
+ *	  only their states are refreshed from the status arrays
+ *
+ * Return values:
+ *	SAHPI_TRUE  - if the resource got replaced
+ *	SAHPI_FALSE - if the same resource is present
+ **/
+static SaHpiBoolT oa_soap_re_disc_is_replaced(resource_status_t *res_status,
+					       SaHpiInt32T bay_number,
+					       char *serial_number,
+					       char *part_number)
+{
+	guint fingerprint;
+
+	if (serial_number == NULL)
+		return SAHPI_TRUE;
+
+	if (strcmp(res_status->serial_number[bay_number - 1],
+		   serial_number) != 0)
+		return SAHPI_TRUE;
+
+	if (res_status->fingerprint == NULL ||
+	    res_status->fingerprint[bay_number - 1] == 0)
+		return SAHPI_FALSE;
+
+	fingerprint = oa_soap_fingerprint(part_number);
+	if (fingerprint != 0 &&
+	    fingerprint != res_status->fingerprint[bay_number - 1]) {
+		err("Part number of the resource in bay %d has changed",
+		    bay_number);
+		return SAHPI_TRUE;
+	}
+
+	return SAHPI_FALSE;
+}
+
 /**
  * oa_soap_re_disc_oa_sen
  *      @oh_handler	: Pointer to openhpi handler
  *      @con		: Pointer SOAP_CON structure
  *      @bay_number	: OA bay nubmer
+ *      @response	: Pointer to OA status from the status array
  *
  * Purpose:
  *	Re-discovers the OA sensor states
  *
- * Detailed Description: NA
+ * Detailed Description:
+ *	- The OA status is taken from the status array fetched by the
+ *	  re-discovery, only the network info is fetched from the OA
  *
  * Return values:
  *      SA_OK                     - on success.
@@ -2741,17 +2823,16 @@ SaErrorT add_ps_unit_arr(struct oh_handler_state *oh_handler,
  **/
 static SaErrorT oa_soap_re_disc_oa_sen(struct oh_handler_state *oh_handler,
 				       SOAP_CON *con,
-				       SaHpiInt32T bay_number)
+				       SaHpiInt32T bay_number,
+				       struct oaStatus *response)
 {
 	SaErrorT rv = SA_OK;
-	struct getOaStatus request;
-	struct oaStatus response;
 	struct oa_soap_handler *oa_handler = NULL;
 	SaHpiResourceIdT resource_id;
 	struct getOaNetworkInfo nw_info_request;
 	struct oaNetworkInfo nw_info_response;
 
-	if (oh_handler == NULL || con == NULL) {
+	if (oh_handler == NULL || con == NULL || response == NULL) {
 		err("Invalid parameters");
 		return SA_ERR_HPI_INVALID_PARAMS;
 	}
@@ -2759,15 +2840,9 @@ static SaErrorT oa_soap_re_disc_oa_sen(struct oh_handler_state *oh_handler,
 	oa_handler = (struct oa_soap_handler *) oh_handler->data;
         resource_id =
                 oa_handler->oa_soap_resources.oa.resource_id[bay_number - 1];
-	request.bayNumber = bay_number;
-	rv = soap_getOaStatus(con, &request, &response);
-	if (rv != SOAP_OK) {
-		err("Get OA status SOAP call failed");
-		return SA_ERR_HPI_INTERNAL_ERROR;
-	}
 
 	/* Check the OA sensor states */
-	oa_soap_proc_oa_status(oh_handler, &response);
+	oa_soap_proc_oa_status(oh_handler, response);
 
 	nw_info_request.bayNumber = bay_number;
 	rv = soap_getOaNetworkInfo(con, &nw_info_request, &nw_info_response);
@@ -2794,6 +2869,7 @@ static SaErrorT oa_soap_re_disc_oa_sen(struct oh_handler_state *oh_handler,
  *      @oh_handler	: Pointer to openhpi handler
  *      @con		: Pointer SOAP_CON structure
  *      @bay_number	: Interconnect bay nubmer
+ *      @response	: Pointer to interconnect status from the status array
  *
  * Purpose:
  *	Re-discovers the interconnect sensor states
@@ -2808,29 +2884,20 @@ static SaErrorT oa_soap_re_disc_oa_sen(struct oh_handler_state *oh_handler,
 static SaErrorT oa_soap_re_disc_interconct_sen(struct oh_handler_state
 							*oh_handler,
 					      SOAP_CON *con,
-					      SaHpiInt32T bay_number)
+					      SaHpiInt32T bay_number,
+					      struct interconnectTrayStatus
+							*response)
 {
-	SaErrorT rv = SA_OK;
-	struct getInterconnectTrayStatus request;
-	struct interconnectTrayStatus response;
-
-	if (oh_handler == NULL || con == NULL) {
+	if (oh_handler == NULL || con == NULL || response == NULL) {
 		err("Invalid parameters");
 		return SA_ERR_HPI_INVALID_PARAMS;
 	}
 
-	request.bayNumber = bay_number;
-	rv = soap_getInterconnectTrayStatus(con, &request, &response);
-	if (rv != SOAP_OK) {
-		err("Get interconnect tray status SOAP call failed");
-		return SA_ERR_HPI_INTERNAL_ERROR;
-	}
-
 	/* Check the interconnect sensor states */
-	oa_soap_proc_interconnect_status(oh_handler, &response);
+	oa_soap_proc_interconnect_status(oh_handler, response);
 
 	/* Check the interconnect thermal sensor state */
-	oa_soap_proc_interconnect_thermal(oh_handler, con, &response);
+	oa_soap_proc_interconnect_thermal(oh_handler, con, response);
 
 	return SA_OK;
 }
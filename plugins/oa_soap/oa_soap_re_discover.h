@@ -62,8 +62,8 @@ SaErrorT re_discover_blade(struct oh_handler_state *oh_handler,
                            SOAP_CON *con);
 
 SaErrorT update_server_hotswap_state(struct oh_handler_state *oh_handler,
-                                     SOAP_CON *con,
-                                     SaHpiInt32T bay_number);
+                                     SaHpiInt32T bay_number,
+                                     SaHpiPowerStateT state);
 
 SaErrorT remove_server_blade(struct oh_handler_state *oh_handler,
                              SaHpiInt32T bay_number);
@@ -78,8 +78,8 @@ SaErrorT re_discover_interconnect(struct oh_handler_state *oh_handler,
                                   SOAP_CON *con);
 
 SaErrorT update_interconnect_hotswap_state(struct oh_handler_state *oh_handler,
-                                           SOAP_CON *con,
-                                           SaHpiInt32T bay_number);
+                                           SaHpiInt32T bay_number,
+                                           SaHpiPowerStateT state);
 
 SaErrorT remove_interconnect(struct oh_handler_state *oh_handler,
                              SaHpiInt32T bay_number);
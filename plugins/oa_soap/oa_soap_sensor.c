@@ -99,6 +99,7 @@
 
 #include "oa_soap_sensor.h"
 #include "oa_soap_resources.h"
+#include "oa_soap_telemetry.h"
 #include "sahpi_wrappers.h"
 
 /* Forward declarations of static functions */
@@ -1002,7 +1003,9 @@ SaErrorT oa_soap_set_sensor_event_masks(void *oh_handler,
  *      Returns current status of the sensor RDR from resource
  *
  * Detailed Description:
- *      - Fetches current reading of the sensor from the resource
+ *      - Returns the reading from the enclosure telemetry snapshot, if the
+ *        snapshot holds the sensor
+ *      - Else fetches current reading of the sensor from the resource
  *        by soap call and returns reading in sensor data
  *
  * Return values:
@@ -1035,6 +1038,7 @@ SaErrorT update_sensor_rdr(struct oh_handler_state *oh_handler,
         struct powerSupplyInfo *power_supply_response = NULL;
         struct powerSubsystemInfo ps_response;
         SaHpiInt32T location = -1;
+        SaHpiFloat64T value = 0;
 
         if (oh_handler == NULL || rpt == NULL || sensor_data == NULL) {
                 err("Invalid parameters");
@@ -1043,6 +1047,20 @@ SaErrorT update_sensor_rdr(struct oh_handler_state *oh_handler,
 
         handler = (struct oh_handler_state *) oh_handler;
         oa_handler = (struct oa_soap_handler *) handler->data;
+
+        /* Serve the reading from the telemetry snapshot. If the snapshot
+         * does not hold the sensor, read it from the resource
+         */
+        rv = oa_soap_tlm_get_reading(handler, rpt, rdr_num, &value);
+        if (rv == SA_OK) {
+                sensor_data->data.IsSupported = SAHPI_TRUE;
+                sensor_data->data.Type = SAHPI_SENSOR_READING_TYPE_FLOAT64;
+                sensor_data->data.Value.SensorFloat64 = value;
+                return SA_OK;
+        } else if (rv != SA_ERR_HPI_NOT_PRESENT) {
+                err("Get reading from telemetry snapshot failed");
+                return rv;
+        }
         location = rpt->ResourceEntity.Entry[0].EntityLocation;
         thermal_request.bayNumber = 
 	server_status_request.bayNumber = 
@@ -0,0 +1,811 @@
+/*
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * This file implements the enclosure telemetry snapshot of the OA SOAP
+ * plugin. The sensor readings of the blades, fans, power supplies and the
+ * power subsystem are fetched with the array SOAP calls in one pass and
+ * served from the snapshot till it expires or an OA event invalidates it.
+ *
+ *      oa_soap_tlm_new()               - Allocates the snapshot and reads
+ *                                        the maximum age from the handler
+ *                                        configuration
+ *
+ *      oa_soap_tlm_free()              - Releases the snapshot
+ *
+ *      oa_soap_tlm_invalidate()        - Drops the snapshot, the next read
+ *                                        refreshes it
+ *
+ *      oa_soap_tlm_get_reading()       - Returns the sensor reading from the
+ *                                        snapshot, refreshes it if required
+ *
+ *      oa_soap_tlm_now()               - Returns the monotonic time in usec
+ *
+ *      oa_soap_tlm_clear_thrm()        - Clears the thermal readings of
+ *                                        the snapshot
+ *
+ *      oa_soap_tlm_clear()             - Clears the values of the snapshot
+ *
+ *      oa_soap_tlm_fetch()             - Makes the array SOAP calls
+ *
+ *      oa_soap_tlm_refresh()           - Refreshes an expired snapshot
+ *
+ *      oa_soap_tlm_thrm_generation()   - Returns the generation for the
+ *                                        thermal readings
+ *
+ *      oa_soap_tlm_get_bld_thrm()      - Returns a blade thermal reading
+ *
+ *      oa_soap_tlm_get_thrm()          - Returns a getThermalInfo reading
+ */
+
+#include <stdlib.h>
+
+#include "oa_soap_telemetry.h"
+#include "sahpi_wrappers.h"
+
+/**
+ * oa_soap_tlm_now
+ *
+ * Purpose:
+ *      Returns the monotonic time
+ *
+ * Detailed Description: NA
+ *
+ * Return values:
+ *      Time in micro seconds
+ **/
+static gint64 oa_soap_tlm_now(void)
+{
+#if GLIB_CHECK_VERSION (2, 28, 0)
+        return g_get_monotonic_time();
+#else
+        GTimeVal now;
+        g_get_current_time(&now);
+        return ((gint64)now.tv_sec * G_USEC_PER_SEC) + now.tv_usec;
+#endif
+}
+
+/**
+ * oa_soap_tlm_new
+ *      @handler_config: Pointer to the handler configuration
+ *
+ * Purpose:
+ *      Allocates the telemetry snapshot of the handler
+ *
+ * Detailed Description:
+ *      - The maximum age is taken from the "telemetry_max_age" parameter
+ *        in milli seconds, OA_SOAP_TLM_DEFAULT_MAX_AGE is used if the
+ *        parameter is not set or invalid
+ *      - With a maximum age of 0 every reading is fetched from the OA
+ *
+ * Return values:
+ *      Pointer to the snapshot - on success.
+ *      NULL                    - on wrong parameters or out of memory.
+ **/
+struct oa_soap_telemetry *oa_soap_tlm_new(GHashTable *handler_config)
+{
+        struct oa_soap_telemetry *tlm = NULL;
+        char *value = NULL;
+        char *end = NULL;
+        long max_age = OA_SOAP_TLM_DEFAULT_MAX_AGE;
+
+        if (handler_config == NULL) {
+                err("Invalid parameters");
+                return NULL;
+        }
+
+        value = (char *) g_hash_table_lookup(handler_config,
+                                             "telemetry_max_age");
+        if (value != NULL) {
+                max_age = strtol(value, &end, 10);
+                if (end == value || *end != '\0' || max_age < 0) {
+                        err("Invalid telemetry_max_age %s, using %d ms",
+                            value, OA_SOAP_TLM_DEFAULT_MAX_AGE);
+                        max_age = OA_SOAP_TLM_DEFAULT_MAX_AGE;
+                }
+        }
+
+        tlm = (struct oa_soap_telemetry *)
+                g_malloc0(sizeof(struct oa_soap_telemetry));
+        if (tlm == NULL) {
+                err("Out of memory");
+                return NULL;
+        }
+
+        tlm->mutex = wrap_g_mutex_new_init();
+        tlm->max_age = (gint64) max_age * 1000;
+        tlm->valid = SAHPI_FALSE;
+
+        dbg("Telemetry snapshot max age is %ld ms", max_age);
+        return tlm;
+}
+
+/**
+ * oa_soap_tlm_clear_thrm
+ *      @tlm: Pointer to the telemetry snapshot
+ *
+ * Purpose:
+ *      Releases the copied thermal responses and drops the getThermalInfo
+ *      temperatures
+ *
+ * Detailed Description:
+ *      - The caller holds the snapshot mutex
+ *
+ * Return values:
+ *      NONE
+ **/
+static void oa_soap_tlm_clear_thrm(struct oa_soap_telemetry *tlm)
+{
+        SaHpiInt32T i;
+
+        for (i = 0; i < OA_SOAP_TLM_MAX_BAYS; i++) {
+                if (tlm->bld_thrm_doc[i] != NULL) {
+                        xmlFreeDoc(tlm->bld_thrm_doc[i]);
+                        tlm->bld_thrm_doc[i] = NULL;
+                }
+                tlm->bld_thrm[i].bladeThermalInfoArray = NULL;
+        }
+        memset(tlm->thrm_valid, 0, sizeof(tlm->thrm_valid));
+        tlm->thrm_taken = oa_soap_tlm_now();
+}
+
+/**
+ * oa_soap_tlm_clear
+ *      @tlm: Pointer to the telemetry snapshot
+ *
+ * Purpose:
+ *      Clears the values and releases the copied thermal responses.
+ *
+ * Detailed Description:
+ *      - The caller holds the snapshot mutex
+ *
+ * Return values:
+ *      NONE
+ **/
+static void oa_soap_tlm_clear(struct oa_soap_telemetry *tlm)
+{
+        oa_soap_tlm_clear_thrm(tlm);
+        memset(&tlm->values, 0, sizeof(tlm->values));
+        tlm->valid = SAHPI_FALSE;
+}
+
+/**
+ * oa_soap_tlm_free
+ *      @tlm: Pointer to the telemetry snapshot
+ *
+ * Purpose:
+ *      Releases the telemetry snapshot
+ *
+ * Detailed Description: NA
+ *
+ * Return values:
+ *      NONE
+ **/
+void oa_soap_tlm_free(struct oa_soap_telemetry *tlm)
+{
+        if (tlm == NULL)
+                return;
+
+        dbg("Telemetry snapshot: %llu hits, %llu refreshes, "
+            "%llu invalidations", (unsigned long long) tlm->hits,
+            (unsigned long long) tlm->refreshes,
+            (unsigned long long) tlm->invalidations);
+
+        oa_soap_tlm_clear(tlm);
+        wrap_g_mutex_free_clear(tlm->mutex);
+        wrap_g_free(tlm);
+}
+
+/**
+ * oa_soap_tlm_invalidate
+ *      @tlm: Pointer to the telemetry snapshot
+ *
+ * Purpose:
+ *      Drops the snapshot. Called by the event thread after the OA events
+ *      are processed and after the OA connection is recovered.
+ *
+ * Detailed Description:
+ *      - A refresh running in parallel is not installed, as its values may
+ *        be older than the event
+ *
+ * Return values:
+ *      NONE
+ **/
+void oa_soap_tlm_invalidate(struct oa_soap_telemetry *tlm)
+{
+        if (tlm == NULL)
+                return;
+
+        wrap_g_mutex_lock(tlm->mutex);
+        if (tlm->valid == SAHPI_TRUE)
+                tlm->invalidations++;
+        oa_soap_tlm_clear(tlm);
+        tlm->generation++;
+        wrap_g_mutex_unlock(tlm->mutex);
+}
+
+/**
+ * oa_soap_tlm_fetch
+ *      @oa_handler: Pointer to the OA SOAP handler
+ *      @values:     Pointer to the values to be filled
+ *
+ * Purpose:
+ *      Makes the array SOAP calls and copies the sensor values
+ *
+ * Detailed Description:
+ *      - getBladeStatusArray, getFanInfoArray, getPowerSupplyInfoArray and
+ *        getPowerSubsystemInfo are called once for the whole enclosure
+ *      - Only the values of present bays are marked as valid
+ *      - The responses are copied by the array calls, the copies are
+ *        released once the values are taken out
+ *
+ * Return values:
+ *      SA_OK                     - on success.
+ *      SA_ERR_HPI_INVALID_PARAMS - on wrong parameters.
+ *      SA_ERR_HPI_INTERNAL_ERROR - on SOAP call failure.
+ **/
+static SaErrorT oa_soap_tlm_fetch(struct oa_soap_handler *oa_handler,
+                                  struct oa_soap_tlm_values *values)
+{
+        SaErrorT rv = SA_OK;
+        SaHpiInt32T max_bays, bay;
+        xmlNode *node = NULL;
+        xmlDocPtr doc = NULL;
+        struct getBladeStsArrayResponse bl_sts_resp;
+        struct getFanInfoArrayResponse fan_resp;
+        struct getPowerSupplyInfoArrayResponse ps_resp;
+        struct bladeStatus bl_sts;
+        struct fanInfo fan;
+        struct powerSupplyInfo ps;
+        struct powerSubsystemInfo ps_subsys;
+
+        if (oa_handler == NULL || values == NULL) {
+                err("Invalid parameters");
+                return SA_ERR_HPI_INVALID_PARAMS;
+        }
+
+        memset(values, 0, sizeof(struct oa_soap_tlm_values));
+
+        /* Power consumption of the blades */
+        max_bays = oa_handler->oa_soap_resources.server.max_bays;
+        if (max_bays > OA_SOAP_TLM_MAX_BAYS)
+                max_bays = OA_SOAP_TLM_MAX_BAYS;
+        if (max_bays > 0) {
+                rv = oa_soap_get_bladests_arr(oa_handler, max_bays,
+                                              &bl_sts_resp, NULL);
+                if (rv != SA_OK) {
+                        err("Failed to get blade status array");
+                        return rv;
+                }
+                node = bl_sts_resp.bladeStsArray;
+                doc = (node != NULL) ? node->doc : NULL;
+                while (node) {
+                        parse_bladeStatus(node, &bl_sts);
+                        bay = bl_sts.bayNumber;
+                        if (bl_sts.presence == PRESENT && bay >= 1 &&
+                            bay <= OA_SOAP_TLM_MAX_BAYS) {
+                                values->blade_valid[bay - 1] = SAHPI_TRUE;
+                                values->blade_power[bay - 1] =
+                                        bl_sts.powerConsumed;
+                        }
+                        node = soap_next_node(node);
+                }
+                if (doc != NULL)
+                        xmlFreeDoc(doc);
+        }
+
+        /* Speed and power consumption of the fans */
+        max_bays = oa_handler->oa_soap_resources.fan.max_bays;
+        if (max_bays > OA_SOAP_TLM_MAX_BAYS)
+                max_bays = OA_SOAP_TLM_MAX_BAYS;
+        if (max_bays > 0) {
+                rv = oa_soap_get_fan_info_arr(oa_handler, max_bays,
+                                              &fan_resp, NULL);
+                if (rv != SA_OK) {
+                        err("Failed to get fan info array");
+                        return rv;
+                }
+                node = fan_resp.fanInfoArray;
+                doc = (node != NULL) ? node->doc : NULL;
+                while (node) {
+                        soap_fanInfo(node, &fan);
+                        bay = fan.bayNumber;
+                        if (fan.presence == PRESENT && bay >= 1 &&
+                            bay <= OA_SOAP_TLM_MAX_BAYS) {
+                                values->fan_valid[bay - 1] = SAHPI_TRUE;
+                                values->fan_speed[bay - 1] = fan.maxFanSpeed;
+                                values->fan_power[bay - 1] =
+                                        fan.powerConsumed;
+                        }
+                        node = soap_next_node(node);
+                }
+                if (doc != NULL)
+                        xmlFreeDoc(doc);
+        }
+
+        /* Output of the power supplies */
+        max_bays = oa_handler->oa_soap_resources.ps_unit.max_bays;
+        if (max_bays > OA_SOAP_TLM_MAX_BAYS)
+                max_bays = OA_SOAP_TLM_MAX_BAYS;
+        if (max_bays > 0) {
+                rv = oa_soap_get_ps_info_arr(oa_handler, max_bays,
+                                             &ps_resp, NULL);
+                if (rv != SA_OK) {
+                        err("Failed to get power supply info array");
+                        return rv;
+                }
+                node = ps_resp.powerSupplyInfoArray;
+                doc = (node != NULL) ? node->doc : NULL;
+                while (node) {
+                        memset(&ps, 0, sizeof(struct powerSupplyInfo));
+                        parse_powerSupplyInfo(node, &ps);
+                        bay = ps.bayNumber;
+                        if (ps.presence == PRESENT && bay >= 1 &&
+                            bay <= OA_SOAP_TLM_MAX_BAYS) {
+                                values->ps_valid[bay - 1] = SAHPI_TRUE;
+                                values->ps_output[bay - 1] = ps.actualOutput;
+                        }
+                        node = soap_next_node(node);
+                }
+                if (doc != NULL)
+                        xmlFreeDoc(doc);
+        }
+
+        /* Power subsystem */
+        rv = soap_getPowerSubsystemInfo(oa_handler->active_con, &ps_subsys);
+        if (rv != SOAP_OK) {
+                err("Get power subsystem info SOAP call failed");
+                return SA_ERR_HPI_INTERNAL_ERROR;
+        }
+        values->ps_subsys_valid = SAHPI_TRUE;
+        values->ps_subsys_input_va = ps_subsys.inputPowerVa;
+        values->ps_subsys_output = ps_subsys.outputPower;
+        values->ps_subsys_consumed = ps_subsys.powerConsumed;
+        values->ps_subsys_capacity = ps_subsys.capacity;
+
+        return SA_OK;
+}
+
+/**
+ * oa_soap_tlm_refresh
+ *      @oa_handler: Pointer to the OA SOAP handler
+ *      @tlm:        Pointer to the telemetry snapshot
+ *      @generation: Generation of the snapshot to be used for the reading
+ *
+ * Purpose:
+ *      Refreshes the snapshot if it is older than the maximum age
+ *
+ * Detailed Description:
+ *      - The SOAP calls are made without holding the snapshot mutex, so the
+ *        event thread is not blocked on invalidation
+ *      - If the snapshot was invalidated while the calls were made, the new
+ *        values are dropped
+ *
+ * Return values:
+ *      SA_OK                     - snapshot is valid.
+ *      SA_ERR_HPI_NOT_PRESENT    - snapshot got invalidated by an event.
+ *      SA_ERR_HPI_INTERNAL_ERROR - on SOAP call failure.
+ **/
+static SaErrorT oa_soap_tlm_refresh(struct oa_soap_handler *oa_handler,
+                                    struct oa_soap_telemetry *tlm,
+                                    guint *generation)
+{
+        SaErrorT rv = SA_OK;
+        struct oa_soap_tlm_values values;
+        guint start;
+
+        wrap_g_mutex_lock(tlm->mutex);
+        if (tlm->valid == SAHPI_TRUE &&
+            oa_soap_tlm_now() - tlm->taken < tlm->max_age) {
+                *generation = tlm->generation;
+                wrap_g_mutex_unlock(tlm->mutex);
+                return SA_OK;
+        }
+        start = tlm->generation;
+        wrap_g_mutex_unlock(tlm->mutex);
+
+        rv = oa_soap_tlm_fetch(oa_handler, &values);
+        if (rv != SA_OK)
+                return rv;
+
+        wrap_g_mutex_lock(tlm->mutex);
+        if (tlm->generation != start) {
+                wrap_g_mutex_unlock(tlm->mutex);
+                dbg("Telemetry snapshot invalidated during refresh");
+                return SA_ERR_HPI_NOT_PRESENT;
+        }
+        oa_soap_tlm_clear(tlm);
+        memcpy(&tlm->values, &values, sizeof(struct oa_soap_tlm_values));
+        tlm->valid = SAHPI_TRUE;
+        tlm->taken = oa_soap_tlm_now();
+        tlm->generation++;
+        tlm->refreshes++;
+        *generation = tlm->generation;
+        wrap_g_mutex_unlock(tlm->mutex);
+
+        return SA_OK;
+}
+
+/**
+ * oa_soap_tlm_thrm_generation
+ *      @tlm: Pointer to the telemetry snapshot
+ *
+ * Purpose:
+ *      Returns the generation of the snapshot to be used for the thermal
+ *      readings
+ *
+ * Detailed Description:
+ *      - The thermal readings are fetched per bay and do not need the
+ *        array calls, hence the snapshot values are not refreshed here
+ *      - Thermal readings older than the maximum age are dropped
+ *
+ * Return values:
+ *      Generation of the snapshot
+ **/
+static guint oa_soap_tlm_thrm_generation(struct oa_soap_telemetry *tlm)
+{
+        guint generation;
+
+        wrap_g_mutex_lock(tlm->mutex);
+        if (oa_soap_tlm_now() - tlm->thrm_taken >= tlm->max_age)
+                oa_soap_tlm_clear_thrm(tlm);
+        generation = tlm->generation;
+        wrap_g_mutex_unlock(tlm->mutex);
+
+        return generation;
+}
+
+/**
+ * oa_soap_tlm_get_bld_thrm
+ *      @oa_handler: Pointer to the OA SOAP handler
+ *      @tlm:        Pointer to the telemetry snapshot
+ *      @generation: Generation of the snapshot
+ *      @bay:        Bay number of the blade
+ *      @rdr_num:    Sensor rdr number
+ *      @value:      Pointer to store the temperature
+ *
+ * Purpose:
+ *      Returns the blade thermal reading from the snapshot
+ *
+ * Detailed Description:
+ *      - On the first read of a blade in this snapshot the
+ *        getBladeThermalInfoArray response is copied and kept, all thermal
+ *        sensors of the blade are served from the copy
+ *
+ * Return values:
+ *      SA_OK                     - on success.
+ *      SA_ERR_HPI_INTERNAL_ERROR - on SOAP call failure.
+ *      SA_ERR_HPI_OUT_OF_MEMORY  - on out of memory.
+ **/
+static SaErrorT oa_soap_tlm_get_bld_thrm(struct oa_soap_handler *oa_handler,
+                                         struct oa_soap_telemetry *tlm,
+                                         guint generation,
+                                         SaHpiInt32T bay,
+                                         SaHpiSensorNumT rdr_num,
+                                         SaHpiFloat64T *value)
+{
+        SaErrorT rv = SA_OK;
+        struct getBladeThermalInfoArray request;
+        struct bladeThermalInfoArrayResponse response;
+        struct bladeThermalInfo info;
+        xmlDocPtr doc = NULL;
+
+        memset(&info, 0, sizeof(struct bladeThermalInfo));
+
+        wrap_g_mutex_lock(tlm->mutex);
+        if (tlm->generation == generation &&
+            tlm->bld_thrm_doc[bay - 1] != NULL) {
+                rv = oa_soap_get_bld_thrm_sen_data(rdr_num,
+                                                   tlm->bld_thrm[bay - 1],
+                                                   &info);
+                tlm->hits++;
+                wrap_g_mutex_unlock(tlm->mutex);
+                if (rv != SA_OK)
+                        return rv;
+                *value = info.temperatureC;
+                return SA_OK;
+        }
+        wrap_g_mutex_unlock(tlm->mutex);
+
+        request.bayNumber = bay;
+        rv = soap_getBladeThermalInfoArray(oa_handler->active_con,
+                                           &request, &response);
+        if (rv != SOAP_OK) {
+                err("Get blade's thermal info failed");
+                return SA_ERR_HPI_INTERNAL_ERROR;
+        }
+
+        /* The response points into the connection document, which is
+         * overwritten by the next SOAP call. Keep a copy of it.
+         */
+        doc = xmlCopyDoc(oa_handler->active_con->doc, 1);
+        if (doc == NULL) {
+                err("Out of memory");
+                return SA_ERR_HPI_OUT_OF_MEMORY;
+        }
+        response.bladeThermalInfoArray =
+                soap_walk_tree(soap_walk_doc(doc, "Body:"
+                                             "getBladeThermalInfoArrayResponse"),
+                               "bladeThermalInfoArray:bladeThermalInfo");
+
+        rv = oa_soap_get_bld_thrm_sen_data(rdr_num, response, &info);
+        if (rv != SA_OK) {
+                xmlFreeDoc(doc);
+                return rv;
+        }
+        *value = info.temperatureC;
+
+        wrap_g_mutex_lock(tlm->mutex);
+        if (tlm->generation == generation &&
+            tlm->bld_thrm_doc[bay - 1] == NULL) {
+                tlm->bld_thrm_doc[bay - 1] = doc;
+                tlm->bld_thrm[bay - 1] = response;
+                doc = NULL;
+        }
+        wrap_g_mutex_unlock(tlm->mutex);
+
+        if (doc != NULL)
+                xmlFreeDoc(doc);
+
+        return SA_OK;
+}
+
+/**
+ * oa_soap_tlm_get_thrm
+ *      @oa_handler: Pointer to the OA SOAP handler
+ *      @tlm:        Pointer to the telemetry snapshot
+ *      @generation: Generation of the snapshot
+ *      @source:     OA_SOAP_TLM_THRM_* index of the thermal source
+ *      @bay:        Bay number, location of the enclosure
+ *      @value:      Pointer to store the temperature
+ *
+ * Purpose:
+ *      Returns the temperature of an interconnect, OA or enclosure
+ *
+ * Detailed Description:
+ *      - getThermalInfo is called on the first read of the bay in this
+ *        snapshot
+ *
+ * Return values:
+ *      SA_OK                     - on success.
+ *      SA_ERR_HPI_INTERNAL_ERROR - on SOAP call failure.
+ **/
+static SaErrorT oa_soap_tlm_get_thrm(struct oa_soap_handler *oa_handler,
+                                     struct oa_soap_telemetry *tlm,
+                                     guint generation,
+                                     SaHpiInt32T source,
+                                     SaHpiInt32T bay,
+                                     SaHpiFloat64T *value)
+{
+        SaErrorT rv = SA_OK;
+        struct getThermalInfo request;
+        struct thermalInfo response;
+        SaHpiInt32T slot;
+
+        /* The enclosure has a single thermal source */
+        slot = (source == OA_SOAP_TLM_THRM_ENC) ? 0 : bay - 1;
+
+        wrap_g_mutex_lock(tlm->mutex);
+        if (tlm->generation == generation &&
+            tlm->thrm_valid[source][slot] == SAHPI_TRUE) {
+                *value = tlm->thrm_temp[source][slot];
+                tlm->hits++;
+                wrap_g_mutex_unlock(tlm->mutex);
+                return SA_OK;
+        }
+        wrap_g_mutex_unlock(tlm->mutex);
+
+        switch (source) {
+                case OA_SOAP_TLM_THRM_INTERCONNECT:
+                        request.sensorType = SENSOR_TYPE_INTERCONNECT;
+                        break;
+                case OA_SOAP_TLM_THRM_OA:
+                        request.sensorType = SENSOR_TYPE_OA;
+                        break;
+                default:
+                        request.sensorType = SENSOR_TYPE_ENC;
+                        break;
+        }
+        request.bayNumber = bay;
+
+        rv = soap_getThermalInfo(oa_handler->active_con, &request, &response);
+        if (rv != SOAP_OK) {
+                return SA_ERR_HPI_INTERNAL_ERROR;
+        }
+        *value = response.temperatureC;
+
+        wrap_g_mutex_lock(tlm->mutex);
+        if (tlm->generation == generation) {
+                tlm->thrm_valid[source][slot] = SAHPI_TRUE;
+                tlm->thrm_temp[source][slot] = response.temperatureC;
+        }
+        wrap_g_mutex_unlock(tlm->mutex);
+
+        return SA_OK;
+}
+
+/**
+ * oa_soap_tlm_get_reading
+ *      @oh_handler: Pointer to openhpi handler
+ *      @rpt:        Pointer to the rpt entry of the resource
+ *      @rdr_num:    Sensor rdr number
+ *      @value:      Pointer to store the reading
+ *
+ * Purpose:
+ *      Returns the current reading of the sensor from the telemetry
+ *      snapshot
+ *
+ * Detailed Description:
+ *      - Refreshes the snapshot with the array SOAP calls if it is older
+ *        than the maximum age. Only the readings served from the array
+ *        values refresh it, the thermal readings are fetched per bay
+ *      - The sensors are mapped in the same way as in update_sensor_rdr
+ *      - SA_ERR_HPI_NOT_PRESENT tells the caller to read the sensor
+ *        directly: the snapshot is disabled, does not hold the sensor,
+ *        could not be refreshed or got invalidated while it was refreshed
+ *
+ * Return values:
+ *      SA_OK                     - on success.
+ *      SA_ERR_HPI_INVALID_PARAMS - on wrong parameters.
+ *      SA_ERR_HPI_NOT_PRESENT    - reading is not served from the snapshot.
+ *      SA_ERR_HPI_INTERNAL_ERROR - on SOAP call failure.
+ **/
+SaErrorT oa_soap_tlm_get_reading(struct oh_handler_state *oh_handler,
+                                 SaHpiRptEntryT *rpt,
+                                 SaHpiSensorNumT rdr_num,
+                                 SaHpiFloat64T *value)
+{
+        SaErrorT rv = SA_OK;
+        struct oa_soap_handler *oa_handler = NULL;
+        struct oa_soap_telemetry *tlm = NULL;
+        struct oa_soap_tlm_values *values = NULL;
+        SaHpiInt32T bay;
+        SaHpiBoolT found = SAHPI_FALSE;
+        guint generation = 0;
+
+        if (oh_handler == NULL || rpt == NULL || value == NULL) {
+                err("Invalid parameters");
+                return SA_ERR_HPI_INVALID_PARAMS;
+        }
+
+        oa_handler = (struct oa_soap_handler *) oh_handler->data;
+        tlm = oa_handler->telemetry;
+        if (tlm == NULL || tlm->max_age == 0)
+                return SA_ERR_HPI_NOT_PRESENT;
+
+        /* The enclosure and the power subsystem are not kept per bay */
+        bay = rpt->ResourceEntity.Entry[0].EntityLocation;
+        if ((bay < 1 || bay > OA_SOAP_TLM_MAX_BAYS) &&
+            rpt->ResourceEntity.Entry[0].EntityType !=
+                                                SAHPI_ENT_SYSTEM_CHASSIS &&
+            rpt->ResourceEntity.Entry[0].EntityType != SAHPI_ENT_POWER_MGMNT)
+                return SA_ERR_HPI_NOT_PRESENT;
+
+        /* Thermal readings, served without the array calls */
+        switch (rpt->ResourceEntity.Entry[0].EntityType) {
+                case (SAHPI_ENT_SYSTEM_BLADE):
+                case (SAHPI_ENT_IO_BLADE):
+                case (SAHPI_ENT_DISK_BLADE):
+                        if ((rdr_num == OA_SOAP_SEN_TEMP_STATUS) ||
+                            ((rdr_num >= OA_SOAP_BLD_THRM_SEN_START) &&
+                             (rdr_num <= OA_SOAP_BLD_THRM_SEN_END)))
+                                return oa_soap_tlm_get_bld_thrm(oa_handler,
+                                        tlm, oa_soap_tlm_thrm_generation(tlm),
+                                        bay, rdr_num, value);
+                        break;
+                case (SAHPI_ENT_SWITCH_BLADE):
+                        return oa_soap_tlm_get_thrm(oa_handler, tlm,
+                                        oa_soap_tlm_thrm_generation(tlm),
+                                        OA_SOAP_TLM_THRM_INTERCONNECT,
+                                        bay, value);
+                case (SAHPI_ENT_SYS_MGMNT_MODULE):
+                        return oa_soap_tlm_get_thrm(oa_handler, tlm,
+                                        oa_soap_tlm_thrm_generation(tlm),
+                                        OA_SOAP_TLM_THRM_OA,
+                                        bay, value);
+                case (SAHPI_ENT_SYSTEM_CHASSIS):
+                        return oa_soap_tlm_get_thrm(oa_handler, tlm,
+                                        oa_soap_tlm_thrm_generation(tlm),
+                                        OA_SOAP_TLM_THRM_ENC,
+                                        bay, value);
+                default:
+                        break;
+        }
+
+        switch (rpt->ResourceEntity.Entry[0].EntityType) {
+                case (SAHPI_ENT_SYSTEM_BLADE):
+                case (SAHPI_ENT_IO_BLADE):
+                case (SAHPI_ENT_DISK_BLADE):
+                        if (rdr_num != OA_SOAP_SEN_PWR_STATUS)
+                                return SA_ERR_HPI_NOT_PRESENT;
+                        break;
+                case (SAHPI_ENT_FAN):
+                        if (rdr_num != OA_SOAP_SEN_FAN_SPEED &&
+                            rdr_num != OA_SOAP_SEN_PWR_STATUS)
+                                return SA_ERR_HPI_NOT_PRESENT;
+                        break;
+                case (SAHPI_ENT_POWER_MGMNT):
+                        if (rdr_num != OA_SOAP_SEN_IN_PWR &&
+                            rdr_num != OA_SOAP_SEN_OUT_PWR &&
+                            rdr_num != OA_SOAP_SEN_PWR_STATUS &&
+                            rdr_num != OA_SOAP_SEN_PWR_CAPACITY)
+                                return SA_ERR_HPI_NOT_PRESENT;
+                        break;
+                case (SAHPI_ENT_POWER_SUPPLY):
+                        break;
+                default:
+                        return SA_ERR_HPI_NOT_PRESENT;
+        }
+
+        /* A failed array call must not fail the reading, the caller
+         * falls back to the per sensor SOAP call
+         */
+        rv = oa_soap_tlm_refresh(oa_handler, tlm, &generation);
+        if (rv != SA_OK) {
+                dbg("Telemetry snapshot not refreshed, reading sensor "
+                    "directly");
+                return SA_ERR_HPI_NOT_PRESENT;
+        }
+
+        /* Values copied from the array calls */
+        wrap_g_mutex_lock(tlm->mutex);
+        if (tlm->generation != generation) {
+                wrap_g_mutex_unlock(tlm->mutex);
+                return SA_ERR_HPI_NOT_PRESENT;
+        }
+        values = &tlm->values;
+        switch (rpt->ResourceEntity.Entry[0].EntityType) {
+                case (SAHPI_ENT_SYSTEM_BLADE):
+                case (SAHPI_ENT_IO_BLADE):
+                case (SAHPI_ENT_DISK_BLADE):
+                        if (values->blade_valid[bay - 1] == SAHPI_TRUE) {
+                                *value = values->blade_power[bay - 1];
+                                found = SAHPI_TRUE;
+                        }
+                        break;
+                case (SAHPI_ENT_FAN):
+                        if (values->fan_valid[bay - 1] == SAHPI_TRUE) {
+                                if (rdr_num == OA_SOAP_SEN_FAN_SPEED)
+                                        *value = values->fan_speed[bay - 1];
+                                else
+                                        *value = values->fan_power[bay - 1];
+                                found = SAHPI_TRUE;
+                        }
+                        break;
+                case (SAHPI_ENT_POWER_MGMNT):
+                        if (values->ps_subsys_valid == SAHPI_TRUE) {
+                                if (rdr_num == OA_SOAP_SEN_IN_PWR)
+                                        *value = values->ps_subsys_input_va;
+                                else if (rdr_num == OA_SOAP_SEN_OUT_PWR)
+                                        *value = values->ps_subsys_output;
+                                else if (rdr_num == OA_SOAP_SEN_PWR_STATUS)
+                                        *value = values->ps_subsys_consumed;
+                                else
+                                        *value = values->ps_subsys_capacity;
+                                found = SAHPI_TRUE;
+                        }
+                        break;
+                case (SAHPI_ENT_POWER_SUPPLY):
+                        if (values->ps_valid[bay - 1] == SAHPI_TRUE) {
+                                *value = values->ps_output[bay - 1];
+                                found = SAHPI_TRUE;
+                        }
+                        break;
+                default:
+                        break;
+        }
+        if (found == SAHPI_TRUE)
+                tlm->hits++;
+        wrap_g_mutex_unlock(tlm->mutex);
+
+        if (found == SAHPI_FALSE)
+                return SA_ERR_HPI_NOT_PRESENT;
+
+        return SA_OK;
+}
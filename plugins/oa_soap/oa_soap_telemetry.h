@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#ifndef _OA_SOAP_TELEMETRY_H
+#define _OA_SOAP_TELEMETRY_H
+
+/* Include files */
+#include "oa_soap_discover.h"
+
+/* Default maximum age of the telemetry snapshot in milliseconds. The value
+ * can be changed with the "telemetry_max_age" handler parameter, 0 disables
+ * the snapshot
+ */
+#define OA_SOAP_TLM_DEFAULT_MAX_AGE	3000
+
+/* Largest bay number kept in the snapshot (blade bays of c7000) */
+#define OA_SOAP_TLM_MAX_BAYS		16
+
+/* Thermal sources read with getThermalInfo */
+#define OA_SOAP_TLM_THRM_INTERCONNECT	0
+#define OA_SOAP_TLM_THRM_OA		1
+#define OA_SOAP_TLM_THRM_ENC		2
+#define OA_SOAP_TLM_THRM_MAX		3
+
+/* Values copied from the array calls. Index 0 is bay 1 */
+struct oa_soap_tlm_values {
+	SaHpiBoolT blade_valid[OA_SOAP_TLM_MAX_BAYS];
+	int blade_power[OA_SOAP_TLM_MAX_BAYS];
+	SaHpiBoolT fan_valid[OA_SOAP_TLM_MAX_BAYS];
+	int fan_speed[OA_SOAP_TLM_MAX_BAYS];
+	int fan_power[OA_SOAP_TLM_MAX_BAYS];
+	SaHpiBoolT ps_valid[OA_SOAP_TLM_MAX_BAYS];
+	int ps_output[OA_SOAP_TLM_MAX_BAYS];
+	SaHpiBoolT ps_subsys_valid;
+	float ps_subsys_input_va;
+	int ps_subsys_output;
+	int ps_subsys_consumed;
+	int ps_subsys_capacity;
+};
+
+/* Enclosure wide telemetry snapshot of the OA SOAP plugin
+ *
+ * The array calls are made in one pass and all sensor readings are served
+ * from the copied values until the snapshot is older than max_age or gets
+ * invalidated by the event thread. The OA has no enclosure wide thermal
+ * call, hence the thermal readings are fetched per bay on the first read
+ * and kept till the next refresh of the snapshot, or till they are older
+ * than max_age. Thermal reads do not refresh the array values.
+ */
+struct oa_soap_telemetry {
+	GMutex *mutex;
+	gint64 max_age;		/* usec, 0 disables the snapshot */
+	SaHpiBoolT valid;
+	gint64 taken;		/* time of the last refresh */
+	guint generation;	/* bumped on every refresh and invalidation */
+	struct oa_soap_tlm_values values;
+	/* Copied getBladeThermalInfoArray responses */
+	xmlDocPtr bld_thrm_doc[OA_SOAP_TLM_MAX_BAYS];
+	struct bladeThermalInfoArrayResponse bld_thrm[OA_SOAP_TLM_MAX_BAYS];
+	/* getThermalInfo temperatures */
+	SaHpiBoolT thrm_valid[OA_SOAP_TLM_THRM_MAX][OA_SOAP_TLM_MAX_BAYS];
+	byte thrm_temp[OA_SOAP_TLM_THRM_MAX][OA_SOAP_TLM_MAX_BAYS];
+	gint64 thrm_taken;	/* time the thermal readings were dropped */
+	/* Statistics */
+	SaHpiUint64T hits;
+	SaHpiUint64T refreshes;
+	SaHpiUint64T invalidations;
+};
+
+/* Function prototypes */
+struct oa_soap_telemetry *oa_soap_tlm_new(GHashTable *handler_config);
+
+void oa_soap_tlm_free(struct oa_soap_telemetry *tlm);
+
+void oa_soap_tlm_invalidate(struct oa_soap_telemetry *tlm);
+
+SaErrorT oa_soap_tlm_get_reading(struct oh_handler_state *oh_handler,
+				 SaHpiRptEntryT *rpt,
+				 SaHpiSensorNumT rdr_num,
+				 SaHpiFloat64T *value);
+
+#endif
@@ -108,6 +108,12 @@
  *      oa_soap_check_serial_number()   - Check the serial_number and
  *                                        give a proper message
  *
+ *      oa_soap_fingerprint()           - Hashes the part number of a
+ *                                        resource
+ *
+ *      oa_soap_update_resource_fingerprint() - Stores the part number
+ *                                        fingerprint of a resource
+ *
  *      oa_soap_sleep_in_loop()   	- Sleep in 3 second intervals so that
  *                                        thread could catch the signal and exit
  *
@@ -1343,6 +1349,7 @@ void release_oa_soap_resources(struct oa_soap_handler *oa_handler)
             }
             wrap_g_free(oa_handler->oa_soap_resources.server.serial_number);
 	}
+        wrap_g_free(oa_handler->oa_soap_resources.server.fingerprint);
 
         /* Release memory of interconnect presence and serial number array */
         wrap_g_free(oa_handler->oa_soap_resources.interconnect.presence);
@@ -1356,6 +1363,7 @@ void release_oa_soap_resources(struct oa_soap_handler *oa_handler)
             }
             wrap_g_free(oa_handler->oa_soap_resources.interconnect.serial_number);
 	}
+        wrap_g_free(oa_handler->oa_soap_resources.interconnect.fingerprint);
 
         /* Release memory of OA presence and serial number array */
         wrap_g_free(oa_handler->oa_soap_resources.oa.presence);
@@ -1368,6 +1376,7 @@ void release_oa_soap_resources(struct oa_soap_handler *oa_handler)
             }
             wrap_g_free(oa_handler->oa_soap_resources.oa.serial_number);
 	}
+        wrap_g_free(oa_handler->oa_soap_resources.oa.fingerprint);
 
         /* Release memory of fan presence.  Since fans do not have serial
          * numbers, a serial numbers array does not need to be released.
@@ -1390,6 +1399,7 @@ void release_oa_soap_resources(struct oa_soap_handler *oa_handler)
             }
             wrap_g_free(oa_handler->oa_soap_resources.ps_unit.serial_number);
 	}
+        wrap_g_free(oa_handler->oa_soap_resources.ps_unit.fingerprint);
 }
 
 /**
@@ -1552,10 +1562,84 @@ void oa_soap_update_resource_status(resource_status_t *res_status,
         }
         res_status->resource_id[index-1] = resource_id;
         res_status->presence[index-1] = presence;
+        /* The part number is set separately, forget the old one */
+        if (res_status->fingerprint != NULL)
+                res_status->fingerprint[index-1] = 0;
 
         return;
 }
 
+/**
+ * oa_soap_fingerprint
+ *      @part_number: Part number string
+ *
+ * Purpose:
+ *      Hashes the part number of a resource.
+ *
+ * Detailed Description:
+ *      - The hash is stored along with the serial number and lets the
+ *        re-discovery detect a replaced resource without fetching its
+ *        info, e.g. a blade that kept the serial number after a system
+ *        board swap
+ *      - Trailing white spaces are ignored
+ *
+ * Return values:
+ *      Non zero hash - on success
+ *      0             - if the part number is not known
+ **/
+guint oa_soap_fingerprint(const char *part_number)
+{
+        guint hash = 5381;
+        size_t len;
+        size_t i;
+
+        if (part_number == NULL)
+                return 0;
+
+        len = strlen(part_number);
+        while (len > 0 && (part_number[len-1] == ' ' ||
+                           part_number[len-1] == '\t'))
+                len--;
+        if (len == 0)
+                return 0;
+
+        for (i = 0; i < len; i++)
+                hash = (hash << 5) + hash + (guchar) part_number[i];
+
+        return (hash != 0) ? hash : 1;
+}
+
+/**
+ * oa_soap_update_resource_fingerprint
+ *      @res_status:  Pointer to resource_status_t
+ *      @index:       Bay number of the resource
+ *      @part_number: Part number of the resource
+ *
+ * Purpose:
+ *      Stores the part number fingerprint of a discovered resource.
+ *
+ * Detailed Description:
+ *      - Resources without fingerprint array (fans, fan zones) are ignored
+ *
+ * Return values:
+ *      None
+ **/
+void oa_soap_update_resource_fingerprint(resource_status_t *res_status,
+                                         SaHpiInt32T index,
+                                         const char *part_number)
+{
+        if (res_status->fingerprint == NULL)
+                return;
+
+        if (index <= 0 || index > res_status->max_bays) {
+                err("Invalid index value %d - returning without update",
+                    index);
+                return;
+        }
+
+        res_status->fingerprint[index-1] = oa_soap_fingerprint(part_number);
+}
+
 char * oa_soap_trim_whitespace(char *s) {
   int i, len = strlen(s);
 
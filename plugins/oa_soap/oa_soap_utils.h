@@ -113,6 +113,12 @@ void oa_soap_update_resource_status(resource_status_t *res_status,
                                     SaHpiResourceIdT resource_id,
                                     resource_presence_status_t presence);
 
+guint oa_soap_fingerprint(const char *part_number);
+
+void oa_soap_update_resource_fingerprint(resource_status_t *res_status,
+                                         SaHpiInt32T index,
+                                         const char *part_number);
+
 char * oa_soap_trim_whitespace(char *s);
 
 SaErrorT update_oa_fw_version(struct oh_handler_state *oh_handler,
@@ -26,31 +26,25 @@
 # Script Description:
 #
 # This script takes raw event information contained in 
-# snmp_bc_event.map and generates code that populates the 
-# errlog2event_hash table. This can be done in two ways - 
-# with C code or with XML code. The C code way is simpler
-# but takes more memory. XML is more complex but takes less space.
+# snmp_bc_event.map and generates the read-only "Error Log to event"
+# table used by the plugin. This can be done in two ways - 
+# with C code or with XML code.
 # 
-# The default way is to generate C code and header files to
-# populate the hash table. This generates the following files:
+# The default way is to generate C code. This generates the 
+# following file:
 #
-# el.h - Error log header file with common #defines
-# el2event.h - Header file definitions need by generated C file.
-# el2event.c - Generated C code that adds events to directly to
-#              the errlog2event_hash table.
+# el2event.c - Generated C tables holding every event of the map
+#              laid out as a minimal perfect hash keyed by the
+#              Error Log message. The lookup routine in 
+#              snmp_bc_xml2event.c uses the same hash function as
+#              errlog2event_hash() below - change both together.
 #
-# The second way is to translate events into XML data which is 
-# (in a later step and script) turned into source code that
-# populates the hash table. This generates the following files:
+# The second way is to translate events into XML data, which is
+# kept for reviewing the map contents. This generates the 
+# following file:
 #
-# el.h - Error log header file with common #defines
-# el2event.h - Header file definitions need by generated source.
 # event.xml - XML formatted events.
 #
-# If the XML method is used, another script, scripts/text2cstr.pl, 
-# needs to be invoked to turn the XML formatted events into source 
-# code that populates the hash table.
-#
 # Script Input:
 #
 # --debug     (optional)   Turn on debug info.
@@ -62,8 +56,7 @@
 # --odir      (optional)   Directory for output file(s).
 #                          Default is current directory.
 # --xml       (optional)   Generate XML formatted events.
-#                          Default is to generate C formatted
-#                          events and code.
+#                          Default is to generate the C tables.
 #
 # Exit codes
 # - 1 successful
@@ -76,9 +69,10 @@ use Getopt::Long;
 sub check4dups($$);
 #sub print_h_file_header;
 #sub print_h_file_ending;
+sub errlog2event_hash($$);
 sub print_c_file_header;
 sub print_c_file_ending;
-sub print_c_file_hash_member($);
+sub print_c_file_tables;
 sub print_xml_file_header;
 sub print_xml_file_ending;
 sub print_xml_file_hash_member($);
@@ -210,9 +204,7 @@ if ($xml) {
 }
 else {
     if (&print_c_file_header) { $err = 0; goto CLEANUP; }
-    foreach my $event_message (sort keys %eventmap) {
-	if (&print_c_file_hash_member($event_message)) { $err = 0; goto CLEANUP; }
-    }
+    if (&print_c_file_tables) { $err = 1; goto CLEANUP; }
     if (&print_c_file_ending) { $err = 0; goto CLEANUP; }
 }
 
@@ -350,6 +342,24 @@ sub check4dups($$) {
 #    return 0;
 #}
 
+##################################################################
+# Hash of an Error Log message string - 32 bit FNV-1a with the
+# offset basis xor'ed with a seed. Must match errlog2event_hash_key()
+# in snmp_bc_xml2event.c.
+##################################################################
+sub errlog2event_hash($$) {
+
+    my ($seed, $str) = @_;
+    my $h = (0x811c9dc5 ^ $seed) & 0xffffffff;
+
+    foreach my $c (unpack("C*", $str)) {
+	$h ^= $c;
+	$h = ($h * 16777619) & 0xffffffff;
+    }
+
+    return $h;
+}
+
 ####################################
 # Print c file's static leading text 
 ####################################
@@ -375,44 +385,10 @@ sub print_c_file_header {
  *******************************************************************/
 
 #include <glib.h>
-#include <string.h>
 #include <SaHpi.h>
 
-#include <openhpi.h>
 #include <snmp_bc_plugin.h>
 
-GHashTable *errlog2event_hash;
-
-static void free_hash_data(gpointer key, gpointer value, gpointer user_data);
-
-/************************************************************************
- * errlog2event_hash_init:
- * \@custom_handle: Plugin's data pointer.
- * 
- * Initializes the Error Log to event translation hash table.
- *
- * Returns:
- * SA_OK - Normal operation.
- * SA_ERR_HPI_OUT_OF_SPACE - No memory to allocate hash table structures.
- * SA_ERR_HPI_INVALID_PARAMS - \@custom_handle is NULL.
- ************************************************************************/
-SaErrorT errlog2event_hash_init(struct snmp_bc_hnd *custom_handle) {
-
-	gchar *key;
-/*       gchar *key_exists; */
-	ErrLog2EventInfoT *strinfo;
-
-	if (!custom_handle) {
-		dbg("Invalid parameter.");
-		return(SA_ERR_HPI_INVALID_PARAMS);
-	}
-
-	errlog2event_hash = g_hash_table_new(g_str_hash, g_str_equal);
-	if (errlog2event_hash == NULL) {
-		dbg("No memory.");
-		return(SA_ERR_HPI_OUT_OF_SPACE);
-	}
-
 EOF
     return 0;
 }
@@ -422,90 +398,132 @@ EOF
 #####################################
 sub print_c_file_ending {
 
-   print FILE_C <<EOF;
-
-	return(SA_OK);
+    return 0;
 }
 
-/**********************************************************************
- * errlog2event_hash_free:
- *
- * Frees the Error Log to event translation hash table.
- *
- * Returns:
- * SA_OK - Normal operation.
- **********************************************************************/
-SaErrorT errlog2event_hash_free()
-{
-        g_hash_table_foreach(errlog2event_hash, free_hash_data, NULL);
-	g_hash_table_destroy(errlog2event_hash);
-
-	return(SA_OK);
-}
+##################################################################
+# Print c file's tables.
+#
+# The events are laid out as a minimal perfect hash (hash and
+# displace): every message is put into a bucket by its seed 0 hash.
+# Buckets holding several messages, largest first, get the smallest
+# seed that moves all their messages into free slots. Messages alone
+# in their bucket take any free slot, which is stored directly as 
+# -(slot + 1). A lookup thus costs at most two hashes and one
+# string compare.
+##################################################################
+sub print_c_file_tables {
 
-static void free_hash_data(gpointer key, gpointer value, gpointer user_data)
-{
-/*        g_free(key);  keys are string constants - cannot free them */
-        g_free(value);
-}
-EOF
+    my @entries = ();
+    my @keys = ();
 
-    return 0;
-}
+    foreach my $event_message (sort keys %eventmap) {
+	my ($event_count, $event_name, $event_hex,
+	    $event_severity, $override_flags, $event_msg, $rest) = 
+		split/\|/,$eventmap{$event_message};
 
-#############################
-# Print c file's dynamic text 
-#############################
-sub print_c_file_hash_member($) {
-    my ($event_message) = @_;
-    
-    my ($event_count, $event_name, $event_hex,
-	$event_severity, $override_flags, $event_msg, $rest) = 
-	    split/\|/,$eventmap{$event_message};
+	chomp($event_msg);
 
-    chomp($event_msg);
+	my $key = $event_msg;
+	$key =~ s/^\s*\"//;
+	$key =~ s/\"\s*$//;
 
-    my $event_hex_str = "\"$event_hex\"";
-    $event_hex_str =~ s/^\"0x/\"/;
+	push @entries, $eventmap{$event_message};
+	push @keys, $key;
+    }
 
-    my $tab = "";
+    my $n = scalar(@keys);
+    if ($n == 0) {
+	print "*************************************************************\n";
+	print "$0: Error! No events found in $file_map.\n";
+	print "*************************************************************\n\n";
+	return 1;
+    }
 
-    # Format override flags
-    if ($override_flags ne "NO_OVR") { 
-	$override_flags =~ s/,/ | /g;
+    my @buckets = ();
+    for (my $i = 0; $i < $n; $i++) {
+	push @{$buckets[errlog2event_hash(0, $keys[$i]) % $n]}, $i;
     }
-    
-    print FILE_C <<EOF;
-$tab	key = $event_msg;
-$tab	strinfo = g_malloc0(sizeof(ErrLog2EventInfoT));
-$tab	if (!strinfo) {
-$tab		dbg("No memory. Key=%s.", key);
-$tab		errlog2event_hash_free();
-$tab		return(SA_ERR_HPI_OUT_OF_SPACE);
-$tab	}
-$tab	strinfo->event = $event_hex_str; /* $event_name */
-$tab	strinfo->event_sev = $event_severity;
-$tab	strinfo->event_ovr = $override_flags;
-$tab	strinfo->event_dup = $event_count;
-$tab	g_hash_table_insert(errlog2event_hash, key, strinfo);
+
+    my @order = sort { 
+	scalar(@{$buckets[$b] || []}) <=> scalar(@{$buckets[$a] || []}) || $a <=> $b
+    } (0 .. $n - 1);
+
+    my @disp = (0) x $n;
+    my @slot = (-1) x $n;
+
+    foreach my $b (@order) {
+	my @items = @{$buckets[$b] || []};
+	last if (scalar(@items) <= 1);
+
+	my $d = 1;
+	my @pos = ();
+	while (1) {
+	    my %taken = ();
+	    @pos = ();
+	    foreach my $i (@items) {
+		my $s = errlog2event_hash($d, $keys[$i]) % $n;
+		last if ($slot[$s] >= 0 || $taken{$s});
+		$taken{$s} = 1;
+		push @pos, $s;
+	    }
+	    last if (scalar(@pos) == scalar(@items));
+	    $d++;
+	    if ($d > 0x7fffffff) {
+		print "$0: Error! Cannot place event message $keys[$items[0]].\n";
+		return 1;
+	    }
+	}
+
+	$disp[$b] = $d;
+	for (my $j = 0; $j < scalar(@items); $j++) {
+	    $slot[$pos[$j]] = $items[$j];
+	}
+    }
+
+    my @free = grep { $slot[$_] < 0 } (0 .. $n - 1);
+    foreach my $b (@order) {
+	next if (scalar(@{$buckets[$b] || []}) != 1);
+	my $s = shift @free;
+	$slot[$s] = $buckets[$b][0];
+	$disp[$b] = -($s + 1);
+    }
+
+    print FILE_C "const ErrLog2EventEntryT errlog2event_table[$n] = {\n";
+    for (my $s = 0; $s < $n; $s++) {
+	my ($event_count, $event_name, $event_hex,
+	    $event_severity, $override_flags, $event_msg, $rest) = 
+		split/\|/,$entries[$slot[$s]];
+
+	my $event_hex_str = "\"$event_hex\"";
+	$event_hex_str =~ s/^\"0x/\"/;
+
+	# Format override flags. Keep only the known flag names - the map
+	# has been read with substring matches, so misspelled ones such as
+	# OVR_RIDV still count as OVR_RID.
+	my @flags = grep { index($override_flags, $_) >= 0 } 
+	    ("OVR_SEV", "OVR_RID", "OVR_EXP", "OVR_VMM", "OVR_MM1", "OVR_MM2",
+	     "OVR_MM_STBY", "OVR_MM_PRIME");
+	$override_flags = scalar(@flags) ? join(" | ", @flags) : "NO_OVR";
+
+	my $msg = $keys[$slot[$s]];
+	$msg =~ s/\\/\\\\/g;
+	$msg =~ s/\"/\\\"/g;
+
+	print FILE_C <<EOF;
+	{ "$msg",
+	  { $event_hex_str, $event_severity, $override_flags, $event_count } }, /* $event_name */
 EOF
-#$tab
-#$tab	key_exists = g_hash_table_lookup(errlog2event_hash, key); 
-#$tab	if (!key_exists) {
-#$tab		strinfo->event = $event_hex_str; /* $event_name */
-#$tab		strinfo->event_sev = $event_severity;
-#$tab		strinfo->event_ovr = $override_flags;
-#$tab		strinfo->event_dup = $event_count;
-#$tab		g_hash_table_insert(errlog2event_hash, key, strinfo);
-#$tab	}
-#$tab	else {
-#$tab		dbg("Error!: Key %s defined twice", key);
-#$tab		errlog2event_hash_free();
-#$tab		return -1;
-#$tab	}
-#EOF
+    }
+    print FILE_C "};\n\n";
+    print FILE_C "const unsigned int errlog2event_table_size = $n;\n\n";
 
-    print FILE_C "\n";
+    print FILE_C "const int errlog2event_disp[$n] = {";
+    for (my $b = 0; $b < $n; $b++) {
+	print FILE_C (($b % 8) ? " " : "\n\t");
+	print FILE_C "$disp[$b],";
+    }
+    print FILE_C "\n};\n";
 
     return 0;
 }
@@ -43,6 +43,8 @@ struct snmp_bc_hnd {
 	char   *host;
 	char   *host_alternate;
 	SaHpiBoolT isFirstDiscovery;
+	guint   sel_newest_hash;	  /* Hash of the newest hardware log entry in elcache */
+	SaHpiBoolT sel_newest_valid;	  /* sel_newest_hash can be used by elcache sync */
 	gchar  handler_timezone[10];
         guint   handler_retries;          /* Number of retries attempted on SNMP target (agent) */
 	ohpi_bc_lock snmp_bc_hlock;
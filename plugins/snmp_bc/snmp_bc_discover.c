@@ -165,7 +165,7 @@ SaErrorT snmp_bc_discover_sensors(struct oh_handler_state *handle,
 	custom_handle = (struct snmp_bc_hnd *)handle->data;
 	
 	for (i=0; sensor_array[i].index != 0; i++) {
-		rdrptr = (SaHpiRdrT *)g_malloc0(sizeof(SaHpiRdrT));
+		rdrptr = oh_rdr_alloc();
 		if (rdrptr == NULL) {
 			err("Out of memory.");
 			return(SA_ERR_HPI_OUT_OF_MEMORY);
@@ -187,7 +187,7 @@ SaErrorT snmp_bc_discover_sensors(struct oh_handler_state *handle,
 			}
 			else {
 				err("Sensor %s cannot be read.", sensor_array[i].comment);
-				g_free(rdrptr);
+				oh_rdr_free(rdrptr);
 				return(SA_ERR_HPI_INTERNAL_ERROR);
 			}
 		}
@@ -211,7 +211,7 @@ SaErrorT snmp_bc_discover_sensors(struct oh_handler_state *handle,
 					 sensor_info_ptr, 0);
 			if (err) {
 				err("Cannot add RDR. Error=%s.", oh_lookup_error(err));
-				g_free(rdrptr);
+				oh_rdr_free(rdrptr);
 			}
 			else {
 				res_oh_event->rdrs = g_slist_append(res_oh_event->rdrs, rdrptr);	
@@ -222,7 +222,7 @@ SaErrorT snmp_bc_discover_sensors(struct oh_handler_state *handle,
 			}
 		}
 		else {
-			g_free(rdrptr);
+			oh_rdr_free(rdrptr);
 		}
 	}
 	
@@ -255,7 +255,7 @@ SaErrorT snmp_bc_discover_controls(struct oh_handler_state *handle,
 	custom_handle = (struct snmp_bc_hnd *)handle->data;
 	
 	for (i=0; control_array[i].index != 0; i++) {
-		rdrptr = (SaHpiRdrT *)g_malloc0(sizeof(SaHpiRdrT));
+		rdrptr = oh_rdr_alloc();
 		if (rdrptr == NULL) {
 			err("Out of memory.");
 			return(SA_ERR_HPI_OUT_OF_MEMORY);
@@ -286,14 +286,14 @@ SaErrorT snmp_bc_discover_controls(struct oh_handler_state *handle,
 					 control_info_ptr, 0);
 			if (err) {
 				err("Cannot add RDR. Error=%s.", oh_lookup_error(err));
-				g_free(rdrptr);
+				oh_rdr_free(rdrptr);
 			}
 			else {
 				res_oh_event->rdrs = g_slist_append(res_oh_event->rdrs, rdrptr);
 			}
 		}
 		else {
-			g_free(rdrptr);
+			oh_rdr_free(rdrptr);
 		}
 	}
 	
@@ -327,7 +327,7 @@ SaErrorT snmp_bc_discover_inventories(struct oh_handler_state *handle,
 
 	/* Assumming OidManufacturer is defined and determines readable of other VPD */
 	for (i=0; inventory_array[i].inventory_info.hardware_mib.oid.OidManufacturer != NULL; i++) {
-		rdrptr = (SaHpiRdrT *)g_malloc0(sizeof(SaHpiRdrT));
+		rdrptr = oh_rdr_alloc();
 		if (rdrptr == NULL) {
 			err("Out of memory.");
 			return(SA_ERR_HPI_OUT_OF_MEMORY);
@@ -356,14 +356,14 @@ SaErrorT snmp_bc_discover_inventories(struct oh_handler_state *handle,
 					 inventory_info_ptr, 0);
 			if (err) {
 				err("Cannot add RDR. Error=%s.", oh_lookup_error(err));
-				g_free(rdrptr);
+				oh_rdr_free(rdrptr);
 			}
 			else {
 				res_oh_event->rdrs = g_slist_append(res_oh_event->rdrs, rdrptr);
 			}
 		}
 		else {
-			g_free(rdrptr);
+			oh_rdr_free(rdrptr);
 		}
 	}
 	
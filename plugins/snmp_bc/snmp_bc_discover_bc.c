@@ -3528,7 +3528,7 @@ static SaErrorT snmp_bc_discover_ipmi_sensors(struct oh_handler_state *handle,
 
 		if (mib_info) {
 
-			rdrptr = (SaHpiRdrT *)g_malloc0(sizeof(SaHpiRdrT));
+			rdrptr = oh_rdr_alloc();
 			if (rdrptr == NULL) {
 				err("Out of memory.");
 				rtn_code = SA_ERR_HPI_OUT_OF_MEMORY;
@@ -3549,7 +3549,7 @@ static SaErrorT snmp_bc_discover_ipmi_sensors(struct oh_handler_state *handle,
 			if (!sinfo) {
 				err("Out of memory.");
 				rtn_code = SA_ERR_HPI_OUT_OF_MEMORY;
-				g_free(rdrptr);
+				oh_rdr_free(rdrptr);
 				goto CLEANUP;
 			}
 
@@ -3562,7 +3562,7 @@ static SaErrorT snmp_bc_discover_ipmi_sensors(struct oh_handler_state *handle,
 					 sinfo, 0);
 			if (err) {
 				err("Cannot add RDR. Error=%s.", oh_lookup_error(err));
-				g_free(rdrptr);
+				oh_rdr_free(rdrptr);
 			}
 			else {
 				res_oh_event->rdrs = g_slist_append(res_oh_event->rdrs, rdrptr);
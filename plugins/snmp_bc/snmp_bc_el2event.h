@@ -26,24 +26,30 @@
 #define OVR_MM_PRIME  0x0000000010000000  /* Override Error Log's source - set resource to primary MM */
 
 typedef struct {
-        gchar *event;
+        const gchar        *event;
 	SaHpiSeverityT      event_sev;
 	unsigned long long  event_ovr;
         short               event_dup;
 } ErrLog2EventInfoT;
 
-/* Global "Error Log to Event" mapping hash table and usage count */
-extern GHashTable *errlog2event_hash;
-extern unsigned int errlog2event_hash_use_count;
-
-SaErrorT errlog2event_hash_init(struct snmp_bc_hnd *custom_handle);
-SaErrorT errlog2event_hash_free(void);
-
-/* XML event code and mapping structures */
-extern char *eventxml;
-
-struct errlog2event_hash_info {
-	GHashTable *hashtable;
-};
+typedef struct {
+        const gchar        *msg;
+        ErrLog2EventInfoT   info;
+} ErrLog2EventEntryT;
+
+/* Read-only "Error Log to Event" mapping table shared by all handlers.
+ * Generated from snmp_bc_event.map by eventmap2code.pl as a minimal
+ * perfect hash keyed by the Error Log message; use errlog2event_lookup() */
+extern const ErrLog2EventEntryT errlog2event_table[];
+extern const unsigned int errlog2event_table_size;
+extern const int errlog2event_disp[];
+
+const ErrLog2EventInfoT *errlog2event_lookup(const gchar *msg);
+
+SaErrorT errlog2event_search_str(const gchar *text,
+				 gchar *search_str,
+				 gsize size,
+				 SaHpiBoolT *is_recovery,
+				 SaHpiBoolT *is_threshold);
 
 #endif
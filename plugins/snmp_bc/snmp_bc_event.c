@@ -45,8 +45,8 @@ static SaErrorT snmp_bc_map2oem(SaHpiEventT *event,
 				sel_entry *sel_entry,
 				OEMReasonCodeT reason);
 
-static ErrLog2EventInfoT *snmp_bc_findevent4dupstr(gchar *search_str,
-						     ErrLog2EventInfoT *dupstrhash_data,
+static const ErrLog2EventInfoT *snmp_bc_findevent4dupstr(gchar *search_str,
+							   const ErrLog2EventInfoT *dupstrhash_data,
 						     LogSource2ResourceT *logsrc2res);
 /**
  * event2hpi_hash_init:
@@ -359,7 +359,6 @@ SaErrorT snmp_bc_log2event(struct oh_handler_state *handle,
 			   LogSource2ResourceT *ret_logsrc2res)
 {
 	sel_entry           log_entry;
-	gchar               *recovery_str, *login_str, *post_str;
 	gchar               root_str[SNMP_BC_MAX_SEL_ENTRY_LENGTH];
 	gchar               search_str[SNMP_BC_MAX_SEL_ENTRY_LENGTH];
 	EventMapInfoT       *eventmap_info;
@@ -371,7 +370,7 @@ SaErrorT snmp_bc_log2event(struct oh_handler_state *handle,
 	SaHpiSeverityT      event_severity;
 	SaHpiTextBufferT    thresh_read_value, thresh_trigger_value;
 	SaHpiTimeT          event_time;
-	ErrLog2EventInfoT   *strhash_data;
+	const ErrLog2EventInfoT *strhash_data;
         struct snmp_bc_hnd *custom_handle;
 	int dupovrovr;
 	struct oh_event *e;
@@ -406,60 +405,16 @@ SaErrorT snmp_bc_log2event(struct oh_handler_state *handle,
          * string, since its what mapped in the event hash table.
          **********************************************************************/
 
-	/* Set default search string */
-	strncpy(search_str, log_entry.text, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
-
-	/* Discover "recovery" event strings */
-	recovery_str = strstr(search_str, EVT_RECOVERY);
-	if (recovery_str && (recovery_str == search_str)) {
-		is_recovery_event = SAHPI_TRUE;
-		memset(search_str, 0, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
-		strncpy(search_str, (log_entry.text + strlen(EVT_RECOVERY)),
-			SNMP_BC_MAX_SEL_ENTRY_LENGTH - strlen(EVT_RECOVERY));
-	}
-
-	/* Adjust "login" event strings - strip username */
-	login_str = strstr(log_entry.text, LOG_LOGIN_STRING);
-	if (login_str) {
-		gchar *id_str = strstr(log_entry.text, LOG_LOGIN_CHAR);
-		if (id_str != NULL) {
-			memset(search_str, 0, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
-			strncpy(search_str, log_entry.text, (id_str - log_entry.text));
-			search_str[(id_str - log_entry.text)] = '\0';
-		}
-	}
-
-	/* Adjust "POST" event strings - strip post results */
-	post_str = strstr(log_entry.text, LOG_POST_STRING);
-	if (post_str) {
-		memset(search_str, 0, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
-		strncpy(search_str, log_entry.text, (post_str - log_entry.text));
-		search_str[(post_str - log_entry.text - 1)] = '\0';
-	}
-
-        /* Replace internal double blanks with a single blank */
-	{
-		gchar *double_blanks;
-		double_blanks = strstr(log_entry.text, "  ");
-		if (double_blanks) {
-			gchar *tmp_str;
-			int len;
-			tmp_str = log_entry.text;
-			memset(search_str, 0, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
-			do {
-				strncat(search_str, tmp_str, (double_blanks - tmp_str));
-				tmp_str = double_blanks + 1;
-				len = strlen(tmp_str);
-				double_blanks = strstr(tmp_str, "  ");
-			} while (double_blanks);
-			strncat(search_str, tmp_str, len);
-		}
+	/* Strip "recovery", "login", "POST" and double blank decorations */
+	err = errlog2event_search_str(log_entry.text, search_str, SNMP_BC_MAX_SEL_ENTRY_LENGTH,
+				      &is_recovery_event, &is_threshold_event);
+	if (err) {
+		err("Cannot derive search string for log string=%s.", log_entry.text);
+		return(err);
 	}
 
 	/* Adjust "threshold" event strings */
-	if (strstr(log_entry.text, LOG_THRESHOLD_VALUE_STRING) ||
-	    strstr(log_entry.text, LOG_THRESHOLD_STRING)) {
-		is_threshold_event = SAHPI_TRUE;
+	if (is_threshold_event) {
 		oh_init_textbuffer(&thresh_read_value);
 		oh_init_textbuffer(&thresh_trigger_value);
 		err = snmp_bc_parse_threshold_str(search_str, root_str,
@@ -473,22 +428,24 @@ SaErrorT snmp_bc_log2event(struct oh_handler_state *handle,
 		}
 	}
 
-	/* Strip any leading/trailing blanks */
+	/* Strip any leading/trailing blanks and any trailing period */
 	{
 		gchar *tmp_str;
-		tmp_str = g_strstrip(g_strdup(search_str));
-		strncpy(search_str, tmp_str, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
-		g_free(tmp_str);
-		if ((search_str == NULL || search_str[0] == '\0')) {
+		gsize len;
+
+		for (tmp_str = search_str; g_ascii_isspace(*tmp_str); tmp_str++);
+		len = strlen(tmp_str);
+		while (len > 0 && g_ascii_isspace(tmp_str[len - 1])) len--;
+		if (len == 0) {
 			err("Search string is NULL for log string=%s", log_entry.text);
 			return(SA_ERR_HPI_INTERNAL_ERROR);
 		}
+		memmove(search_str, tmp_str, len);
+		search_str[len] = '\0';
+		if (search_str[len - 1] == '.')
+			search_str[len - 1] = '\0';
 	}
 
-	/* Strip any trailing period */
-	if (search_str[strlen(search_str) - 1] == '.')
-		search_str[strlen(search_str) - 1] = '\0';
-
 	dbg("Event search string=%s", search_str);
 
 	/* Set dynamic event fields with default values from the log string.
@@ -505,9 +462,9 @@ SaErrorT snmp_bc_log2event(struct oh_handler_state *handle,
 	event_rid = logsrc2res.rid;
 
 	/***********************************************************
-	 * See if adjusted root string is in errlog2event_hash table
+	 * See if adjusted root string is in errlog2event_table
          ***********************************************************/
-	strhash_data = (ErrLog2EventInfoT *)g_hash_table_lookup(errlog2event_hash, search_str);
+	strhash_data = errlog2event_lookup(search_str);
 	if (!strhash_data) {
 		if (snmp_bc_map2oem(&working, &log_entry, EVENT_NOT_ALERTABLE)) {
 			err("Cannot map to OEM Event %s.", log_entry.text);
@@ -804,10 +761,10 @@ RESUME_TO_EXIT:
  * information. A NULL is returned if the information cannot be found.
  * 
  * There are several identical Error Log messages strings that are shared by
- * multiple resources. The scripts that populate errlog2event_hash
+ * multiple resources. The scripts that generate errlog2event_table
  * create unique entries for these duplicate strings by tacking on
  * an unique string (HPIDUP_duplicate_number) to the error log message.
- * This is then stored in errlog2event_hash. So there is a unique mapping
+ * This is then stored in errlog2event_table. So there is a unique mapping
  * for each resource with a duplicate string.
  * 
  * This routine goes finds the unique mapping for all the duplicate strings.
@@ -820,12 +777,12 @@ RESUME_TO_EXIT:
  * SA_OK - Normal case.
  * SA_ERR_HPI_INVALID_PARAMS - Parameter pointer(s) are NULL.
  **/
-static ErrLog2EventInfoT *snmp_bc_findevent4dupstr(gchar *search_str,
-						   ErrLog2EventInfoT *strhash_data,
+static const ErrLog2EventInfoT *snmp_bc_findevent4dupstr(gchar *search_str,
+							 const ErrLog2EventInfoT *strhash_data,
 						   LogSource2ResourceT *logsrc2res)
 {	
 	gchar dupstr[SNMP_BC_MAX_SEL_ENTRY_LENGTH];
-	ErrLog2EventInfoT *dupstr_hash_data;
+	const ErrLog2EventInfoT *dupstr_hash_data;
 	short strnum;
 
 	if (!search_str || !strhash_data || !logsrc2res) {
@@ -877,7 +834,7 @@ static ErrLog2EventInfoT *snmp_bc_findevent4dupstr(gchar *search_str,
 			strncpy(dupstr, tmpstr, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
 			g_free(tmpstr);
 
-			dupstr_hash_data = (ErrLog2EventInfoT *)g_hash_table_lookup(errlog2event_hash, dupstr);
+			dupstr_hash_data = errlog2event_lookup(dupstr);
 			if (dupstr_hash_data == NULL) {
 				err("Cannot find duplicate string=%s.", dupstr);
 			}
@@ -897,7 +854,7 @@ static ErrLog2EventInfoT *snmp_bc_findevent4dupstr(gchar *search_str,
  * Parses a Error Log threshold string into its root string, read, 
  * and trigger value strings.
  * 
- * Format is a root string (in the errlog2event_hash table) followed by a
+ * Format is a root string (in the errlog2event_table) followed by a
  * read threshold value string, followed by a trigger threshold value string.
  * Unfortunately cannot convert directly to sensor values yet because 
  * don't yet know if event is in the event2hpi_hash table or if it is, 
@@ -236,54 +236,141 @@ SaErrorT snmp_bc_get_sel_entry(void *hnd,
 
 
 /**
- * snmp_bc_bulk_selcache
+ * snmp_bc_sel_entry_oid:
+ * @custom_handle: Pointer to handler's custom data.
+ * @current: Hardware Event Log index, 1 is the newest entry.
+ * @oid: Location to store the OID of the entry.
+ *
+ * Builds the OID of a hardware Event Log entry.
+ **/
+static void snmp_bc_sel_entry_oid(struct snmp_bc_hnd *custom_handle,
+				  int current,
+				  char *oid)
+{
+	if (custom_handle->platform == SNMP_BC_PLATFORM_RSA) {
+		snprintf(oid, SNMP_BC_MAX_OID_LENGTH, "%s.%d",
+			 SNMP_BC_SEL_ENTRY_OID_RSA, current);
+	}
+	else {
+		snprintf(oid, SNMP_BC_MAX_OID_LENGTH, "%s.%d",
+			 SNMP_BC_SEL_ENTRY_OID, current);
+	}
+}
+
+/**
+ * snmp_bc_sel_is_newest:
  * @handle: Pointer to handler's data.
- * @id: Resource ID that owns the Event Log. 
- * 
- * Builds internal event log cache using SNMP_MSG_GETBULK.
- * 
+ * @logstr: Hardware log string.
+ * @newest: Newest elcache entry, may be NULL.
+ *
+ * Checks whether @logstr is the hardware entry that @newest was built from.
+ * Entries logged within the same second share a timestamp, so the hash of
+ * the log string saved when @newest was added is compared first. The
+ * timestamp alone is used when no hash is known.
+ *
  * Return values:
- * SA_OK - normal case.
- * SA_ERR_HPI_INVALID_PARAMS - @handle is NULL.
+ * SAHPI_TRUE - @logstr matches @newest.
+ * SAHPI_FALSE - otherwise.
  **/
+static SaHpiBoolT snmp_bc_sel_is_newest(struct oh_handler_state *handle,
+					char *logstr,
+					const oh_el_entry *newest)
+{
+	sel_entry sel_entry;
+	struct snmp_bc_hnd *custom_handle;
+
+	if (newest == NULL) return(SAHPI_FALSE);
+
+	custom_handle = (struct snmp_bc_hnd *)handle->data;
+	if (custom_handle->sel_newest_valid &&
+	    custom_handle->sel_newest_hash != g_str_hash(logstr))
+		return(SAHPI_FALSE);
+
+	if (snmp_bc_parse_sel_entry(handle, logstr, &sel_entry) != SA_OK)
+		return(SAHPI_FALSE);
+
+	if (newest->event.Event.Timestamp != (SaHpiTimeT)mktime(&sel_entry.time) * 1000000000)
+		return(SAHPI_FALSE);
 
-SaErrorT snmp_bc_bulk_selcache(	struct oh_handler_state *handle,
-				SaHpiResourceIdT id)
+	return(SAHPI_TRUE);
+}
+
+/**
+ * snmp_bc_sel_fetch:
+ * @handle: Pointer to handler's data.
+ * @first: Hardware Event Log index to start at, 1 is the newest entry.
+ * @newest: Newest elcache entry to stop at, NULL to read the whole log.
+ * @max: Maximum number of entries to read, 0 for no limit.
+ * @sync_log: Location of the list the log strings are prepended to.
+ * @found: Location to store whether @newest was seen.
+ *
+ * Reads the hardware Event Log, newest entry first, until the entry
+ * matching @newest, the end of the log or @max entries. If user has
+ * configured for snmpV3, then GETBULK is used for performance. Else,
+ * individual GETs are used. Since the log strings are prepended,
+ * @sync_log ends up with the oldest entry first.
+ *
+ * Return values:
+ * SA_OK - normal case.
+ * SA_ERR_HPI_INVALID_PARAMS - @handle, @sync_log or @found is NULL.
+ **/
+static SaErrorT snmp_bc_sel_fetch(struct oh_handler_state *handle,
+				  int first,
+				  const oh_el_entry *newest,
+				  guint max,
+				  GList **sync_log,
+				  SaHpiBoolT *found)
 {
         struct snmp_bc_hnd *custom_handle;
 	SaErrorT 	err;
-	int 		isdst;
-	sel_entry 	sel_entry;
-        SaHpiEventT 	tmpevent;
-    	netsnmp_pdu	*pdu, *response;
+        struct snmp_value get_value;
+    	netsnmp_pdu	*response;
     	netsnmp_variable_list *vars;
-	LogSource2ResourceT logsrc2res;
-	int             count;
+	int             current;
+	guint           count;
     	int             running;
     	int             status;
 	char 		logstring[MAX_ASN_STR_LEN];
-    	char 		objoid[SNMP_BC_MAX_OID_LENGTH];	
+    	char 		objoid[SNMP_BC_MAX_OID_LENGTH];
     	oid             name[MAX_OID_LEN];
 	oid             root[MAX_OID_LEN];
     	size_t          rootlen;
-    	size_t          name_length;	
+    	size_t          name_length;
 	size_t 		str_len;
-    	int             reps;
 
-	if (!handle) {
+	if (!handle || !sync_log || !found) {
 		err("Invalid parameter.");
 		return(SA_ERR_HPI_INVALID_PARAMS);
 	}
-		
-	str_len = MAX_ASN_STR_LEN;
-	isdst=0;
+
 	custom_handle = (struct snmp_bc_hnd *)handle->data;
-	reps = custom_handle->count_per_getbulk;
-	
+	*found = SAHPI_FALSE;
+	count = 0;
+
+	if ((custom_handle->session.version != SNMP_VERSION_3) ||
+				(custom_handle->count_per_getbulk == 0))
+	{
+		for (current = first; (max == 0) || (count < max); current++) {
+			snmp_bc_sel_entry_oid(custom_handle, current, objoid);
+			err = snmp_bc_snmp_get(custom_handle, objoid, &get_value, SAHPI_TRUE);
+			if ((err != SA_OK) || (get_value.type != ASN_OCTET_STR)) {
+				dbg("End of BladeCenter log reached.");
+				break;
+			}
+
+			if (snmp_bc_sel_is_newest(handle, get_value.string, newest)) {
+				*found = SAHPI_TRUE;
+				break;
+			}
+			*sync_log = g_list_prepend(*sync_log, g_strdup(get_value.string));
+			count++;
+		}
+		return(SA_OK);
+	}
+
 	/* --------------------------------------------------- */
      	/* Set initial Event Log Entry OID and root tree       */
      	/* --------------------------------------------------- */
-
 	if (custom_handle->platform == SNMP_BC_PLATFORM_RSA) {
 		snprintf(objoid, SNMP_BC_MAX_OID_LENGTH, "%s", SNMP_BC_SEL_ENTRY_OID_RSA);
 	} else {
@@ -293,136 +380,258 @@ SaErrorT snmp_bc_bulk_selcache(	struct oh_handler_state *handle,
         read_objid(objoid, root, &rootlen);
 
 	/* --------------------------------------------------- */
-     	/* Object ID for GETBULK request                       */ 
+	/* GETBULK returns the entries after the given OID,    */
+	/* so start at the entry preceding @first              */
 	/* --------------------------------------------------- */
     	g_memmove(name, root, rootlen * sizeof(oid));
     	name_length = rootlen;
+	if (first > 1) name[name_length++] = first - 1;
 
     	running = 1;
-
     	while (running) {
-    
-       		/* --------------------------------------------------- */
-         	/* Create PDU for GETBULK request                      */ 
-         	/* --------------------------------------------------- */
-        	pdu = snmp_pdu_create(SNMP_MSG_GETBULK);
-
+		response = NULL;
 		status = snmp_getn_bulk(custom_handle->sessp,
 					 name,
 					 name_length,
-					 pdu, 
+					 NULL,
 					 &response,
-					 reps);
-					 
-		if (pdu) snmp_free_pdu(pdu);
-					 	
-        	if (status == STAT_SUCCESS) {
-            		if (response->errstat == SNMP_ERR_NOERROR) {
-	                	for (vars = response->variables; vars;
-                     			vars = vars->next_variable) {
-	
-				 	/* ------------------------------------------------- */
-				 	/* Check if this variable is of the same OID tree    */
-				 	/* ------------------------------------------------- */
-                    			if ((vars->name_length < rootlen)
-                        			|| (memcmp(root, vars->name, rootlen * sizeof(oid)) != 0))
-                            		{
-						/* Exit vars processing */
-                        			running = 0;
-                        			continue;
-                    			}  			
-		  
-                    			if ((vars->type != SNMP_ENDOFMIBVIEW) &&
-                        			(vars->type != SNMP_NOSUCHOBJECT) &&
-                        			(vars->type != SNMP_NOSUCHINSTANCE)) {
-                        
-                        			if (snmp_oid_compare(name, name_length,
-                                                			vars->name,
-									vars->name_length) >= 0) {
-                            				fprintf(stderr, "Error: OID not increasing: ");
-                            				fprint_objid(stderr, name, name_length);
-                            				fprintf(stderr, " >= ");
-                            				fprint_objid(stderr, vars->name,
-                                        					 vars->name_length);
-                            				fprintf(stderr, "\n");
-                            				running = 0;
-                        			}
-			                        /* ---------------------------------- */
-                         			/* Check if last variable,            */
-						/* and if so, save for next request.  */ 
-                         			/* ---------------------------------- */
-                        			if (vars->next_variable == NULL) {
-                            				g_memmove(name, vars->name,
-                                    			vars->name_length * sizeof(oid));
-                            				name_length = vars->name_length;
-                        			}
-						
-						/* ---------------------------------- */
-				 		/* ---------------------------------- */ 
-				 		/* ---------------------------------- */
-						if ((running == 1) && (vars->type == ASN_OCTET_STR)) {
-						
-                        				if (vars->val_len < MAX_ASN_STR_LEN) str_len = vars->val_len;
-							else str_len = MAX_ASN_STR_LEN;
-						
-							/* ---------------------------------- */
-				 			/* Guarantee NULL terminated string   */
-				 			/* ---------------------------------- */
-                        				// memcpy(logstring, vars->val.string, str_len);
-							g_memmove(logstring, vars->val.string, str_len);
-							logstring[str_len] = '\0';
-							
-							
-							err = snmp_bc_parse_sel_entry(handle,logstring, &sel_entry);
-							isdst = sel_entry.time.tm_isdst;
-							snmp_bc_log2event(handle, logstring, &tmpevent, isdst, &logsrc2res);
-							err = oh_el_prepend(handle->elcache, &tmpevent, NULL, NULL);
-							if (custom_handle->isFirstDiscovery == SAHPI_FALSE)
-		             					err = snmp_bc_add_to_eventq(handle, &tmpevent, SAHPI_TRUE);
-						}
-                    			} else {
-                        			/* Stop on an exception value */
-                        			running = 0;
-                    			}
-                		}  /* end for */
-              		} else {   /* if (response->errstat != SNMP_ERR_NOERROR) */
-			
-                		/* --------------------------------------------- */
-				/* Error condition is seen in response,          */
-                 		/* for now, print the error then exit            */ 
-                 		/* Not sure what to do for recovery              */
-                		running = 0;
-                		if (response->errstat == SNMP_ERR_NOSUCHNAME) {
-                    				printf("End of MIB\n");
-                		} else {
-                    			fprintf(stderr, "Error in packet.\nReason: %s\n",
-                            				snmp_errstring(response->errstat));
-                    		if (response->errindex != 0) {
-                        		fprintf(stderr, "Failed object: ");
-                        		for (count = 1, vars = response->variables;
-                             				vars && count != response->errindex;
-                             				vars = vars->next_variable, count++)
-                        			if (vars)
-                            				fprint_objid(stderr, vars->name,
-                                         				vars->name_length);
-                        			fprintf(stderr, "\n");
-                    			}
-                		}
-            		}  
-		} else if (status == STAT_TIMEOUT) {            
-            		fprintf(stderr, "Timeout: No Response\n");
-            		running = 0;
-        	} else {                /* status == STAT_ERROR */
-            		snmp_sess_perror("snmp_bulk_sel",custom_handle->sessp );
-            		running = 0;
-        	}
+					 custom_handle->count_per_getbulk);
+
+        	if ((status != STAT_SUCCESS) || (response == NULL)) {
+			if (status == STAT_TIMEOUT)
+				err("Timeout: No Response\n");
+			else
+				snmp_sess_perror("snmp_bulk_sel", custom_handle->sessp);
+			running = 0;
+		} else if (response->errstat != SNMP_ERR_NOERROR) {
+			if (response->errstat != SNMP_ERR_NOSUCHNAME)
+				err("Error in packet. Reason: %s\n",
+				    snmp_errstring(response->errstat));
+			running = 0;
+		}
+
+		for (vars = (running ? response->variables : NULL); vars && running;
+		     vars = vars->next_variable) {
+
+			/* ------------------------------------------------- */
+			/* Stop when leaving the Event Log OID tree, on an   */
+			/* exception value or if the OID is not increasing   */
+			/* ------------------------------------------------- */
+			if ((vars->name_length < rootlen) ||
+			    (memcmp(root, vars->name, rootlen * sizeof(oid)) != 0) ||
+			    (vars->type == SNMP_ENDOFMIBVIEW) ||
+			    (vars->type == SNMP_NOSUCHOBJECT) ||
+			    (vars->type == SNMP_NOSUCHINSTANCE) ||
+			    (snmp_oid_compare(name, name_length,
+					      vars->name, vars->name_length) >= 0)) {
+				running = 0;
+				break;
+			}
+
+			g_memmove(name, vars->name, vars->name_length * sizeof(oid));
+			name_length = vars->name_length;
+
+			if (vars->type != ASN_OCTET_STR) continue;
+
+			/* ---------------------------------- */
+			/* Guarantee NULL terminated string   */
+			/* ---------------------------------- */
+			if (vars->val_len < MAX_ASN_STR_LEN) str_len = vars->val_len;
+			else str_len = MAX_ASN_STR_LEN - 1;
+			g_memmove(logstring, vars->val.string, str_len);
+			logstring[str_len] = '\0';
+
+			if (snmp_bc_sel_is_newest(handle, logstring, newest)) {
+				*found = SAHPI_TRUE;
+				running = 0;
+				break;
+			}
+			*sync_log = g_list_prepend(*sync_log, g_strdup(logstring));
+			count++;
+			if ((max != 0) && (count >= max)) running = 0;
+		}
 
         	if (response)
             		snmp_free_pdu(response);
     	}
+
+	return(SA_OK);
+}
+
+/**
+ * snmp_bc_sel_event_rdr:
+ * @handle: Pointer to handler's data.
+ * @tmpevent: Event built from a hardware log entry.
+ * @rdr: Location to build the RDR of events without one.
+ * @rdr_ptr: Location to store the RDR to log the event with.
+ *
+ * Finds the RDR an Event Log entry refers to. See feature 1077241.
+ *
+ * Return values:
+ * SA_OK - normal operation.
+ * SA_ERR_HPI_INTERNAL_ERROR - unrecognized event type.
+ **/
+static SaErrorT snmp_bc_sel_event_rdr(struct oh_handler_state *handle,
+				      SaHpiEventT *tmpevent,
+				      SaHpiRdrT *rdr,
+				      SaHpiRdrT **rdr_ptr)
+{
+	SaHpiEntryIdT rdrid;
+
+	*rdr_ptr = NULL;
+	switch (tmpevent->EventType) {
+		case SAHPI_ET_OEM:
+		case SAHPI_ET_HOTSWAP:
+		case SAHPI_ET_USER:
+                        memset(rdr, 0, sizeof(SaHpiRdrT));
+                                        /* There is no RDR associated to OEM event */
+                        rdr->RdrType = SAHPI_NO_RECORD;
+                                          /* Set RDR Type to SAHPI_NO_RECORD, spec B-01.01 */
+                                          /* It is redundant because SAHPI_NO_RECORD == 0  */
+                                          /* This code is here for clarity.                */
+                        *rdr_ptr = rdr;
+
+			break;		  
+		case SAHPI_ET_SENSOR:
+			rdrid = oh_get_rdr_uid(SAHPI_SENSOR_RDR,
+					    tmpevent->EventDataUnion.SensorEvent.SensorNum); 
+			*rdr_ptr = oh_get_rdr_by_id(handle->rptcache, tmpevent->Source, rdrid);
+			break;
+		case SAHPI_ET_WATCHDOG:
+			rdrid = oh_get_rdr_uid(SAHPI_WATCHDOG_RDR,
+					    tmpevent->EventDataUnion.WatchdogEvent.WatchdogNum);
+			*rdr_ptr = oh_get_rdr_by_id(handle->rptcache, tmpevent->Source, rdrid);
+			break;
+		default:
+			err("Unrecognized Event Type=%d.", tmpevent->EventType);
+			return(SA_ERR_HPI_INTERNAL_ERROR);
+			break;
+	} 
+
 	return(SA_OK);
 }
 
+/**
+ * snmp_bc_sel_add_logs:
+ * @handle: Pointer to handler's data.
+ * @sync_log: Hardware log strings, oldest first.
+ *
+ * Appends the hardware log entries to the elcache in a single batch. The
+ * events are added to the eventq only once the whole batch is in the
+ * elcache, see snmp_bc_add_entry_to_elcache(). Entries that cannot be
+ * parsed are skipped.
+ *
+ * Return values:
+ * SA_OK - normal operation.
+ * SA_ERR_HPI_INVALID_PARAMS - @handle is NULL.
+ **/
+static SaErrorT snmp_bc_sel_add_logs(struct oh_handler_state *handle,
+				     GList *sync_log)
+{
+	SaErrorT err;
+	sel_entry sel_entry;
+	LogSource2ResourceT logsrc2res;
+	SaHpiRdrT rdr, *rdr_ptr;
+	SaHpiRptEntryT *res;
+	oh_el_entry *entry;
+	GList *proc_log, *batch;
+	GArray *events;
+	char *newest_log;
+	guint i;
+	struct snmp_bc_hnd *custom_handle;
+
+	if (!handle) {
+		err("Invalid parameter.");
+		return(SA_ERR_HPI_INVALID_PARAMS);
+	}
+
+	custom_handle = (struct snmp_bc_hnd *)handle->data;
+	batch = NULL;
+	events = NULL;
+	newest_log = NULL;
+
+	for (proc_log = sync_log; proc_log; proc_log = g_list_next(proc_log)) {
+		if (snmp_bc_parse_sel_entry(handle, proc_log->data, &sel_entry) != SA_OK) {
+			err("Cannot parse Event Log entry.");
+			continue;
+		}
+
+		if (g_ascii_strncasecmp(proc_log->data, EVT_EN_LOG_FULL, sizeof(EVT_EN_LOG_FULL)) == 0 )
+			oh_el_overflowset(handle->elcache, SAHPI_TRUE);
+
+		entry = g_new0(oh_el_entry, 1);
+		snmp_bc_log2event(handle, proc_log->data, &entry->event.Event,
+				  sel_entry.time.tm_isdst, &logsrc2res);
+		if (snmp_bc_sel_event_rdr(handle, &entry->event.Event, &rdr, &rdr_ptr) != SA_OK) {
+			g_free(entry);
+			continue;
+		}
+
+		/* The elcache keeps its own copy of RES and RDR */
+		if (rdr_ptr) entry->rdr = *rdr_ptr;
+		res = oh_get_resource_by_id(handle->rptcache, entry->event.Event.Source);
+		if (res) entry->res = *res;
+		else dbg("Warning: NULL RPT for rid %d.", entry->event.Event.Source);
+
+		batch = g_list_prepend(batch, entry);
+		newest_log = proc_log->data;
+	}
+
+	if (batch == NULL) return(SA_OK);
+	batch = g_list_reverse(batch);
+
+	/* The elcache may wrap and free the oldest entries of the batch */
+	if (custom_handle->isFirstDiscovery == SAHPI_FALSE) {
+		events = g_array_sized_new(FALSE, FALSE, sizeof(SaHpiEventT),
+					   g_list_length(batch));
+		for (proc_log = batch; proc_log; proc_log = g_list_next(proc_log)) {
+			entry = (oh_el_entry *)proc_log->data;
+			g_array_append_val(events, entry->event.Event);
+		}
+	}
+
+	err = oh_el_append_batch(handle->elcache, batch);
+	if (err) {
+	 	err("Cannot add el entries to elcache. Error=%s.", oh_lookup_error(err));
+		for (proc_log = batch; proc_log; proc_log = g_list_next(proc_log))
+			g_free(proc_log->data);
+		g_list_free(batch);
+		if (events) g_array_free(events, TRUE);
+		return(err);
+	}
+
+	custom_handle->sel_newest_hash = g_str_hash(newest_log);
+	custom_handle->sel_newest_valid = SAHPI_TRUE;
+
+	if (events) {
+		for (i = 0; i < events->len; i++) {
+			err = snmp_bc_add_to_eventq(handle,
+						    &g_array_index(events, SaHpiEventT, i),
+						    SAHPI_FALSE);
+			if (err) 
+				err("Cannot add el entry to eventq. Error=%s.", oh_lookup_error(err));
+		}
+		g_array_free(events, TRUE);
+	}
+
+	return(SA_OK);
+}
+
+/**
+ * snmp_bc_sel_free_logs:
+ * @sync_log: Hardware log strings.
+ *
+ * Frees a list filled by snmp_bc_sel_fetch().
+ **/
+static void snmp_bc_sel_free_logs(GList *sync_log)
+{
+	GList *proc_log;
+
+	for (proc_log = sync_log; proc_log; proc_log = g_list_next(proc_log))
+		g_free(proc_log->data);
+	g_list_free(sync_log);
+}
+
 /**
  * snmp_bc_check_selcache:
  * @handle: Pointer to handler's data.
@@ -488,18 +697,13 @@ SaErrorT snmp_bc_selcache_sync(struct oh_handler_state *handle,
 {
 	SaHpiEventLogEntryIdT prev;
 	SaHpiEventLogEntryIdT next;
-        struct snmp_value get_value, *this_value;
-        sel_entry sel_entry;
+        struct snmp_value get_value;
         oh_el_entry *fetchentry, tmpentry;
-        SaHpiTimeT new_timestamp;
 	char oid[SNMP_BC_MAX_OID_LENGTH];
 	SaErrorT err;
-	int current, cacheupdate;
         struct snmp_bc_hnd *custom_handle;
-	int isdst;
-        SaHpiEventT tmpevent;
-	LogSource2ResourceT logsrc2res;
-	GList *sync_log, *proc_log;
+	SaHpiBoolT found;
+	GList *sync_log;
 
 	if (!handle) {
 		err("Invalid parameter.");
@@ -508,10 +712,8 @@ SaErrorT snmp_bc_selcache_sync(struct oh_handler_state *handle,
 
 	err = SA_OK;
 	sync_log = NULL;
-	proc_log = NULL;
 				
 	fetchentry = &tmpentry; 
-	cacheupdate = 0;
 	custom_handle = (struct snmp_bc_hnd *)handle->data;
 
 	err = oh_el_get(handle->elcache, SAHPI_NEWEST_ENTRY, &prev, &next, &fetchentry);
@@ -521,15 +723,9 @@ SaErrorT snmp_bc_selcache_sync(struct oh_handler_state *handle,
 		err = snmp_bc_build_selcache(handle, id);
 		return(err);
 	}
-				
-	current = 1;
-	if (custom_handle->platform == SNMP_BC_PLATFORM_RSA) {
-		snprintf(oid, SNMP_BC_MAX_OID_LENGTH, "%s.%d", SNMP_BC_SEL_ENTRY_OID_RSA, current);
-	}
-	else {
-		snprintf(oid, SNMP_BC_MAX_OID_LENGTH, "%s.%d", SNMP_BC_SEL_ENTRY_OID, current);
-	}
 
+	/* A single GET of the newest entry tells if anything was logged */
+	snmp_bc_sel_entry_oid(custom_handle, 1, oid);
        	err = snmp_bc_snmp_get(custom_handle, oid, &get_value, SAHPI_TRUE);
        	if (err) {
 		err("Error %s snmp_get latest BC Event Log.\n", oh_lookup_error(err));
@@ -543,98 +739,30 @@ SaErrorT snmp_bc_selcache_sync(struct oh_handler_state *handle,
 		return(err);
 	}
 
-	if (snmp_bc_parse_sel_entry(handle, get_value.string, &sel_entry) < 0) {
-		err("Cannot parse Event Log entry");
-		return(SA_ERR_HPI_INTERNAL_ERROR);
+	if (snmp_bc_sel_is_newest(handle, get_value.string, fetchentry)) {
+		dbg("EL Sync: there are no new entry indicated.\n");
+		return(SA_OK);
 	}
 
-	new_timestamp = (SaHpiTimeT)mktime(&sel_entry.time) * 1000000000;
-	if (fetchentry->event.Event.Timestamp != new_timestamp) {
-
-		this_value = g_memdup(&get_value, sizeof(get_value));
-		if (this_value != NULL) 
-			sync_log = g_list_prepend(sync_log, this_value);
-		while (1) {
-			current++;
-			if (custom_handle->platform == SNMP_BC_PLATFORM_RSA) {
-				snprintf(oid, SNMP_BC_MAX_OID_LENGTH, "%s.%d",
-					 SNMP_BC_SEL_ENTRY_OID_RSA, current);
-			}
-			else {
-				snprintf(oid, SNMP_BC_MAX_OID_LENGTH, "%s.%d",
-					 SNMP_BC_SEL_ENTRY_OID, current);
-			}
-			err = snmp_bc_snmp_get(custom_handle,oid,&get_value, SAHPI_TRUE);
-			if (err == SA_OK) {
-				if (snmp_bc_parse_sel_entry(handle, get_value.string, &sel_entry) < 0) {
-					err("Cannot parse SEL entry.");
-					err = SA_ERR_HPI_INTERNAL_ERROR;
-					goto out;
-				}
-				
-				if (fetchentry->event.Event.Timestamp == 
-				     (SaHpiTimeT)mktime(&sel_entry.time) * 1000000000) {
-					current--;
-					cacheupdate = 1;	
-					break;
-				} else {
-					this_value = g_memdup(&get_value, sizeof(struct snmp_value));
-					if (this_value != NULL) 
-						sync_log = g_list_prepend(sync_log, this_value);
-				}
-			} else {
-				dbg("End of BladeCenter log reached.");
-				break;
-			}
-		}
-		
-		
-		if (cacheupdate) {
-
-			proc_log = g_list_first(sync_log);
-			while(proc_log != NULL) {
-				this_value = (struct snmp_value *)proc_log->data;
-				err = snmp_bc_parse_sel_entry(handle,this_value->string, &sel_entry);
-				if (err != SA_OK) goto out;
+	/* Read only the new entries, up to the newest cached one */
+	sync_log = g_list_prepend(sync_log, g_strdup(get_value.string));
+	err = snmp_bc_sel_fetch(handle, 2, fetchentry, 0, &sync_log, &found);
+	if (err) goto out;
 		
-				if (g_ascii_strncasecmp(get_value.string, EVT_EN_LOG_FULL, sizeof(EVT_EN_LOG_FULL)) == 0 )
-						oh_el_overflowset(handle->elcache, SAHPI_TRUE);
-		 
-				isdst = sel_entry.time.tm_isdst;
-				snmp_bc_log2event(handle, this_value->string, &tmpevent, isdst, &logsrc2res);
-
-				/*  append to end-of-elcache and end-of-eventq   */
-				err = snmp_bc_add_entry_to_elcache(handle, &tmpevent, SAHPI_FALSE);
-				proc_log = g_list_next(proc_log);
-
-			}
-			
-		} else {
-			err = oh_el_clear(handle->elcache);
-			if (err != SA_OK)
-				err("Invalid elcache pointer or mode, err %s\n", oh_lookup_error(err));
-			err = snmp_bc_build_selcache(handle, id);
-			if ( (err == SA_ERR_HPI_OUT_OF_MEMORY) || (err == SA_ERR_HPI_INVALID_PARAMS)) {
-				/* either of these 2 errors prevent us from doing anything meaningful */
-				/* tell user about them                                               */
-				goto out;
-			}
-		}
+	if (found) {
+		/*  append to end-of-elcache and end-of-eventq   */
+		err = snmp_bc_sel_add_logs(handle, sync_log);
 	} else {
-		dbg("EL Sync: there are no new entry indicated.\n");
+		/* Newest cached entry is gone, e.g. the log was cleared */
+		err = oh_el_clear(handle->elcache);
+		if (err != SA_OK)
+			err("Invalid elcache pointer or mode, err %s\n", oh_lookup_error(err));
+		custom_handle->sel_newest_valid = SAHPI_FALSE;
+		err = snmp_bc_build_selcache(handle, id);
 	}
 	
 	out:
-	if (sync_log) {
-		proc_log = g_list_first(sync_log);
-		while (proc_log){
-			if ( (this_value = (struct snmp_value *) proc_log->data)) {
-				g_free(this_value);
-			}
-			proc_log = g_list_next(proc_log);
-		}
-		g_list_free(sync_log);
-	}
+	snmp_bc_sel_free_logs(sync_log);
 	return(err);
 
 }
@@ -655,8 +783,11 @@ SaErrorT snmp_bc_selcache_sync(struct oh_handler_state *handle,
  **/
 SaErrorT snmp_bc_build_selcache(struct oh_handler_state *handle, SaHpiResourceIdT id)
 {	
-	int i;
 	SaErrorT err;
+	SaHpiEventLogInfoT elinfo;
+	SaHpiBoolT found;
+	guint max;
+	GList *sync_log;
 	struct snmp_bc_hnd *custom_handle;
 	
 	if (!handle) {
@@ -665,16 +796,12 @@ SaErrorT snmp_bc_build_selcache(struct oh_handler_state *handle, SaHpiResourceId
 	}
 	
 	err = SA_OK;
+	sync_log = NULL;
 	custom_handle = (struct snmp_bc_hnd *)handle->data;
 
-	/* ------------------------------------------------------------------- */
-	/* If user has configured for snmpV3, then use GETBULK for performance */
-	/* Else, stay with individual GETs                                     */
-	/* ------------------------------------------------------------------- */   
 	if ((custom_handle->session.version == SNMP_VERSION_3) && 
 				(custom_handle->count_per_getbulk != 0))
 	{
-	
 		/* ------------------------------------------------- */
 		/*      DO NOT remove this trace statement!!!!       */
 		/* ------------------------------------------------- */		
@@ -689,29 +816,29 @@ SaErrorT snmp_bc_build_selcache(struct oh_handler_state *handle, SaHpiResourceId
 		dbg(">>>>>> bulk build selcache %p. count_per_getbulk %d\n", 
 		    handle,custom_handle->count_per_getbulk);
 		/* ------------------------------------------------- */
-				
-		err = snmp_bc_bulk_selcache(handle, id);
-	} else {
-		i = 1;
-		while(1) {
-			err = snmp_bc_sel_read_add(handle, id, i, SAHPI_TRUE);
-			if ( (err == SA_ERR_HPI_OUT_OF_MEMORY) || (err == SA_ERR_HPI_INVALID_PARAMS)) {
-				/* Either of these 2 errors prevent us from doing anything meaningful */
-				return(err);
-			} else if (err != SA_OK) {
-				/* other errors (mainly HPI_INTERNAL_ERROR or HPI_BUSY) means */
-				/* only this record has problem. record error then go to next */
-				err("Error, %s, encountered with EventLog entry %d\n", 
-				oh_lookup_error(err), i);
-				break;
-			}	
-			i++;
-		}
 	}
+
+	/* Read no more entries than the elcache can hold */
+	oh_el_info(handle->elcache, &elinfo);
+	max = 0;
+	if (elinfo.Size != OH_EL_MAX_SIZE) {
+		if (elinfo.Entries >= elinfo.Size) return(SA_OK);
+		max = elinfo.Size - elinfo.Entries;
+	}
+
+	err = snmp_bc_sel_fetch(handle, 1, NULL, max, &sync_log, &found);
+	if (err) return(err);
+
+	err = snmp_bc_sel_add_logs(handle, sync_log);
+	snmp_bc_sel_free_logs(sync_log);
+	if ( (err == SA_ERR_HPI_OUT_OF_MEMORY) || (err == SA_ERR_HPI_INVALID_PARAMS)) {
+		/* Either of these 2 errors prevent us from doing anything meaningful */
+		return(err);
+	}
+
 	return(SA_OK);
 }
 
-
 /**
  * snmp_bc_set_sel_time:
  * @hnd: Pointer to handler's data. 
@@ -866,7 +993,6 @@ SaErrorT snmp_bc_add_entry_to_elcache(struct oh_handler_state *handle,
 			       		SaHpiBoolT prepend)
 {
 
-	SaHpiEntryIdT rdrid;
 	SaHpiRdrT rdr, *rdr_ptr; 
 	struct snmp_bc_hnd *custom_handle;
 	SaHpiResourceIdT id;
@@ -878,39 +1004,10 @@ SaErrorT snmp_bc_add_entry_to_elcache(struct oh_handler_state *handle,
 		return(SA_ERR_HPI_INVALID_PARAMS);
 	}
 	
-	rdrid=0;
-	rdr_ptr=NULL;			
         custom_handle = (struct snmp_bc_hnd *)handle->data;
 			
-	/* See feature 1077241 */
-	switch (tmpevent->EventType) {
-		case SAHPI_ET_OEM:
-		case SAHPI_ET_HOTSWAP:
-		case SAHPI_ET_USER:
-                        memset(&rdr, 0, sizeof(SaHpiRdrT));
-                                        /* There is no RDR associated to OEM event */
-                        rdr.RdrType = SAHPI_NO_RECORD;
-                                          /* Set RDR Type to SAHPI_NO_RECORD, spec B-01.01 */
-                                          /* It is redundant because SAHPI_NO_RECORD == 0  */
-                                          /* This code is here for clarity.                */
-                        rdr_ptr = &rdr;
-
-			break;		  
-		case SAHPI_ET_SENSOR:
-			rdrid = oh_get_rdr_uid(SAHPI_SENSOR_RDR,
-					    tmpevent->EventDataUnion.SensorEvent.SensorNum); 
-			rdr_ptr = oh_get_rdr_by_id(handle->rptcache, tmpevent->Source, rdrid);
-			break;
-		case SAHPI_ET_WATCHDOG:
-			rdrid = oh_get_rdr_uid(SAHPI_WATCHDOG_RDR,
-					    tmpevent->EventDataUnion.WatchdogEvent.WatchdogNum);
-			rdr_ptr = oh_get_rdr_by_id(handle->rptcache, tmpevent->Source, rdrid);
-			break;
-		default:
-			err("Unrecognized Event Type=%d.", tmpevent->EventType);
-			return(SA_ERR_HPI_INTERNAL_ERROR);
-			break;
-	} 
+	err = snmp_bc_sel_event_rdr(handle, tmpevent, &rdr, &rdr_ptr);
+	if (err) return(err);
 	
 	
 	/* Since oh_el_append() does a copy of RES and RDR into it own data struct, */ 
@@ -1095,6 +1192,7 @@ SaErrorT snmp_bc_clear_sel(void *hnd, SaHpiResourceIdT id)
 		err("Cannot clear system Event Log. Error=%s.", oh_lookup_error(err));
 		return(err);
 	}
+	custom_handle->sel_newest_valid = SAHPI_FALSE;
 
 	set_value.type = ASN_INTEGER;
 	set_value.str_len = 1;
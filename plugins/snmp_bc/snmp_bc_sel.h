@@ -71,9 +71,6 @@ SaErrorT snmp_bc_sel_state_set(void      *hnd,
                 		SaHpiResourceIdT   id, 
                 		SaHpiBoolT         enable);
 
-SaErrorT snmp_bc_bulk_selcache(	struct oh_handler_state *handle,
-				SaHpiResourceIdT id);
-
 SaErrorT snmp_bc_add_entry_to_elcache(struct oh_handler_state *handle,
         				SaHpiEventT *tmpevent,
 			       		SaHpiBoolT prepend);
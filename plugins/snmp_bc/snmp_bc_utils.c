@@ -240,8 +240,8 @@ SaErrorT snmp_bc_copy_oh_event(struct oh_event *new_event, struct oh_event *old_
 	*new_event = *old_event;
 	new_event->rdrs = NULL;
 	for (node = old_event->rdrs; node; node = node->next) {
-		new_event->rdrs = g_slist_append(new_event->rdrs, g_memdup(node->data,
-							   sizeof(SaHpiRdrT)));
+		new_event->rdrs = g_slist_append(new_event->rdrs,
+						 oh_rdr_dup(node->data));
 	}
 
 	return(SA_OK);
@@ -261,7 +261,7 @@ struct oh_event *snmp_bc_alloc_oh_event()
 {
 	struct oh_event *e = NULL;
 
-	e = (struct oh_event *)g_malloc0(sizeof(struct oh_event));
+	e = oh_new_event();
 	if (e == NULL) return(e); 
 	
 	e->rdrs = NULL;
@@ -284,7 +284,8 @@ void snmp_bc_free_oh_event(struct oh_event *e)
 	if (!e) return;
 	
 	g_slist_free(e->rdrs);	
-	g_free(e);
+	e->rdrs = NULL;
+	oh_event_free(e, FALSE);
 	return;
 }
 
@@ -19,250 +19,236 @@
 
 #include <snmp_bc_plugin.h>
 
-GHashTable *errlog2event_hash = NULL;
 ohpi_bc_lock snmp_bc_plock = {
         .lock = G_STATIC_REC_MUTEX_INIT,
         .count = 0
 };
 
-unsigned int errlog2event_hash_use_count = 0;
+/**********************************************************************
+ * errlog2event_hash_key:
+ * @seed: Hash seed; 0 for the bucket, displacement for the slot.
+ * @str: Error Log message.
+ *
+ * 32 bit FNV-1a hash of @str with the offset basis xor'ed with @seed.
+ * Must match errlog2event_hash() in eventmap2code.pl, which lays out
+ * the generated errlog2event_table with it.
+ *
+ * Returns:
+ * Hash value.
+ **********************************************************************/
+static guint32 errlog2event_hash_key(guint32 seed, const gchar *str)
+{
+        const guchar *p;
+        guint32 h = 0x811c9dc5U ^ seed;
+
+        for (p = (const guchar *)str; *p != '\0'; p++) {
+                h ^= *p;
+                h *= 16777619U;
+        }
 
-static void free_hash_data(gpointer key, gpointer value, gpointer user_data);
-static void event_start_element(GMarkupParseContext *context,
-                                const gchar         *element_name,
-                                const gchar         **attribute_names,
-                                const gchar         **attribute_values,
-                                gpointer            user_data,
-                                GError              **error);
+        return(h);
+}
 
 /**********************************************************************
- * errlog2event_hash_init:
- * @custom_handle: Plugin's data pointer.
- * 
- * Initializes the Error Log to event translation hash table.
+ * errlog2event_lookup:
+ * @msg: Error Log message, including any _HPIDUP suffix.
+ *
+ * Finds the event mapping of an Error Log message. The message's bucket
+ * gives either the table slot directly (negative values) or the seed
+ * that hashes the message to its slot. As the table is a perfect hash
+ * of all known messages, the slot's message only needs to be compared
+ * to reject unknown ones.
  *
  * Returns:
- * SA_OK - Normal operation.
- * SA_ERR_HPI_OUT_OF_MEMORY - No memory to allocate hash table structures.
- * SA_ERR_HPI_INVALID_PARAMS - @custom_handle NULL
+ * Pointer to the read-only event mapping; NULL if @msg is not mapped.
  **********************************************************************/
-SaErrorT errlog2event_hash_init(struct snmp_bc_hnd *custom_handle) {
-        GMarkupParser parser;
-        GMarkupParseContext *pcontext;
-        gboolean rc;
-        GError *err;
-        struct errlog2event_hash_info user_data;
-        if (!custom_handle) {
-                err("Invalid parameter.");
-                return(SA_ERR_HPI_INVALID_PARAMS);
-        }
-	
-        err = NULL;
-        snmp_bc_lock(snmp_bc_plock);
-	/* Initialize hash table */
-        errlog2event_hash = g_hash_table_new(g_str_hash, g_str_equal);
-        if (errlog2event_hash == NULL) {
-                err("No memory.");
-                snmp_bc_unlock(snmp_bc_plock);
-                return(SA_ERR_HPI_OUT_OF_MEMORY);
-	}
-	
-	/* Initialize user data used in parsing XML events */
-	user_data.hashtable = errlog2event_hash;
+const ErrLog2EventInfoT *errlog2event_lookup(const gchar *msg)
+{
+        const ErrLog2EventEntryT *entry;
+        guint32 slot;
+        int disp;
 
-        /* Initialize XML parser */
-        memset(&parser, 0, sizeof(parser));
-        parser.start_element = event_start_element;
-        pcontext = g_markup_parse_context_new(&parser, 0, &user_data, NULL);
-        if (pcontext == NULL) {
-		err("No memory.");
-                snmp_bc_unlock(snmp_bc_plock);
-		return(SA_ERR_HPI_OUT_OF_MEMORY);
-        }
+        if (!msg) return(NULL);
 
-        /* Parse XML events */
-        rc = g_markup_parse_context_parse(pcontext,
-                                          (const gchar *)eventxml,
-                                          (gssize)strlen(eventxml), &err);
-        if (rc == FALSE || err != NULL) {
-                if (err != NULL) {
-                        err("Parse error=%s.", err->message);
-                        g_error_free(err);
-                }
-                else {
-                        err("Unknown XML parse error.");
-                }
-                g_markup_parse_context_free(pcontext);
-                snmp_bc_unlock(snmp_bc_plock);
-                return(SA_ERR_HPI_INTERNAL_ERROR);
+        disp = errlog2event_disp[errlog2event_hash_key(0, msg) % errlog2event_table_size];
+        if (disp < 0) {
+                slot = (guint32)(-disp - 1);
         }
-        g_markup_parse_context_end_parse(pcontext, &err);
-        g_markup_parse_context_free(pcontext);
-
-        /* Make sure there are elements in the hash table */
-        if (g_hash_table_size(errlog2event_hash) == 0) {
-                err("Hash table is empty.");
-                snmp_bc_unlock(snmp_bc_plock);
-                return(SA_ERR_HPI_INTERNAL_ERROR);
+        else {
+                slot = errlog2event_hash_key((guint32)disp, msg) % errlog2event_table_size;
         }
-        
-        snmp_bc_unlock(snmp_bc_plock);
-	return(SA_OK);
+
+        entry = &errlog2event_table[slot];
+        if (strcmp(entry->msg, msg) != 0) return(NULL);
+
+        return(&entry->info);
 }
 
+/* Markers searched for in the text of an Error Log entry */
+enum {
+        EL_MARK_RECOVERY = 0,
+        EL_MARK_LOGIN,
+        EL_MARK_LOGIN_CHAR,
+        EL_MARK_POST,
+        EL_MARK_DOUBLE_BLANK,
+        EL_MARK_THRESHOLD_VALUE,
+        EL_MARK_THRESHOLD,
+        EL_MARK_MAX
+};
+
+#define EL_DOUBLE_BLANK "  "
+
+/* Word-at-a-time byte search. EL_BYTES() sets the high bit of every
+ * byte of @w that equals @c and clears all other bits */
+#define EL_ONES          0x0101010101010101ULL
+#define EL_LOWS          0x7F7F7F7F7F7F7F7FULL
+#define EL_HIGHS         0x8080808080808080ULL
+#define EL_ZEROS(v)      (~((((v) & EL_LOWS) + EL_LOWS) | (v)) & EL_HIGHS)
+#define EL_BYTES(w, c)   EL_ZEROS((w) ^ (EL_ONES * (guchar)(c)))
+
+/* Records @str as marker @mark if it starts at @p and was not seen yet */
+#define EL_MATCH(mark, str) \
+        if (!(seen & (1 << (mark))) && *p == (str)[0] && \
+            strncmp(p, (str), sizeof(str) - 1) == 0) { \
+                first[mark] = p - text; \
+                seen |= (1 << (mark)); \
+        }
+
 /**********************************************************************
- * errlog2event_hash_free:
+ * el_match_at:
+ * @text: Text of an Error Log entry.
+ * @p: Position in @text.
+ * @seen: Bit mask of markers already found.
+ * @first: Positions of the markers already found.
  *
- * Frees Error Log to event translation hash table.
+ * Checks which markers, not yet found, start at @p. A leading
+ * "Recovery " is checked by the caller.
  *
  * Returns:
- * SA_OK - Normal operation.
+ * Updated @seen.
  **********************************************************************/
-SaErrorT errlog2event_hash_free()
+static inline guint el_match_at(const gchar *text, const gchar *p,
+                                guint seen, int *first)
 {
-        snmp_bc_lock(snmp_bc_plock);
-        g_hash_table_foreach(errlog2event_hash, free_hash_data, NULL);
-	g_hash_table_destroy(errlog2event_hash);
-        snmp_bc_unlock(snmp_bc_plock);
-	return(SA_OK);
+        EL_MATCH(EL_MARK_LOGIN, LOG_LOGIN_STRING);
+        EL_MATCH(EL_MARK_LOGIN_CHAR, LOG_LOGIN_CHAR);
+        EL_MATCH(EL_MARK_POST, LOG_POST_STRING);
+        EL_MATCH(EL_MARK_DOUBLE_BLANK, EL_DOUBLE_BLANK);
+        EL_MATCH(EL_MARK_THRESHOLD_VALUE, LOG_THRESHOLD_VALUE_STRING);
+        EL_MATCH(EL_MARK_THRESHOLD, LOG_THRESHOLD_STRING);
+
+        return(seen);
 }
 
-static void free_hash_data(gpointer key, gpointer value, gpointer user_data)
+/**********************************************************************
+ * errlog2event_search_str:
+ * @text: Text of an Error Log entry.
+ * @search_str: Location to store the root message of @text.
+ * @size: Size of @search_str.
+ * @is_recovery: Location to store if @text is a recovery event.
+ * @is_threshold: Location to store if @text is a threshold event.
+ *
+ * Derives the root message of an Error Log entry by stripping a leading
+ * "Recovery ", a login's user ID, POST results or double blanks. A single
+ * pass over @text copies it to @search_str and finds all markers, testing
+ * a word at a time for bytes that start a marker and comparing markers
+ * only there. Like the former chain of strstr() calls, the last
+ * applicable edit in the order above wins. Threshold values are left for the caller to
+ * parse and blanks for the caller to strip.
+ *
+ * Returns:
+ * SA_OK - Normal case.
+ * SA_ERR_HPI_INVALID_PARAMS - Pointer parameter(s) are NULL.
+ **********************************************************************/
+SaErrorT errlog2event_search_str(const gchar *text,
+				 gchar *search_str,
+				 gsize size,
+				 SaHpiBoolT *is_recovery,
+				 SaHpiBoolT *is_threshold)
 {
-	ErrLog2EventInfoT *xmlinfo;
-
-        g_free(key);
-        xmlinfo = (ErrLog2EventInfoT *)value;
-        g_free(xmlinfo->event);
-        g_free(value);
-}
+        int first[EL_MARK_MAX];
+        guint seen;
+        gsize len, i, n;
 
-/* Note: Error messages are passed back to the caller via the GError
- * mechanism. There is no need for err calls in this function. */
-static void event_start_element(GMarkupParseContext *context,
-                                const gchar         *element_name,
-                                const gchar         **attribute_names,
-                                const gchar         **attribute_values,
-                                gpointer            user_data,
-                                GError              **error)
-{
-        int i = 0;
-	gchar *key = NULL;
-        gint line, pos;
-	ErrLog2EventInfoT *xmlinfo, working;
-	struct errlog2event_hash_info *hash_info;
+        if (!text || !search_str || size == 0 || !is_recovery || !is_threshold) {
+                err("Invalid parameter.");
+                return(SA_ERR_HPI_INVALID_PARAMS);
+        }
 
-	memset(&working, 0, sizeof(ErrLog2EventInfoT));
-	hash_info = (struct errlog2event_hash_info *)user_data;
- 
-        /* Ignore all XML elements except the event tag */
-        if (g_ascii_strncasecmp(element_name, "event", sizeof("event")) != 0) {
-                /* This is normal - not an error condition! */
-                return;
+        seen = 0;
+        if (strncmp(text, EVT_RECOVERY, sizeof(EVT_RECOVERY) - 1) == 0) {
+                first[EL_MARK_RECOVERY] = 0;
+                seen |= (1 << EL_MARK_RECOVERY);
         }
 
-        /* Fetch XML element attributes and values. Build event info */
-        while (attribute_names[i] != NULL) {
-                if (g_ascii_strncasecmp(attribute_names[i], "name", sizeof("name")) == 0) {
-                        /* Don't use this attribute so ignore it */
-                }
-                else if (g_ascii_strncasecmp(attribute_names[i], "msg", sizeof("msg")) == 0) {
-                        key = g_strdup(attribute_values[i]);
-                        if (key == NULL) {
-                                g_set_error(error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE,
-                                            "No memory for hash key=%s", attribute_values[i]);
-                                return;
-                        }
-                }
-                else if (g_ascii_strncasecmp(attribute_names[i], "hex", sizeof("hex")) == 0) {
-                        working.event = g_strdup(attribute_values[i]);
-                        if (working.event == NULL) {
-                                g_set_error(error, G_MARKUP_ERROR, G_MARKUP_ERROR_PARSE,
-                                            "No memory for hash value=%s", attribute_values[i]);
-                                return;
-                        }
-                }
-                else if (g_ascii_strncasecmp(attribute_names[i], "severity", sizeof("severity")) == 0) {
-                        if (g_ascii_strncasecmp(attribute_values[i], "SAHPI_CRITICAL", sizeof("SAHPI_CRITICAL")) == 0) {
-                                working.event_sev = SAHPI_CRITICAL;
-                        }
-                        else if (g_ascii_strncasecmp(attribute_values[i], "SAHPI_MAJOR", sizeof("SAHPI_MAJOR")) == 0) {
-                                working.event_sev = SAHPI_MAJOR;
-                        }
-                        else if (g_ascii_strncasecmp(attribute_values[i], "SAHPI_MINOR", sizeof("SAHPI_MINOR")) == 0) {
-                                working.event_sev = SAHPI_MINOR;
-                        }
-                        else if (g_ascii_strncasecmp(attribute_values[i], "SAHPI_INFORMATIONAL", sizeof("SAHPI_INFORMATIONAL")) == 0) {
-                                working.event_sev = SAHPI_INFORMATIONAL;
-                        }
-                        else {
-                                g_markup_parse_context_get_position(context, &line, &pos);
-                                g_set_error(error, G_MARKUP_ERROR, G_MARKUP_ERROR_INVALID_CONTENT,
-                                            "Bad severity=%s for XML event element line %d", 
-					    attribute_values[i], line);
-                                return;
-                        }
+        /* Copy @text with double blanks squeezed, finding the first
+         * occurrence of every marker on the way. Only bytes that start
+         * a marker are compared; they are picked a word at a time */
+        len = strlen(text);
+        n = 0;
+        for (i = 0; i + sizeof(guint64) < len && n + sizeof(guint64) < size;
+             i += sizeof(guint64)) {
+                guint64 w, w_next, blanks, hits;
+                int k;
+
+                memcpy(&w, text + i, sizeof(w));
+                memcpy(&w_next, text + i + 1, sizeof(w_next));
+                w = GUINT64_FROM_LE(w);
+                w_next = GUINT64_FROM_LE(w_next);
+                blanks = EL_BYTES(w, EL_DOUBLE_BLANK[0]) &
+                         EL_BYTES(w_next, EL_DOUBLE_BLANK[1]);
+                hits = blanks |
+                       EL_BYTES(w, LOG_LOGIN_STRING[0]) |
+                       EL_BYTES(w, LOG_LOGIN_CHAR[0]) |
+                       EL_BYTES(w, LOG_POST_STRING[0]) |
+                       EL_BYTES(w, LOG_THRESHOLD_VALUE_STRING[0]) |
+                       EL_BYTES(w, LOG_THRESHOLD_STRING[0]);
+
+                if (!blanks) {
+                        memcpy(search_str + n, text + i, sizeof(guint64));
+                        n += sizeof(guint64);
                 }
-                else if (g_ascii_strncasecmp(attribute_names[i], "override", sizeof("override")) == 0) {
-                        working.event_ovr |= NO_OVR;
-                        if (strstr(attribute_values[i], "OVR_SEV") != NULL) {
-                                working.event_ovr |= OVR_SEV;
-                        }
-                        if (strstr(attribute_values[i], "OVR_RID") != NULL) {
-                                working.event_ovr |= OVR_RID;
-                        }
-                        if (strstr(attribute_values[i], "OVR_EXP") != NULL) {
-                                working.event_ovr |= OVR_EXP;
-                        }
-                        if (strstr(attribute_values[i], "OVR_VMM") != NULL) {
-                                working.event_ovr |= OVR_VMM;
-                        }
-                        if (strstr(attribute_values[i], "OVR_MM1") != NULL) {
-                                working.event_ovr |= OVR_MM1;
-                        }
-                        if (strstr(attribute_values[i], "OVR_MM2") != NULL) {
-                                working.event_ovr |= OVR_MM2;
-                        }
-                        if (strstr(attribute_values[i], "OVR_MM_STBY") != NULL) {
-                                working.event_ovr |= OVR_MM_STBY;
-                        }
-                        if (strstr(attribute_values[i], "OVR_MM_PRIME") != NULL) {
-                                working.event_ovr |= OVR_MM_PRIME;
+                else {
+                        for (k = 0; k < (int)sizeof(guint64); k++, blanks >>= 8) {
+                                if (!(blanks & 0x80)) search_str[n++] = text[i + k];
                         }
-                        /* Ignore any other values */
-                }
-                else if (g_ascii_strncasecmp(attribute_names[i], "dup", sizeof("dup")) == 0) {
-                        working.event_dup = (short)atoi(attribute_values[i]);
                 }
-                else {
-                        g_markup_parse_context_get_position(context, &line, &pos);
-                        g_set_error(error, G_MARKUP_ERROR, G_MARKUP_ERROR_UNKNOWN_ATTRIBUTE,
-                                    "Bad name for XML event element line %d", line);
-                        return;
+
+                for (k = 0; hits; k++, hits >>= 8) {
+                        if (hits & 0x80)
+                                seen = el_match_at(text, text + i + k, seen, first);
                 }
-                i++;
         }
-
-	/* Check for valid key */
-        if (key == NULL) {
-                g_set_error(error, G_MARKUP_ERROR, G_MARKUP_ERROR_INVALID_CONTENT,
-                            "No key set from XML event element");
-                return;
+        for (; i < len; i++) {
+                seen = el_match_at(text, text + i, seen, first);
+                if (n < size - 1 && !(text[i] == ' ' && text[i + 1] == ' '))
+                        search_str[n++] = text[i];
         }
+        search_str[n] = '\0';
+
+        *is_recovery = (seen & (1 << EL_MARK_RECOVERY)) ? SAHPI_TRUE : SAHPI_FALSE;
+        *is_threshold = (seen & ((1 << EL_MARK_THRESHOLD_VALUE) |
+                                 (1 << EL_MARK_THRESHOLD))) ? SAHPI_TRUE : SAHPI_FALSE;
 
-        /* Malloc memory for hash value and set values */
-        xmlinfo = g_malloc0(sizeof(ErrLog2EventInfoT));
-        if (!xmlinfo) {
-                g_set_error(error, G_MARKUP_ERROR,G_MARKUP_ERROR_PARSE,
-                            "No memory for hash value");
-                return;
+        /* Without double blanks the copy equals @text, so the other
+         * edits only need to cut it */
+        if (seen & (1 << EL_MARK_DOUBLE_BLANK)) {
+                /* Double blanks replaced with a single blank */
+        }
+        else if (seen & (1 << EL_MARK_POST)) {
+                /* Strip post results */
+                i = (first[EL_MARK_POST] > 0) ? first[EL_MARK_POST] - 1 : 0;
+                if (i < n) search_str[i] = '\0';
+        }
+        else if ((seen & (1 << EL_MARK_LOGIN)) && (seen & (1 << EL_MARK_LOGIN_CHAR))) {
+                /* Strip username */
+                i = first[EL_MARK_LOGIN_CHAR];
+                if (i < n) search_str[i] = '\0';
+        }
+        else if (*is_recovery) {
+                memmove(search_str, search_str + sizeof(EVT_RECOVERY) - 1,
+                        n - (sizeof(EVT_RECOVERY) - 1) + 1);
         }
-	*xmlinfo = working;
 
-	/* Insert event into hash table */
-        g_hash_table_insert(hash_info->hashtable, key, xmlinfo);
-	dbg("Inserted event=%s into hash table. Sev=%s, OVR=%lld, Dup=%d",
-	    xmlinfo->event, oh_lookup_severity(xmlinfo->event_sev),
-	    xmlinfo->event_ovr, xmlinfo->event_dup);
-        return;
+        return(SA_OK);
 }
@@ -0,0 +1,253 @@
+/*
+ * BladeCenter log-to-event search string benchmark.
+ *
+ * Times the former chain of strstr() calls of snmp_bc_log2event()
+ * against the single pass errlog2event_search_str() over a recorded
+ * log dump, one entry per line. Lines holding a full BladeCenter log
+ * entry are reduced to the text after "Text:". Without a dump, one is
+ * made from the messages of the event map, decorated with recovery
+ * prefixes, user IDs, POST results, threshold values and double blanks.
+ * Both must derive the same search string for every entry.
+ * Not part of "make check": build it with "make log2event_bench".
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <snmp_bc_plugin.h>
+
+static double bench_now(void)
+{
+        struct timeval tv;
+
+        gettimeofday(&tv, NULL);
+        return(tv.tv_sec + tv.tv_usec / 1000000.0);
+}
+
+/* Former search string code of snmp_bc_log2event() */
+static void legacy_search_str(gchar *text, gchar *search_str,
+			      SaHpiBoolT *is_recovery, SaHpiBoolT *is_threshold)
+{
+	gchar *recovery_str, *login_str, *post_str;
+
+	*is_recovery = *is_threshold = SAHPI_FALSE;
+
+	strncpy(search_str, text, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
+
+	recovery_str = strstr(search_str, EVT_RECOVERY);
+	if (recovery_str && (recovery_str == search_str)) {
+		*is_recovery = SAHPI_TRUE;
+		memset(search_str, 0, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
+		strncpy(search_str, (text + strlen(EVT_RECOVERY)),
+			SNMP_BC_MAX_SEL_ENTRY_LENGTH - strlen(EVT_RECOVERY));
+	}
+
+	login_str = strstr(text, LOG_LOGIN_STRING);
+	if (login_str) {
+		gchar *id_str = strstr(text, LOG_LOGIN_CHAR);
+		if (id_str != NULL) {
+			memset(search_str, 0, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
+			strncpy(search_str, text, (id_str - text));
+			search_str[(id_str - text)] = '\0';
+		}
+	}
+
+	post_str = strstr(text, LOG_POST_STRING);
+	if (post_str) {
+		memset(search_str, 0, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
+		strncpy(search_str, text, (post_str - text));
+		/* Was search_str[-1] for a leading marker */
+		search_str[post_str > text ? (post_str - text - 1) : 0] = '\0';
+	}
+
+	{
+		gchar *double_blanks;
+		double_blanks = strstr(text, "  ");
+		if (double_blanks) {
+			gchar *tmp_str;
+			int len;
+			tmp_str = text;
+			memset(search_str, 0, SNMP_BC_MAX_SEL_ENTRY_LENGTH);
+			do {
+				strncat(search_str, tmp_str, (double_blanks - tmp_str));
+				tmp_str = double_blanks + 1;
+				len = strlen(tmp_str);
+				double_blanks = strstr(tmp_str, "  ");
+			} while (double_blanks);
+			strncat(search_str, tmp_str, len);
+		}
+	}
+
+	if (strstr(text, LOG_THRESHOLD_VALUE_STRING) ||
+	    strstr(text, LOG_THRESHOLD_STRING)) {
+		*is_threshold = SAHPI_TRUE;
+	}
+}
+
+static void bench_add(GPtrArray *dump, const gchar *text)
+{
+        gchar *entry;
+
+        entry = g_malloc0(SNMP_BC_MAX_SEL_ENTRY_LENGTH);
+        strncpy(entry, text, SNMP_BC_MAX_SEL_ENTRY_LENGTH - 1);
+        g_ptr_array_add(dump, entry);
+}
+
+/* Reads one log entry per line; returns NULL if the file cannot be read */
+static GPtrArray *bench_read_dump(const char *file)
+{
+        GPtrArray *dump;
+        char line[1024];
+        FILE *fp;
+
+        fp = fopen(file, "r");
+        if (!fp) return(NULL);
+
+        dump = g_ptr_array_new();
+        while (fgets(line, sizeof(line), fp)) {
+                char *text = strstr(line, "Text:");
+
+                text = text ? text + strlen("Text:") : line;
+                text[strcspn(text, "\r\n")] = '\0';
+                if (*text != '\0') bench_add(dump, text);
+        }
+        fclose(fp);
+
+        return(dump);
+}
+
+/* Decorates every message of the event map the way the BladeCenter does */
+static GPtrArray *bench_make_dump(void)
+{
+        GPtrArray *dump;
+        gchar msg[SNMP_BC_MAX_SEL_ENTRY_LENGTH];
+        gchar *text;
+        unsigned int i;
+
+        dump = g_ptr_array_new();
+        for (i = 0; i < errlog2event_table_size; i++) {
+                gchar *dup;
+
+                strncpy(msg, errlog2event_table[i].msg, sizeof(msg) - 1);
+                msg[sizeof(msg) - 1] = '\0';
+                dup = strstr(msg, HPIDUP_STRING);
+                if (dup) *dup = '\0';
+
+                bench_add(dump, msg);
+
+                text = g_strconcat(EVT_RECOVERY, msg, ".", NULL);
+                bench_add(dump, text);
+                g_free(text);
+
+                text = g_strconcat(msg, "  Read value 47.01.  ",
+                                   LOG_THRESHOLD_VALUE_STRING, " 45.00", NULL);
+                bench_add(dump, text);
+                g_free(text);
+
+                switch (i % 3) {
+                case 0:
+                        text = g_strconcat(msg, " ", LOG_LOGIN_STRING,
+                                           " 'USERID' from WEB browser at IP@=9.3.4.5", NULL);
+                        break;
+                case 1:
+                        text = g_strconcat(EVT_RECOVERY, msg, " ",
+                                           LOG_POST_STRING, " 0x1F)", NULL);
+                        break;
+                default:
+                        text = g_strconcat(" ", msg, "   ", NULL);
+                        break;
+                }
+                bench_add(dump, text);
+                g_free(text);
+        }
+
+        return(dump);
+}
+
+int main(int argc, char *argv[])
+{
+        GPtrArray *dump;
+        gchar old_str[SNMP_BC_MAX_SEL_ENTRY_LENGTH];
+        gchar new_str[SNMP_BC_MAX_SEL_ENTRY_LENGTH];
+        SaHpiBoolT old_rec, old_thr, new_rec, new_thr;
+        double t0, t1, t2;
+        unsigned long sum = 0;
+        int loops = 200;
+        int diffs = 0;
+        int l;
+        guint i;
+
+        if (argc > 1) {
+                dump = bench_read_dump(argv[1]);
+                if (!dump) {
+                        printf("Usage: %s [log dump [loops]]\n", argv[0]);
+                        return(1);
+                }
+        }
+        else {
+                dump = bench_make_dump();
+        }
+
+        if (argc > 2) {
+                loops = atoi(argv[2]);
+                if (loops < 1) loops = 1;
+        }
+
+        /* Both must derive the same search strings */
+        for (i = 0; i < dump->len; i++) {
+                gchar *text = g_ptr_array_index(dump, i);
+
+                legacy_search_str(text, old_str, &old_rec, &old_thr);
+                if (errlog2event_search_str(text, new_str, sizeof(new_str),
+                                            &new_rec, &new_thr) != SA_OK ||
+                    strcmp(old_str, new_str) != 0 ||
+                    old_rec != new_rec || old_thr != new_thr) {
+                        printf("\"%s\" differs: \"%s\" != \"%s\"\n",
+                               text, old_str, new_str);
+                        diffs++;
+                }
+        }
+
+        t0 = bench_now();
+        for (l = 0; l < loops; l++) {
+                for (i = 0; i < dump->len; i++) {
+                        legacy_search_str(g_ptr_array_index(dump, i), old_str,
+                                          &old_rec, &old_thr);
+                        sum += old_str[0];
+                }
+        }
+        t1 = bench_now();
+        for (l = 0; l < loops; l++) {
+                for (i = 0; i < dump->len; i++) {
+                        errlog2event_search_str(g_ptr_array_index(dump, i), new_str,
+                                                sizeof(new_str), &new_rec, &new_thr);
+                        sum += new_str[0];
+                }
+        }
+        t2 = bench_now();
+
+        printf("%u entries, %d loops\n", dump->len, loops);
+        printf("strstr chain %10.0f lines/s  marker scan %10.0f lines/s  (%.2fx)\n",
+               dump->len * loops / (t1 - t0), dump->len * loops / (t2 - t1),
+               (t2 - t1) > 0 ? (t1 - t0) / (t2 - t1) : 0.0);
+        printf("%d entries differ\n", diffs);
+
+        /* keep the loops from being optimized away */
+        if (sum == 1) printf("\n");
+
+        for (i = 0; i < dump->len; i++) g_free(g_ptr_array_index(dump, i));
+        g_ptr_array_free(dump, TRUE);
+
+        return(diffs == 0 ? 0 : 1);
+}
@@ -0,0 +1,336 @@
+/*
+ * BladeCenter Event Log cache synchronization benchmark.
+ *
+ * Fills the simulator with a recorded BladeCenter Event Log of 4096
+ * entries (or the number given) and times building the elcache with the
+ * former per entry snmp_bc_sel_read_add() loop against the batch build,
+ * with individual GETs and with GETBULK. Then new entries are logged and
+ * the incremental snmp_bc_selcache_sync() is timed against a rebuild of
+ * the elcache. All ways must leave the same entries in the elcache. The
+ * 768 entry limit of the elcache is lifted to keep the whole log.
+ * Not part of "make check": build it with "make selsync_bench" and run
+ * it in this directory.
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <snmp_bc_plugin.h>
+#include <sahpimacros.h>
+#include <oh_session.h>
+#include <oh_domain.h>
+#include <oh_plugin.h>
+#include <sim_resources.h>
+#include <tsetup.h>
+
+/* Entries recorded from a BladeCenter Event Log */
+static const struct {
+        const char *severity;
+        const char *source;
+        const char *name;
+        const char *text;
+} recorded_log[] = {
+        { "ERR",  "BLADE_02", "SN#ZJ1R6G5931XY", "Critical Interrupt - Front panel NMI" },
+        { "WARN", "BLADE_01", "SN#ZJ1R6G5932JX", "System shutoff due to VRM 1 over voltage.  Read value 247.01. Threshold value. 0." },
+        { "INFO", "SERVPROC", "SN#             ", "Management Module 2 was removed." },
+        { "ERR",  "BLADE_01", "SN#ZJ1R6G5932JX", "CPU 3 shut off due to over temperature " },
+        { "ERR",  "SERVPROC", "SN#             ", "Blower 1 Fault Single blower failure" },
+        { "WARN", "SERVPROC", "SN#             ", "Management Module network uplink loss." },
+        { "ERR",  "SERVPROC", "SN#             ", "Blower 1 Failure Single blower failure" },
+        { "WARN", "BLADE_01", "SN#ZJ1R6G5932JX", "System over temperature for CPU 4.   Read value. 0. Threshold value. 0." },
+        { "INFO", "SERVPROC", "SN#             ", "TAM MNR alert for Event (ID = 0x0421d504) System over temperature for CPU 4." },
+        { "ERR",  "BLADE_01", "SN#ZJ1R6G5932JX", "Planar voltage fault.  Read value. 0. Threshold value. 0." },
+        { "ERR",  "BLADE_01", "SN#ZJ1R6G5932JX", "IO Board voltage fault.  Read value. 0. Threshold value. 0." },
+};
+
+#define RECORDED_LOG_SIZE (sizeof(recorded_log) / sizeof(recorded_log[0]))
+
+static double bench_now(void)
+{
+        struct timeval tv;
+
+        gettimeofday(&tv, NULL);
+        return(tv.tv_sec + tv.tv_usec / 1000000.0);
+}
+
+/* Sets the simulator Event Log to @total entries. Entry 1 is the newest,
+ * entries keep their text when newer ones are logged. Two entries are
+ * logged per second, so timestamps alone do not tell entries apart. */
+static void bench_fill_log(struct snmp_bc_hnd *custom_handle, int total)
+{
+        SnmpMibInfoT *mibinfo;
+        struct tm tm;
+        time_t tt;
+        char oid[SNMP_BC_MAX_OID_LENGTH];
+        int current, seq;
+
+        for (current = 1; current <= total; current++) {
+                if (custom_handle->platform == SNMP_BC_PLATFORM_RSA)
+                        snprintf(oid, sizeof(oid), "%s.%d", SNMP_BC_SEL_ENTRY_OID_RSA, current);
+                else
+                        snprintf(oid, sizeof(oid), "%s.%d", SNMP_BC_SEL_ENTRY_OID, current);
+
+                mibinfo = (SnmpMibInfoT *)g_hash_table_lookup(sim_hash, oid);
+                if (!mibinfo) {
+                        mibinfo = g_new0(SnmpMibInfoT, 1);
+                        g_hash_table_insert(sim_hash, g_strdup(oid), mibinfo);
+                }
+
+                seq = total - current;
+                memset(&tm, 0, sizeof(tm));
+                tm.tm_year = 105;
+                tm.tm_mon = 10;
+                tm.tm_mday = 18;
+                tm.tm_isdst = -1;
+                tt = mktime(&tm) + seq / 2;
+                localtime_r(&tt, &tm);
+
+                mibinfo->type = ASN_OCTET_STR;
+                snprintf(mibinfo->value.string, MAX_ASN_STR_LEN,
+                         "Severity:%s  Source:%s  Name:%s  Date:%02d/%02d/%02d  Time:%02d:%02d:%02d  Text:%s",
+                         recorded_log[seq % RECORDED_LOG_SIZE].severity,
+                         recorded_log[seq % RECORDED_LOG_SIZE].source,
+                         recorded_log[seq % RECORDED_LOG_SIZE].name,
+                         tm.tm_mon + 1, tm.tm_mday, tm.tm_year % 100,
+                         tm.tm_hour, tm.tm_min, tm.tm_sec,
+                         recorded_log[seq % RECORDED_LOG_SIZE].text);
+        }
+
+        /* End the log after @total entries */
+        if (custom_handle->platform == SNMP_BC_PLATFORM_RSA)
+                snprintf(oid, sizeof(oid), "%s.%d", SNMP_BC_SEL_ENTRY_OID_RSA, current);
+        else
+                snprintf(oid, sizeof(oid), "%s.%d", SNMP_BC_SEL_ENTRY_OID, current);
+        mibinfo = (SnmpMibInfoT *)g_hash_table_lookup(sim_hash, oid);
+        if (mibinfo) {
+                mibinfo->type = ASN_INTEGER;
+                mibinfo->value.integer = SNMP_FORCE_ERROR;
+        }
+}
+
+/* Former elcache build, one GET and one prepend per entry */
+static void bench_read_add(struct oh_handler_state *handle, SaHpiResourceIdT id)
+{
+        SaHpiEventLogEntryIdT current;
+
+        for (current = 1; ; current++) {
+                if (snmp_bc_sel_read_add(handle, id, current, SAHPI_TRUE) != SA_OK)
+                        break;
+        }
+}
+
+/* Copies the events of the elcache, oldest first */
+static GArray *bench_save_cache(struct oh_handler_state *handle)
+{
+        GArray *events;
+        GList *node;
+
+        events = g_array_new(FALSE, TRUE, sizeof(SaHpiEventT));
+        for (node = handle->elcache->list; node; node = node->next) {
+                g_array_append_val(events, ((oh_el_entry *)node->data)->event.Event);
+        }
+
+        return(events);
+}
+
+/* Returns the number of elcache entries that differ from @events */
+static int bench_compare_cache(struct oh_handler_state *handle, GArray *events)
+{
+        SaHpiEventT *event;
+        GList *node;
+        int diffs = 0;
+        guint i = 0;
+
+        for (node = handle->elcache->list; node; node = node->next, i++) {
+                event = &((oh_el_entry *)node->data)->event.Event;
+                if (i >= events->len ||
+                    event->Timestamp != g_array_index(events, SaHpiEventT, i).Timestamp ||
+                    event->EventType != g_array_index(events, SaHpiEventT, i).EventType ||
+                    event->Source != g_array_index(events, SaHpiEventT, i).Source ||
+                    event->Severity != g_array_index(events, SaHpiEventT, i).Severity)
+                        diffs++;
+        }
+        if (i != events->len) diffs++;
+
+        return(diffs);
+}
+
+static void bench_use_getbulk(struct snmp_bc_hnd *custom_handle, SaHpiBoolT getbulk)
+{
+        if (getbulk) {
+                custom_handle->session.version = SNMP_VERSION_3;
+                custom_handle->count_per_getbulk = SNMP_BC_BULK_DEFAULT;
+        }
+        else {
+                custom_handle->session.version = SNMP_VERSION_1;
+                custom_handle->count_per_getbulk = 0;
+        }
+}
+
+static void bench_clear_cache(struct oh_handler_state *handle)
+{
+        struct snmp_bc_hnd *custom_handle = (struct snmp_bc_hnd *)handle->data;
+
+        oh_el_clear(handle->elcache);
+        custom_handle->sel_newest_valid = SAHPI_FALSE;
+}
+
+int main(int argc, char **argv)
+{
+        SaErrorT err;
+        SaHpiResourceIdT id;
+        SaHpiRptEntryT rptentry;
+        SaHpiSessionIdT sessionid;
+        SaHpiDomainIdT did;
+        struct oh_handler *h = NULL;
+        struct oh_domain *d = NULL;
+        unsigned int *hid = NULL;
+        struct oh_handler_state *handle;
+        struct snmp_bc_hnd *custom_handle;
+        GArray *events;
+        double t_read_add, t_get, t_getbulk, t_rebuild, t_sync_get, t_sync_getbulk;
+        double t0;
+        int total = 4096;
+        int added = 16;
+        int loops = 5;
+        int diffs = 0;
+        int l;
+
+        if (argc > 1) {
+                total = atoi(argv[1]);
+                if (total < 1) {
+                        printf("Usage: %s [entries [new entries]]\n", argv[0]);
+                        return(1);
+                }
+        }
+        if (argc > 2) {
+                added = atoi(argv[2]);
+                if (added < 1) added = 1;
+        }
+
+        /* Same environment as "make check" */
+        setenv("OPENHPI_CONF", "openhpi.conf", 0);
+        setenv("OPENHPI_SIMTEST_FILE", "sim_test_file", 0);
+        setenv("OPENHPI_UID_MAP", "uid_map", 0);
+
+        err = tsetup(&sessionid);
+        if (err != SA_OK) {
+                printf("Error! Can not open session for test environment\n");
+                return(1);
+        }
+
+        err = tfind_resource(&sessionid, SAHPI_CAPABILITY_EVENT_LOG, SAHPI_FIRST_ENTRY, &rptentry, SAHPI_TRUE);
+        if (err != SA_OK) {
+                printf("Can not find an Event Log resource for test environment\n");
+                tcleanup(&sessionid);
+                return(1);
+        }
+
+        id = rptentry.ResourceId;
+        INIT_HANDLE(did, d, hid, h, handle);
+        custom_handle = (struct snmp_bc_hnd *)handle->data;
+
+        snmp_bc_lock_handler(custom_handle);
+
+        /* Only the elcache work is timed, events are not queued */
+        custom_handle->isFirstDiscovery = SAHPI_TRUE;
+        handle->elcache->info.Size = OH_EL_MAX_SIZE;
+        bench_fill_log(custom_handle, total);
+
+        /* Full build: former per entry prepend, batch with GET and GETBULK */
+        t0 = bench_now();
+        for (l = 0; l < loops; l++) {
+                bench_clear_cache(handle);
+                bench_read_add(handle, id);
+        }
+        t_read_add = (bench_now() - t0) * 1000 / loops;
+        events = bench_save_cache(handle);
+        if (events->len != total) {
+                printf("read_add cached %d of %d entries\n", events->len, total);
+                diffs++;
+        }
+
+        bench_use_getbulk(custom_handle, SAHPI_FALSE);
+        t0 = bench_now();
+        for (l = 0; l < loops; l++) {
+                bench_clear_cache(handle);
+                snmp_bc_build_selcache(handle, id);
+        }
+        t_get = (bench_now() - t0) * 1000 / loops;
+        diffs += bench_compare_cache(handle, events);
+
+        bench_use_getbulk(custom_handle, SAHPI_TRUE);
+        t0 = bench_now();
+        for (l = 0; l < loops; l++) {
+                bench_clear_cache(handle);
+                snmp_bc_build_selcache(handle, id);
+        }
+        t_getbulk = (bench_now() - t0) * 1000 / loops;
+        diffs += bench_compare_cache(handle, events);
+        g_array_free(events, TRUE);
+
+        /* New entries: rebuild against incremental sync */
+        bench_fill_log(custom_handle, total + added);
+
+        bench_use_getbulk(custom_handle, SAHPI_FALSE);
+        t0 = bench_now();
+        for (l = 0; l < loops; l++) {
+                bench_clear_cache(handle);
+                snmp_bc_build_selcache(handle, id);
+        }
+        t_rebuild = (bench_now() - t0) * 1000 / loops;
+        events = bench_save_cache(handle);
+
+        t_sync_get = t_sync_getbulk = 0;
+        for (l = 0; l < loops; l++) {
+                bench_fill_log(custom_handle, total);
+                bench_use_getbulk(custom_handle, SAHPI_FALSE);
+                bench_clear_cache(handle);
+                snmp_bc_build_selcache(handle, id);
+                bench_fill_log(custom_handle, total + added);
+                t0 = bench_now();
+                snmp_bc_selcache_sync(handle, id, SAHPI_NEWEST_ENTRY);
+                t_sync_get += bench_now() - t0;
+                diffs += bench_compare_cache(handle, events);
+
+                bench_fill_log(custom_handle, total);
+                bench_use_getbulk(custom_handle, SAHPI_TRUE);
+                bench_clear_cache(handle);
+                snmp_bc_build_selcache(handle, id);
+                bench_fill_log(custom_handle, total + added);
+                t0 = bench_now();
+                snmp_bc_selcache_sync(handle, id, SAHPI_NEWEST_ENTRY);
+                t_sync_getbulk += bench_now() - t0;
+                diffs += bench_compare_cache(handle, events);
+        }
+        t_sync_get = t_sync_get * 1000 / loops;
+        t_sync_getbulk = t_sync_getbulk * 1000 / loops;
+        g_array_free(events, TRUE);
+
+        bench_use_getbulk(custom_handle, SAHPI_FALSE);
+        snmp_bc_unlock_handler(custom_handle);
+
+        printf("%d entries, %d loops\n", total, loops);
+        printf("build:  read_add %10.3f ms  batch GET %10.3f ms  batch GETBULK %10.3f ms\n",
+               t_read_add, t_get, t_getbulk);
+        printf("%d new: rebuild  %10.3f ms  sync GET  %10.3f ms  sync GETBULK  %10.3f ms\n",
+               added, t_rebuild, t_sync_get, t_sync_getbulk);
+        printf("%d entries differ\n", diffs);
+
+        tcleanup(&sessionid);
+
+        return(diffs == 0 ? 0 : 1);
+}
+
+#include <tsetup.c>
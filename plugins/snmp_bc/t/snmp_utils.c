@@ -13,6 +13,7 @@
  *      Steve Sherman <stevees@us.ibm.com>
  */
 
+#include <string.h>
 #include <glib.h>
 
 #include <SaHpi.h>
@@ -90,7 +91,58 @@ int snmp_getn_bulk( void *sessp,
                     struct snmp_pdu **bulk_response,
                     int num_repetitions )
 {
-	return 0;
+	SnmpMibInfoT *hash_data;
+	struct snmp_pdu *response;
+	oid name[MAX_OID_LEN];
+	size_t name_length;
+	GString *column;
+	gchar *objid;
+	int i;
+
+	/* Tables are kept in sim_hash as "<column OID>.<row>", so the walk */
+	/* steps from row to row within the column the request starts in.  */
+	/* Only string rows are served, anything else ends the MIB view.   */
+	*bulk_response = NULL;
+	if (bulk_objid_len < 1 || bulk_objid_len >= MAX_OID_LEN) return STAT_ERROR;
+
+	column = g_string_new(NULL);
+	for (i = 0; i < bulk_objid_len; i++) {
+		g_string_append_printf(column, ".%lu", (unsigned long)bulk_objid[i]);
+	}
+	memcpy(name, bulk_objid, bulk_objid_len * sizeof(oid));
+	name_length = bulk_objid_len;
+
+	/* Request for the column itself starts before its first row */
+	objid = g_strdup_printf("%s.1", column->str);
+	if (g_hash_table_lookup(sim_hash, objid)) {
+		name[name_length++] = 0;
+	} else {
+		g_string_truncate(column, strrchr(column->str, '.') - column->str);
+	}
+	g_free(objid);
+
+	response = snmp_pdu_create(SNMP_MSG_RESPONSE);
+	for (i = 0; i < num_repetitions; i++) {
+		name[name_length - 1]++;
+		objid = g_strdup_printf("%s.%lu", column->str,
+					(unsigned long)name[name_length - 1]);
+		hash_data = (SnmpMibInfoT *)g_hash_table_lookup(sim_hash, objid);
+		g_free(objid);
+
+		if (hash_data && hash_data->type == ASN_OCTET_STR) {
+			snmp_pdu_add_variable(response, name, name_length, ASN_OCTET_STR,
+					      hash_data->value.string,
+					      strlen(hash_data->value.string));
+		} else {
+			snmp_pdu_add_variable(response, name, name_length,
+					      SNMP_ENDOFMIBVIEW, NULL, 0);
+			break;
+		}
+	}
+
+	g_string_free(column, TRUE);
+	*bulk_response = response;
 
+	return STAT_SUCCESS;
 }
 
@@ -32,7 +32,10 @@
 #include <netinet/tcp.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 #include <unistd.h>
 #endif
 
@@ -68,6 +71,19 @@ static void Finalize( void )
 /***************************************************************
  * Helper functions
  **************************************************************/
+static uint16_t DecodeUint16( const uint8_t * bytes, int byte_order )
+{
+    uint16_t x;
+    memcpy( &x, bytes, sizeof( x ) );
+    return ( byte_order == G_BYTE_ORDER ) ? x : GUINT16_SWAP_LE_BE( x );
+}
+
+static void EncodeUint16( uint8_t * bytes, uint16_t x, int byte_order )
+{
+    uint16_t x2 = ( byte_order == G_BYTE_ORDER ) ? x : GUINT16_SWAP_LE_BE( x );
+    memcpy( bytes, &x2, sizeof( x ) );
+}
+
 static uint32_t DecodeUint32( const uint8_t * bytes, int byte_order )
 {
     uint32_t x;
@@ -119,12 +135,90 @@ static void SelectAddresses( int ipvflags,
     }
 }
 
+#ifndef _WIN32
+static bool FillLocalAddress( const char * path,
+                              struct sockaddr_un& sa,
+                              struct addrinfo& info )
+{
+    if ( strlen( path ) >= sizeof(sa.sun_path) ) {
+        CRIT( "unix socket path %s is too long.", path );
+        return false;
+    }
+
+    memset( &sa, 0, sizeof(sa) );
+    sa.sun_family = AF_UNIX;
+    strcpy( sa.sun_path, path );
+
+    memset( &info, 0, sizeof(info) );
+    info.ai_family   = AF_UNIX;
+    info.ai_socktype = SOCK_STREAM;
+    info.ai_addr     = reinterpret_cast<struct sockaddr *>( &sa );
+    info.ai_addrlen  = sizeof(sa);
+
+    return true;
+}
+#endif
+
+
+/***************************************************************
+ * Message Buffers
+ **************************************************************/
+// Buffers beyond this stay out of the pool
+static const guint dMsgBufferPoolSize = 64;
+
+#if GLIB_CHECK_VERSION (2, 14, 0)
+static GAsyncQueue * msg_buffers = 0;
+
+static GAsyncQueue * MsgBufferPool()
+{
+    static gsize initialized = 0;
+    if ( g_once_init_enter( &initialized ) ) {
+        msg_buffers = g_async_queue_new();
+        g_once_init_leave( &initialized, 1 );
+    }
+
+    return msg_buffers;
+}
+#endif
+
+void * AllocMsgBuffer()
+{
+    gpointer buffer = 0;
+#if GLIB_CHECK_VERSION (2, 14, 0)
+    buffer = g_async_queue_try_pop( MsgBufferPool() );
+#endif
+    if ( !buffer ) {
+        buffer = g_malloc( dMaxPayloadLength );
+    }
+
+    return buffer;
+}
+
+void FreeMsgBuffer( void * buffer )
+{
+    if ( !buffer ) {
+        return;
+    }
+
+#if GLIB_CHECK_VERSION (2, 14, 0)
+    GAsyncQueue * pool = MsgBufferPool();
+    if ( g_async_queue_length( pool ) < (gint)dMsgBufferPoolSize ) {
+        g_async_queue_push( pool, buffer );
+        return;
+    }
+#endif
+    g_free( buffer );
+}
+
 
 /***************************************************************
  * Base Stream Socket class
  **************************************************************/
 cStreamSock::cStreamSock( SockFdT sockfd )
-    : m_sockfd( sockfd )
+    : m_sockfd( sockfd ),
+      m_rbuf( 0 ),
+      m_rbuf_pos( 0 ),
+      m_rbuf_len( 0 )
 {
     // empty
 }
@@ -132,6 +226,7 @@ cStreamSock::cStreamSock( SockFdT sockfd )
 cStreamSock::~cStreamSock()
 {
     Close();
+    g_free( m_rbuf );
 }
 
 bool cStreamSock::GetPeerAddress( SockAddrStorageT& storage ) const
@@ -143,6 +238,32 @@ bool cStreamSock::GetPeerAddress( SockAddrStorageT& storage ) const
     return ( cc == 0 );
 }
 
+#ifndef _WIN32
+bool cStreamSock::GetPeerCredentials( uid_t& uid, gid_t& gid, pid_t& pid ) const
+{
+#if defined(__linux__)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    int cc = getsockopt( m_sockfd, SOL_SOCKET, SO_PEERCRED, &cred, &len );
+    if ( cc != 0 ) {
+        return false;
+    }
+    uid = cred.uid;
+    gid = cred.gid;
+    pid = cred.pid;
+
+    return true;
+#elif defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__APPLE__)
+    pid = -1;
+    int cc = getpeereid( m_sockfd, &uid, &gid );
+
+    return ( cc == 0 );
+#else
+    return false;
+#endif
+}
+#endif
+
 bool cStreamSock::Close()
 {
     if ( m_sockfd == InvalidSockFd ) {
@@ -164,6 +285,8 @@ bool cStreamSock::Close()
     }
 
     m_sockfd = InvalidSockFd;
+    m_rbuf_pos = 0;
+    m_rbuf_len = 0;
 
     return true;
 }
@@ -173,74 +296,126 @@ bool cStreamSock::ReadMsg( uint8_t& type,
                            void * payload,
                            uint32_t& payload_len,
                            int& payload_byte_order )
+{
+    uint16_t tag;
+    return ReadMsg( type, tag, id, payload, payload_len, payload_byte_order );
+}
+
+bool cStreamSock::ReadMsg( uint8_t& type,
+                           uint16_t& tag,
+                           uint32_t& id,
+                           void * payload,
+                           uint32_t& payload_len,
+                           int& payload_byte_order )
+{
+    bool rc = ReadMsgHeader( type, tag, id, payload_len, payload_byte_order );
+    if ( !rc ) {
+        return false;
+    }
+
+    return ReadMsgPayload( payload, payload_len );
+}
+
+bool cStreamSock::ReadMsgHeader( uint8_t& type,
+                                 uint16_t& tag,
+                                 uint32_t& id,
+                                 uint32_t& payload_len,
+                                 int& payload_byte_order )
+{
+    MessageHeader hdr;
+    bool rc = Recv( hdr, dMhSize );
+    if ( !rc ) {
+        return false;
+    }
+
+    uint8_t ver = hdr[dMhOffFlags] >> 4;
+    if ( ver != dMhRpcVersion ) {
+        CRIT( "unsupported version 0x%x != 0x%x.",
+             ver,
+             dMhRpcVersion );
+        return false;
+    }
+    type = hdr[dMhOffType];
+    payload_byte_order = ( ( hdr[dMhOffFlags] & dMhEndianBit ) != 0 ) ?
+                         G_LITTLE_ENDIAN : G_BIG_ENDIAN;
+    if ( ( hdr[dMhOffFlags] & dMhMuxBit ) != 0 ) {
+        tag = DecodeUint16( &hdr[dMhOffReserved1], payload_byte_order );
+    } else {
+        tag = 0;
+    }
+    id = DecodeUint32( &hdr[dMhOffId], payload_byte_order );
+    payload_len = DecodeUint32( &hdr[dMhOffLen], payload_byte_order );
+    if ( payload_len > dMaxPayloadLength ) {
+        CRIT( "message payload too large." );
+        return false;
+    }
+
+    return true;
+}
+
+bool cStreamSock::ReadMsgPayload( void * payload, uint32_t payload_len )
+{
+    if ( ( payload_len > 0 ) && ( payload == 0 ) ) {
+        return false;
+    }
+
+    return Recv( payload, payload_len );
+}
+
+bool cStreamSock::Recv( void * dst, size_t len )
 {
     // Windows recv() takes char * so we need the workaround below.
-    union {
-        MessageHeader hdr;
-        char rawhdr[sizeof(MessageHeader)];
-    };
-
-    char * dst = rawhdr;
-    size_t got  = 0;
-    size_t need = dMhSize;
-    while ( got < need ) {
-        ssize_t len = recv( m_sockfd, dst + got, need - got, 0 );
-        if ( len < 0 ) {
-            CRIT( "error while reading message in thread %p.", 
+    char * p = reinterpret_cast<char *>(dst);
+
+    while ( len > 0 ) {
+        size_t avail = m_rbuf_len - m_rbuf_pos;
+        if ( avail > 0 ) {
+            size_t n = ( avail < len ) ? avail : len;
+            memcpy( p, m_rbuf + m_rbuf_pos, n );
+            m_rbuf_pos += n;
+            p   += n;
+            len -= n;
+            continue;
+        }
+
+        // Large payloads go straight to their destination,
+        // everything else is read ahead together with what follows.
+        char * rdst;
+        size_t rlen;
+        if ( len >= dRecvBufferSize ) {
+            rdst = p;
+            rlen = len;
+        } else {
+            if ( !m_rbuf ) {
+                m_rbuf = reinterpret_cast<char *>( g_malloc( dRecvBufferSize ) );
+            }
+            rdst = m_rbuf;
+            rlen = dRecvBufferSize;
+        }
+
+        ssize_t got = recv( m_sockfd, rdst, rlen, 0 );
+        if ( got < 0 ) {
+#ifndef _WIN32
+            if ( errno == EINTR ) {
+                continue;
+            }
+#endif
+            CRIT( "error while reading message in thread %p.",
             g_thread_self() );
             return false;
-        } else if ( len == 0 ) {
+        } else if ( got == 0 ) {
             //CRIT( "peer closed connection." );
             return false;
         }
-        got += len;
-
-        if ( ( got == need ) && ( dst == rawhdr ) ) {
-            // we got header
-            uint8_t ver = hdr[dMhOffFlags] >> 4;
-            if ( ver != dMhRpcVersion ) {
-                CRIT( "unsupported version 0x%x != 0x%x.",
-                     ver,
-                     dMhRpcVersion );
-                return false;
-            }
-            type = hdr[dMhOffType];
-            payload_byte_order = ( ( hdr[dMhOffFlags] & dMhEndianBit ) != 0 ) ?
-                                 G_LITTLE_ENDIAN : G_BIG_ENDIAN;
-            id = DecodeUint32( &hdr[dMhOffId], payload_byte_order );
-            payload_len = DecodeUint32( &hdr[dMhOffLen], payload_byte_order );
-
-            // now prepare to get payload
-            dst  = reinterpret_cast<char *>(payload);
-            got  = 0;
-            need = payload_len;
-        }
-    }
 
-    payload_len = got;
-
-/*
-    printf( "Transport: got message of %u bytes in buffer %p:\n",
-            sizeof(MessageHeader) + got,
-            payload );
-    for ( size_t i = 0; i < dMhSize; ++i ) {
-        union {
-            char c;
-            unsigned char uc;
-        };
-        c = rawhdr[i];
-        printf( "%02x ", uc );
-    }
-    for ( size_t i = 0; i < got; ++i ) {
-        union {
-            char c;
-            unsigned char uc;
-        };
-        c = (reinterpret_cast<char *>(payload))[i];
-        printf( "%02x ", uc );
+        if ( rdst == p ) {
+            p   += got;
+            len -= got;
+        } else {
+            m_rbuf_pos = 0;
+            m_rbuf_len = got;
+        }
     }
-    printf( "\n" );
-*/
 
     return true;
 }
@@ -249,6 +424,15 @@ bool cStreamSock::WriteMsg( uint8_t type,
                             uint32_t id,
                             const void * payload,
                             uint32_t payload_len )
+{
+    return WriteMsg( type, 0, id, payload, payload_len );
+}
+
+bool cStreamSock::WriteMsg( uint8_t type,
+                            uint16_t tag,
+                            uint32_t id,
+                            const void * payload,
+                            uint32_t payload_len )
 {
     if ( ( payload_len > 0 ) && ( payload == 0 ) ) {
         return false;
@@ -258,45 +442,76 @@ bool cStreamSock::WriteMsg( uint8_t type,
         return false;
     }
 
-    // Windows send() takes char * so we need the workaround below.
-    union {
-        MessageHeader hdr;
-        char msg[dMaxMessageLength];
-    };
-
+    MessageHeader hdr;
     hdr[dMhOffType] = type;
     hdr[dMhOffFlags] = dMhRpcVersion << 4;
     if ( G_BYTE_ORDER == G_LITTLE_ENDIAN ) {
         hdr[dMhOffFlags] |= dMhEndianBit;
     }
-    hdr[dMhOffReserved1] = 0;
-    hdr[dMhOffReserved2] = 0;
+    if ( tag != 0 ) {
+        hdr[dMhOffFlags] |= dMhMuxBit;
+        EncodeUint16( &hdr[dMhOffReserved1], tag, G_BYTE_ORDER );
+    } else {
+        hdr[dMhOffReserved1] = 0;
+        hdr[dMhOffReserved2] = 0;
+    }
     EncodeUint32( &hdr[dMhOffId], id, G_BYTE_ORDER );
     EncodeUint32( &hdr[dMhOffLen], payload_len, G_BYTE_ORDER );
 
-    if ( payload ) {
-        memcpy( &msg[dMhSize], payload, payload_len );
-    }
+    // Header and payload go out together without being copied
     size_t msg_len = dMhSize + payload_len;
+    size_t nbufs = ( payload_len > 0 ) ? 2 : 1;
 
-/*
-    printf("Transport: sending message of %d bytes:\n", msg_len );
-    for ( size_t i = 0; i < msg_len; ++i ) {
-        union {
-            char c;
-            unsigned char uc;
-        };
-        c = msg[i];
-        printf( "%02x ", uc );
-    }
-    printf( "\n" );
-*/
-
-    ssize_t cc = send( m_sockfd, &msg[0], msg_len, 0 );
-    if ( cc != (ssize_t)msg_len ) {
+#ifdef _WIN32
+    WSABUF bufs[2];
+    bufs[0].buf = reinterpret_cast<char *>( &hdr[0] );
+    bufs[0].len = dMhSize;
+    bufs[1].buf = const_cast<char *>( reinterpret_cast<const char *>(payload) );
+    bufs[1].len = payload_len;
+
+    DWORD sent = 0;
+    int cc = WSASend( m_sockfd, bufs, nbufs, &sent, 0, 0, 0 );
+    if ( ( cc != 0 ) || ( sent != msg_len ) ) {
         CRIT( "error while sending message." );
         return false;
     }
+#else
+    struct iovec iov[2];
+    iov[0].iov_base = &hdr[0];
+    iov[0].iov_len  = dMhSize;
+    iov[1].iov_base = const_cast<void *>( payload );
+    iov[1].iov_len  = payload_len;
+
+    struct msghdr mh;
+    memset( &mh, 0, sizeof(mh) );
+    mh.msg_iov    = iov;
+    mh.msg_iovlen = nbufs;
+
+    while ( msg_len > 0 ) {
+        ssize_t cc = sendmsg( m_sockfd, &mh, 0 );
+        if ( ( cc < 0 ) && ( errno == EINTR ) ) {
+            continue;
+        }
+        if ( cc <= 0 ) {
+            CRIT( "error while sending message." );
+            return false;
+        }
+        msg_len -= cc;
+        // skip what was sent
+        while ( ( cc > 0 ) && ( mh.msg_iovlen > 0 ) ) {
+            if ( (size_t)cc >= mh.msg_iov->iov_len ) {
+                cc -= mh.msg_iov->iov_len;
+                ++mh.msg_iov;
+                --mh.msg_iovlen;
+            } else {
+                mh.msg_iov->iov_base =
+                    reinterpret_cast<char *>( mh.msg_iov->iov_base ) + cc;
+                mh.msg_iov->iov_len -= cc;
+                cc = 0;
+            }
+        }
+    }
+#endif
 
     return true;
 }
@@ -375,7 +590,8 @@ bool cStreamSock::CreateAttempt( const struct addrinfo * info, bool last_attempt
  * Client Stream Socket class
  **************************************************************/
 cClientStreamSock::cClientStreamSock()
-    : cStreamSock()
+    : cStreamSock(),
+      m_local( false )
 {
     // empty
 }
@@ -387,6 +603,12 @@ cClientStreamSock::~cClientStreamSock()
 
 bool cClientStreamSock::Create( const char * host, uint16_t port )
 {
+    const size_t prefix_len = sizeof(dUnixHostPrefix) - 1;
+    if ( strncmp( host, dUnixHostPrefix, prefix_len ) == 0 ) {
+        return CreateLocal( host + prefix_len );
+    }
+    m_local = false;
+
     bool connected = false;
     struct addrinfo * info;
     std::list<struct addrinfo *> infos;
@@ -409,6 +631,11 @@ bool cClientStreamSock::EnableKeepAliveProbes( int keepalive_time,
                                                int keepalive_intvl,
                                                int keepalive_probes )
 {
+    if ( m_local ) {
+        // the peer going away is seen right away
+        return true;
+    }
+
 #ifdef __linux__
     int rc;
     int val;
@@ -468,6 +695,24 @@ bool cClientStreamSock::CreateAttempt( const struct addrinfo * info, bool last_a
     return true;
 }
 
+bool cClientStreamSock::CreateLocal( const char * path )
+{
+#ifdef _WIN32
+    CRIT( "unix domain sockets are not supported on this platform." );
+    return false;
+#else
+    struct sockaddr_un sa;
+    struct addrinfo info;
+    if ( !FillLocalAddress( path, sa, info ) ) {
+        return false;
+    }
+
+    m_local = CreateAttempt( &info, true );
+
+    return m_local;
+#endif
+}
+
 
 /***************************************************************
  * Server Stream Socket class
@@ -540,6 +785,23 @@ bool cServerStreamSock::CreateAttempt( const struct addrinfo * info, bool last_a
         }
         return false;
     }
+#ifndef _WIN32
+    if ( info->ai_family == AF_UNIX ) {
+        // srw-rw----, so other users cannot connect.
+        // Set before listen, no connection is accepted with wider access.
+        const struct sockaddr_un * sa
+            = reinterpret_cast<const struct sockaddr_un *>( info->ai_addr );
+        cc = chmod( sa->sun_path, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP );
+        if ( cc != 0 ) {
+            Close();
+            unlink( sa->sun_path );
+            if ( last_attempt ) {
+                CRIT( "chmod failed." );
+            }
+            return false;
+        }
+    }
+#endif
     cc = listen( SockFd(), 5 /* TODO */ );
     if ( cc != 0 ) {
         Close();
@@ -552,6 +814,28 @@ bool cServerStreamSock::CreateAttempt( const struct addrinfo * info, bool last_a
     return true;
 }
 
+bool cServerStreamSock::CreateLocal( const char * path )
+{
+#ifdef _WIN32
+    CRIT( "unix domain sockets are not supported on this platform." );
+    return false;
+#else
+    struct sockaddr_un sa;
+    struct addrinfo info;
+    if ( !FillLocalAddress( path, sa, info ) ) {
+        return false;
+    }
+
+    // A socket left behind by a previous instance makes bind fail
+    struct stat st;
+    if ( ( lstat( path, &st ) == 0 ) && S_ISSOCK( st.st_mode ) ) {
+        unlink( path );
+    }
+
+    return CreateAttempt( &info, true );
+#endif
+}
+
 cStreamSock * cServerStreamSock::Accept()
 {
     SockFdT sock = accept( SockFd(), 0, 0 );
@@ -30,6 +30,7 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #endif
 
 
@@ -55,19 +56,76 @@ const size_t dMhOffReserved2 = 3;
 const size_t dMhOffId        = 4;
 const size_t dMhOffLen       = 8;
 
-const uint8_t eMhMsg   = 1;
-const uint8_t eMhError = 2;
+const uint8_t eMhMsg      = 1;
+const uint8_t eMhError    = 2;
+// Asks the peer whether it accepts tagged messages.
+// A peer that does replies with the same type.
+const uint8_t eMhMuxHello = 3;
 
 // message flags
 // bits 0-3 : flags, bit 4-7 : OpenHPI RPC version
 // if endian bit is set the byte order is Little Endian
+// if mux bit is set the reserved bytes carry a 16-bit message tag
+// (in the message byte order). The reply to a tagged message
+// carries the same tag, so several requests can be outstanding
+// on one connection. Tag 0 means an untagged message.
 const uint8_t dMhEndianBit  = 1;
+const uint8_t dMhMuxBit     = 2;
 const uint8_t dMhRpcVersion = 1;
 
 
+/***************************************************************
+ * Unix Domain Sockets
+ * A host given as "unix:<path>" names a Unix domain socket,
+ * the port is ignored then.
+ **************************************************************/
+const char dUnixHostPrefix[] = "unix:";
+
+
 const size_t dMaxMessageLength = 0xFFFF;
 const size_t dMaxPayloadLength = dMaxMessageLength - sizeof(MessageHeader);
 
+// Socket read-ahead, a number of small messages fit in
+const size_t dRecvBufferSize = 16384;
+
+
+/***************************************************************
+ * Message Buffers
+ * dMaxPayloadLength bytes each, kept in a pool for reuse.
+ **************************************************************/
+void * AllocMsgBuffer();
+void FreeMsgBuffer( void * buffer );
+
+class cMsgBuffer
+{
+public:
+
+    explicit cMsgBuffer()
+        : m_data( reinterpret_cast<char *>( AllocMsgBuffer() ) )
+    {
+        // empty
+    }
+
+    ~cMsgBuffer()
+    {
+        FreeMsgBuffer( m_data );
+    }
+
+    char * Data() const
+    {
+        return m_data;
+    }
+
+private:
+
+    cMsgBuffer( const cMsgBuffer& );
+    cMsgBuffer& operator =( const cMsgBuffer& );
+
+private:
+
+    char * m_data;
+};
+
 
 /***************************************************************
  * Base Stream Socket class
@@ -95,13 +153,41 @@ public:
 
     bool GetPeerAddress( SockAddrStorageT& storage ) const;
 
+#ifndef _WIN32
+    // Credentials of the process on the other end of a Unix domain socket.
+    // pid is -1 if the platform does not report it.
+    bool GetPeerCredentials( uid_t& uid, gid_t& gid, pid_t& pid ) const;
+#endif
+
+    bool ReadMsg( uint8_t& type,
+                  uint32_t& id,
+                  void * payload,
+                  uint32_t& payload_len,
+                  int& payload_byte_order );
+
     bool ReadMsg( uint8_t& type,
+                  uint16_t& tag,
                   uint32_t& id,
                   void * payload,
                   uint32_t& payload_len,
                   int& payload_byte_order );
 
+    // ReadMsg in two steps, so the caller can pick the payload
+    // destination once it knows the message
+    bool ReadMsgHeader( uint8_t& type,
+                        uint16_t& tag,
+                        uint32_t& id,
+                        uint32_t& payload_len,
+                        int& payload_byte_order );
+    bool ReadMsgPayload( void * payload, uint32_t payload_len );
+
+    bool WriteMsg( uint8_t type,
+                   uint32_t id,
+                   const void * payload,
+                   uint32_t payload_len );
+
     bool WriteMsg( uint8_t type,
+                   uint16_t tag,
                    uint32_t id,
                    const void * payload,
                    uint32_t payload_len );
@@ -129,9 +215,14 @@ private:
     cStreamSock( const cStreamSock& );
     cStreamSock& operator =( const cStreamSock& );
 
+    bool Recv( void * dst, size_t len );
+
 private:
 
     SockFdT m_sockfd;
+    char *  m_rbuf;     // read-ahead buffer, dRecvBufferSize bytes
+    size_t  m_rbuf_pos;
+    size_t  m_rbuf_len;
 };
 
 
@@ -166,6 +257,11 @@ private:
     cClientStreamSock& operator =( const cClientStreamSock& );
 
     bool CreateAttempt( const struct addrinfo * ainfo, bool last_attempt );
+    bool CreateLocal( const char * path );
+
+private:
+
+    bool m_local;
 };
 
 
@@ -181,6 +277,10 @@ public:
 
     bool Create( int ipvflags, const char * bindaddr, uint16_t port );
 
+    // Listens on a Unix domain socket, access is limited to the owner
+    // and the group of the process.
+    bool CreateLocal( const char * path );
+
     cStreamSock * Accept();
 
 private:
@@ -120,6 +120,68 @@ SaErrorT oh_el_append(oh_el *el,
 }
 
 
+/* append a list of caller allocated entries, oldest first, to the EL.
+ * The EL takes over the entries and the list links on success.
+ */
+SaErrorT oh_el_append_batch(oh_el *el, GList *entries)
+{
+        GList *node;
+        oh_el_entry *entry;
+        SaHpiTimeT cursystime = 0;
+        guint length;
+
+        /* check for valid el params and state */
+        if (el == NULL) {
+                return SA_ERR_HPI_INVALID_PARAMS;
+        }
+
+        for (node = entries; node; node = node->next) {
+                entry = (oh_el_entry *)node->data;
+                if (entry == NULL) {
+                        return SA_ERR_HPI_INVALID_PARAMS;
+                } else if (el->info.Enabled == FALSE &&
+                           entry->event.Event.EventType != SAHPI_ET_USER) {
+                        return SA_ERR_HPI_INVALID_REQUEST;
+                }
+        }
+
+        if (entries == NULL) {
+                return SA_OK;
+        }
+
+        /* Set the event log entry ids and timestamps */
+        if (el->gentimestamp) {
+                oh_gettimeofday(&cursystime);
+        }
+        for (node = entries; node; node = node->next) {
+                entry = (oh_el_entry *)node->data;
+                entry->event.EntryId = el->nextid++;
+                if (el->gentimestamp) {
+                        el->info.UpdateTimestamp =
+                                el->basetime + (cursystime - el->sysbasetime);
+                } else {
+                        el->info.UpdateTimestamp = entry->event.Event.Timestamp;
+                }
+                entry->event.Timestamp = el->info.UpdateTimestamp;
+        }
+        if (!el->gentimestamp) {
+                oh_el_timeset(el, el->info.UpdateTimestamp);
+        }
+
+        /* append the new entries, then wrap the el entries if necessary */
+        length = g_list_length(el->list) + g_list_length(entries);
+        el->list = g_list_concat(el->list, entries);
+        while (el->info.Size != OH_EL_MAX_SIZE && length > el->info.Size) {
+                g_free(el->list->data);
+                el->list = g_list_delete_link(el->list, el->list);
+                el->info.OverflowFlag = SAHPI_TRUE;
+                length--;
+        }
+
+        return SA_OK;
+}
+
+
 /* prepend a new entry to the EL */
 SaErrorT oh_el_prepend(oh_el *el,
 			const SaHpiEventT *event,
@@ -58,6 +58,7 @@ SaErrorT oh_el_append(oh_el *el,
 		       const SaHpiEventT *event,
 		       const SaHpiRdrT *rdr,
 		       const SaHpiRptEntryT *res);
+SaErrorT oh_el_append_batch(oh_el *el, GList *entries);
 SaErrorT oh_el_prepend(oh_el *el,
 		        const SaHpiEventT *event,
 			const SaHpiRdrT *rdr,
@@ -20,57 +20,241 @@
  *     Anton Pak <anton.pak@pigeonpoint.com>
  */
 
+#include <string.h>
 #include <glib.h>
 
 #include <SaHpi.h>
 
 #include <oh_utils.h>
+#include <sahpi_wrappers.h>
 
 
+/*
+ * Each thread keeps up to OH_POOL_MAGAZINE free objects of each type.
+ * A thread with a full cache moves half of it to a shared depot, and a
+ * thread with an empty cache refills from there before going to the heap.
+ * The depot holds up to OH_POOL_DEPOT objects of each type. Free objects
+ * are linked through their first pointer while in the depot.
+ */
+#define OH_POOL_MAGAZINE 64
+#define OH_POOL_DEPOT    4096
+
+enum {
+        OH_POOL_EVENT = 0,
+        OH_POOL_RDR,
+        OH_POOL_TYPES
+};
+
+struct oh_pool_magazine {
+        guint count;
+        gpointer objs[OH_POOL_MAGAZINE];
+};
+
+struct oh_pool_depot {
+        gpointer head;
+        guint count;
+};
+
+static const gsize oh_pool_size[OH_POOL_TYPES] = {
+        sizeof(struct oh_event),
+        sizeof(SaHpiRdrT)
+};
+
+static struct oh_pool_depot oh_pool_depots[OH_POOL_TYPES];
+static volatile gint oh_pool_allocated[OH_POOL_TYPES];
+static volatile gint oh_pool_released[OH_POOL_TYPES];
+
+static void oh_pool_cache_free(gpointer data);
+
+#if GLIB_CHECK_VERSION (2, 32, 0)
+static GMutex oh_pool_lock;
+static GPrivate oh_pool_cache = G_PRIVATE_INIT(oh_pool_cache_free);
+#else
+static GStaticMutex oh_pool_lock = G_STATIC_MUTEX_INIT;
+static GStaticPrivate oh_pool_cache = G_STATIC_PRIVATE_INIT;
+#endif
+
+/* Moves objects from the magazine to the depot until the magazine holds
+ * @keep objects. Objects that do not fit in the depot are freed. */
+static void oh_pool_drain(guint type, struct oh_pool_magazine *mag, guint keep)
+{
+        struct oh_pool_depot *depot = &oh_pool_depots[type];
+        gpointer obj;
+
+        wrap_g_static_mutex_lock(&oh_pool_lock);
+        while (mag->count > keep && depot->count < OH_POOL_DEPOT) {
+                obj = mag->objs[--mag->count];
+                *(gpointer *)obj = depot->head;
+                depot->head = obj;
+                depot->count++;
+        }
+        wrap_g_static_mutex_unlock(&oh_pool_lock);
+
+        while (mag->count > keep) {
+                g_free(mag->objs[--mag->count]);
+                g_atomic_int_inc(&oh_pool_released[type]);
+        }
+}
+
+static void oh_pool_refill(guint type, struct oh_pool_magazine *mag)
+{
+        struct oh_pool_depot *depot = &oh_pool_depots[type];
+        gpointer obj;
+
+        wrap_g_static_mutex_lock(&oh_pool_lock);
+        while (depot->head && mag->count < OH_POOL_MAGAZINE / 2) {
+                obj = depot->head;
+                depot->head = *(gpointer *)obj;
+                depot->count--;
+                mag->objs[mag->count++] = obj;
+        }
+        wrap_g_static_mutex_unlock(&oh_pool_lock);
+}
+
+/* Called when a thread exits */
+static void oh_pool_cache_free(gpointer data)
+{
+        struct oh_pool_magazine *mags = data;
+        guint type;
+
+        for (type = 0; type < OH_POOL_TYPES; type++) {
+                oh_pool_drain(type, &mags[type], 0);
+        }
+        g_free(mags);
+}
+
+static struct oh_pool_magazine *oh_pool_magazine_get(guint type)
+{
+        struct oh_pool_magazine *mags;
+
+        mags = wrap_g_static_private_get(&oh_pool_cache);
+        if (!mags) {
+                mags = g_new0(struct oh_pool_magazine, OH_POOL_TYPES);
+#if GLIB_CHECK_VERSION (2, 32, 0)
+                wrap_g_static_private_set(&oh_pool_cache, mags);
+#else
+                wrap_g_static_private_set(&oh_pool_cache, mags,
+                                          oh_pool_cache_free);
+#endif
+        }
+
+        return &mags[type];
+}
+
+static gpointer oh_pool_alloc(guint type)
+{
+        struct oh_pool_magazine *mag = oh_pool_magazine_get(type);
+        gpointer obj;
+
+        if (mag->count == 0) {
+                oh_pool_refill(type, mag);
+        }
+        if (mag->count == 0) {
+                g_atomic_int_inc(&oh_pool_allocated[type]);
+                return g_malloc0(oh_pool_size[type]);
+        }
+
+        obj = mag->objs[--mag->count];
+        memset(obj, 0, oh_pool_size[type]);
+
+        return obj;
+}
+
+static void oh_pool_free(guint type, gpointer obj)
+{
+        struct oh_pool_magazine *mag;
+
+        if (!obj) return;
+
+        mag = oh_pool_magazine_get(type);
+        if (mag->count == OH_POOL_MAGAZINE) {
+                oh_pool_drain(type, mag, OH_POOL_MAGAZINE / 2);
+        }
+        mag->objs[mag->count++] = obj;
+}
+
+struct oh_event *oh_event_alloc(void)
+{
+        return (struct oh_event *)oh_pool_alloc(OH_POOL_EVENT);
+}
+
+SaHpiRdrT *oh_rdr_alloc(void)
+{
+        return (SaHpiRdrT *)oh_pool_alloc(OH_POOL_RDR);
+}
+
+SaHpiRdrT *oh_rdr_dup(const SaHpiRdrT *rdr)
+{
+        SaHpiRdrT *copy;
+
+        if (!rdr) return NULL;
+
+        copy = oh_rdr_alloc();
+        *copy = *rdr;
+
+        return copy;
+}
+
+void oh_rdr_free(SaHpiRdrT *rdr)
+{
+        oh_pool_free(OH_POOL_RDR, rdr);
+}
+
+static GSList *oh_rdr_list_dup(GSList *rdrs)
+{
+        GSList *copy = NULL;
+        GSList *node;
+
+        for (node = rdrs; node; node = node->next) {
+                copy = g_slist_prepend(copy, oh_rdr_dup(node->data));
+        }
+
+        return g_slist_reverse(copy);
+}
+
+static void oh_rdr_list_free(GSList *rdrs)
+{
+        GSList *node;
+
+        for (node = rdrs; node; node = node->next) {
+                oh_rdr_free(node->data);
+        }
+        g_slist_free(rdrs);
+}
+
 void oh_event_free(struct oh_event *e, int only_rdrs)
 {
 	if (e) {
-		if (e->rdrs) {
-			GSList *node = NULL;
-			for (node = e->rdrs; node; node = node->next) {
-				g_free(node->data);
-			}
-			g_slist_free(e->rdrs);
-		}
-		if (e->rdrs_to_remove) {
-			GSList *node = NULL;
-			for (node = e->rdrs_to_remove; node; node = node->next) {
-				g_free(node->data);
-			}
-			g_slist_free(e->rdrs_to_remove);
-		}
-		if (!only_rdrs) g_free(e);
+		oh_rdr_list_free(e->rdrs);
+		oh_rdr_list_free(e->rdrs_to_remove);
+		if (!only_rdrs) oh_pool_free(OH_POOL_EVENT, e);
 	}
 }
 
 struct oh_event *oh_dup_event(struct oh_event *old_event)
 {
-	GSList *node = NULL;
 	struct oh_event *e = NULL;
 
 	if (!old_event) return NULL;
 
-	e = g_new0(struct oh_event, 1);
+	e = oh_event_alloc();
 	*e = *old_event;
-	e->rdrs = NULL;
-	for (node = old_event->rdrs; node; node = node->next) {
-		e->rdrs = g_slist_append(e->rdrs, g_memdup(node->data,
-							   sizeof(SaHpiRdrT)));
-	}
-    e->rdrs_to_remove = NULL;
-	for (node = old_event->rdrs_to_remove; node; node = node->next) {
-		e->rdrs_to_remove = g_slist_append(e->rdrs_to_remove, g_memdup(node->data,
-							   sizeof(SaHpiRdrT)));
-	}
+	e->rdrs = oh_rdr_list_dup(old_event->rdrs);
+	e->rdrs_to_remove = oh_rdr_list_dup(old_event->rdrs_to_remove);
 
 	return e;
 }
 
+void oh_event_pool_get_stats(oh_event_pool_stats *stats)
+{
+        if (!stats) return;
+
+        stats->events_allocated = g_atomic_int_get(&oh_pool_allocated[OH_POOL_EVENT]);
+        stats->events_released = g_atomic_int_get(&oh_pool_released[OH_POOL_EVENT]);
+        stats->rdrs_allocated = g_atomic_int_get(&oh_pool_allocated[OH_POOL_RDR]);
+        stats->rdrs_released = g_atomic_int_get(&oh_pool_released[OH_POOL_RDR]);
+}
+
 void oh_evt_queue_push(oh_evt_queue *equeue, gpointer data)
 {
         g_async_queue_push(equeue, data);
@@ -105,9 +105,31 @@ struct oh_event {
 
 typedef GAsyncQueue oh_evt_queue;
 
-#define oh_new_event() g_new0(struct oh_event, 1)
+/***
+ * oh_event and SaHpiRdrT pool
+ *****************************
+ * oh_new_event(), oh_dup_event() and oh_rdr_dup() take zeroed (or copied)
+ * objects from a per-thread cache, and oh_event_free()/oh_rdr_free() put
+ * them back. Pooled objects are ordinary g_malloc() blocks: releasing
+ * them with g_free() is still correct, and events or RDRs allocated with
+ * g_new0()/g_memdup() can still be passed to oh_event_free().
+ **/
+
+typedef struct {
+        guint events_allocated; /* events taken from the heap */
+        guint events_released;  /* events given back to the heap */
+        guint rdrs_allocated;
+        guint rdrs_released;
+} oh_event_pool_stats;
+
+#define oh_new_event() oh_event_alloc()
+struct oh_event *oh_event_alloc(void);
 void oh_event_free(struct oh_event *e, int only_rdrs);
 struct oh_event *oh_dup_event(struct oh_event *old_event);
+SaHpiRdrT *oh_rdr_alloc(void);
+SaHpiRdrT *oh_rdr_dup(const SaHpiRdrT *rdr);
+void oh_rdr_free(SaHpiRdrT *rdr);
+void oh_event_pool_get_stats(oh_event_pool_stats *stats);
 void oh_evt_queue_push(oh_evt_queue *equeue, gpointer data);
 
 #ifdef __cplusplus
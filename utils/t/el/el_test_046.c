@@ -0,0 +1,155 @@
+/*      -*- linux-c -*-
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <string.h>
+
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include <el_utils.h>
+
+
+#include "el_test.h"
+
+static GList *make_batch(int first, int count)
+{
+        GList *batch = NULL;
+        oh_el_entry *entry;
+        int x;
+
+        for (x = first; x < first + count; x++) {
+                entry = g_new0(oh_el_entry, 1);
+                entry->event.Event.Source = 1;
+                entry->event.Event.EventType = SAHPI_ET_OEM;
+                entry->event.Event.Timestamp = (SaHpiTimeT)(x + 1) * 1000000000;
+                entry->event.Event.Severity = SAHPI_DEBUG;
+                batch = g_list_prepend(batch, entry);
+        }
+
+        return g_list_reverse(batch);
+}
+
+static void free_batch(GList *batch)
+{
+        GList *node;
+
+        for (node = batch; node; node = node->next)
+                g_free(node->data);
+        g_list_free(batch);
+}
+
+/**
+ * main: EL test
+ *
+ * This test verifies oh_el_append_batch. A batch appended after two single
+ * entries wraps a log of size 5, and the kept entries are the newest ones,
+ * in order, with consecutive entry ids. A batch is refused as a whole by a
+ * disabled log.
+ *
+ * Return value: 0 on success, 1 on failure
+ **/
+
+
+int main(int argc, char **argv)
+{
+        oh_el *el;
+        oh_el_entry *entry;
+        SaErrorT retc;
+        SaHpiEventT event;
+        SaHpiEventLogEntryIdT id, prev, next;
+        SaHpiEventLogInfoT info;
+        GList *batch;
+        int x;
+
+        el = oh_el_create(5);
+        el->gentimestamp = SAHPI_FALSE;
+
+        memset(&event, 0, sizeof(event));
+        event.Source = 1;
+        event.EventType = SAHPI_ET_OEM;
+        event.Severity = SAHPI_DEBUG;
+        for (x = 0; x < 2; x++) {
+                event.Timestamp = (SaHpiTimeT)(x + 1) * 1000000000;
+                retc = oh_el_append(el, &event, NULL, NULL);
+                if (retc != SA_OK) {
+                        CRIT("oh_el_append failed.");
+                        return 1;
+                }
+        }
+
+        /* an empty batch is a no-op */
+        retc = oh_el_append_batch(el, NULL);
+        if (retc != SA_OK) {
+                CRIT("oh_el_append_batch with an empty batch failed.");
+                return 1;
+        }
+
+        batch = make_batch(2, 6);
+        retc = oh_el_append_batch(el, batch);
+        if (retc != SA_OK) {
+                CRIT("oh_el_append_batch failed.");
+                return 1;
+        }
+
+        oh_el_info(el, &info);
+        if (info.Entries != 5 || info.OverflowFlag != SAHPI_TRUE) {
+                CRIT("EL did not wrap: %d entries.", info.Entries);
+                return 1;
+        }
+
+        /* entries 4..8 are kept, oldest first */
+        id = SAHPI_OLDEST_ENTRY;
+        for (x = 3; x < 8; x++) {
+                retc = oh_el_get(el, id, &prev, &next, &entry);
+                if (retc != SA_OK) {
+                        CRIT("oh_el_get failed.");
+                        return 1;
+                }
+                if (entry->event.EntryId != (SaHpiEventLogEntryIdT)(x + 1) ||
+                    entry->event.Event.Timestamp != (SaHpiTimeT)(x + 1) * 1000000000) {
+                        CRIT("Unexpected entry %d.", entry->event.EntryId);
+                        return 1;
+                }
+                id = next;
+        }
+        if (id != SAHPI_NO_MORE_ENTRIES) {
+                CRIT("More entries than expected.");
+                return 1;
+        }
+
+        /* a disabled log refuses the whole batch */
+        oh_el_enableset(el, SAHPI_FALSE);
+        batch = make_batch(8, 2);
+        retc = oh_el_append_batch(el, batch);
+        if (retc != SA_ERR_HPI_INVALID_REQUEST) {
+                CRIT("oh_el_append_batch on a disabled EL did not fail.");
+                return 1;
+        }
+        free_batch(batch);
+
+        oh_el_info(el, &info);
+        if (info.Entries != 5) {
+                CRIT("Disabled EL changed.");
+                return 1;
+        }
+
+        /* close el */
+        retc = oh_el_close(el);
+        if (retc != SA_OK) {
+                CRIT("oh_el_close on el failed.");
+                return 1;
+        }
+
+        return 0;
+}
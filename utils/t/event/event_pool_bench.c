@@ -0,0 +1,154 @@
+/*      -*- linux-c -*-
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ * oh_event/RDR pool benchmark.
+ *
+ * Each producer thread builds events carrying RDRs the way a plugin
+ * does and pushes them to a queue. The consumer thread duplicates each
+ * event once per session, as the daemon does when it delivers an event,
+ * and frees everything. Producers wait while more than -q events are
+ * queued, as a plugin is held back by the daemon. Reports the event rate and the heap allocations
+ * per event next to the count without the pool.
+ * Not part of "make check": build it with "make event_pool_bench".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <glib.h>
+
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include <sahpi_wrappers.h>
+
+static int nevents = 200000;
+static int nrdrs = 4;
+static int nsessions = 2;
+static int backlog = 256;
+
+static double now_sec(void)
+{
+        struct timeval tv;
+
+        gettimeofday(&tv, NULL);
+
+        return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static gpointer producer(gpointer data)
+{
+        oh_evt_queue *q = data;
+        struct oh_event *e;
+        SaHpiRdrT *rdr;
+        int x, y;
+
+        for (x = 0; x < nevents; x++) {
+                e = oh_new_event();
+                e->hid = 1;
+                e->event.Source = x % 64 + 1;
+                e->event.EventType = SAHPI_ET_RESOURCE;
+                for (y = 0; y < nrdrs; y++) {
+                        rdr = oh_rdr_alloc();
+                        rdr->RecordId = y + 1;
+                        rdr->RdrType = SAHPI_SENSOR_RDR;
+                        e->rdrs = g_slist_prepend(e->rdrs, rdr);
+                }
+                oh_evt_queue_push(q, e);
+                while (g_async_queue_length(q) > backlog) {
+                        g_usleep(100);
+                }
+        }
+
+        return NULL;
+}
+
+static void usage(const char *prog)
+{
+        printf("usage: %s [-n events] [-r rdrs] [-s sessions] "
+               "[-p producers] [-q backlog]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+        oh_evt_queue *q;
+        GThread **threads;
+        struct oh_event *e, *copy;
+        oh_event_pool_stats stats;
+        double start, elapsed;
+        guint heap, unpooled;
+        int nproducers = 1;
+        int total, x, y, c;
+
+        while ((c = getopt(argc, argv, "n:r:s:p:q:h")) != -1) {
+                switch (c) {
+                case 'n': nevents = atoi(optarg); break;
+                case 'r': nrdrs = atoi(optarg); break;
+                case 's': nsessions = atoi(optarg); break;
+                case 'p': nproducers = atoi(optarg); break;
+                case 'q': backlog = atoi(optarg); break;
+                default:
+                        usage(argv[0]);
+                        return 1;
+                }
+        }
+        if (nevents <= 0 || nrdrs < 0 || nsessions < 0 || nproducers <= 0 ||
+            backlog <= 0) {
+                usage(argv[0]);
+                return 1;
+        }
+
+        if (g_thread_supported() == FALSE) {
+                wrap_g_thread_init(0);
+        }
+        q = g_async_queue_new();
+        threads = g_new0(GThread *, nproducers);
+
+        start = now_sec();
+        for (x = 0; x < nproducers; x++) {
+                threads[x] = wrap_g_thread_create_new("event_pool_bench",
+                                                      producer, q, TRUE, NULL);
+        }
+
+        total = nevents * nproducers;
+        for (x = 0; x < total; x++) {
+                e = g_async_queue_pop(q);
+                for (y = 0; y < nsessions; y++) {
+                        copy = oh_dup_event(e);
+                        oh_event_free(copy, FALSE);
+                }
+                oh_event_free(e, FALSE);
+        }
+
+        for (x = 0; x < nproducers; x++) {
+                g_thread_join(threads[x]);
+        }
+        elapsed = now_sec() - start;
+
+        oh_event_pool_get_stats(&stats);
+        heap = stats.events_allocated + stats.rdrs_allocated;
+        unpooled = (1 + nrdrs) * (1 + nsessions);
+
+        printf("%d events, %d RDRs each, %d sessions, %d producers\n",
+               total, nrdrs, nsessions, nproducers);
+        printf("%.0f events/sec\n", total / elapsed);
+        printf("heap allocations: %u events, %u RDRs (%.4f per event, "
+               "%u per event without the pool)\n",
+               stats.events_allocated, stats.rdrs_allocated,
+               (double)heap / total, unpooled);
+        printf("heap releases: %u events, %u RDRs\n",
+               stats.events_released, stats.rdrs_released);
+
+        g_free(threads);
+        g_async_queue_unref(q);
+
+        return 0;
+}
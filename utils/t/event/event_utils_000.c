@@ -0,0 +1,113 @@
+/*      -*- linux-c -*-
+ *
+ * Copyright (c) 2026 by The OpenHPI Project
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include <SaHpi.h>
+#include <oh_utils.h>
+
+static struct oh_event *make_event(int nrdrs)
+{
+        struct oh_event *e;
+        SaHpiRdrT *rdr;
+        int x;
+
+        e = oh_new_event();
+        e->hid = 7;
+        e->event.Source = 3;
+        e->event.EventType = SAHPI_ET_RESOURCE;
+        e->resource.ResourceId = 3;
+        for (x = 0; x < nrdrs; x++) {
+                rdr = oh_rdr_alloc();
+                rdr->RecordId = x + 1;
+                rdr->RdrType = SAHPI_SENSOR_RDR;
+                e->rdrs = g_slist_append(e->rdrs, rdr);
+        }
+
+        return e;
+}
+
+/**
+ * main: event_utils test
+ *
+ * This test verifies the oh_event/RDR pool. Recycled objects come back
+ * zeroed, oh_dup_event copies the RDRs in order, events and RDRs from
+ * g_new0() can be freed with oh_event_free(), and a steady allocate/free
+ * cycle does not go back to the heap.
+ *
+ * Return value: 0 on success, 1 on failure
+ **/
+int main(int argc, char **argv)
+{
+        struct oh_event *e, *copy;
+        SaHpiRdrT *rdr;
+        GSList *a, *b;
+        oh_event_pool_stats before, after;
+        int x;
+
+        /* recycled objects are zeroed */
+        e = make_event(3);
+        oh_event_free(e, FALSE);
+        e = oh_new_event();
+        rdr = oh_rdr_alloc();
+        if (e->hid != 0 || e->rdrs != NULL || e->event.Source != 0 ||
+            rdr->RecordId != 0) {
+                printf("Recycled object not zeroed\n");
+                return 1;
+        }
+        oh_rdr_free(rdr);
+        oh_event_free(e, FALSE);
+
+        /* deep copy keeps the RDR order */
+        e = make_event(5);
+        copy = oh_dup_event(e);
+        if (copy == e || copy->hid != 7 || copy->resource.ResourceId != 3 ||
+            g_slist_length(copy->rdrs) != 5) {
+                printf("oh_dup_event: bad copy\n");
+                return 1;
+        }
+        for (a = e->rdrs, b = copy->rdrs; a && b; a = a->next, b = b->next) {
+                if (a->data == b->data ||
+                    memcmp(a->data, b->data, sizeof(SaHpiRdrT)) != 0) {
+                        printf("oh_dup_event: RDR not copied\n");
+                        return 1;
+                }
+        }
+        oh_event_free(e, FALSE);
+        oh_event_free(copy, FALSE);
+
+        /* objects not taken from the pool can be returned to it */
+        e = g_new0(struct oh_event, 1);
+        e->rdrs = g_slist_append(e->rdrs, g_new0(SaHpiRdrT, 1));
+        oh_event_free(e, FALSE);
+
+        /* a warm pool serves a steady workload without the heap */
+        oh_event_pool_get_stats(&before);
+        for (x = 0; x < 1000; x++) {
+                e = make_event(4);
+                copy = oh_dup_event(e);
+                oh_event_free(e, FALSE);
+                oh_event_free(copy, FALSE);
+        }
+        oh_event_pool_get_stats(&after);
+        if (after.events_allocated - before.events_allocated > 2 ||
+            after.rdrs_allocated - before.rdrs_allocated > 8) {
+                printf("Pool went to the heap: %u events, %u RDRs\n",
+                       after.events_allocated - before.events_allocated,
+                       after.rdrs_allocated - before.rdrs_allocated);
+                return 1;
+        }
+
+        return 0;
+}